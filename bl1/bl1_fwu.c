@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -52,6 +52,13 @@ __dead2 static void bl1_fwu_done(void *client_cookie, void *reserved);
  */
 static unsigned int sec_exec_image_id = INVALID_IMAGE_ID;
 
+#if AUTH_STREAM_HASH
+/*
+ * This keeps track of the image hashed while it is copied in blocks.
+ */
+static unsigned int stream_hash_image_id = INVALID_IMAGE_ID;
+#endif
+
 /*******************************************************************************
  * Top level handler for servicing FWU SMCs.
  ******************************************************************************/
@@ -346,11 +353,33 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 					image_id);
 			return -EPERM;
 		}
+
+#if AUTH_STREAM_HASH
+		/*
+		 * Hash the image block by block, if its parent certificate is
+		 * already authenticated. Starting another image stops it.
+		 */
+		stream_hash_image_id = INVALID_IMAGE_ID;
+		if (auth_mod_stream_hash_start(image_id) == 0) {
+			stream_hash_image_id = image_id;
+		}
+#endif
 	}
 
 	/* Everything looks sane. Go ahead and copy the block of data. */
 	dest_addr = desc->image_info.image_base + desc->copied_size;
 	(void)memcpy((void *) dest_addr, (const void *) image_src, block_size);
+#if AUTH_STREAM_HASH
+	/*
+	 * Hash the secure copy, not the non-secure source, while it is hot in
+	 * the data cache. An error stops the streaming, auth then hashes all
+	 * the image again.
+	 */
+	if ((stream_hash_image_id == image_id) &&
+	    (auth_mod_stream_hash_update((void *)dest_addr, block_size) != 0)) {
+		stream_hash_image_id = INVALID_IMAGE_ID;
+	}
+#endif
 	flush_dcache_range(dest_addr, block_size);
 
 	desc->copied_size += block_size;
@@ -443,6 +472,11 @@ static int bl1_fwu_image_auth(unsigned int image_id,
 	 */
 	INFO("BL1-FWU: Authenticating image_id:%d\n", image_id);
 	result = auth_mod_verify_img(image_id, (void *)base_addr, total_size);
+#if AUTH_STREAM_HASH
+	if (stream_hash_image_id == image_id) {
+		stream_hash_image_id = INVALID_IMAGE_ID;
+	}
+#endif
 	if (result != 0) {
 		WARN("BL1-FWU: Authentication Failed err=%d\n", result);
 
@@ -725,6 +759,12 @@ static int bl1_fwu_image_reset(unsigned int image_id, unsigned int flags)
 					desc->copied_size);
 		}
 
+#if AUTH_STREAM_HASH
+		if (stream_hash_image_id == image_id) {
+			stream_hash_image_id = INVALID_IMAGE_ID;
+		}
+#endif
+
 		/* Reset status variables */
 		desc->copied_size = 0;
 		desc->image_info.image_size = 0;
@@ -15,6 +15,10 @@ ifeq (${ARCH},aarch64)
 BL2_SOURCES		+=	common/aarch64/early_exceptions.S
 endif
 
+ifeq (${BL2_LOAD_INSTRUMENTATION},1)
+BL2_SOURCES		+=	lib/pmf/pmf_main.c
+endif
+
 ifeq (${ENABLE_RME},1)
 # Using RME, run BL2 at EL3
 include lib/gpt_rme/gpt_rme.mk
@@ -65,6 +65,17 @@ struct entry_point_info *bl2_load_images(void)
 		}
 
 		if ((bl2_node_info->image_info->h.attr &
+		    (IMAGE_ATTRIB_SKIP_LOADING | IMAGE_ATTRIB_DEFERRED)) ==
+		    IMAGE_ATTRIB_DEFERRED) {
+			INFO("BL2: Deferring image id %d\n", bl2_node_info->image_id);
+			err = load_auth_image_parents(bl2_node_info->image_id,
+				bl2_node_info->image_info);
+			if (err != 0) {
+				ERROR("BL2: Failed to authenticate image id %d parents (%i)\n",
+				      bl2_node_info->image_id, err);
+				plat_error_handler(err);
+			}
+		} else if ((bl2_node_info->image_info->h.attr &
 		    IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
 			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
 			err = load_auth_image(bl2_node_info->image_id,
@@ -15,9 +15,13 @@
 #include <drivers/auth/auth_mod.h>
 #include <drivers/console.h>
 #include <drivers/fwu/fwu.h>
+#include <lib/bl2_load_instr.h>
 #include <lib/extensions/pauth.h>
+#include <lib/pmf/pmf.h>
 #include <plat/common/platform.h>
 
+#include <platform_def.h>
+
 #include "bl2_private.h"
 
 #ifdef __aarch64__
@@ -26,6 +30,54 @@
 #define NEXT_IMAGE	"BL32"
 #endif
 
+#if BL2_LOAD_INSTRUMENTATION
+CASSERT(BL2_LOAD_INSTR_TOTAL_IDS <= (PMF_TID_MASK + 1U),
+	assert_bl2_load_instr_ids_fit_pmf_tid);
+
+PMF_REGISTER_SERVICE(bl2_load_instr_svc, PMF_BL2_LOAD_INSTR_SVC_ID,
+	BL2_LOAD_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+
+/*******************************************************************************
+ * Print the open, read and authentication durations, in generic timer ticks,
+ * of the last load of each image, in the order of the image ids.
+ ******************************************************************************/
+static void bl2_load_instr_print(void)
+{
+	unsigned int cpu = plat_my_core_pos();
+	unsigned int id;
+
+	NOTICE("BL2_LOAD_INSTR freq=%u\n", (unsigned int)read_cntfrq_el0());
+
+	for (id = 0U; id < MAX_NUMBER_IDS; id++) {
+		unsigned long long ts[BL2_LOAD_INSTR_POINTS];
+		unsigned long long auth = 0ULL;
+		unsigned int point;
+
+		for (point = 0U; point < BL2_LOAD_INSTR_POINTS; point++) {
+			PMF_GET_TIMESTAMP_BY_INDEX(bl2_load_instr_svc,
+				BL2_LOAD_INSTR_TID(id, point), cpu,
+				PMF_NO_CACHE_MAINT, ts[point]);
+		}
+
+		if ((ts[BL2_LOAD_INSTR_OPEN] == 0ULL) ||
+		    (ts[BL2_LOAD_INSTR_CLOSE] == 0ULL)) {
+			continue;
+		}
+
+		if (ts[BL2_LOAD_INSTR_AUTH] != 0ULL) {
+			auth = ts[BL2_LOAD_INSTR_AUTH] -
+			       ts[BL2_LOAD_INSTR_CLOSE];
+		}
+
+		NOTICE("BL2_LOAD_INSTR id=%u start=%llu open=%llu read=%llu auth=%llu\n",
+		       id, ts[BL2_LOAD_INSTR_OPEN],
+		       ts[BL2_LOAD_INSTR_READ] - ts[BL2_LOAD_INSTR_OPEN],
+		       ts[BL2_LOAD_INSTR_CLOSE] - ts[BL2_LOAD_INSTR_READ],
+		       auth);
+	}
+}
+#endif /* BL2_LOAD_INSTRUMENTATION */
+
 #if BL2_AT_EL3
 /*******************************************************************************
  * Setup function for BL2 when BL2_AT_EL3=1
@@ -105,6 +157,10 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if BL2_LOAD_INSTRUMENTATION
+	bl2_load_instr_print();
+#endif
+
 	/* Teardown the Measured Boot backend */
 	bl2_plat_mboot_finish();
 
@@ -96,10 +96,20 @@ BL31_SOURCES		+=	lib/extensions/sve/sve.c
 endif
 endif
 
+ifeq (${CTX_LAZY_SIMD_REGS},1)
+BL31_SOURCES		+=	lib/extensions/sve/sve_lazy.c			\
+				lib/extensions/sve/sve_lazy_helpers.S
+endif
+
 ifeq (${ENABLE_MPAM_FOR_LOWER_ELS},1)
 BL31_SOURCES		+=	lib/extensions/mpam/mpam.c
 endif
 
+ifeq (${ENABLE_MPAM_MSC},1)
+BL31_SOURCES		+=	lib/extensions/mpam/mpam_msc.c			\
+				${FCONF_MPAM_MSC_SOURCES}
+endif
+
 ifeq (${ENABLE_TRBE_FOR_NS},1)
 BL31_SOURCES		+=	lib/extensions/trbe/trbe.c
 endif
@@ -71,3 +71,10 @@ $(eval $(call assert_boolean,RESET_TO_SP_MIN))
 SP_MIN_WITH_SECURE_FIQ 	?= 0
 $(eval $(call add_define,SP_MIN_WITH_SECURE_FIQ))
 $(eval $(call assert_boolean,SP_MIN_WITH_SECURE_FIQ))
+
+# Flag to skip the save and restore of the other modes banked registers on SMC
+# and FIQ entry and exit. The platform port is free to override this value. It
+# is default disabled.
+SP_MIN_LAZY_BANKED_REGS	?= 0
+$(eval $(call add_define,SP_MIN_LAZY_BANKED_REGS))
+$(eval $(call assert_boolean,SP_MIN_LAZY_BANKED_REGS))
@@ -19,6 +19,7 @@
 #include <context.h>
 #include <drivers/console.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/per_cpu.h>
 #include <lib/pmf/pmf.h>
 #include <lib/psci/psci.h>
 #include <lib/runtime_instr.h>
@@ -35,11 +36,11 @@ PMF_REGISTER_SERVICE_SMC(rt_instr_svc, PMF_RT_INSTR_SVC_ID,
 	RT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
 #endif
 
-/* Pointers to per-core cpu contexts */
-static void *sp_min_cpu_ctx_ptr[PLATFORM_CORE_COUNT];
+/* Pointer to the cpu context of each core */
+static DEFINE_PER_CPU(void *, sp_min_cpu_ctx_ptr);
 
 /* SP_MIN only stores the non secure smc context */
-static smc_ctx_t sp_min_smc_context[PLATFORM_CORE_COUNT];
+static DEFINE_PER_CPU(smc_ctx_t, sp_min_smc_context);
 
 /******************************************************************************
  * Define the smccc helper library APIs
@@ -47,7 +48,7 @@ static smc_ctx_t sp_min_smc_context[PLATFORM_CORE_COUNT];
 void *smc_get_ctx(unsigned int security_state)
 {
 	assert(security_state == NON_SECURE);
-	return &sp_min_smc_context[plat_my_core_pos()];
+	return PER_CPU_CUR(sp_min_smc_context);
 }
 
 void smc_set_next_ctx(unsigned int security_state)
@@ -58,7 +59,7 @@ void smc_set_next_ctx(unsigned int security_state)
 
 void *smc_get_next_ctx(void)
 {
-	return &sp_min_smc_context[plat_my_core_pos()];
+	return PER_CPU_CUR(sp_min_smc_context);
 }
 
 /*******************************************************************************
@@ -69,7 +70,7 @@ void *smc_get_next_ctx(void)
 void *cm_get_context(uint32_t security_state)
 {
 	assert(security_state == NON_SECURE);
-	return sp_min_cpu_ctx_ptr[plat_my_core_pos()];
+	return *PER_CPU_CUR(sp_min_cpu_ctx_ptr);
 }
 
 /*******************************************************************************
@@ -79,7 +80,7 @@ void *cm_get_context(uint32_t security_state)
 void cm_set_context(void *context, uint32_t security_state)
 {
 	assert(security_state == NON_SECURE);
-	sp_min_cpu_ctx_ptr[plat_my_core_pos()] = context;
+	*PER_CPU_CUR(sp_min_cpu_ctx_ptr) = context;
 }
 
 /*******************************************************************************
@@ -92,7 +93,7 @@ void *cm_get_context_by_index(unsigned int cpu_idx,
 				unsigned int security_state)
 {
 	assert(security_state == NON_SECURE);
-	return sp_min_cpu_ctx_ptr[cpu_idx];
+	return *PER_CPU_BY_INDEX(sp_min_cpu_ctx_ptr, cpu_idx);
 }
 
 /*******************************************************************************
@@ -103,7 +104,7 @@ void cm_set_context_by_index(unsigned int cpu_idx, void *context,
 				unsigned int security_state)
 {
 	assert(security_state == NON_SECURE);
-	sp_min_cpu_ctx_ptr[cpu_idx] = context;
+	*PER_CPU_BY_INDEX(sp_min_cpu_ctx_ptr, cpu_idx) = context;
 }
 
 static void copy_cpu_ctx_to_smc_stx(const regs_t *cpu_reg_ctx,
@@ -177,6 +178,8 @@ void sp_min_main(void)
 	NOTICE("SP_MIN: %s\n", version_string);
 	NOTICE("SP_MIN: %s\n", build_message);
 
+	per_cpu_check_granule();
+
 	/* Perform the SP_MIN platform setup */
 	sp_min_platform_setup();
 
@@ -13,12 +13,24 @@
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <common/image_decompress.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/io/io_storage.h>
+#include <lib/bl2_load_instr.h>
+#include <lib/pmf/pmf.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <plat/common/platform.h>
 
+#if defined(IMAGE_BL2) && BL2_LOAD_INSTRUMENTATION
+#define BL2_LOAD_INSTR_CAPTURE(_id, _point)				\
+	PMF_CAPTURE_TIMESTAMP(bl2_load_instr_svc,			\
+			      BL2_LOAD_INSTR_TID(_id, _point),		\
+			      PMF_NO_CACHE_MAINT)
+#else
+#define BL2_LOAD_INSTR_CAPTURE(_id, _point)
+#endif
+
 #if TRUSTED_BOARD_BOOT
 # ifdef DYN_DISABLE_AUTH
 static int disable_auth;
@@ -59,6 +71,90 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+#if AUTH_STREAM_HASH
+/* Size of the parts read and hashed in turn when streaming the image hash */
+#define STREAM_HASH_CHUNK_SIZE		U(0x10000)
+
+/*
+ * Read the image data in chunks, giving each of them to the authentication
+ * module while they are still hot in the data cache.
+ */
+static int read_image_hashed(uintptr_t image_handle, uintptr_t image_base,
+			     size_t image_size, size_t *bytes_read)
+{
+	size_t offset = 0U;
+	int io_result;
+
+	while (offset < image_size) {
+		size_t len = MIN(STREAM_HASH_CHUNK_SIZE, image_size - offset);
+		size_t chunk_read;
+
+		io_result = io_read(image_handle, image_base + offset, len,
+				    &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0U)) {
+			*bytes_read = offset;
+			return io_result;
+		}
+
+		/* An error stops the streaming, auth then hashes all again */
+		(void)auth_mod_stream_hash_update((void *)(image_base + offset),
+						  (unsigned int)chunk_read);
+
+		offset += chunk_read;
+	}
+
+	*bytes_read = offset;
+
+	return 0;
+}
+#endif /* AUTH_STREAM_HASH */
+
+/*
+ * Read the image data to its load address, decompressed or hashed on the
+ * way when the image was selected for it.
+ */
+static int read_image(unsigned int image_id, uintptr_t image_handle,
+		      image_info_t *image_data, size_t image_size,
+		      size_t *bytes_read)
+{
+	uintptr_t mapped_base;
+	size_t mapped_size;
+
+#if IMAGE_DECOMPRESS_STREAM
+	if (image_decompress_stream_is_active(image_id)) {
+		return image_decompress_stream_read(image_handle, image_data,
+						    image_size, bytes_read);
+	}
+#endif
+
+	/*
+	 * The image is already at its load address when it is memory-mapped
+	 * there, e.g. in a FIP downloaded to or executed from its final
+	 * location: there is nothing to copy.
+	 */
+	if ((io_map(image_handle, &mapped_base, &mapped_size) == 0) &&
+	    (mapped_base == image_data->image_base) &&
+	    (mapped_size >= image_size)) {
+#if AUTH_STREAM_HASH
+		if (auth_mod_stream_hash_is_active()) {
+			(void)auth_mod_stream_hash_update((void *)mapped_base,
+						(unsigned int)image_size);
+		}
+#endif
+		*bytes_read = image_size;
+		return 0;
+	}
+#if AUTH_STREAM_HASH
+	if (auth_mod_stream_hash_is_active()) {
+		return read_image_hashed(image_handle, image_data->image_base,
+					 image_size, bytes_read);
+	}
+#endif
+
+	return io_read(image_handle, image_data->image_base, image_size,
+		       bytes_read);
+}
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
@@ -82,6 +178,8 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	image_base = image_data->image_base;
 
+	BL2_LOAD_INSTR_CAPTURE(image_id, BL2_LOAD_INSTR_OPEN);
+
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (io_result != 0) {
@@ -123,14 +221,16 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	BL2_LOAD_INSTR_CAPTURE(image_id, BL2_LOAD_INSTR_READ);
+	io_result = read_image(image_id, image_handle, image_data, image_size,
+			       &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
 
 	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
-	     (uintptr_t)(image_base + image_size));
+	     (uintptr_t)(image_base + image_data->image_size));
 
 exit:
 	(void)io_close(image_handle);
@@ -140,6 +240,8 @@ exit:
 	(void)io_dev_close(dev_handle);
 	/* Ignore improbable/unrecoverable error in 'dev_close' */
 
+	BL2_LOAD_INSTR_CAPTURE(image_id, BL2_LOAD_INSTR_CLOSE);
+
 	return io_result;
 }
 
@@ -153,10 +255,12 @@ static int load_image_flush(unsigned int image_id,
 	int rc;
 
 	rc = load_image(image_id, image_data);
+#if !(defined(IMAGE_BL2) && BL2_DEFER_IMAGE_FLUSH)
 	if (rc == 0) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
 	}
+#endif
 
 	return rc;
 }
@@ -183,6 +287,11 @@ static int load_auth_image_recursive(unsigned int image_id,
 		}
 	}
 
+#if AUTH_STREAM_HASH
+	/* Hash the image while it is loaded, if supported for this image */
+	(void)auth_mod_stream_hash_start(image_id);
+#endif
+
 	/* Load the image */
 	rc = load_image(image_id, image_data);
 	if (rc != 0) {
@@ -193,6 +302,7 @@ static int load_auth_image_recursive(unsigned int image_id,
 	rc = auth_mod_verify_img(image_id,
 				 (void *)image_data->image_base,
 				 image_data->image_size);
+	BL2_LOAD_INSTR_CAPTURE(image_id, BL2_LOAD_INSTR_AUTH);
 	if (rc != 0) {
 		/* Authentication error, zero memory and flush it right away. */
 		zero_normalmem((void *)image_data->image_base,
@@ -220,10 +330,13 @@ static int load_auth_image_recursive(unsigned int image_id,
 		 * Flush the image to main memory so that it can be executed
 		 * later by any CPU, regardless of cache and MMU state. This
 		 * is only needed for child images, not for the parents
-		 * (certificates).
+		 * (certificates). With BL2_DEFER_IMAGE_FLUSH, the platform
+		 * flushes the images when BL2 hands off to the next one.
 		 */
+#if !(defined(IMAGE_BL2) && BL2_DEFER_IMAGE_FLUSH)
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+#endif
 	}
 
 	return 0;
@@ -273,6 +386,26 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 	return err;
 }
 
+/*******************************************************************************
+ * Authenticate the parent images of an image that is not loaded, up to the
+ * root of trust, for a later stage to load it and check it against the data
+ * extracted from its parent, e.g. with auth_mod_get_img_hash(). The parents are
+ * loaded in the image area. Without TBB, there is nothing to authenticate.
+ ******************************************************************************/
+int load_auth_image_parents(unsigned int image_id, image_info_t *image_data)
+{
+#if TRUSTED_BOARD_BOOT
+	unsigned int parent_id;
+
+	if ((dyn_is_auth_disabled() == 0) &&
+	    (auth_mod_get_parent_id(image_id, &parent_id) == 0)) {
+		return load_auth_image_recursive(parent_id, image_data, 1);
+	}
+#endif
+
+	return 0;
+}
+
 /*******************************************************************************
  * Print the content of an entry_point_info_t structure.
  ******************************************************************************/
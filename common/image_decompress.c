@@ -5,12 +5,16 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <drivers/io/io_storage.h>
+#include <lib/utils_def.h>
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
@@ -78,3 +82,129 @@ int image_decompress(struct image_info *info)
 
 	return 0;
 }
+
+#if IMAGE_DECOMPRESS_STREAM
+/* Size of the parts read and inflated in turn, at the temporary buffer base */
+#define STREAM_CHUNK_SIZE		U(0x10000)
+
+static uintptr_t stream_buf_base;
+static uint32_t stream_buf_size;
+static const decompressor_stream_t *stream_decompressor;
+static unsigned int stream_image_id = INVALID_IMAGE_ID;
+
+/*
+ * The temporary buffer holds a chunk of compressed data, the rest of it is
+ * the workspace of the decompressor.
+ */
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  const decompressor_stream_t *decompressor)
+{
+	assert(buf_size > STREAM_CHUNK_SIZE);
+
+	stream_buf_base = buf_base;
+	stream_buf_size = buf_size;
+	stream_decompressor = decompressor;
+}
+
+/* Inflate the image while it is read, on its next load */
+void image_decompress_stream_prepare(unsigned int image_id)
+{
+	stream_image_id = image_id;
+}
+
+bool image_decompress_stream_is_active(unsigned int image_id)
+{
+	return (stream_decompressor != NULL) && (stream_image_id == image_id);
+}
+
+static int stream_read_chunk(uintptr_t image_handle, size_t len)
+{
+	size_t bytes_read;
+	int ret;
+
+	ret = io_read(image_handle, stream_buf_base, len, &bytes_read);
+	if ((ret == 0) && (bytes_read < len)) {
+		ret = -EIO;
+	}
+
+	return ret;
+}
+
+/*
+ * Read image_size bytes of the image, inflated to info->image_base within
+ * info->image_max_size. On success, info->image_size is updated to the size
+ * of the inflated image. An image not recognized by the decompressor is
+ * read as is.
+ */
+int image_decompress_stream_read(uintptr_t image_handle,
+				 struct image_info *info, size_t image_size,
+				 size_t *bytes_read)
+{
+	uintptr_t image_base = info->image_base;
+	size_t offset = 0U;
+	size_t len;
+	int ret;
+
+	stream_image_id = INVALID_IMAGE_ID;
+	*bytes_read = 0U;
+
+	len = MIN(STREAM_CHUNK_SIZE, image_size);
+	ret = stream_read_chunk(image_handle, len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (!stream_decompressor->probe(stream_buf_base, len)) {
+		/* Not compressed, only the first chunk is copied */
+		memcpy((void *)image_base, (void *)stream_buf_base, len);
+
+		ret = io_read(image_handle, image_base + len, image_size - len,
+			      bytes_read);
+		*bytes_read += len;
+
+		return ret;
+	}
+
+	ret = stream_decompressor->init(image_base, info->image_max_size,
+					stream_buf_base + STREAM_CHUNK_SIZE,
+					stream_buf_size - STREAM_CHUNK_SIZE);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (;;) {
+		ret = stream_decompressor->update(stream_buf_base, len);
+		offset += len;
+
+		if ((ret != 0) || (offset == image_size)) {
+			break;
+		}
+
+		len = MIN(STREAM_CHUNK_SIZE, image_size - offset);
+		ret = stream_read_chunk(image_handle, len);
+		if (ret != 0) {
+			break;
+		}
+	}
+
+	if (ret == 0) {
+		/* Input ended before the compressed stream */
+		ret = -EIO;
+	}
+
+	if (stream_decompressor->end(&image_base) != 0) {
+		ret = -EIO;
+	}
+
+	if (ret < 0) {
+		ERROR("Failed to decompress image (err=%d)\n", ret);
+		return ret;
+	}
+
+	/* Trailing data read after the compressed stream are ignored */
+	*bytes_read = image_size;
+	info->image_size = image_base - info->image_base;
+
+	return 0;
+}
+#endif /* IMAGE_DECOMPRESS_STREAM */
@@ -8,8 +8,12 @@
 #include <errno.h>
 #include <string.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
 
 /*******************************************************************************
  * The 'rt_svc_descs' array holds the runtime service descriptors exported by
@@ -25,6 +29,74 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if ENABLE_RT_SVC_STATS
+/*******************************************************************************
+ * Statistics are kept per CPU so that accounting takes no lock, and indexed
+ * by unique OEN like 'rt_svc_descs_indices'.
+ ******************************************************************************/
+static rt_svc_stats_t rt_svc_stats[PLATFORM_CORE_COUNT][MAX_RT_SVCS];
+
+static void rt_svc_stats_update(unsigned int idx, uint64_t ticks)
+{
+	rt_svc_stats_t *stats = &rt_svc_stats[plat_my_core_pos()][idx];
+
+	if (ticks > UINT32_MAX) {
+		ticks = UINT32_MAX;
+	}
+
+	stats->count++;
+	stats->total_ticks += ticks;
+	if (ticks > stats->max_ticks) {
+		stats->max_ticks = (uint32_t)ticks;
+	}
+}
+
+/*******************************************************************************
+ * Function to invoke the registered `handle` corresponding to the smc_fid and
+ * account the call duration. In AArch64 mode, the SMC entry code branches here
+ * once it has checked that a service is registered for the smc_fid.
+ ******************************************************************************/
+uintptr_t handle_runtime_svc_stats(uint32_t smc_fid, u_register_t x1,
+				   u_register_t x2, u_register_t x3,
+				   u_register_t x4, void *cookie, void *handle,
+				   u_register_t flags)
+{
+	const rt_svc_desc_t *rt_svc_descs;
+	unsigned int idx;
+	uint64_t start;
+	uintptr_t ret;
+
+	idx = get_unique_oen_from_smc_fid(smc_fid);
+	assert(rt_svc_descs_indices[idx] < RT_SVC_DECS_NUM);
+
+	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
+
+	start = read_cntpct_el0();
+	ret = rt_svc_descs[rt_svc_descs_indices[idx]].handle(smc_fid, x1, x2,
+							      x3, x4, cookie,
+							      handle, flags);
+	rt_svc_stats_update(idx, read_cntpct_el0() - start);
+
+	return ret;
+}
+
+/*******************************************************************************
+ * Get the statistics of the runtime service owning smc_fid on a CPU. Fast and
+ * yielding calls of a same OEN are accounted separately.
+ ******************************************************************************/
+int rt_svc_get_stats(unsigned int core_pos, uint32_t smc_fid,
+		     rt_svc_stats_t *stats)
+{
+	if (core_pos >= PLATFORM_CORE_COUNT) {
+		return -EINVAL;
+	}
+
+	*stats = rt_svc_stats[core_pos][get_unique_oen_from_smc_fid(smc_fid)];
+
+	return 0;
+}
+#endif /* ENABLE_RT_SVC_STATS */
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -37,7 +109,9 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	u_register_t x1, x2, x3, x4;
 	unsigned int index;
 	unsigned int idx;
+#if !ENABLE_RT_SVC_STATS
 	const rt_svc_desc_t *rt_svc_descs;
+#endif
 
 	assert(handle != NULL);
 	idx = get_unique_oen_from_smc_fid(smc_fid);
@@ -47,12 +121,17 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	if (index >= RT_SVC_DECS_NUM)
 		SMC_RET1(handle, SMC_UNK);
 
-	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
-
 	get_smc_params_from_ctx(handle, x1, x2, x3, x4);
 
+#if ENABLE_RT_SVC_STATS
+	return handle_runtime_svc_stats(smc_fid, x1, x2, x3, x4, cookie,
+					handle, flags);
+#else
+	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
+
 	return rt_svc_descs[index].handle(smc_fid, x1, x2, x3, x4, cookie,
 						handle, flags);
+#endif
 }
 
 /*******************************************************************************
@@ -6,17 +6,23 @@
 
 #include <stdarg.h>
 #include <assert.h>
+#include <stdint.h>
 
 #include <arm_acle.h>
 #include <common/debug.h>
 #include <common/tf_crc32.h>
 
+/* Word loads from the byte buffer, once it is aligned */
+typedef uint32_t __attribute__((__may_alias__)) crc32_word_t;
+typedef uint64_t __attribute__((__may_alias__)) crc32_dword_t;
+
 /* compute CRC using Arm intrinsic function
  *
  * This function is useful for the platforms with the CPU ARMv8.0
  * (with CRC instructions supported), and onwards.
  * Platforms with CPU ARMv8.0 should make sure to add a compile switch
  * '-march=armv8-a+crc" for successful compilation of this file.
+ * Once the buffer is aligned, it is processed a register at a time.
  *
  * @crc: previous accumulated CRC
  * @buf: buffer base address
@@ -33,8 +39,29 @@ uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
 	size_t local_size = size;
 
 	/*
-	 * calculate CRC over byte data
+	 * calculate CRC over byte data, until the buffer is aligned
 	 */
+	while ((local_size != 0UL) &&
+	       (((uintptr_t)local_buf & (sizeof(uintptr_t) - 1U)) != 0U)) {
+		calc_crc = __crc32b(calc_crc, *local_buf);
+		local_buf++;
+		local_size--;
+	}
+
+#ifdef __aarch64__
+	while (local_size >= sizeof(uint64_t)) {
+		calc_crc = __crc32d(calc_crc, *(const crc32_dword_t *)local_buf);
+		local_buf += sizeof(uint64_t);
+		local_size -= sizeof(uint64_t);
+	}
+#endif
+
+	while (local_size >= sizeof(uint32_t)) {
+		calc_crc = __crc32w(calc_crc, *(const crc32_word_t *)local_buf);
+		local_buf += sizeof(uint32_t);
+		local_size -= sizeof(uint32_t);
+	}
+
 	while (local_size != 0UL) {
 		calc_crc = __crc32b(calc_crc, *local_buf);
 		local_buf++;
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/tf_crc32.h>
+
+#define CRC32_POLY		0xEDB88320U	/* Reflected IEEE 802.3 */
+#define CRC32_SLICES		8U
+
+/* Word loads from the byte buffer, once it is aligned */
+typedef uint32_t __attribute__((__may_alias__)) crc32_word_t;
+
+/*
+ * crc32_table[0] is the usual byte-wise table, crc32_table[n] gives the CRC
+ * of a byte followed by n null bytes: the CRC of 8 bytes is then the XOR of
+ * 8 lookups. The 8KB of tables are computed on first use.
+ */
+static uint32_t crc32_table[CRC32_SLICES][256];
+static bool crc32_table_ready;
+
+static void crc32_init_tables(void)
+{
+	unsigned int i;
+	unsigned int j;
+
+	for (i = 0U; i < 256U; i++) {
+		uint32_t c = i;
+
+		for (j = 0U; j < 8U; j++) {
+			c = ((c & 1U) != 0U) ? ((c >> 1) ^ CRC32_POLY) : (c >> 1);
+		}
+
+		crc32_table[0][i] = c;
+	}
+
+	for (i = 0U; i < 256U; i++) {
+		for (j = 1U; j < CRC32_SLICES; j++) {
+			uint32_t c = crc32_table[j - 1U][i];
+
+			crc32_table[j][i] = (c >> 8) ^ crc32_table[0][c & 0xFFU];
+		}
+	}
+
+	crc32_table_ready = true;
+}
+
+/* compute CRC using slicing-by-8 tables
+ *
+ * This function is useful for the platforms whose CPU has no CRC
+ * instructions, like Armv7-A ones, where it runs several times faster
+ * than a byte-wise table.
+ *
+ * @crc: previous accumulated CRC
+ * @buf: buffer base address
+ * @size: the size of the buffer
+ *
+ * Return calculated CRC value
+ */
+uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
+{
+	assert(buf != NULL);
+
+	uint32_t calc_crc = ~crc;
+	const unsigned char *local_buf = buf;
+	size_t local_size = size;
+
+	if (!crc32_table_ready) {
+		crc32_init_tables();
+	}
+
+	/* Byte-wise until the buffer is word aligned */
+	while ((local_size != 0UL) &&
+	       (((uintptr_t)local_buf & (sizeof(uint32_t) - 1U)) != 0U)) {
+		calc_crc = crc32_table[0][(calc_crc ^ *local_buf) & 0xFFU] ^
+			   (calc_crc >> 8);
+		local_buf++;
+		local_size--;
+	}
+
+	while (local_size >= CRC32_SLICES) {
+		uint32_t lo = *(const crc32_word_t *)local_buf ^ calc_crc;
+		uint32_t hi = *(const crc32_word_t *)(local_buf + 4);
+
+		calc_crc = crc32_table[7][lo & 0xFFU] ^
+			   crc32_table[6][(lo >> 8) & 0xFFU] ^
+			   crc32_table[5][(lo >> 16) & 0xFFU] ^
+			   crc32_table[4][lo >> 24] ^
+			   crc32_table[3][hi & 0xFFU] ^
+			   crc32_table[2][(hi >> 8) & 0xFFU] ^
+			   crc32_table[1][(hi >> 16) & 0xFFU] ^
+			   crc32_table[0][hi >> 24];
+		local_buf += CRC32_SLICES;
+		local_size -= CRC32_SLICES;
+	}
+
+	while (local_size != 0UL) {
+		calc_crc = crc32_table[0][(calc_crc ^ *local_buf) & 0xFFU] ^
+			   (calc_crc >> 8);
+		local_buf++;
+		local_size--;
+	}
+
+	return ~calc_crc;
+}
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2017-2019, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdarg.h>
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include <common/debug.h>
@@ -49,6 +50,76 @@ void tf_log(const char *fmt, ...)
 	va_end(args);
 }
 
+#if ENABLE_LOG_TOKENS
+/* Image the format strings belong to, see tf_log_tokens.h */
+#if defined(IMAGE_BL1)
+#define LOG_TOKEN_IMAGE		1U
+#elif defined(IMAGE_BL2)
+#define LOG_TOKEN_IMAGE		2U
+#elif defined(IMAGE_BL2U)
+#define LOG_TOKEN_IMAGE		3U
+#elif defined(IMAGE_BL31)
+#define LOG_TOKEN_IMAGE		31U
+#else
+#define LOG_TOKEN_IMAGE		32U
+#endif
+
+static void tf_log_token_put(unsigned long long val, unsigned int size)
+{
+	unsigned int i;
+
+	for (i = 0U; i < size; i++) {
+		unsigned int c = (unsigned int)val & 0xFFU;
+
+		if ((c == LOG_TOKEN_SYNC) || (c == LOG_TOKEN_ESC) ||
+		    (c == (unsigned int)'\n') || (c == (unsigned int)'\r')) {
+			(void)putchar((int)LOG_TOKEN_ESC);
+			c ^= LOG_TOKEN_ESC_XOR;
+		}
+
+		(void)putchar((int)c);
+		val >>= 8;
+	}
+}
+
+/*
+ * The log function invoked by the log macros defined in debug.h with
+ * ENABLE_LOG_TOKENS. fmt is only used as a token: the format strings are not
+ * loaded with the image. info is built by LOG_TOKEN_INFO().
+ */
+void tf_log_token(const char *fmt, unsigned int info, ...)
+{
+	unsigned int log_level = LOG_TOKEN_LEVEL(info);
+	unsigned int nargs = LOG_TOKEN_NARGS(info);
+	unsigned int wide = LOG_TOKEN_WIDE_MASK(info);
+	unsigned int i;
+	va_list args;
+
+	assert((log_level > 0U) && (log_level <= LOG_LEVEL_VERBOSE));
+	assert((log_level % 10U) == 0U);
+	assert(nargs <= LOG_TOKEN_MAX_ARGS);
+
+	if (log_level > max_log_level)
+		return;
+
+	(void)putchar((int)LOG_TOKEN_SYNC);
+	tf_log_token_put(LOG_TOKEN_IMAGE, 1U);
+	tf_log_token_put((uintptr_t)fmt, 4U);
+	tf_log_token_put(nargs, 1U);
+	tf_log_token_put(wide, 2U);
+
+	va_start(args, info);
+	for (i = 0U; i < nargs; i++) {
+		if ((wide & (1U << i)) != 0U) {
+			tf_log_token_put(va_arg(args, unsigned long long), 8U);
+		} else {
+			tf_log_token_put(va_arg(args, unsigned int), 4U);
+		}
+	}
+	va_end(args);
+}
+#endif /* ENABLE_LOG_TOKENS */
+
 void tf_log_newline(const char log_fmt[2])
 {
 	unsigned int log_level = log_fmt[0];
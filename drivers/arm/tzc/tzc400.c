@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include <common/debug.h>
@@ -72,6 +73,22 @@ DEFINE_TZC_COMMON_UPDATE_FILTERS(400, 400)
 DEFINE_TZC_COMMON_CONFIGURE_REGION0(400)
 DEFINE_TZC_COMMON_CONFIGURE_REGION(400)
 
+static void _tzc400_read_region(uintptr_t base, unsigned int region_no,
+				struct tzc400_region *region)
+{
+	uintptr_t reg = base + TZC_REGION_OFFSET(TZC_400_REGION_SIZE,
+						 (u_register_t)region_no);
+
+	region->base = ((unsigned long long)mmio_read_32(reg +
+				TZC_400_REGION_BASE_HIGH_0_OFFSET) << 32) |
+		       mmio_read_32(reg + TZC_400_REGION_BASE_LOW_0_OFFSET);
+	region->top = ((unsigned long long)mmio_read_32(reg +
+				TZC_400_REGION_TOP_HIGH_0_OFFSET) << 32) |
+		      mmio_read_32(reg + TZC_400_REGION_TOP_LOW_0_OFFSET);
+	region->attributes = mmio_read_32(reg + TZC_400_REGION_ATTR_0_OFFSET);
+	region->id_access = mmio_read_32(reg + TZC_400_REGION_ID_ACCESS_0_OFFSET);
+}
+
 static void _tzc400_clear_it(uintptr_t base, uint32_t filter)
 {
 	mmio_write_32(base + INT_CLEAR, BIT_32(filter));
@@ -281,6 +298,97 @@ void tzc400_update_filters(unsigned int region, unsigned int filters)
 	_tzc400_update_filters(tzc400.base, region, tzc400.num_filters, filters);
 }
 
+/*
+ * `tzc400_get_regions` reads back the configuration of `count` regions,
+ * starting at region `first`, e.g. to save it before a low power mode.
+ */
+void tzc400_get_regions(unsigned int first, struct tzc400_region *regions,
+			unsigned int count)
+{
+	unsigned int i;
+
+	assert(tzc400.base != 0U);
+	assert((first + count) <= tzc400.num_regions);
+
+	for (i = 0U; i < count; i++) {
+		_tzc400_read_region(tzc400.base, first + i, &regions[i]);
+	}
+}
+
+/*
+ * `tzc400_configure_regions` programs `count` regions, starting at region
+ * `first`, from a table. Only the registers that differ from the current
+ * controller state are written, so regions already set are never disabled.
+ * A region whose range or NSAID permissions change is first disabled on all
+ * filters, its attributes being written last. Returns the number of regions
+ * that were updated.
+ */
+unsigned int tzc400_configure_regions(unsigned int first,
+				      const struct tzc400_region *regions,
+				      unsigned int count)
+{
+	unsigned int i;
+	unsigned int updated = 0U;
+
+	assert(tzc400.base != 0U);
+	assert((first != 0U) && ((first + count) <= tzc400.num_regions));
+
+	for (i = 0U; i < count; i++) {
+		const struct tzc400_region *new = &regions[i];
+		unsigned int region_no = first + i;
+		struct tzc400_region cur;
+		bool range_changed;
+
+		assert((((new->attributes >> TZC_REGION_ATTR_F_EN_SHIFT) &
+			 TZC_400_REGION_ATTR_F_EN_MASK) >>
+			tzc400.num_filters) == 0U);
+
+		_tzc400_read_region(tzc400.base, region_no, &cur);
+
+		range_changed = (cur.base != new->base) ||
+				(cur.top != new->top) ||
+				(cur.id_access != new->id_access);
+
+		if (!range_changed && (cur.attributes == new->attributes)) {
+			continue;
+		}
+
+		if (range_changed) {
+			uint32_t f_en = TZC_400_REGION_ATTR_F_EN_MASK <<
+					TZC_REGION_ATTR_F_EN_SHIFT;
+
+			if ((cur.attributes & f_en) != 0U) {
+				_tzc400_write_region_attributes(tzc400.base,
+								region_no,
+								cur.attributes &
+								~f_en);
+			}
+
+			if (cur.base != new->base) {
+				_tzc400_write_region_base(tzc400.base,
+							  region_no, new->base);
+			}
+
+			if (cur.top != new->top) {
+				_tzc400_write_region_top(tzc400.base,
+							 region_no, new->top);
+			}
+
+			if (cur.id_access != new->id_access) {
+				_tzc400_write_region_id_access(tzc400.base,
+							       region_no,
+							       new->id_access);
+			}
+		}
+
+		_tzc400_write_region_attributes(tzc400.base, region_no,
+						new->attributes);
+		updated++;
+	}
+
+	return updated;
+}
+
 void tzc400_enable_filters(void)
 {
 	unsigned int state;
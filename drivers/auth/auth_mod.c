@@ -5,6 +5,8 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -33,6 +35,170 @@
 #pragma weak plat_set_nv_ctr2
 #pragma weak plat_get_hashed_pk
 
+#if AUTH_STREAM_HASH
+/* Image being hashed while it is loaded */
+static struct {
+	unsigned int img_id;
+	bool active;
+} stream_hash;
+#endif
+
+#if MEASURED_BOOT
+#define AUTH_DIGEST_INFO_MAX_SIZE	96U
+
+/*
+ * Digest info of the last data authenticated by their hash, given to the
+ * measured boot driver to avoid hashing the same bytes again.
+ */
+static struct {
+	uintptr_t data_base;
+	unsigned int data_len;
+	unsigned int digest_info_len;
+	uint8_t digest_info[AUTH_DIGEST_INFO_MAX_SIZE];
+} img_digest;
+
+static void save_img_digest(void *data_ptr, unsigned int data_len,
+			    void *digest_info_ptr,
+			    unsigned int digest_info_len)
+{
+	if (digest_info_len > sizeof(img_digest.digest_info)) {
+		return;
+	}
+
+	(void)memcpy(img_digest.digest_info, digest_info_ptr,
+		     digest_info_len);
+	img_digest.digest_info_len = digest_info_len;
+	img_digest.data_base = (uintptr_t)data_ptr;
+	img_digest.data_len = data_len;
+}
+
+static void clear_img_digest(void)
+{
+	img_digest.data_len = 0U;
+}
+#else
+static inline void save_img_digest(void *data_ptr, unsigned int data_len,
+				   void *digest_info_ptr,
+				   unsigned int digest_info_len)
+{
+}
+
+static inline void clear_img_digest(void)
+{
+}
+#endif
+
+#if AUTH_CERT_CACHE
+#ifndef AUTH_CERT_CACHE_SIZE
+#define AUTH_CERT_CACHE_SIZE		4096U
+#endif
+#define AUTH_CERT_CACHE_ENTRIES		8U
+
+/*
+ * Certificates already authenticated during this boot. The pool holds a copy
+ * of each certificate, followed by the parameters extracted from it.
+ */
+struct cert_cache_entry {
+	unsigned int img_id;
+	unsigned int img_len;
+	unsigned int param_len[COT_MAX_VERIFIED_PARAMS];
+	size_t offset;
+};
+
+static struct {
+	struct cert_cache_entry entry[AUTH_CERT_CACHE_ENTRIES];
+	unsigned int nb_entries;
+	size_t used;
+	uint8_t pool[AUTH_CERT_CACHE_SIZE];
+} cert_cache;
+
+/*
+ * Look for an identical certificate authenticated earlier. On success, the
+ * parameters extracted from it are restored for its children images.
+ */
+static bool cert_cache_lookup(const auth_img_desc_t *img_desc,
+			      void *img_ptr, unsigned int img_len)
+{
+	const struct cert_cache_entry *entry;
+	const uint8_t *data;
+	unsigned int i;
+	unsigned int j;
+
+	for (i = 0U; i < cert_cache.nb_entries; i++) {
+		entry = &cert_cache.entry[i];
+
+		if ((entry->img_id != img_desc->img_id) ||
+		    (entry->img_len != img_len)) {
+			continue;
+		}
+
+		data = &cert_cache.pool[entry->offset];
+		if (memcmp(data, img_ptr, img_len) != 0) {
+			continue;
+		}
+
+		data += img_len;
+		if (img_desc->authenticated_data != NULL) {
+			for (j = 0U; j < COT_MAX_VERIFIED_PARAMS; j++) {
+				if (img_desc->authenticated_data[j].type_desc ==
+				    NULL) {
+					continue;
+				}
+
+				memcpy(img_desc->authenticated_data[j].data.ptr,
+				       data, entry->param_len[j]);
+				data += entry->param_len[j];
+			}
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+static void cert_cache_store(const auth_img_desc_t *img_desc,
+			     void *img_ptr, unsigned int img_len,
+			     const unsigned int *param_len)
+{
+	struct cert_cache_entry *entry;
+	size_t size = img_len;
+	uint8_t *data;
+	unsigned int i;
+
+	for (i = 0U; i < COT_MAX_VERIFIED_PARAMS; i++) {
+		size += param_len[i];
+	}
+
+	if ((cert_cache.nb_entries == AUTH_CERT_CACHE_ENTRIES) ||
+	    (size > (sizeof(cert_cache.pool) - cert_cache.used))) {
+		VERBOSE("Certificate cache full, image %u not cached\n",
+			img_desc->img_id);
+		return;
+	}
+
+	entry = &cert_cache.entry[cert_cache.nb_entries];
+	entry->img_id = img_desc->img_id;
+	entry->img_len = img_len;
+	entry->offset = cert_cache.used;
+
+	data = &cert_cache.pool[entry->offset];
+	memcpy(data, img_ptr, img_len);
+	data += img_len;
+
+	for (i = 0U; i < COT_MAX_VERIFIED_PARAMS; i++) {
+		entry->param_len[i] = param_len[i];
+		if (param_len[i] != 0U) {
+			memcpy(data, img_desc->authenticated_data[i].data.ptr,
+			       param_len[i]);
+			data += param_len[i];
+		}
+	}
+
+	cert_cache.used += size;
+	cert_cache.nb_entries++;
+}
+#endif /* AUTH_CERT_CACHE */
 
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
@@ -107,6 +273,21 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			&hash_der_ptr, &hash_der_len);
 	return_if_error(rc);
 
+#if AUTH_STREAM_HASH
+	/* The image has been hashed while it was loaded */
+	if (stream_hash.active && (stream_hash.img_id == img_desc->img_id)) {
+		stream_hash.active = false;
+
+		rc = crypto_mod_hash_stream_finish();
+		if (rc == 0) {
+			save_img_digest(img, img_len, hash_der_ptr,
+					hash_der_len);
+		}
+
+		return rc;
+	}
+#endif
+
 	/* Get the data to be hashed from the current image */
 	rc = img_parser_get_auth_param(img_desc->img_type, param->data,
 			img, img_len, &data_ptr, &data_len);
@@ -115,10 +296,138 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
+	if (rc == 0) {
+		save_img_digest(data_ptr, data_len, hash_der_ptr,
+				hash_der_len);
+	}
+
+	return rc;
+}
+
+#if MEASURED_BOOT
+/*
+ * Get the digest info of data authenticated by their hash
+ *
+ * Only the last data authenticated by auth_mod_verify_img() are known, and
+ * only until they are requested: the caller is expected to measure an image
+ * right after its authentication.
+ *
+ * Return: 0 = digest info found, Otherwise = these data must be hashed
+ */
+int auth_mod_get_img_digest_info(uintptr_t data_base, unsigned int data_len,
+				 const void **digest_info_ptr,
+				 unsigned int *digest_info_len)
+{
+	if ((img_digest.data_len == 0U) ||
+	    (img_digest.data_base != data_base) ||
+	    (img_digest.data_len != data_len)) {
+		return -ENOENT;
+	}
+
+	*digest_info_ptr = img_digest.digest_info;
+	*digest_info_len = img_digest.digest_info_len;
+
+	clear_img_digest();
+
+	return 0;
+}
+#endif
+
+/*
+ * Get the hash an image authenticated by 'AUTH_METHOD_HASH' must match
+ *
+ * The hash is DER encoded, with the hash algorithm, and is only known once the
+ * parent image has been authenticated. It can be given to a later stage that
+ * loads the image itself.
+ *
+ * Return: 0 = success, Otherwise = the image is not authenticated by its hash
+ */
+int auth_mod_get_img_hash(unsigned int img_id, void **hash_der_ptr,
+			  unsigned int *hash_der_len)
+{
+	const auth_img_desc_t *img_desc;
+	int i;
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL) ||
+	    (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		if (img_desc->img_auth_methods[i].type == AUTH_METHOD_HASH) {
+			return auth_get_param(
+				img_desc->img_auth_methods[i].param.hash.hash,
+				img_desc->parent, hash_der_ptr, hash_der_len);
+		}
+	}
+
+	return 1;
+}
+
+#if AUTH_STREAM_HASH
+/*
+ * Start hashing an image before it is loaded
+ *
+ * This is possible for a raw image authenticated by 'AUTH_METHOD_HASH', once
+ * its parent has been authenticated: the expected hash is then known. The
+ * image data is then given to auth_mod_stream_hash_update() while it is
+ * loaded, and the result is used by auth_mod_verify_img().
+ *
+ * Return: 0 = streaming started, Otherwise = the image is not hashed while
+ * it is loaded
+ */
+int auth_mod_stream_hash_start(unsigned int img_id)
+{
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc;
+
+	stream_hash.active = false;
+
+	rc = auth_mod_get_img_hash(img_id, &hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_hash_stream_start(hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	stream_hash.img_id = img_id;
+	stream_hash.active = true;
+
+	return 0;
+}
+
+/*
+ * Add a part of the image being loaded to the hash in progress
+ *
+ * Return: 0 = success, Otherwise = error, the streaming is stopped
+ */
+int auth_mod_stream_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	if (!stream_hash.active) {
+		return 1;
+	}
+
+	rc = crypto_mod_hash_stream_update(data_ptr, data_len);
+	if (rc != 0) {
+		stream_hash.active = false;
+	}
 
 	return rc;
 }
 
+/*
+ * Check if an image is being hashed while it is loaded
+ */
+bool auth_mod_stream_hash_is_active(void)
+{
+	return stream_hash.active;
+}
+#endif /* AUTH_STREAM_HASH */
+
 /*
  * Authenticate by digital signature
  *
@@ -378,10 +687,24 @@ int auth_mod_verify_img(unsigned int img_id,
 	bool need_nv_ctr_upgrade = false;
 	bool sig_auth_done = false;
 	const auth_method_param_nv_ctr_t *nv_ctr_param = NULL;
+#if AUTH_CERT_CACHE
+	unsigned int param_len_cache[COT_MAX_VERIFIED_PARAMS] = { 0U };
+#endif
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
 
+	clear_img_digest();
+
+#if AUTH_CERT_CACHE
+	/* Skip certificates already authenticated with the same content */
+	if ((img_desc->img_type == IMG_CERT) &&
+	    cert_cache_lookup(img_desc, img_ptr, img_len)) {
+		auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
+		return 0;
+	}
+#endif
+
 	/* Ask the parser to check the image integrity */
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
@@ -451,9 +774,18 @@ int auth_mod_verify_img(unsigned int img_id,
 			/* Copy the parameter for later use */
 			memcpy((void *)img_desc->authenticated_data[i].data.ptr,
 					(void *)param_ptr, param_len);
+#if AUTH_CERT_CACHE
+			param_len_cache[i] = param_len;
+#endif
 		}
 	}
 
+#if AUTH_CERT_CACHE
+	if (img_desc->img_type == IMG_CERT) {
+		cert_cache_store(img_desc, img_ptr, img_len, param_len_cache);
+	}
+#endif
+
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
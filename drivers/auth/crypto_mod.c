@@ -104,6 +104,47 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 					   digest_info_ptr, digest_info_len);
 }
 
+#if AUTH_STREAM_HASH
+/*
+ * Start a hash of data provided in successive parts
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared at the end
+ */
+int crypto_mod_hash_stream_start(void *digest_info_ptr,
+				 unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0U);
+
+	return crypto_hash_stream_desc.start(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add a part of the data to the hash in progress
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_stream_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0U);
+
+	return crypto_hash_stream_desc.update(data_ptr, data_len);
+}
+
+/*
+ * Complete the hash in progress and compare it with the expected one
+ */
+int crypto_mod_hash_stream_finish(void)
+{
+	return crypto_hash_stream_desc.finish();
+}
+#endif /* AUTH_STREAM_HASH */
+
 #if MEASURED_BOOT
 /*
  * Calculate a hash
@@ -156,3 +197,59 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 					    key_len, key_flags, iv, iv_len, tag,
 					    tag_len);
 }
+
+#if DECRYPTION_STREAM
+/*
+ * Start an authenticated decryption of data provided in successive parts
+ *
+ * Parameters:
+ *
+ *   dec_algo: authenticated decryption algorithm
+ *   key, key_len, key_flags: symmetric decryption key
+ *   iv, iv_len: initialization vector
+ */
+int crypto_mod_auth_decrypt_stream_start(enum crypto_dec_algo dec_algo,
+					 const void *key, unsigned int key_len,
+					 unsigned int key_flags,
+					 const void *iv, unsigned int iv_len)
+{
+	assert(key != NULL);
+	assert(key_len != 0U);
+	assert(iv != NULL);
+	assert((iv_len != 0U) && (iv_len <= CRYPTO_MAX_IV_SIZE));
+
+	return crypto_dec_stream_desc.start(dec_algo, key, key_len, key_flags,
+					    iv, iv_len);
+}
+
+/*
+ * Decrypt in place a part of the data
+ *
+ * Parameters:
+ *
+ *   data_ptr, len: data to be decrypted (inout param)
+ */
+int crypto_mod_auth_decrypt_stream_update(void *data_ptr, size_t len)
+{
+	assert(data_ptr != NULL);
+	assert(len != 0U);
+
+	return crypto_dec_stream_desc.update(data_ptr, len);
+}
+
+/*
+ * Complete the decryption in progress and check the authentication tag
+ *
+ * Parameters:
+ *
+ *   tag, tag_len: authentication tag
+ */
+int crypto_mod_auth_decrypt_stream_finish(const void *tag,
+					  unsigned int tag_len)
+{
+	assert(tag != NULL);
+	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
+
+	return crypto_dec_stream_desc.finish(tag, tag_len);
+}
+#endif /* DECRYPTION_STREAM */
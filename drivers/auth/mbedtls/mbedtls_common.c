@@ -6,6 +6,8 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 /* mbed TLS headers */
 #include <mbedtls/memory_buffer_alloc.h>
@@ -14,6 +16,7 @@
 #include <common/debug.h>
 #include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <drivers/auth/mbedtls/mbedtls_config.h>
+#include <lib/utils_def.h>
 #include <plat/common/platform.h>
 
 static void cleanup(void)
@@ -22,6 +25,127 @@ static void cleanup(void)
 	panic();
 }
 
+#if TF_MBEDTLS_HEAP_ARENA
+#define ARENA_ALIGN		8U
+#define ARENA_NO_BLOCK		UINT32_MAX
+#define ARENA_BLOCK_FREED	BIT_32(31)
+
+/*
+ * Arena allocator: blocks are stacked, each one preceded by a header. A freed
+ * block is released with all freed blocks below the top of the arena, which
+ * empties it once the contexts of an image verification are freed.
+ */
+struct arena_block {
+	uint32_t prev;	/* Offset of the previous block header */
+	uint32_t size;	/* Data size, with ARENA_BLOCK_FREED once freed */
+};
+
+static struct {
+	uint8_t *base;
+	size_t size;
+	size_t used;
+	size_t max_used;
+	uint32_t last;
+} arena;
+
+static void *arena_calloc(size_t nmemb, size_t size)
+{
+	struct arena_block *blk;
+	size_t avail = arena.size - arena.used;
+	size_t len;
+
+	if ((nmemb == 0U) || (size == 0U) || (size > (SIZE_MAX / nmemb))) {
+		return NULL;
+	}
+
+	if (avail < sizeof(*blk)) {
+		return NULL;
+	}
+	avail -= sizeof(*blk);
+
+	len = nmemb * size;
+	if (len > avail) {
+		return NULL;
+	}
+
+	len = round_up(len, ARENA_ALIGN);
+	if (len > avail) {
+		return NULL;
+	}
+
+	blk = (struct arena_block *)(arena.base + arena.used);
+	blk->prev = arena.last;
+	blk->size = (uint32_t)len;
+
+	arena.last = (uint32_t)arena.used;
+	arena.used += sizeof(*blk) + len;
+	if (arena.used > arena.max_used) {
+		arena.max_used = arena.used;
+	}
+
+	(void)memset(blk + 1, 0, len);
+
+	return blk + 1;
+}
+
+static void arena_free(void *ptr)
+{
+	struct arena_block *blk;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	blk = (struct arena_block *)ptr - 1;
+	assert((blk->size & ARENA_BLOCK_FREED) == 0U);
+	blk->size |= ARENA_BLOCK_FREED;
+
+	while (arena.last != ARENA_NO_BLOCK) {
+		blk = (struct arena_block *)(arena.base + arena.last);
+		if ((blk->size & ARENA_BLOCK_FREED) == 0U) {
+			break;
+		}
+
+		arena.used = arena.last;
+		arena.last = blk->prev;
+	}
+}
+
+static void arena_init(void *heap_addr, size_t heap_size)
+{
+	uintptr_t base = round_up((uintptr_t)heap_addr, ARENA_ALIGN);
+
+	assert(heap_size > (base - (uintptr_t)heap_addr));
+
+	arena.base = (uint8_t *)base;
+	arena.size = heap_size - (base - (uintptr_t)heap_addr);
+	arena.used = 0U;
+	arena.max_used = 0U;
+	arena.last = ARENA_NO_BLOCK;
+	assert(arena.size > sizeof(struct arena_block));
+
+	mbedtls_platform_set_calloc_free(arena_calloc, arena_free);
+}
+
+/*
+ * Print the most space used in the mbed TLS heap, headers included, to help
+ * adjusting the heap size.
+ */
+void mbedtls_heap_print_usage(void)
+{
+	INFO("mbed TLS heap: %u/%u bytes used at most, %u in use\n",
+	     (unsigned int)arena.max_used, (unsigned int)arena.size,
+	     (unsigned int)arena.used);
+}
+
+/* Most space used in the mbed TLS heap, headers included, and its size */
+void mbedtls_heap_get_usage(size_t *max_used, size_t *size)
+{
+	*max_used = arena.max_used;
+	*size = arena.size;
+}
+#endif /* TF_MBEDTLS_HEAP_ARENA */
+
 /*
  * mbed TLS initialization function
  */
@@ -46,7 +170,11 @@ void mbedtls_init(void)
 		assert(heap_size >= TF_MBEDTLS_HEAP_SIZE);
 
 		/* Initialize the mbed TLS heap */
+#if TF_MBEDTLS_HEAP_ARENA
+		arena_init(heap_addr, heap_size);
+#else
 		mbedtls_memory_buffer_alloc_init(heap_addr, heap_size);
+#endif
 
 #ifdef MBEDTLS_PLATFORM_SNPRINTF_ALT
 		mbedtls_platform_set_snprintf(snprintf);
@@ -90,6 +90,27 @@ else
     $(error "TF_MBEDTLS_KEY_ALG=${TF_MBEDTLS_KEY_ALG} not supported on mbed TLS")
 endif
 
+# The platform may set 'TF_MBEDTLS_SHA_NEON' to 1 to replace the SHA-256 and
+# SHA-512 block functions of mbed TLS by NEON ones, on AArch32 only.
+TF_MBEDTLS_SHA_NEON	?=	0
+$(eval $(call assert_boolean,TF_MBEDTLS_SHA_NEON))
+
+ifeq (${TF_MBEDTLS_SHA_NEON},1)
+    ifneq (${ARCH},aarch32)
+        $(error "TF_MBEDTLS_SHA_NEON=1 requires ARCH=aarch32")
+    endif
+    ifneq (${ARM_WITH_NEON},yes)
+        $(error "TF_MBEDTLS_SHA_NEON=1 requires ARM_WITH_NEON=yes")
+    endif
+    LIBMBEDTLS_SRCS	+=	drivers/auth/mbedtls/mbedtls_sha_neon.c	\
+				drivers/auth/mbedtls/aarch32/sha_block_neon.S
+endif
+
+# The platform may set 'TF_MBEDTLS_HEAP_ARENA' to 1 to use a stack-like arena
+# allocator for the mbed TLS heap, instead of the mbed TLS buffer allocator.
+TF_MBEDTLS_HEAP_ARENA	?=	0
+$(eval $(call assert_boolean,TF_MBEDTLS_HEAP_ARENA))
+
 ifeq (${DECRYPTION_SUPPORT}, aes_gcm)
     TF_MBEDTLS_USE_AES_GCM	:=	1
 else
@@ -102,6 +123,8 @@ $(eval $(call add_defines,\
         TF_MBEDTLS_KEY_ALG_ID \
         TF_MBEDTLS_KEY_SIZE \
         TF_MBEDTLS_HASH_ALG_ID \
+        TF_MBEDTLS_HEAP_ARENA \
+        TF_MBEDTLS_SHA_NEON \
         TF_MBEDTLS_USE_AES_GCM \
 )))
 
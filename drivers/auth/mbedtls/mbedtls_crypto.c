@@ -140,19 +140,16 @@ end2:
 }
 
 /*
- * Match a hash
- *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Extract the message digest algorithm and the hash from a digest info, passed
+ * in DER format following the ASN.1 structure detailed above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -176,8 +173,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -188,20 +185,42 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
-	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+	rc = mbedtls_md(md_info, (unsigned char *)data_ptr, data_len,
+			data_hash);
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
 
 	/* Compare values */
-	rc = memcmp(data_hash, hash, mbedtls_md_get_size(md_info));
+	rc = timingsafe_bcmp(data_hash, hash, mbedtls_md_get_size(md_info));
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -209,6 +228,80 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+#if AUTH_STREAM_HASH
+static mbedtls_md_context_t stream_md_ctx;
+static unsigned char stream_hash[MBEDTLS_MD_MAX_SIZE];
+static size_t stream_hash_len;
+
+/*
+ * Start a hash of data given in successive parts, to be compared with the one
+ * of the digest info.
+ */
+static int hash_stream_start(void *digest_info_ptr,
+			     unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	stream_hash_len = mbedtls_md_get_size(md_info);
+	memcpy(stream_hash, hash, stream_hash_len);
+
+	mbedtls_md_free(&stream_md_ctx);
+	mbedtls_md_init(&stream_md_ctx);
+
+	rc = mbedtls_md_setup(&stream_md_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&stream_md_ctx);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int hash_stream_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	rc = mbedtls_md_update(&stream_md_ctx, (unsigned char *)data_ptr,
+			       data_len);
+	if (rc != 0) {
+		mbedtls_md_free(&stream_md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int hash_stream_finish(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = mbedtls_md_finish(&stream_md_ctx, data_hash);
+	if (rc == 0) {
+		rc = timingsafe_bcmp(data_hash, stream_hash, stream_hash_len);
+	}
+
+	mbedtls_md_free(&stream_md_ctx);
+
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+#endif /* AUTH_STREAM_HASH */
+
 #if MEASURED_BOOT
 /*
  * Calculate a hash
@@ -301,6 +394,89 @@ exit_gcm:
 	return rc;
 }
 
+#if DECRYPTION_STREAM
+static mbedtls_gcm_context stream_gcm_ctx;
+
+/*
+ * Start an authenticated decryption of data given in successive parts
+ */
+static int auth_decrypt_stream_start(enum crypto_dec_algo dec_algo,
+				     const void *key, unsigned int key_len,
+				     unsigned int key_flags, const void *iv,
+				     unsigned int iv_len)
+{
+	int rc;
+
+	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
+
+	if (dec_algo != CRYPTO_GCM_DECRYPT) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	mbedtls_gcm_init(&stream_gcm_ctx);
+
+	rc = mbedtls_gcm_setkey(&stream_gcm_ctx, MBEDTLS_CIPHER_ID_AES, key,
+				key_len * 8);
+	if (rc == 0) {
+		rc = mbedtls_gcm_starts(&stream_gcm_ctx, MBEDTLS_GCM_DECRYPT,
+					iv, iv_len, NULL, 0);
+	}
+
+	if (rc != 0) {
+		mbedtls_gcm_free(&stream_gcm_ctx);
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int auth_decrypt_stream_update(void *data_ptr, size_t len)
+{
+	unsigned char buf[DEC_OP_BUF_SIZE];
+	unsigned char *pt = data_ptr;
+	size_t dec_len;
+	int rc;
+
+	while (len > 0) {
+		dec_len = MIN(sizeof(buf), len);
+
+		rc = mbedtls_gcm_update(&stream_gcm_ctx, dec_len, pt, buf);
+		if (rc != 0) {
+			return CRYPTO_ERR_DECRYPTION;
+		}
+
+		memcpy(pt, buf, dec_len);
+		pt += dec_len;
+		len -= dec_len;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int auth_decrypt_stream_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	int diff, i, rc;
+
+	rc = mbedtls_gcm_finish(&stream_gcm_ctx, tag_buf, sizeof(tag_buf));
+	mbedtls_gcm_free(&stream_gcm_ctx);
+
+	if (rc != 0) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	/* Check tag in "constant-time" */
+	for (diff = 0, i = 0; i < tag_len; i++)
+		diff |= ((const unsigned char *)tag)[i] ^ tag_buf[i];
+
+	if (diff != 0) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+#endif /* DECRYPTION_STREAM */
+
 /*
  * Authenticated decryption of an image
  */
@@ -348,3 +524,14 @@ REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL);
 #endif
 #endif /* MEASURED_BOOT */
+
+#if AUTH_STREAM_HASH
+REGISTER_CRYPTO_HASH_STREAM(hash_stream_start, hash_stream_update,
+			    hash_stream_finish);
+#endif
+
+#if TF_MBEDTLS_USE_AES_GCM && DECRYPTION_STREAM
+REGISTER_CRYPTO_DEC_STREAM(auth_decrypt_stream_start,
+			   auth_decrypt_stream_update,
+			   auth_decrypt_stream_finish);
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+#include <drivers/auth/mbedtls/mbedtls_sha_neon.h>
+
+/*
+ * Block processing hooks of mbed TLS, replacing its generic C
+ * implementations when TF_MBEDTLS_SHA_NEON is set.
+ */
+#if defined(MBEDTLS_SHA256_PROCESS_ALT)
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
+				    const unsigned char data[64])
+{
+	sha256_block_neon(ctx->state, data, 1U);
+
+	return 0;
+}
+#endif
+
+#if defined(MBEDTLS_SHA512_PROCESS_ALT)
+int mbedtls_internal_sha512_process(mbedtls_sha512_context *ctx,
+				    const unsigned char data[128])
+{
+	sha512_block_neon(ctx->state, data, 1U);
+
+	return 0;
+}
+#endif
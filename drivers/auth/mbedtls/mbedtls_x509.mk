@@ -1,9 +1,18 @@
 #
-# Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2022, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
 include drivers/auth/mbedtls/mbedtls_common.mk
 
+# The platform may set 'TF_X509_DER_PARSER' to 1 to parse the certificates
+# with a minimal DER parser instead of the mbed TLS ASN.1 functions.
+TF_X509_DER_PARSER	?=	0
+$(eval $(call assert_boolean,TF_X509_DER_PARSER))
+
+ifeq (${TF_X509_DER_PARSER},1)
+MBEDTLS_SOURCES	+=	drivers/auth/x509_der_parser.c
+else
 MBEDTLS_SOURCES	+=	drivers/auth/mbedtls/mbedtls_x509_parser.c
+endif
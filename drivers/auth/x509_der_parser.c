@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Minimal X509v3 parser
+ *
+ * This module checks the integrity of the ASN.1 DER structure of a X509v3
+ * certificate and extracts the authentication parameters used by the TBBR
+ * chain of trust, in place: the TBS region, the subject public key, the
+ * signature algorithm and value, and the extensions (image hashes, public
+ * keys and NV counters). It does not depend on any cryptographic library,
+ * and requested extension OIDs are compared in their DER encoding rather
+ * than converting the OID of each extension to a string.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <drivers/auth/img_parser_mod.h>
+#include <lib/utils.h>
+
+#define LIB_NAME		"X509v3 DER"
+
+/* DER tags */
+#define DER_BOOLEAN		0x01U
+#define DER_INTEGER		0x02U
+#define DER_BIT_STRING		0x03U
+#define DER_OCTET_STRING	0x04U
+#define DER_OID			0x06U
+#define DER_SEQUENCE		0x30U
+#define DER_CONTEXT(n)		(0x80U | (n))
+#define DER_CONTEXT_CONS(n)	(0xA0U | (n))
+
+/* Maximum length of the DER encoding of a requested OID */
+#define MAX_OID_DER_LEN		32U
+
+struct der_buf {
+	uint8_t *p;
+	size_t len;
+};
+
+/* Temporary variables to speed up the authentication parameters search. These
+ * variables are assigned once during the integrity check and used any time an
+ * authentication parameter is requested, so we do not have to parse the image
+ * again */
+static struct der_buf tbs;
+static struct der_buf v3_ext;
+static struct der_buf pk;
+static struct der_buf sig_alg;
+static struct der_buf signature;
+
+/*
+ * Clear all static temporary variables.
+ */
+static void clear_temp_vars(void)
+{
+#define ZERO_AND_CLEAN(x)					\
+	do {							\
+		zeromem(&x, sizeof(x));				\
+		clean_dcache_range((uintptr_t)&x, sizeof(x));	\
+	} while (0)
+
+	ZERO_AND_CLEAN(tbs);
+	ZERO_AND_CLEAN(v3_ext);
+	ZERO_AND_CLEAN(pk);
+	ZERO_AND_CLEAN(sig_alg);
+	ZERO_AND_CLEAN(signature);
+
+#undef ZERO_AND_CLEAN
+}
+
+static bool der_has_tag(const uint8_t *p, const uint8_t *end, uint8_t tag)
+{
+	return (p < end) && (*p == tag);
+}
+
+/*
+ * Read the identifier and length of the element at *p, which must have the
+ * given tag and fit before end. On success, *p points to the contents.
+ */
+static int der_get_tag(uint8_t **p, const uint8_t *end, size_t *len,
+		       uint8_t tag)
+{
+	uint8_t *q = *p;
+	size_t l;
+
+	if (((end - q) < 2) || (*q != tag)) {
+		return -1;
+	}
+	q++;
+
+	l = *q++;
+	if ((l & 0x80U) != 0U) {
+		unsigned int n = l & 0x7FU;
+
+		/* Definite length, on up to 4 bytes */
+		if ((n == 0U) || (n > 4U) || ((size_t)(end - q) < n)) {
+			return -1;
+		}
+
+		for (l = 0U; n > 0U; n--) {
+			l = (l << 8) | *q++;
+		}
+	}
+
+	if (l > (size_t)(end - q)) {
+		return -1;
+	}
+
+	*p = q;
+	*len = l;
+
+	return 0;
+}
+
+/* Skip the element at *p, recording it with its header in buf if not NULL */
+static int der_skip(uint8_t **p, const uint8_t *end, uint8_t tag,
+		    struct der_buf *buf)
+{
+	uint8_t *start = *p;
+	size_t len;
+
+	if (der_get_tag(p, end, &len, tag) != 0) {
+		return -1;
+	}
+	*p += len;
+
+	if (buf != NULL) {
+		buf->p = start;
+		buf->len = (size_t)(*p - start);
+	}
+
+	return 0;
+}
+
+/*
+ * Encode an OID string ("a.b.c...") into the contents of a DER OID.
+ * Return the encoded length, or 0 if the string is not a valid OID.
+ */
+static size_t oid_str_to_der(const char *str, uint8_t *der, size_t size)
+{
+	unsigned int arcs = 0U;
+	uint32_t first = 0U;
+	size_t len = 0U;
+
+	while (*str != '\0') {
+		uint32_t arc = 0U;
+		uint8_t tmp[5];
+		unsigned int n = 0U;
+
+		if ((*str < '0') || (*str > '9')) {
+			return 0U;
+		}
+
+		while ((*str >= '0') && (*str <= '9')) {
+			if (arc > ((UINT32_MAX - 9U) / 10U)) {
+				return 0U;
+			}
+			arc = (arc * 10U) + (uint32_t)(*str - '0');
+			str++;
+		}
+
+		if (*str == '.') {
+			str++;
+			if (*str == '\0') {
+				return 0U;
+			}
+		} else if (*str != '\0') {
+			return 0U;
+		}
+
+		arcs++;
+		if (arcs == 1U) {
+			if (arc > 2U) {
+				return 0U;
+			}
+			first = arc;
+			continue;
+		}
+
+		if (arcs == 2U) {
+			if ((first < 2U) && (arc > 39U)) {
+				return 0U;
+			}
+			if (arc > (UINT32_MAX - 80U)) {
+				return 0U;
+			}
+			arc += first * 40U;
+		}
+
+		/* Base 128, most significant group first */
+		do {
+			tmp[n++] = (uint8_t)(arc & 0x7FU);
+			arc >>= 7;
+		} while (arc != 0U);
+
+		if ((len + n) > size) {
+			return 0U;
+		}
+
+		while (n > 1U) {
+			der[len++] = tmp[--n] | 0x80U;
+		}
+		der[len++] = tmp[0];
+	}
+
+	if (arcs < 2U) {
+		return 0U;
+	}
+
+	return len;
+}
+
+/*
+ * Get X509v3 extension
+ *
+ * Global variable 'v3_ext' must point to the extensions region
+ * in the certificate. No need to check for errors since the image has passed
+ * the integrity check.
+ */
+static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+{
+	uint8_t oid_der[MAX_OID_DER_LEN];
+	size_t oid_len;
+	size_t len;
+	uint8_t *p;
+	const uint8_t *end;
+
+	assert(oid != NULL);
+
+	oid_len = oid_str_to_der(oid, oid_der, sizeof(oid_der));
+	if (oid_len == 0U) {
+		return IMG_PARSER_ERR;
+	}
+
+	p = v3_ext.p;
+	end = v3_ext.p + v3_ext.len;
+
+	(void)der_get_tag(&p, end, &len, DER_SEQUENCE);
+
+	while (p < end) {
+		const uint8_t *end_ext_data;
+		bool match;
+
+		(void)der_get_tag(&p, end, &len, DER_SEQUENCE);
+		end_ext_data = p + len;
+
+		/* Get extension ID */
+		(void)der_get_tag(&p, end_ext_data, &len, DER_OID);
+		match = (len == oid_len) && (memcmp(p, oid_der, len) == 0);
+		p += len;
+
+		/* Skip optional critical */
+		if (der_has_tag(p, end_ext_data, DER_BOOLEAN)) {
+			(void)der_skip(&p, end_ext_data, DER_BOOLEAN, NULL);
+		}
+
+		/* Extension data */
+		(void)der_get_tag(&p, end_ext_data, &len, DER_OCTET_STRING);
+
+		if (match) {
+			*ext = (void *)p;
+			*ext_len = (unsigned int)len;
+			return IMG_PARSER_OK;
+		}
+
+		/* Next */
+		p += len;
+	}
+
+	return IMG_PARSER_ERR_NOT_FOUND;
+}
+
+/*
+ * Check the integrity of the certificate ASN.1 structure.
+ *
+ * Extract the relevant data that will be used later during authentication.
+ *
+ * This function doesn't clear the static variables located on the top of this
+ * file in case of an error. It is only called from check_integrity(), which
+ * performs the cleanup if necessary.
+ */
+static int cert_parse(void *img, unsigned int img_len)
+{
+	size_t len;
+	uint8_t *p, *end, *crt_end, *ext_end;
+	struct der_buf sig_alg1, sig_alg2;
+
+	p = (uint8_t *)img;
+	end = p + img_len;
+
+	/*
+	 * Certificate  ::=  SEQUENCE  {
+	 *      tbsCertificate       TBSCertificate,
+	 *      signatureAlgorithm   AlgorithmIdentifier,
+	 *      signatureValue       BIT STRING  }
+	 */
+	if (der_get_tag(&p, end, &len, DER_SEQUENCE) != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	crt_end = p + len;
+
+	/*
+	 * TBSCertificate  ::=  SEQUENCE  {
+	 */
+	tbs.p = p;
+	if (der_get_tag(&p, crt_end, &len, DER_SEQUENCE) != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	end = p + len;
+	tbs.len = (size_t)(end - tbs.p);
+
+	/*
+	 * version         [0]  EXPLICIT Version,
+	 * serialNumber         CertificateSerialNumber,
+	 * signature            AlgorithmIdentifier,
+	 * issuer               Name,
+	 * validity             Validity,
+	 * subject              Name,
+	 * subjectPublicKeyInfo SubjectPublicKeyInfo,
+	 */
+	if ((der_skip(&p, end, DER_CONTEXT_CONS(0U), NULL) != 0) ||
+	    (der_skip(&p, end, DER_INTEGER, NULL) != 0) ||
+	    (der_skip(&p, end, DER_SEQUENCE, &sig_alg1) != 0) ||
+	    (der_skip(&p, end, DER_SEQUENCE, NULL) != 0) ||
+	    (der_skip(&p, end, DER_SEQUENCE, NULL) != 0) ||
+	    (der_skip(&p, end, DER_SEQUENCE, NULL) != 0) ||
+	    (der_skip(&p, end, DER_SEQUENCE, &pk) != 0)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/*
+	 * issuerUniqueID  [1]  IMPLICIT UniqueIdentifier OPTIONAL,
+	 * subjectUniqueID [2]  IMPLICIT UniqueIdentifier OPTIONAL,
+	 */
+	if (der_has_tag(p, end, DER_CONTEXT(1U)) &&
+	    (der_skip(&p, end, DER_CONTEXT(1U), NULL) != 0)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	if (der_has_tag(p, end, DER_CONTEXT(2U)) &&
+	    (der_skip(&p, end, DER_CONTEXT(2U), NULL) != 0)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/*
+	 * extensions      [3]  EXPLICIT Extensions OPTIONAL
+	 *
+	 * Extensions  ::=  SEQUENCE SIZE (1..MAX) OF Extension
+	 */
+	if (der_get_tag(&p, end, &len, DER_CONTEXT_CONS(3U)) != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	if ((p + len) != end) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	v3_ext.p = p;
+	if (der_get_tag(&p, end, &len, DER_SEQUENCE) != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	ext_end = p + len;
+	v3_ext.len = (size_t)(ext_end - v3_ext.p);
+	if (ext_end != end) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/*
+	 * Extension  ::=  SEQUENCE  {
+	 *      extnID      OBJECT IDENTIFIER,
+	 *      critical    BOOLEAN DEFAULT FALSE,
+	 *      extnValue   OCTET STRING  }
+	 */
+	while (p < end) {
+		uint8_t *end_ext_data;
+
+		if (der_get_tag(&p, end, &len, DER_SEQUENCE) != 0) {
+			return IMG_PARSER_ERR_FORMAT;
+		}
+		end_ext_data = p + len;
+
+		if (der_skip(&p, end_ext_data, DER_OID, NULL) != 0) {
+			return IMG_PARSER_ERR_FORMAT;
+		}
+
+		if (der_has_tag(p, end_ext_data, DER_BOOLEAN) &&
+		    (der_skip(&p, end_ext_data, DER_BOOLEAN, NULL) != 0)) {
+			return IMG_PARSER_ERR_FORMAT;
+		}
+
+		if ((der_skip(&p, end_ext_data, DER_OCTET_STRING, NULL) != 0) ||
+		    (p != end_ext_data)) {
+			return IMG_PARSER_ERR_FORMAT;
+		}
+	}
+
+	/*
+	 *  }
+	 *  -- end of TBSCertificate
+	 *
+	 *  signatureAlgorithm   AlgorithmIdentifier
+	 *  signatureValue       BIT STRING
+	 */
+	end = crt_end;
+
+	if ((der_skip(&p, end, DER_SEQUENCE, &sig_alg2) != 0) ||
+	    (der_skip(&p, end, DER_BIT_STRING, &signature) != 0)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/* Compare both signature algorithms */
+	if ((sig_alg1.len != sig_alg2.len) ||
+	    (memcmp(sig_alg1.p, sig_alg2.p, sig_alg1.len) != 0)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	sig_alg = sig_alg1;
+
+	/* Check certificate length */
+	if (p != end) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	return IMG_PARSER_OK;
+}
+
+/* Exported functions */
+
+static void init(void)
+{
+}
+
+/*
+ * Wrapper for cert_parse() that clears the static variables used by it in case
+ * of an error.
+ */
+static int check_integrity(void *img, unsigned int img_len)
+{
+	int rc = cert_parse(img, img_len);
+
+	if (rc != IMG_PARSER_OK) {
+		clear_temp_vars();
+	}
+
+	return rc;
+}
+
+/*
+ * Extract an authentication parameter from an X509v3 certificate
+ *
+ * This function returns a pointer to the extracted data and its length,
+ * within the certificate checked by the last call to check_integrity().
+ */
+static int get_auth_param(const auth_param_type_desc_t *type_desc,
+		void *img, unsigned int img_len,
+		void **param, unsigned int *param_len)
+{
+	int rc = IMG_PARSER_OK;
+
+	switch (type_desc->type) {
+	case AUTH_PARAM_RAW_DATA:
+		/* Data to be signed */
+		*param = (void *)tbs.p;
+		*param_len = (unsigned int)tbs.len;
+		break;
+	case AUTH_PARAM_HASH:
+	case AUTH_PARAM_NV_CTR:
+		/* All these parameters are included as X509v3 extensions */
+		rc = get_ext(type_desc->cookie, param, param_len);
+		break;
+	case AUTH_PARAM_PUB_KEY:
+		if (type_desc->cookie != 0) {
+			/* Get public key from extension */
+			rc = get_ext(type_desc->cookie, param, param_len);
+		} else {
+			/* Get the subject public key */
+			*param = (void *)pk.p;
+			*param_len = (unsigned int)pk.len;
+		}
+		break;
+	case AUTH_PARAM_SIG_ALG:
+		/* Get the certificate signature algorithm */
+		*param = (void *)sig_alg.p;
+		*param_len = (unsigned int)sig_alg.len;
+		break;
+	case AUTH_PARAM_SIG:
+		/* Get the certificate signature */
+		*param = (void *)signature.p;
+		*param_len = (unsigned int)signature.len;
+		break;
+	default:
+		rc = IMG_PARSER_ERR_NOT_FOUND;
+		break;
+	}
+
+	return rc;
+}
+
+REGISTER_IMG_PARSER_LIB(IMG_CERT, LIB_NAME, init, \
+		       check_integrity, get_auth_param);
@@ -8,6 +8,7 @@
 
 #include <platform_def.h>
 
+#include <arch.h>
 #include <drivers/delay_timer.h>
 #include <lib/utils_def.h>
 
@@ -16,6 +17,34 @@
  ***********************************************************/
 static const timer_ops_t *timer_ops;
 
+/* CNTKCTL event stream setting, 0 when waiting for events is disabled */
+static u_register_t evtstrm_cfg;
+static uint32_t evtstrm_period_us;
+
+/***********************************************************
+ * Sleep until the next event. The event stream setting of
+ * CNTKCTL belongs to the lower exception level, it is only
+ * overridden for the duration of the WFE.
+ ***********************************************************/
+void timeout_wait_event(void)
+{
+	u_register_t cntkctl;
+
+	if (evtstrm_cfg == 0U) {
+		return;
+	}
+
+	cntkctl = read_cntkctl_el1();
+	write_cntkctl_el1((cntkctl & ~((EVNTI_MASK << EVNTI_SHIFT) |
+				       EVNTDIR_BIT)) | evtstrm_cfg);
+	isb();
+
+	wfe();
+
+	write_cntkctl_el1(cntkctl);
+	isb();
+}
+
 /***********************************************************
  * Delay for the given number of microseconds. The driver must
  * be initialized before calling this function.
@@ -29,6 +58,7 @@ void udelay(uint32_t usec)
 
 	uint32_t start, delta;
 	uint64_t total_delta;
+	uint64_t wfe_margin = UINT64_MAX;
 
 	assert(usec < (UINT64_MAX / timer_ops->clk_div));
 
@@ -46,6 +76,13 @@ void udelay(uint32_t usec)
 	 */
 	assert(total_delta < (UINT32_MAX - 1000U));
 
+	/* Only sleep when more than one event period remains */
+	if (evtstrm_cfg != 0U) {
+		wfe_margin = div_round_up((uint64_t)evtstrm_period_us *
+					  timer_ops->clk_div,
+					  timer_ops->clk_mult);
+	}
+
 	do {
 		/*
 		 * If the timer value wraps around, the subtraction will
@@ -54,6 +91,10 @@ void udelay(uint32_t usec)
 		 */
 		delta = start - timer_ops->get_timer_value();
 
+		if ((delta < total_delta) &&
+		    ((total_delta - delta) > wfe_margin)) {
+			timeout_wait_event();
+		}
 	} while (delta < total_delta);
 }
 
@@ -80,3 +121,25 @@ void timer_init(const timer_ops_t *ops_ptr)
 
 	timer_ops = ops_ptr;
 }
+
+/***********************************************************
+ * Enable waiting for events on the generic timer event
+ * stream, with an event at least every period_us
+ * microseconds. The stream triggers on the transitions of
+ * a counter bit, so the period is rounded down to a power
+ * of two ticks.
+ ***********************************************************/
+void timer_evtstrm_init(uint32_t period_us)
+{
+	uint64_t ticks = timeout_cnt_us2cnt(period_us);
+	u_register_t evnti = 0U;
+
+	/* An event is generated every 2^(EVNTI + 1) ticks */
+	while ((evnti < EVNTI_MASK) && ((ticks >> (evnti + 2U)) != 0U)) {
+		evnti++;
+	}
+
+	evtstrm_period_us = (uint32_t)div_round_up((2ULL << evnti) * 1000000ULL,
+						   read_cntfrq_el0());
+	evtstrm_cfg = (evnti << EVNTI_SHIFT) | EVNTEN_BIT;
+}
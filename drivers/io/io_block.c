@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -15,13 +16,27 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
+#include <lib/utils_def.h>
 
+#ifndef MAX_IO_BLOCK_HANDLES
+#define MAX_IO_BLOCK_HANDLES	MAX_IO_HANDLES
+#endif
+
+typedef struct {
+	io_block_dev_spec_t	*dev_spec;
+} block_dev_state_t;
+
+/*
+ * State of an open entity. Each entity has its own position, so that several
+ * regions of a device can be read in turn. The transfer buffer of the device
+ * spec is shared, it only holds data during a read or write call.
+ */
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	unsigned long long	file_pos;
 	unsigned long long	size;
-} block_dev_state_t;
+} block_file_state_t;
 
 #define is_power_of_2(x)	(((x) != 0U) && (((x) & ((x) - 1U)) == 0U))
 
@@ -34,6 +49,8 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
+static int block_readv(io_entity_t *entity, const io_vec_t *vec,
+		       unsigned int count, size_t *length_read);
 static int block_close(io_entity_t *entity);
 static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
 static int block_dev_close(io_dev_info_t *dev_info);
@@ -52,10 +69,12 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.close		= block_close,
 	.dev_init	= NULL,
 	.dev_close	= block_dev_close,
+	.readv		= block_readv,
 };
 
 static block_dev_state_t state_pool[MAX_IO_BLOCK_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_IO_BLOCK_DEVICES];
+static block_file_state_t file_pool[MAX_IO_BLOCK_HANDLES];
 
 /* Track number of allocated block state */
 static unsigned int block_dev_count;
@@ -124,10 +143,25 @@ static int free_dev_info(io_dev_info_t *dev_info)
 	return result;
 }
 
+/* Allocate the state of an entity from the pool */
+static block_file_state_t *allocate_file_state(void)
+{
+	unsigned int index;
+
+	for (index = 0U; index < MAX_IO_BLOCK_HANDLES; ++index) {
+		if (file_pool[index].dev_spec == NULL) {
+			return &file_pool[index];
+		}
+	}
+
+	return NULL;
+}
+
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		      io_entity_t *entity)
 {
-	block_dev_state_t *cur;
+	block_dev_state_t *dev;
+	block_file_state_t *cur;
 	io_block_spec_t *region;
 
 	assert((dev_info->info != (uintptr_t)NULL) &&
@@ -135,10 +169,16 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	       (entity->info == (uintptr_t)NULL));
 
 	region = (io_block_spec_t *)spec;
-	cur = (block_dev_state_t *)dev_info->info;
-	assert(((region->offset % cur->dev_spec->block_size) == 0) &&
-	       ((region->length % cur->dev_spec->block_size) == 0));
+	dev = (block_dev_state_t *)dev_info->info;
+	assert(((region->offset % dev->dev_spec->block_size) == 0) &&
+	       ((region->length % dev->dev_spec->block_size) == 0));
+
+	cur = allocate_file_state();
+	if (cur == NULL) {
+		return -ENOMEM;
+	}
 
+	cur->dev_spec = dev->dev_spec;
 	cur->base = region->offset;
 	cur->size = region->length;
 	cur->file_pos = 0;
@@ -150,11 +190,11 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 /* parameter offset is relative address at here */
 static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 {
-	block_dev_state_t *cur;
+	block_file_state_t *cur;
 
 	assert(entity->info != (uintptr_t)NULL);
 
-	cur = (block_dev_state_t *)entity->info;
+	cur = (block_file_state_t *)entity->info;
 	assert((offset >= 0) && ((unsigned long long)offset < cur->size));
 
 	switch (mode) {
@@ -171,6 +211,84 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 	return 0;
 }
 
+/*
+ * Check if the next read iteration can bypass the temporary buffer: the
+ * direct read mode is enabled, the current position is block-aligned, there
+ * is at least one complete block to read and the destination is aligned.
+ */
+static bool is_direct_read(const io_block_dev_spec_t *dev_spec,
+			   uintptr_t dest, size_t skip, size_t left)
+{
+	size_t align = dev_spec->direct_read_align;
+
+	return (align != 0U) && (skip == 0U) &&
+	       (left >= dev_spec->block_size) &&
+	       ((dest & (align - 1U)) == 0U);
+}
+
+/*
+ * Read complete blocks directly into the caller buffer and return the number
+ * of bytes read, rounded down to the block size. When a read hook and the
+ * split-phase read ops are available, the transfer is split in chunks and
+ * the next chunk is read while the hook consumes the previous one.
+ */
+static size_t block_direct_read(const io_block_dev_spec_t *dev_spec, int lba,
+				uintptr_t dest, size_t length)
+{
+	const io_block_ops_t *ops = &dev_spec->ops;
+	size_t block_size = dev_spec->block_size;
+	size_t chunk = dev_spec->read_chunk_size;
+	size_t done = 0U;
+	size_t size;
+	size_t nbytes;
+
+	if ((dev_spec->read_hook == NULL) || (ops->read_start == NULL) ||
+	    (ops->read_wait == NULL) || (chunk == 0U) || (chunk >= length)) {
+		/*
+		 * The read may return size less than requested.
+		 * Round down to the nearest block boundary.
+		 */
+		nbytes = ops->read(lba, dest, length) & ~(block_size - 1U);
+		if ((nbytes != 0U) && (dev_spec->read_hook != NULL)) {
+			dev_spec->read_hook(dest, nbytes);
+		}
+
+		return nbytes;
+	}
+
+	size = chunk;
+	if (ops->read_start(lba, dest, size) != 0) {
+		return 0U;
+	}
+
+	while (done < length) {
+		uintptr_t chunk_base = dest + done;
+
+		nbytes = ops->read_wait();
+		if (nbytes != size) {
+			nbytes &= ~(block_size - 1U);
+			if (nbytes != 0U) {
+				dev_spec->read_hook(chunk_base, nbytes);
+			}
+
+			return done + nbytes;
+		}
+
+		done += size;
+		if (done < length) {
+			size = MIN(chunk, length - done);
+			if (ops->read_start(lba + (int)(done / block_size),
+					    dest + done, size) != 0) {
+				length = done;
+			}
+		}
+
+		dev_spec->read_hook(chunk_base, nbytes);
+	}
+
+	return done;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,11 +358,16 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * When the direct read mode is enabled (direct_read_align != 0), the
+ * complete blocks between skip and padding are read straight into the
+ * caller buffer; only the first and last partial blocks are copied from
+ * the underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
 {
-	block_dev_state_t *cur;
+	block_file_state_t *cur;
 	io_block_spec_t *buf;
 	io_block_ops_t *ops;
 	int lba;
@@ -265,7 +388,7 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	size_t padding;
 
 	assert(entity->info != (uintptr_t)NULL);
-	cur = (block_dev_state_t *)entity->info;
+	cur = (block_file_state_t *)entity->info;
 	ops = &(cur->dev_spec->ops);
 	buf = &(cur->dev_spec->buffer);
 	block_size = cur->dev_spec->block_size;
@@ -296,6 +419,23 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (is_direct_read(cur->dev_spec, buffer + count, skip, left)) {
+			/*
+			 * Read all the remaining complete blocks directly
+			 * into the user buffer, without intermediate copy.
+			 */
+			request = left & ~(block_size - 1U);
+			nbytes = block_direct_read(cur->dev_spec, lba,
+						   buffer + count, request);
+			if (nbytes == 0U) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -338,6 +478,10 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		       (void *)(buf->offset + skip),
 		       nbytes);
 
+		if (cur->dev_spec->read_hook != NULL) {
+			cur->dev_spec->read_hook(buffer + count, nbytes);
+		}
+
 		cur->file_pos += nbytes;
 		count += nbytes;
 	}
@@ -347,6 +491,92 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Check if a vectored read can be done with a single ops->readv() transfer:
+ * the current position is block-aligned and each buffer takes complete
+ * blocks at an address aligned for the direct read mode.
+ */
+static bool is_direct_readv(const block_file_state_t *cur,
+			    const io_vec_t *vec, unsigned int count)
+{
+	const io_block_dev_spec_t *dev_spec = cur->dev_spec;
+	size_t block_size = dev_spec->block_size;
+	unsigned int i;
+
+	if ((dev_spec->ops.readv == NULL) ||
+	    ((cur->file_pos & (block_size - 1U)) != 0U)) {
+		return false;
+	}
+
+	for (i = 0U; i < count; i++) {
+		if ((vec[i].length == 0U) ||
+		    ((vec[i].length & (block_size - 1U)) != 0U) ||
+		    !is_direct_read(dev_spec, vec[i].buffer, 0U,
+				    vec[i].length)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Read consecutive data into a list of buffers. When the block driver can
+ * scatter a transfer and the buffers take complete, aligned blocks, all of
+ * them are filled by one multiple block read. Otherwise each buffer is read
+ * in turn with block_read().
+ */
+static int block_readv(io_entity_t *entity, const io_vec_t *vec,
+		       unsigned int count, size_t *length_read)
+{
+	block_file_state_t *cur;
+	size_t total = 0U;
+	size_t nbytes;
+	unsigned int i;
+	int lba;
+	int ret;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_file_state_t *)entity->info;
+
+	if (!is_direct_readv(cur, vec, count)) {
+		*length_read = 0U;
+		for (i = 0U; i < count; i++) {
+			ret = block_read(entity, vec[i].buffer, vec[i].length,
+					 &nbytes);
+			if (ret != 0) {
+				return ret;
+			}
+
+			*length_read += nbytes;
+		}
+
+		return 0;
+	}
+
+	for (i = 0U; i < count; i++) {
+		total += vec[i].length;
+	}
+	assert(total <= cur->size);
+
+	lba = (cur->file_pos + cur->base) / cur->dev_spec->block_size;
+	nbytes = cur->dev_spec->ops.readv(lba, vec, count);
+	if (nbytes != total) {
+		return -EIO;
+	}
+
+	if (cur->dev_spec->read_hook != NULL) {
+		for (i = 0U; i < count; i++) {
+			cur->dev_spec->read_hook(vec[i].buffer, vec[i].length);
+		}
+	}
+
+	cur->file_pos += total;
+	*length_read = total;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
@@ -356,7 +586,7 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written)
 {
-	block_dev_state_t *cur;
+	block_file_state_t *cur;
 	io_block_spec_t *buf;
 	io_block_ops_t *ops;
 	int lba;
@@ -377,7 +607,7 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	size_t padding;
 
 	assert(entity->info != (uintptr_t)NULL);
-	cur = (block_dev_state_t *)entity->info;
+	cur = (block_file_state_t *)entity->info;
 	ops = &(cur->dev_spec->ops);
 	buf = &(cur->dev_spec->buffer);
 	block_size = cur->dev_spec->block_size;
@@ -493,6 +723,9 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 
 static int block_close(io_entity_t *entity)
 {
+	assert(entity->info != (uintptr_t)NULL);
+
+	zeromem((void *)entity->info, sizeof(block_file_state_t));
 	entity->info = (uintptr_t)NULL;
 	return 0;
 }
@@ -518,7 +751,10 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	assert((block_size > 0U) &&
 	       (is_power_of_2(block_size) != 0U) &&
 	       ((buffer->offset % block_size) == 0U) &&
-	       ((buffer->length % block_size) == 0U));
+	       ((buffer->length % block_size) == 0U) &&
+	       ((cur->dev_spec->direct_read_align == 0U) ||
+		(is_power_of_2(cur->dev_spec->direct_read_align) != 0U)) &&
+	       ((cur->dev_spec->read_chunk_size % block_size) == 0U));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
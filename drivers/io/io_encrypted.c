@@ -23,6 +23,14 @@
 #include <tools_share/firmware_encrypted.h>
 #include <tools_share/uuid.h>
 
+#if DECRYPTION_STREAM
+/*
+ * Size of the parts read and decrypted in turn, a multiple of the cipher
+ * block size.
+ */
+#define ENC_STREAM_CHUNK_SIZE		U(0x10000)
+#endif
+
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_dev_spec;
 static uintptr_t backend_handle;
@@ -150,6 +158,71 @@ static int enc_file_len(io_entity_t *entity, size_t *length)
 	return result;
 }
 
+#if DECRYPTION_STREAM
+/*
+ * Read the encrypted payload in chunks, each of them being decrypted in place
+ * while it is still hot in the data cache. The tag is checked once the whole
+ * payload has been decrypted.
+ */
+static int enc_file_read_stream(struct fw_enc_hdr *header, uintptr_t buffer,
+				size_t length, size_t *length_read,
+				uint8_t *key, size_t key_len,
+				unsigned int key_flags)
+{
+	size_t offset = 0U;
+	int result;
+
+	result = crypto_mod_auth_decrypt_stream_start(header->dec_algo, key,
+						      key_len, key_flags,
+						      header->iv,
+						      header->iv_len);
+	memset(key, 0, key_len);
+
+	if (result != 0) {
+		return result;
+	}
+
+	while (offset < length) {
+		size_t len = MIN(ENC_STREAM_CHUNK_SIZE, length - offset);
+		size_t chunk_read;
+
+		result = io_read(backend_handle, buffer + offset, len,
+				 &chunk_read);
+		if (result != 0) {
+			WARN("Failed to read encrypted payload (%i)\n", result);
+			break;
+		}
+
+		if (chunk_read != 0U) {
+			result = crypto_mod_auth_decrypt_stream_update(
+					(void *)(buffer + offset), chunk_read);
+			if (result != 0) {
+				break;
+			}
+		}
+
+		offset += chunk_read;
+
+		/* A short read is the end of the payload */
+		if (chunk_read < len) {
+			break;
+		}
+	}
+
+	*length_read = offset;
+
+	if (result != 0) {
+		/* Complete the stream to release the crypto context */
+		(void)crypto_mod_auth_decrypt_stream_finish(header->tag,
+							    header->tag_len);
+		return result;
+	}
+
+	return crypto_mod_auth_decrypt_stream_finish(header->tag,
+						     header->tag_len);
+}
+#endif /* DECRYPTION_STREAM */
+
 static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			 size_t *length_read)
 {
@@ -186,6 +259,18 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
+#if DECRYPTION_STREAM
+	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
+				       (uint8_t *)&uuid_spec->uuid,
+				       sizeof(uuid_t));
+	if (result != 0) {
+		WARN("Failed to obtain encryption key (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = enc_file_read_stream(&header, buffer, length, length_read,
+				      key, key_len, key_flags);
+#else
 	result = io_read(backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
 		WARN("Failed to read encrypted payload (%i)\n", result);
@@ -208,6 +293,7 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 					 header.iv_len, header.tag,
 					 header.tag_len);
 	memset(key, 0, key_len);
+#endif
 
 	if (result != 0) {
 		ERROR("File decryption failed (%i)\n", result);
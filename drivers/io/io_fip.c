@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -25,6 +26,11 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/* Number of ToC entries kept in the index of each FIP device */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	16
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -47,6 +53,14 @@ typedef struct {
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+	/*
+	 * Index of the ToC entries, read by fip_dev_init(). If the ToC end
+	 * marker has been found, the index is complete and file lookups do not
+	 * access the backend.
+	 */
+	fip_toc_entry_t toc[MAX_FIP_TOC_ENTRIES];
+	unsigned int toc_entries;
+	bool toc_complete;
 } fip_dev_state_t;
 
 /*
@@ -73,6 +87,10 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_map(io_entity_t *entity, uintptr_t *base,
+			size_t *length);
+static int fip_file_readv(io_entity_t *entity, const io_vec_t *vec,
+			  unsigned int count, size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -117,6 +135,8 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
+	.map = fip_file_map,
+	.readv = fip_file_readv,
 };
 
 /* Locate a file state in the pool, specified by address */
@@ -212,6 +232,54 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
+/*
+ * Read the ToC entries following the FIP header into the device index. The
+ * backend is expected to be positioned right after the header.
+ */
+static void fip_read_toc(fip_dev_state_t *state, uintptr_t backend_handle)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	size_t bytes_read;
+	unsigned int i;
+	int result;
+
+	state->toc_entries = 0U;
+	state->toc_complete = false;
+
+	/* Read the whole index in one go */
+	result = io_read(backend_handle, (uintptr_t)&state->toc,
+			 sizeof(state->toc), &bytes_read);
+	if ((result != 0) || (bytes_read != sizeof(state->toc))) {
+		/* Index not usable, lookups will scan the ToC */
+		return;
+	}
+
+	for (i = 0U; i < MAX_FIP_TOC_ENTRIES; i++) {
+		if (compare_uuids(&state->toc[i].uuid, &uuid_null) == 0) {
+			state->toc_complete = true;
+			break;
+		}
+	}
+
+	state->toc_entries = i;
+}
+
+/* Look for a file in the ToC index of the FIP device */
+static int fip_find_toc_entry(const fip_dev_state_t *state,
+			      const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	unsigned int i;
+
+	for (i = 0U; i < state->toc_entries; i++) {
+		if (compare_uuids(&state->toc[i].uuid, uuid) == 0) {
+			*entry = state->toc[i];
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
 /* Do some basic package checks. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
@@ -258,6 +326,8 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 * bits [32-47] in fip header.
 			 */
 			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+
+			fip_read_toc(state, backend_handle);
 		}
 	}
 
@@ -290,9 +360,13 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
 	size_t bytes_read;
 	int found_file = 0;
+	fip_dev_state_t *state;
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
+	assert(dev_info != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
 
 	/* Can only have one file open at a time for the moment. We need to
 	 * track state like file cursor position. We know the header lives at
@@ -305,6 +379,20 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENFILE;
 	}
 
+	/* Look in the ToC index first, without accessing the backend */
+	if (fip_find_toc_entry(state, &uuid_spec->uuid,
+			       &current_fip_file.entry) == 0) {
+		current_fip_file.file_pos = 0;
+		entity->info = (uintptr_t)&current_fip_file;
+		return 0;
+	}
+
+	if (state->toc_complete) {
+		/* Did not find the file in the FIP. */
+		current_fip_file.entry.offset_address = 0;
+		return -ENOENT;
+	}
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -314,9 +402,14 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		goto fip_file_open_exit;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
+	/*
+	 * Seek past the FIP header and the entries already in the index into
+	 * the Table of Contents
+	 */
 	result = io_seek(backend_handle, IO_SEEK_SET,
-			 (signed long long)sizeof(fip_toc_header_t));
+			 (signed long long)(sizeof(fip_toc_header_t) +
+					    (state->toc_entries *
+					     sizeof(fip_toc_entry_t))));
 	if (result != 0) {
 		WARN("fip_file_open: failed to seek\n");
 		result = -ENOENT;
@@ -431,6 +524,96 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/* Get the address of the payload, if the backend is memory-mapped */
+static int fip_file_map(io_entity_t *entity, uintptr_t *base,
+			size_t *length)
+{
+	int result;
+	fip_file_state_t *fp;
+	size_t file_offset;
+	size_t mapped_length;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		return result;
+	}
+
+	fp = (fip_file_state_t *)entity->info;
+
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 (signed long long)file_offset);
+	if (result == 0) {
+		result = io_map(backend_handle, base, &mapped_length);
+	}
+
+	if (result == 0) {
+		*length = (size_t)fp->entry.size - fp->file_pos;
+		if (mapped_length < *length) {
+			result = -EINVAL;
+		}
+	}
+
+	io_close(backend_handle);
+
+	return result;
+}
+
+
+/*
+ * Read consecutive data of a file in package into several buffers, with a
+ * single vectored read of the backend.
+ */
+static int fip_file_readv(io_entity_t *entity, const io_vec_t *vec,
+			  unsigned int count, size_t *length_read)
+{
+	int result;
+	fip_file_state_t *fp;
+	size_t file_offset;
+	size_t bytes_read;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	fp = (fip_file_state_t *)entity->info;
+
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 (signed long long)file_offset);
+	if (result != 0) {
+		WARN("fip_file_readv: failed to seek\n");
+		result = -ENOENT;
+	} else {
+		result = io_readv(backend_handle, vec, count, &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read payload (%i)\n", result);
+			result = -ENOENT;
+		} else {
+			*length_read = bytes_read;
+			fp->file_pos += bytes_read;
+		}
+	}
+
+	io_close(backend_handle);
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
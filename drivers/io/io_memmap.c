@@ -31,6 +31,9 @@ typedef struct {
 
 static memmap_file_state_t current_memmap_file = {0};
 
+/* memcpy() is used when no copy function is set */
+static io_memmap_copy_t memmap_copy;
+
 /* Identify the device type as memmap */
 static io_type_t device_type_memmap(void)
 {
@@ -48,6 +51,8 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
+static int memmap_block_map(io_entity_t *entity, uintptr_t *base,
+			    size_t *length);
 static int memmap_block_close(io_entity_t *entity);
 static int memmap_dev_close(io_dev_info_t *dev_info);
 
@@ -67,6 +72,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.close = memmap_block_close,
 	.dev_init = NULL,
 	.dev_close = memmap_dev_close,
+	.map = memmap_block_map,
 };
 
 
@@ -181,8 +187,13 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 	pos_after = fp->file_pos + length;
 	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
 
-	memcpy((void *)buffer,
-	       (void *)((uintptr_t)(fp->base + fp->file_pos)), length);
+	if (memmap_copy != NULL) {
+		memmap_copy(buffer, (uintptr_t)(fp->base + fp->file_pos),
+			    length);
+	} else {
+		memcpy((void *)buffer,
+		       (void *)((uintptr_t)(fp->base + fp->file_pos)), length);
+	}
 
 	*length_read = length;
 
@@ -221,6 +232,23 @@ static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 }
 
 
+/* Get the address of the file data from the current position */
+static int memmap_block_map(io_entity_t *entity, uintptr_t *base,
+			    size_t *length)
+{
+	memmap_file_state_t *fp;
+
+	assert(entity != NULL);
+
+	fp = (memmap_file_state_t *) entity->info;
+
+	*base = (uintptr_t)(fp->base + fp->file_pos);
+	*length = (size_t)(fp->size - fp->file_pos);
+
+	return 0;
+}
+
+
 /* Close a file on the memmap device */
 static int memmap_block_close(io_entity_t *entity)
 {
@@ -249,3 +277,9 @@ int register_io_dev_memmap(const io_dev_connector_t **dev_con)
 
 	return result;
 }
+
+/* Set the copy function of the reads, NULL for memcpy() */
+void io_memmap_set_copy(io_memmap_copy_t copy)
+{
+	memmap_copy = copy;
+}
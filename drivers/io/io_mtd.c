@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -15,13 +16,29 @@
 #include <drivers/io/io_mtd.h>
 #include <lib/utils.h>
 
+#ifndef MAX_IO_MTD_HANDLES
+#define MAX_IO_MTD_HANDLES	MAX_IO_HANDLES
+#endif
+
+typedef struct {
+	io_mtd_dev_spec_t	*dev_spec;
+	unsigned long long	size;		/* Size of device in bytes */
+	unsigned long long	cache_offset;	/* Device offset of read_cache */
+	size_t			cache_len;	/* Valid bytes in read_cache */
+} mtd_dev_state_t;
+
+/*
+ * State of an open entity, with its own position so that several regions of
+ * the device can be read in turn. The read-ahead window is kept per device,
+ * as it is indexed by device offset.
+ */
 typedef struct {
+	mtd_dev_state_t		*dev;
 	io_mtd_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	unsigned long long	pos;		/* Offset in bytes */
-	unsigned long long	size;		/* Size of device in bytes */
 	unsigned long long	extra_offset;	/* Extra offset in bytes */
-} mtd_dev_state_t;
+} mtd_file_state_t;
 
 io_type_t device_type_mtd(void);
 
@@ -30,6 +47,8 @@ static int mtd_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int mtd_seek(io_entity_t *entity, int mode, signed long long offset);
 static int mtd_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		    size_t *length_read);
+static int mtd_readv(io_entity_t *entity, const io_vec_t *vec,
+		     unsigned int count, size_t *out_length);
 static int mtd_close(io_entity_t *entity);
 static int mtd_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
 static int mtd_dev_close(io_dev_info_t *dev_info);
@@ -45,10 +64,12 @@ static const io_dev_funcs_t mtd_dev_funcs = {
 	.read		= mtd_read,
 	.close		= mtd_close,
 	.dev_close	= mtd_dev_close,
+	.readv		= mtd_readv,
 };
 
 static mtd_dev_state_t state_pool[MAX_IO_MTD_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_IO_MTD_DEVICES];
+static mtd_file_state_t file_pool[MAX_IO_MTD_HANDLES];
 
 io_type_t device_type_mtd(void)
 {
@@ -111,7 +132,7 @@ static int free_dev_info(io_dev_info_t *dev_info)
 	return 0;
 }
 
-static int mtd_add_extra_offset(mtd_dev_state_t *cur, size_t *extra_offset)
+static int mtd_add_extra_offset(mtd_file_state_t *cur, size_t *extra_offset)
 {
 	io_mtd_ops_t *ops = &cur->dev_spec->ops;
 	int ret;
@@ -129,29 +150,50 @@ static int mtd_add_extra_offset(mtd_dev_state_t *cur, size_t *extra_offset)
 	return 0;
 }
 
+/* Allocate the state of an entity from the pool */
+static mtd_file_state_t *allocate_file_state(void)
+{
+	unsigned int index;
+
+	for (index = 0U; index < MAX_IO_MTD_HANDLES; index++) {
+		if (file_pool[index].dev == NULL) {
+			return &file_pool[index];
+		}
+	}
+
+	return NULL;
+}
+
 static int mtd_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		    io_entity_t *entity)
 {
-	mtd_dev_state_t *cur;
+	mtd_file_state_t *cur;
 	io_block_spec_t *region;
 	size_t extra_offset = 0U;
 	int ret;
 
 	assert((dev_info->info != 0UL) && (entity->info == 0UL));
 
+	cur = allocate_file_state();
+	if (cur == NULL) {
+		return -ENOMEM;
+	}
+
 	region = (io_block_spec_t *)spec;
-	cur = (mtd_dev_state_t *)dev_info->info;
-	entity->info = (uintptr_t)cur;
+	cur->dev = (mtd_dev_state_t *)dev_info->info;
+	cur->dev_spec = cur->dev->dev_spec;
 	cur->base = region->offset;
 	cur->pos = 0U;
 	cur->extra_offset = 0U;
 
 	ret = mtd_add_extra_offset(cur, &extra_offset);
 	if (ret != 0) {
+		zeromem(cur, sizeof(mtd_file_state_t));
 		return ret;
 	}
 
 	cur->base += extra_offset;
+	entity->info = (uintptr_t)cur;
 
 	return 0;
 }
@@ -159,18 +201,18 @@ static int mtd_open(io_dev_info_t *dev_info, const uintptr_t spec,
 /* Seek to a specific position using offset */
 static int mtd_seek(io_entity_t *entity, int mode, signed long long offset)
 {
-	mtd_dev_state_t *cur;
+	mtd_file_state_t *cur;
 	size_t extra_offset = 0U;
 	int ret;
 
 	assert((entity->info != (uintptr_t)NULL) && (offset >= 0));
 
-	cur = (mtd_dev_state_t *)entity->info;
+	cur = (mtd_file_state_t *)entity->info;
 
 	switch (mode) {
 	case IO_SEEK_SET:
 		if ((offset >= 0) &&
-		    ((unsigned long long)offset >= cur->size)) {
+		    ((unsigned long long)offset >= cur->dev->size)) {
 			return -EINVAL;
 		}
 
@@ -178,7 +220,7 @@ static int mtd_seek(io_entity_t *entity, int mode, signed long long offset)
 		break;
 	case IO_SEEK_CUR:
 		if (((cur->base + cur->pos + (unsigned long long)offset) >=
-		     cur->size) ||
+		     cur->dev->size) ||
 		    ((cur->base + cur->pos + (unsigned long long)offset) <
 		     cur->base + cur->pos)) {
 			return -EINVAL;
@@ -200,17 +242,65 @@ static int mtd_seek(io_entity_t *entity, int mode, signed long long offset)
 	return 0;
 }
 
+static bool mtd_use_read_cache(mtd_file_state_t *cur, size_t length)
+{
+	io_mtd_dev_spec_t *dev_spec = cur->dev_spec;
+
+	return (dev_spec->read_cache != 0U) && (dev_spec->ops.seek == NULL) &&
+	       (length <= (dev_spec->read_cache_size / 2U));
+}
+
+/*
+ * Serve a small read from the read-ahead window, fetching a new window at
+ * the read offset if the data is not in the current one.
+ */
+static int mtd_read_cached(mtd_dev_state_t *dev, unsigned long long offset,
+			   uintptr_t buffer, size_t length, size_t *out_length)
+{
+	io_mtd_dev_spec_t *dev_spec = dev->dev_spec;
+	size_t len;
+	int ret;
+
+	if ((offset < dev->cache_offset) ||
+	    ((offset + length) > (dev->cache_offset + dev->cache_len))) {
+		dev->cache_len = 0U;
+		len = (size_t)MIN((unsigned long long)dev_spec->read_cache_size,
+				  dev_spec->device_size - offset);
+
+		ret = dev_spec->ops.read(offset, dev_spec->read_cache, len,
+					 &len);
+		if (ret < 0) {
+			return ret;
+		}
+
+		dev->cache_offset = offset;
+		dev->cache_len = len;
+
+		if (len < length) {
+			return -EIO;
+		}
+	}
+
+	(void)memcpy((void *)buffer,
+		     (void *)(dev_spec->read_cache +
+			      (size_t)(offset - dev->cache_offset)),
+		     length);
+	*out_length = length;
+
+	return 0;
+}
+
 static int mtd_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		    size_t *out_length)
 {
-	mtd_dev_state_t *cur;
+	mtd_file_state_t *cur;
 	io_mtd_ops_t *ops;
 	int ret;
 
 	assert(entity->info != (uintptr_t)NULL);
 	assert((length > 0U) && (buffer != (uintptr_t)NULL));
 
-	cur = (mtd_dev_state_t *)entity->info;
+	cur = (mtd_file_state_t *)entity->info;
 	ops = &cur->dev_spec->ops;
 	assert(ops->read != NULL);
 
@@ -220,8 +310,13 @@ static int mtd_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -EINVAL;
 	}
 
-	ret = ops->read(cur->base + cur->pos + cur->extra_offset, buffer,
-			length, out_length);
+	if (mtd_use_read_cache(cur, length)) {
+		ret = mtd_read_cached(cur->dev, cur->base + cur->pos, buffer,
+				      length, out_length);
+	} else {
+		ret = ops->read(cur->base + cur->pos + cur->extra_offset,
+				buffer, length, out_length);
+	}
 	if (ret < 0) {
 		return ret;
 	}
@@ -232,8 +327,71 @@ static int mtd_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Read consecutive data into a list of buffers, as one sequential access of
+ * the device. When the whole span fits in the read-ahead window, it is
+ * fetched with a single device read and copied to the buffers.
+ */
+static int mtd_readv(io_entity_t *entity, const io_vec_t *vec,
+		     unsigned int count, size_t *out_length)
+{
+	mtd_file_state_t *cur;
+	io_mtd_ops_t *ops;
+	unsigned long long offset;
+	size_t total = 0U;
+	size_t len;
+	bool cached;
+	unsigned int i;
+	int ret;
+
+	assert(entity->info != (uintptr_t)NULL);
+
+	cur = (mtd_file_state_t *)entity->info;
+	ops = &cur->dev_spec->ops;
+	assert(ops->read != NULL);
+
+	for (i = 0U; i < count; i++) {
+		assert((vec[i].length > 0U) &&
+		       (vec[i].buffer != (uintptr_t)NULL));
+		total += vec[i].length;
+	}
+
+	VERBOSE("Read at %llx into %u buffers, length %zi\n",
+		cur->base + cur->pos, count, total);
+	if ((cur->base + cur->pos + total) > cur->dev_spec->device_size) {
+		return -EINVAL;
+	}
+
+	cached = mtd_use_read_cache(cur, total);
+	offset = cur->base + cur->pos;
+
+	for (i = 0U; i < count; i++) {
+		if (cached) {
+			ret = mtd_read_cached(cur->dev, offset, vec[i].buffer,
+					      vec[i].length, &len);
+		} else {
+			ret = ops->read(offset + cur->extra_offset,
+					vec[i].buffer, vec[i].length, &len);
+		}
+		if (ret < 0) {
+			return ret;
+		}
+
+		assert(len == vec[i].length);
+		offset += len;
+	}
+
+	cur->pos += total;
+	*out_length = total;
+
+	return 0;
+}
+
 static int mtd_close(io_entity_t *entity)
 {
+	assert(entity->info != (uintptr_t)NULL);
+
+	zeromem((void *)entity->info, sizeof(mtd_file_state_t));
 	entity->info = (uintptr_t)NULL;
 
 	return 0;
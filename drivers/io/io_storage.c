@@ -19,8 +19,9 @@ static io_entity_t entity_pool[MAX_IO_HANDLES];
  * entity */
 static io_entity_t *entity_map[MAX_IO_HANDLES];
 
-/* Track number of allocated entities */
+/* Track number of allocated entities, and the most allocated at once */
 static unsigned int entity_count;
+static unsigned int entity_count_max;
 
 /* Array of fixed maximum of registered devices, definable by platform */
 static const io_dev_info_t *devices[MAX_IO_DEVICES];
@@ -116,6 +117,9 @@ static int allocate_entity(io_entity_t **entity)
 		*entity = &entity_pool[index];
 		entity_map[index] = &entity_pool[index];
 		++entity_count;
+		if (entity_count > entity_count_max) {
+			entity_count_max = entity_count;
+		}
 	}
 
 	return result;
@@ -285,6 +289,50 @@ int io_read(uintptr_t handle,
 }
 
 
+/*
+ * Read consecutive data of an IO entity into a list of buffers. Devices that
+ * do not implement the operation get one read per buffer, until a read is
+ * short or fails. The total number of bytes read is returned.
+ */
+int io_readv(uintptr_t handle, const io_vec_t *vec, unsigned int count,
+		size_t *length_read)
+{
+	int result = -ENODEV;
+	unsigned int i;
+	size_t bytes_read;
+	assert(is_valid_entity(handle));
+	assert((vec != NULL) && (count != 0U) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->readv != NULL) {
+		return dev->funcs->readv(entity, vec, count, length_read);
+	}
+
+	if (dev->funcs->read == NULL) {
+		return result;
+	}
+
+	*length_read = 0U;
+	for (i = 0U; i < count; i++) {
+		result = dev->funcs->read(entity, vec[i].buffer, vec[i].length,
+				&bytes_read);
+		if (result != 0) {
+			break;
+		}
+
+		*length_read += bytes_read;
+		if (bytes_read != vec[i].length) {
+			break;
+		}
+	}
+
+	return result;
+}
+
+
 /* Write data to an IO entity */
 int io_write(uintptr_t handle,
 		const uintptr_t buffer,
@@ -307,6 +355,29 @@ int io_write(uintptr_t handle,
 }
 
 
+/*
+ * Get the address and length of the entity data from the current position,
+ * for devices where it is directly accessible in memory. Returns -ENOTSUP
+ * otherwise, the data then has to be read with io_read().
+ */
+int io_map(uintptr_t handle, uintptr_t *base, size_t *length)
+{
+	int result = -ENOTSUP;
+	assert(is_valid_entity(handle));
+	assert((base != NULL) && (length != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->map != NULL) {
+		result = dev->funcs->map(entity, base, length);
+	}
+
+	return result;
+}
+
+
 /* Close an IO entity */
 int io_close(uintptr_t handle)
 {
@@ -326,3 +397,10 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+/* Return the most entities open at once, out of MAX_IO_HANDLES */
+unsigned int io_get_handles_max_used(void)
+{
+	return entity_count_max;
+}
@@ -11,9 +11,12 @@
 
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/measured_boot/event_log/event_log.h>
+#include <mbedtls/asn1.h>
 #include <mbedtls/md.h>
+#include <mbedtls/oid.h>
 
 #include <plat/common/platform.h>
 
@@ -231,9 +234,66 @@ void event_log_write_header(void)
 	log_ptr = (uint8_t *)((uintptr_t)ptr + sizeof(startup_locality_event_t));
 }
 
+/*
+ * Get the hash of data just authenticated by their hash, if the Event Log
+ * algorithm was used.
+ *
+ * @param[in] data_base		Address of data
+ * @param[in] data_size		Size of data
+ * @param[out] hash		Hash data of TCG_DIGEST_SIZE bytes
+ * @return:
+ *	0 = success
+ *    < 0 = data must be hashed
+ */
+static int event_log_get_auth_hash(uintptr_t data_base, uint32_t data_size,
+				   unsigned char *hash)
+{
+	const void *digest_info;
+	unsigned int digest_info_len;
+	mbedtls_asn1_buf hash_oid, params;
+	mbedtls_md_type_t md_alg;
+	unsigned char *p, *end;
+	size_t len;
+	int rc;
+
+	rc = auth_mod_get_img_digest_info(data_base, data_size,
+					  &digest_info, &digest_info_len);
+	if (rc != 0) {
+		return rc;
+	}
+
+	p = (unsigned char *)digest_info;
+	end = p + digest_info_len;
+	rc = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				  MBEDTLS_ASN1_SEQUENCE);
+	if (rc != 0) {
+		return -EINVAL;
+	}
+
+	rc = mbedtls_asn1_get_alg(&p, end, &hash_oid, &params);
+	if (rc != 0) {
+		return -EINVAL;
+	}
+
+	rc = mbedtls_oid_get_md_alg(&hash_oid, &md_alg);
+	if ((rc != 0) || (md_alg != MBEDTLS_MD_ID)) {
+		return -EINVAL;
+	}
+
+	rc = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_OCTET_STRING);
+	if ((rc != 0) || (len != TCG_DIGEST_SIZE)) {
+		return -EINVAL;
+	}
+
+	(void)memcpy(hash, p, TCG_DIGEST_SIZE);
+
+	return 0;
+}
+
 /*
  * Calculate and write hash of image, configuration data, etc.
- * to Event Log.
+ * to Event Log. The hash computed to authenticate the data is reused
+ * when possible.
  *
  * @param[in] data_base		Address of data
  * @param[in] data_size		Size of data
@@ -256,11 +316,15 @@ int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
 	}
 	assert(metadata_ptr->id != INVALID_ID);
 
-	/* Calculate hash */
-	rc = crypto_mod_calc_hash((unsigned int)MBEDTLS_MD_ID,
-				(void *)data_base, data_size, hash_data);
+	/* Calculate hash, unless already done during authentication */
+	rc = event_log_get_auth_hash(data_base, data_size, hash_data);
 	if (rc != 0) {
-		return rc;
+		rc = crypto_mod_calc_hash((unsigned int)MBEDTLS_MD_ID,
+					(void *)data_base, data_size,
+					hash_data);
+		if (rc != 0) {
+			return rc;
+		}
 	}
 
 	event_log_record(hash_data, metadata_ptr);
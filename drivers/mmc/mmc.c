@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,7 @@
 
 #define MMC_DEFAULT_MAX_RETRIES		5
 #define SEND_OP_COND_MAX_RETRIES	100
+#define SEND_OP_COND_DELAY_US		10000U
 
 #define MULT_BY_512K_SHIFT		19
 
@@ -27,10 +28,29 @@ static unsigned int mmc_ocr_value;
 static struct mmc_csd_emmc mmc_csd;
 static struct sd_switch_status sd_switch_func_status;
 static unsigned char mmc_ext_csd[512] __aligned(16);
+/* The boot partition stays selected after a read, until another access */
+static bool mmc_boot_part_selected;
 static unsigned int mmc_flags;
+static bool mmc_card_cmd23;
+/* Set when the SD card accepted the 1.8V signalling, cleared if it failed */
+static bool mmc_sd_uhs;
+static bool mmc_sd_uhs_failed;
 static struct mmc_device_info *mmc_dev_info;
 static unsigned int rca;
+static struct {
+	int lba;
+	uintptr_t buf;
+	size_t size;
+} mmc_pending_read;
 static unsigned int scr[2]__aligned(16) = { 0 };
+/* Card power-up, polled until the card leaves its busy state */
+static struct {
+	unsigned int clk;
+	unsigned int bus_width;
+	unsigned int retries;
+	uint64_t timeout;
+	bool pending;
+} mmc_op_cond;
 
 static const unsigned char tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 26, 30, 35, 40, 45, 52, 55, 60, 70, 80
@@ -40,9 +60,43 @@ static const unsigned char sd_tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80
 };
 
+/* JEDEC 5.1 tuning block patterns, chapter 6.6.5.1 */
+static const unsigned char tuning_blk_pattern_4bit[64] = {
+	0xff, 0x0f, 0xff, 0x00, 0xff, 0xcc, 0xc3, 0xcc,
+	0xc3, 0x3c, 0xcc, 0xff, 0xfe, 0xff, 0xfe, 0xef,
+	0xff, 0xdf, 0xff, 0xdd, 0xff, 0xfb, 0xff, 0xfb,
+	0xbf, 0xff, 0x7f, 0xff, 0x77, 0xf7, 0xbd, 0xef,
+	0xff, 0xf0, 0xff, 0xf0, 0x0f, 0xfc, 0xcc, 0x3c,
+	0xcc, 0x33, 0xcc, 0xcf, 0xff, 0xef, 0xff, 0xee,
+	0xff, 0xfd, 0xff, 0xfd, 0xdf, 0xff, 0xbf, 0xff,
+	0xbb, 0xff, 0xf7, 0xff, 0xf7, 0x7f, 0x7b, 0xde,
+};
+
+static const unsigned char tuning_blk_pattern_8bit[128] = {
+	0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00,
+	0xff, 0xff, 0xcc, 0xcc, 0xcc, 0x33, 0xcc, 0xcc,
+	0xcc, 0x33, 0x33, 0xcc, 0xcc, 0xcc, 0xff, 0xff,
+	0xff, 0xee, 0xff, 0xff, 0xff, 0xee, 0xee, 0xff,
+	0xff, 0xff, 0xdd, 0xff, 0xff, 0xff, 0xdd, 0xdd,
+	0xff, 0xff, 0xff, 0xbb, 0xff, 0xff, 0xff, 0xbb,
+	0xbb, 0xff, 0xff, 0xff, 0x77, 0xff, 0xff, 0xff,
+	0x77, 0x77, 0xff, 0x77, 0xbb, 0xdd, 0xee, 0xff,
+	0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00,
+	0x00, 0xff, 0xff, 0xcc, 0xcc, 0xcc, 0x33, 0xcc,
+	0xcc, 0xcc, 0x33, 0x33, 0xcc, 0xcc, 0xcc, 0xff,
+	0xff, 0xff, 0xee, 0xff, 0xff, 0xff, 0xee, 0xee,
+	0xff, 0xff, 0xff, 0xdd, 0xff, 0xff, 0xff, 0xdd,
+	0xdd, 0xff, 0xff, 0xff, 0xbb, 0xff, 0xff, 0xff,
+	0xbb, 0xbb, 0xff, 0xff, 0xff, 0x77, 0xff, 0xff,
+	0xff, 0x77, 0x77, 0xff, 0x77, 0xbb, 0xdd, 0xee,
+};
+
+static unsigned char mmc_tuning_blk[128] __aligned(16);
+
 static bool is_cmd23_enabled(void)
 {
-	return ((mmc_flags & MMC_FLAG_CMD23) != 0U);
+	return ((mmc_flags & MMC_FLAG_CMD23) != 0U) ||
+	       (((mmc_flags & MMC_FLAG_CMD23_AUTO) != 0U) && mmc_card_cmd23);
 }
 
 static bool is_sd_cmd6_enabled(void)
@@ -50,6 +104,12 @@ static bool is_sd_cmd6_enabled(void)
 	return ((mmc_flags & MMC_FLAG_SD_CMD6) != 0U);
 }
 
+static bool is_sd_uhs_enabled(void)
+{
+	return ((mmc_flags & (MMC_FLAG_SD_SDR50 | MMC_FLAG_SD_SDR104)) != 0U) &&
+	       (ops->voltage_switch != NULL) && !mmc_sd_uhs_failed;
+}
+
 static int mmc_send_cmd(unsigned int idx, unsigned int arg,
 			unsigned int r_type, unsigned int *r_data)
 {
@@ -203,6 +263,8 @@ static int mmc_sd_switch(unsigned int bus_width)
 		bus_width_arg = 2;
 	}
 
+	mmc_card_cmd23 = ((scr[0] & SD_SCR_CMD23_SUPPORT) != 0U);
+
 	/* CMD55: Application Specific Command */
 	ret = mmc_send_cmd(MMC_CMD(55), rca << RCA_SHIFT_OFFSET,
 			   MMC_RESPONSE_R5, NULL);
@@ -253,6 +315,112 @@ static int mmc_set_ios(unsigned int clk, unsigned int bus_width)
 	return ops->set_ios(clk, width);
 }
 
+/*
+ * Select the fastest eMMC bus timing allowed by the platform flags and the
+ * device type. The bus width is already set in SDR mode, as required before
+ * switching to HS200. If the HS200 tuning fails, the high speed timing is
+ * used.
+ */
+static int mmc_emmc_set_timing(unsigned int clk, unsigned int bus_width)
+{
+	unsigned int device_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	unsigned int width = bus_width;
+	int ret;
+
+	if (((mmc_flags & MMC_FLAG_EMMC_HS200) != 0U) &&
+	    ((device_type & MMC_DEVICE_TYPE_HS200_1V8) != 0U) &&
+	    (bus_width != MMC_BUS_WIDTH_1) && (ops->execute_tuning != NULL)) {
+		ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING,
+				      MMC_HS_TIMING_HS200);
+		if (ret != 0) {
+			return ret;
+		}
+
+		mmc_dev_info->max_bus_freq = MMC_HS200_MAX_FREQ;
+
+		ret = ops->set_ios(clk, bus_width);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = ops->execute_tuning();
+		if (ret == 0) {
+			return 0;
+		}
+
+		WARN("eMMC HS200 tuning failed (%d), use high speed\n", ret);
+	} else if (((mmc_flags & (MMC_FLAG_EMMC_HS | MMC_FLAG_EMMC_DDR52)) == 0U) ||
+		   ((device_type & MMC_DEVICE_TYPE_HS_52) == 0U)) {
+		return 0;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS);
+	if (ret != 0) {
+		return ret;
+	}
+
+	mmc_dev_info->max_bus_freq = MMC_HS_52_MAX_FREQ;
+
+	if (((mmc_flags & MMC_FLAG_EMMC_DDR52) != 0U) &&
+	    ((device_type & MMC_DEVICE_TYPE_DDR_52_1V8_3V) != 0U) &&
+	    (bus_width != MMC_BUS_WIDTH_1)) {
+		if (bus_width == MMC_BUS_WIDTH_8) {
+			width = MMC_BUS_WIDTH_DDR_8;
+		} else {
+			width = MMC_BUS_WIDTH_DDR_4;
+		}
+
+		ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, width);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return ops->set_ios(clk, width);
+}
+
+int mmc_send_tuning(void)
+{
+	const unsigned char *pattern = tuning_blk_pattern_4bit;
+	size_t size = sizeof(tuning_blk_pattern_4bit);
+	unsigned int cmd_idx = MMC_CMD(21);
+	int ret;
+
+	assert(mmc_op_cond.bus_width != MMC_BUS_WIDTH_1);
+
+	if (mmc_op_cond.bus_width == MMC_BUS_WIDTH_8) {
+		pattern = tuning_blk_pattern_8bit;
+		size = sizeof(tuning_blk_pattern_8bit);
+	}
+
+	ret = ops->prepare(0, (uintptr_t)&mmc_tuning_blk, size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (mmc_dev_info->mmc_dev_type != MMC_IS_EMMC) {
+		/* SD CMD19: SEND_TUNING_BLOCK */
+		cmd_idx = MMC_CMD(19);
+	}
+
+	/* MMC CMD21: SEND_TUNING_BLOCK */
+	ret = mmc_send_cmd(cmd_idx, 0, MMC_RESPONSE_R1, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->read(0, (uintptr_t)&mmc_tuning_blk, size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (memcmp(mmc_tuning_blk, pattern, size) != 0) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
 static int mmc_fill_device_info(void)
 {
 	unsigned long long c_size;
@@ -390,99 +558,206 @@ static int sd_switch(unsigned char mode, unsigned char group,
 			 sizeof(sd_switch_func_status));
 }
 
-static int sd_send_op_cond(void)
+static bool sd_uhs_func_allowed(unsigned int func)
 {
-	int n;
-	unsigned int resp_data[4];
+	switch (func) {
+	case SD_SWITCH_FUNC_SDR104:
+		return ((mmc_flags & MMC_FLAG_SD_SDR104) != 0U) &&
+		       (ops->execute_tuning != NULL);
+	case SD_SWITCH_FUNC_SDR50:
+		return ((mmc_flags &
+			 (MMC_FLAG_SD_SDR50 | MMC_FLAG_SD_SDR104)) != 0U);
+	default:
+		return true;
+	}
+}
 
-	for (n = 0; n < SEND_OP_COND_MAX_RETRIES; n++) {
-		int ret;
+/*
+ * Select the fastest SD UHS-I bus speed mode supported by the card and allowed
+ * by the platform flags, the card signalling being already at 1.8V. The
+ * sampling point is tuned in SDR50 and SDR104, the next slower mode is tried
+ * if the tuning fails.
+ */
+static int mmc_sd_set_uhs_timing(unsigned int clk, unsigned int bus_width)
+{
+	static const unsigned int uhs_max_freq[] = {
+		[SD_SWITCH_FUNC_SDR25] = SD_SDR25_MAX_FREQ,
+		[SD_SWITCH_FUNC_SDR50] = SD_SDR50_MAX_FREQ,
+		[SD_SWITCH_FUNC_SDR104] = SD_SDR104_MAX_FREQ,
+	};
+	unsigned int default_freq = mmc_dev_info->max_bus_freq;
+	unsigned int support;
+	unsigned int func;
+	int ret;
+
+	/* UHS-I bus speed modes other than SDR12 require the 4-bit bus */
+	if (bus_width != MMC_BUS_WIDTH_4) {
+		return 0;
+	}
+
+	ret = sd_switch(SD_SWITCH_FUNC_CHECK, 1U, SD_SWITCH_FUNC_SDR104);
+	if (ret != 0) {
+		return ret;
+	}
+
+	support = sd_switch_func_status.support_g1;
+
+	for (func = SD_SWITCH_FUNC_SDR104; func >= SD_SWITCH_FUNC_SDR25;
+	     func--) {
+		if (((support & BIT(8U + func)) == 0U) ||
+		    !sd_uhs_func_allowed(func)) {
+			continue;
+		}
 
-		/* CMD55: Application Specific Command */
-		ret = mmc_send_cmd(MMC_CMD(55), 0, MMC_RESPONSE_R1, NULL);
+		ret = sd_switch(SD_SWITCH_FUNC_SWITCH, 1U, func);
 		if (ret != 0) {
 			return ret;
 		}
 
-		/* ACMD41: SD_SEND_OP_COND */
-		ret = mmc_send_cmd(MMC_ACMD(41), OCR_HCS |
-			mmc_dev_info->ocr_voltage, MMC_RESPONSE_R3,
-			&resp_data[0]);
+		if ((sd_switch_func_status.sel_g2_g1 & 0xFU) != func) {
+			continue;
+		}
+
+		mmc_dev_info->max_bus_freq = uhs_max_freq[func];
+
+		ret = ops->set_ios(clk, bus_width);
 		if (ret != 0) {
 			return ret;
 		}
 
-		if ((resp_data[0] & OCR_POWERUP) != 0U) {
-			mmc_ocr_value = resp_data[0];
-
-			if ((mmc_ocr_value & OCR_HCS) != 0U) {
-				mmc_dev_info->mmc_dev_type = MMC_IS_SD_HC;
-			} else {
-				mmc_dev_info->mmc_dev_type = MMC_IS_SD;
-			}
+		if ((func == SD_SWITCH_FUNC_SDR25) ||
+		    (ops->execute_tuning == NULL)) {
+			return 0;
+		}
 
+		ret = ops->execute_tuning();
+		if (ret == 0) {
 			return 0;
 		}
 
-		mdelay(10);
+		WARN("SD UHS-I tuning failed (%d), try a slower mode\n", ret);
 	}
 
-	ERROR("ACMD41 failed after %d retries\n", SEND_OP_COND_MAX_RETRIES);
+	/* Keep SDR12, or the last selected mode at the default frequency */
+	mmc_dev_info->max_bus_freq = default_freq;
 
-	return -EIO;
+	return ops->set_ios(clk, bus_width);
 }
 
-static int mmc_reset_to_idle(void)
+/*
+ * Send CMD1 (eMMC) or ACMD41 (SD) once, the card being ready when it has
+ * completed its power-up.
+ *
+ * Return: 0 = card ready, -EAGAIN = card busy, Otherwise = error
+ */
+static int mmc_op_cond_try(void)
 {
 	int ret;
+	unsigned int resp_data[4];
+	unsigned int arg;
 
-	/* CMD0: reset to IDLE */
-	ret = mmc_send_cmd(MMC_CMD(0), 0, 0, NULL);
+	if (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) {
+		/* CMD1: SEND_OP_COND */
+		ret = mmc_send_cmd(MMC_CMD(1), OCR_SECTOR_MODE |
+				   OCR_VDD_MIN_2V7 | OCR_VDD_MIN_1V7,
+				   MMC_RESPONSE_R3, &resp_data[0]);
+		if (ret != 0) {
+			return ret;
+		}
+
+		if ((resp_data[0] & OCR_POWERUP) == 0U) {
+			return -EAGAIN;
+		}
+
+		mmc_ocr_value = resp_data[0];
+
+		return 0;
+	}
+
+	/* CMD55: Application Specific Command */
+	ret = mmc_send_cmd(MMC_CMD(55), 0, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
 		return ret;
 	}
 
-	mdelay(2);
+	arg = OCR_HCS | mmc_dev_info->ocr_voltage;
+	if (is_sd_uhs_enabled()) {
+		arg |= OCR_S18R;
+	}
+
+	/* ACMD41: SD_SEND_OP_COND */
+	ret = mmc_send_cmd(MMC_ACMD(41), arg, MMC_RESPONSE_R3, &resp_data[0]);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if ((resp_data[0] & OCR_POWERUP) == 0U) {
+		return -EAGAIN;
+	}
+
+	mmc_ocr_value = resp_data[0];
+
+	if ((mmc_ocr_value & OCR_HCS) != 0U) {
+		mmc_dev_info->mmc_dev_type = MMC_IS_SD_HC;
+	} else {
+		mmc_dev_info->mmc_dev_type = MMC_IS_SD;
+	}
+
+	/* S18A: the card accepts to switch to 1.8V signalling */
+	mmc_sd_uhs = is_sd_uhs_enabled() &&
+		     ((mmc_ocr_value & (OCR_HCS | OCR_S18R)) ==
+		      (OCR_HCS | OCR_S18R));
 
 	return 0;
 }
 
-static int mmc_send_op_cond(void)
+/*
+ * CMD11: switch the card and the host to 1.8V signalling, before the card
+ * identification. A failed switch requires a power cycle of the card.
+ */
+static int mmc_sd_voltage_switch(void)
 {
-	int ret, n;
-	unsigned int resp_data[4];
+	int ret;
 
-	ret = mmc_reset_to_idle();
+	/* CMD11: VOLTAGE_SWITCH */
+	ret = mmc_send_cmd(MMC_CMD(11), 0, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
 		return ret;
 	}
 
-	for (n = 0; n < SEND_OP_COND_MAX_RETRIES; n++) {
-		ret = mmc_send_cmd(MMC_CMD(1), OCR_SECTOR_MODE |
-				   OCR_VDD_MIN_2V7 | OCR_VDD_MIN_1V7,
-				   MMC_RESPONSE_R3, &resp_data[0]);
-		if (ret != 0) {
-			return ret;
-		}
+	return ops->voltage_switch();
+}
 
-		if ((resp_data[0] & OCR_POWERUP) != 0U) {
-			mmc_ocr_value = resp_data[0];
-			return 0;
-		}
+static int mmc_reset_to_idle(void)
+{
+	int ret;
 
-		mdelay(10);
+	/* CMD0: reset to IDLE */
+	ret = mmc_send_cmd(MMC_CMD(0), 0, 0, NULL);
+	if (ret != 0) {
+		return ret;
 	}
 
-	ERROR("CMD1 failed after %d retries\n", SEND_OP_COND_MAX_RETRIES);
+	mdelay(2);
 
-	return -EIO;
+	return 0;
 }
 
-static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
+/*
+ * Reset the card and send the first CMD1 or ACMD41. If the card is not ready,
+ * the command is sent again by mmc_init_poll() every SEND_OP_COND_DELAY_US.
+ */
+static int mmc_enumerate_start(unsigned int clk, unsigned int bus_width)
 {
 	int ret;
 	unsigned int resp_data[4];
 
+	mmc_op_cond.clk = clk;
+	mmc_op_cond.bus_width = bus_width;
+	mmc_op_cond.retries = 0U;
+	mmc_op_cond.pending = false;
+	mmc_sd_uhs = false;
+
 	ops->init();
 
 	ret = mmc_reset_to_idle();
@@ -491,18 +766,59 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 	}
 
 	if (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) {
-		ret = mmc_send_op_cond();
+		ret = mmc_reset_to_idle();
+		if (ret != 0) {
+			return ret;
+		}
 	} else {
 		/* CMD8: Send Interface Condition Command */
 		ret = mmc_send_cmd(MMC_CMD(8), VHS_2_7_3_6_V | CMD8_CHECK_PATTERN,
 				   MMC_RESPONSE_R5, &resp_data[0]);
+		if (ret != 0) {
+			return ret;
+		}
 
-		if ((ret == 0) && ((resp_data[0] & 0xffU) == CMD8_CHECK_PATTERN)) {
-			ret = sd_send_op_cond();
+		if ((resp_data[0] & 0xffU) != CMD8_CHECK_PATTERN) {
+			return 0;
 		}
 	}
-	if (ret != 0) {
-		return ret;
+
+	ret = mmc_op_cond_try();
+	if (ret == -EAGAIN) {
+		mmc_op_cond.retries = 1U;
+		mmc_op_cond.timeout = timeout_init_us(SEND_OP_COND_DELAY_US);
+		mmc_op_cond.pending = true;
+		ret = 0;
+	}
+
+	return ret;
+}
+
+static int mmc_enumerate_finish(void)
+{
+	int ret;
+	unsigned int resp_data[4];
+	unsigned int clk = mmc_op_cond.clk;
+	unsigned int bus_width = mmc_op_cond.bus_width;
+
+	if (mmc_sd_uhs) {
+		ret = mmc_sd_voltage_switch();
+		if (ret != 0) {
+			WARN("SD 1.8V switch failed (%d), use 3.3V\n", ret);
+			mmc_sd_uhs_failed = true;
+
+			/* Power cycle the card, and enumerate it again */
+			ret = mmc_enumerate_start(clk, bus_width);
+			if (ret != 0) {
+				return ret;
+			}
+
+			if (mmc_op_cond.pending) {
+				return -EAGAIN;
+			}
+
+			return mmc_enumerate_finish();
+		}
 	}
 
 	/* CMD2: Card Identification */
@@ -538,6 +854,11 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 
 	memcpy(&mmc_csd, &resp_data, sizeof(resp_data));
 
+	/* SET_BLOCK_COUNT is supported by all MMC since version 3.1 */
+	if (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) {
+		mmc_card_cmd23 = (mmc_csd.spec_vers >= 3U);
+	}
+
 	/* CMD7: Select Card */
 	ret = mmc_send_cmd(MMC_CMD(7), rca << RCA_SHIFT_OFFSET,
 			   MMC_RESPONSE_R1, NULL);
@@ -562,6 +883,15 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		return ret;
 	}
 
+	if ((mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) &&
+	    (mmc_csd.spec_vers == 4U)) {
+		return mmc_emmc_set_timing(clk, bus_width);
+	}
+
+	if (mmc_sd_uhs) {
+		return mmc_sd_set_uhs_timing(clk, bus_width);
+	}
+
 	if (is_sd_cmd6_enabled() &&
 	    (mmc_dev_info->mmc_dev_type == MMC_IS_SD_HC)) {
 		/* Try to switch to High Speed Mode */
@@ -592,7 +922,9 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 	return ret;
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+static int mmc_user_part_select(void);
+
+static int mmc_read_blocks_cmd(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
@@ -600,11 +932,12 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	assert((ops != NULL) &&
 	       (ops->read != NULL) &&
 	       (size != 0U) &&
-	       ((size & MMC_BLOCK_MASK) == 0U));
+	       ((size & MMC_BLOCK_MASK) == 0U) &&
+	       (mmc_pending_read.size == 0U));
 
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
 	if (is_cmd23_enabled()) {
@@ -612,7 +945,7 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		ret = mmc_send_cmd(MMC_CMD(23), size / MMC_BLOCK_SIZE,
 				   MMC_RESPONSE_R1, NULL);
 		if (ret != 0) {
-			return 0;
+			return ret;
 		}
 
 		cmd_idx = MMC_CMD(18);
@@ -633,10 +966,38 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 
 	ret = mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
-	ret = ops->read(lba, buf, size);
+	mmc_pending_read.lba = lba;
+	mmc_pending_read.buf = buf;
+	mmc_pending_read.size = size;
+
+	return 0;
+}
+
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size)
+{
+	int ret;
+
+	ret = mmc_user_part_select();
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_read_blocks_cmd(lba, buf, size);
+}
+
+size_t mmc_read_blocks_wait(void)
+{
+	int ret;
+	size_t size = mmc_pending_read.size;
+
+	assert(size != 0U);
+
+	mmc_pending_read.size = 0U;
+
+	ret = ops->read(mmc_pending_read.lba, mmc_pending_read.buf, size);
 	if (ret != 0) {
 		return 0;
 	}
@@ -659,6 +1020,15 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	return size;
 }
 
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	if (mmc_read_blocks_start(lba, buf, size) != 0) {
+		return 0;
+	}
+
+	return mmc_read_blocks_wait();
+}
+
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	int ret;
@@ -670,6 +1040,11 @@ size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 	       ((buf & MMC_BLOCK_MASK) == 0U) &&
 	       ((size & MMC_BLOCK_MASK) == 0U));
 
+	ret = mmc_user_part_select();
+	if (ret != 0) {
+		return 0;
+	}
+
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
 		return 0;
@@ -733,6 +1108,11 @@ size_t mmc_erase_blocks(int lba, size_t size)
 	assert(ops != NULL);
 	assert((size != 0U) && ((size & MMC_BLOCK_MASK) == 0U));
 
+	ret = mmc_user_part_select();
+	if (ret != 0) {
+		return 0;
+	}
+
 	ret = mmc_send_cmd(MMC_CMD(35), lba, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
 		return 0;
@@ -761,6 +1141,7 @@ size_t mmc_erase_blocks(int lba, size_t size)
 
 static inline void mmc_rpmb_enable(void)
 {
+	mmc_boot_part_selected = false;
 	mmc_set_ext_csd(CMD_EXTCSD_PARTITION_CONFIG,
 			PART_CFG_BOOT_PARTITION1_ENABLE |
 			PART_CFG_BOOT_PARTITION1_ACCESS);
@@ -820,38 +1201,74 @@ static unsigned char mmc_current_boot_part(void)
 	return PART_CFG_CURRENT_BOOT_PARTITION(mmc_ext_csd[CMD_EXTCSD_PARTITION_CONFIG]);
 }
 
-size_t mmc_boot_part_read_blocks(int lba, uintptr_t buf, size_t size)
+/* Go back to the user area after boot partition reads */
+static int mmc_user_part_select(void)
 {
-	size_t size_read;
 	int ret;
-	unsigned char current_boot_part = mmc_current_boot_part();
 
-	if (current_boot_part != 1U &&
-	    current_boot_part != 2U) {
-		ERROR("Got unexpected value for active boot partition, %u\n", current_boot_part);
+	if (!mmc_boot_part_selected) {
 		return 0;
 	}
 
-	ret = mmc_part_switch(current_boot_part);
+	ret = mmc_part_switch(0);
 	if (ret < 0) {
-		ERROR("Failed to switch to boot partition, %d\n", ret);
-		return 0;
+		ERROR("Failed to switch back to user partition, %d\n", ret);
+		return ret;
 	}
 
-	size_read = mmc_read_blocks(lba, buf, size);
+	mmc_boot_part_selected = false;
 
-	ret = mmc_part_switch(0);
-	if (ret < 0) {
-		ERROR("Failed to switch back to user partition, %d\n", ret);
+	return 0;
+}
+
+/*
+ * Read from the boot partition enabled for boot. The partition is selected
+ * by the first read and kept for the following ones, so that consecutive
+ * reads are plain multiple block reads.
+ */
+int mmc_boot_part_read_blocks_start(int lba, uintptr_t buf, size_t size)
+{
+	unsigned char current_boot_part = mmc_current_boot_part();
+	int ret;
+
+	if (!mmc_boot_part_selected) {
+		if ((current_boot_part != 1U) && (current_boot_part != 2U)) {
+			ERROR("Got unexpected value for active boot partition, %u\n",
+			      current_boot_part);
+			return -EINVAL;
+		}
+
+		ret = mmc_part_switch(current_boot_part);
+		if (ret < 0) {
+			ERROR("Failed to switch to boot partition, %d\n", ret);
+			return ret;
+		}
+
+		mmc_boot_part_selected = true;
+	}
+
+	return mmc_read_blocks_cmd(lba, buf, size);
+}
+
+size_t mmc_boot_part_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	if (mmc_boot_part_read_blocks_start(lba, buf, size) != 0) {
 		return 0;
 	}
 
-	return size_read;
+	return mmc_read_blocks_wait();
 }
 
-int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
-	     unsigned int width, unsigned int flags,
-	     struct mmc_device_info *device_info)
+/* Size in bytes of each boot partition */
+size_t mmc_boot_part_size(void)
+{
+	return (size_t)mmc_ext_csd[CMD_EXTCSD_BOOT_SIZE_MULT] *
+	       MMC_BOOT_SIZE_MULT_UNIT;
+}
+
+int mmc_init_start(const struct mmc_ops *ops_ptr, unsigned int clk,
+		   unsigned int width, unsigned int flags,
+		   struct mmc_device_info *device_info)
 {
 	assert((ops_ptr != NULL) &&
 	       (ops_ptr->init != NULL) &&
@@ -870,7 +1287,61 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 
 	ops = ops_ptr;
 	mmc_flags = flags;
+	mmc_card_cmd23 = false;
+	mmc_sd_uhs_failed = false;
+	mmc_boot_part_selected = false;
 	mmc_dev_info = device_info;
 
-	return mmc_enumerate(clk, width);
+	return mmc_enumerate_start(clk, width);
+}
+
+int mmc_init_poll(void)
+{
+	int ret;
+
+	if (mmc_op_cond.pending) {
+		if (!timeout_elapsed(mmc_op_cond.timeout)) {
+			return -EAGAIN;
+		}
+
+		ret = mmc_op_cond_try();
+		if (ret == -EAGAIN) {
+			mmc_op_cond.retries++;
+			if (mmc_op_cond.retries < SEND_OP_COND_MAX_RETRIES) {
+				mmc_op_cond.timeout =
+					timeout_init_us(SEND_OP_COND_DELAY_US);
+				return -EAGAIN;
+			}
+
+			ERROR("%s failed after %d retries\n",
+			      (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) ?
+			      "CMD1" : "ACMD41", SEND_OP_COND_MAX_RETRIES);
+			ret = -EIO;
+		}
+
+		mmc_op_cond.pending = false;
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return mmc_enumerate_finish();
+}
+
+int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
+	     unsigned int width, unsigned int flags,
+	     struct mmc_device_info *device_info)
+{
+	int ret;
+
+	ret = mmc_init_start(ops_ptr, clk, width, flags, device_info);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_init_poll();
+	} while (ret == -EAGAIN);
+
+	return ret;
 }
@@ -15,11 +15,52 @@
 #include <drivers/nand.h>
 #include <lib/utils.h>
 
+/* Number of blocks whose bad block status is cached */
+#ifndef NAND_BBT_MAX_BLOCKS
+#define NAND_BBT_MAX_BLOCKS	4096U
+#endif
+
+#define NAND_BBT_WORDS		((NAND_BBT_MAX_BLOCKS + 31U) / 32U)
+
 /*
  * Define a single nand_device used by specific NAND frameworks.
  */
 static struct nand_device nand_dev;
 
+/*
+ * Bad block table, lazily populated so that each block OOB area is probed
+ * at most once.
+ */
+static uint32_t bbt_checked[NAND_BBT_WORDS];
+static uint32_t bbt_bad[NAND_BBT_WORDS];
+
+static int nand_block_is_bad(unsigned int block)
+{
+	unsigned int word = block / 32U;
+	uint32_t mask = BIT_32(block % 32U);
+	int is_bad;
+
+	if (block >= NAND_BBT_MAX_BLOCKS) {
+		return nand_dev.mtd_block_is_bad(block);
+	}
+
+	if ((bbt_checked[word] & mask) != 0U) {
+		return ((bbt_bad[word] & mask) != 0U) ? 1 : 0;
+	}
+
+	is_bad = nand_dev.mtd_block_is_bad(block);
+	if (is_bad < 0) {
+		return is_bad;
+	}
+
+	bbt_checked[word] |= mask;
+	if (is_bad == 1) {
+		bbt_bad[word] |= mask;
+	}
+
+	return is_bad;
+}
+
 #pragma weak plat_get_scratch_buffer
 void plat_get_scratch_buffer(void **buffer_addr, size_t *buf_size)
 {
@@ -63,7 +104,7 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 	}
 
 	while (block <= end_block) {
-		is_bad = nand_dev.mtd_block_is_bad(block);
+		is_bad = nand_block_is_bad(block);
 		if (is_bad < 0) {
 			return is_bad;
 		}
@@ -102,6 +143,23 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 				       bytes_read);
 
 				start_offset = 0U;
+			} else if ((nand_dev.mtd_read_pages != NULL) &&
+				   (length >= (2U * nand_dev.page_size)) &&
+				   (page < (nb_pages - 1U))) {
+				unsigned int nb_seq =
+					MIN((size_t)(nb_pages - page),
+					    length / nand_dev.page_size);
+
+				ret = nand_dev.mtd_read_pages(&nand_dev,
+						(block * nb_pages) + page,
+						nb_seq, buffer);
+				if (ret != 0) {
+					return ret;
+				}
+
+				/* Loop increment accounts for the last page */
+				page += nb_seq - 1U;
+				bytes_read = nb_seq * nand_dev.page_size;
 			} else {
 				ret = nand_dev.mtd_read_page(&nand_dev,
 						(block * nb_pages) + page,
@@ -152,7 +210,7 @@ int nand_seek_bb(uintptr_t base, unsigned int offset, size_t *extra_offset)
 			return -EIO;
 		}
 
-		is_bad = nand_dev.mtd_block_is_bad(block);
+		is_bad = nand_block_is_bad(block);
 		if (is_bad < 0) {
 			return is_bad;
 		}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -29,6 +29,142 @@
 
 static struct rawnand_device rawnand_dev;
 
+/* ONFI SDR timing modes 0 to 5 */
+static const struct nand_sdr_timings onfi_sdr_timings[ONFI_SDR_TIMING_MODES] = {
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 20000UL,
+		.tAR_min = 25000UL,
+		.tCH_min = 20000UL,
+		.tCLH_min = 20000UL,
+		.tCLR_min = 20000UL,
+		.tCOH_min = 0UL,
+		.tCS_min = 70000UL,
+		.tDH_min = 20000UL,
+		.tDS_min = 40000UL,
+		.tRC_min = 100000UL,
+		.tREA_max = 40000UL,
+		.tREH_min = 30000UL,
+		.tRHW_min = 200000UL,
+		.tRP_min = 50000UL,
+		.tWB_max = 200000UL,
+		.tWC_min = 100000UL,
+		.tWH_min = 30000UL,
+		.tWHR_min = 120000UL,
+		.tWP_min = 50000UL,
+	},
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 10000UL,
+		.tAR_min = 10000UL,
+		.tCH_min = 10000UL,
+		.tCLH_min = 10000UL,
+		.tCLR_min = 10000UL,
+		.tCOH_min = 15000UL,
+		.tCS_min = 35000UL,
+		.tDH_min = 10000UL,
+		.tDS_min = 20000UL,
+		.tRC_min = 50000UL,
+		.tREA_max = 30000UL,
+		.tREH_min = 15000UL,
+		.tRHW_min = 100000UL,
+		.tRP_min = 25000UL,
+		.tWB_max = 100000UL,
+		.tWC_min = 45000UL,
+		.tWH_min = 15000UL,
+		.tWHR_min = 80000UL,
+		.tWP_min = 25000UL,
+	},
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 10000UL,
+		.tAR_min = 10000UL,
+		.tCH_min = 10000UL,
+		.tCLH_min = 10000UL,
+		.tCLR_min = 10000UL,
+		.tCOH_min = 15000UL,
+		.tCS_min = 25000UL,
+		.tDH_min = 5000UL,
+		.tDS_min = 15000UL,
+		.tRC_min = 35000UL,
+		.tREA_max = 25000UL,
+		.tREH_min = 15000UL,
+		.tRHW_min = 100000UL,
+		.tRP_min = 17000UL,
+		.tWB_max = 100000UL,
+		.tWC_min = 35000UL,
+		.tWH_min = 15000UL,
+		.tWHR_min = 80000UL,
+		.tWP_min = 17000UL,
+	},
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 5000UL,
+		.tAR_min = 10000UL,
+		.tCH_min = 5000UL,
+		.tCLH_min = 5000UL,
+		.tCLR_min = 10000UL,
+		.tCOH_min = 15000UL,
+		.tCS_min = 25000UL,
+		.tDH_min = 5000UL,
+		.tDS_min = 10000UL,
+		.tRC_min = 30000UL,
+		.tREA_max = 20000UL,
+		.tREH_min = 10000UL,
+		.tRHW_min = 100000UL,
+		.tRP_min = 15000UL,
+		.tWB_max = 100000UL,
+		.tWC_min = 30000UL,
+		.tWH_min = 10000UL,
+		.tWHR_min = 60000UL,
+		.tWP_min = 15000UL,
+	},
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 5000UL,
+		.tAR_min = 10000UL,
+		.tCH_min = 5000UL,
+		.tCLH_min = 5000UL,
+		.tCLR_min = 10000UL,
+		.tCOH_min = 15000UL,
+		.tCS_min = 20000UL,
+		.tDH_min = 5000UL,
+		.tDS_min = 10000UL,
+		.tRC_min = 25000UL,
+		.tREA_max = 20000UL,
+		.tREH_min = 10000UL,
+		.tRHW_min = 100000UL,
+		.tRP_min = 12000UL,
+		.tWB_max = 100000UL,
+		.tWC_min = 25000UL,
+		.tWH_min = 10000UL,
+		.tWHR_min = 60000UL,
+		.tWP_min = 12000UL,
+	},
+	{
+		.tADL_min = 400000UL,
+		.tALH_min = 5000UL,
+		.tAR_min = 10000UL,
+		.tCH_min = 5000UL,
+		.tCLH_min = 5000UL,
+		.tCLR_min = 10000UL,
+		.tCOH_min = 15000UL,
+		.tCS_min = 15000UL,
+		.tDH_min = 5000UL,
+		.tDS_min = 7000UL,
+		.tRC_min = 20000UL,
+		.tREA_max = 16000UL,
+		.tREH_min = 7000UL,
+		.tRHW_min = 100000UL,
+		.tRP_min = 10000UL,
+		.tWB_max = 100000UL,
+		.tWC_min = 20000UL,
+		.tWH_min = 7000UL,
+		.tWHR_min = 60000UL,
+		.tWP_min = 10000UL,
+	},
+};
+
 #pragma weak plat_get_raw_nand_data
 int plat_get_raw_nand_data(struct rawnand_device *device)
 {
@@ -87,6 +223,21 @@ static int nand_read_data(uint8_t *data, unsigned int length, bool use_8bit)
 	return rawnand_dev.ops->exec(&req);
 }
 
+#if NAND_ONFI_DETECT
+static int nand_write_data(uint8_t *data, unsigned int length, bool use_8bit)
+{
+	struct nand_req req;
+
+	zeromem(&req, sizeof(struct nand_req));
+	req.nand = rawnand_dev.nand_dev;
+	req.type = NAND_REQ_DATAOUT | (use_8bit ? NAND_REQ_BUS_WIDTH_8 : 0U);
+	req.addr = data;
+	req.length = length;
+
+	return rawnand_dev.ops->exec(&req);
+}
+#endif
+
 int nand_change_read_column_cmd(unsigned int offset, uintptr_t buffer,
 				unsigned int len)
 {
@@ -118,7 +269,11 @@ int nand_change_read_column_cmd(unsigned int offset, uintptr_t buffer,
 		return ret;
 	}
 
-	return nand_read_data((uint8_t *)buffer, len, false);
+	if (buffer != 0U) {
+		ret = nand_read_data((uint8_t *)buffer, len, false);
+	}
+
+	return ret;
 }
 
 int nand_read_page_cmd(unsigned int page, unsigned int offset,
@@ -174,6 +329,34 @@ int nand_read_page_cmd(unsigned int page, unsigned int offset,
 	return ret;
 }
 
+/*
+ * Issue READ CACHE SEQUENTIAL (31h), or READ CACHE END (3Fh) for the last
+ * page, after a nand_read_page_cmd(). The page previously loaded is moved to
+ * the cache register and, unless last is set, the array read of the next page
+ * starts while the cache register content is transferred.
+ */
+int nand_read_cache_cmd(bool last, uintptr_t buffer, unsigned int len)
+{
+	int ret;
+
+	ret = nand_send_cmd(last ? NAND_CMD_READ_CACHE_END :
+			    NAND_CMD_READ_CACHE_SEQ, NAND_TWB_MAX);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = nand_send_wait(PSEC_TO_MSEC(NAND_TR_MAX), NAND_TRR_MIN);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (buffer != 0U) {
+		ret = nand_read_data((uint8_t *)buffer, len, false);
+	}
+
+	return ret;
+}
+
 static int nand_status(uint8_t *status)
 {
 	int ret;
@@ -330,6 +513,16 @@ static int nand_read_param_page(void)
 				     page.bytes_per_page *
 				     page.num_blk_in_lun * page.num_lun;
 
+	if ((page.opt_cmd & ONFI_OPT_CMD_READ_CACHE) != 0U) {
+		rawnand_dev.read_cache = true;
+	}
+
+	if ((page.opt_cmd & ONFI_OPT_CMD_SET_GET_FEATURES) != 0U) {
+		rawnand_dev.set_features = true;
+	}
+
+	rawnand_dev.sdr_timing_modes = page.sdr_timing_mode;
+
 	if (page.nb_ecc_bits != GENMASK_32(7, 0)) {
 		rawnand_dev.nand_dev->ecc.max_bit_corr = page.nb_ecc_bits;
 		rawnand_dev.nand_dev->ecc.size = SZ_512;
@@ -366,8 +559,114 @@ static int detect_onfi(void)
 
 	return nand_read_param_page();
 }
+
+static int nand_set_features(uint8_t feature, uint8_t *param)
+{
+	int ret;
+
+	ret = nand_send_cmd(NAND_CMD_SET_FEATURES, 0U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = nand_send_addr(feature, NAND_TADL_MIN);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = nand_write_data(param, ONFI_SUBFEATURE_PARAM_LEN, true);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return nand_send_wait(PSEC_TO_MSEC(NAND_TFEAT_MAX), 0U);
+}
+
+static int nand_get_features(uint8_t feature, uint8_t *param)
+{
+	int ret;
+
+	ret = nand_send_cmd(NAND_CMD_GET_FEATURES, 0U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = nand_send_addr(feature, NAND_TWB_MAX);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = nand_send_wait(PSEC_TO_MSEC(NAND_TFEAT_MAX), NAND_TRR_MIN);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return nand_read_data(param, ONFI_SUBFEATURE_PARAM_LEN, true);
+}
+
+/*
+ * Switch the device and the controller to the fastest ONFI timing mode they
+ * both support. On failure, both are set back to mode 0, the mode of the
+ * device after a reset.
+ */
+static void nand_setup_timing_mode(void)
+{
+	const struct nand_ctrl_ops *ops = rawnand_dev.ops;
+	uint8_t param[ONFI_SUBFEATURE_PARAM_LEN];
+	unsigned int mode;
+	int ret = 0;
+
+	if (ops->setup_timings == NULL) {
+		return;
+	}
+
+	for (mode = ONFI_SDR_TIMING_MODES - 1U; mode > 0U; mode--) {
+		if (((rawnand_dev.sdr_timing_modes & BIT(mode)) != 0U) &&
+		    (ops->setup_timings(&onfi_sdr_timings[mode], true) == 0)) {
+			break;
+		}
+	}
+
+	if (mode == 0U) {
+		return;
+	}
+
+	/* The device switches on SET FEATURES, if it supports it */
+	if (rawnand_dev.set_features) {
+		zeromem(param, sizeof(param));
+		param[0] = (uint8_t)mode;
+		ret = nand_set_features(ONFI_FEATURE_ADDR_TIMING_MODE, param);
+	}
+
+	if (ret == 0) {
+		ret = ops->setup_timings(&onfi_sdr_timings[mode], false);
+	}
+
+	if ((ret == 0) && rawnand_dev.set_features) {
+		ret = nand_get_features(ONFI_FEATURE_ADDR_TIMING_MODE, param);
+		if ((ret == 0) && (param[0] != mode)) {
+			ret = -EIO;
+		}
+	}
+
+	if (ret == 0) {
+		VERBOSE("NAND ONFI timing mode %u\n", mode);
+		return;
+	}
+
+	WARN("NAND timing mode %u not set (%d), using mode 0\n", mode, ret);
+	(void)ops->setup_timings(&onfi_sdr_timings[0], false);
+	(void)nand_reset();
+}
 #endif
 
+const struct nand_sdr_timings *nand_onfi_sdr_timings(unsigned int mode)
+{
+	assert(mode < ONFI_SDR_TIMING_MODES);
+
+	return &onfi_sdr_timings[mode];
+}
+
 static int nand_mtd_block_is_bad(unsigned int block)
 {
 	unsigned int nbpages_per_block = rawnand_dev.nand_dev->block_size /
@@ -402,6 +701,30 @@ static int nand_mtd_read_page_raw(struct nand_device *nand, unsigned int page,
 				  rawnand_dev.nand_dev->page_size);
 }
 
+static int nand_mtd_read_pages_raw(struct nand_device *nand, unsigned int page,
+				   unsigned int nb_pages, uintptr_t buffer)
+{
+	unsigned int i;
+	int ret;
+
+	ret = nand_read_page_cmd(page, 0U, 0U, 0U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < nb_pages; i++) {
+		ret = nand_read_cache_cmd(i == (nb_pages - 1U), buffer,
+					  nand->page_size);
+		if (ret != 0) {
+			return ret;
+		}
+
+		buffer += nand->page_size;
+	}
+
+	return 0;
+}
+
 void nand_raw_ctrl_init(const struct nand_ctrl_ops *ops)
 {
 	rawnand_dev.ops = ops;
@@ -416,6 +739,10 @@ int nand_raw_init(unsigned long long *size, unsigned int *erase_size)
 
 	rawnand_dev.nand_dev->mtd_block_is_bad = nand_mtd_block_is_bad;
 	rawnand_dev.nand_dev->mtd_read_page = nand_mtd_read_page_raw;
+	rawnand_dev.nand_dev->mtd_read_pages = NULL;
+	rawnand_dev.read_cache = false;
+	rawnand_dev.set_features = false;
+	rawnand_dev.sdr_timing_modes = 0U;
 	rawnand_dev.nand_dev->ecc.mode = NAND_ECC_NONE;
 
 	if ((rawnand_dev.ops->setup == NULL) ||
@@ -437,6 +764,14 @@ int nand_raw_init(unsigned long long *size, unsigned int *erase_size)
 	       (rawnand_dev.nand_dev->block_size != 0U) &&
 	       (rawnand_dev.nand_dev->size != 0U));
 
+	if (rawnand_dev.read_cache) {
+		rawnand_dev.nand_dev->mtd_read_pages = nand_mtd_read_pages_raw;
+	}
+
+#if NAND_ONFI_DETECT
+	nand_setup_timing_mode();
+#endif
+
 	*size = rawnand_dev.nand_dev->size;
 	*erase_size = rawnand_dev.nand_dev->block_size;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021,  STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022,  STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -18,6 +18,8 @@
 #define SPI_NAND_MAX_ID_LEN		4U
 #define DELAY_US_400MS			400000U
 #define MACRONIX_ID			0xC2U
+#define MICRON_ID			0x2CU
+#define WINBOND_ID			0xEFU
 
 static struct spinand_device spinand_dev;
 
@@ -104,6 +106,42 @@ static int spi_nand_quad_enable(uint8_t manufacturer_id)
 				   enable ? SPI_NAND_CFG_QE : 0U);
 }
 
+/*
+ * Send the column address on the four lines too (1-4-4) when the read from
+ * cache is in quad output mode, the device is known to support it and the
+ * bus has four lines in both directions.
+ */
+static void spi_nand_select_quad_io(uint8_t manufacturer_id)
+{
+	struct spi_mem_op op = spinand_dev.spi_read_cache_op;
+
+	if ((op.data.buswidth != SPI_MEM_BUSWIDTH_4_LINE) ||
+	    (op.addr.buswidth != SPI_MEM_BUSWIDTH_1_LINE)) {
+		return;
+	}
+
+	switch (manufacturer_id) {
+	case MACRONIX_ID:
+	case MICRON_ID:
+	case WINBOND_ID:
+		break;
+	default:
+		return;
+	}
+
+	op.cmd.opcode = SPI_NAND_OP_READ_FROM_CACHE_QUAD_IO;
+	op.addr.buswidth = SPI_MEM_BUSWIDTH_4_LINE;
+	/* 4 dummy clocks */
+	op.dummy.nbytes = 2U;
+	op.dummy.buswidth = SPI_MEM_BUSWIDTH_4_LINE;
+	op.data.nbytes = 1U;
+
+	if (spi_mem_supports_op(&op)) {
+		op.data.nbytes = 0U;
+		spinand_dev.spi_read_cache_op = op;
+	}
+}
+
 static int spi_nand_wait_ready(uint8_t *status)
 {
 	int ret;
@@ -157,7 +195,7 @@ static int spi_nand_read_id(uint8_t *id)
 	return spi_mem_exec_op(&op);
 }
 
-static int spi_nand_load_page(unsigned int page)
+static int spi_nand_page_op(uint8_t opcode, unsigned int page)
 {
 	struct spi_mem_op op;
 	uint32_t block_nb = page / spinand_dev.nand_dev->block_size;
@@ -167,7 +205,7 @@ static int spi_nand_load_page(unsigned int page)
 	uint32_t block_sh = __builtin_ctz(nbpages_per_block) + 1U;
 
 	zeromem(&op, sizeof(struct spi_mem_op));
-	op.cmd.opcode = SPI_NAND_OP_LOAD_PAGE;
+	op.cmd.opcode = opcode;
 	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
 	op.addr.val = (block_nb << block_sh) | page_nb;
 	op.addr.nbytes = 3U;
@@ -176,6 +214,22 @@ static int spi_nand_load_page(unsigned int page)
 	return spi_mem_exec_op(&op);
 }
 
+static int spi_nand_load_page(unsigned int page)
+{
+	return spi_nand_page_op(SPI_NAND_OP_LOAD_PAGE, page);
+}
+
+static int spi_nand_read_cache_last(void)
+{
+	struct spi_mem_op op;
+
+	zeromem(&op, sizeof(struct spi_mem_op));
+	op.cmd.opcode = SPI_NAND_OP_READ_CACHE_LAST;
+	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+
+	return spi_mem_exec_op(&op);
+}
+
 static int spi_nand_read_from_cache(unsigned int page, unsigned int offset,
 				    uint8_t *buffer, unsigned int len)
 {
@@ -230,6 +284,66 @@ static int spi_nand_read_page(unsigned int page, unsigned int offset,
 	return 0;
 }
 
+/*
+ * Stream nb_pages consecutive pages: READ PAGE CACHE RANDOM moves the page
+ * previously loaded to the cache and starts the array read of the next one,
+ * READ PAGE CACHE LAST terminates the sequence with the last page.
+ */
+static int spi_nand_read_pages(unsigned int page, unsigned int nb_pages,
+			       uint8_t *buffer)
+{
+	unsigned int len = spinand_dev.nand_dev->page_size;
+	unsigned int i;
+	uint8_t status;
+	int ret;
+
+	ret = spi_nand_ecc_enable(true);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = spi_nand_load_page(page);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = spi_nand_wait_ready(&status);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < nb_pages; i++) {
+		if (i == (nb_pages - 1U)) {
+			ret = spi_nand_read_cache_last();
+		} else {
+			ret = spi_nand_page_op(SPI_NAND_OP_READ_CACHE_RANDOM,
+					       page + i + 1U);
+		}
+
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = spi_nand_wait_ready(&status);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = spi_nand_read_from_cache(page + i, 0U, buffer, len);
+		if (ret != 0) {
+			return ret;
+		}
+
+		if ((status & SPI_NAND_STATUS_ECC_UNCOR) != 0U) {
+			return -EBADMSG;
+		}
+
+		buffer += len;
+	}
+
+	return 0;
+}
+
 static int spi_nand_mtd_block_is_bad(unsigned int block)
 {
 	unsigned int nbpages_per_block = spinand_dev.nand_dev->block_size /
@@ -260,6 +374,12 @@ static int spi_nand_mtd_read_page(struct nand_device *nand, unsigned int page,
 				  spinand_dev.nand_dev->page_size, true);
 }
 
+static int spi_nand_mtd_read_pages(struct nand_device *nand, unsigned int page,
+				   unsigned int nb_pages, uintptr_t buffer)
+{
+	return spi_nand_read_pages(page, nb_pages, (uint8_t *)buffer);
+}
+
 int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 {
 	uint8_t id[SPI_NAND_MAX_ID_LEN];
@@ -272,7 +392,9 @@ int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 
 	spinand_dev.nand_dev->mtd_block_is_bad = spi_nand_mtd_block_is_bad;
 	spinand_dev.nand_dev->mtd_read_page = spi_nand_mtd_read_page;
+	spinand_dev.nand_dev->mtd_read_pages = NULL;
 	spinand_dev.nand_dev->nb_planes = 1;
+	spinand_dev.read_cache = false;
 
 	spinand_dev.spi_read_cache_op.cmd.opcode = SPI_NAND_OP_READ_FROM_CACHE;
 	spinand_dev.spi_read_cache_op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
@@ -290,6 +412,10 @@ int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 	       (spinand_dev.nand_dev->block_size != 0U) &&
 	       (spinand_dev.nand_dev->size != 0U));
 
+	if (spinand_dev.read_cache) {
+		spinand_dev.nand_dev->mtd_read_pages = spi_nand_mtd_read_pages;
+	}
+
 	ret = spi_nand_reset();
 	if (ret != 0) {
 		return ret;
@@ -310,6 +436,8 @@ int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 		return ret;
 	}
 
+	spi_nand_select_quad_io(id[1]);
+
 	VERBOSE("SPI_NAND Detected ID 0x%x\n", id[1]);
 
 	VERBOSE("Page size %i, Block size %i, size %lli\n",
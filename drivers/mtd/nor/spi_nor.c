@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2019-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include <common/debug.h>
@@ -27,6 +28,109 @@
 
 #define SPI_READY_TIMEOUT_US	40000U
 
+/* Longest register access, in bytes per device */
+#define SPI_NOR_REG_MAX_LEN	2U
+/* Longest SFDP read, in bytes per device */
+#define SFDP_READ_MAX_LEN	64U
+
+/* Serial Flash Discoverable Parameters (JESD216) */
+#define SFDP_SIGNATURE		0x50444653U	/* "SFDP" */
+#define SFDP_BFPT_ID		0xFF00U		/* Basic Flash Parameter Table */
+#define SFDP_4BAIT_ID		0xFF84U		/* 4-byte Address Instruction */
+#define SFDP_MAX_PARAM_HEADERS	8U
+#define SFDP_BFPT_MIN_DWORDS	9U
+#define SFDP_DUMMY_CLOCKS	8U
+
+#define BFPT_DWORD1_ADDR_MASK	GENMASK_32(18, 17)
+#define BFPT_DWORD1_ADDR_3	0U
+#define BFPT_DWORD1_ADDR_4	BIT(18)
+#define BFPT_DWORD1_FAST_1_1_2	BIT(16)
+#define BFPT_DWORD1_FAST_1_2_2	BIT(20)
+#define BFPT_DWORD1_FAST_1_4_4	BIT(21)
+#define BFPT_DWORD1_FAST_1_1_4	BIT(22)
+#define BFPT_DWORD2_DENSITY_4G	BIT(31)
+
+/* Fast read settings, in a half of a BFPT DWORD */
+#define BFPT_READ_WAIT_MASK	GENMASK_32(4, 0)
+#define BFPT_READ_MODE_MASK	GENMASK_32(7, 5)
+#define BFPT_READ_MODE_SHIFT	5
+#define BFPT_READ_OPCODE_SHIFT	8
+
+struct sfdp_header {
+	uint32_t signature;
+	uint8_t minor;
+	uint8_t major;
+	uint8_t nph;		/* Number of parameter headers, minus one */
+	uint8_t unused;
+};
+
+struct sfdp_param_header {
+	uint8_t id_lsb;
+	uint8_t minor;
+	uint8_t major;
+	uint8_t length;		/* In DWORDs */
+	uint8_t ptp[3];		/* Parameter table pointer */
+	uint8_t id_msb;
+};
+
+/*
+ * Read operation described in the SFDP tables, fastest first.
+ * @addr_width: lines of the address and dummy phases
+ * @data_width: lines of the data phase
+ * @bfpt_support: support bit in BFPT DWORD1, 0 if always supported
+ * @bfpt_dword: BFPT DWORD index of the settings, 0 for the fixed ones
+ * @bfpt_shift: offset of the settings in the DWORD
+ * @bait_support: support bit of the 4-byte address opcode in the 4BAIT
+ * @opcode_4b: 4-byte address opcode
+ */
+struct spi_nor_read_mode {
+	uint8_t addr_width;
+	uint8_t data_width;
+	uint32_t bfpt_support;
+	uint8_t bfpt_dword;
+	uint8_t bfpt_shift;
+	uint32_t bait_support;
+	uint8_t opcode_4b;
+};
+
+static const struct spi_nor_read_mode spi_nor_read_modes[] = {
+	{
+		.addr_width = 4U, .data_width = 4U,
+		.bfpt_support = BFPT_DWORD1_FAST_1_4_4,
+		.bfpt_dword = 2U, .bfpt_shift = 0U,
+		.bait_support = BIT(5),
+		.opcode_4b = SPI_NOR_OP_READ_1_4_4_4B,
+	},
+	{
+		.addr_width = 1U, .data_width = 4U,
+		.bfpt_support = BFPT_DWORD1_FAST_1_1_4,
+		.bfpt_dword = 2U, .bfpt_shift = 16U,
+		.bait_support = BIT(4),
+		.opcode_4b = SPI_NOR_OP_READ_1_1_4_4B,
+	},
+	{
+		.addr_width = 2U, .data_width = 2U,
+		.bfpt_support = BFPT_DWORD1_FAST_1_2_2,
+		.bfpt_dword = 3U, .bfpt_shift = 16U,
+		.bait_support = BIT(3),
+		.opcode_4b = SPI_NOR_OP_READ_1_2_2_4B,
+	},
+	{
+		.addr_width = 1U, .data_width = 2U,
+		.bfpt_support = BFPT_DWORD1_FAST_1_1_2,
+		.bfpt_dword = 3U, .bfpt_shift = 0U,
+		.bait_support = BIT(2),
+		.opcode_4b = SPI_NOR_OP_READ_1_1_2_4B,
+	},
+	{
+		.addr_width = 1U, .data_width = 1U,
+		.bfpt_support = 0U,
+		.bfpt_dword = 0U, .bfpt_shift = 0U,
+		.bait_support = BIT(1),
+		.opcode_4b = SPI_NOR_OP_READ_FAST_4B,
+	},
+};
+
 static struct nor_device nor_dev;
 
 #pragma weak plat_get_nor_data
@@ -35,10 +139,31 @@ int plat_get_nor_data(struct nor_device *device)
 	return 0;
 }
 
-static int spi_nor_reg(uint8_t reg, uint8_t *buf, size_t len,
-		       enum spi_mem_data_dir dir)
+static inline bool spi_nor_is_dual_flash(void)
 {
+	return (nor_dev.flags & SPI_NOR_DUAL_FLASH) != 0U;
+}
+
+/* Bank register span, in the address space seen by the reads */
+static inline uint32_t spi_nor_bank_size(void)
+{
+	return spi_nor_is_dual_flash() ? 2U * BANK_SIZE : BANK_SIZE;
+}
+
+/*
+ * In dual flash mode, the devices get the same commands and their data
+ * bytes are interleaved, the first device on the even ones. A written
+ * register byte is sent to both devices, a read one is the AND of the two
+ * values, or the OR with @any_device, so that a status bit is reported as
+ * set when it is set on all the devices, or on any of them.
+ */
+static int spi_nor_reg_merge(uint8_t reg, uint8_t *buf, size_t len,
+			     enum spi_mem_data_dir dir, bool any_device)
+{
+	uint8_t dual_buf[2U * SPI_NOR_REG_MAX_LEN];
 	struct spi_mem_op op;
+	unsigned int i;
+	int ret;
 
 	zeromem(&op, sizeof(struct spi_mem_op));
 	op.cmd.opcode = reg;
@@ -48,7 +173,42 @@ static int spi_nor_reg(uint8_t reg, uint8_t *buf, size_t len,
 	op.data.nbytes = len;
 	op.data.buf = buf;
 
-	return spi_mem_exec_op(&op);
+	if (!spi_nor_is_dual_flash() || (len == 0U)) {
+		return spi_mem_exec_op(&op);
+	}
+
+	assert(len <= SPI_NOR_REG_MAX_LEN);
+
+	if (dir == SPI_MEM_DATA_OUT) {
+		for (i = 0U; i < len; i++) {
+			dual_buf[2U * i] = buf[i];
+			dual_buf[(2U * i) + 1U] = buf[i];
+		}
+	}
+
+	op.data.nbytes = 2U * len;
+	op.data.buf = dual_buf;
+
+	ret = spi_mem_exec_op(&op);
+	if ((ret != 0) || (dir == SPI_MEM_DATA_OUT)) {
+		return ret;
+	}
+
+	for (i = 0U; i < len; i++) {
+		if (any_device) {
+			buf[i] = dual_buf[2U * i] | dual_buf[(2U * i) + 1U];
+		} else {
+			buf[i] = dual_buf[2U * i] & dual_buf[(2U * i) + 1U];
+		}
+	}
+
+	return 0;
+}
+
+static int spi_nor_reg(uint8_t reg, uint8_t *buf, size_t len,
+		       enum spi_mem_data_dir dir)
+{
+	return spi_nor_reg_merge(reg, buf, len, dir, false);
 }
 
 static inline int spi_nor_read_id(uint8_t *id)
@@ -86,7 +246,9 @@ static int spi_nor_ready(void)
 	uint8_t sr;
 	int ret;
 
-	ret = spi_nor_read_sr(&sr);
+	/* Busy until the write is completed on all the devices */
+	ret = spi_nor_reg_merge(SPI_NOR_OP_READ_SR, &sr, 1U, SPI_MEM_DATA_IN,
+				true);
 	if (ret != 0) {
 		return ret;
 	}
@@ -235,7 +397,7 @@ static int spi_nor_clean_bar(void)
 
 static int spi_nor_write_bar(uint32_t offset)
 {
-	uint8_t selected_bank = offset / BANK_SIZE;
+	uint8_t selected_bank = offset / spi_nor_bank_size();
 	int ret;
 
 	if (selected_bank == nor_dev.selected_bank) {
@@ -274,8 +436,221 @@ static int spi_nor_read_bar(void)
 	return 0;
 }
 
-int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
-		 size_t *length_read)
+/*
+ * In dual flash mode, the tables are read from both devices, at the doubled
+ * address, and the ones of the first device are kept.
+ */
+static int spi_nor_read_sfdp(uint32_t addr, void *buf, size_t len)
+{
+	uint8_t dual_buf[2U * SFDP_READ_MAX_LEN];
+	struct spi_mem_op op;
+	unsigned int i;
+	int ret;
+
+	zeromem(&op, sizeof(struct spi_mem_op));
+	op.cmd.opcode = SPI_NOR_OP_READ_SFDP;
+	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.addr.nbytes = 3U;
+	op.addr.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.addr.val = addr;
+	op.dummy.nbytes = 1U;
+	op.dummy.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.dir = SPI_MEM_DATA_IN;
+	op.data.nbytes = len;
+	op.data.buf = buf;
+
+	if (!spi_nor_is_dual_flash()) {
+		return spi_mem_exec_op(&op);
+	}
+
+	assert(len <= SFDP_READ_MAX_LEN);
+
+	op.addr.val = 2U * addr;
+	op.data.nbytes = 2U * len;
+	op.data.buf = dual_buf;
+
+	ret = spi_mem_exec_op(&op);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < len; i++) {
+		((uint8_t *)buf)[i] = dual_buf[2U * i];
+	}
+
+	return 0;
+}
+
+static uint32_t sfdp_param_addr(const struct sfdp_param_header *header)
+{
+	return ((uint32_t)header->ptp[2] << 16) |
+	       ((uint32_t)header->ptp[1] << 8) | header->ptp[0];
+}
+
+/*
+ * Fill the read operation with the mode, if the device and the bus support
+ * it. Return true on success.
+ */
+static bool spi_nor_sfdp_set_read(struct spi_mem_op *op,
+				  const struct spi_nor_read_mode *mode,
+				  const uint32_t *bfpt)
+{
+	unsigned int clocks = SFDP_DUMMY_CLOCKS;
+	uint8_t opcode = SPI_NOR_OP_READ_FAST;
+	struct spi_mem_op read_op;
+
+	if ((bfpt[0] & mode->bfpt_support) != mode->bfpt_support) {
+		return false;
+	}
+
+	if (mode->bfpt_dword != 0U) {
+		uint32_t settings = bfpt[mode->bfpt_dword] >> mode->bfpt_shift;
+
+		opcode = (uint8_t)(settings >> BFPT_READ_OPCODE_SHIFT);
+		clocks = (settings & BFPT_READ_WAIT_MASK) +
+			 ((settings & BFPT_READ_MODE_MASK) >>
+			  BFPT_READ_MODE_SHIFT);
+	}
+
+	/* Mode clocks are sent as dummy, the bus counts whole bytes */
+	if ((opcode == 0U) || (((clocks * mode->addr_width) % 8U) != 0U)) {
+		return false;
+	}
+
+	zeromem(&read_op, sizeof(struct spi_mem_op));
+	read_op.cmd.opcode = opcode;
+	read_op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	read_op.addr.nbytes = 3U;
+	read_op.addr.buswidth = mode->addr_width;
+	read_op.dummy.nbytes = clocks * mode->addr_width / 8U;
+	read_op.dummy.buswidth = mode->addr_width;
+	read_op.data.buswidth = mode->data_width;
+	read_op.data.dir = SPI_MEM_DATA_IN;
+	read_op.data.nbytes = 1U;
+
+	if (!spi_mem_supports_op(&read_op)) {
+		return false;
+	}
+
+	read_op.data.nbytes = 0U;
+	*op = read_op;
+
+	return true;
+}
+
+/*
+ * Select the fastest read operation of the device supported by the bus,
+ * from the SFDP tables. Above 16MB, the 4-byte address opcodes are used when
+ * listed in the 4BAIT, so that reads do not switch the bank register.
+ * The read operation set by the platform is kept if the tables are missing.
+ */
+static int spi_nor_parse_sfdp(void)
+{
+	struct sfdp_header header;
+	struct sfdp_param_header params[SFDP_MAX_PARAM_HEADERS];
+	const struct sfdp_param_header *bfpt_header = NULL;
+	const struct sfdp_param_header *bait_header = NULL;
+	uint32_t bfpt[SFDP_BFPT_MIN_DWORDS];
+	uint32_t bait = 0U;
+	unsigned int nph;
+	unsigned int i;
+	int ret;
+
+	ret = spi_nor_read_sfdp(0U, &header, sizeof(header));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (header.signature != SFDP_SIGNATURE) {
+		return -ENOTSUP;
+	}
+
+	nph = MIN((unsigned int)header.nph + 1U, SFDP_MAX_PARAM_HEADERS);
+	ret = spi_nor_read_sfdp(sizeof(header), params,
+				nph * sizeof(struct sfdp_param_header));
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < nph; i++) {
+		uint16_t id = ((uint16_t)params[i].id_msb << 8) |
+			      params[i].id_lsb;
+
+		if ((id == SFDP_BFPT_ID) && (bfpt_header == NULL)) {
+			bfpt_header = &params[i];
+		} else if ((id == SFDP_4BAIT_ID) && (params[i].length != 0U)) {
+			bait_header = &params[i];
+		}
+	}
+
+	if ((bfpt_header == NULL) ||
+	    (bfpt_header->length < SFDP_BFPT_MIN_DWORDS)) {
+		return -ENOTSUP;
+	}
+
+	ret = spi_nor_read_sfdp(sfdp_param_addr(bfpt_header), bfpt,
+				sizeof(bfpt));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (bait_header != NULL) {
+		ret = spi_nor_read_sfdp(sfdp_param_addr(bait_header), &bait,
+					sizeof(bait));
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (nor_dev.size == 0U) {
+		uint32_t density = bfpt[1];
+
+		if ((density & BFPT_DWORD2_DENSITY_4G) != 0U) {
+			return -ENOTSUP;
+		}
+
+		nor_dev.size = (density + 1U) / 8U;
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(spi_nor_read_modes); i++) {
+		const struct spi_nor_read_mode *mode = &spi_nor_read_modes[i];
+		struct spi_mem_op op;
+
+		if ((mode->data_width > nor_dev.read_op.data.buswidth) ||
+		    !spi_nor_sfdp_set_read(&op, mode, bfpt)) {
+			continue;
+		}
+
+		switch (bfpt[0] & BFPT_DWORD1_ADDR_MASK) {
+		case BFPT_DWORD1_ADDR_3:
+			break;
+		case BFPT_DWORD1_ADDR_4:
+			op.addr.nbytes = 4U;
+			break;
+		default:
+			if ((nor_dev.size > BANK_SIZE) &&
+			    ((bait & mode->bait_support) != 0U)) {
+				op.cmd.opcode = mode->opcode_4b;
+				op.addr.nbytes = 4U;
+			}
+			break;
+		}
+
+		nor_dev.read_op = op;
+
+		INFO("SPI NOR read op 0x%x, 1-%u-%u, %u address bytes\n",
+		     op.cmd.opcode, op.addr.buswidth, op.data.buswidth,
+		     op.addr.nbytes);
+
+		return 0;
+	}
+
+	return -ENOTSUP;
+}
+
+static int spi_nor_read_range(unsigned int offset, uintptr_t buffer,
+			      size_t length, size_t *length_read)
 {
 	size_t remain_len;
 	int ret;
@@ -293,8 +668,9 @@ int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
 				return ret;
 			}
 
-			remain_len = (BANK_SIZE * (nor_dev.selected_bank + 1)) -
-				nor_dev.read_op.addr.val;
+			remain_len = (spi_nor_bank_size() *
+				      (nor_dev.selected_bank + 1U)) -
+				     nor_dev.read_op.addr.val;
 			nor_dev.read_op.data.nbytes = MIN(length, remain_len);
 		} else {
 			nor_dev.read_op.data.nbytes = length;
@@ -322,6 +698,94 @@ int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * In dual flash mode, an address is shared by a byte of each device: the
+ * transfers start on even offsets and are made of whole pairs, the partial
+ * pairs at the edges of the range are read into a bounce buffer.
+ */
+int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
+		 size_t *length_read)
+{
+	uint8_t pair[2];
+	size_t body_len;
+	size_t len;
+	int ret;
+
+	if (!spi_nor_is_dual_flash() || (length == 0U)) {
+		return spi_nor_read_range(offset, buffer, length, length_read);
+	}
+
+	*length_read = 0U;
+
+	if ((offset & 1U) != 0U) {
+		ret = spi_nor_read_range(offset - 1U, (uintptr_t)pair,
+					 sizeof(pair), &len);
+		if (ret != 0) {
+			return ret;
+		}
+
+		*(uint8_t *)buffer = pair[1];
+		offset++;
+		buffer++;
+		length--;
+		*length_read = 1U;
+	}
+
+	body_len = length & ~(size_t)1U;
+	if (body_len != 0U) {
+		ret = spi_nor_read_range(offset, buffer, body_len, &len);
+		if (ret != 0) {
+			return ret;
+		}
+
+		*length_read += len;
+	}
+
+	if (length != body_len) {
+		ret = spi_nor_read_range(offset + body_len, (uintptr_t)pair,
+					 sizeof(pair), &len);
+		if (ret != 0) {
+			return ret;
+		}
+
+		*(uint8_t *)(buffer + body_len) = pair[0];
+		*length_read += 1U;
+	}
+
+	return 0;
+}
+
+/*
+ * Map a range of the device in the memory, for reads by a DMA, until
+ * spi_nor_mm_unmap(). The bank register is not switched: with it, only
+ * the first bank can be mapped.
+ */
+int spi_nor_mm_map(unsigned int offset, size_t length, uintptr_t *addr)
+{
+	struct spi_mem_op op = nor_dev.read_op;
+
+	if ((length == 0U) || (offset > nor_dev.size) ||
+	    (length > (nor_dev.size - offset))) {
+		return -EINVAL;
+	}
+
+	if (((nor_dev.flags & SPI_NOR_USE_BANK) != 0U) &&
+	    ((offset + length) > spi_nor_bank_size())) {
+		return -ENOTSUP;
+	}
+
+	op.addr.val = offset;
+	op.data.nbytes = length;
+	op.data.buf = NULL;
+
+	return spi_mem_mm_map(&op, addr);
+}
+
+void spi_nor_mm_unmap(void)
+{
+	spi_mem_mm_unmap();
+}
+
 int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 {
 	int ret;
@@ -339,19 +803,35 @@ int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 		return -EINVAL;
 	}
 
-	assert(nor_dev.size != 0U);
-
-	if (nor_dev.size > BANK_SIZE) {
-		nor_dev.flags |= SPI_NOR_USE_BANK;
+	if (spi_mem_is_dual_flash()) {
+		nor_dev.flags |= SPI_NOR_DUAL_FLASH;
 	}
 
-	*size = nor_dev.size;
-
 	ret = spi_nor_read_id(&id);
 	if (ret != 0) {
 		return ret;
 	}
 
+	if ((nor_dev.flags & SPI_NOR_USE_SFDP) != 0U) {
+		ret = spi_nor_parse_sfdp();
+		if (ret != 0) {
+			WARN("SPI NOR: SFDP not used (%d)\n", ret);
+		}
+	}
+
+	assert(nor_dev.size != 0U);
+
+	if ((nor_dev.size > BANK_SIZE) && (nor_dev.read_op.addr.nbytes != 4U)) {
+		nor_dev.flags |= SPI_NOR_USE_BANK;
+	}
+
+	/* The size of a device is set, the reads address both of them */
+	if (spi_nor_is_dual_flash()) {
+		nor_dev.size *= 2U;
+	}
+
+	*size = nor_dev.size;
+
 	if ((nor_dev.flags & SPI_NOR_USE_BANK) != 0U) {
 		switch (id) {
 		case SPANSION_ID:
@@ -61,7 +61,14 @@ static bool spi_mem_check_buswidth_req(uint8_t buswidth, bool tx)
 	return false;
 }
 
-static bool spi_mem_supports_op(const struct spi_mem_op *op)
+/*
+ * spi_mem_supports_op() - Check the bus widths of an operation against the
+ * ones set for the slave in the device tree.
+ * @op: The memory operation to check.
+ *
+ * Return: true if the operation can be executed, false otherwise.
+ */
+bool spi_mem_supports_op(const struct spi_mem_op *op)
 {
 	if (!spi_mem_check_buswidth_req(op->cmd.buswidth, true)) {
 		return false;
@@ -86,6 +93,17 @@ static bool spi_mem_supports_op(const struct spi_mem_op *op)
 	return true;
 }
 
+/*
+ * spi_mem_is_dual_flash() - Check if two devices are accessed in parallel,
+ * their bytes interleaved on the bus, the first device on the even bytes.
+ *
+ * Return: true in dual flash mode, false otherwise.
+ */
+bool spi_mem_is_dual_flash(void)
+{
+	return (spi_slave.mode & SPI_DUAL_FLASH) != 0U;
+}
+
 static int spi_mem_set_speed_mode(void)
 {
 	const struct spi_bus_ops *ops = spi_slave.ops;
@@ -175,6 +193,51 @@ int spi_mem_exec_op(const struct spi_mem_op *op)
 	return ret;
 }
 
+/*
+ * spi_mem_mm_map() - Map a read operation in the memory.
+ * @op: The read operation, with the address and size of the range.
+ * @addr: Filled with the address of the range in the memory.
+ *
+ * The bus stays claimed until spi_mem_mm_unmap(), no other operation can be
+ * executed meanwhile.
+ *
+ * Return: 0 in case of success, a negative error code otherwise.
+ */
+int spi_mem_mm_map(const struct spi_mem_op *op, uintptr_t *addr)
+{
+	const struct spi_bus_ops *ops = spi_slave.ops;
+	int ret;
+
+	if ((ops->mm_map == NULL) || (ops->mm_unmap == NULL) ||
+	    !spi_mem_supports_op(op)) {
+		return -ENOTSUP;
+	}
+
+	ret = ops->claim_bus(spi_slave.cs);
+	if (ret != 0) {
+		WARN("Error claim_bus\n");
+		return ret;
+	}
+
+	ret = ops->mm_map(op, addr);
+	if (ret != 0) {
+		ops->release_bus();
+	}
+
+	return ret;
+}
+
+/*
+ * spi_mem_mm_unmap() - Stop the reads mapped by spi_mem_mm_map().
+ */
+void spi_mem_mm_unmap(void)
+{
+	const struct spi_bus_ops *ops = spi_slave.ops;
+
+	ops->mm_unmap();
+	ops->release_bus();
+}
+
 /*
  * spi_mem_init_slave() - SPI slave device initialization.
  * @fdt: Pointer to the device tree blob.
@@ -200,22 +263,35 @@ int spi_mem_init_slave(void *fdt, int bus_node, const struct spi_bus_ops *ops)
 	}
 
 	fdt_for_each_subnode(bus_subnode, fdt, bus_node) {
+		cuint = fdt_getprop(fdt, bus_subnode, "reg", NULL);
+		if ((cuint == NULL) || (fdt32_to_cpu(*cuint) > 1U)) {
+			ERROR("Chip select not well defined\n");
+			return -EINVAL;
+		}
+
 		nchips++;
 	}
 
-	if (nchips != 1) {
-		ERROR("Only one SPI device is currently supported\n");
+	/*
+	 * Two devices, on chip selects 0 and 1, are driven in parallel, with
+	 * the settings of the first one.
+	 */
+	if ((nchips != 1) && (nchips != 2)) {
+		ERROR("Only one SPI device, or two in dual flash mode, are supported\n");
 		return -EINVAL;
 	}
 
 	fdt_for_each_subnode(bus_subnode, fdt, bus_node) {
 		/* Get chip select */
 		cuint = fdt_getprop(fdt, bus_subnode, "reg", NULL);
-		if (cuint == NULL) {
-			ERROR("Chip select not well defined\n");
-			return -EINVAL;
+		if ((nchips == 2) && (fdt32_to_cpu(*cuint) != 0U)) {
+			continue;
 		}
+
 		spi_slave.cs = fdt32_to_cpu(*cuint);
+		if (nchips == 2) {
+			mode |= SPI_DUAL_FLASH;
+		}
 
 		/* Get max slave frequency */
 		spi_slave.max_hz = SPI_MEM_DEFAULT_SPEED_HZ;
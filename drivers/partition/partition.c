@@ -5,20 +5,59 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
 #include <common/debug.h>
+#if GPT_CRC_CHECK
+#include <common/tf_crc32.h>
+#endif
 #include <drivers/io/io_storage.h>
 #include <drivers/partition/efi.h>
 #include <drivers/partition/partition.h>
 #include <drivers/partition/gpt.h>
 #include <drivers/partition/mbr.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
+/* GPT entries read at once, the whole used table for most platforms */
+#if PLAT_PARTITION_MAX_ENTRIES > 16
+#define GPT_ENTRIES_READ_NB		16U
+#else
+#define GPT_ENTRIES_READ_NB		PLAT_PARTITION_MAX_ENTRIES
+#endif
+
+/* Hash index size, a power of 2 at least twice the number of entries */
+#if PLAT_PARTITION_MAX_ENTRIES <= 8
+#define PARTITION_INDEX_SIZE		16U
+#elif PLAT_PARTITION_MAX_ENTRIES <= 16
+#define PARTITION_INDEX_SIZE		32U
+#elif PLAT_PARTITION_MAX_ENTRIES <= 32
+#define PARTITION_INDEX_SIZE		64U
+#elif PLAT_PARTITION_MAX_ENTRIES <= 64
+#define PARTITION_INDEX_SIZE		128U
+#else
+#define PARTITION_INDEX_SIZE		256U
+#endif
+
 static uint8_t mbr_sector[PLAT_PARTITION_BLOCK_SIZE];
 static partition_entry_list_t list;
+static gpt_entry_t gpt_entries[GPT_ENTRIES_READ_NB];
+
+/* Table already loaded for this image ID */
+static bool list_loaded;
+static unsigned int list_image_id;
+
+/*
+ * Open addressing indexes of the entries by name and by unique GUID. A slot
+ * holds the entry index plus one, 0 for a free slot.
+ */
+static uint8_t name_index[PARTITION_INDEX_SIZE];
+static uint8_t uuid_index[PARTITION_INDEX_SIZE];
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
@@ -41,6 +80,56 @@ static void dump_entries(int num)
 #define dump_entries(num)	((void)num)
 #endif
 
+/* FNV-1a */
+static unsigned int partition_hash(const uint8_t *data, size_t len)
+{
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash ^= data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static unsigned int name_hash(const char *name)
+{
+	return partition_hash((const uint8_t *)name,
+			      strnlen(name, EFI_NAMELEN));
+}
+
+static unsigned int uuid_hash(const void *guid)
+{
+	return partition_hash((const uint8_t *)guid, sizeof(struct efi_guid));
+}
+
+static void index_insert(uint8_t *index, unsigned int hash, int entry)
+{
+	unsigned int slot = hash & (PARTITION_INDEX_SIZE - 1U);
+
+	while (index[slot] != 0U) {
+		slot = (slot + 1U) & (PARTITION_INDEX_SIZE - 1U);
+	}
+
+	index[slot] = (uint8_t)(entry + 1);
+}
+
+/* Entries are inserted in table order, the first one matching is found */
+static void build_indexes(void)
+{
+	int i;
+
+	zeromem(name_index, sizeof(name_index));
+	zeromem(uuid_index, sizeof(uuid_index));
+
+	for (i = 0; i < list.entry_count; i++) {
+		index_insert(name_index, name_hash(list.list[i].name), i);
+		index_insert(uuid_index, uuid_hash(&list.list[i].part_guid), i);
+	}
+}
+
 /*
  * Load the first sector that carries MBR header.
  * The MBR boot signature should be always valid whether it's MBR or GPT.
@@ -76,12 +165,11 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 }
 
 /*
- * Load GPT header and check the GPT signature.
+ * Load GPT header and check the GPT signature, and its CRC with GPT_CRC_CHECK.
  * If partition numbers could be found, check & update it.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
 	int result;
 
@@ -89,18 +177,37 @@ static int load_gpt_header(uintptr_t image_handle)
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
+	result = io_read(image_handle, (uintptr_t)&mbr_sector,
+			 PLAT_PARTITION_BLOCK_SIZE, &bytes_read);
+	if (result != 0) {
 		return result;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+	if (bytes_read != PLAT_PARTITION_BLOCK_SIZE) {
+		return -EINVAL;
+	}
+	memcpy(header, mbr_sector, sizeof(gpt_header_t));
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
+	}
+	if ((header->size < sizeof(gpt_header_t)) ||
+	    (header->size > PLAT_PARTITION_BLOCK_SIZE) ||
+	    (header->part_size != sizeof(gpt_entry_t))) {
 		return -EINVAL;
 	}
 
+#if GPT_CRC_CHECK
+	/* The header CRC is computed with its own field cleared */
+	zeromem(&mbr_sector[offsetof(gpt_header_t, header_crc)],
+		sizeof(header->header_crc));
+	if (tf_crc32(0U, mbr_sector, header->size) != header->header_crc) {
+		WARN("GPT header CRC error\n");
+		return -EINVAL;
+	}
+#endif
+
 	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
+	list.entry_count = header->list_num;
 	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
 		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
 	}
@@ -158,32 +265,59 @@ static int load_mbr_entries(uintptr_t image_handle)
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the entries by GPT_ENTRIES_READ_NB. The entries after the ones used
+ * are only read to check the CRC32 of the whole array with GPT_CRC_CHECK.
+ */
+static int verify_partition_gpt(uintptr_t image_handle,
+				const gpt_header_t *header)
 {
-	size_t bytes_read;
-	int result;
+	unsigned int nb_read = 0U;
+	unsigned int nb_entries = (unsigned int)list.entry_count;
+	int i = list.entry_count;
+#if GPT_CRC_CHECK
+	uint32_t crc = 0U;
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
-		return -EINVAL;
-	return result;
-}
+	nb_entries = header->list_num;
+#endif
 
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
+	while (nb_read < nb_entries) {
+		unsigned int nb = MIN(nb_entries - nb_read,
+				      GPT_ENTRIES_READ_NB);
+		size_t bytes_read;
+		unsigned int j;
+		int result;
+
+		result = io_read(image_handle, (uintptr_t)&gpt_entries,
+				 nb * sizeof(gpt_entry_t), &bytes_read);
+		if ((result != 0) ||
+		    (bytes_read != (nb * sizeof(gpt_entry_t)))) {
+			return -EINVAL;
+		}
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
+#if GPT_CRC_CHECK
+		crc = tf_crc32(crc, (const unsigned char *)&gpt_entries,
+			       bytes_read);
+#endif
+
+		for (j = 0U; (j < nb) && ((int)(nb_read + j) < i); j++) {
+			result = parse_gpt_entry(&gpt_entries[j],
+						 &list.list[nb_read + j]);
+			if (result != 0) {
+				i = (int)(nb_read + j);
+			}
 		}
+
+		nb_read += nb;
 	}
+
+#if GPT_CRC_CHECK
+	if (crc != header->part_crc) {
+		WARN("GPT entries CRC error\n");
+		return -EINVAL;
+	}
+#endif
+
 	if (i == 0) {
 		return -EINVAL;
 	}
@@ -201,8 +335,13 @@ int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
 	mbr_entry_t mbr_entry;
+	gpt_header_t header;
 	int result;
 
+	if (list_loaded && (list_image_id == image_id)) {
+		return 0;
+	}
+
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
@@ -222,28 +361,47 @@ int load_partition_table(unsigned int image_id)
 		return result;
 	}
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
-		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
-		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = load_gpt_header(image_handle, &header);
+		if (result == 0) {
+			result = io_seek(image_handle, IO_SEEK_SET,
+					 GPT_ENTRY_OFFSET);
+		}
+		if (result == 0) {
+			result = verify_partition_gpt(image_handle, &header);
+		}
 	} else {
 		result = load_mbr_entries(image_handle);
 	}
 
 	io_close(image_handle);
+
+	if (result == 0) {
+		build_indexes();
+		list_image_id = image_id;
+	} else {
+		list.entry_count = 0;
+	}
+	list_loaded = (result == 0);
+
 	return result;
 }
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int slot = name_hash(name) & (PARTITION_INDEX_SIZE - 1U);
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	while (name_index[slot] != 0U) {
+		const partition_entry_t *entry;
+
+		entry = &list.list[name_index[slot] - 1U];
+
+		if (strcmp(name, entry->name) == 0) {
+			return entry;
 		}
+
+		slot = (slot + 1U) & (PARTITION_INDEX_SIZE - 1U);
 	}
+
 	return NULL;
 }
 
@@ -262,12 +420,18 @@ const partition_entry_t *get_partition_entry_by_type(const uuid_t *type_uuid)
 
 const partition_entry_t *get_partition_entry_by_uuid(const uuid_t *part_uuid)
 {
-	int i;
+	unsigned int slot = uuid_hash(part_uuid) & (PARTITION_INDEX_SIZE - 1U);
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (guidcmp(part_uuid, &list.list[i].part_guid) == 0) {
-			return &list.list[i];
+	while (uuid_index[slot] != 0U) {
+		const partition_entry_t *entry;
+
+		entry = &list.list[uuid_index[slot] - 1U];
+
+		if (guidcmp(part_uuid, &entry->part_guid) == 0) {
+			return entry;
 		}
+
+		slot = (slot + 1U) & (PARTITION_INDEX_SIZE - 1U);
 	}
 
 	return NULL;
@@ -15,11 +15,21 @@
 #include <common/debug.h>
 #include <drivers/delay_timer.h>
 #include <drivers/regulator.h>
+#include <lib/utils_def.h>
 
 #define MAX_PROPERTY_LEN 64
 
+/* rdev cache_flags */
+#define CACHE_MV_VALID		BIT(0)
+#define CACHE_STATE_VALID	BIT(1)
+
 static struct rdev rdev_array[PLAT_NB_RDEVS];
 
+#if defined(IMAGE_BL32)
+static unsigned int batch_depth;
+static uint32_t batch_ramp_delay;
+#endif
+
 #pragma weak plat_get_lp_mode_name
 const char *plat_get_lp_mode_name(int mode)
 {
@@ -125,11 +135,38 @@ struct rdev *regulator_get_by_supply_name(const void *fdt, int node, const char
 
 static int __regulator_set_state(struct rdev *rdev, bool state)
 {
+	int ret;
+
 	if (rdev->desc->ops->set_state == NULL) {
 		return -ENODEV;
 	}
 
-	return rdev->desc->ops->set_state(rdev->desc, state);
+	ret = rdev->desc->ops->set_state(rdev->desc, state);
+	if (ret == 0) {
+		rdev->cached_state = state;
+		rdev->cache_flags |= CACHE_STATE_VALID;
+	} else {
+		rdev->cache_flags &= ~CACHE_STATE_VALID;
+	}
+
+	return ret;
+}
+
+/*
+ * Wait for the regulator output to be stable after an enable. Within a batch,
+ * the longest delay is waited for once, on commit.
+ */
+static void regulator_ramp_delay(const struct rdev *rdev)
+{
+#if defined(IMAGE_BL32)
+	if (batch_depth != 0U) {
+		batch_ramp_delay = MAX(batch_ramp_delay,
+				       rdev->enable_ramp_delay);
+		return;
+	}
+#endif
+
+	udelay(rdev->enable_ramp_delay);
 }
 
 #if defined(IMAGE_BL32)
@@ -165,7 +202,7 @@ static int __regulator_enable(struct rdev *rdev)
 			return ret;
 		}
 
-		udelay(rdev->enable_ramp_delay);
+		regulator_ramp_delay(rdev);
 	}
 
 	rdev->use_count++;
@@ -274,7 +311,7 @@ int regulator_enable(struct rdev *rdev)
 
 	ret = __regulator_set_state(rdev, STATE_ENABLE);
 
-	udelay(rdev->enable_ramp_delay);
+	regulator_ramp_delay(rdev);
 
 	return ret;
 }
@@ -297,7 +334,7 @@ int regulator_disable(struct rdev *rdev)
 
 	ret = __regulator_set_state(rdev, STATE_DISABLE);
 
-	udelay(rdev->enable_ramp_delay);
+	regulator_ramp_delay(rdev);
 
 	return ret;
 }
@@ -309,7 +346,7 @@ int regulator_disable(struct rdev *rdev)
  * @rdev - pointer to rdev struct
  * Return 0 if disabled, 1 if enabled, <0 else.
  */
-int regulator_is_enabled(const struct rdev *rdev)
+int regulator_is_enabled(struct rdev *rdev)
 {
 	int ret = 0;
 
@@ -317,6 +354,10 @@ int regulator_is_enabled(const struct rdev *rdev)
 
 	VERBOSE("%s: is en\n", rdev->desc->node_name);
 
+	if ((rdev->cache_flags & CACHE_STATE_VALID) != 0U) {
+		return rdev->cached_state ? 1 : 0;
+	}
+
 	if (rdev->desc->ops->get_state == NULL) {
 		return -ENODEV;
 	}
@@ -327,6 +368,9 @@ int regulator_is_enabled(const struct rdev *rdev)
 	if (ret < 0) {
 		ERROR("regul %s get state failed: err:%d\n",
 		      rdev->desc->node_name, ret);
+	} else {
+		rdev->cached_state = (ret != 0);
+		rdev->cache_flags |= CACHE_STATE_VALID;
 	}
 
 	unlock_driver(rdev);
@@ -357,12 +401,21 @@ int regulator_set_voltage(struct rdev *rdev, uint16_t mvolt)
 		return -EPERM;
 	}
 
+	if (((rdev->cache_flags & CACHE_MV_VALID) != 0U) &&
+	    (rdev->cached_mv == mvolt)) {
+		return 0;
+	}
+
 	lock_driver(rdev);
 
 	ret = rdev->desc->ops->set_voltage(rdev->desc, mvolt);
 	if (ret < 0) {
 		ERROR("regul %s set volt failed: err:%d\n",
 		      rdev->desc->node_name, ret);
+		rdev->cache_flags &= ~CACHE_MV_VALID;
+	} else {
+		rdev->cached_mv = mvolt;
+		rdev->cache_flags |= CACHE_MV_VALID;
 	}
 
 	unlock_driver(rdev);
@@ -387,7 +440,7 @@ int regulator_set_min_voltage(struct rdev *rdev)
  * @rdev - pointer to rdev struct
  * Return milli volts if succeed, <0 else.
  */
-int regulator_get_voltage(const struct rdev *rdev)
+int regulator_get_voltage(struct rdev *rdev)
 {
 	int ret = 0;
 
@@ -399,12 +452,19 @@ int regulator_get_voltage(const struct rdev *rdev)
 		return rdev->min_mv;
 	}
 
+	if ((rdev->cache_flags & CACHE_MV_VALID) != 0U) {
+		return rdev->cached_mv;
+	}
+
 	lock_driver(rdev);
 
 	ret = rdev->desc->ops->get_voltage(rdev->desc);
 	if (ret < 0) {
 		ERROR("regul %s get voltage failed: err:%d\n",
 		      rdev->desc->node_name, ret);
+	} else if (ret > 0) {
+		rdev->cached_mv = (uint16_t)ret;
+		rdev->cache_flags |= CACHE_MV_VALID;
 	}
 
 	unlock_driver(rdev);
@@ -537,6 +597,9 @@ int regulator_set_flag(struct rdev *rdev, uint16_t flag)
 
 	lock_driver(rdev);
 
+	/* Bypass or sink modes change the output: read it again */
+	rdev->cache_flags = 0U;
+
 	ret = rdev->desc->ops->set_flag(rdev->desc, flag);
 
 	unlock_driver(rdev);
@@ -899,6 +962,109 @@ static int resume_regulator(struct rdev *rdev)
 	return ret;
 }
 
+/*
+ * Return true if an rdev registered before this one has the same driver ops,
+ * so that the batch callbacks are called once per driver.
+ */
+static bool batch_ops_already_called(const struct rdev *rdev)
+{
+	const struct rdev *prev;
+
+	for (prev = rdev_array; prev < rdev; prev++) {
+		if (prev->desc->ops == rdev->desc->ops) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Start a batch of regulator changes
+ *
+ * Return 0 if succeed, non 0 else.
+ */
+int regulator_core_batch_start(void)
+{
+	struct rdev *rdev;
+
+	batch_depth++;
+	if (batch_depth > 1U) {
+		return 0;
+	}
+
+	batch_ramp_delay = 0U;
+
+	for_each_registered_rdev(rdev) {
+		int ret;
+
+		if ((rdev->desc->ops->batch_start == NULL) ||
+		    batch_ops_already_called(rdev)) {
+			continue;
+		}
+
+		lock_driver(rdev);
+		ret = rdev->desc->ops->batch_start(rdev->desc);
+		unlock_driver(rdev);
+		if (ret != 0) {
+			ERROR("%s failed to start batch: %d\n",
+			      rdev->desc->node_name, ret);
+			batch_depth--;
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Apply the regulator changes of a batch, then wait for the longest enable
+ * ramp delay of the regulators enabled in the batch.
+ *
+ * Return 0 if succeed, non 0 else.
+ */
+int regulator_core_batch_commit(void)
+{
+	struct rdev *rdev;
+	int ret = 0;
+
+	assert(batch_depth != 0U);
+
+	batch_depth--;
+	if (batch_depth != 0U) {
+		return 0;
+	}
+
+	for_each_registered_rdev(rdev) {
+		int status;
+
+		if ((rdev->desc->ops->batch_commit == NULL) ||
+		    batch_ops_already_called(rdev)) {
+			continue;
+		}
+
+		lock_driver(rdev);
+		status = rdev->desc->ops->batch_commit(rdev->desc);
+		unlock_driver(rdev);
+		if (status != 0) {
+			ERROR("%s failed to commit batch: %d\n",
+			      rdev->desc->node_name, status);
+			ret = status;
+		}
+	}
+
+	if (ret != 0) {
+		/* Some changes may not have been applied */
+		for_each_registered_rdev(rdev) {
+			rdev->cache_flags = 0U;
+		}
+	}
+
+	udelay(batch_ramp_delay);
+
+	return ret;
+}
+
 /*
  * Suspend regulators before entering low power
  *
@@ -914,6 +1080,10 @@ int regulator_core_suspend(int mode)
 		return -EINVAL;
 	}
 
+	if (regulator_core_batch_start() != 0) {
+		panic();
+	}
+
 	/* Suspend each regulator */
 	for_each_registered_rdev(rdev) {
 		if (suspend_regulator(rdev, mode) != 0) {
@@ -921,6 +1091,10 @@ int regulator_core_suspend(int mode)
 		}
 	}
 
+	if (regulator_core_batch_commit() != 0) {
+		panic();
+	}
+
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 	regulator_core_dump();
 #endif
@@ -936,12 +1110,33 @@ int regulator_core_suspend(int mode)
 int regulator_core_resume(void)
 {
 	struct rdev *rdev;
+	bool boot_on = false;
 
 	VERBOSE("Regulator core resume\n");
 
-	/* Resume each regulator */
+	/* The regulators may have been changed while in low power */
 	for_each_registered_rdev(rdev) {
-		if (resume_regulator(rdev) != 0) {
+		rdev->cache_flags = 0U;
+
+		if ((rdev->flags & REGUL_BOOT_ON) != 0U) {
+			boot_on = true;
+		}
+	}
+
+	/* Only regulators needed in low power are changed on resume */
+	if (boot_on) {
+		if (regulator_core_batch_start() != 0) {
+			panic();
+		}
+
+		/* Resume each regulator */
+		for_each_registered_rdev(rdev) {
+			if (resume_regulator(rdev) != 0) {
+				panic();
+			}
+		}
+
+		if (regulator_core_batch_commit() != 0) {
 			panic();
 		}
 	}
@@ -989,6 +1184,7 @@ void regulator_core_restore_context(void *backup_area, size_t backup_size)
 
 	for_each_rdev(rdev) {
 		rdev->use_count = *data;
+		rdev->cache_flags = 0U;
 		data++;
 	}
 }
@@ -239,6 +239,26 @@ static void scmi_clock_round_rate_get(struct scmi_msg *msg)
 	scmi_write_response(msg, &return_values, sizeof(return_values));
 }
 
+/* Complete an asynchronous rate change, input arguments already checked */
+static void scmi_clock_rate_set_complete(struct scmi_msg *msg)
+{
+	const struct scmi_clock_rate_set_a2p *in_args = (void *)msg->in;
+	struct scmi_clock_rate_set_complete_p2a return_values = {
+		.clock_id = in_args->clock_id,
+		.rate = { in_args->rate[0], in_args->rate[1] },
+	};
+	unsigned long rate = 0U;
+
+	rate = (unsigned long)(((uint64_t)in_args->rate[1] << 32) |
+			       in_args->rate[0]);
+
+	return_values.status = plat_scmi_clock_set_rate(msg->agent_id,
+							in_args->clock_id,
+							rate);
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
 static void scmi_clock_rate_set(struct scmi_msg *msg)
 {
 	const struct scmi_clock_rate_set_a2p *in_args = (void *)msg->in;
@@ -258,6 +278,20 @@ static void scmi_clock_rate_set(struct scmi_msg *msg)
 		return;
 	}
 
+	/* Rate is changed synchronously if it cannot be deferred */
+	if ((in_args->flags & SCMI_CLOCK_RATE_SET_ASYNC_MASK) != 0U) {
+		bool respond = (in_args->flags &
+				SCMI_CLOCK_RATE_SET_NO_DELAYED_RESPONSE_MASK) == 0U;
+
+		status = scmi_delayed_response_queue(msg,
+						     scmi_clock_rate_set_complete,
+						     respond);
+		if (status != SCMI_NOT_SUPPORTED) {
+			scmi_status_response(msg, status);
+			return;
+		}
+	}
+
 	rate = (unsigned long)(((uint64_t)in_args->rate[1] << 32) |
 			       in_args->rate[0]);
 
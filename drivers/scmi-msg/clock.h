@@ -101,6 +101,12 @@ struct scmi_clock_rate_set_p2a {
 	int32_t status;
 };
 
+struct scmi_clock_rate_set_complete_p2a {
+	int32_t status;
+	uint32_t clock_id;
+	uint32_t rate[2];
+};
+
 /*
  * Clock Config Set
  */
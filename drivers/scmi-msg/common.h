@@ -13,8 +13,10 @@
 
 #include "base.h"
 #include "clock.h"
+#include "perf.h"
 #include "power_domain.h"
 #include "reset_domain.h"
+#include "sensor.h"
 
 #define SCMI_VERSION			0x20000U
 #define SCMI_IMPL_VERSION		0U
@@ -67,6 +69,7 @@ struct scmi_protocol_message_attributes_p2a {
  * @agent_id: SCMI agent ID, safely set from secure world
  * @protocol_id: SCMI protocol ID for the related message, set by caller agent
  * @message_id: SCMI message ID for the related message, set by caller agent
+ * @token: Sequence token of the message, set by caller agent
  * @in: Address of the incoming message payload copied in secure memory
  * @in_size: Byte length of the incoming message payload, set by caller agent
  * @out: Address of of the output message payload message in non-secure memory
@@ -77,6 +80,7 @@ struct scmi_msg {
 	unsigned int agent_id;
 	unsigned int protocol_id;
 	unsigned int message_id;
+	unsigned int token;
 	char *in;
 	size_t in_size;
 	char *out;
@@ -104,6 +108,13 @@ scmi_msg_handler_t scmi_msg_get_base_handler(struct scmi_msg *msg);
  */
 scmi_msg_handler_t scmi_msg_get_clock_handler(struct scmi_msg *msg);
 
+/*
+ * scmi_msg_get_perf_handler - Return a handler for a performance domain message
+ * @msg - message to process
+ * Return a function handler for the message or NULL
+ */
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg);
+
 /*
  * scmi_msg_get_rstd_handler - Return a handler for a reset domain message
  * @msg - message to process
@@ -111,6 +122,13 @@ scmi_msg_handler_t scmi_msg_get_clock_handler(struct scmi_msg *msg);
  */
 scmi_msg_handler_t scmi_msg_get_rstd_handler(struct scmi_msg *msg);
 
+/*
+ * scmi_msg_get_sensor_handler - Return a handler for a sensor message
+ * @msg - message to process
+ * Return a function handler for the message or NULL
+ */
+scmi_msg_handler_t scmi_msg_get_sensor_handler(struct scmi_msg *msg);
+
 /*
  * scmi_msg_get_pd_handler - Return a handler for a power domain message
  * @msg - message to process
@@ -141,4 +159,40 @@ void scmi_write_response(struct scmi_msg *msg, void *payload, size_t size);
  * @status: SCMI status value returned to caller
  */
 void scmi_status_response(struct scmi_msg *msg, int32_t status);
+
+/*
+ * Defer the processing of an asynchronous SCMI message
+ *
+ * The input payload is saved and @handler is later called with it from
+ * scmi_delayed_response_process(). The response written by @handler is
+ * posted to the agent as the delayed response of the message.
+ *
+ * @msg: SCMI message context
+ * @handler: Handler completing the operation
+ * @respond: False if the agent does not expect a delayed response
+ * Return SCMI_SUCCESS when deferred, SCMI_NOT_SUPPORTED when the message
+ * shall be processed synchronously or SCMI_BUSY if no slot is available
+ */
+int32_t scmi_delayed_response_queue(struct scmi_msg *msg,
+				    scmi_msg_handler_t handler, bool respond);
+
+/*
+ * Post a delayed response in the agent server-to-agent channel
+ *
+ * @msg: SCMI message context, output buffer holds the response payload
+ * Return 0 on success, a negative errno otherwise
+ */
+int scmi_smt_delayed_response(struct scmi_msg *msg);
+
+#if SCMI_MSG_STATS
+/*
+ * Account the processing time of a message, called while its agent channel
+ * is busy
+ */
+void scmi_msg_stats_update(struct scmi_msg *msg, uint64_t ticks);
+
+/* Account a message dropped as its agent channel was busy */
+void scmi_msg_stats_busy(unsigned int agent_id);
+#endif
+
 #endif /* SCMI_MSG_COMMON_H */
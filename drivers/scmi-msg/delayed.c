@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/scmi-msg.h>
+#include <drivers/scmi.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+
+#include "common.h"
+
+#pragma weak plat_scmi_delayed_response_kick
+#pragma weak plat_scmi_delayed_response_notify
+
+/* Maximum number of deferred messages, all agents included */
+#define SCMI_DELAYED_MSG_MAX		4U
+
+#define DELAYED_MSG_FREE		0U
+#define DELAYED_MSG_PENDING		1U
+#define DELAYED_MSG_RUNNING		2U
+
+/*
+ * struct scmi_delayed_msg - Deferred asynchronous SCMI message
+ *
+ * @state: One of DELAYED_MSG_*
+ * @respond: True if agent expects a delayed response
+ * @handler: Handler completing the operation
+ * @agent_id: SCMI agent ID
+ * @protocol_id: SCMI protocol ID of the message
+ * @message_id: SCMI message ID of the message
+ * @token: Sequence token of the message
+ * @in_size: Byte size of the saved input payload
+ * @in: Saved input payload
+ */
+struct scmi_delayed_msg {
+	unsigned int state;
+	bool respond;
+	scmi_msg_handler_t handler;
+	unsigned int agent_id;
+	unsigned int protocol_id;
+	unsigned int message_id;
+	unsigned int token;
+	size_t in_size;
+	uint32_t in[SCMI_PLAYLOAD_MAX / sizeof(uint32_t)];
+};
+
+static struct scmi_delayed_msg delayed_msg[SCMI_DELAYED_MSG_MAX];
+static struct spinlock delayed_msg_lock;
+
+bool plat_scmi_delayed_response_kick(void)
+{
+	return false;
+}
+
+void plat_scmi_delayed_response_notify(unsigned int agent_id __unused)
+{
+}
+
+int32_t scmi_delayed_response_queue(struct scmi_msg *msg,
+				    scmi_msg_handler_t handler, bool respond)
+{
+	struct scmi_msg_channel *chan = plat_scmi_get_channel(msg->agent_id);
+	struct scmi_delayed_msg *dmsg = NULL;
+	unsigned int n;
+
+	assert(handler != NULL);
+
+	if ((chan == NULL) || (chan->p2a_shm_addr == 0U) ||
+	    (msg->in_size > sizeof(dmsg->in))) {
+		return SCMI_NOT_SUPPORTED;
+	}
+
+	spin_lock(&delayed_msg_lock);
+
+	for (n = 0U; n < ARRAY_SIZE(delayed_msg); n++) {
+		if (delayed_msg[n].state == DELAYED_MSG_FREE) {
+			dmsg = &delayed_msg[n];
+			dmsg->state = DELAYED_MSG_RUNNING;
+			break;
+		}
+	}
+
+	spin_unlock(&delayed_msg_lock);
+
+	if (dmsg == NULL) {
+		return SCMI_BUSY;
+	}
+
+	dmsg->respond = respond;
+	dmsg->handler = handler;
+	dmsg->agent_id = msg->agent_id;
+	dmsg->protocol_id = msg->protocol_id;
+	dmsg->message_id = msg->message_id;
+	dmsg->token = msg->token;
+	dmsg->in_size = msg->in_size;
+	memcpy(dmsg->in, msg->in, msg->in_size);
+
+	spin_lock(&delayed_msg_lock);
+	dmsg->state = DELAYED_MSG_PENDING;
+	spin_unlock(&delayed_msg_lock);
+
+	if (!plat_scmi_delayed_response_kick()) {
+		spin_lock(&delayed_msg_lock);
+		dmsg->state = DELAYED_MSG_FREE;
+		spin_unlock(&delayed_msg_lock);
+
+		return SCMI_NOT_SUPPORTED;
+	}
+
+	return SCMI_SUCCESS;
+}
+
+static struct scmi_delayed_msg *get_pending_msg(void)
+{
+	struct scmi_delayed_msg *dmsg = NULL;
+	unsigned int n;
+
+	spin_lock(&delayed_msg_lock);
+
+	for (n = 0U; n < ARRAY_SIZE(delayed_msg); n++) {
+		if (delayed_msg[n].state == DELAYED_MSG_PENDING) {
+			dmsg = &delayed_msg[n];
+			dmsg->state = DELAYED_MSG_RUNNING;
+			break;
+		}
+	}
+
+	spin_unlock(&delayed_msg_lock);
+
+	return dmsg;
+}
+
+void scmi_delayed_response_process(void)
+{
+	struct scmi_delayed_msg *dmsg;
+
+	for (dmsg = get_pending_msg(); dmsg != NULL;
+	     dmsg = get_pending_msg()) {
+		uint32_t out[SCMI_PLAYLOAD_MAX / sizeof(uint32_t)];
+		struct scmi_msg msg = {
+			.agent_id = dmsg->agent_id,
+			.protocol_id = dmsg->protocol_id,
+			.message_id = dmsg->message_id,
+			.token = dmsg->token,
+			.in = (char *)dmsg->in,
+			.in_size = dmsg->in_size,
+			.out = (char *)out,
+			.out_size = sizeof(out),
+		};
+		int ret;
+
+		dmsg->handler(&msg);
+
+		if (dmsg->respond) {
+			ret = scmi_smt_delayed_response(&msg);
+			if (ret != 0) {
+				WARN("SCMI agent %u: delayed response lost (%d)\n",
+				     msg.agent_id, ret);
+			}
+		}
+
+		spin_lock(&delayed_msg_lock);
+		dmsg->state = DELAYED_MSG_FREE;
+		spin_unlock(&delayed_msg_lock);
+	}
+}
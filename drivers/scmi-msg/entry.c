@@ -6,13 +6,17 @@
 
 #include <assert.h>
 
+#include <arch_helpers.h>
 #include <drivers/scmi-msg.h>
 #include <drivers/scmi.h>
+#include <lib/utils_def.h>
 
 #include "common.h"
 
 #pragma weak scmi_msg_get_clock_handler
+#pragma weak scmi_msg_get_perf_handler
 #pragma weak scmi_msg_get_rstd_handler
+#pragma weak scmi_msg_get_sensor_handler
 #pragma weak scmi_msg_get_pd_handler
 #pragma weak scmi_msg_get_voltage_handler
 
@@ -21,11 +25,21 @@ scmi_msg_handler_t scmi_msg_get_clock_handler(struct scmi_msg *msg __unused)
 	return NULL;
 }
 
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg __unused)
+{
+	return NULL;
+}
+
 scmi_msg_handler_t scmi_msg_get_rstd_handler(struct scmi_msg *msg __unused)
 {
 	return NULL;
 }
 
+scmi_msg_handler_t scmi_msg_get_sensor_handler(struct scmi_msg *msg __unused)
+{
+	return NULL;
+}
+
 scmi_msg_handler_t scmi_msg_get_pd_handler(struct scmi_msg *msg __unused)
 {
 	return NULL;
@@ -58,29 +72,48 @@ void scmi_write_response(struct scmi_msg *msg, void *payload, size_t size)
 	msg->out_size_out = size;
 }
 
-void scmi_process_message(struct scmi_msg *msg)
+/*
+ * Protocol handler getters indexed from SCMI_PROTOCOL_ID_BASE, so that a
+ * message reaches its handler with two table lookups.
+ */
+typedef scmi_msg_handler_t (*scmi_msg_get_handler_t)(struct scmi_msg *msg);
+
+#define PROTOCOL_INDEX(_id)	((_id) - SCMI_PROTOCOL_ID_BASE)
+
+static const scmi_msg_get_handler_t scmi_protocol_table[] = {
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_BASE)] = scmi_msg_get_base_handler,
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_POWER_DOMAIN)] = scmi_msg_get_pd_handler,
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_PERF)] = scmi_msg_get_perf_handler,
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_CLOCK)] = scmi_msg_get_clock_handler,
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_RESET_DOMAIN)] = scmi_msg_get_rstd_handler,
+	[PROTOCOL_INDEX(SCMI_PROTOCOL_ID_SENSOR)] = scmi_msg_get_sensor_handler,
+};
+
+void __hot scmi_process_message(struct scmi_msg *msg)
 {
 	scmi_msg_handler_t handler = NULL;
-
-	switch (msg->protocol_id) {
-	case SCMI_PROTOCOL_ID_BASE:
-		handler = scmi_msg_get_base_handler(msg);
-		break;
-	case SCMI_PROTOCOL_ID_CLOCK:
-		handler = scmi_msg_get_clock_handler(msg);
-		break;
-	case SCMI_PROTOCOL_ID_RESET_DOMAIN:
-		handler = scmi_msg_get_rstd_handler(msg);
-		break;
-	case SCMI_PROTOCOL_ID_POWER_DOMAIN:
-		handler = scmi_msg_get_pd_handler(msg);
-		break;
-	default:
-		break;
+	unsigned int index = PROTOCOL_INDEX(msg->protocol_id);
+#if SCMI_MSG_STATS
+	uint64_t start;
+#endif
+
+	/* Protocol IDs below SCMI_PROTOCOL_ID_BASE wrap to large indexes */
+	if (index < ARRAY_SIZE(scmi_protocol_table)) {
+		index = SPECULATION_SAFE_VALUE(index);
+
+		if (scmi_protocol_table[index] != NULL) {
+			handler = scmi_protocol_table[index](msg);
+		}
 	}
 
 	if (handler) {
+#if SCMI_MSG_STATS
+		start = read_cntpct_el0();
+		handler(msg);
+		scmi_msg_stats_update(msg, read_cntpct_el0() - start);
+#else
 		handler(msg);
+#endif
 		return;
 	}
 
@@ -0,0 +1,386 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+#include <cdefs.h>
+#include <string.h>
+
+#include <drivers/scmi-msg.h>
+#include <drivers/scmi.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include "common.h"
+
+static bool message_id_is_supported(unsigned int message_id);
+
+#pragma weak plat_scmi_perf_count
+#pragma weak plat_scmi_perf_get_name
+#pragma weak plat_scmi_perf_levels_array
+#pragma weak plat_scmi_perf_level_get
+#pragma weak plat_scmi_perf_level_set
+
+size_t plat_scmi_perf_count(unsigned int agent_id __unused)
+{
+	return 0U;
+}
+
+const char *plat_scmi_perf_get_name(unsigned int agent_id __unused,
+				    unsigned int scmi_id __unused)
+{
+	return NULL;
+}
+
+int32_t plat_scmi_perf_levels_array(unsigned int agent_id __unused,
+				    unsigned int scmi_id __unused,
+				    size_t start_index __unused,
+				    unsigned int *levels __unused,
+				    size_t *nb_elts __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_level_get(unsigned int agent_id __unused,
+				 unsigned int scmi_id __unused,
+				 unsigned int *level __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_level_set(unsigned int agent_id __unused,
+				 unsigned int scmi_id __unused,
+				 unsigned int level __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+static void report_version(struct scmi_msg *msg)
+{
+	struct scmi_protocol_version_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		.version = SCMI_PROTOCOL_VERSION_PERF,
+	};
+
+	if (msg->in_size != 0U) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_attributes(struct scmi_msg *msg)
+{
+	size_t domain_count = plat_scmi_perf_count(msg->agent_id);
+	struct scmi_perf_protocol_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		/* Power costs are abstract, no statistics shared memory */
+		.attributes = domain_count & SCMI_PERF_DOMAIN_COUNT_MASK,
+	};
+
+	if (msg->in_size != 0U) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_message_attributes(struct scmi_msg *msg)
+{
+	struct scmi_protocol_message_attributes_a2p *in_args = (void *)msg->in;
+	struct scmi_protocol_message_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		/* Fast channels are not supported */
+		.attributes = 0U,
+	};
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	if (!message_id_is_supported(in_args->message_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+/* Get the lowest and highest levels of a domain */
+static int32_t get_level_range(unsigned int agent_id, unsigned int domain_id,
+			       unsigned int *min, unsigned int *max)
+{
+	unsigned int level = 0U;
+	size_t nb_levels = 0U;
+	size_t one = 1U;
+	int32_t status;
+
+	status = plat_scmi_perf_levels_array(agent_id, domain_id, 0U, NULL,
+					     &nb_levels);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	if (nb_levels == 0U) {
+		return SCMI_GENERIC_ERROR;
+	}
+
+	/* Levels are reported in ascending order */
+	status = plat_scmi_perf_levels_array(agent_id, domain_id, 0U, &level,
+					     &one);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	*min = level;
+
+	status = plat_scmi_perf_levels_array(agent_id, domain_id,
+					     nb_levels - 1U, &level, &one);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	*max = level;
+
+	return SCMI_SUCCESS;
+}
+
+static void scmi_perf_domain_attributes(struct scmi_msg *msg)
+{
+	const struct scmi_perf_domain_attributes_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_domain_attributes_p2a return_values;
+	const char *name = NULL;
+	unsigned int domain_id = 0U;
+	unsigned int min = 0U;
+	unsigned int max = 0U;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	name = plat_scmi_perf_get_name(msg->agent_id, domain_id);
+	if (name == NULL) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = get_level_range(msg->agent_id, domain_id, &min, &max);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	zeromem(&return_values, sizeof(return_values));
+	COPY_NAME_IDENTIFIER(return_values.name, name);
+	return_values.status = SCMI_SUCCESS;
+	return_values.attributes = SCMI_PERF_DOMAIN_ATTR_SET_LEVEL;
+	/* Performance levels are the frequencies in kHz */
+	return_values.sustained_freq_khz = max;
+	return_values.sustained_perf_level = max;
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+#define LEVELS_ARRAY_SIZE_MAX	(SCMI_PLAYLOAD_MAX - \
+				 sizeof(struct scmi_perf_describe_levels_p2a))
+
+static void scmi_perf_describe_levels(struct scmi_msg *msg)
+{
+	const struct scmi_perf_describe_levels_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_describe_levels_p2a *p2a = (void *)msg->out;
+	unsigned int levels[LEVELS_ARRAY_SIZE_MAX /
+			    sizeof(struct scmi_perf_level)];
+	unsigned int domain_id = 0U;
+	size_t nb_levels = 0U;
+	size_t ret_nb = 0U;
+	size_t n;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_levels_array(msg->agent_id, domain_id, 0U,
+					     NULL, &nb_levels);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	if (in_args->level_index > nb_levels) {
+		scmi_status_response(msg, SCMI_OUT_OF_RANGE);
+		return;
+	}
+
+	ret_nb = MIN(nb_levels - in_args->level_index, ARRAY_SIZE(levels));
+
+	status = plat_scmi_perf_levels_array(msg->agent_id, domain_id,
+					     in_args->level_index, levels,
+					     &ret_nb);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	if (msg->out_size < (sizeof(*p2a) +
+			     ret_nb * sizeof(struct scmi_perf_level))) {
+		scmi_status_response(msg, SCMI_GENERIC_ERROR);
+		return;
+	}
+
+	for (n = 0U; n < ret_nb; n++) {
+		p2a->level[n].perf_level = levels[n];
+		/* Power cost in abstract unit, level based */
+		p2a->level[n].power_cost = levels[n];
+		/* Transition latency is not known */
+		p2a->level[n].attributes = 0U;
+	}
+
+	p2a->num_levels = SCMI_PERF_NUM_LEVELS(ret_nb, nb_levels - ret_nb -
+					       in_args->level_index);
+	p2a->status = SCMI_SUCCESS;
+
+	msg->out_size_out = sizeof(*p2a) +
+			    ret_nb * sizeof(struct scmi_perf_level);
+}
+
+static void scmi_perf_limits_get(struct scmi_msg *msg)
+{
+	const struct scmi_perf_limits_get_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_limits_get_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int domain_id = 0U;
+	unsigned int min = 0U;
+	unsigned int max = 0U;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	/* Limits cannot be changed, they cover all levels */
+	status = get_level_range(msg->agent_id, domain_id, &min, &max);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	return_values.range_max = max;
+	return_values.range_min = min;
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void scmi_perf_level_set(struct scmi_msg *msg)
+{
+	const struct scmi_perf_level_set_a2p *in_args = (void *)msg->in;
+	unsigned int domain_id = 0U;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_level_set(msg->agent_id, domain_id,
+					  in_args->perf_level);
+
+	scmi_status_response(msg, status);
+}
+
+static void scmi_perf_level_get(struct scmi_msg *msg)
+{
+	const struct scmi_perf_level_get_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_level_get_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int domain_id = 0U;
+	unsigned int level = 0U;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_level_get(msg->agent_id, domain_id, &level);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	return_values.perf_level = level;
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static const scmi_msg_handler_t scmi_perf_handler_table[] = {
+	[SCMI_PROTOCOL_VERSION] = report_version,
+	[SCMI_PROTOCOL_ATTRIBUTES] = report_attributes,
+	[SCMI_PROTOCOL_MESSAGE_ATTRIBUTES] = report_message_attributes,
+	[SCMI_PERF_DOMAIN_ATTRIBUTES] = scmi_perf_domain_attributes,
+	[SCMI_PERF_DESCRIBE_LEVELS] = scmi_perf_describe_levels,
+	[SCMI_PERF_LIMITS_GET] = scmi_perf_limits_get,
+	[SCMI_PERF_LEVEL_SET] = scmi_perf_level_set,
+	[SCMI_PERF_LEVEL_GET] = scmi_perf_level_get,
+};
+
+static bool message_id_is_supported(unsigned int message_id)
+{
+	return (message_id < ARRAY_SIZE(scmi_perf_handler_table)) &&
+	       (scmi_perf_handler_table[message_id] != NULL);
+}
+
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg)
+{
+	unsigned int message_id = SPECULATION_SAFE_VALUE(msg->message_id);
+
+	if (message_id >= ARRAY_SIZE(scmi_perf_handler_table)) {
+		VERBOSE("Perf domain handle not found %u\n", msg->message_id);
+		return NULL;
+	}
+
+	return scmi_perf_handler_table[message_id];
+}
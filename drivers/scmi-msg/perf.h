@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+#ifndef SCMI_MSG_PERF_H
+#define SCMI_MSG_PERF_H
+
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+#define SCMI_PROTOCOL_VERSION_PERF	0x20000U
+
+/*
+ * Identifiers of the SCMI Performance Domain Management Protocol commands
+ */
+enum scmi_perf_command_id {
+	SCMI_PERF_DOMAIN_ATTRIBUTES = 0x003,
+	SCMI_PERF_DESCRIBE_LEVELS = 0x004,
+	SCMI_PERF_LIMITS_SET = 0x005,
+	SCMI_PERF_LIMITS_GET = 0x006,
+	SCMI_PERF_LEVEL_SET = 0x007,
+	SCMI_PERF_LEVEL_GET = 0x008,
+};
+
+/*
+ * PROTOCOL_ATTRIBUTES
+ */
+
+#define SCMI_PERF_DOMAIN_COUNT_MASK		GENMASK_32(15, 0)
+
+struct scmi_perf_protocol_attributes_p2a {
+	int32_t status;
+	uint32_t attributes;
+	uint32_t statistics_address_low;
+	uint32_t statistics_address_high;
+	uint32_t statistics_len;
+};
+
+/*
+ * PERFORMANCE_DOMAIN_ATTRIBUTES
+ */
+
+#define SCMI_PERF_DOMAIN_ATTR_SET_LIMITS	BIT_32(31)
+#define SCMI_PERF_DOMAIN_ATTR_SET_LEVEL		BIT_32(30)
+
+#define SCMI_PERF_DOMAIN_NAME_SIZE		16U
+
+struct scmi_perf_domain_attributes_a2p {
+	uint32_t domain_id;
+};
+
+struct scmi_perf_domain_attributes_p2a {
+	int32_t status;
+	uint32_t attributes;
+	uint32_t rate_limit_us;
+	uint32_t sustained_freq_khz;
+	uint32_t sustained_perf_level;
+	char name[SCMI_PERF_DOMAIN_NAME_SIZE];
+};
+
+/*
+ * PERFORMANCE_DESCRIBE_LEVELS
+ */
+
+#define SCMI_PERF_NUM_LEVELS_COUNT_MASK		GENMASK_32(11, 0)
+#define SCMI_PERF_NUM_LEVELS_REMAINING_MASK	GENMASK_32(31, 16)
+#define SCMI_PERF_NUM_LEVELS_REMAINING_POS	16
+
+#define SCMI_PERF_NUM_LEVELS(_count, _rem_levels) \
+	(((_count) & SCMI_PERF_NUM_LEVELS_COUNT_MASK) | \
+	 (((_rem_levels) << SCMI_PERF_NUM_LEVELS_REMAINING_POS) & \
+	  SCMI_PERF_NUM_LEVELS_REMAINING_MASK))
+
+struct scmi_perf_describe_levels_a2p {
+	uint32_t domain_id;
+	uint32_t level_index;
+};
+
+struct scmi_perf_level {
+	uint32_t perf_level;
+	uint32_t power_cost;
+	uint32_t attributes;
+};
+
+struct scmi_perf_describe_levels_p2a {
+	int32_t status;
+	uint32_t num_levels;
+	struct scmi_perf_level level[];
+};
+
+/*
+ * PERFORMANCE_LIMITS_GET
+ */
+
+struct scmi_perf_limits_get_a2p {
+	uint32_t domain_id;
+};
+
+struct scmi_perf_limits_get_p2a {
+	int32_t status;
+	uint32_t range_max;
+	uint32_t range_min;
+};
+
+/*
+ * PERFORMANCE_LEVEL_SET
+ */
+
+struct scmi_perf_level_set_a2p {
+	uint32_t domain_id;
+	uint32_t perf_level;
+};
+
+/*
+ * PERFORMANCE_LEVEL_GET
+ */
+
+struct scmi_perf_level_get_a2p {
+	uint32_t domain_id;
+};
+
+struct scmi_perf_level_get_p2a {
+	int32_t status;
+	uint32_t perf_level;
+};
+
+#endif /* SCMI_MSG_PERF_H */
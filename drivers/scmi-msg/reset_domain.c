@@ -19,6 +19,8 @@ static bool message_id_is_supported(unsigned int message_id);
 #pragma weak plat_scmi_rstd_get_name
 #pragma weak plat_scmi_rstd_autonomous
 #pragma weak plat_scmi_rstd_set_state
+#pragma weak plat_scmi_rstd_group_autonomous
+#pragma weak plat_scmi_rstd_group_set_state
 
 size_t plat_scmi_rstd_count(unsigned int agent_id __unused)
 {
@@ -45,6 +47,22 @@ int32_t plat_scmi_rstd_set_state(unsigned int agent_id __unused,
 	return SCMI_NOT_SUPPORTED;
 }
 
+int32_t plat_scmi_rstd_group_autonomous(unsigned int agent_id __unused,
+					const uint32_t *scmi_id __unused,
+					size_t count __unused,
+					unsigned int state __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_rstd_group_set_state(unsigned int agent_id __unused,
+				       const uint32_t *scmi_id __unused,
+				       size_t count __unused,
+				       bool assert_not_deassert __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
 static void report_version(struct scmi_msg *msg)
 {
 	struct scmi_protocol_version_p2a return_values = {
@@ -170,6 +188,64 @@ static void reset_request(struct scmi_msg *msg)
 	}
 }
 
+static void reset_group_request(struct scmi_msg *msg)
+{
+	struct scmi_reset_domain_group_request_a2p *in_args = (void *)msg->in;
+	struct scmi_reset_domain_group_request_p2a out_args = {
+		.status = SCMI_SUCCESS,
+	};
+	uint32_t domain_id[SCMI_RESET_DOMAIN_GROUP_MAX];
+	size_t count;
+	size_t i;
+
+	if (msg->in_size < sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	count = SPECULATION_SAFE_VALUE(in_args->count);
+
+	if ((count == 0U) || (count > SCMI_RESET_DOMAIN_GROUP_MAX)) {
+		scmi_status_response(msg, SCMI_INVALID_PARAMETERS);
+		return;
+	}
+
+	if (msg->in_size != (sizeof(*in_args) + (count * sizeof(uint32_t)))) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	/* Copy the IDs: the platform checks them before they are used */
+	for (i = 0U; i < count; i++) {
+		domain_id[i] = in_args->domain_id[i];
+
+		if (domain_id[i] >= plat_scmi_rstd_count(msg->agent_id)) {
+			scmi_status_response(msg, SCMI_NOT_FOUND);
+			return;
+		}
+	}
+
+	if ((in_args->flags & SCMI_RESET_DOMAIN_AUTO) != 0U) {
+		out_args.status = plat_scmi_rstd_group_autonomous(msg->agent_id,
+								  domain_id,
+								  count,
+								  in_args->reset_state);
+	} else {
+		out_args.status = plat_scmi_rstd_group_set_state(msg->agent_id,
+								 domain_id,
+								 count,
+								 (in_args->flags &
+								  SCMI_RESET_DOMAIN_EXPLICIT) !=
+								 0U);
+	}
+
+	if (out_args.status != SCMI_SUCCESS) {
+		scmi_status_response(msg, out_args.status);
+	} else {
+		scmi_write_response(msg, &out_args, sizeof(out_args));
+	}
+}
+
 static const scmi_msg_handler_t scmi_rstd_handler_table[] = {
 	[SCMI_PROTOCOL_VERSION] = report_version,
 	[SCMI_PROTOCOL_ATTRIBUTES] = report_attributes,
@@ -180,6 +256,10 @@ static const scmi_msg_handler_t scmi_rstd_handler_table[] = {
 
 static bool message_id_is_supported(unsigned int message_id)
 {
+	if (message_id == SCMI_RESET_DOMAIN_GROUP_REQUEST) {
+		return true;
+	}
+
 	return (message_id < ARRAY_SIZE(scmi_rstd_handler_table)) &&
 	       (scmi_rstd_handler_table[message_id] != NULL);
 }
@@ -188,6 +268,11 @@ scmi_msg_handler_t scmi_msg_get_rstd_handler(struct scmi_msg *msg)
 {
 	unsigned int message_id = SPECULATION_SAFE_VALUE(msg->message_id);
 
+	/* Out of the table, not to size it for the vendor message ID */
+	if (message_id == SCMI_RESET_DOMAIN_GROUP_REQUEST) {
+		return reset_group_request;
+	}
+
 	if (message_id >= ARRAY_SIZE(scmi_rstd_handler_table)) {
 		VERBOSE("Reset domain handle not found %u\n", msg->message_id);
 		return NULL;
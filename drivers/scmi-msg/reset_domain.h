@@ -23,6 +23,8 @@ enum scmi_reset_domain_command_id {
 	SCMI_RESET_DOMAIN_ATTRIBUTES = 0x03,
 	SCMI_RESET_DOMAIN_REQUEST = 0x04,
 	SCMI_RESET_DOMAIN_NOTIFY = 0x05,
+	/* Vendor extension */
+	SCMI_RESET_DOMAIN_GROUP_REQUEST = 0x80,
 };
 
 /*
@@ -85,6 +87,25 @@ struct scmi_reset_domain_request_p2a {
 	int32_t status;
 };
 
+/*
+ * RESET_DOMAIN_GROUP_REQUEST (vendor extension)
+ *
+ * Same request as RESET, applied to several domains at once. The reset
+ * controller writes each of its registers once for the whole group. The
+ * group size is limited to SCMI_RESET_DOMAIN_GROUP_MAX.
+ */
+
+struct scmi_reset_domain_group_request_a2p {
+	uint32_t flags;
+	uint32_t reset_state;
+	uint32_t count;
+	uint32_t domain_id[];
+};
+
+struct scmi_reset_domain_group_request_p2a {
+	int32_t status;
+};
+
 /*
  * RESET_NOTIFY
  */
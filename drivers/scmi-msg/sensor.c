@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+#include <cdefs.h>
+#include <string.h>
+
+#include <drivers/scmi-msg.h>
+#include <drivers/scmi.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include "common.h"
+
+static bool message_id_is_supported(unsigned int message_id);
+
+#pragma weak plat_scmi_sensor_count
+#pragma weak plat_scmi_sensor_get_name
+#pragma weak plat_scmi_sensor_get_unit
+#pragma weak plat_scmi_sensor_reading_get
+
+size_t plat_scmi_sensor_count(unsigned int agent_id __unused)
+{
+	return 0U;
+}
+
+const char *plat_scmi_sensor_get_name(unsigned int agent_id __unused,
+				      unsigned int scmi_id __unused)
+{
+	return NULL;
+}
+
+int32_t plat_scmi_sensor_get_unit(unsigned int agent_id __unused,
+				  unsigned int scmi_id __unused,
+				  unsigned int *type __unused,
+				  int *scale __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_sensor_reading_get(unsigned int agent_id __unused,
+				     unsigned int scmi_id __unused,
+				     int64_t *value __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+static void report_version(struct scmi_msg *msg)
+{
+	struct scmi_protocol_version_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		.version = SCMI_PROTOCOL_VERSION_SENSOR,
+	};
+
+	if (msg->in_size != 0U) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_attributes(struct scmi_msg *msg)
+{
+	size_t sensor_count = plat_scmi_sensor_count(msg->agent_id);
+	struct scmi_sensor_protocol_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		/* No asynchronous reading, no shared memory sensor registers */
+		.attributes = sensor_count & SCMI_SENSOR_COUNT_MASK,
+	};
+
+	if (msg->in_size != 0U) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_message_attributes(struct scmi_msg *msg)
+{
+	struct scmi_protocol_message_attributes_a2p *in_args = (void *)msg->in;
+	struct scmi_protocol_message_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		/* For this protocol, attributes shall be zero */
+		.attributes = 0U,
+	};
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	if (!message_id_is_supported(in_args->message_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+#define DESC_ARRAY_SIZE_MAX	((SCMI_PLAYLOAD_MAX - \
+				  sizeof(struct scmi_sensor_description_get_p2a)) / \
+				 sizeof(struct scmi_sensor_desc))
+
+static void scmi_sensor_description_get(struct scmi_msg *msg)
+{
+	const struct scmi_sensor_description_get_a2p *in_args = (void *)msg->in;
+	struct scmi_sensor_description_get_p2a *p2a = (void *)msg->out;
+	size_t sensor_count = plat_scmi_sensor_count(msg->agent_id);
+	size_t ret_nb = 0U;
+	size_t n;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	if (in_args->desc_index > sensor_count) {
+		scmi_status_response(msg, SCMI_INVALID_PARAMETERS);
+		return;
+	}
+
+	ret_nb = MIN(sensor_count - in_args->desc_index, DESC_ARRAY_SIZE_MAX);
+
+	if (msg->out_size < (sizeof(*p2a) +
+			     ret_nb * sizeof(struct scmi_sensor_desc))) {
+		scmi_status_response(msg, SCMI_GENERIC_ERROR);
+		return;
+	}
+
+	for (n = 0U; n < ret_nb; n++) {
+		struct scmi_sensor_desc *desc = &p2a->desc[n];
+		unsigned int sensor_id = in_args->desc_index + n;
+		const char *name = NULL;
+		unsigned int type = 0U;
+		int scale = 0;
+		int32_t status;
+
+		name = plat_scmi_sensor_get_name(msg->agent_id, sensor_id);
+		if (name == NULL) {
+			scmi_status_response(msg, SCMI_GENERIC_ERROR);
+			return;
+		}
+
+		status = plat_scmi_sensor_get_unit(msg->agent_id, sensor_id,
+						   &type, &scale);
+		if (status != SCMI_SUCCESS) {
+			scmi_status_response(msg, status);
+			return;
+		}
+
+		zeromem(desc, sizeof(*desc));
+		desc->sensor_id = sensor_id;
+		/* No trip point, no asynchronous reading */
+		desc->attributes_low = 0U;
+		desc->attributes_high = SCMI_SENSOR_ATTR_HIGH(type, scale);
+		COPY_NAME_IDENTIFIER(desc->name, name);
+	}
+
+	p2a->num_sensor_flags = SCMI_SENSOR_NUM_DESC(ret_nb, sensor_count -
+						     ret_nb -
+						     in_args->desc_index);
+	p2a->status = SCMI_SUCCESS;
+
+	msg->out_size_out = sizeof(*p2a) +
+			    ret_nb * sizeof(struct scmi_sensor_desc);
+}
+
+static void scmi_sensor_reading_get(struct scmi_msg *msg)
+{
+	const struct scmi_sensor_reading_get_a2p *in_args = (void *)msg->in;
+	struct scmi_sensor_reading_get_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int sensor_id = 0U;
+	int64_t value = 0;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	sensor_id = SPECULATION_SAFE_VALUE(in_args->sensor_id);
+
+	if (sensor_id >= plat_scmi_sensor_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	if ((in_args->flags & SCMI_SENSOR_READING_ASYNC) != 0U) {
+		scmi_status_response(msg, SCMI_NOT_SUPPORTED);
+		return;
+	}
+
+	status = plat_scmi_sensor_reading_get(msg->agent_id, sensor_id, &value);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	return_values.value_low = (uint32_t)value;
+	return_values.value_high = (uint32_t)((uint64_t)value >> 32);
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static const scmi_msg_handler_t scmi_sensor_handler_table[] = {
+	[SCMI_PROTOCOL_VERSION] = report_version,
+	[SCMI_PROTOCOL_ATTRIBUTES] = report_attributes,
+	[SCMI_PROTOCOL_MESSAGE_ATTRIBUTES] = report_message_attributes,
+	[SCMI_SENSOR_DESCRIPTION_GET] = scmi_sensor_description_get,
+	[SCMI_SENSOR_READING_GET] = scmi_sensor_reading_get,
+};
+
+static bool message_id_is_supported(unsigned int message_id)
+{
+	return (message_id < ARRAY_SIZE(scmi_sensor_handler_table)) &&
+	       (scmi_sensor_handler_table[message_id] != NULL);
+}
+
+scmi_msg_handler_t scmi_msg_get_sensor_handler(struct scmi_msg *msg)
+{
+	unsigned int message_id = SPECULATION_SAFE_VALUE(msg->message_id);
+
+	if (message_id >= ARRAY_SIZE(scmi_sensor_handler_table)) {
+		VERBOSE("Sensor handle not found %u\n", msg->message_id);
+		return NULL;
+	}
+
+	return scmi_sensor_handler_table[message_id];
+}
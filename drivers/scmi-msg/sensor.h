@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+#ifndef SCMI_MSG_SENSOR_H
+#define SCMI_MSG_SENSOR_H
+
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+#define SCMI_PROTOCOL_VERSION_SENSOR	0x10000U
+
+/*
+ * Identifiers of the SCMI Sensor Management Protocol commands
+ */
+enum scmi_sensor_command_id {
+	SCMI_SENSOR_DESCRIPTION_GET = 0x003,
+	SCMI_SENSOR_TRIP_POINT_NOTIFY = 0x004,
+	SCMI_SENSOR_TRIP_POINT_CONFIG = 0x005,
+	SCMI_SENSOR_READING_GET = 0x006,
+};
+
+/*
+ * PROTOCOL_ATTRIBUTES
+ */
+
+#define SCMI_SENSOR_COUNT_MASK			GENMASK_32(15, 0)
+
+struct scmi_sensor_protocol_attributes_p2a {
+	int32_t status;
+	uint32_t attributes;
+	uint32_t sensor_reg_address_low;
+	uint32_t sensor_reg_address_high;
+	uint32_t sensor_reg_len;
+};
+
+/*
+ * SENSOR_DESCRIPTION_GET
+ */
+
+#define SCMI_SENSOR_NAME_SIZE			16U
+
+#define SCMI_SENSOR_TYPE_MASK			GENMASK_32(7, 0)
+#define SCMI_SENSOR_SCALE_MASK			GENMASK_32(15, 11)
+#define SCMI_SENSOR_SCALE_POS			11
+
+/* Unit scale is a 5-bit two's complement power-of-10 exponent */
+#define SCMI_SENSOR_ATTR_HIGH(_type, _scale) \
+	(((_type) & SCMI_SENSOR_TYPE_MASK) | \
+	 (((uint32_t)(_scale) << SCMI_SENSOR_SCALE_POS) & \
+	  SCMI_SENSOR_SCALE_MASK))
+
+#define SCMI_SENSOR_NUM_DESC_COUNT_MASK		GENMASK_32(11, 0)
+#define SCMI_SENSOR_NUM_DESC_REMAINING_MASK	GENMASK_32(31, 16)
+#define SCMI_SENSOR_NUM_DESC_REMAINING_POS	16
+
+#define SCMI_SENSOR_NUM_DESC(_count, _rem_desc) \
+	(((_count) & SCMI_SENSOR_NUM_DESC_COUNT_MASK) | \
+	 (((_rem_desc) << SCMI_SENSOR_NUM_DESC_REMAINING_POS) & \
+	  SCMI_SENSOR_NUM_DESC_REMAINING_MASK))
+
+struct scmi_sensor_description_get_a2p {
+	uint32_t desc_index;
+};
+
+struct scmi_sensor_desc {
+	uint32_t sensor_id;
+	uint32_t attributes_low;
+	uint32_t attributes_high;
+	char name[SCMI_SENSOR_NAME_SIZE];
+};
+
+struct scmi_sensor_description_get_p2a {
+	int32_t status;
+	uint32_t num_sensor_flags;
+	struct scmi_sensor_desc desc[];
+};
+
+/*
+ * SENSOR_READING_GET
+ */
+
+#define SCMI_SENSOR_READING_ASYNC		BIT_32(0)
+
+struct scmi_sensor_reading_get_a2p {
+	uint32_t sensor_id;
+	uint32_t flags;
+};
+
+struct scmi_sensor_reading_get_p2a {
+	int32_t status;
+	uint32_t value_low;
+	uint32_t value_high;
+};
+
+#endif /* SCMI_MSG_SENSOR_H */
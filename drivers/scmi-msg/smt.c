@@ -4,6 +4,7 @@
  * Copyright (c) 2019-2020, Linaro Limited
  */
 #include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -12,7 +13,6 @@
 #include <drivers/scmi.h>
 #include <lib/cassert.h>
 #include <lib/mmio.h>
-#include <lib/spinlock.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
@@ -61,6 +61,18 @@ CASSERT(SCMI_PLAYLOAD_MAX + sizeof(struct smt_header) <= SMT_BUF_SLOT_SIZE,
 #define SMT_MSG_PROT_ID_MASK		GENMASK_32(17, 10)
 #define SMT_HDR_PROT_ID(_hdr)		(((_hdr) & SMT_MSG_PROT_ID_MASK) >> 10)
 
+#define SMT_MSG_TOKEN_MASK		GENMASK_32(27, 18)
+#define SMT_HDR_TOKEN(_hdr)		(((_hdr) & SMT_MSG_TOKEN_MASK) >> 18)
+
+/* Message type of a server-to-agent delayed response */
+#define SMT_MSG_TYPE_DELAYED_RESP	2U
+
+#define SMT_HEADER(_msg_id, _type, _prot_id, _token) \
+	(((_msg_id) & SMT_MSG_ID_MASK) | \
+	 (((_type) << 8) & SMT_MSG_TYPE_MASK) | \
+	 (((_prot_id) << 10) & SMT_MSG_PROT_ID_MASK) | \
+	 (((_token) << 18) & SMT_MSG_TOKEN_MASK))
+
 /*
  * Provision input message payload buffers for fastcall SMC context entries
  * and for interrupt context execution entries.
@@ -68,30 +80,22 @@ CASSERT(SCMI_PLAYLOAD_MAX + sizeof(struct smt_header) <= SMT_BUF_SLOT_SIZE,
 static uint32_t fast_smc_payload[PLATFORM_CORE_COUNT][SCMI_PLAYLOAD_U32_MAX];
 static uint32_t interrupt_payload[PLATFORM_CORE_COUNT][SCMI_PLAYLOAD_U32_MAX];
 
-/* SMP protection on channel access */
-static struct spinlock smt_channels_lock;
+/*
+ * Channel ownership is taken with an atomic exchange on the channel busy flag
+ * (LDREX/STREX loop on Armv7-A), so that agents never contend on a shared
+ * lock. Acquire and release orderings keep the channel shared memory accesses
+ * within the ownership window.
+ */
 
 /* If channel is not busy, set busy and return true, otherwise return false */
 static bool channel_set_busy(struct scmi_msg_channel *chan)
 {
-	bool channel_is_busy;
-
-	spin_lock(&smt_channels_lock);
-
-	channel_is_busy = chan->busy;
-
-	if (!channel_is_busy) {
-		chan->busy = true;
-	}
-
-	spin_unlock(&smt_channels_lock);
-
-	return !channel_is_busy;
+	return !__atomic_exchange_n(&chan->busy, true, __ATOMIC_ACQUIRE);
 }
 
 static void channel_release_busy(struct scmi_msg_channel *chan)
 {
-	chan->busy = false;
+	__atomic_store_n(&chan->busy, false, __ATOMIC_RELEASE);
 }
 
 static struct smt_header *channel_to_smt_hdr(struct scmi_msg_channel *chan)
@@ -126,6 +130,9 @@ static void scmi_proccess_smt(unsigned int agent_id, uint32_t *payload_buf)
 
 	if (!channel_set_busy(chan)) {
 		VERBOSE("SCMI channel %u busy", agent_id);
+#if SCMI_MSG_STATS
+		scmi_msg_stats_busy(agent_id);
+#endif
 		goto out;
 	}
 
@@ -157,6 +164,7 @@ static void scmi_proccess_smt(unsigned int agent_id, uint32_t *payload_buf)
 
 	msg.protocol_id = SMT_HDR_PROT_ID(smt_hdr->message_header);
 	msg.message_id = SMT_HDR_MSG_ID(smt_hdr->message_header);
+	msg.token = SMT_HDR_TOKEN(smt_hdr->message_header);
 	msg.agent_id = agent_id;
 
 	scmi_process_message(&msg);
@@ -176,7 +184,7 @@ out:
 	}
 }
 
-void scmi_smt_fastcall_smc_entry(unsigned int agent_id)
+void __hot scmi_smt_fastcall_smc_entry(unsigned int agent_id)
 {
 	scmi_proccess_smt(agent_id,
 			  fast_smc_payload[plat_my_core_pos()]);
@@ -188,6 +196,129 @@ void scmi_smt_interrupt_entry(unsigned int agent_id)
 			  interrupt_payload[plat_my_core_pos()]);
 }
 
+/*
+ * Messages that can be passed in registers: their request and response fit in
+ * SCMI_REGS_PAYLOAD_U32_MAX words and they are never deferred.
+ */
+static const struct scmi_regs_msg {
+	uint8_t protocol_id;
+	uint8_t message_id;
+	uint8_t in_size;
+} scmi_regs_msg[] = {
+	{
+		.protocol_id = SCMI_PROTOCOL_ID_CLOCK,
+		.message_id = SCMI_CLOCK_RATE_GET,
+		.in_size = sizeof(struct scmi_clock_rate_get_a2p),
+	},
+	{
+		.protocol_id = SCMI_PROTOCOL_ID_PERF,
+		.message_id = SCMI_PERF_LEVEL_GET,
+		.in_size = sizeof(struct scmi_perf_level_get_a2p),
+	},
+	{
+		.protocol_id = SCMI_PROTOCOL_ID_PERF,
+		.message_id = SCMI_PERF_LEVEL_SET,
+		.in_size = sizeof(struct scmi_perf_level_set_a2p),
+	},
+};
+
+CASSERT(sizeof(struct scmi_clock_rate_get_p2a) <=
+	(SCMI_REGS_PAYLOAD_U32_MAX * sizeof(uint32_t)),
+	assert_scmi_regs_response_fits);
+
+int scmi_regs_fastcall_entry(unsigned int agent_id, uint32_t msg_header,
+			     const uint32_t *in, uint32_t *out,
+			     size_t *out_size)
+{
+	const struct scmi_regs_msg *regs_msg = NULL;
+	uint32_t in_buf[SCMI_REGS_PAYLOAD_U32_MAX];
+	struct scmi_msg_channel *chan;
+	struct scmi_msg msg;
+	size_t i;
+
+	for (i = 0U; i < ARRAY_SIZE(scmi_regs_msg); i++) {
+		if ((scmi_regs_msg[i].protocol_id ==
+		     SMT_HDR_PROT_ID(msg_header)) &&
+		    (scmi_regs_msg[i].message_id ==
+		     SMT_HDR_MSG_ID(msg_header))) {
+			regs_msg = &scmi_regs_msg[i];
+			break;
+		}
+	}
+
+	if (regs_msg == NULL) {
+		return -ENOTSUP;
+	}
+
+	chan = plat_scmi_get_channel(agent_id);
+	if (chan == NULL) {
+		return -ENOENT;
+	}
+
+	/* Messages of an agent are serialized, whatever their transport */
+	if (!channel_set_busy(chan)) {
+#if SCMI_MSG_STATS
+		scmi_msg_stats_busy(agent_id);
+#endif
+		return -EBUSY;
+	}
+
+	memcpy(in_buf, in, regs_msg->in_size);
+
+	zeromem(&msg, sizeof(msg));
+	msg.in = (char *)in_buf;
+	msg.in_size = regs_msg->in_size;
+	msg.out = (char *)out;
+	msg.out_size = SCMI_REGS_PAYLOAD_U32_MAX * sizeof(uint32_t);
+	msg.protocol_id = regs_msg->protocol_id;
+	msg.message_id = regs_msg->message_id;
+	msg.token = SMT_HDR_TOKEN(msg_header);
+	msg.agent_id = agent_id;
+
+	scmi_process_message(&msg);
+
+	*out_size = msg.out_size_out;
+
+	channel_release_busy(chan);
+
+	return 0;
+}
+
+int scmi_smt_delayed_response(struct scmi_msg *msg)
+{
+	struct scmi_msg_channel *chan;
+	struct smt_header *smt_hdr;
+
+	chan = plat_scmi_get_channel(msg->agent_id);
+	if ((chan == NULL) || (chan->p2a_shm_addr == 0U)) {
+		return -ENODEV;
+	}
+
+	smt_hdr = (struct smt_header *)chan->p2a_shm_addr;
+
+	if (msg->out_size_out > (chan->p2a_shm_size - sizeof(*smt_hdr))) {
+		return -EINVAL;
+	}
+
+	/* Agent has not yet consumed the previous delayed response */
+	if ((__atomic_load_n(&smt_hdr->status, __ATOMIC_ACQUIRE) &
+	     SMT_STATUS_FREE) == 0U) {
+		return -EBUSY;
+	}
+
+	memcpy(smt_hdr->payload, msg->out, msg->out_size_out);
+	smt_hdr->message_header = SMT_HEADER(msg->message_id,
+					     SMT_MSG_TYPE_DELAYED_RESP,
+					     msg->protocol_id, msg->token);
+	smt_hdr->length = msg->out_size_out + sizeof(smt_hdr->message_header);
+
+	__atomic_store_n(&smt_hdr->status, 0U, __ATOMIC_RELEASE);
+
+	plat_scmi_delayed_response_notify(msg->agent_id);
+
+	return 0;
+}
+
 /* Init a SMT header for a shared memory buffer: state it a free/no-error */
 void scmi_smt_init_agent_channel(struct scmi_msg_channel *chan)
 {
@@ -198,6 +329,13 @@ void scmi_smt_init_agent_channel(struct scmi_msg_channel *chan)
 			memset(smt_header, 0, sizeof(*smt_header));
 			smt_header->status = SMT_STATUS_FREE;
 
+			if (chan->p2a_shm_addr != 0U) {
+				smt_header = (struct smt_header *)
+					     chan->p2a_shm_addr;
+				memset(smt_header, 0, sizeof(*smt_header));
+				smt_header->status = SMT_STATUS_FREE;
+			}
+
 			return;
 		}
 	}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <drivers/scmi-msg.h>
+#include <drivers/scmi.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include "common.h"
+
+/*
+ * Statistics of a message are only updated while the channel of its agent is
+ * busy, which serializes them without a lock. Busy collisions are counted
+ * outside of the channel ownership, with atomic operations.
+ */
+static struct scmi_msg_stats
+msg_stats[SCMI_MSG_STATS_AGENTS][SCMI_MSG_STATS_PROTOCOLS]
+	 [SCMI_MSG_STATS_MESSAGES];
+static uint32_t busy_count[SCMI_MSG_STATS_AGENTS];
+
+static struct scmi_msg_stats *stats_entry(unsigned int agent_id,
+					  unsigned int protocol_id,
+					  unsigned int message_id)
+{
+	unsigned int index = protocol_id - SCMI_PROTOCOL_ID_BASE;
+
+	if ((agent_id >= SCMI_MSG_STATS_AGENTS) ||
+	    (index >= SCMI_MSG_STATS_PROTOCOLS) ||
+	    (message_id >= SCMI_MSG_STATS_MESSAGES)) {
+		return NULL;
+	}
+
+	return &msg_stats[agent_id][index][message_id];
+}
+
+void scmi_msg_stats_update(struct scmi_msg *msg, uint64_t ticks)
+{
+	struct scmi_msg_stats *stats = stats_entry(msg->agent_id,
+						   msg->protocol_id,
+						   msg->message_id);
+
+	if (stats == NULL) {
+		return;
+	}
+
+	stats->count++;
+	stats->total_ticks += ticks;
+	stats->max_ticks = MAX(stats->max_ticks,
+			       (uint32_t)MIN(ticks, (uint64_t)UINT32_MAX));
+}
+
+void scmi_msg_stats_busy(unsigned int agent_id)
+{
+	if (agent_id < SCMI_MSG_STATS_AGENTS) {
+		(void)__atomic_fetch_add(&busy_count[agent_id], 1U,
+					 __ATOMIC_RELAXED);
+	}
+}
+
+int scmi_msg_stats_get(unsigned int agent_id, unsigned int protocol_id,
+		       unsigned int message_id, struct scmi_msg_stats *stats)
+{
+	struct scmi_msg_stats *entry = stats_entry(agent_id, protocol_id,
+						   message_id);
+
+	if (entry == NULL) {
+		return -EINVAL;
+	}
+
+	*stats = *entry;
+
+	return 0;
+}
+
+uint32_t scmi_msg_stats_get_busy(unsigned int agent_id)
+{
+	if (agent_id >= SCMI_MSG_STATS_AGENTS) {
+		return 0U;
+	}
+
+	return __atomic_load_n(&busy_count[agent_id], __ATOMIC_RELAXED);
+}
+
+void scmi_msg_stats_reset(void)
+{
+	zeromem(msg_stats, sizeof(msg_stats));
+	zeromem(busy_count, sizeof(busy_count));
+}
+
+void scmi_msg_stats_dump(void)
+{
+	unsigned int agent;
+	unsigned int prot;
+	unsigned int msg;
+
+	for (agent = 0U; agent < SCMI_MSG_STATS_AGENTS; agent++) {
+		NOTICE("SCMI agent %u: %u busy\n", agent,
+		       scmi_msg_stats_get_busy(agent));
+
+		for (prot = 0U; prot < SCMI_MSG_STATS_PROTOCOLS; prot++) {
+			for (msg = 0U; msg < SCMI_MSG_STATS_MESSAGES; msg++) {
+				struct scmi_msg_stats *stats;
+
+				stats = &msg_stats[agent][prot][msg];
+				if (stats->count == 0U) {
+					continue;
+				}
+
+				NOTICE("  0x%x/0x%x: %u, avg %u max %u ticks\n",
+				       prot + SCMI_PROTOCOL_ID_BASE, msg,
+				       stats->count,
+				       (uint32_t)(stats->total_ticks /
+						  stats->count),
+				       stats->max_ticks);
+			}
+		}
+	}
+}
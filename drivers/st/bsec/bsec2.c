@@ -13,6 +13,7 @@
 
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/delay_timer.h>
 #include <drivers/st/bsec.h>
 #include <drivers/st/bsec2_reg.h>
 #include <lib/mmio.h>
@@ -70,11 +71,15 @@ static int bsec_get_dt_node(struct dt_node_info *info)
 	return node;
 }
 
-static void enable_non_secure_access(uint32_t otp)
+static void enable_non_secure_access(uint32_t otp, uint32_t count)
 {
-	otp_nsec_access[otp / __WORD_BIT] |= BIT(otp % __WORD_BIT);
+	uint32_t i;
 
-	if (bsec_shadow_register(otp) != BSEC_OK) {
+	for (i = otp; i < (otp + count); i++) {
+		otp_nsec_access[i / __WORD_BIT] |= BIT(i % __WORD_BIT);
+	}
+
+	if (bsec_shadow_range(otp, count) != BSEC_OK) {
 		panic();
 	}
 }
@@ -92,7 +97,6 @@ static int bsec_dt_otp_nsec_access(void *fdt, int bsec_node)
 	fdt_for_each_subnode(bsec_subnode, fdt, bsec_node) {
 		const fdt32_t *cuint;
 		uint32_t otp;
-		uint32_t i;
 		uint32_t size;
 		uint32_t offset;
 		uint32_t length;
@@ -143,9 +147,7 @@ static int bsec_dt_otp_nsec_access(void *fdt, int bsec_node)
 
 		size = length / sizeof(uint32_t);
 
-		for (i = otp; i < (otp + size); i++) {
-			enable_non_secure_access(i);
-		}
+		enable_non_secure_access(otp, size);
 	}
 
 	return 0;
@@ -328,8 +330,22 @@ uint32_t bsec_get_config(struct bsec_config *cfg)
  * return value: BSEC_OK if no error.
  */
 uint32_t bsec_shadow_register(uint32_t otp)
+{
+	return bsec_shadow_range(otp, 1U);
+}
+
+/*
+ * bsec_shadow_range: copy a range of SAFMEM OTPs to BSEC data.
+ *	SAFMEM is powered up once for the whole range.
+ * first: first OTP number.
+ * count: number of OTPs.
+ * return value: BSEC_OK if no error. On error, the following OTPs of the
+ *	range are not refreshed.
+ */
+uint32_t bsec_shadow_range(uint32_t first, uint32_t count)
 {
 	uint32_t result;
+	uint32_t otp;
 	bool value;
 	bool power_up = false;
 
@@ -337,15 +353,9 @@ uint32_t bsec_shadow_register(uint32_t otp)
 		return BSEC_ERROR;
 	}
 
-	result = bsec_read_sr_lock(otp, &value);
-	if (result != BSEC_OK) {
-		ERROR("BSEC: %u Sticky-read bit read Error %i\n", otp, result);
-		return result;
-	}
-
-	if (value) {
-		VERBOSE("BSEC: OTP %u is locked and will not be refreshed\n",
-			otp);
+	if ((first > STM32MP1_OTP_MAX_ID) ||
+	    (count > (STM32MP1_OTP_MAX_ID + 1U - first))) {
+		return BSEC_INVALID_PARAM;
 	}
 
 	if ((bsec_get_status() & BSEC_MODE_PWR_MASK) == 0U) {
@@ -358,17 +368,37 @@ uint32_t bsec_shadow_register(uint32_t otp)
 		power_up = true;
 	}
 
-	bsec_lock();
+	result = BSEC_OK;
+
+	for (otp = first; otp < (first + count); otp++) {
+		result = bsec_read_sr_lock(otp, &value);
+		if (result != BSEC_OK) {
+			ERROR("BSEC: %u Sticky-read bit read Error %i\n", otp,
+			      result);
+			break;
+		}
 
-	mmio_write_32(bsec_base + BSEC_OTP_CTRL_OFF, otp | BSEC_READ);
+		if (value) {
+			VERBOSE("BSEC: OTP %u is locked and will not be refreshed\n",
+				otp);
+		}
 
-	while ((bsec_get_status() & BSEC_MODE_BUSY_MASK) != 0U) {
-		;
-	}
+		bsec_lock();
 
-	result = bsec_check_error(otp, true);
+		mmio_write_32(bsec_base + BSEC_OTP_CTRL_OFF, otp | BSEC_READ);
 
-	bsec_unlock();
+		while ((bsec_get_status() & BSEC_MODE_BUSY_MASK) != 0U) {
+			timeout_wait_event();
+		}
+
+		result = bsec_check_error(otp, true);
+
+		bsec_unlock();
+
+		if (result != BSEC_OK) {
+			break;
+		}
+	}
 
 	if (power_up) {
 		if (bsec_power_safmem(false) != BSEC_OK) {
@@ -494,7 +524,7 @@ uint32_t bsec_program_otp(uint32_t val, uint32_t otp)
 	mmio_write_32(bsec_base + BSEC_OTP_CTRL_OFF, otp | BSEC_WRITE);
 
 	while ((bsec_get_status() & BSEC_MODE_BUSY_MASK) != 0U) {
-		;
+		timeout_wait_event();
 	}
 
 	if ((bsec_get_status() & BSEC_MODE_PROGFAIL_MASK) != 0U) {
@@ -562,7 +592,7 @@ uint32_t bsec_permanent_lock_otp(uint32_t otp)
 		      addr | BSEC_WRITE | BSEC_LOCK);
 
 	while ((bsec_get_status() & BSEC_MODE_BUSY_MASK) != 0U) {
-		;
+		timeout_wait_event();
 	}
 
 	if ((bsec_get_status() & BSEC_MODE_PROGFAIL_MASK) != 0U) {
@@ -961,3 +991,36 @@ uint32_t bsec_check_nsec_access_rights(uint32_t otp)
 	return BSEC_OK;
 }
 
+/*
+ * bsec_check_nsec_access_rights_range: check non-secure access rights to a
+ *	range of OTPs, one access bitmap word at a time.
+ * first: first OTP number.
+ * count: number of OTPs.
+ * return value: BSEC_OK if authorized access to all OTPs of the range.
+ */
+uint32_t bsec_check_nsec_access_rights_range(uint32_t first, uint32_t count)
+{
+	if ((count == 0U) || (first > STM32MP1_OTP_MAX_ID) ||
+	    (count > (STM32MP1_OTP_MAX_ID + 1U - first))) {
+		return BSEC_INVALID_PARAM;
+	}
+
+#if defined(IMAGE_BL32)
+	uint32_t end = first + count;
+	uint32_t otp = MAX(first, (uint32_t)STM32MP1_UPPER_OTP_START);
+
+	while (otp < end) {
+		uint32_t shift = otp % __WORD_BIT;
+		uint32_t nb = MIN(__WORD_BIT - shift, end - otp);
+		uint32_t mask = GENMASK_32(shift + nb - 1U, shift);
+
+		if ((otp_nsec_access[otp / __WORD_BIT] & mask) != mask) {
+			return BSEC_ERROR;
+		}
+
+		otp += nb;
+	}
+#endif
+
+	return BSEC_OK;
+}
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
 #include <drivers/clk.h>
@@ -14,11 +15,13 @@
 #include <drivers/st/stm32mp_clkfunc.h>
 #include <lib/mmio.h>
 #include <lib/spinlock.h>
+#include <lib/utils.h>
 
 #include "clk-stm32-core.h"
 
-static struct spinlock reg_lock;
-static struct spinlock refcount_lock;
+static struct ticketlock reg_lock;
+static struct ticketlock refcount_lock;
+static struct ticketlock rate_lock;
 
 static struct stm32_clk_priv *stm32_clock_data;
 
@@ -29,18 +32,19 @@ struct stm32_clk_priv *clk_stm32_get_priv(void)
 	return stm32_clock_data;
 }
 
-static void stm32mp1_clk_lock(struct spinlock *lock)
+/* Ticket locks, both cores being served in turn on RCC accesses */
+static void stm32mp1_clk_lock(struct ticketlock *lock)
 {
 	if (stm32mp_lock_available()) {
 		/* Assume interrupts are masked */
-		spin_lock(lock);
+		ticket_lock(lock);
 	}
 }
 
-static void stm32mp1_clk_unlock(struct spinlock *lock)
+static void stm32mp1_clk_unlock(struct ticketlock *lock)
 {
 	if (stm32mp_lock_available()) {
-		spin_unlock(lock);
+		ticket_unlock(lock);
 	}
 }
 
@@ -54,6 +58,64 @@ void stm32mp1_clk_rcc_regs_unlock(void)
 	stm32mp1_clk_unlock(&reg_lock);
 }
 
+/*
+ * Rates and mux selections are cached once the clock tree is configured. A
+ * zero entry is not cached, mux entries hold the selection plus one.
+ * Invalidation bumps the generation so that a value computed from registers
+ * read before a change is not stored afterwards.
+ */
+static bool rate_cache_enabled;
+static unsigned int rate_cache_gen;
+
+void clk_stm32_rate_cache_invalidate(struct stm32_clk_priv *priv)
+{
+	if (!rate_cache_enabled) {
+		return;
+	}
+
+	stm32mp1_clk_lock(&rate_lock);
+	rate_cache_gen++;
+	zeromem(priv->rate_cache, priv->num * sizeof(*priv->rate_cache));
+	if (priv->mux_cache != NULL) {
+		zeromem(priv->mux_cache, priv->nb_parents);
+	}
+	stm32mp1_clk_unlock(&rate_lock);
+}
+
+void clk_stm32_rate_cache_enable(struct stm32_clk_priv *priv)
+{
+	if (priv->rate_cache == NULL) {
+		return;
+	}
+
+	zeromem(priv->rate_cache, priv->num * sizeof(*priv->rate_cache));
+	if (priv->mux_cache != NULL) {
+		zeromem(priv->mux_cache, priv->nb_parents);
+	}
+	rate_cache_enabled = true;
+}
+
+static void clk_stm32_rate_cache_store(struct stm32_clk_priv *priv, int id,
+				       unsigned int gen, unsigned long rate)
+{
+	stm32mp1_clk_lock(&rate_lock);
+	if (gen == rate_cache_gen) {
+		priv->rate_cache[id] = rate;
+	}
+	stm32mp1_clk_unlock(&rate_lock);
+}
+
+static void clk_stm32_mux_cache_store(struct stm32_clk_priv *priv,
+				      uint32_t mux_id, unsigned int gen,
+				      uint32_t sel)
+{
+	stm32mp1_clk_lock(&rate_lock);
+	if (gen == rate_cache_gen) {
+		priv->mux_cache[mux_id] = (uint8_t)(sel + 1U);
+	}
+	stm32mp1_clk_unlock(&rate_lock);
+}
+
 #define TIMEOUT_US_1S	U(1000000)
 #define OSCRDY_TIMEOUT	TIMEOUT_US_1S
 
@@ -279,6 +341,8 @@ int clk_mux_set_parent(struct stm32_clk_priv *priv, uint16_t pid, uint8_t sel)
 
 	mmio_clrsetbits_32(address, mask, (sel << mux->shift) & mask);
 
+	clk_stm32_rate_cache_invalidate(priv);
+
 	if (mux->bitrdy == MUX_NO_BIT_RDY) {
 		return 0;
 	}
@@ -350,18 +414,36 @@ int clk_mux_get_parent(struct stm32_clk_priv *priv, uint32_t mux_id)
 {
 	const struct parent_cfg *parent;
 	const struct mux_cfg *mux;
+	bool use_cache = rate_cache_enabled && (priv->mux_cache != NULL);
+	unsigned int gen = 0U;
 	uint32_t mask;
+	uint32_t sel;
 
 	if (mux_id >= priv->nb_parents) {
 		panic();
 	}
 
+	if (use_cache) {
+		if (priv->mux_cache[mux_id] != 0U) {
+			return (int)priv->mux_cache[mux_id] - 1;
+		}
+
+		gen = rate_cache_gen;
+		dmbish();
+	}
+
 	parent = &priv->parents[mux_id];
 	mux = parent->mux;
 
 	mask = MASK_WIDTH_SHIFT(mux->width, mux->shift);
 
-	return (mmio_read_32(priv->base + mux->offset) & mask) >> mux->shift;
+	sel = (mmio_read_32(priv->base + mux->offset) & mask) >> mux->shift;
+
+	if (use_cache) {
+		clk_stm32_mux_cache_store(priv, mux_id, gen, sel);
+	}
+
+	return (int)sel;
 }
 
 int _clk_stm32_set_parent_by_index(struct stm32_clk_priv *priv, int clk, int sel)
@@ -455,6 +537,12 @@ int clk_get_index(struct stm32_clk_priv *priv, unsigned long binding_id)
 {
 	unsigned int i;
 
+	/* Index table entries hold the clock index plus one, built at init */
+	if ((binding_id < priv->nb_binding) &&
+	    (priv->binding_index[binding_id] != 0U)) {
+		return (int)priv->binding_index[binding_id] - 1;
+	}
+
 	for (i = 0U; i < priv->num; i++) {
 		if (binding_id == priv->clks[i].binding) {
 			return (int)i;
@@ -464,16 +552,12 @@ int clk_get_index(struct stm32_clk_priv *priv, unsigned long binding_id)
 	return -EINVAL;
 }
 
-unsigned long _clk_stm32_get_rate(struct stm32_clk_priv *priv, int id)
+static unsigned long clk_stm32_recalc_rate(struct stm32_clk_priv *priv, int id)
 {
 	const struct clk_stm32 *clk = _clk_get(priv, id);
 	int parent;
 	unsigned long rate = 0UL;
 
-	if ((unsigned int)id >= priv->num) {
-		return rate;
-	}
-
 	parent = _clk_stm32_get_parent(priv, id);
 	if (parent < 0) {
 		return 0UL;
@@ -503,6 +587,34 @@ unsigned long _clk_stm32_get_rate(struct stm32_clk_priv *priv, int id)
 
 }
 
+unsigned long _clk_stm32_get_rate(struct stm32_clk_priv *priv, int id)
+{
+	unsigned long rate;
+	unsigned int gen;
+
+	if ((unsigned int)id >= priv->num) {
+		return 0UL;
+	}
+
+	if (!rate_cache_enabled) {
+		return clk_stm32_recalc_rate(priv, id);
+	}
+
+	rate = priv->rate_cache[id];
+	if (rate != 0UL) {
+		return rate;
+	}
+
+	gen = rate_cache_gen;
+	dmbish();
+
+	rate = clk_stm32_recalc_rate(priv, id);
+
+	clk_stm32_rate_cache_store(priv, id, gen, rate);
+
+	return rate;
+}
+
 unsigned long _clk_stm32_get_parent_rate(struct stm32_clk_priv *priv, int id)
 {
 	int parent_id = _clk_stm32_get_parent(priv, id);
@@ -534,6 +646,7 @@ int clk_stm32_enable_call_ops(struct stm32_clk_priv *priv, uint16_t id)
 
 	if (clk->ops->enable != NULL) {
 		clk->ops->enable(priv, id);
+		clk_stm32_rate_cache_invalidate(priv);
 	}
 
 	return 0;
@@ -585,6 +698,7 @@ void clk_stm32_disable_call_ops(struct stm32_clk_priv *priv, uint16_t id)
 
 	if (clk->ops->disable != NULL) {
 		clk->ops->disable(priv, id);
+		clk_stm32_rate_cache_invalidate(priv);
 	}
 }
 
@@ -783,6 +897,8 @@ int clk_stm32_set_div(struct stm32_clk_priv *priv, uint32_t div_id, uint32_t val
 	mask = MASK_WIDTH_SHIFT(divider->width, divider->shift);
 	mmio_clrsetbits_32(address, mask, (value << divider->shift) & mask);
 
+	clk_stm32_rate_cache_invalidate(priv);
+
 	if (divider->bitrdy == DIV_NO_BIT_RDY) {
 		return 0;
 	}
@@ -1097,6 +1213,12 @@ int clk_stm32_init(struct stm32_clk_priv *priv, uintptr_t base)
 		if (clk->ops->init != NULL) {
 			clk->ops->init(priv, i);
 		}
+
+		if ((clk->binding < priv->nb_binding) &&
+		    (priv->binding_index[clk->binding] == 0U)) {
+			assert(i < UINT16_MAX);
+			priv->binding_index[clk->binding] = (uint16_t)(i + 1U);
+		}
 	}
 
 	stm32_clk_register();
@@ -74,6 +74,10 @@ struct stm32_clk_priv {
 	struct clk_oscillator_data *osci_data;
 	const uint32_t nb_osci_data;
 	uint32_t *gate_refcounts;
+	unsigned long *rate_cache;
+	uint8_t *mux_cache;
+	uint16_t *binding_index;
+	const uint32_t nb_binding;
 	void *pdata;
 };
 
@@ -146,6 +150,8 @@ struct clk_gate_cfg {
 
 int clk_stm32_init(struct stm32_clk_priv *priv, uintptr_t base);
 void clk_stm32_enable_critical_clocks(void);
+void clk_stm32_rate_cache_enable(struct stm32_clk_priv *priv);
+void clk_stm32_rate_cache_invalidate(struct stm32_clk_priv *priv);
 
 struct stm32_clk_priv *clk_stm32_get_priv(void);
 
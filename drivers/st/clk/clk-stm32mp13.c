@@ -950,6 +950,9 @@ static bool pll4_bootrom;
 
 /* RCC clock device driver private */
 static unsigned int refcounts_mp13[CK_LAST];
+static unsigned long rates_mp13[CK_LAST];
+static uint8_t mux_sel_mp13[ARRAY_SIZE(parent_mp13)];
+static uint16_t binding_index_mp13[STM32MP1_LAST_CLK];
 
 static const struct stm32_clk_pll *clk_st32_pll_data(unsigned int idx);
 
@@ -2031,6 +2034,10 @@ static struct stm32_clk_priv stm32mp13_clock_data = {
 	.osci_data	= stm32mp13_osc_data,
 	.nb_osci_data	= ARRAY_SIZE(stm32mp13_osc_data),
 	.gate_refcounts	= refcounts_mp13,
+	.rate_cache	= rates_mp13,
+	.mux_cache	= mux_sel_mp13,
+	.binding_index	= binding_index_mp13,
+	.nb_binding	= ARRAY_SIZE(binding_index_mp13),
 	.pdata		= &stm32mp13_clock_pdata,
 };
 
@@ -2374,5 +2381,8 @@ int stm32mp1_clk_probe(void)
 
 	clk_stm32_enable_critical_clocks();
 
+	/* PLLs and oscillators are no more reconfigured: cache the rates */
+	clk_stm32_rate_cache_enable(&stm32mp13_clock_data);
+
 	return 0;
 }
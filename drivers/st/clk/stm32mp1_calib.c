@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2019-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (C) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -27,9 +28,20 @@
 #include <lib/utils_def.h>
 #include <plat/common/platform.h>
 
+#include <stm32mp_sec_timer.h>
+
 #define TIMEOUT_10MS	10000
 #define CALIB_TIMEOUT	TIMEOUT_10MS
 
+/* Periodic calibration interval is doubled up to 8 times the DT period */
+#define CALIB_PERIOD_SHIFT_MAX	3U
+
+/* Periodic calibration can be delayed by 1/8 of its period */
+#define CALIB_SLACK_SHIFT	3U
+
+/* Input periods averaged by an asynchronous frequency measurement */
+#define CALIB_ASYNC_CAPTURES	16U
+
 struct stm32mp1_trim_boundary_t {
 	/* Max boundary trim value around forbidden value */
 	unsigned int x1;
@@ -121,7 +133,20 @@ static struct stm32mp1_clk_cal stm32mp1_clk_cal_csi = {
 	.get_trim = csi_get_trimed_cal,
 };
 
-static uint32_t timer_val;
+static struct stm32mp1_clk_cal *const calib_clk[] = {
+	[HSI_CAL] = &stm32mp1_clk_cal_hsi,
+	[CSI_CAL] = &stm32mp1_clk_cal_csi,
+};
+
+static uint64_t timer_val;
+static unsigned int timer_shift;
+static int timer_id = -1;
+
+/* Calibration sequence in progress, waiting for frequency measurements */
+static spinlock_t calib_lock;
+static bool calib_running;
+static bool calib_periodic;
+static bool calib_trimmed;
 
 /*
  * HSI Calibration part
@@ -177,132 +202,206 @@ static unsigned int csi_get_trimed_cal(void)
 		(int)stm32mp1_clk_cal_csi.cal_ref - 1;
 }
 
-static unsigned int trim_increase(struct stm32mp1_clk_cal *clk_cal,
+/*
+ * Allowed calibration values are indexed in increasing order, skipping the
+ * forbidden values: the frequency increases with the index.
+ */
+static unsigned int trim_count(struct stm32mp1_clk_cal *clk_cal)
+{
+	unsigned int count = 0U;
+	unsigned int i;
+
+	for (i = 0U; i < clk_cal->boundary_max; i++) {
+		count += clk_cal->boundary[i].x1 - clk_cal->boundary[i].x2 + 1U;
+	}
+
+	return count;
+}
+
+static unsigned int trim_to_index(struct stm32mp1_clk_cal *clk_cal,
 				  unsigned int cal)
 {
 	struct stm32mp1_trim_boundary_t *boundary;
-	unsigned int new_cal;
+	unsigned int idx = 0U;
 	int i;
 
-	/* By default: last calibration value */
-	new_cal = cal;
-
 	/* Start from Lowest cal value */
 	for (i = (int)clk_cal->boundary_max - 1; i >= 0; i--) {
 		boundary = &clk_cal->boundary[i];
 
 		if (cal < boundary->x2) {
-			new_cal = boundary->x2;
-			break;
+			/* Forbidden value: take the next allowed one */
+			return idx;
 		}
 
-		if ((cal >= boundary->x2) && (cal < boundary->x1)) {
-			new_cal = cal + 1;
-			break;
+		if (cal <= boundary->x1) {
+			return idx + cal - boundary->x2;
 		}
+
+		idx += boundary->x1 - boundary->x2 + 1U;
 	}
 
-	return new_cal;
+	return idx - 1U;
 }
 
-static unsigned int trim_decrease(struct stm32mp1_clk_cal *clk_cal,
-				  unsigned int cal)
+static unsigned int index_to_trim(struct stm32mp1_clk_cal *clk_cal,
+				  unsigned int idx)
 {
 	struct stm32mp1_trim_boundary_t *boundary;
-	unsigned int new_cal;
-	unsigned int i;
+	int i;
 
-	/* By default: last calibration value */
-	new_cal = cal;
+	/* Start from Lowest cal value */
+	for (i = (int)clk_cal->boundary_max - 1; i >= 0; i--) {
+		unsigned int count;
 
-	/* Start from Highest cal value */
-	for (i = 0; i < clk_cal->boundary_max; i++) {
 		boundary = &clk_cal->boundary[i];
+		count = boundary->x1 - boundary->x2 + 1U;
 
-		if (cal > boundary->x1) {
-			new_cal = boundary->x1;
-			break;
+		if (idx < count) {
+			return boundary->x2 + idx;
 		}
 
-		if ((cal > boundary->x2) && (cal <= boundary->x1)) {
-			new_cal = cal - 1;
-			break;
-		}
+		idx -= count;
 	}
 
-	return new_cal;
+	return clk_cal->boundary[0].x1;
+}
+
+static unsigned long trim_measure(struct stm32mp1_clk_cal *clk_cal,
+				  unsigned int idx)
+{
+	clk_cal->set_trim(index_to_trim(clk_cal, idx));
+
+	return clk_cal->get_freq();
 }
 
-static void rcc_calibration(struct stm32mp1_clk_cal *clk_cal)
+static unsigned long freq_delta(unsigned long freq, unsigned long ref)
 {
-	unsigned long freq = clk_cal->get_freq();
-	unsigned long min = clk_cal->ref_freq -
-		((clk_cal->ref_freq * clk_cal->freq_margin) / 1000);
-	unsigned long max = clk_cal->ref_freq +
-		((clk_cal->ref_freq * clk_cal->freq_margin) / 1000);
-	int trim, new_trim;
-	unsigned long conv;
-	unsigned long min_conv = ULONG_MAX;
+	return (ref < freq) ? freq - ref : ref - freq;
+}
+
+/*
+ * Calibrate the oscillator when its measured frequency is out of the margin.
+ * The reference frequency is bracketed from the current trim value with a
+ * step doubled at each measurement, then located by a binary search over
+ * the allowed trim values. Return true when the trim value was updated.
+ */
+static bool rcc_calibration_freq(struct stm32mp1_clk_cal *clk_cal,
+				 unsigned long freq)
+{
+	unsigned long ref = clk_cal->ref_freq;
+	unsigned long min = ref - ((ref * clk_cal->freq_margin) / 1000);
+	unsigned long max = ref + ((ref * clk_cal->freq_margin) / 1000);
+	unsigned long freq_lo, freq_hi;
+	unsigned int count = trim_count(clk_cal);
+	unsigned int lo, hi, step, idx;
 	uint64_t start;
 
-	if ((freq >= min) && (freq <= max)) {
-		return;
+	if (((freq >= min) && (freq <= max)) || (count == 0U)) {
+		return false;
+	}
+
+	idx = trim_to_index(clk_cal, clk_cal->get_trim());
+	if (index_to_trim(clk_cal, idx) != clk_cal->get_trim()) {
+		freq = trim_measure(clk_cal, idx);
 	}
 
-	trim = clk_cal->get_trim();
+	lo = idx;
+	hi = idx;
+	freq_lo = freq;
+	freq_hi = freq;
+	step = 1U;
 	start = timeout_init_us(CALIB_TIMEOUT);
-	do {
-		if (freq < clk_cal->ref_freq) {
-			new_trim = trim_increase(clk_cal, trim);
-		} else {
-			new_trim = trim_decrease(clk_cal, trim);
+
+	/* Bracket the reference frequency between lo and hi */
+	while ((freq_hi < ref) && (hi < (count - 1U))) {
+		lo = hi;
+		freq_lo = freq_hi;
+		hi = MIN(lo + step, count - 1U);
+		freq_hi = trim_measure(clk_cal, hi);
+		step <<= 1;
+		if ((freq_hi == 0U) || timeout_elapsed(start)) {
+			goto out;
 		}
+	}
 
-		clk_cal->set_trim(new_trim);
-		freq = clk_cal->get_freq();
-		if (freq == 0U) {
-			/* Calibration will be stopped */
-			clk_cal->ref_freq = 0U;
-			return;
+	while ((freq_lo > ref) && (lo > 0U)) {
+		hi = lo;
+		freq_hi = freq_lo;
+		lo = (lo > step) ? lo - step : 0U;
+		freq_lo = trim_measure(clk_cal, lo);
+		step <<= 1;
+		if ((freq_lo == 0U) || timeout_elapsed(start)) {
+			goto out;
+		}
+	}
+
+	while (((hi - lo) > 1U) && (freq_lo <= ref) && (freq_hi >= ref)) {
+		unsigned int mid = lo + ((hi - lo) / 2U);
+		unsigned long freq_mid = trim_measure(clk_cal, mid);
+
+		if (freq_mid == 0U) {
+			goto out;
 		}
-		conv = (clk_cal->ref_freq < freq) ?
-			freq - clk_cal->ref_freq : clk_cal->ref_freq - freq;
-		if (conv < min_conv) {
-			min_conv = conv;
-			trim = new_trim;
+
+		if (freq_mid < ref) {
+			lo = mid;
+			freq_lo = freq_mid;
+		} else {
+			hi = mid;
+			freq_hi = freq_mid;
 		}
 
 		if (timeout_elapsed(start)) {
 			break;
 		}
+	}
+
+out:
+	if ((freq_lo == 0U) || (freq_hi == 0U)) {
+		/* Calibration will be stopped */
+		clk_cal->ref_freq = 0U;
+		return false;
+	}
 
-	} while (conv == min_conv);
+	idx = (freq_delta(freq_lo, ref) <= freq_delta(freq_hi, ref)) ? lo : hi;
 
-	clk_cal->set_trim(trim);
+	clk_cal->set_trim(index_to_trim(clk_cal, idx));
 	freq = clk_cal->get_freq();
 
 	if ((freq < min) || (freq > max)) {
 		ERROR("%s Calibration : Freq %lu, trim %i\n",
 		      (clk_cal->set_trim == hsi_set_trim) ? "HSI" : "CSI",
-		      freq, trim);
+		      freq, index_to_trim(clk_cal, idx));
 #if DEBUG
 		/*
 		 * Show the steps around the selected trim value
 		 * to correct the margin if needed
 		 */
-		new_trim = trim_decrease(clk_cal, trim);
-		clk_cal->set_trim(new_trim);
-		ERROR("%s Calibration : Freq %lu, trim %i\n",
-		      (clk_cal->set_trim == hsi_set_trim) ?
-		      "HSI" : "CSI", clk_cal->get_freq(), new_trim);
+		if (idx > 0U) {
+			ERROR("%s Calibration : Freq %lu, trim %i\n",
+			      (clk_cal->set_trim == hsi_set_trim) ?
+			      "HSI" : "CSI", trim_measure(clk_cal, idx - 1U),
+			      index_to_trim(clk_cal, idx - 1U));
+		}
 
-		new_trim = trim_increase(clk_cal, trim);
-		clk_cal->set_trim(new_trim);
-		ERROR("%s Calibration : Freq %lu, trim %i\n",
-		      (clk_cal->set_trim == hsi_set_trim) ?
-		      "HSI" : "CSI", clk_cal->get_freq(), new_trim);
+		if (idx < (count - 1U)) {
+			ERROR("%s Calibration : Freq %lu, trim %i\n",
+			      (clk_cal->set_trim == hsi_set_trim) ?
+			      "HSI" : "CSI", trim_measure(clk_cal, idx + 1U),
+			      index_to_trim(clk_cal, idx + 1U));
+		}
+
+		clk_cal->set_trim(index_to_trim(clk_cal, idx));
 #endif
 	}
+
+	return true;
+}
+
+static bool rcc_calibration(struct stm32mp1_clk_cal *clk_cal)
+{
+	return rcc_calibration_freq(clk_cal, clk_cal->get_freq());
 }
 
 static void save_trim(struct stm32mp1_clk_cal *clk_cal,
@@ -391,6 +490,97 @@ void stm32mp1_calib_set_wakeup(bool state)
 	rcc_wakeup = state;
 }
 
+static void calibrate_done(void)
+{
+	if (timer_id >= 0) {
+		/*
+		 * Lengthen the interval while the oscillators stay in their
+		 * margin, get back to the DT period on the first drift.
+		 */
+		if (calib_trimmed) {
+			timer_shift = 0U;
+		} else if (calib_periodic &&
+			   (timer_shift < CALIB_PERIOD_SHIFT_MAX)) {
+			timer_shift++;
+		}
+
+		stm32mp_sec_timer_arm((unsigned int)timer_id,
+				      timer_val << timer_shift);
+	}
+
+	spin_lock(&calib_lock);
+	calib_running = false;
+	spin_unlock(&calib_lock);
+}
+
+static void calib_freq_cb(enum timer_cal type, unsigned long freq);
+
+/*
+ * Check the oscillators from the given one. The frequency is measured on the
+ * timer interrupts, the sequence goes on from the completion callback. The
+ * blocking trim search only runs for an oscillator out of its margin, or when
+ * the timer cannot measure asynchronously.
+ */
+static void calibrate_from(enum timer_cal type)
+{
+	enum timer_cal i;
+
+	for (i = type; i <= CSI_CAL; i++) {
+		if (calib_clk[i]->ref_freq == 0U) {
+			continue;
+		}
+
+		if (stm32_timer_freq_async(i, CALIB_ASYNC_CAPTURES,
+					   calib_freq_cb) == 0) {
+			return;
+		}
+
+		calib_trimmed |= rcc_calibration(calib_clk[i]);
+	}
+
+	calibrate_done();
+}
+
+static void calib_freq_cb(enum timer_cal type, unsigned long freq)
+{
+	struct stm32mp1_clk_cal *clk_cal = calib_clk[type];
+
+	if (freq != 0U) {
+		calib_trimmed |= rcc_calibration_freq(clk_cal, freq);
+	} else {
+		calib_trimmed |= rcc_calibration(clk_cal);
+	}
+
+	if (type == HSI_CAL) {
+		calibrate_from(CSI_CAL);
+	} else {
+		calibrate_done();
+	}
+}
+
+static void calibrate(bool periodic)
+{
+	spin_lock(&calib_lock);
+	if (calib_running) {
+		/* The sequence in progress re-arms the periodic timer */
+		spin_unlock(&calib_lock);
+		return;
+	}
+
+	calib_running = true;
+	spin_unlock(&calib_lock);
+
+	calib_periodic = periodic;
+	calib_trimmed = false;
+
+	calibrate_from(HSI_CAL);
+}
+
+static void calib_timer_task(void)
+{
+	calibrate(true);
+}
+
 void stm32mp1_calib_it_handler(uint32_t id)
 {
 	uintptr_t rcc_base = stm32mp_rcc_base();
@@ -418,42 +608,47 @@ void stm32mp1_calib_it_handler(uint32_t id)
 
 		break;
 
-	case ARM_IRQ_SEC_PHY_TIMER:
 	default:
 		break;
 	}
 
-	if (stm32mp1_clk_cal_hsi.ref_freq != 0U) {
-		rcc_calibration(&stm32mp1_clk_cal_hsi);
-	}
+	calibrate(false);
+}
 
-	if (stm32mp1_clk_cal_csi.ref_freq != 0U) {
-		rcc_calibration(&stm32mp1_clk_cal_csi);
+/* Calibrate an oscillator on request, unless the calibration is running */
+static int calib_start(struct stm32mp1_clk_cal *clk_cal)
+{
+	if (clk_cal->ref_freq == 0U) {
+		return -ENOENT;
 	}
 
-	if (timer_val != 0U) {
-		write_cntp_tval(timer_val);
+	spin_lock(&calib_lock);
+	if (calib_running) {
+		/* The sequence in progress checks this oscillator */
+		spin_unlock(&calib_lock);
+		return 0;
 	}
+
+	calib_running = true;
+	spin_unlock(&calib_lock);
+
+	rcc_calibration(clk_cal);
+
+	spin_lock(&calib_lock);
+	calib_running = false;
+	spin_unlock(&calib_lock);
+
+	return 0;
 }
 
 int stm32mp1_calib_start_hsi_cal(void)
 {
-	if (stm32mp1_clk_cal_hsi.ref_freq == 0U) {
-		return -ENOENT;
-	}
-
-	rcc_calibration(&stm32mp1_clk_cal_hsi);
-	return 0;
+	return calib_start(&stm32mp1_clk_cal_hsi);
 }
 
 int stm32mp1_calib_start_csi_cal(void)
 {
-	if (stm32mp1_clk_cal_csi.ref_freq == 0U) {
-		return -ENOENT;
-	}
-
-	rcc_calibration(&stm32mp1_clk_cal_csi);
-	return 0;
+	return calib_start(&stm32mp1_clk_cal_csi);
 }
 
 static void init_hsi_cal(void)
@@ -515,20 +710,21 @@ void stm32mp1_calib_init(void)
 	init_hsi_cal();
 	init_csi_cal();
 
-	timer_val = fdt_rcc_read_uint32_default("st,cal-sec", 0) *
+	timer_val = (uint64_t)fdt_rcc_read_uint32_default("st,cal-sec", 0) *
 		plat_get_syscnt_freq2();
 
-	if (timer_val > INT32_MAX) {
-		timer_val = INT32_MAX;
-	}
+	if (timer_val != 0ULL) {
+		timer_id = stm32mp_sec_timer_register(calib_timer_task,
+						      timer_val >>
+						      CALIB_SLACK_SHIFT);
+		if (timer_id < 0) {
+			panic();
+		}
 
-	if (timer_val != 0U) {
-		/* Load & enable timer */
 		INFO("Set calibration timer to %u sec\n",
-		     timer_val / plat_get_syscnt_freq2());
-		write_cntp_tval(timer_val);
-		write_cntp_ctl(BIT(0));
-	};
+		     (unsigned int)(timer_val / plat_get_syscnt_freq2()));
+		stm32mp_sec_timer_arm((unsigned int)timer_id, timer_val);
+	}
 
 	if (fdt_rcc_enable_it("mcu_sev") < 0) {
 		VERBOSE("No MCU calibration\n");
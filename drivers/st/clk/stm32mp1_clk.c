@@ -24,6 +24,7 @@
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_rcc.h>
 #include <dt-bindings/clock/stm32mp1-clksrc.h>
+#include <lib/cassert.h>
 #include <lib/mmio.h>
 #include <lib/spinlock.h>
 #include <lib/utils_def.h>
@@ -397,6 +398,9 @@ static const struct stm32mp1_clk_gate stm32mp1_clk_gate[] = {
 	_CLK_SC_SELEC(N_S, RCC_MP_APB2ENSETR, 13, USART6_K, _UART6_SEL),
 
 	_CLK_SC_FIXED(N_S, RCC_MP_APB3ENSETR, 11, SYSCFG, _UNKNOWN_ID),
+#if defined(IMAGE_BL32)
+	_CLK_SC_FIXED(N_S, RCC_MP_APB3ENSETR, 16, TMPSENS, _PCLK3),
+#endif
 
 	_CLK_SC_SELEC(N_S, RCC_MP_APB4ENSETR, 8, DDRPERFM, _UNKNOWN_SEL),
 	_CLK_SC_SELEC(N_S, RCC_MP_APB4ENSETR, 15, IWDG2, _UNKNOWN_SEL),
@@ -417,6 +421,8 @@ static const struct stm32mp1_clk_gate stm32mp1_clk_gate[] = {
 #if defined(IMAGE_BL32)
 	_CLK_SC_SELEC(N_S, RCC_MP_AHB2ENSETR, 8, USBO_K, _USBO_SEL),
 	_CLK_SC_SELEC(N_S, RCC_MP_AHB2ENSETR, 16, SDMMC3_K, _SDMMC3_SEL),
+
+	_CLK_SC_FIXED(N_S, RCC_MP_AHB3ENSETR, 12, IPCC, _UNKNOWN_ID),
 #endif
 
 	_CLK_SC_SELEC(N_S, RCC_MP_AHB4ENSETR, 0, GPIOA, _UNKNOWN_SEL),
@@ -652,12 +658,29 @@ static const char * const stm32mp1_clk_parent_name[_PARENT_NB] __unused = {
 
 /* RCC clock device driver private */
 static unsigned long stm32mp1_osc[NB_OSC];
-static struct spinlock reg_lock;
+static struct ticketlock reg_lock;
 static unsigned int gate_refcounts[NB_GATES];
-static struct spinlock refcount_lock;
+/* Gate index plus one for each clock binding ID, built at probe */
+static uint8_t gate_index[STM32MP1_LAST_CLK];
+static struct ticketlock refcount_lock;
 static struct stm32mp1_pll_settings pll1_settings;
+/* LSE started at clock init, not yet awaited, and its CSS request */
+static bool lse_pending;
+static bool lse_pending_css;
 static uint32_t current_opp_khz;
 #if defined(IMAGE_BL32)
+/*
+ * PLL1 registers values of each OPP of pll1_settings, built on the first OPP
+ * change, so that changing OPP needs no computation.
+ */
+static struct stm32mp1_pll1_opp_regs {
+	uint32_t cfgr1;
+	uint32_t cfgr2;
+	uint32_t fracr;
+} pll1_opp_regs[PLAT_MAX_OPP_NB];
+static bool pll1_opp_regs_valid;
+/* PLL1 P output frequency as set for an OPP, 0 if not known */
+static uint32_t pll1_p_khz;
 static uint32_t save_current_opp_khz;
 static uint32_t pll3cr;
 static uint32_t pll4cr;
@@ -687,18 +710,19 @@ static const struct stm32mp1_clk_pll *pll_ref(unsigned int idx)
 	return &stm32mp1_clk_pll[idx];
 }
 
-static void stm32mp1_clk_lock(struct spinlock *lock)
+/* Ticket locks, both cores being served in turn on RCC accesses */
+static void stm32mp1_clk_lock(struct ticketlock *lock)
 {
 	if (stm32mp_lock_available()) {
 		/* Assume interrupts are masked */
-		spin_lock(lock);
+		ticket_lock(lock);
 	}
 }
 
-static void stm32mp1_clk_unlock(struct spinlock *lock)
+static void stm32mp1_clk_unlock(struct ticketlock *lock)
 {
 	if (stm32mp_lock_available()) {
-		spin_unlock(lock);
+		ticket_unlock(lock);
 	}
 }
 
@@ -737,10 +761,29 @@ static unsigned long stm32mp1_clk_get_fixed(enum stm32mp_osc_id idx)
 	return stm32mp1_osc[idx];
 }
 
+CASSERT(NB_GATES < UINT8_MAX, assert_stm32mp1_clk_gate_index);
+
+static void stm32mp1_clk_index_gates(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < NB_GATES; i++) {
+		unsigned int id = gate_ref(i)->index;
+
+		if ((id < ARRAY_SIZE(gate_index)) && (gate_index[id] == 0U)) {
+			gate_index[id] = (uint8_t)(i + 1U);
+		}
+	}
+}
+
 static int stm32mp1_clk_get_gated_id(unsigned long id)
 {
 	unsigned int i;
 
+	if ((id < ARRAY_SIZE(gate_index)) && (gate_index[id] != 0U)) {
+		return (int)gate_index[id] - 1;
+	}
+
 	for (i = 0U; i < NB_GATES; i++) {
 		if (gate_ref(i)->index == id) {
 			return i;
@@ -1146,6 +1189,13 @@ static void __stm32mp1_clk_enable(unsigned long id, bool with_refcnt)
 	const struct stm32mp1_clk_gate *gate;
 	int i;
 
+	/* The RTC is clocked by its own source, that is most often LSE */
+	if (lse_pending &&
+	    ((id == RTC) || (id == RTCAPB) ||
+	     (stm32mp1_clk_get_parent(id) == (int)_LSE))) {
+		stm32mp1_clk_lse_wait_ready();
+	}
+
 	if (clock_is_always_on(id)) {
 		return;
 	}
@@ -1407,6 +1457,28 @@ static void stm32mp1_lse_wait(void)
 	}
 }
 
+/*
+ * The LSE crystal may take hundreds of milliseconds to start. Clock init does
+ * not wait for it: it is awaited when a clock it feeds is first enabled, and
+ * at the latest before leaving BL2. The LSE CSS can only be enabled once the
+ * LSE is ready.
+ */
+void stm32mp1_clk_lse_wait_ready(void)
+{
+	if (!lse_pending) {
+		return;
+	}
+
+	stm32mp1_lse_wait();
+
+	if (lse_pending_css) {
+		mmio_setbits_32(stm32mp_rcc_base() + RCC_BDCR,
+				RCC_BDCR_LSECSSON);
+	}
+
+	lse_pending = false;
+}
+
 static void stm32mp1_lsi_set(bool enable)
 {
 	stm32mp1_ls_osc_set(enable, RCC_RDLSICR, RCC_RDLSICR_LSION);
@@ -1916,57 +1988,15 @@ int stm32mp1_round_opp_khz(uint32_t *freq_khz)
 	return 0;
 }
 
-/*
- * Check if PLL1 can be configured on the fly.
- * @result (-1) => config on the fly is not possible.
- *         (0)  => config on the fly is possible.
- *         (+1) => same parameters, no need to reconfigure.
- * Return value is 0 if no error.
- */
-static int stm32mp1_is_pll_config_on_the_fly(enum stm32mp1_pll_id pll_id,
-					     uint32_t *pllcfg, uint32_t fracv,
-					     int *result)
-{
-	const struct stm32mp1_clk_pll *pll = pll_ref(pll_id);
-	uintptr_t rcc_base = stm32mp_rcc_base();
-	uint32_t fracr;
-	uint32_t value;
-	int ret;
-
-	ret = stm32mp1_pll_compute_pllxcfgr1(pll, pllcfg, &value);
-	if (ret != 0) {
-		return ret;
-	}
-
-	if (mmio_read_32(rcc_base + pll->pllxcfgr1) != value) {
-		/* Different DIVN/DIVM, can't config on the fly */
-		*result = -1;
-		return 0;
-	}
-
-	*result = true;
-
-	fracr = fracv << RCC_PLLNFRACR_FRACV_SHIFT;
-	fracr |= RCC_PLLNFRACR_FRACLE;
-	value = stm32mp1_pll_compute_pllxcfgr2(pllcfg);
-
-	if ((mmio_read_32(rcc_base + pll->pllxfracr) == fracr) &&
-	    (mmio_read_32(rcc_base + pll->pllxcfgr2) == value)) {
-		/* Same parameters, no need to config */
-		*result = 1;
-	} else {
-		*result = 0;
-	}
-
-	return 0;
-}
-
 static int stm32mp1_get_mpu_div(uint32_t freq_khz)
 {
-	unsigned long freq_pll1_p;
+	unsigned long freq_pll1_p = pll1_p_khz;
 	unsigned long div;
 
-	freq_pll1_p = get_clock_rate(_PLL1_P) / 1000UL;
+	if (freq_pll1_p == 0UL) {
+		freq_pll1_p = get_clock_rate(_PLL1_P) / 1000UL;
+	}
+
 	if ((freq_pll1_p % freq_khz) != 0U) {
 		return -1;
 	}
@@ -1985,12 +2015,65 @@ static int stm32mp1_get_mpu_div(uint32_t freq_khz)
 	}
 }
 
+static int stm32mp1_pll1_build_opp_regs(void)
+{
+	const struct stm32mp1_clk_pll *pll = pll_ref(_PLL1);
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < PLAT_MAX_OPP_NB; i++) {
+		struct stm32mp1_pll1_opp_regs *regs = &pll1_opp_regs[i];
+
+		if (pll1_settings.freq[i] == 0U) {
+			continue;
+		}
+
+		ret = stm32mp1_pll_compute_pllxcfgr1(pll,
+						     &pll1_settings.cfg[i][0],
+						     &regs->cfgr1);
+		if (ret != 0) {
+			return ret;
+		}
+
+		regs->cfgr2 =
+			stm32mp1_pll_compute_pllxcfgr2(&pll1_settings.cfg[i][0]);
+		regs->fracr = (pll1_settings.frac[i] <<
+			       RCC_PLLNFRACR_FRACV_SHIFT) |
+			      RCC_PLLNFRACR_FRACLE;
+	}
+
+	pll1_opp_regs_valid = true;
+
+	return 0;
+}
+
+/* Same sequence as stm32mp1_pll_config(), from precomputed values */
+static void
+stm32mp1_pll1_write_opp_regs(const struct stm32mp1_pll1_opp_regs *regs)
+{
+	const struct stm32mp1_clk_pll *pll = pll_ref(_PLL1);
+	uintptr_t rcc_base = stm32mp_rcc_base();
+
+	mmio_write_32(rcc_base + pll->pllxcfgr1, regs->cfgr1);
+
+	/*  Frac must be enabled only once its configuration is loaded */
+	mmio_write_32(rcc_base + pll->pllxfracr, 0U);
+	mmio_write_32(rcc_base + pll->pllxfracr,
+		      regs->fracr & ~RCC_PLLNFRACR_FRACLE);
+	mmio_write_32(rcc_base + pll->pllxfracr, regs->fracr);
+
+	mmio_write_32(rcc_base + pll->pllxcfgr2, regs->cfgr2);
+}
+
 static int stm32mp1_pll1_config_from_opp_khz(uint32_t freq_khz)
 {
+	const struct stm32mp1_clk_pll *pll = pll_ref(_PLL1);
+	const struct stm32mp1_pll1_opp_regs *regs;
+	uintptr_t rcc_base = stm32mp_rcc_base();
 	unsigned int i;
 	int ret;
 	int div;
-	int config_on_the_fly = -1;
+	bool config_on_the_fly;
 
 	for (i = 0; i < PLAT_MAX_OPP_NB; i++) {
 		if (pll1_settings.freq[i] == freq_khz) {
@@ -2018,19 +2101,25 @@ static int stm32mp1_pll1_config_from_opp_khz(uint32_t freq_khz)
 		return ret;
 	}
 
-	ret = stm32mp1_is_pll_config_on_the_fly(_PLL1, &pll1_settings.cfg[i][0],
-						pll1_settings.frac[i],
-						&config_on_the_fly);
-	if (ret != 0) {
+	regs = &pll1_opp_regs[i];
+
+	if ((mmio_read_32(rcc_base + pll->pllxcfgr2) == regs->cfgr2) &&
+	    (mmio_read_32(rcc_base + pll->pllxfracr) == regs->fracr) &&
+	    (mmio_read_32(rcc_base + pll->pllxcfgr1) == regs->cfgr1)) {
+		/* No need to reconfigure, setup already OK */
+		ret = stm32mp1_set_clksrc(CLK_MPU_PLL1P);
+		if (ret == 0) {
+			pll1_p_khz = freq_khz;
+		}
+
 		return ret;
 	}
 
-	if (config_on_the_fly == 1) {
-		/*  No need to reconfigure, setup already OK */
-		return 0;
-	}
+	/* Only DIVN/DIVM changes need PLL1 to be stopped */
+	config_on_the_fly = mmio_read_32(rcc_base + pll->pllxcfgr1) ==
+			    regs->cfgr1;
 
-	if (config_on_the_fly == -1) {
+	if (!config_on_the_fly) {
 		/* Switch to HSI and stop PLL1 before reconfiguration */
 		ret = stm32mp1_set_clksrc(CLK_MPU_HSI);
 		if (ret != 0) {
@@ -2043,13 +2132,10 @@ static int stm32mp1_pll1_config_from_opp_khz(uint32_t freq_khz)
 		}
 	}
 
-	ret = stm32mp1_pll_config(_PLL1, &pll1_settings.cfg[i][0],
-				  pll1_settings.frac[i]);
-	if (ret != 0) {
-		return ret;
-	}
+	stm32mp1_pll1_write_opp_regs(regs);
+	pll1_p_khz = freq_khz;
 
-	if (config_on_the_fly == -1) {
+	if (!config_on_the_fly) {
 		/* Start PLL1 and switch back to after reconfiguration */
 		stm32mp1_pll_start(_PLL1);
 
@@ -2058,14 +2144,9 @@ static int stm32mp1_pll1_config_from_opp_khz(uint32_t freq_khz)
 		if (ret != 0) {
 			return ret;
 		}
-
-		ret = stm32mp1_set_clksrc(CLK_MPU_PLL1P);
-		if (ret != 0) {
-			return ret;
-		}
 	}
 
-	return 0;
+	return stm32mp1_set_clksrc(CLK_MPU_PLL1P);
 }
 
 int stm32mp1_set_opp_khz(uint32_t freq_khz)
@@ -2094,6 +2175,10 @@ int stm32mp1_set_opp_khz(uint32_t freq_khz)
 		return -EPERM;
 	}
 
+	if (!pll1_opp_regs_valid && (stm32mp1_pll1_build_opp_regs() != 0)) {
+		return -EINVAL;
+	}
+
 	if (stm32mp1_pll1_config_from_opp_khz(freq_khz) != 0) {
 		/* Restore original value */
 		if (stm32mp1_pll1_config_from_opp_khz(current_opp_khz) != 0) {
@@ -2427,9 +2512,18 @@ int stm32mp1_clk_compute_all_pll1_settings(uint32_t buck1_voltage)
 
 	pll1_settings.valid_id = PLL1_SETTINGS_VALID_ID;
 
+#if defined(IMAGE_BL32)
+	pll1_opp_regs_valid = false;
+#endif
+
 	return 0;
 }
 
+bool stm32mp1_clk_pll1_settings_are_valid(void)
+{
+	return clk_pll1_settings_are_valid();
+}
+
 void stm32mp1_clk_lp_save_opp_pll1_settings(uint8_t *data, size_t size)
 {
 	if (size != sizeof(pll1_settings) || !clk_pll1_settings_are_valid()) {
@@ -2446,6 +2540,11 @@ void stm32mp1_clk_lp_load_opp_pll1_settings(uint8_t *data, size_t size)
 	}
 
 	memcpy(&pll1_settings, data, size);
+
+#if defined(IMAGE_BL32)
+	pll1_opp_regs_valid = false;
+	pll1_p_khz = 0U;
+#endif
 }
 
 int stm32mp1_clk_init(uint32_t pll1_freq_khz)
@@ -2705,9 +2804,14 @@ int stm32mp1_clk_init(uint32_t pll1_freq_khz)
 			return ret;
 		}
 	}
-	/* Wait LSE ready before to use it */
+	/*
+	 * LSE readiness is awaited by its first user, the RTC source is set
+	 * meanwhile and the LSE CSS enabled once the LSE is ready.
+	 */
 	if (stm32mp1_osc[_LSE] != 0U) {
-		stm32mp1_lse_wait();
+		lse_pending = true;
+		lse_pending_css = lse_css;
+		lse_css = false;
 	}
 
 	/* Configure with expected clock source */
@@ -3410,6 +3514,8 @@ int stm32mp1_clk_probe(void)
 
 	assert(PLLCFG_NB == PLAT_MAX_PLLCFG_NB);
 
+	stm32mp1_clk_index_gates();
+
 #if defined(IMAGE_BL32)
 	if (!fdt_get_rcc_secure_state()) {
 		mmio_write_32(stm32mp_rcc_base() + RCC_TZCR, 0U);
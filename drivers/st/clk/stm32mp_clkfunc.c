@@ -161,7 +161,7 @@ static int fdt_get_rcc_node(void *fdt)
 	static int node;
 
 	if (node <= 0) {
-		node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+		node = dt_node_offset_by_compatible(-1, DT_RCC_CLK_COMPAT);
 	}
 
 	return node;
@@ -284,7 +284,7 @@ bool fdt_get_rcc_secure_state(void)
 		return false;
 	}
 
-	if (fdt_node_offset_by_compatible(fdt, -1, DT_RCC_SEC_CLK_COMPAT) < 0) {
+	if (dt_node_offset_by_compatible(-1, DT_RCC_SEC_CLK_COMPAT) < 0) {
 		return false;
 	}
 
@@ -32,7 +32,9 @@
 #define HASH_CR				0x00U
 #define HASH_DIN			0x04U
 #define HASH_STR			0x08U
+#define HASH_IMR			0x20U
 #define HASH_SR				0x24U
+#define HASH_CSR(x)			(0xF8U + ((x) * 0x04U))
 #define HASH_HREG(x)			(0x310U + ((x) * 0x04U))
 
 /* Control Register */
@@ -56,6 +58,7 @@
 #endif
 
 /* Status Flags */
+#define HASH_SR_DINIS			BIT(0)
 #define HASH_SR_DCIS			BIT(1)
 #define HASH_SR_BUSY			BIT(3)
 
@@ -72,6 +75,10 @@
 #define SHA512_256_DIGEST_SIZE		32U
 #define SHA512_DIGEST_SIZE		64U
 
+/* Input FIFO depth, a block of data */
+#define HASH_FIFO_WORDS			16U
+#define HASH_FIFO_SIZE			(HASH_FIFO_WORDS * sizeof(uint32_t))
+
 #define RESET_TIMEOUT_US_1MS		1000U
 #define HASH_TIMEOUT_US			10000U
 
@@ -97,6 +104,9 @@ struct stm32_hash_remain {
 static struct stm32_hash_instance stm32_hash;
 static struct stm32_hash_remain stm32_remain;
 
+/* Context whose digest is in the peripheral, NULL if none */
+static struct stm32_hash_context *active_ctx;
+
 static uintptr_t hash_base(void)
 {
 	return stm32_hash.base;
@@ -111,6 +121,8 @@ static int hash_wait_busy(void)
 			ERROR("%s: busy timeout\n", __func__);
 			return -ETIMEDOUT;
 		}
+
+		timeout_wait_event();
 	}
 
 	return 0;
@@ -125,6 +137,8 @@ static int hash_wait_computation(void)
 			ERROR("%s: busy timeout\n", __func__);
 			return -ETIMEDOUT;
 		}
+
+		timeout_wait_event();
 	}
 
 	return 0;
@@ -144,6 +158,51 @@ static int hash_write_data(uint32_t data)
 	return 0;
 }
 
+/*
+ * Write a complete block of data. If the input FIFO is ready to get a new
+ * block, the words are pushed in a burst without polling the busy flag,
+ * otherwise fall back to the per-word write.
+ */
+static int hash_write_block(const uint8_t *buffer)
+{
+	uintptr_t din = hash_base() + HASH_DIN;
+	unsigned int i;
+
+	if ((mmio_read_32(hash_base() + HASH_SR) & HASH_SR_DINIS) == 0U) {
+		for (i = 0U; i < HASH_FIFO_WORDS; i++) {
+			uint32_t tmp_buf;
+			int ret;
+
+			memcpy(&tmp_buf, buffer + (i * sizeof(uint32_t)),
+			       sizeof(uint32_t));
+			ret = hash_write_data(tmp_buf);
+			if (ret != 0) {
+				return ret;
+			}
+		}
+
+		return 0;
+	}
+
+	if (((uintptr_t)buffer & (sizeof(uint32_t) - 1U)) == 0U) {
+		const uint32_t *word = (const uint32_t *)buffer;
+
+		for (i = 0U; i < HASH_FIFO_WORDS; i++) {
+			mmio_write_32(din, word[i]);
+		}
+	} else {
+		for (i = 0U; i < HASH_FIFO_WORDS; i++) {
+			uint32_t tmp_buf;
+
+			memcpy(&tmp_buf, buffer + (i * sizeof(uint32_t)),
+			       sizeof(uint32_t));
+			mmio_write_32(din, tmp_buf);
+		}
+	}
+
+	return 0;
+}
+
 static void hash_hw_init(enum stm32_hash_algo_mode mode)
 {
 	uint32_t reg;
@@ -213,6 +272,164 @@ static int hash_get_digest(uint8_t *digest)
 	return 0;
 }
 
+/*
+ * Save the context in the peripheral, with no block being processed. The
+ * input FIFO content is part of the context registers.
+ */
+static int hash_ctx_save(struct stm32_hash_context *ctx)
+{
+	unsigned int i;
+	int ret;
+
+	ret = hash_wait_busy();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ctx->imr = mmio_read_32(hash_base() + HASH_IMR);
+	ctx->str = mmio_read_32(hash_base() + HASH_STR);
+	ctx->cr = mmio_read_32(hash_base() + HASH_CR);
+
+	for (i = 0U; i < HASH_CSR_NB; i++) {
+		ctx->csr[i] = mmio_read_32(hash_base() + HASH_CSR(i));
+	}
+
+	return 0;
+}
+
+static void hash_ctx_restore(const struct stm32_hash_context *ctx)
+{
+	unsigned int i;
+
+	mmio_write_32(hash_base() + HASH_IMR, ctx->imr);
+	mmio_write_32(hash_base() + HASH_STR, ctx->str);
+	mmio_write_32(hash_base() + HASH_CR, ctx->cr);
+	mmio_write_32(hash_base() + HASH_CR, ctx->cr | HASH_CR_INIT);
+
+	for (i = 0U; i < HASH_CSR_NB; i++) {
+		mmio_write_32(hash_base() + HASH_CSR(i), ctx->csr[i]);
+	}
+
+	stm32_hash.digest_size = ctx->digest_size;
+}
+
+/* Save the active context, if any data of its digest is in the peripheral */
+static int hash_ctx_release(void)
+{
+	struct stm32_hash_context *ctx = active_ctx;
+
+	active_ctx = NULL;
+
+	if ((ctx == NULL) || !ctx->started) {
+		return 0;
+	}
+
+	return hash_ctx_save(ctx);
+}
+
+/* Load a context in the peripheral, the clock being enabled */
+static int hash_ctx_switch(struct stm32_hash_context *ctx)
+{
+	int ret;
+
+	if (active_ctx == ctx) {
+		return 0;
+	}
+
+	ret = hash_ctx_release();
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (ctx->started) {
+		hash_ctx_restore(ctx);
+	} else {
+		hash_hw_init(ctx->mode);
+		ctx->digest_size = stm32_hash.digest_size;
+	}
+
+	active_ctx = ctx;
+
+	return 0;
+}
+
+static int hash_write_words(const uint8_t *buffer, size_t nb_words)
+{
+	size_t i;
+	int ret;
+
+	for (i = 0U; i < nb_words; i++) {
+		uint32_t tmp_buf;
+
+		memcpy(&tmp_buf, buffer + (i * sizeof(uint32_t)),
+		       sizeof(uint32_t));
+		ret = hash_write_data(tmp_buf);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static size_t hash_algo_block_size(enum stm32_hash_algo_mode mode)
+{
+#if STM32MP13
+	if ((mode == HASH_SHA384) || (mode == HASH_SHA512)) {
+		return 128U;
+	}
+#endif
+
+	return 64U;
+}
+
+/*
+ * The first block of a digest is only processed once its next word is
+ * written: the blocks are written after this extra word, so that the last
+ * word written stays in the FIFO and is part of the saved context.
+ */
+static size_t hash_ctx_block_size(const struct stm32_hash_context *ctx)
+{
+	size_t size = hash_algo_block_size(ctx->mode);
+
+	if (!ctx->started) {
+		size += sizeof(uint32_t);
+	}
+
+	return size;
+}
+
+static int hash_ctx_write_block(struct stm32_hash_context *ctx,
+				const uint8_t *buffer)
+{
+	size_t size = hash_algo_block_size(ctx->mode);
+	size_t offset;
+	int ret;
+
+	ret = hash_ctx_switch(ctx);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (offset = 0U; offset < size; offset += HASH_FIFO_SIZE) {
+		ret = hash_write_block(buffer + offset);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (ctx->started) {
+		return 0;
+	}
+
+	ret = hash_write_words(buffer + size, 1U);
+	if (ret == 0) {
+		ctx->started = true;
+	}
+
+	return ret;
+}
+
 int stm32_hash_update(const uint8_t *buffer, size_t length)
 {
 	size_t remain_length = length;
@@ -243,6 +460,16 @@ int stm32_hash_update(const uint8_t *buffer, size_t length)
 		}
 	}
 
+	while (remain_length >= HASH_FIFO_SIZE) {
+		ret = hash_write_block(buffer);
+		if (ret != 0) {
+			goto exit;
+		}
+
+		buffer += HASH_FIFO_SIZE;
+		remain_length -= HASH_FIFO_SIZE;
+	}
+
 	while (remain_length / sizeof(uint32_t) != 0U) {
 		uint32_t tmp_buf;
 
@@ -315,6 +542,11 @@ void stm32_hash_init(enum stm32_hash_algo_mode mode)
 {
 	clk_enable(stm32_hash.clock);
 
+	/* The other digests are resumed from their context */
+	if (hash_ctx_release() != 0) {
+		panic();
+	}
+
 	hash_hw_init(mode);
 
 	clk_disable(stm32_hash.clock);
@@ -322,6 +554,109 @@ void stm32_hash_init(enum stm32_hash_algo_mode mode)
 	zeromem(&stm32_remain, sizeof(stm32_remain));
 }
 
+/*
+ * The context API interleaves several digests on the peripheral. Only whole
+ * blocks are written to the peripheral, the rest of the data is kept in the
+ * context, so that it can be saved between two updates. The single digest
+ * API above saves the active context when it starts, and its digest must be
+ * completed before the next context update.
+ */
+void stm32_hash_ctx_init(struct stm32_hash_context *ctx,
+			 enum stm32_hash_algo_mode mode)
+{
+	if (active_ctx == ctx) {
+		active_ctx = NULL;
+	}
+
+	zeromem(ctx, sizeof(*ctx));
+	ctx->mode = mode;
+}
+
+int stm32_hash_ctx_update(struct stm32_hash_context *ctx,
+			  const uint8_t *buffer, size_t length)
+{
+	int ret = 0;
+
+	if ((length == 0U) || (buffer == NULL)) {
+		return 0;
+	}
+
+	clk_enable(stm32_hash.clock);
+
+	while (length != 0U) {
+		size_t block_size = hash_ctx_block_size(ctx);
+		size_t copysize;
+
+		/* Write the blocks from the buffer while nothing is kept */
+		if ((ctx->block_len == 0U) && (length >= block_size)) {
+			ret = hash_ctx_write_block(ctx, buffer);
+			if (ret != 0) {
+				break;
+			}
+
+			buffer += block_size;
+			length -= block_size;
+			continue;
+		}
+
+		copysize = MIN(block_size - ctx->block_len, length);
+		memcpy(ctx->block + ctx->block_len, buffer, copysize);
+		ctx->block_len += copysize;
+		buffer += copysize;
+		length -= copysize;
+
+		if (ctx->block_len == block_size) {
+			ret = hash_ctx_write_block(ctx, ctx->block);
+			if (ret != 0) {
+				break;
+			}
+
+			ctx->block_len = 0U;
+		}
+	}
+
+	clk_disable(stm32_hash.clock);
+
+	return ret;
+}
+
+int stm32_hash_ctx_final(struct stm32_hash_context *ctx, uint8_t *digest)
+{
+	size_t nb_words = ctx->block_len / sizeof(uint32_t);
+	size_t last_bytes = ctx->block_len % sizeof(uint32_t);
+	int ret;
+
+	clk_enable(stm32_hash.clock);
+
+	ret = hash_ctx_switch(ctx);
+	if (ret == 0) {
+		ret = hash_write_words(ctx->block, nb_words);
+	}
+
+	if ((ret == 0) && (last_bytes != 0U)) {
+		uint32_t tmp_buf = 0U;
+
+		memcpy(&tmp_buf, ctx->block + (nb_words * sizeof(uint32_t)),
+		       last_bytes);
+		ret = hash_write_data(tmp_buf);
+	}
+
+	if (ret == 0) {
+		mmio_clrsetbits_32(hash_base() + HASH_STR, HASH_STR_NBLW_MASK,
+				   8U * last_bytes);
+		mmio_setbits_32(hash_base() + HASH_STR, HASH_STR_DCAL);
+
+		ret = hash_get_digest(digest);
+	}
+
+	active_ctx = NULL;
+	zeromem(ctx->block, sizeof(ctx->block));
+
+	clk_disable(stm32_hash.clock);
+
+	return ret;
+}
+
 int stm32_hash_register(void)
 {
 	struct dt_node_info hash_info;
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2020-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2020-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <drivers/clk.h>
@@ -36,7 +37,12 @@
 #define DT_PKA_COMPAT			"st,stm32-pka64"
 
 #define MAX_ECC_SIZE_LEN		640
+#if PKA_USE_RSA
+#define MAX_RSA_SIZE_LEN		4160
+#define MAX_EO_NBW			OP_NBW_FROM_LEN(MAX_RSA_SIZE_LEN)
+#else
 #define MAX_EO_NBW			OP_NBW_FROM_LEN(MAX_ECC_SIZE_LEN)
+#endif
 
 /* PKA registers */
 /* PKA control register */
@@ -53,6 +59,7 @@
 /* PKA control register fields */
 #define _PKA_CR_MODE_MASK		GENMASK(13, 8)
 #define _PKA_CR_MODE_SHIFT		U(8)
+#define _PKA_CR_MODE_MODULAR_EXP	U(0x0)
 #define _PKA_CR_MODE_ADD		U(0x9)
 #define _PKA_CR_MODE_ECDSA_VERIF	U(0x26)
 #define _PKA_CR_START			BIT(1)
@@ -102,6 +109,14 @@
 #define _PKA_RAM_ECDSA_VERIFY_VALID	ULL(0xD60D)
 #define _PKA_RAM_ECDSA_VERIFY_INVALID	ULL(0xA3B7)
 
+/* PKA RAM offsets for the modular exponentiation */
+#define _PKA_RAM_EXP_NB_BITS		U(0x400) /* 64 */
+#define _PKA_RAM_OP_NB_BITS		U(0x408) /* 64 */
+#define _PKA_RAM_EXP_RESULT		U(0x838) /* EOS */
+#define _PKA_RAM_EXP_A			U(0xC68) /* EOS */
+#define _PKA_RAM_EXP_E			U(0xE78) /* EOS */
+#define _PKA_RAM_EXP_N			U(0x1088) /* EOS */
+
 #define PKA_TIMEOUT_US			U(1000000)
 #define TIMEOUT_US_1MS			U(1000)
 #define PKA_RESET_DELAY			U(20)
@@ -257,6 +272,11 @@ static struct curve_parameters curve_def[] = {
 
 static struct stm32_pka_platdata pka_pdata;
 
+static struct {
+	enum stm32_pka_ecdsa_curve_id cid;
+	bool active;
+} pka_session;
+
 __attribute__((weak))
 int stm32_pka_get_platdata(struct stm32_pka_platdata *pdata)
 {
@@ -387,6 +407,43 @@ static int write_eo_data(uintptr_t addr, uint8_t *data, unsigned int data_size,
 	return 0;
 }
 
+#if PKA_USE_RSA
+/*
+ * Read an operand from PKA RAM, the reverse of write_eo_data(): data is a
+ * BYTE list with most significant bytes first, of data_size bytes.
+ */
+static void read_eo_data(uintptr_t addr, uint8_t *data, unsigned int data_size)
+{
+	uint32_t word_index;
+	int data_index = (int)data_size - 1;
+
+	for (word_index = 0U; data_index >= 0; word_index++) {
+		uint64_t tmp = mmio_read_64(addr + word_index * sizeof(tmp));
+		unsigned int i;
+
+		for (i = 0U; (i < sizeof(tmp)) && (data_index >= 0); i++) {
+			data[data_index] = (uint8_t)(tmp >> (INT8_LEN * i));
+			data_index--;
+		}
+	}
+}
+
+/* Number of significant bits of a BigInt, most significant bytes first */
+static unsigned int bigint_len(const uint8_t *data, unsigned int size)
+{
+	unsigned int i;
+
+	for (i = 0U; i < size; i++) {
+		if (data[i] != 0U) {
+			return ((size - i) * INT8_LEN) -
+			       ((unsigned int)__builtin_clz(data[i]) - 24U);
+		}
+	}
+
+	return 0U;
+}
+#endif /* PKA_USE_RSA */
+
 static unsigned int get_ecc_op_nbword(enum stm32_pka_ecdsa_curve_id cid)
 {
 	return OP_NBW_FROM_LEN(curve_def[cid].n_len);
@@ -608,16 +665,68 @@ int stm32_pka_init(void)
 	return 0;
 }
 
-int stm32_pka_ecdsa_verif(void *hash, unsigned int hash_size,
-			  void *sig_r_ptr, unsigned int sig_r_size,
-			  void *sig_s_ptr, unsigned int sig_s_size,
-			  void *pk_x_ptr, unsigned int pk_x_size,
-			  void *pk_y_ptr, unsigned int pk_y_size,
-			  enum stm32_pka_ecdsa_curve_id cid)
+/*
+ * Start an ECDSA verification session: the curve parameters are loaded once
+ * in PKA RAM and the PKA is kept enabled, so that several signatures on the
+ * same curve can then be checked with stm32_pka_ecdsa_verif_session_run().
+ * Operands written by a verification do not overlap the curve parameters.
+ */
+int stm32_pka_ecdsa_verif_session_start(enum stm32_pka_ecdsa_curve_id cid)
 {
 	int ret;
 	uintptr_t base = pka_pdata.base;
-	unsigned int eo_nbw = get_ecc_op_nbword(cid);
+
+	if (pka_session.active) {
+		if (pka_session.cid == cid) {
+			return 0;
+		}
+
+		stm32_pka_ecdsa_verif_session_end();
+	}
+
+	if ((mmio_read_32(base + _PKA_SR) & _PKA_SR_BUSY) == _PKA_SR_BUSY) {
+		INFO("%s busy\n", __func__);
+		return -EBUSY;
+	}
+
+	/* Fill PKA RAM with curve id values */
+	ret = stm32_pka_ecdsa_verif_configure_curve(base, cid);
+	if (ret < 0) {
+		goto out;
+	}
+
+	/* Set mode to ecdsa signature verification */
+	ret = pka_enable(base, _PKA_CR_MODE_ECDSA_VERIF);
+	if (ret < 0) {
+		WARN("%s set mode pka error %d\n", __func__, ret);
+		goto out;
+	}
+
+	pka_session.cid = cid;
+	pka_session.active = true;
+
+	return 0;
+
+out:
+	pka_disable(base);
+
+	return ret;
+}
+
+int stm32_pka_ecdsa_verif_session_run(void *hash, unsigned int hash_size,
+				      void *sig_r_ptr, unsigned int sig_r_size,
+				      void *sig_s_ptr, unsigned int sig_s_size,
+				      void *pk_x_ptr, unsigned int pk_x_size,
+				      void *pk_y_ptr, unsigned int pk_y_size)
+{
+	int ret;
+	uintptr_t base = pka_pdata.base;
+	enum stm32_pka_ecdsa_curve_id cid = pka_session.cid;
+	unsigned int eo_nbw;
+
+	if (!pka_session.active) {
+		return -EINVAL;
+	}
 
 	if ((hash == NULL) || (sig_r_ptr == NULL) || (sig_s_ptr == NULL) ||
 	    (pk_x_ptr == NULL) || (pk_y_ptr == NULL)) {
@@ -632,68 +741,184 @@ int stm32_pka_ecdsa_verif(void *hash, unsigned int hash_size,
 					  cid);
 	if (ret < 0) {
 		INFO("%s check param error %d\n", __func__, ret);
-		goto out;
+		return ret;
 	}
 
 	if ((mmio_read_32(base + _PKA_SR) & _PKA_SR_BUSY) == _PKA_SR_BUSY) {
 		INFO("%s busy\n", __func__);
-		ret = -EBUSY;
-		goto out;
+		return -EBUSY;
 	}
 
-	/* Fill PKA RAM */
-	/*    With curve id values */
-	ret = stm32_pka_ecdsa_verif_configure_curve(base, cid);
-	if (ret < 0) {
-		goto out;
-	}
+	eo_nbw = get_ecc_op_nbword(cid);
 
+	/* Fill PKA RAM */
 	/*    With pubkey */
 	ret = write_eo_data(base + _PKA_RAM_XQ, pk_x_ptr, pk_x_size, eo_nbw);
 	if (ret < 0) {
-		goto out;
+		return ret;
 	}
 
 	ret = write_eo_data(base + _PKA_RAM_YQ, pk_y_ptr, pk_y_size, eo_nbw);
 	if (ret < 0) {
-		goto out;
+		return ret;
 	}
 
 	/*    With hash */
 	ret = write_eo_data(base + _PKA_RAM_HASH_Z, hash, hash_size, eo_nbw);
 	if (ret < 0) {
-		goto out;
+		return ret;
 	}
 
 	/*    With signature */
 	ret = write_eo_data(base + _PKA_RAM_SIGN_R, sig_r_ptr, sig_r_size, eo_nbw);
 	if (ret < 0) {
-		goto out;
+		return ret;
 	}
 
 	ret = write_eo_data(base + _PKA_RAM_SIGN_S, sig_s_ptr, sig_s_size, eo_nbw);
 	if (ret < 0) {
-		goto out;
+		return ret;
 	}
 
-	/* Set mode to ecdsa signature verification */
-	ret = pka_enable(base, _PKA_CR_MODE_ECDSA_VERIF);
+	/* Start processing and wait end */
+	ret = stm32_pka_process(base);
+	if (ret < 0) {
+		WARN("%s process error %d\n", __func__, ret);
+		/* PKA state is unknown, a new session is required */
+		stm32_pka_ecdsa_verif_session_end();
+		return ret;
+	}
+
+	/* Check return status */
+	ret = stm32_pka_ecdsa_verif_check_return(base);
+
+	/* Unset end proc */
+	mmio_setbits_32(base + _PKA_CLRFR, _PKA_IT_PROCEND);
+
+	return ret;
+}
+
+void stm32_pka_ecdsa_verif_session_end(void)
+{
+	if (!pka_session.active) {
+		return;
+	}
+
+	/* Disable PKA (will stop all pending proccess and reset RAM) */
+	pka_disable(pka_pdata.base);
+
+	pka_session.active = false;
+}
+
+int stm32_pka_ecdsa_verif(void *hash, unsigned int hash_size,
+			  void *sig_r_ptr, unsigned int sig_r_size,
+			  void *sig_s_ptr, unsigned int sig_s_size,
+			  void *pk_x_ptr, unsigned int pk_x_size,
+			  void *pk_y_ptr, unsigned int pk_y_size,
+			  enum stm32_pka_ecdsa_curve_id cid)
+{
+	int ret;
+
+	ret = stm32_pka_ecdsa_verif_session_start(cid);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = stm32_pka_ecdsa_verif_session_run(hash, hash_size,
+						sig_r_ptr, sig_r_size,
+						sig_s_ptr, sig_s_size,
+						pk_x_ptr, pk_x_size,
+						pk_y_ptr, pk_y_size);
+
+	stm32_pka_ecdsa_verif_session_end();
+
+	return ret;
+}
+
+#if PKA_USE_RSA
+/*
+ * RSA public operation: out = in ^ e mod n, computed by the PKA modular
+ * exponentiation, the Montgomery parameter being computed by the same
+ * operation. The PKA RAM is shared with ECDSA verification, an opened
+ * session is ended and will be started again by its next user.
+ * n, e, in and out are BYTE lists with most significant bytes first, in and
+ * out being n_size bytes long.
+ */
+int stm32_pka_rsa_public(const void *n, unsigned int n_size,
+			 const void *e, unsigned int e_size,
+			 const void *in, void *out)
+{
+	uintptr_t base = pka_pdata.base;
+	unsigned int n_len;
+	unsigned int e_len;
+	unsigned int eo_nbw;
+	int ret;
+
+	if ((n == NULL) || (e == NULL) || (in == NULL) || (out == NULL)) {
+		return -EINVAL;
+	}
+
+	n_len = bigint_len(n, n_size);
+	e_len = bigint_len(e, e_size);
+	eo_nbw = OP_NBW_FROM_LEN(n_len);
+
+	/* Odd modulus of at most MAX_RSA_SIZE_LEN bits, 0 < in < n */
+	if ((n_len == 0U) || (n_len > MAX_RSA_SIZE_LEN) ||
+	    ((((const uint8_t *)n)[n_size - 1U] & 1U) == 0U) ||
+	    (e_len == 0U) || (e_len > n_len) ||
+	    is_zero((uint8_t *)in, n_size) ||
+	    !is_smaller((uint8_t *)in, n_size, (uint8_t *)n, n_size)) {
+		INFO("%s invalid input param\n", __func__);
+		return -EINVAL;
+	}
+
+	stm32_pka_ecdsa_verif_session_end();
+
+	if ((mmio_read_32(base + _PKA_SR) & _PKA_SR_BUSY) == _PKA_SR_BUSY) {
+		INFO("%s busy\n", __func__);
+		return -EBUSY;
+	}
+
+	mmio_write_64(base + _PKA_RAM_EXP_NB_BITS, e_len);
+	mmio_write_64(base + _PKA_RAM_OP_NB_BITS, n_len);
+
+	ret = write_eo_data(base + _PKA_RAM_EXP_A, (uint8_t *)in, n_size,
+			    eo_nbw);
+	if (ret == 0) {
+		ret = write_eo_data(base + _PKA_RAM_EXP_E, (uint8_t *)e, e_size,
+				    eo_nbw);
+	}
+
+	if (ret == 0) {
+		ret = write_eo_data(base + _PKA_RAM_EXP_N, (uint8_t *)n, n_size,
+				    eo_nbw);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = pka_enable(base, _PKA_CR_MODE_MODULAR_EXP);
 	if (ret < 0) {
 		WARN("%s set mode pka error %d\n", __func__, ret);
 		goto out;
 	}
 
-	/* Start processing and wait end */
 	ret = stm32_pka_process(base);
 	if (ret < 0) {
 		WARN("%s process error %d\n", __func__, ret);
 		goto out;
 	}
 
-	/* Check return status */
-	ret = stm32_pka_ecdsa_verif_check_return(base);
+	if ((mmio_read_32(base + _PKA_SR) &
+	     (_PKA_IT_OPERR | _PKA_IT_ADDRERR | _PKA_IT_RAMERR)) != 0U) {
+		WARN("%s operation error\n", __func__);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	read_eo_data(base + _PKA_RAM_EXP_RESULT, out, n_size);
 
-	/* Unset end proc */
 	mmio_setbits_32(base + _PKA_CLRFR, _PKA_IT_PROCEND);
 
 out:
@@ -702,3 +927,4 @@ out:
 
 	return ret;
 }
+#endif /* PKA_USE_RSA */
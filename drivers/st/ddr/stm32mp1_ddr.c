@@ -17,6 +17,7 @@
 #include <drivers/st/stm32mp_ddr.h>
 #include <drivers/st/stm32mp1_ddr.h>
 #include <drivers/st/stm32mp1_ddr_regs.h>
+#include <drivers/st/stm32mp1_ddr_training.h>
 #include <drivers/st/stm32mp1_pwr.h>
 #include <drivers/st/stm32mp1_ram.h>
 #include <lib/mmio.h>
@@ -213,6 +214,15 @@ static const struct stm32mp_ddr_reg_info ddr_registers[REG_TYPE_NB] = {
 	},
 };
 
+/*
+ * The platform can step other initialisations while the PHY runs, provided
+ * they return quickly: the PHY errors are only checked between the calls.
+ */
+#pragma weak plat_ddrphy_wait_step
+void plat_ddrphy_wait_step(void)
+{
+}
+
 static void stm32mp1_ddrphy_idone_wait(struct stm32mp_ddrphy *phy)
 {
 	uint32_t pgsr;
@@ -253,6 +263,10 @@ static void stm32mp1_ddrphy_idone_wait(struct stm32mp_ddrphy *phy)
 			VERBOSE("Read Valid Training Intermittent Error\n");
 			error++;
 		}
+
+		if (((pgsr & DDRPHYC_PGSR_IDONE) == 0U) && (error == 0)) {
+			plat_ddrphy_wait_step();
+		}
 	} while (((pgsr & DDRPHYC_PGSR_IDONE) == 0U) && (error == 0));
 	VERBOSE("\n[0x%lx] pgsr = 0x%x\n",
 		(uintptr_t)&phy->pgsr, pgsr);
@@ -889,16 +903,24 @@ void stm32mp1_ddr_init(struct stm32mp_ddr_priv *priv,
 	 * 10. configure PUBL PIR register to specify which training step
 	 * to run
 	 * RVTRN is executed only on LPDDR2/LPDDR3
-	 */
-	pir = DDRPHYC_PIR_QSTRN;
-	if ((config->c_reg.mstr & DDRCTRL_MSTR_DDR3) == 0U) {
-		pir |= DDRPHYC_PIR_RVTRN;
-	}
+	 * On cold boot, the results of a previous training can be restored
+	 * instead, they are then checked by the DDR tests.
+	 */
+	if (config->self_refresh ||
+	    !stm32mp1_ddr_training_restore(priv, config)) {
+		pir = DDRPHYC_PIR_QSTRN;
+		if ((config->c_reg.mstr & DDRCTRL_MSTR_DDR3) == 0U) {
+			pir |= DDRPHYC_PIR_RVTRN;
+		}
 
-	stm32mp1_ddrphy_init(priv->phy, pir);
+		stm32mp1_ddrphy_init(priv->phy, pir);
 
-	/* 11. monitor PUB PGSR.IDONE to poll completion of training sequence */
-	stm32mp1_ddrphy_idone_wait(priv->phy);
+		/*
+		 * 11. monitor PUB PGSR.IDONE to poll completion of training
+		 * sequence
+		 */
+		stm32mp1_ddrphy_idone_wait(priv->phy);
+	}
 
 	/* Refresh compensation: forcing refresh command */
 	if (config->self_refresh) {
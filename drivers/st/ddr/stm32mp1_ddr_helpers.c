@@ -4,18 +4,110 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <errno.h>
+
+#include <libfdt.h>
+
 #include <platform_def.h>
 
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/delay_timer.h>
 #include <drivers/st/stm32mp_ddr.h>
 #include <drivers/st/stm32mp1_ddr.h>
 #include <drivers/st/stm32mp1_ddr_helpers.h>
 #include <drivers/st/stm32mp1_ddr_regs.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
 #include <plat/common/platform.h>
 
+/*
+ * PUBL IOs and DLLs registers values of the Self-Refresh entry and exit
+ * sequences. These registers are only set by the DDR initialization, their
+ * values are computed once from the run configuration and written as is,
+ * rather than read-modify-write each field at every low power cycle.
+ */
+struct ddr_sr_publ {
+	uint32_t aciocr_pd;
+	uint32_t aciocr_sr;
+	uint32_t aciocr_pu;
+	uint32_t aciocr_run;
+	uint32_t dxccr_sr;
+	uint32_t dxccr_run;
+	uint32_t dsgcr_pd;
+	uint32_t dsgcr_sr;
+	uint32_t dsgcr_unlatch;
+	uint32_t dsgcr_run;
+	uint32_t acdllcr;
+	uint32_t dxndllcr[4];
+};
+
+static const uint32_t ddr_sr_dxndllcr[] = {
+	DDRPHYC_DX0DLLCR,
+	DDRPHYC_DX1DLLCR,
+#if STM32MP_DDR_32BIT_INTERFACE
+	DDRPHYC_DX2DLLCR,
+	DDRPHYC_DX3DLLCR,
+#endif
+};
+
+static struct ddr_sr_publ ddr_sr_publ;
+static bool ddr_sr_publ_valid;
+
+/* Register settings of a Self-Refresh mode */
+struct ddr_sr_mode_cfg {
+	uint32_t rcc_clr;
+	uint32_t rcc_set;
+	bool hw_lp_en;
+	uint32_t pwrctl_clr;
+	uint32_t pwrctl_set;
+};
+
+#if STM32MP_DDR_DUAL_AXI_PORT
+#define DDR_SR_DDRC2EN		RCC_DDRITFCR_DDRC2EN
+#define DDR_SR_DDRC2LPEN	RCC_DDRITFCR_DDRC2LPEN
+#else
+#define DDR_SR_DDRC2EN		0U
+#define DDR_SR_DDRC2LPEN	0U
+#endif
+
+static const struct ddr_sr_mode_cfg ddr_sr_mode_cfg[] = {
+	[DDR_SSR_MODE] = {
+		.rcc_clr = RCC_DDRITFCR_AXIDCGEN | RCC_DDRITFCR_DDRCKMOD_MASK,
+		.rcc_set = RCC_DDRITFCR_DDRC1LPEN | RCC_DDRITFCR_DDRC1EN |
+			   DDR_SR_DDRC2LPEN | DDR_SR_DDRC2EN |
+			   RCC_DDRITFCR_DDRCAPBLPEN |
+			   RCC_DDRITFCR_DDRPHYCAPBLPEN |
+			   RCC_DDRITFCR_DDRCAPBEN |
+			   RCC_DDRITFCR_DDRPHYCAPBEN |
+			   RCC_DDRITFCR_DDRPHYCEN,
+		/* Disable HW LP interface and automatic Self-Refresh */
+		.hw_lp_en = false,
+		.pwrctl_clr = DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE |
+			      DDRCTRL_PWRCTL_SELFREF_EN,
+	},
+	[DDR_HSR_MODE] = {
+		.rcc_clr = RCC_DDRITFCR_DDRC1LPEN | DDR_SR_DDRC2LPEN |
+			   RCC_DDRITFCR_DDRCKMOD_MASK,
+		.rcc_set = RCC_DDRITFCR_AXIDCGEN | RCC_DDRITFCR_DDRPHYCLPEN |
+			   RCC_DDRITFCR_DDRCKMOD_HSR1,
+		/* Enable HW LP interface and Clock disable with LP modes */
+		.hw_lp_en = true,
+		.pwrctl_set = DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE,
+	},
+	[DDR_ASR_MODE] = {
+		.rcc_clr = RCC_DDRITFCR_DDRCKMOD_MASK,
+		.rcc_set = RCC_DDRITFCR_AXIDCGEN | RCC_DDRITFCR_DDRC1LPEN |
+			   DDR_SR_DDRC2LPEN | RCC_DDRITFCR_DDRPHYCLPEN |
+			   RCC_DDRITFCR_DDRCKMOD_ASR1,
+		/* Also enable automatic Self-Refresh */
+		.hw_lp_en = true,
+		.pwrctl_set = DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE |
+			      DDRCTRL_PWRCTL_SELFREF_EN,
+	},
+};
+
 void ddr_enable_clock(void)
 {
 	stm32mp1_clk_rcc_regs_lock();
@@ -32,12 +124,72 @@ void ddr_enable_clock(void)
 	stm32mp1_clk_rcc_regs_unlock();
 }
 
+static void ddr_sr_publ_init(void)
+{
+	uintptr_t ddrphyc_base = stm32mp_ddrphyc_base();
+	struct ddr_sr_publ *publ = &ddr_sr_publ;
+	uint32_t val;
+	unsigned int i;
+
+	/* IOs powering down, then command/address output driver disabled */
+	val = mmio_read_32(ddrphyc_base + DDRPHYC_ACIOCR);
+	val |= DDRPHYC_ACIOCR_ACPDD | DDRPHYC_ACIOCR_ACPDR;
+	val &= ~(DDRPHYC_ACIOCR_CKPDD_MASK | DDRPHYC_ACIOCR_CKPDR_MASK |
+		 DDRPHYC_ACIOCR_CSPDD_MASK);
+	val |= DDRPHYC_ACIOCR_CKPDD_0 | DDRPHYC_ACIOCR_CKPDR_0 |
+	       DDRPHYC_ACIOCR_CSPDD_0;
+	publ->aciocr_pd = val;
+	publ->aciocr_sr = val & ~DDRPHYC_ACIOCR_ACOE;
+
+	/* Pad drivers enabled, then command/address output driver */
+	publ->aciocr_pu = publ->aciocr_sr & ~DDRPHYC_ACIOCR_ACPDD;
+	publ->aciocr_run = (publ->aciocr_pu | DDRPHYC_ACIOCR_ACOE) &
+			   ~(DDRPHYC_ACIOCR_CKPDD_MASK |
+			     DDRPHYC_ACIOCR_CSPDD_MASK);
+
+	val = mmio_read_32(ddrphyc_base + DDRPHYC_DXCCR);
+	publ->dxccr_sr = val | DDRPHYC_DXCCR_DXPDD | DDRPHYC_DXCCR_DXPDR;
+	publ->dxccr_run = publ->dxccr_sr &
+			  ~(DDRPHYC_DXCCR_DXPDD | DDRPHYC_DXCCR_DXPDR);
+
+	/* Power down settings, then latch set */
+	val = mmio_read_32(ddrphyc_base + DDRPHYC_DSGCR);
+	val &= ~(DDRPHYC_DSGCR_ODTPDD_MASK | DDRPHYC_DSGCR_CKEPDD_MASK);
+	val |= DDRPHYC_DSGCR_ODTPDD_0 | DDRPHYC_DSGCR_NL2PD |
+	       DDRPHYC_DSGCR_CKEPDD_0;
+	publ->dsgcr_pd = val;
+	publ->dsgcr_sr = val & ~DDRPHYC_DSGCR_CKOE;
+
+	/* Latch released, then power down settings removed */
+	publ->dsgcr_unlatch = publ->dsgcr_sr | DDRPHYC_DSGCR_CKOE;
+	publ->dsgcr_run = publ->dsgcr_unlatch &
+			  ~(DDRPHYC_DSGCR_ODTPDD_MASK | DDRPHYC_DSGCR_NL2PD |
+			    DDRPHYC_DSGCR_CKEPDD_MASK);
+
+	publ->acdllcr = mmio_read_32(ddrphyc_base + DDRPHYC_ACDLLCR) &
+			~DDRPHYC_ACDLLCR_DLLDIS;
+
+	for (i = 0U; i < ARRAY_SIZE(ddr_sr_dxndllcr); i++) {
+		publ->dxndllcr[i] = mmio_read_32(ddrphyc_base +
+						 ddr_sr_dxndllcr[i]) &
+				    ~DDRPHYC_DXNDLLCR_DLLDIS;
+	}
+
+	ddr_sr_publ_valid = true;
+}
+
 static int ddr_sw_self_refresh_in(void)
 {
 	uintptr_t rcc_base = stm32mp_rcc_base();
 	uintptr_t pwr_base = stm32mp_pwr_base();
 	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
 	uintptr_t ddrphyc_base = stm32mp_ddrphyc_base();
+	struct ddr_sr_publ *publ = &ddr_sr_publ;
+	unsigned int i;
+
+	if (!ddr_sr_publ_valid) {
+		ddr_sr_publ_init();
+	}
 
 	stm32mp1_clk_rcc_regs_lock();
 
@@ -56,44 +208,20 @@ static int ddr_sw_self_refresh_in(void)
 	}
 
 	/* IOs powering down (PUBL registers) */
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_ACIOCR, DDRPHYC_ACIOCR_ACPDD);
-
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_ACIOCR, DDRPHYC_ACIOCR_ACPDR);
-
-	mmio_clrsetbits_32(ddrphyc_base + DDRPHYC_ACIOCR,
-			   DDRPHYC_ACIOCR_CKPDD_MASK,
-			   DDRPHYC_ACIOCR_CKPDD_0);
-
-	mmio_clrsetbits_32(ddrphyc_base + DDRPHYC_ACIOCR,
-			   DDRPHYC_ACIOCR_CKPDR_MASK,
-			   DDRPHYC_ACIOCR_CKPDR_0);
-
-	mmio_clrsetbits_32(ddrphyc_base + DDRPHYC_ACIOCR,
-			   DDRPHYC_ACIOCR_CSPDD_MASK,
-			   DDRPHYC_ACIOCR_CSPDD_0);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACIOCR, publ->aciocr_pd);
 
 	/* Disable command/address output driver */
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACIOCR, DDRPHYC_ACIOCR_ACOE);
-
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DXCCR, DDRPHYC_DXCCR_DXPDD);
-
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DXCCR, DDRPHYC_DXCCR_DXPDR);
-
-	mmio_clrsetbits_32(ddrphyc_base + DDRPHYC_DSGCR,
-			   DDRPHYC_DSGCR_ODTPDD_MASK,
-			   DDRPHYC_DSGCR_ODTPDD_0);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACIOCR, publ->aciocr_sr);
 
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DSGCR, DDRPHYC_DSGCR_NL2PD);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DXCCR, publ->dxccr_sr);
 
-	mmio_clrsetbits_32(ddrphyc_base + DDRPHYC_DSGCR,
-			   DDRPHYC_DSGCR_CKEPDD_MASK,
-			   DDRPHYC_DSGCR_CKEPDD_0);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DSGCR, publ->dsgcr_pd);
 
-	/* Disable PZQ cell (PUBL register) */
+	/* Disable PZQ cell (PUBL register), ZDATA is updated by calibration */
 	mmio_setbits_32(ddrphyc_base + DDRPHYC_ZQ0CR0, DDRPHYC_ZQ0CRN_ZQPD);
 
 	/* Set latch */
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DSGCR, DDRPHYC_DSGCR_CKOE);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DSGCR, publ->dsgcr_sr);
 
 	/* Additional delay to avoid early latch */
 	udelay(DDR_DELAY_10US);
@@ -109,22 +237,13 @@ static int ddr_sw_self_refresh_in(void)
 	stm32mp1_clk_rcc_regs_unlock();
 
 	/* Disable all DLLs: GLITCH window */
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_ACDLLCR,
-			DDRPHYC_ACDLLCR_DLLDIS);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACDLLCR,
+		      publ->acdllcr | DDRPHYC_ACDLLCR_DLLDIS);
 
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DX0DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DX1DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-
-#if STM32MP_DDR_32BIT_INTERFACE
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DX2DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DX3DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-#endif
+	for (i = 0U; i < ARRAY_SIZE(ddr_sr_dxndllcr); i++) {
+		mmio_write_32(ddrphyc_base + ddr_sr_dxndllcr[i],
+			      publ->dxndllcr[i] | DDRPHYC_DXNDLLCR_DLLDIS);
+	}
 
 	stm32mp1_clk_rcc_regs_lock();
 
@@ -161,6 +280,13 @@ int ddr_sw_self_refresh_exit(void)
 	uintptr_t pwr_base = stm32mp_pwr_base();
 	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
 	uintptr_t ddrphyc_base = stm32mp_ddrphyc_base();
+	struct ddr_sr_publ *publ = &ddr_sr_publ;
+	unsigned int i;
+
+	/* Self-Refresh was entered from BL2 when waking up from Standby */
+	if (!ddr_sr_publ_valid) {
+		ddr_sr_publ_init();
+	}
 
 	/* Enable all clocks */
 	ddr_enable_clock();
@@ -183,22 +309,12 @@ int ddr_sw_self_refresh_exit(void)
 	stm32mp1_clk_rcc_regs_unlock();
 
 	/* Enable all DLLs: GLITCH window */
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACDLLCR,
-			DDRPHYC_ACDLLCR_DLLDIS);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DX0DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACDLLCR, publ->acdllcr);
 
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DX1DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-
-#if STM32MP_DDR_32BIT_INTERFACE
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DX2DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DX3DLLCR,
-			DDRPHYC_DXNDLLCR_DLLDIS);
-#endif
+	for (i = 0U; i < ARRAY_SIZE(ddr_sr_dxndllcr); i++) {
+		mmio_write_32(ddrphyc_base + ddr_sr_dxndllcr[i],
+			      publ->dxndllcr[i]);
+	}
 
 	/* Additional delay to avoid early DLL clock switch */
 	udelay(DDR_DELAY_50US);
@@ -208,13 +324,13 @@ int ddr_sw_self_refresh_exit(void)
 	mmio_clrbits_32(rcc_base + RCC_DDRITFCR, RCC_DDRITFCR_GSKPCTRL);
 	stm32mp1_clk_rcc_regs_unlock();
 
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACDLLCR,
-			DDRPHYC_ACDLLCR_DLLSRST);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACDLLCR,
+		      publ->acdllcr & ~DDRPHYC_ACDLLCR_DLLSRST);
 
 	udelay(DDR_DELAY_10US);
 
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_ACDLLCR,
-			DDRPHYC_ACDLLCR_DLLSRST);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACDLLCR,
+		      publ->acdllcr | DDRPHYC_ACDLLCR_DLLSRST);
 
 	/* PHY partial init: (DLL lock and ITM reset) */
 	mmio_write_32(ddrphyc_base + DDRPHYC_PIR,
@@ -255,31 +371,17 @@ int ddr_sw_self_refresh_exit(void)
 	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ZQ0CR0, DDRPHYC_ZQ0CRN_ZQPD);
 
 	/* Enable pad drivers */
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACIOCR, DDRPHYC_ACIOCR_ACPDD);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACIOCR, publ->aciocr_pu);
 
 	/* Enable command/address output driver */
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_ACIOCR, DDRPHYC_ACIOCR_ACOE);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACIOCR,
-			DDRPHYC_ACIOCR_CKPDD_MASK);
+	mmio_write_32(ddrphyc_base + DDRPHYC_ACIOCR, publ->aciocr_run);
 
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_ACIOCR,
-			DDRPHYC_ACIOCR_CSPDD_MASK);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DXCCR, DDRPHYC_DXCCR_DXPDD);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DXCCR, DDRPHYC_DXCCR_DXPDR);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DXCCR, publ->dxccr_run);
 
 	/* Release latch */
-	mmio_setbits_32(ddrphyc_base + DDRPHYC_DSGCR, DDRPHYC_DSGCR_CKOE);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DSGCR,
-			DDRPHYC_DSGCR_ODTPDD_MASK);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DSGCR, publ->dsgcr_unlatch);
 
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DSGCR, DDRPHYC_DSGCR_NL2PD);
-
-	mmio_clrbits_32(ddrphyc_base + DDRPHYC_DSGCR,
-			DDRPHYC_DSGCR_CKEPDD_MASK);
+	mmio_write_32(ddrphyc_base + DDRPHYC_DSGCR, publ->dsgcr_run);
 
 	/* Remove selfrefresh */
 	stm32mp_ddr_sw_selfref_exit((struct stm32mp_ddrctl *)ddrctrl_base);
@@ -331,212 +433,508 @@ int ddr_standby_sr_entry(void)
 	return 0;
 }
 
-static void ddr_sr_mode_ssr(void)
+static void ddr_sr_mode_apply(const struct ddr_sr_mode_cfg *cfg)
 {
-	uintptr_t rcc_ddritfcr = stm32mp_rcc_base() + RCC_DDRITFCR;
 	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
+	bool hw_lp_en = (mmio_read_32(ddrctrl_base + DDRCTRL_HWLPCTL) &
+			 DDRCTRL_HWLPCTL_HW_LP_EN) != 0U;
+	uint32_t selfref_to = mmio_read_32(ddrctrl_base + DDRCTRL_PWRTMG) &
+			      DDRCTRL_PWRTMG_SELFREF_TO_X32_MASK;
 
 	stm32mp1_clk_rcc_regs_lock();
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC1LPEN);
+	mmio_clrsetbits_32(stm32mp_rcc_base() + RCC_DDRITFCR, cfg->rcc_clr,
+			   cfg->rcc_set);
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC1EN);
+	stm32mp1_clk_rcc_regs_unlock();
 
-#if STM32MP_DDR_DUAL_AXI_PORT
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC2LPEN);
+	/*
+	 * Update conditions of the quasi-dynamic registers block the AXI
+	 * ports and the host interface: skip them when the HW LP interface
+	 * and the automatic LP modes are already configured, as on each
+	 * low power entry in the same mode.
+	 */
+	if ((hw_lp_en != cfg->hw_lp_en) ||
+	    (selfref_to != DDRCTRL_PWRTMG_SELFREF_TO_X32_0)) {
+		/*
+		 * Manage quasi-dynamic registers modification
+		 * hwlpctl.hw_lp_en : Group 3
+		 * pwrtmg.selfref_to_x32 & powerdown_to_x32 : Group 4
+		 * Group 3 is the most restrictive, apply its conditions for all
+		 */
+		stm32mp_ddr_set_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+
+		/* Configure HW LP interface of uMCTL2 */
+		if (cfg->hw_lp_en) {
+			mmio_setbits_32(ddrctrl_base + DDRCTRL_HWLPCTL,
+					DDRCTRL_HWLPCTL_HW_LP_EN);
+		} else {
+			mmio_clrbits_32(ddrctrl_base + DDRCTRL_HWLPCTL,
+					DDRCTRL_HWLPCTL_HW_LP_EN);
+		}
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC2EN);
-#endif
+		/* Configure Automatic LP modes of uMCTL2 */
+		mmio_clrsetbits_32(ddrctrl_base + DDRCTRL_PWRTMG,
+				   DDRCTRL_PWRTMG_SELFREF_TO_X32_MASK,
+				   DDRCTRL_PWRTMG_SELFREF_TO_X32_0);
+
+		stm32mp_ddr_unset_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	}
+
+	/*
+	 * Clock disable with LP modes (used in RUN mode for LPDDR2 with
+	 * specific timing) and automatic Self-Refresh mode.
+	 */
+	mmio_clrsetbits_32(ddrctrl_base + DDRCTRL_PWRCTL, cfg->pwrctl_clr,
+			   cfg->pwrctl_set);
+}
+
+enum stm32mp1_ddr_sr_mode ddr_read_sr_mode(void)
+{
+	uint32_t pwrctl = mmio_read_32(stm32mp_ddrctrl_base() + DDRCTRL_PWRCTL);
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRCAPBLPEN);
+	switch (pwrctl & (DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE |
+			  DDRCTRL_PWRCTL_SELFREF_EN)) {
+	case 0U:
+		return DDR_SSR_MODE;
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRPHYCAPBLPEN);
+	case DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE:
+		return DDR_HSR_MODE;
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRCAPBEN);
+	case DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE | DDRCTRL_PWRCTL_SELFREF_EN:
+		return DDR_ASR_MODE;
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRPHYCAPBEN);
+	default:
+		return DDR_SR_MODE_INVALID;
+	}
+}
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRPHYCEN);
+void ddr_set_sr_mode(enum stm32mp1_ddr_sr_mode mode)
+{
+	switch (mode) {
+	case DDR_SSR_MODE:
+	case DDR_HSR_MODE:
+	case DDR_ASR_MODE:
+		ddr_sr_mode_apply(&ddr_sr_mode_cfg[mode]);
+		break;
 
-	mmio_clrbits_32(rcc_ddritfcr, RCC_DDRITFCR_AXIDCGEN);
+	default:
+		ERROR("Unknown Self Refresh mode\n");
+		panic();
+	}
+}
 
-	mmio_clrbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRCKMOD_MASK);
+#if STM32MP_DDR_FREQ_SCALING
+/*
+ * PLL2 and DDRCTRL registers values of a DDR frequency mode. The nominal
+ * values are the ones set by BL2 from the DT, the low speed ones halve the
+ * PLL2 R output, which only feeds the DDR.
+ */
+struct ddr_freq_set {
+	uint32_t pll2cfgr2;
+	uint32_t rfshtmg;
+};
 
-	stm32mp1_clk_rcc_regs_unlock();
+static struct ddr_freq_set ddr_freq_set[DDR_FREQ_NB];
+static bool ddr_freq_set_valid;
 
-	/*
-	 * Manage quasi-dynamic registers modification
-	 * hwlpctl.hw_lp_en : Group 3
-	 * pwrtmg.selfref_to_x32 & powerdown_to_x32 : Group 4
-	 * Group 3 is the most restrictive, apply its conditions for all
-	 */
-	stm32mp_ddr_set_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+static int ddr_freq_set_init(void)
+{
+	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
+	struct ddr_freq_set *nominal = &ddr_freq_set[DDR_FREQ_NOMINAL];
+	struct ddr_freq_set *low = &ddr_freq_set[DDR_FREQ_LOW];
+	uint32_t divr;
+	uint32_t trefi;
+
+	/* DDR3 DLL on mode and CAS write latency depend on the frequency */
+	if ((mmio_read_32(ddrctrl_base + DDRCTRL_MSTR) &
+	     DDRCTRL_MSTR_DDR3) != 0U) {
+		return -ENOTSUP;
+	}
 
-	/* Disable HW LP interface of uMCTL2 */
-	mmio_clrbits_32(ddrctrl_base + DDRCTRL_HWLPCTL,
-			DDRCTRL_HWLPCTL_HW_LP_EN);
+	nominal->pll2cfgr2 = mmio_read_32(stm32mp_rcc_base() + RCC_PLL2CFGR2);
+	nominal->rfshtmg = mmio_read_32(ddrctrl_base + DDRCTRL_RFSHTMG);
 
-	/* Configure Automatic LP modes of uMCTL2 */
-	mmio_clrsetbits_32(ddrctrl_base + DDRCTRL_PWRTMG,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_MASK,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_0);
+	/* PLL2 R divider is DIVR + 1 */
+	divr = (nominal->pll2cfgr2 & RCC_PLL2CFGR2_DIVR_MASK) >>
+	       RCC_PLL2CFGR2_DIVR_SHIFT;
+	divr = (2U * divr) + 1U;
+	if (divr > (RCC_PLL2CFGR2_DIVR_MASK >> RCC_PLL2CFGR2_DIVR_SHIFT)) {
+		return -EINVAL;
+	}
 
-	stm32mp_ddr_unset_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	low->pll2cfgr2 = (nominal->pll2cfgr2 & ~RCC_PLL2CFGR2_DIVR_MASK) |
+			 (divr << RCC_PLL2CFGR2_DIVR_SHIFT);
 
 	/*
-	 * Disable Clock disable with LP modes
-	 * (used in RUN mode for LPDDR2 with specific timing).
+	 * Keep the average refresh interval, in half as many clock cycles.
+	 * Other timings are minimum delays, longer at low speed.
 	 */
-	mmio_clrbits_32(ddrctrl_base + DDRCTRL_PWRCTL,
-			DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE);
+	trefi = (nominal->rfshtmg & DDRCTRL_RFSHTMG_T_RFC_NOM_X1_X32_MASK) >>
+		DDRCTRL_RFSHTMG_T_RFC_NOM_X1_X32_SHIFT;
+	if (trefi < 2U) {
+		return -EINVAL;
+	}
 
-	/* Disable automatic Self-Refresh mode */
-	mmio_clrbits_32(ddrctrl_base + DDRCTRL_PWRCTL,
-			DDRCTRL_PWRCTL_SELFREF_EN);
+	low->rfshtmg = (nominal->rfshtmg &
+			~DDRCTRL_RFSHTMG_T_RFC_NOM_X1_X32_MASK) |
+		       ((trefi / 2U) << DDRCTRL_RFSHTMG_T_RFC_NOM_X1_X32_SHIFT);
+
+	ddr_freq_set_valid = true;
+
+	return 0;
 }
 
-static void ddr_sr_mode_asr(void)
+/* Only called in Self-Refresh, with the DDR clocks and DLLs off */
+static void ddr_freq_set_pll2(const struct ddr_freq_set *set)
 {
-	uintptr_t rcc_ddritfcr = stm32mp_rcc_base() + RCC_DDRITFCR;
-	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
+	uintptr_t rcc_base = stm32mp_rcc_base();
 
 	stm32mp1_clk_rcc_regs_lock();
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_AXIDCGEN);
-
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC1LPEN);
-
-#if STM32MP_DDR_DUAL_AXI_PORT
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC2LPEN);
-#endif
+	mmio_clrbits_32(rcc_base + RCC_PLL2CR, RCC_PLLNCR_DIVREN);
+	mmio_write_32(rcc_base + RCC_PLL2CFGR2, set->pll2cfgr2);
+	mmio_setbits_32(rcc_base + RCC_PLL2CR, RCC_PLLNCR_DIVREN);
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRPHYCLPEN);
+	stm32mp1_clk_rcc_regs_unlock();
+}
 
-	mmio_clrsetbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRCKMOD_MASK,
-			   RCC_DDRITFCR_DDRCKMOD_ASR1);
+/*
+ * Update the refresh interval and run again the DQS gate and read valid
+ * trainings for the new frequency, with the auto refresh and power down
+ * disabled, as BL2 does when exiting from Standby.
+ */
+static int ddr_freq_train(const struct ddr_freq_set *set)
+{
+	struct stm32mp_ddrctl *ctl =
+		(struct stm32mp_ddrctl *)stm32mp_ddrctrl_base();
+	uintptr_t ddrphyc_base = stm32mp_ddrphyc_base();
+	uint32_t rfshctl3 = mmio_read_32((uintptr_t)&ctl->rfshctl3);
+	uint32_t pwrctl = mmio_read_32((uintptr_t)&ctl->pwrctl);
+	uint64_t timeout;
+	uint32_t pgsr;
 
-	stm32mp1_clk_rcc_regs_unlock();
+	if (stm32mp_ddr_disable_axi_port(ctl) != 0) {
+		return -1;
+	}
 
 	/*
 	 * Manage quasi-dynamic registers modification
-	 * hwlpctl.hw_lp_en : Group 3
-	 * pwrtmg.selfref_to_x32 & powerdown_to_x32 : Group 4
-	 * Group 3 is the most restrictive, apply its conditions for all
+	 * dfimisc.dfi_init_complete_en : Group 3
 	 */
-	stm32mp_ddr_set_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	stm32mp_ddr_disable_host_interface(ctl);
+	stm32mp_ddr_start_sw_done(ctl);
+
+	mmio_setbits_32((uintptr_t)&ctl->rfshctl3,
+			DDRCTRL_RFSHCTL3_DIS_AUTO_REFRESH);
+	mmio_write_32((uintptr_t)&ctl->rfshtmg, set->rfshtmg);
+	stm32mp_ddr_wait_refresh_update_done_ack(ctl);
 
-	/* Enable HW LP interface of uMCTL2 */
-	mmio_setbits_32(ddrctrl_base + DDRCTRL_HWLPCTL,
-			DDRCTRL_HWLPCTL_HW_LP_EN);
+	mmio_clrbits_32((uintptr_t)&ctl->pwrctl, DDRCTRL_PWRCTL_POWERDOWN_EN |
+						 DDRCTRL_PWRCTL_SELFREF_EN);
+	mmio_clrbits_32((uintptr_t)&ctl->dfimisc,
+			DDRCTRL_DFIMISC_DFI_INIT_COMPLETE_EN);
 
-	/* Configure Automatic LP modes of uMCTL2 */
-	mmio_clrsetbits_32(ddrctrl_base + DDRCTRL_PWRTMG,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_MASK,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_0);
+	stm32mp_ddr_wait_sw_done_ack(ctl);
+	stm32mp_ddr_enable_host_interface(ctl);
 
-	stm32mp_ddr_unset_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	mmio_write_32(ddrphyc_base + DDRPHYC_PIR,
+		      DDRPHYC_PIR_QSTRN | DDRPHYC_PIR_RVTRN |
+		      DDRPHYC_PIR_INIT);
 
-	/*
-	 * Enable Clock disable with LP modes
-	 * (used in RUN mode for LPDDR2 with specific timing).
-	 */
-	mmio_setbits_32(ddrctrl_base + DDRCTRL_PWRCTL,
-			DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE);
+	/* Need to wait 10 configuration clock before start polling */
+	udelay(DDR_DELAY_10US);
+
+	timeout = timeout_init_us(DDR_TIMEOUT_US_1S);
+	do {
+		pgsr = mmio_read_32(ddrphyc_base + DDRPHYC_PGSR);
+
+		if (((pgsr & (DDRPHYC_PGSR_DTERR | DDRPHYC_PGSR_DTIERR |
+			      DDRPHYC_PGSR_DFTERR | DDRPHYC_PGSR_RVERR |
+			      DDRPHYC_PGSR_RVEIRR)) != 0U) ||
+		    timeout_elapsed(timeout)) {
+			return -1;
+		}
+	} while ((pgsr & DDRPHYC_PGSR_IDONE) == 0U);
+
+	stm32mp_ddr_disable_host_interface(ctl);
+	stm32mp_ddr_start_sw_done(ctl);
+
+	if ((rfshctl3 & DDRCTRL_RFSHCTL3_DIS_AUTO_REFRESH) == 0U) {
+		mmio_clrbits_32((uintptr_t)&ctl->rfshctl3,
+				DDRCTRL_RFSHCTL3_DIS_AUTO_REFRESH);
+		stm32mp_ddr_wait_refresh_update_done_ack(ctl);
+	}
+
+	mmio_setbits_32((uintptr_t)&ctl->pwrctl,
+			pwrctl & (DDRCTRL_PWRCTL_POWERDOWN_EN |
+				  DDRCTRL_PWRCTL_SELFREF_EN));
+	mmio_setbits_32((uintptr_t)&ctl->dfimisc,
+			DDRCTRL_DFIMISC_DFI_INIT_COMPLETE_EN);
+
+	stm32mp_ddr_wait_sw_done_ack(ctl);
+	stm32mp_ddr_enable_host_interface(ctl);
 
-	/* Enable automatic Self-Refresh for ASR mode */
-	mmio_setbits_32(ddrctrl_base + DDRCTRL_PWRCTL,
-			DDRCTRL_PWRCTL_SELFREF_EN);
+	stm32mp_ddr_enable_axi_port(ctl);
+
+	return 0;
 }
 
-static void ddr_sr_mode_hsr(void)
+/*
+ * Change the DDR frequency in SW Self-Refresh. The caller runs from SYSRAM,
+ * the other masters are stalled on the DDR AXI ports meanwhile.
+ */
+int ddr_set_freq_mode(enum stm32mp1_ddr_freq_mode mode)
 {
-	uintptr_t rcc_ddritfcr = stm32mp_rcc_base() + RCC_DDRITFCR;
-	uintptr_t ddrctrl_base = stm32mp_ddrctrl_base();
+	enum stm32mp1_ddr_sr_mode sr_mode;
+	const struct ddr_freq_set *set;
+	int ret;
 
-	stm32mp1_clk_rcc_regs_lock();
+	if (mode >= DDR_FREQ_NB) {
+		return -EINVAL;
+	}
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_AXIDCGEN);
+	if (!ddr_freq_set_valid) {
+		ret = ddr_freq_set_init();
+		if (ret != 0) {
+			return ret;
+		}
+	}
 
-	mmio_clrbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC1LPEN);
+	if (mode == ddr_get_freq_mode()) {
+		return 0;
+	}
 
-#if STM32MP_DDR_DUAL_AXI_PORT
-	mmio_clrbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRC2LPEN);
-#endif
+	set = &ddr_freq_set[mode];
 
-	mmio_setbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRPHYCLPEN);
+	sr_mode = ddr_read_sr_mode();
+	if (sr_mode != DDR_SSR_MODE) {
+		ddr_set_sr_mode(DDR_SSR_MODE);
+	}
 
-	mmio_clrsetbits_32(rcc_ddritfcr, RCC_DDRITFCR_DDRCKMOD_MASK,
-			   RCC_DDRITFCR_DDRCKMOD_HSR1);
+	if (ddr_sw_self_refresh_in() != 0) {
+		if (sr_mode != DDR_SSR_MODE) {
+			ddr_set_sr_mode(sr_mode);
+		}
 
-	stm32mp1_clk_rcc_regs_unlock();
+		return -EIO;
+	}
 
-	/*
-	 * Manage quasi-dynamic registers modification
-	 * hwlpctl.hw_lp_en : Group 3
-	 * pwrtmg.selfref_to_x32 & powerdown_to_x32 : Group 4
-	 * Group 3 is the most restrictive, apply its conditions for all
-	 */
-	stm32mp_ddr_set_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	ddr_freq_set_pll2(set);
 
-	/* Enable HW LP interface of uMCTL2 */
-	mmio_setbits_32(ddrctrl_base + DDRCTRL_HWLPCTL,
-			DDRCTRL_HWLPCTL_HW_LP_EN);
+	/* The DDR content is lost if it cannot run again */
+	if ((ddr_sw_self_refresh_exit() != 0) || (ddr_freq_train(set) != 0)) {
+		ERROR("DDR frequency change failed\n");
+		panic();
+	}
 
-	/* Configure Automatic LP modes of uMCTL2 */
-	mmio_clrsetbits_32(ddrctrl_base + DDRCTRL_PWRTMG,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_MASK,
-			   DDRCTRL_PWRTMG_SELFREF_TO_X32_0);
+	if (sr_mode != DDR_SSR_MODE) {
+		ddr_set_sr_mode(sr_mode);
+	}
 
-	stm32mp_ddr_unset_qd3_update_conditions((struct stm32mp_ddrctl *)ddrctrl_base);
+	return 0;
+}
+
+/* BL2 restores the nominal frequency when exiting from Standby */
+enum stm32mp1_ddr_freq_mode ddr_get_freq_mode(void)
+{
+	if (ddr_freq_set_valid &&
+	    (mmio_read_32(stm32mp_rcc_base() + RCC_PLL2CFGR2) ==
+	     ddr_freq_set[DDR_FREQ_LOW].pll2cfgr2)) {
+		return DDR_FREQ_LOW;
+	}
+
+	return DDR_FREQ_NOMINAL;
+}
+#endif /* STM32MP_DDR_FREQ_SCALING */
+
+#if STM32MP_DDR_QOS_PROFILES
+/*
+ * DDRCTRL QoS profiles: profile 0 holds the boot settings, from st,ctl-perf
+ * of the DDR node, next ones the st,ctl-perf of each st,qos-profiles
+ * subnode, in DT order.
+ */
+#define DDR_QOS_PROFILES_MAX	4U
+
+static struct stm32mp1_ddrctrl_perf ddr_qos_profile[DDR_QOS_PROFILES_MAX];
+static unsigned int ddr_qos_profile_nb;
+static spinlock_t ddr_qos_lock;
+
+static int ddr_qos_read_profile(void *fdt, int node,
+				struct stm32mp1_ddrctrl_perf *perf)
+{
+	return fdt_read_uint32_array(fdt, node, "st,ctl-perf",
+				     sizeof(*perf) / sizeof(uint32_t),
+				     (uint32_t *)perf);
+}
+
+static int ddr_qos_profiles_init(void)
+{
+	void *fdt;
+	int node;
+	int subnode;
+
+	if (fdt_get_address(&fdt) == 0) {
+		return -ENOENT;
+	}
+
+	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	if ((node < 0) ||
+	    (ddr_qos_read_profile(fdt, node, &ddr_qos_profile[0]) != 0)) {
+		return -EINVAL;
+	}
+
+	ddr_qos_profile_nb = 1U;
+
+	node = fdt_subnode_offset(fdt, node, "st,qos-profiles");
+	if (node < 0) {
+		return 0;
+	}
+
+	fdt_for_each_subnode(subnode, fdt, node) {
+		struct stm32mp1_ddrctrl_perf *perf =
+			&ddr_qos_profile[ddr_qos_profile_nb];
+
+		if (ddr_qos_profile_nb == DDR_QOS_PROFILES_MAX) {
+			WARN("DDR: too many QoS profiles\n");
+			break;
+		}
+
+		if (ddr_qos_read_profile(fdt, subnode, perf) != 0) {
+			return -EINVAL;
+		}
+
+		/* SCHED.lpr_num_entries is static, scheduler is not updated */
+		if ((perf->sched != ddr_qos_profile[0].sched) ||
+		    (perf->sched1 != ddr_qos_profile[0].sched1)) {
+			ERROR("DDR: QoS profile %s changes SCHED\n",
+			      fdt_get_name(fdt, subnode, NULL));
+			return -EINVAL;
+		}
+
+		ddr_qos_profile_nb++;
+	}
+
+	return 0;
+}
+
+static bool ddr_qos_profile_is_set(const struct stm32mp1_ddrctrl_perf *perf)
+{
+	struct stm32mp_ddrctl *ctl =
+		(struct stm32mp_ddrctl *)stm32mp_ddrctrl_base();
+
+	return (mmio_read_32((uintptr_t)&ctl->perfhpr1) == perf->perfhpr1) &&
+	       (mmio_read_32((uintptr_t)&ctl->perflpr1) == perf->perflpr1) &&
+	       (mmio_read_32((uintptr_t)&ctl->perfwr1) == perf->perfwr1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgr_0) == perf->pcfgr_0) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgw_0) == perf->pcfgw_0) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgqos0_0) == perf->pcfgqos0_0) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgqos1_0) == perf->pcfgqos1_0) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgwqos0_0) ==
+		perf->pcfgwqos0_0) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgwqos1_0) ==
+		perf->pcfgwqos1_0)
+#if STM32MP_DDR_DUAL_AXI_PORT
+	       && (mmio_read_32((uintptr_t)&ctl->pcfgr_1) == perf->pcfgr_1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgw_1) == perf->pcfgw_1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgqos0_1) == perf->pcfgqos0_1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgqos1_1) == perf->pcfgqos1_1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgwqos0_1) ==
+		perf->pcfgwqos0_1) &&
+	       (mmio_read_32((uintptr_t)&ctl->pcfgwqos1_1) ==
+		perf->pcfgwqos1_1)
+#endif
+	       ;
+}
+
+static void ddr_qos_profile_apply(const struct stm32mp1_ddrctrl_perf *perf)
+{
+	struct stm32mp_ddrctl *ctl =
+		(struct stm32mp_ddrctl *)stm32mp_ddrctrl_base();
 
 	/*
-	 * Enable Clock disable with LP modes
-	 * (used in RUN mode for LPDDR2 with specific timing).
+	 * Manage quasi-dynamic registers modification
+	 * Group 3 is the most restrictive, apply its conditions for all.
+	 * AXI ports are idle and the host interface is disabled meanwhile,
+	 * so that the ports never run with a mix of two profiles.
 	 */
-	mmio_setbits_32(ddrctrl_base + DDRCTRL_PWRCTL,
-			DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE);
+	stm32mp_ddr_set_qd3_update_conditions(ctl);
+
+	mmio_write_32((uintptr_t)&ctl->perfhpr1, perf->perfhpr1);
+	mmio_write_32((uintptr_t)&ctl->perflpr1, perf->perflpr1);
+	mmio_write_32((uintptr_t)&ctl->perfwr1, perf->perfwr1);
+	mmio_write_32((uintptr_t)&ctl->pcfgr_0, perf->pcfgr_0);
+	mmio_write_32((uintptr_t)&ctl->pcfgw_0, perf->pcfgw_0);
+	mmio_write_32((uintptr_t)&ctl->pcfgqos0_0, perf->pcfgqos0_0);
+	mmio_write_32((uintptr_t)&ctl->pcfgqos1_0, perf->pcfgqos1_0);
+	mmio_write_32((uintptr_t)&ctl->pcfgwqos0_0, perf->pcfgwqos0_0);
+	mmio_write_32((uintptr_t)&ctl->pcfgwqos1_0, perf->pcfgwqos1_0);
+#if STM32MP_DDR_DUAL_AXI_PORT
+	mmio_write_32((uintptr_t)&ctl->pcfgr_1, perf->pcfgr_1);
+	mmio_write_32((uintptr_t)&ctl->pcfgw_1, perf->pcfgw_1);
+	mmio_write_32((uintptr_t)&ctl->pcfgqos0_1, perf->pcfgqos0_1);
+	mmio_write_32((uintptr_t)&ctl->pcfgqos1_1, perf->pcfgqos1_1);
+	mmio_write_32((uintptr_t)&ctl->pcfgwqos0_1, perf->pcfgwqos0_1);
+	mmio_write_32((uintptr_t)&ctl->pcfgwqos1_1, perf->pcfgwqos1_1);
+#endif
+
+	stm32mp_ddr_unset_qd3_update_conditions(ctl);
 }
 
-enum stm32mp1_ddr_sr_mode ddr_read_sr_mode(void)
+int ddr_qos_set_profile(unsigned int id)
 {
-	uint32_t pwrctl = mmio_read_32(stm32mp_ddrctrl_base() + DDRCTRL_PWRCTL);
+	int ret = 0;
 
-	switch (pwrctl & (DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE |
-			  DDRCTRL_PWRCTL_SELFREF_EN)) {
-	case 0U:
-		return DDR_SSR_MODE;
-
-	case DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE:
-		return DDR_HSR_MODE;
+	spin_lock(&ddr_qos_lock);
 
-	case DDRCTRL_PWRCTL_EN_DFI_DRAM_CLK_DISABLE | DDRCTRL_PWRCTL_SELFREF_EN:
-		return DDR_ASR_MODE;
+	if (ddr_qos_profile_nb == 0U) {
+		ret = ddr_qos_profiles_init();
+	}
 
-	default:
-		return DDR_SR_MODE_INVALID;
+	if (ret == 0) {
+		if (id >= ddr_qos_profile_nb) {
+			ret = -EINVAL;
+		} else if (!ddr_qos_profile_is_set(&ddr_qos_profile[id])) {
+			ddr_qos_profile_apply(&ddr_qos_profile[id]);
+		}
 	}
+
+	spin_unlock(&ddr_qos_lock);
+
+	return ret;
 }
 
-void ddr_set_sr_mode(enum stm32mp1_ddr_sr_mode mode)
+/*
+ * Return the number of profiles and the index of the current one, or
+ * ddr_qos_profile_nb if the DDRCTRL settings match none of them.
+ */
+int ddr_qos_get_profile(unsigned int *id, unsigned int *nb)
 {
-	switch (mode) {
-	case DDR_SSR_MODE:
-		ddr_sr_mode_ssr();
-		break;
+	unsigned int n;
+	int ret = 0;
 
-	case DDR_HSR_MODE:
-		ddr_sr_mode_hsr();
-		break;
+	spin_lock(&ddr_qos_lock);
 
-	case DDR_ASR_MODE:
-		ddr_sr_mode_asr();
-		break;
+	if (ddr_qos_profile_nb == 0U) {
+		ret = ddr_qos_profiles_init();
+	}
 
-	default:
-		ERROR("Unknown Self Refresh mode\n");
-		panic();
+	if (ret == 0) {
+		for (n = 0U; n < ddr_qos_profile_nb; n++) {
+			if (ddr_qos_profile_is_set(&ddr_qos_profile[n])) {
+				break;
+			}
+		}
+
+		*id = n;
+		*nb = ddr_qos_profile_nb;
 	}
+
+	spin_unlock(&ddr_qos_lock);
+
+	return ret;
 }
+#endif /* STM32MP_DDR_QOS_PROFILES */
 
 bool ddr_is_nonsecured_area(uintptr_t address, uint32_t length)
 {
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <common/debug.h>
+#include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <drivers/st/stm32_dts.h>
+#include <drivers/st/stm32_hash.h>
+#include <drivers/st/stm32mp1_ddr.h>
+#include <drivers/st/stm32mp1_ddr_regs.h>
+#include <drivers/st/stm32mp1_ddr_training.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/cassert.h>
+#include <lib/mmio.h>
+#include <lib/utils.h>
+
+#define DDR_TRAINING_MAGIC		0x4E525444U	/* "DTRN" */
+
+#define DDR_TRAINING_LANE_NB		4U
+#define DDR_TRAINING_DIGEST_SIZE	32U
+
+/* Results are reused within a temperature band, from -40 degrees Celsius */
+#define DDR_TRAINING_TEMP_MIN_MC	(-40000)
+#define DDR_TRAINING_TEMP_BAND_MC	20000
+#define DDR_TRAINING_TEMP_NONE		UINT32_MAX
+
+#define DDR_TRAINING_DTS_TIMEOUT_US	1000U
+
+struct ddr_training_lane {
+	uint32_t dqtr;
+	uint32_t dqstr;
+};
+
+/*
+ * Record stored at STM32MP_DDR_TRAINING_BASE in Backup SRAM, only accessible
+ * from the secure world and kept across cold boots while VBAT is supplied.
+ * The SHA-256 digest covers the record and the DDR settings it was trained
+ * with.
+ */
+struct ddr_training {
+	uint32_t magic;
+	uint32_t temp_band;
+	struct ddr_training_lane lane[DDR_TRAINING_LANE_NB];
+	uint8_t digest[DDR_TRAINING_DIGEST_SIZE];
+};
+
+CASSERT(sizeof(struct ddr_training) <= STM32MP_DDR_TRAINING_SIZE,
+	assert_ddr_training_size);
+
+/* Byte lanes DQ and DQS timing registers, updated by QSTRN and RVTRN */
+static const struct {
+	size_t dqtr;
+	size_t dqstr;
+} ddr_training_lane_reg[DDR_TRAINING_LANE_NB] = {
+	{
+		offsetof(struct stm32mp_ddrphy, dx0dqtr),
+		offsetof(struct stm32mp_ddrphy, dx0dqstr),
+	},
+	{
+		offsetof(struct stm32mp_ddrphy, dx1dqtr),
+		offsetof(struct stm32mp_ddrphy, dx1dqstr),
+	},
+	{
+		offsetof(struct stm32mp_ddrphy, dx2dqtr),
+		offsetof(struct stm32mp_ddrphy, dx2dqstr),
+	},
+	{
+		offsetof(struct stm32mp_ddrphy, dx3dqtr),
+		offsetof(struct stm32mp_ddrphy, dx3dqstr),
+	},
+};
+
+static struct {
+	uint32_t temp_band;
+	bool hash_ready;
+	bool restored;
+} ddr_training_state = {
+	.temp_band = DDR_TRAINING_TEMP_NONE,
+};
+
+static struct ddr_training *ddr_training(void)
+{
+	return (struct ddr_training *)STM32MP_DDR_TRAINING_BASE;
+}
+
+/*
+ * Temperature band read on the digital temperature sensor, when assigned to
+ * the secure world. Otherwise, the temperature is not checked and the DDR
+ * tests run after the initialization are the only guard.
+ */
+static uint32_t ddr_training_temp_band(void)
+{
+	uint64_t timeout;
+	int mcelsius = 0;
+	int ret;
+
+	if (stm32_dts_init() != 1) {
+		return DDR_TRAINING_TEMP_NONE;
+	}
+
+	/* First measurement is available after a sampling period */
+	timeout = timeout_init_us(DDR_TRAINING_DTS_TIMEOUT_US);
+	do {
+		ret = stm32_dts_get_temp(&mcelsius);
+	} while ((ret == -EAGAIN) && !timeout_elapsed(timeout));
+
+	if (ret != 0) {
+		return DDR_TRAINING_TEMP_NONE;
+	}
+
+	if (mcelsius < DDR_TRAINING_TEMP_MIN_MC) {
+		mcelsius = DDR_TRAINING_TEMP_MIN_MC;
+	}
+
+	return (uint32_t)(mcelsius - DDR_TRAINING_TEMP_MIN_MC) /
+	       (uint32_t)DDR_TRAINING_TEMP_BAND_MC;
+}
+
+static int ddr_training_digest(const struct ddr_training *record,
+			       const struct stm32mp_ddr_config *config,
+			       uint8_t *digest)
+{
+	/* Registers settings, from c_reg to p_timing, are 32-bit words */
+	size_t settings_size = offsetof(struct stm32mp_ddr_config, self_refresh) -
+			       offsetof(struct stm32mp_ddr_config, c_reg);
+	int ret;
+
+	if (!ddr_training_state.hash_ready) {
+		if (stm32_hash_register() != 0) {
+			return -ENODEV;
+		}
+
+		ddr_training_state.hash_ready = true;
+	}
+
+	stm32_hash_init(HASH_SHA256);
+
+	ret = stm32_hash_update((const uint8_t *)record,
+				offsetof(struct ddr_training, digest));
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = stm32_hash_update((const uint8_t *)&config->info.speed,
+				sizeof(config->info.speed));
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = stm32_hash_update((const uint8_t *)&config->info.size,
+				sizeof(config->info.size));
+	if (ret != 0) {
+		return ret;
+	}
+
+	return stm32_hash_final_update((const uint8_t *)&config->c_reg,
+				       settings_size, digest);
+}
+
+bool stm32mp1_ddr_training_restore(struct stm32mp_ddr_priv *priv,
+				   const struct stm32mp_ddr_config *config)
+{
+	struct ddr_training *record = ddr_training();
+	uint8_t digest[DDR_TRAINING_DIGEST_SIZE];
+	bool valid = false;
+	unsigned int i;
+
+	ddr_training_state.temp_band = ddr_training_temp_band();
+
+	clk_enable(BKPSRAM);
+
+	if ((record->magic == DDR_TRAINING_MAGIC) &&
+	    (record->temp_band == ddr_training_state.temp_band) &&
+	    (ddr_training_digest(record, config, digest) == 0) &&
+	    (timingsafe_bcmp(digest, record->digest, sizeof(digest)) == 0)) {
+		for (i = 0U; i < DDR_TRAINING_LANE_NB; i++) {
+			uintptr_t phy = (uintptr_t)priv->phy;
+
+			mmio_write_32(phy + ddr_training_lane_reg[i].dqtr,
+				      record->lane[i].dqtr);
+			mmio_write_32(phy + ddr_training_lane_reg[i].dqstr,
+				      record->lane[i].dqstr);
+		}
+
+		valid = true;
+	}
+
+	clk_disable(BKPSRAM);
+
+	ddr_training_state.restored = valid;
+
+	VERBOSE("DDR DQS training %s\n", valid ? "restored" : "required");
+
+	return valid;
+}
+
+void stm32mp1_ddr_training_save(struct stm32mp_ddr_priv *priv,
+				const struct stm32mp_ddr_config *config)
+{
+	struct ddr_training *record = ddr_training();
+	struct ddr_training update;
+	unsigned int i;
+
+	if (ddr_training_state.restored) {
+		/* Saved results are unchanged */
+		return;
+	}
+
+	zeromem(&update, sizeof(update));
+	update.magic = DDR_TRAINING_MAGIC;
+	update.temp_band = ddr_training_state.temp_band;
+
+	for (i = 0U; i < DDR_TRAINING_LANE_NB; i++) {
+		uintptr_t phy = (uintptr_t)priv->phy;
+
+		update.lane[i].dqtr =
+			mmio_read_32(phy + ddr_training_lane_reg[i].dqtr);
+		update.lane[i].dqstr =
+			mmio_read_32(phy + ddr_training_lane_reg[i].dqstr);
+	}
+
+	if (ddr_training_digest(&update, config, update.digest) != 0) {
+		WARN("DDR training results not saved\n");
+		stm32mp1_ddr_training_invalidate();
+		return;
+	}
+
+	clk_enable(BKPSRAM);
+	memcpy(record, &update, sizeof(update));
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_ddr_training_invalidate(void)
+{
+	clk_enable(BKPSRAM);
+	zeromem(ddr_training(), sizeof(struct ddr_training));
+	clk_disable(BKPSRAM);
+
+	ddr_training_state.restored = false;
+}
@@ -19,6 +19,7 @@
 #include <drivers/st/stm32mp_ram.h>
 #include <drivers/st/stm32mp1_ddr.h>
 #include <drivers/st/stm32mp1_ddr_helpers.h>
+#include <drivers/st/stm32mp1_ddr_training.h>
 #include <drivers/st/stm32mp1_ram.h>
 #include <lib/mmio.h>
 
@@ -52,6 +53,13 @@ int stm32mp1_ddr_clk_enable(struct stm32mp_ddr_priv *priv, uint32_t mem_speed)
 	return 0;
 }
 
+/* Next cold boot runs the DQS training, results restored could be wrong */
+static void __dead2 ddr_cold_boot_test_failed(void)
+{
+	stm32mp1_ddr_training_invalidate();
+	panic();
+}
+
 static int stm32mp1_ddr_setup(void)
 {
 	struct stm32mp_ddr_priv *priv = &ddr_priv_data;
@@ -129,22 +137,30 @@ static int stm32mp1_ddr_setup(void)
 		if (uret != 0U) {
 			ERROR("DDR data bus test: can't access memory @ 0x%x\n",
 			      uret);
-			panic();
+			ddr_cold_boot_test_failed();
 		}
 
 		uret = stm32mp_ddr_test_addr_bus(config.info.size);
 		if (uret != 0U) {
 			ERROR("DDR addr bus test: can't access memory @ 0x%x\n",
 			      uret);
-			panic();
+			ddr_cold_boot_test_failed();
 		}
 
 		uret = stm32mp_ddr_check_size();
 		if (uret < config.info.size) {
 			ERROR("DDR size: 0x%x does not match DT config: 0x%x\n",
 			      uret, config.info.size);
-			panic();
+			ddr_cold_boot_test_failed();
 		}
+
+		uret = stm32mp_ddr_test_full(config.info.size);
+		if (uret != 0U) {
+			ERROR("DDR full test: error @ 0x%x\n", uret);
+			ddr_cold_boot_test_failed();
+		}
+
+		stm32mp1_ddr_training_save(priv, &config);
 	}
 
 	/*
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/delay_timer.h>
+#include <drivers/st/stm32_iwdg.h>
+#include <drivers/st/stm32mp_ddr_test.h>
+#include <lib/mmio.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp1_bl2_smp.h>
+
+#define DDR_TEST_BLOCK_SIZE		64U
+#define DDR_TEST_BLOCK_WORDS		(DDR_TEST_BLOCK_SIZE / sizeof(uint32_t))
+
+/* Range tested between two watchdog refreshes */
+#define DDR_TEST_SLICE_SIZE		U(0x01000000)
+#define DDR_TEST_SMP_POLL_US		100U
+
+/* Failing words reported per test and per core */
+#define DDR_TEST_FAIL_LOG		8U
+
+#define DDR_TEST_WALKING_ONES		BIT(0)
+#define DDR_TEST_CHECKERBOARD		BIT(1)
+#define DDR_TEST_MATS_PLUS		BIT(2)
+
+#define DDR_TEST_STEP_MAX		4U
+
+enum ddr_test_pattern {
+	DDR_PAT_ZEROS,
+	DDR_PAT_ONES,
+	DDR_PAT_WALK_LOW,
+	DDR_PAT_WALK_HIGH,
+	DDR_PAT_CHECKER,
+	DDR_PAT_CHECKER_INV,
+	DDR_PAT_NB
+};
+
+enum ddr_test_op {
+	DDR_TEST_FILL,
+	DDR_TEST_CHECK,
+	DDR_TEST_RW_UP,
+	DDR_TEST_RW_DOWN,
+};
+
+struct ddr_test_step {
+	enum ddr_test_op op;
+	enum ddr_test_pattern expect;
+	enum ddr_test_pattern write;
+};
+
+struct ddr_test {
+	const char *name;
+	uint32_t id;
+	unsigned int nb_steps;
+	struct ddr_test_step step[DDR_TEST_STEP_MAX];
+};
+
+struct ddr_test_fail {
+	uintptr_t addr;
+	uint32_t data;
+	uint32_t expect;
+};
+
+/* Range tested by one core, with the failures it found */
+struct ddr_test_part {
+	uintptr_t base;
+	size_t size;
+	const struct ddr_test_step *step;
+	uint32_t errors;
+	unsigned int logged;
+	struct ddr_test_fail fail[DDR_TEST_FAIL_LOG];
+};
+
+uint32_t stm32mp_ddr_test_neon_enable(void);
+void stm32mp_ddr_test_neon_restore(uint32_t fpexc);
+void stm32mp_ddr_test_neon_fill(uintptr_t addr, size_t size,
+				const uint32_t *pattern);
+uintptr_t stm32mp_ddr_test_neon_check(uintptr_t addr, size_t size,
+				      const uint32_t *pattern);
+uintptr_t stm32mp_ddr_test_neon_rw_up(uintptr_t addr, size_t size,
+				      const uint32_t *expect,
+				      const uint32_t *write);
+uintptr_t stm32mp_ddr_test_neon_rw_down(uintptr_t addr, size_t size,
+					const uint32_t *expect,
+					const uint32_t *write);
+
+/*
+ * Walking ones go through the 32 data lines, in two blocks of 16 words.
+ * MATS+ is {up or down (w0); up (r0, w1); down (r1, w0)}, on 64-byte
+ * elements: address lines below bit 6 are covered by the address bus test.
+ */
+static const struct ddr_test ddr_tests[] = {
+	{
+		.name = "walking ones",
+		.id = DDR_TEST_WALKING_ONES,
+		.nb_steps = 4U,
+		.step = {
+			{ DDR_TEST_FILL, DDR_PAT_WALK_LOW, DDR_PAT_WALK_LOW },
+			{ DDR_TEST_CHECK, DDR_PAT_WALK_LOW, DDR_PAT_WALK_LOW },
+			{ DDR_TEST_FILL, DDR_PAT_WALK_HIGH, DDR_PAT_WALK_HIGH },
+			{ DDR_TEST_CHECK, DDR_PAT_WALK_HIGH, DDR_PAT_WALK_HIGH },
+		},
+	},
+	{
+		.name = "checkerboard",
+		.id = DDR_TEST_CHECKERBOARD,
+		.nb_steps = 4U,
+		.step = {
+			{ DDR_TEST_FILL, DDR_PAT_CHECKER, DDR_PAT_CHECKER },
+			{ DDR_TEST_CHECK, DDR_PAT_CHECKER, DDR_PAT_CHECKER },
+			{ DDR_TEST_FILL, DDR_PAT_CHECKER_INV,
+			  DDR_PAT_CHECKER_INV },
+			{ DDR_TEST_CHECK, DDR_PAT_CHECKER_INV,
+			  DDR_PAT_CHECKER_INV },
+		},
+	},
+	{
+		.name = "MATS+",
+		.id = DDR_TEST_MATS_PLUS,
+		.nb_steps = 3U,
+		.step = {
+			{ DDR_TEST_FILL, DDR_PAT_ZEROS, DDR_PAT_ZEROS },
+			{ DDR_TEST_RW_UP, DDR_PAT_ZEROS, DDR_PAT_ONES },
+			{ DDR_TEST_RW_DOWN, DDR_PAT_ONES, DDR_PAT_ZEROS },
+		},
+	},
+};
+
+static uint32_t ddr_test_pattern[DDR_PAT_NB][DDR_TEST_BLOCK_WORDS];
+
+static void ddr_test_init_patterns(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DDR_TEST_BLOCK_WORDS; i++) {
+		ddr_test_pattern[DDR_PAT_ZEROS][i] = 0U;
+		ddr_test_pattern[DDR_PAT_ONES][i] = UINT32_MAX;
+		ddr_test_pattern[DDR_PAT_WALK_LOW][i] = BIT_32(i);
+		ddr_test_pattern[DDR_PAT_WALK_HIGH][i] =
+			BIT_32(i + DDR_TEST_BLOCK_WORDS);
+		ddr_test_pattern[DDR_PAT_CHECKER][i] =
+			((i & 1U) == 0U) ? 0xAAAAAAAAU : 0x55555555U;
+		ddr_test_pattern[DDR_PAT_CHECKER_INV][i] =
+			~ddr_test_pattern[DDR_PAT_CHECKER][i];
+	}
+}
+
+/* Record the failing words of a block, read back with single accesses */
+static void ddr_test_log_block(struct ddr_test_part *part, uintptr_t block,
+			       const uint32_t *expect)
+{
+	bool found = false;
+	unsigned int i;
+
+	for (i = 0U; i < DDR_TEST_BLOCK_WORDS; i++) {
+		uintptr_t addr = block + (i * sizeof(uint32_t));
+		uint32_t data = mmio_read_32(addr);
+
+		if (data == expect[i]) {
+			continue;
+		}
+
+		if (part->logged < DDR_TEST_FAIL_LOG) {
+			part->fail[part->logged].addr = addr;
+			part->fail[part->logged].data = data;
+			part->fail[part->logged].expect = expect[i];
+			part->logged++;
+		}
+
+		part->errors++;
+		found = true;
+	}
+
+	/* Transient failure, only seen by the block access */
+	if (!found) {
+		if (part->logged < DDR_TEST_FAIL_LOG) {
+			part->fail[part->logged].addr = block;
+			part->fail[part->logged].data = expect[0];
+			part->fail[part->logged].expect = expect[0];
+			part->logged++;
+		}
+
+		part->errors++;
+	}
+}
+
+static void ddr_test_write_block(uintptr_t block, const uint32_t *write)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DDR_TEST_BLOCK_WORDS; i++) {
+		mmio_write_32(block + (i * sizeof(uint32_t)), write[i]);
+	}
+}
+
+static void ddr_test_slice(struct ddr_test_part *part, uintptr_t addr,
+			   size_t size)
+{
+	const uint32_t *expect = ddr_test_pattern[part->step->expect];
+	const uint32_t *write = ddr_test_pattern[part->step->write];
+	uintptr_t end = addr + size;
+	uintptr_t fail;
+
+	switch (part->step->op) {
+	case DDR_TEST_FILL:
+		stm32mp_ddr_test_neon_fill(addr, size, write);
+		break;
+	case DDR_TEST_CHECK:
+		while (addr < end) {
+			fail = stm32mp_ddr_test_neon_check(addr, end - addr,
+							   expect);
+			if (fail == 0U) {
+				break;
+			}
+
+			ddr_test_log_block(part, fail, expect);
+			addr = fail + DDR_TEST_BLOCK_SIZE;
+		}
+		break;
+	case DDR_TEST_RW_UP:
+		while (addr < end) {
+			fail = stm32mp_ddr_test_neon_rw_up(addr, end - addr,
+							   expect, write);
+			if (fail == 0U) {
+				break;
+			}
+
+			ddr_test_log_block(part, fail, expect);
+			ddr_test_write_block(fail, write);
+			addr = fail + DDR_TEST_BLOCK_SIZE;
+		}
+		break;
+	case DDR_TEST_RW_DOWN:
+		while (end > addr) {
+			fail = stm32mp_ddr_test_neon_rw_down(addr, end - addr,
+							     expect, write);
+			if (fail == 0U) {
+				break;
+			}
+
+			ddr_test_log_block(part, fail, expect);
+			ddr_test_write_block(fail, write);
+			end = fail;
+		}
+		break;
+	default:
+		panic();
+	}
+}
+
+/* Run a step on a part, by slices in the step direction */
+static void ddr_test_part_run(struct ddr_test_part *part, bool refresh_wdg)
+{
+	uint32_t fpexc = stm32mp_ddr_test_neon_enable();
+	size_t done;
+
+	for (done = 0U; done < part->size; done += DDR_TEST_SLICE_SIZE) {
+		size_t size = MIN((size_t)DDR_TEST_SLICE_SIZE,
+				  part->size - done);
+		uintptr_t addr = part->base + done;
+
+		if (part->step->op == DDR_TEST_RW_DOWN) {
+			addr = part->base + part->size - done - size;
+		}
+
+		ddr_test_slice(part, addr, size);
+
+		if (refresh_wdg) {
+			stm32_iwdg_refresh();
+		}
+	}
+
+	stm32mp_ddr_test_neon_restore(fpexc);
+}
+
+#if STM32MP_DDR_FULL_TEST_SMP
+static int ddr_test_smp_job(void *arg)
+{
+	ddr_test_part_run(arg, false);
+
+	return 0;
+}
+#endif
+
+/*
+ * Run a step on the whole range. With STM32MP_DDR_FULL_TEST_SMP, the upper
+ * half is tested by core 1: both cores are done before the next step.
+ */
+static void ddr_test_step_run(struct ddr_test_part *part)
+{
+	bool smp = false;
+
+#if STM32MP_DDR_FULL_TEST_SMP
+	smp = stm32mp1_bl2_smp_run(ddr_test_smp_job, &part[1]) == 0;
+#endif
+
+	ddr_test_part_run(&part[0], true);
+
+	if (smp) {
+		while (stm32mp1_bl2_smp_pending()) {
+			stm32_iwdg_refresh();
+			udelay(DDR_TEST_SMP_POLL_US);
+		}
+
+		(void)stm32mp1_bl2_smp_wait();
+	} else {
+		ddr_test_part_run(&part[1], true);
+	}
+}
+
+static void ddr_test_report(const struct ddr_test *test,
+			    const struct ddr_test_part *part,
+			    uint64_t bytes, uint64_t ticks)
+{
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t time_us = 0U;
+	uint32_t errors = part[0].errors + part[1].errors;
+	unsigned int i;
+	unsigned int n;
+
+	if (freq != 0U) {
+		time_us = (ticks * 1000000U) / freq;
+	}
+
+	/* Bytes per microsecond are MB/s */
+	NOTICE("DDR %s test: %llu ms, %llu MB/s, %u errors\n", test->name,
+	       time_us / 1000U, (time_us != 0U) ? (bytes / time_us) : 0U,
+	       errors);
+
+	for (i = 0U; i < 2U; i++) {
+		for (n = 0U; n < part[i].logged; n++) {
+			ERROR("DDR %s test: @ 0x%lx read 0x%08x, expected 0x%08x\n",
+			      test->name, part[i].fail[n].addr,
+			      part[i].fail[n].data, part[i].fail[n].expect);
+		}
+	}
+}
+
+static uintptr_t ddr_test_first_fail(const struct ddr_test_part *part)
+{
+	if (part[0].logged != 0U) {
+		return part[0].fail[0].addr;
+	}
+
+	if (part[1].logged != 0U) {
+		return part[1].fail[0].addr;
+	}
+
+	return 0U;
+}
+
+/*******************************************************************************
+ * This function runs march tests over the whole DDR, selected with the
+ * STM32MP_DDR_FULL_TEST mask. It has to be run with the DDR mapped
+ * non-cacheable, stores are then merged in the CPU write buffer. This test
+ * is only done for cold boot, the DDR content is lost.
+ * size: size in bytes of the DDR memory device.
+ * Returns 0 if success, and the first failing address else.
+ ******************************************************************************/
+uint32_t stm32mp_ddr_test_full(uint32_t size)
+{
+	struct ddr_test_part part[2];
+	uint32_t ret = 0U;
+	unsigned int t;
+	unsigned int s;
+
+	assert((size % (2U * DDR_TEST_BLOCK_SIZE)) == 0U);
+
+	ddr_test_init_patterns();
+
+	for (t = 0U; t < ARRAY_SIZE(ddr_tests); t++) {
+		const struct ddr_test *test = &ddr_tests[t];
+		uint64_t bytes = 0U;
+		uint64_t start;
+
+		if ((STM32MP_DDR_FULL_TEST & test->id) == 0U) {
+			continue;
+		}
+
+		zeromem(part, sizeof(part));
+		part[0].base = STM32MP_DDR_BASE;
+		part[0].size = size / 2U;
+		part[1].base = STM32MP_DDR_BASE + (size / 2U);
+		part[1].size = size / 2U;
+
+		start = read_cntpct_el0();
+
+		for (s = 0U; s < test->nb_steps; s++) {
+			const struct ddr_test_step *step = &test->step[s];
+
+			part[0].step = step;
+			part[1].step = step;
+
+			ddr_test_step_run(part);
+
+			bytes += size;
+			if ((step->op == DDR_TEST_RW_UP) ||
+			    (step->op == DDR_TEST_RW_DOWN)) {
+				bytes += size;
+			}
+		}
+
+		ddr_test_report(test, part, bytes, read_cntpct_el0() - start);
+
+		if (ret == 0U) {
+			ret = (uint32_t)ddr_test_first_fail(part);
+		}
+	}
+
+	return ret;
+}
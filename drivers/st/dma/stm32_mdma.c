@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <drivers/st/stm32_mdma.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/mmio.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+
+/* Global and channel x registers */
+#define MDMA_GISR0			0x00U
+#define MDMA_CH(x)			(0x40U * (x))
+#define MDMA_CISR			0x40U
+#define MDMA_CIFCR			0x44U
+#define MDMA_CESR			0x48U
+#define MDMA_CCR			0x4CU
+#define MDMA_CTCR			0x50U
+#define MDMA_CBNDTR			0x54U
+#define MDMA_CSAR			0x58U
+#define MDMA_CDAR			0x5CU
+#define MDMA_CBRUR			0x60U
+#define MDMA_CLAR			0x64U
+#define MDMA_CTBR			0x68U
+#define MDMA_CMAR			0x70U
+#define MDMA_CMDR			0x74U
+
+/* Channel interrupt status and flag clear registers */
+#define MDMA_CISR_TEIF			BIT(0)
+#define MDMA_CISR_CTCIF			BIT(1)
+#define MDMA_CISR_CRQA			BIT(16)
+#define MDMA_CIFCR_ALL			GENMASK_32(4, 0)
+
+/* Channel control register */
+#define MDMA_CCR_EN			BIT(0)
+#define MDMA_CCR_PL_VERY_HIGH		GENMASK_32(7, 6)
+#define MDMA_CCR_SM			BIT(8)
+#define MDMA_CCR_SWRQ			BIT(16)
+
+/* Channel transfer configuration register */
+#define MDMA_CTCR_SINC_SHIFT		0
+#define MDMA_CTCR_DINC_SHIFT		2
+#define MDMA_CTCR_INC			0x2U
+#define MDMA_CTCR_SSIZE_SHIFT		4
+#define MDMA_CTCR_DSIZE_SHIFT		6
+#define MDMA_CTCR_SINCOS_SHIFT		8
+#define MDMA_CTCR_DINCOS_SHIFT		10
+#define MDMA_CTCR_SBURST_SHIFT		12
+#define MDMA_CTCR_DBURST_SHIFT		15
+#define MDMA_CTCR_TLEN_SHIFT		18
+#define MDMA_CTCR_TRGM_LLIST		(0x3U << 28)
+#define MDMA_CTCR_SWRM			BIT(30)
+#define MDMA_CTCR_BWM			BIT(31)
+
+#define MDMA_BUFFER_MAX_LEN		128U
+#define MDMA_BURST_MAX_SHIFT		4U
+
+/* Channel trigger and bus selection register */
+#define MDMA_CTBR_TSEL_MASK		GENMASK_32(5, 0)
+
+#define MDMA_NB_CHANNELS		32U
+
+/*
+ * Channels used by the firmware, the last ones. They are secure: their
+ * registers cannot be written by the non-secure world and their transfers
+ * are secure accesses.
+ */
+#ifndef MDMA_FW_CHANNEL_NB
+#define MDMA_FW_CHANNEL_NB		2U
+#endif
+#define MDMA_FW_CHANNEL_FIRST		(MDMA_NB_CHANNELS - MDMA_FW_CHANNEL_NB)
+#define MDMA_FW_CHANNELS		GENMASK_32(MDMA_NB_CHANNELS - 1U, \
+						   MDMA_FW_CHANNEL_FIRST)
+
+#define MDMA_MEMCPY_DESC_NB		4U
+#define MDMA_MEMCPY_TIMEOUT_US		100000U
+
+static uint32_t mdma_channels_used;
+static bool mdma_ready;
+static spinlock_t mdma_lock;
+
+/* Items of the copies done on each firmware channel */
+static struct stm32_mdma_desc
+mdma_memcpy_desc[MDMA_FW_CHANNEL_NB][MDMA_MEMCPY_DESC_NB];
+
+static uintptr_t mdma_ch_base(unsigned int channel)
+{
+	assert(channel < MDMA_NB_CHANNELS);
+
+	return MDMA_BASE + MDMA_CH(channel);
+}
+
+static void mdma_lock_get(void)
+{
+	if (stm32mp_lock_available()) {
+		spin_lock(&mdma_lock);
+	}
+}
+
+static void mdma_lock_put(void)
+{
+	if (stm32mp_lock_available()) {
+		spin_unlock(&mdma_lock);
+	}
+}
+
+/*
+ * Enable the MDMA clock. The controller is not reset: in SP_MIN, the
+ * non-secure world can use the other channels.
+ */
+int stm32_mdma_init(void)
+{
+	if (mdma_ready) {
+		return 0;
+	}
+
+	clk_enable(MDMA);
+	mdma_ready = true;
+
+	return 0;
+}
+
+/* Return a free firmware channel, or -EBUSY */
+int stm32_mdma_get_channel(void)
+{
+	uint32_t free_channels;
+	int channel = -EBUSY;
+
+	assert(mdma_ready);
+
+	mdma_lock_get();
+
+	free_channels = MDMA_FW_CHANNELS & ~mdma_channels_used;
+	if (free_channels != 0U) {
+		channel = (int)__builtin_ctz(free_channels);
+		mdma_channels_used |= BIT((unsigned int)channel);
+	}
+
+	mdma_lock_put();
+
+	return channel;
+}
+
+void stm32_mdma_put_channel(unsigned int channel)
+{
+	assert((BIT(channel) & mdma_channels_used) != 0U);
+
+	stm32_mdma_abort(channel);
+
+	mdma_lock_get();
+	mdma_channels_used &= ~BIT(channel);
+	mdma_lock_put();
+}
+
+/*
+ * Fill a linked-list item, the last of its list. Both sides are accessed on
+ * the AXI bus.
+ */
+int stm32_mdma_desc_fill(struct stm32_mdma_desc *desc,
+			 const struct stm32_mdma_cfg *cfg)
+{
+	unsigned int buffer_len = cfg->buffer_len;
+	unsigned int size;
+	unsigned int burst;
+	uint32_t ctcr;
+
+	if (buffer_len == 0U) {
+		buffer_len = MDMA_BUFFER_MAX_LEN;
+	}
+
+	if ((cfg->width == 0U) || (cfg->width > 8U) ||
+	    !IS_POWER_OF_TWO(cfg->width) ||
+	    (cfg->len == 0U) || (cfg->len > STM32_MDMA_MAX_LEN) ||
+	    (buffer_len > MDMA_BUFFER_MAX_LEN) || (buffer_len < cfg->width) ||
+	    ((buffer_len % cfg->width) != 0U) ||
+	    ((cfg->len % cfg->width) != 0U) ||
+	    ((cfg->src % cfg->width) != 0U) ||
+	    ((cfg->dst % cfg->width) != 0U)) {
+		return -EINVAL;
+	}
+
+	if ((cfg->request != STM32_MDMA_SW_REQUEST) &&
+	    ((cfg->request < 0) ||
+	     ((uint32_t)cfg->request > MDMA_CTBR_TSEL_MASK))) {
+		return -EINVAL;
+	}
+
+	size = __builtin_ctz(cfg->width);
+
+	/* Bursts of up to 16 beats, that fit in a buffer */
+	burst = 31U - __builtin_clz(buffer_len / cfg->width);
+	if (burst > MDMA_BURST_MAX_SHIFT) {
+		burst = MDMA_BURST_MAX_SHIFT;
+	}
+
+	ctcr = (size << MDMA_CTCR_SSIZE_SHIFT) |
+	       (size << MDMA_CTCR_DSIZE_SHIFT) |
+	       ((buffer_len - 1U) << MDMA_CTCR_TLEN_SHIFT);
+
+	if (cfg->src_inc) {
+		ctcr |= (MDMA_CTCR_INC << MDMA_CTCR_SINC_SHIFT) |
+			(size << MDMA_CTCR_SINCOS_SHIFT) |
+			(burst << MDMA_CTCR_SBURST_SHIFT);
+	}
+
+	if (cfg->dst_inc) {
+		ctcr |= (MDMA_CTCR_INC << MDMA_CTCR_DINC_SHIFT) |
+			(size << MDMA_CTCR_DINCOS_SHIFT) |
+			(burst << MDMA_CTCR_DBURST_SHIFT) |
+			MDMA_CTCR_BWM;
+	}
+
+	desc->ctbr = 0U;
+	if (cfg->request == STM32_MDMA_SW_REQUEST) {
+		/* A single software request transfers the whole list */
+		ctcr |= MDMA_CTCR_TRGM_LLIST | MDMA_CTCR_SWRM;
+	} else {
+		/* Each hardware request transfers a buffer */
+		desc->ctbr = (uint32_t)cfg->request;
+	}
+
+	desc->ctcr = ctcr;
+	desc->cbndtr = (uint32_t)cfg->len;
+	desc->csar = (uint32_t)cfg->src;
+	desc->cdar = (uint32_t)cfg->dst;
+	desc->cbrur = 0U;
+	desc->clar = 0U;
+	desc->reserved = 0U;
+	desc->cmar = 0U;
+	desc->cmdr = 0U;
+
+	return 0;
+}
+
+void stm32_mdma_desc_link(struct stm32_mdma_desc *desc,
+			  struct stm32_mdma_desc *next)
+{
+	desc->clar = (uint32_t)(uintptr_t)next;
+}
+
+/*
+ * Load the first item of a list in the channel and start it. The items,
+ * read by the MDMA, are cleaned from the data cache. The list must not loop.
+ */
+int stm32_mdma_start(unsigned int channel, struct stm32_mdma_desc *desc)
+{
+	uintptr_t base = mdma_ch_base(channel);
+	struct stm32_mdma_desc *item;
+	uint32_t ccr = MDMA_CCR_PL_VERY_HIGH | MDMA_CCR_SM | MDMA_CCR_EN;
+
+	assert((BIT(channel) & mdma_channels_used) != 0U);
+
+	if ((mmio_read_32(base + MDMA_CCR) & MDMA_CCR_EN) != 0U) {
+		return -EBUSY;
+	}
+
+	for (item = desc; item != NULL;
+	     item = (struct stm32_mdma_desc *)(uintptr_t)item->clar) {
+		clean_dcache_range((uintptr_t)item, sizeof(*item));
+	}
+
+	/* Secure mode first: the other registers are then secure only */
+	mmio_write_32(base + MDMA_CCR, MDMA_CCR_SM);
+	mmio_write_32(base + MDMA_CIFCR, MDMA_CIFCR_ALL);
+
+	mmio_write_32(base + MDMA_CTCR, desc->ctcr);
+	mmio_write_32(base + MDMA_CBNDTR, desc->cbndtr);
+	mmio_write_32(base + MDMA_CSAR, desc->csar);
+	mmio_write_32(base + MDMA_CDAR, desc->cdar);
+	mmio_write_32(base + MDMA_CBRUR, desc->cbrur);
+	mmio_write_32(base + MDMA_CLAR, desc->clar);
+	mmio_write_32(base + MDMA_CTBR, desc->ctbr);
+	mmio_write_32(base + MDMA_CMAR, desc->cmar);
+	mmio_write_32(base + MDMA_CMDR, desc->cmdr);
+
+	mmio_write_32(base + MDMA_CCR, ccr);
+
+	if ((desc->ctcr & MDMA_CTCR_SWRM) != 0U) {
+		mmio_write_32(base + MDMA_CCR, ccr | MDMA_CCR_SWRQ);
+	}
+
+	return 0;
+}
+
+/* Return 0 when the transfer is complete, -EBUSY while it runs, or -EIO */
+int stm32_mdma_poll(unsigned int channel)
+{
+	uintptr_t base = mdma_ch_base(channel);
+	uint32_t isr = mmio_read_32(base + MDMA_CISR);
+
+	if ((isr & MDMA_CISR_TEIF) != 0U) {
+		ERROR("MDMA channel %u error 0x%x\n", channel,
+		      mmio_read_32(base + MDMA_CESR));
+		stm32_mdma_abort(channel);
+
+		return -EIO;
+	}
+
+	if ((isr & MDMA_CISR_CTCIF) == 0U) {
+		return -EBUSY;
+	}
+
+	mmio_clrbits_32(base + MDMA_CCR, MDMA_CCR_EN);
+	mmio_write_32(base + MDMA_CIFCR, MDMA_CIFCR_ALL);
+
+	return 0;
+}
+
+int stm32_mdma_wait(unsigned int channel, uint32_t timeout_us)
+{
+	uint64_t timeout = timeout_init_us(timeout_us);
+	int ret;
+
+	do {
+		ret = stm32_mdma_poll(channel);
+		if (ret != -EBUSY) {
+			return ret;
+		}
+	} while (!timeout_elapsed(timeout));
+
+	ret = stm32_mdma_poll(channel);
+	if (ret == -EBUSY) {
+		stm32_mdma_abort(channel);
+		ret = -ETIMEDOUT;
+	}
+
+	return ret;
+}
+
+/* Stop the channel, the current AXI burst completes */
+void stm32_mdma_abort(unsigned int channel)
+{
+	uintptr_t base = mdma_ch_base(channel);
+	uint64_t timeout = timeout_init_us(1000U);
+
+	mmio_clrbits_32(base + MDMA_CCR, MDMA_CCR_EN);
+
+	while ((mmio_read_32(base + MDMA_CISR) & MDMA_CISR_CRQA) != 0U) {
+		if (timeout_elapsed(timeout)) {
+			break;
+		}
+	}
+
+	mmio_write_32(base + MDMA_CIFCR, MDMA_CIFCR_ALL);
+}
+
+/*
+ * Copy memory with a firmware channel, waiting for the end of the copy.
+ * Cacheable buffers must not share cache lines with data used meanwhile.
+ */
+int stm32_mdma_memcpy(uintptr_t dst, uintptr_t src, size_t size)
+{
+	struct stm32_mdma_desc *desc;
+	struct stm32_mdma_cfg cfg = {
+		.src_inc = true,
+		.dst_inc = true,
+		.request = STM32_MDMA_SW_REQUEST,
+	};
+	uintptr_t align = dst | src | size;
+	size_t done = 0U;
+	int channel;
+	int ret = 0;
+
+	if (size == 0U) {
+		return 0;
+	}
+
+	if ((align % 8U) == 0U) {
+		cfg.width = 8U;
+	} else if ((align % 4U) == 0U) {
+		cfg.width = 4U;
+	} else {
+		cfg.width = 1U;
+	}
+
+	channel = stm32_mdma_get_channel();
+	if (channel < 0) {
+		return channel;
+	}
+
+	desc = mdma_memcpy_desc[(unsigned int)channel - MDMA_FW_CHANNEL_FIRST];
+
+	stm32_mdma_prepare_src(src, size);
+	stm32_mdma_prepare_dst(dst, size);
+
+	while ((done < size) && (ret == 0)) {
+		unsigned int i;
+
+		for (i = 0U; (i < MDMA_MEMCPY_DESC_NB) && (done < size); i++) {
+			cfg.src = src + done;
+			cfg.dst = dst + done;
+			cfg.len = MIN(size - done, (size_t)STM32_MDMA_MAX_LEN);
+			done += cfg.len;
+
+			ret = stm32_mdma_desc_fill(&desc[i], &cfg);
+			if (ret != 0) {
+				break;
+			}
+
+			if (i != 0U) {
+				stm32_mdma_desc_link(&desc[i - 1U], &desc[i]);
+			}
+		}
+
+		if (ret == 0) {
+			ret = stm32_mdma_start((unsigned int)channel, desc);
+		}
+		if (ret == 0) {
+			ret = stm32_mdma_wait((unsigned int)channel,
+					      MDMA_MEMCPY_TIMEOUT_US);
+		}
+	}
+
+	stm32_mdma_complete_dst(dst, size);
+	stm32_mdma_put_channel((unsigned int)channel);
+
+	return ret;
+}
+
+/* Write back the source data for the MDMA to read */
+void stm32_mdma_prepare_src(uintptr_t base, size_t size)
+{
+	clean_dcache_range(base, size);
+}
+
+/*
+ * Write back and invalidate the destination, so that no dirty line is
+ * evicted over the transferred data.
+ */
+void stm32_mdma_prepare_dst(uintptr_t base, size_t size)
+{
+	flush_dcache_range(base, size);
+}
+
+/* Drop the lines speculatively loaded during the transfer */
+void stm32_mdma_complete_dst(uintptr_t base, size_t size)
+{
+	inv_dcache_range(base, size);
+}
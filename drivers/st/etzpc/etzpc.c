@@ -44,6 +44,10 @@
 #define DECPROT_SHIFT			1
 #define IDS_PER_DECPROT_REGS		16U
 #define IDS_PER_DECPROT_LOCK_REGS	32U
+#define DECPROT_REGS_NB			\
+	DIV_ROUND_UP_2EVAL(STM32MP1_ETZPC_MAX_ID, IDS_PER_DECPROT_REGS)
+#define DECPROT_LOCK_REGS_NB		\
+	DIV_ROUND_UP_2EVAL(STM32MP1_ETZPC_MAX_ID, IDS_PER_DECPROT_LOCK_REGS)
 
 /*
  * etzpc_instance.
@@ -71,11 +75,12 @@ struct dt_id_attr {
 };
 
 /*
- * Implementation uses uint8_t to store each securable DECPROT configuration.
- * When resuming from deep suspend, the DECPROT configurations are restored.
+ * RAM mirror of the DECPROT registers, loaded from the hardware at init and
+ * kept in sync by the driver, which is the only one to write them. DECPROT
+ * attributes are read from the mirror, and are programmed by writing whole
+ * registers.
  */
-#define PERIPH_LOCK_BIT		BIT(7)
-#define PERIPH_ATTR_MASK	GENMASK(2, 0)
+static uint32_t decprot_mirror[DECPROT_REGS_NB];
 
 #if ENABLE_ASSERTIONS
 static bool valid_decprot_id(unsigned int id)
@@ -89,9 +94,46 @@ static bool valid_tzma_id(unsigned int id)
 }
 #endif
 
+static void etzpc_set_decprot_mirror(uint32_t decprot_id,
+				     enum etzpc_decprot_attributes decprot_attr)
+{
+	uint32_t shift = (decprot_id % IDS_PER_DECPROT_REGS) << DECPROT_SHIFT;
+	uint32_t masked_decprot = (uint32_t)decprot_attr & ETZPC_DECPROT0_MASK;
+
+	assert(valid_decprot_id(decprot_id));
+
+	decprot_mirror[decprot_id / IDS_PER_DECPROT_REGS] &=
+		~((uint32_t)ETZPC_DECPROT0_MASK << shift);
+	decprot_mirror[decprot_id / IDS_PER_DECPROT_REGS] |=
+		masked_decprot << shift;
+}
+
+/*
+ * etzpc_apply_decprot : Write the DECPROT mirror to the registers, then
+ * set the given lock bits
+ * lock : DECPROT lock bitmaps, one per lock register
+ */
+static void etzpc_apply_decprot(const uint32_t *lock)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DECPROT_REGS_NB; i++) {
+		mmio_write_32(etzpc_dev.base + ETZPC_DECPROT0 +
+			      (sizeof(uint32_t) * i), decprot_mirror[i]);
+	}
+
+	for (i = 0U; i < DECPROT_LOCK_REGS_NB; i++) {
+		if (lock[i] != 0U) {
+			mmio_write_32(etzpc_dev.base + ETZPC_DECPROT_LOCK0 +
+				      (sizeof(uint32_t) * i), lock[i]);
+		}
+	}
+}
+
 static int etzpc_dt_conf_decprot(void)
 {
 	const struct dt_id_attr *conf_list;
+	uint32_t lock[DECPROT_LOCK_REGS_NB] = { 0U };
 	void *fdt;
 	unsigned int i;
 	int len = 0;
@@ -129,13 +171,16 @@ static int etzpc_dt_conf_decprot(void)
 
 		stm32mp1_register_etzpc_decprot(id, attr);
 
-		etzpc_configure_decprot(id, attr);
+		etzpc_set_decprot_mirror(id, attr);
 
 		if ((value & ETZPC_LOCK_MASK) != 0U) {
-			etzpc_lock_decprot(id);
+			lock[id / IDS_PER_DECPROT_LOCK_REGS] |=
+				BIT(id % IDS_PER_DECPROT_LOCK_REGS);
 		}
 	}
 
+	etzpc_apply_decprot(lock);
+
 	return 0;
 }
 
@@ -148,31 +193,26 @@ void etzpc_configure_decprot(uint32_t decprot_id,
 			     enum etzpc_decprot_attributes decprot_attr)
 {
 	uintptr_t offset = 4U * (decprot_id / IDS_PER_DECPROT_REGS);
-	uint32_t shift = (decprot_id % IDS_PER_DECPROT_REGS) << DECPROT_SHIFT;
-	uint32_t masked_decprot = (uint32_t)decprot_attr & ETZPC_DECPROT0_MASK;
 
-	assert(valid_decprot_id(decprot_id));
+	etzpc_set_decprot_mirror(decprot_id, decprot_attr);
 
-	mmio_clrsetbits_32(etzpc_dev.base + ETZPC_DECPROT0 + offset,
-			   (uint32_t)ETZPC_DECPROT0_MASK << shift,
-			   masked_decprot << shift);
+	mmio_write_32(etzpc_dev.base + ETZPC_DECPROT0 + offset,
+		      decprot_mirror[decprot_id / IDS_PER_DECPROT_REGS]);
 }
 
 /*
- * etzpc_get_decprot : Get the DECPROT attribute
+ * etzpc_get_decprot : Get the DECPROT attribute, from the RAM mirror
  * decprot_id : ID of the IP
  * return : Attribute of this DECPROT
  */
 enum etzpc_decprot_attributes etzpc_get_decprot(uint32_t decprot_id)
 {
-	uintptr_t offset = 4U * (decprot_id / IDS_PER_DECPROT_REGS);
 	uint32_t shift = (decprot_id % IDS_PER_DECPROT_REGS) << DECPROT_SHIFT;
-	uintptr_t base_decprot = etzpc_dev.base + offset;
 	uint32_t value;
 
 	assert(valid_decprot_id(decprot_id));
 
-	value = (mmio_read_32(base_decprot + ETZPC_DECPROT0) >> shift) &
+	value = (decprot_mirror[decprot_id / IDS_PER_DECPROT_REGS] >> shift) &
 		ETZPC_DECPROT0_MASK;
 
 	return (enum etzpc_decprot_attributes)value;
@@ -279,6 +319,7 @@ uintptr_t etzpc_get_base_address(void)
 int etzpc_init(void)
 {
 	uint32_t hwcfg;
+	unsigned int i;
 
 	etzpc_dev.base = STM32MP1_ETZPC_BASE;
 
@@ -296,5 +337,13 @@ int etzpc_init(void)
 
 	VERBOSE("ETZPC version 0x%x", etzpc_dev.revision);
 
+	assert(etzpc_dev.num_per_sec <= STM32MP1_ETZPC_MAX_ID);
+
+	for (i = 0U; i < DECPROT_REGS_NB; i++) {
+		decprot_mirror[i] = mmio_read_32(etzpc_dev.base +
+						 ETZPC_DECPROT0 +
+						 (sizeof(uint32_t) * i));
+	}
+
 	return etzpc_dt_conf_decprot();
 }
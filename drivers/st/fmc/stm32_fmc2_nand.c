@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: GPL-2.0+ OR BSD-3-Clause
  */
@@ -160,7 +160,7 @@ static uintptr_t fmc2_base(void)
 	return stm32_fmc2.reg_base;
 }
 
-static void stm32_fmc2_nand_setup_timing(void)
+static void stm32_fmc2_nand_setup_timing(const struct nand_sdr_timings *t)
 {
 	struct stm32_fmc2_nand_timings tims;
 	unsigned long hclk = clk_get_rate(stm32_fmc2.clock_id);
@@ -169,11 +169,11 @@ static void stm32_fmc2_nand_setup_timing(void)
 	unsigned long tset_mem, tset_att, thold_mem, thold_att;
 	uint32_t pcr, pmem, patt;
 
-	tar = MAX(hclkp, NAND_TAR_MIN);
+	tar = MAX(hclkp, t->tAR_min);
 	timing = div_round_up(tar, hclkp) - 1U;
 	tims.tar = MIN(timing, (unsigned long)FMC2_PCR_TIMING_MASK);
 
-	tclr = MAX(hclkp, NAND_TCLR_MIN);
+	tclr = MAX(hclkp, t->tCLR_min);
 	timing = div_round_up(tclr, hclkp) - 1U;
 	tims.tclr = MIN(timing, (unsigned long)FMC2_PCR_TIMING_MASK);
 
@@ -185,9 +185,9 @@ static void stm32_fmc2_nand_setup_timing(void)
 	 * tWAIT > tWP
 	 * tWAIT > tREA + tIO
 	 */
-	twait = MAX(hclkp, NAND_TRP_MIN);
-	twait = MAX(twait, NAND_TWP_MIN);
-	twait = MAX(twait, NAND_TREA_MAX + FMC2_TIO);
+	twait = MAX(hclkp, t->tRP_min);
+	twait = MAX(twait, t->tWP_min);
+	twait = MAX(twait, t->tREA_max + FMC2_TIO);
 	timing = div_round_up(twait, hclkp);
 	tims.twait = CLAMP(timing, 1UL,
 			   (unsigned long)FMC2_PMEM_PATT_TIMING_MASK);
@@ -198,12 +198,12 @@ static void stm32_fmc2_nand_setup_timing(void)
 	 * tSETUP_MEM > tDS - (tWAIT - tHIZ)
 	 */
 	tset_mem = hclkp;
-	if ((twait < NAND_TCS_MIN) && (tset_mem < (NAND_TCS_MIN - twait))) {
-		tset_mem = NAND_TCS_MIN - twait;
+	if ((twait < t->tCS_min) && (tset_mem < (t->tCS_min - twait))) {
+		tset_mem = t->tCS_min - twait;
 	}
-	if ((twait > thiz) && ((twait - thiz) < NAND_TDS_MIN) &&
-	    (tset_mem < (NAND_TDS_MIN - (twait - thiz)))) {
-		tset_mem = NAND_TDS_MIN - (twait - thiz);
+	if ((twait > thiz) && ((twait - thiz) < t->tDS_min) &&
+	    (tset_mem < (t->tDS_min - (twait - thiz)))) {
+		tset_mem = t->tDS_min - (twait - thiz);
 	}
 	timing = div_round_up(tset_mem, hclkp);
 	tims.tset_mem = CLAMP(timing, 1UL,
@@ -214,18 +214,18 @@ static void stm32_fmc2_nand_setup_timing(void)
 	 * tHOLD_MEM > tREH - tSETUP_MEM
 	 * tHOLD_MEM > max(tRC, tWC) - (tSETUP_MEM + tWAIT)
 	 */
-	thold_mem = MAX(hclkp, NAND_TCH_MIN);
-	if ((tset_mem < NAND_TREH_MIN) &&
-	    (thold_mem < (NAND_TREH_MIN - tset_mem))) {
-		thold_mem = NAND_TREH_MIN - tset_mem;
+	thold_mem = MAX(hclkp, t->tCH_min);
+	if ((tset_mem < t->tREH_min) &&
+	    (thold_mem < (t->tREH_min - tset_mem))) {
+		thold_mem = t->tREH_min - tset_mem;
 	}
-	if (((tset_mem + twait) < NAND_TRC_MIN) &&
-	    (thold_mem < (NAND_TRC_MIN - (tset_mem + twait)))) {
-		thold_mem = NAND_TRC_MIN  - (tset_mem + twait);
+	if (((tset_mem + twait) < t->tRC_min) &&
+	    (thold_mem < (t->tRC_min - (tset_mem + twait)))) {
+		thold_mem = t->tRC_min  - (tset_mem + twait);
 	}
-	if (((tset_mem + twait) < NAND_TWC_MIN) &&
-	    (thold_mem < (NAND_TWC_MIN - (tset_mem + twait)))) {
-		thold_mem = NAND_TWC_MIN - (tset_mem + twait);
+	if (((tset_mem + twait) < t->tWC_min) &&
+	    (thold_mem < (t->tWC_min - (tset_mem + twait)))) {
+		thold_mem = t->tWC_min - (tset_mem + twait);
 	}
 	timing = div_round_up(thold_mem, hclkp);
 	tims.thold_mem = CLAMP(timing, 1UL,
@@ -239,16 +239,16 @@ static void stm32_fmc2_nand_setup_timing(void)
 	 * tSETUP_ATT > tDS - (tWAIT - tHIZ)
 	 */
 	tset_att = hclkp;
-	if ((twait < NAND_TCS_MIN) && (tset_att < (NAND_TCS_MIN - twait))) {
-		tset_att = NAND_TCS_MIN - twait;
+	if ((twait < t->tCS_min) && (tset_att < (t->tCS_min - twait))) {
+		tset_att = t->tCS_min - twait;
 	}
-	if ((thold_mem < NAND_TRHW_MIN) &&
-	    (tset_att < (NAND_TRHW_MIN - thold_mem))) {
-		tset_att = NAND_TRHW_MIN - thold_mem;
+	if ((thold_mem < t->tRHW_min) &&
+	    (tset_att < (t->tRHW_min - thold_mem))) {
+		tset_att = t->tRHW_min - thold_mem;
 	}
-	if ((twait > thiz) && ((twait - thiz) < NAND_TDS_MIN) &&
-	    (tset_att < (NAND_TDS_MIN - (twait - thiz)))) {
-		tset_att = NAND_TDS_MIN - (twait - thiz);
+	if ((twait > thiz) && ((twait - thiz) < t->tDS_min) &&
+	    (tset_att < (t->tDS_min - (twait - thiz)))) {
+		tset_att = t->tDS_min - (twait - thiz);
 	}
 	timing = div_round_up(tset_att, hclkp);
 	tims.tset_att = CLAMP(timing, 1UL,
@@ -267,34 +267,34 @@ static void stm32_fmc2_nand_setup_timing(void)
 	 * tHOLD_ATT > tRC - (tSETUP_ATT + tWAIT)
 	 * tHOLD_ATT > tWC - (tSETUP_ATT + tWAIT)
 	 */
-	thold_att = MAX(hclkp, NAND_TALH_MIN);
-	thold_att = MAX(thold_att, NAND_TCH_MIN);
-	thold_att = MAX(thold_att, NAND_TCLH_MIN);
-	thold_att = MAX(thold_att, NAND_TCOH_MIN);
-	thold_att = MAX(thold_att, NAND_TDH_MIN);
-	if (((NAND_TWB_MAX + FMC2_TIO + FMC2_TSYNC) > tset_mem) &&
-	    (thold_att < (NAND_TWB_MAX + FMC2_TIO + FMC2_TSYNC - tset_mem))) {
-		thold_att = NAND_TWB_MAX + FMC2_TIO + FMC2_TSYNC - tset_mem;
-	}
-	if ((tset_mem < NAND_TADL_MIN) &&
-	    (thold_att < (NAND_TADL_MIN - tset_mem))) {
-		thold_att = NAND_TADL_MIN - tset_mem;
-	}
-	if ((tset_mem < NAND_TWH_MIN) &&
-	    (thold_att < (NAND_TWH_MIN - tset_mem))) {
-		thold_att = NAND_TWH_MIN - tset_mem;
-	}
-	if ((tset_mem < NAND_TWHR_MIN) &&
-	    (thold_att < (NAND_TWHR_MIN - tset_mem))) {
-		thold_att = NAND_TWHR_MIN - tset_mem;
-	}
-	if (((tset_att + twait) < NAND_TRC_MIN) &&
-	    (thold_att < (NAND_TRC_MIN - (tset_att + twait)))) {
-		thold_att = NAND_TRC_MIN - (tset_att + twait);
-	}
-	if (((tset_att + twait) < NAND_TWC_MIN) &&
-	    (thold_att < (NAND_TWC_MIN - (tset_att + twait)))) {
-		thold_att = NAND_TWC_MIN - (tset_att + twait);
+	thold_att = MAX(hclkp, t->tALH_min);
+	thold_att = MAX(thold_att, t->tCH_min);
+	thold_att = MAX(thold_att, t->tCLH_min);
+	thold_att = MAX(thold_att, t->tCOH_min);
+	thold_att = MAX(thold_att, t->tDH_min);
+	if (((t->tWB_max + FMC2_TIO + FMC2_TSYNC) > tset_mem) &&
+	    (thold_att < (t->tWB_max + FMC2_TIO + FMC2_TSYNC - tset_mem))) {
+		thold_att = t->tWB_max + FMC2_TIO + FMC2_TSYNC - tset_mem;
+	}
+	if ((tset_mem < t->tADL_min) &&
+	    (thold_att < (t->tADL_min - tset_mem))) {
+		thold_att = t->tADL_min - tset_mem;
+	}
+	if ((tset_mem < t->tWH_min) &&
+	    (thold_att < (t->tWH_min - tset_mem))) {
+		thold_att = t->tWH_min - tset_mem;
+	}
+	if ((tset_mem < t->tWHR_min) &&
+	    (thold_att < (t->tWHR_min - tset_mem))) {
+		thold_att = t->tWHR_min - tset_mem;
+	}
+	if (((tset_att + twait) < t->tRC_min) &&
+	    (thold_att < (t->tRC_min - (tset_att + twait)))) {
+		thold_att = t->tRC_min - (tset_att + twait);
+	}
+	if (((tset_att + twait) < t->tWC_min) &&
+	    (thold_att < (t->tWC_min - (tset_att + twait)))) {
+		thold_att = t->tWC_min - (tset_att + twait);
 	}
 	timing = div_round_up(thold_att, hclkp);
 	tims.thold_att = CLAMP(timing, 1UL,
@@ -329,6 +329,24 @@ static void stm32_fmc2_nand_setup_timing(void)
 	mmio_write_32(fmc2_base() + FMC2_PATT, patt);
 }
 
+/*
+ * Without EDO sampling in the FMC2, data cannot be read with a read cycle
+ * shorter than 30ns: ONFI modes 4 and 5 are not supported.
+ */
+static int stm32_fmc2_setup_timings(const struct nand_sdr_timings *timings,
+				    bool check_only)
+{
+	if (timings->tRC_min < 30000UL) {
+		return -ENOTSUP;
+	}
+
+	if (!check_only) {
+		stm32_fmc2_nand_setup_timing(timings);
+	}
+
+	return 0;
+}
+
 static void stm32_fmc2_set_buswidth_16(bool set)
 {
 	mmio_clrsetbits_32(fmc2_base() + FMC2_PCR, FMC2_PCR_PWID_MASK,
@@ -503,8 +521,55 @@ static void stm32_fmc2_hwctl(struct nand_device *nand)
 	stm32_fmc2_set_ecc(true);
 }
 
-static int stm32_fmc2_read_page(struct nand_device *nand,
-				unsigned int page, uintptr_t buffer)
+static void stm32_fmc2_read_data(struct nand_device *nand,
+				 uint8_t *buff, unsigned int length,
+				 bool use_bus8)
+{
+	uintptr_t data_base = stm32_fmc2.cs[stm32_fmc2.cs_sel].data_base;
+
+	if (use_bus8 && (nand->buswidth == NAND_BUS_WIDTH_16)) {
+		stm32_fmc2_set_buswidth_16(false);
+	}
+
+	if ((((uintptr_t)buff & BIT(0)) != 0U) && (length != 0U)) {
+		*buff = mmio_read_8(data_base);
+		buff += sizeof(uint8_t);
+		length -= sizeof(uint8_t);
+	}
+
+	if ((((uintptr_t)buff & GENMASK_32(1, 0)) != 0U) &&
+	    (length >= sizeof(uint16_t))) {
+		*(uint16_t *)buff = mmio_read_16(data_base);
+		buff += sizeof(uint16_t);
+		length -= sizeof(uint16_t);
+	}
+
+	/* 32bit aligned */
+	while (length >= sizeof(uint32_t)) {
+		*(uint32_t *)buff = mmio_read_32(data_base);
+		buff += sizeof(uint32_t);
+		length -= sizeof(uint32_t);
+	}
+
+	/* Read remaining bytes */
+	if (length >= sizeof(uint16_t)) {
+		*(uint16_t *)buff = mmio_read_16(data_base);
+		buff += sizeof(uint16_t);
+		length -= sizeof(uint16_t);
+	}
+
+	if (length != 0U) {
+		*buff = mmio_read_8(data_base);
+	}
+
+	if (use_bus8 && (nand->buswidth == NAND_BUS_WIDTH_16)) {
+		/* Reconfigure bus width to 16-bit */
+		stm32_fmc2_set_buswidth_16(true);
+	}
+}
+
+static int stm32_fmc2_read_page_data(struct nand_device *nand,
+				     uintptr_t buffer)
 {
 	unsigned int eccsize = nand->ecc.size;
 	unsigned int eccbytes = nand->ecc.bytes;
@@ -516,9 +581,8 @@ static int stm32_fmc2_read_page(struct nand_device *nand,
 	unsigned int s;
 	int ret;
 
-	VERBOSE(">%s page %i buffer %lx\n", __func__, page, buffer);
-
-	ret = nand_read_page_cmd(page, 0U, 0U, 0U);
+	/* Set the column of the first NAND page sector */
+	ret = nand_change_read_column_cmd(0U, 0U, 0U);
 	if (ret != 0) {
 		return ret;
 	}
@@ -529,11 +593,7 @@ static int stm32_fmc2_read_page(struct nand_device *nand,
 		stm32_fmc2_hwctl(nand);
 
 		/* Read the NAND page sector (512 bytes) */
-		ret = nand_change_read_column_cmd(s * eccsize, (uintptr_t)p,
-						  eccsize);
-		if (ret != 0) {
-			return ret;
-		}
+		stm32_fmc2_read_data(nand, p, eccsize, false);
 
 		if (nand->ecc.max_bit_corr == FMC2_ECC_HAM) {
 			ret = stm32_fmc2_ham_calculate(p, ecc_cal);
@@ -549,6 +609,19 @@ static int stm32_fmc2_read_page(struct nand_device *nand,
 			return ret;
 		}
 
+		/*
+		 * Select the next sector column while the BCH decoder
+		 * processes the current one: command and address cycles do
+		 * not feed the ECC engine, only data accesses do.
+		 */
+		if ((s + 1U) < eccsteps) {
+			ret = nand_change_read_column_cmd((s + 1U) * eccsize,
+							  0U, 0U);
+			if (ret != 0) {
+				return ret;
+			}
+		}
+
 		/* Correct the data */
 		if (nand->ecc.max_bit_corr == FMC2_ECC_HAM) {
 			ret = stm32_fmc2_ham_correct(p, ecc_corr, ecc_cal);
@@ -564,51 +637,50 @@ static int stm32_fmc2_read_page(struct nand_device *nand,
 	return 0;
 }
 
-static void stm32_fmc2_read_data(struct nand_device *nand,
-				 uint8_t *buff, unsigned int length,
-				 bool use_bus8)
+static int stm32_fmc2_read_page(struct nand_device *nand,
+				unsigned int page, uintptr_t buffer)
 {
-	uintptr_t data_base = stm32_fmc2.cs[stm32_fmc2.cs_sel].data_base;
+	int ret;
 
-	if (use_bus8 && (nand->buswidth == NAND_BUS_WIDTH_16)) {
-		stm32_fmc2_set_buswidth_16(false);
-	}
+	VERBOSE(">%s page %i buffer %lx\n", __func__, page, buffer);
 
-	if ((((uintptr_t)buff & BIT(0)) != 0U) && (length != 0U)) {
-		*buff = mmio_read_8(data_base);
-		buff += sizeof(uint8_t);
-		length -= sizeof(uint8_t);
+	ret = nand_read_page_cmd(page, 0U, 0U, 0U);
+	if (ret != 0) {
+		return ret;
 	}
 
-	if ((((uintptr_t)buff & GENMASK_32(1, 0)) != 0U) &&
-	    (length >= sizeof(uint16_t))) {
-		*(uint16_t *)buff = mmio_read_16(data_base);
-		buff += sizeof(uint16_t);
-		length -= sizeof(uint16_t);
-	}
+	return stm32_fmc2_read_page_data(nand, buffer);
+}
 
-	/* 32bit aligned */
-	while (length >= sizeof(uint32_t)) {
-		*(uint32_t *)buff = mmio_read_32(data_base);
-		buff += sizeof(uint32_t);
-		length -= sizeof(uint32_t);
-	}
+static int stm32_fmc2_read_pages(struct nand_device *nand, unsigned int page,
+				 unsigned int nb_pages, uintptr_t buffer)
+{
+	unsigned int i;
+	int ret;
 
-	/* Read remaining bytes */
-	if (length >= sizeof(uint16_t)) {
-		*(uint16_t *)buff = mmio_read_16(data_base);
-		buff += sizeof(uint16_t);
-		length -= sizeof(uint16_t);
-	}
+	VERBOSE(">%s page %i nb %u buffer %lx\n", __func__, page, nb_pages,
+		buffer);
 
-	if (length != 0U) {
-		*buff = mmio_read_8(data_base);
+	ret = nand_read_page_cmd(page, 0U, 0U, 0U);
+	if (ret != 0) {
+		return ret;
 	}
 
-	if (use_bus8 && (nand->buswidth == NAND_BUS_WIDTH_16)) {
-		/* Reconfigure bus width to 16-bit */
-		stm32_fmc2_set_buswidth_16(true);
+	for (i = 0U; i < nb_pages; i++) {
+		ret = nand_read_cache_cmd(i == (nb_pages - 1U), 0U, 0U);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = stm32_fmc2_read_page_data(nand, buffer);
+		if (ret != 0) {
+			return ret;
+		}
+
+		buffer += nand->page_size;
 	}
+
+	return 0;
 }
 
 static void stm32_fmc2_write_data(struct nand_device *nand,
@@ -749,6 +821,9 @@ static void stm32_fmc2_setup(struct nand_device *nand)
 
 	if (nand->ecc.mode == NAND_ECC_HW) {
 		nand->mtd_read_page = stm32_fmc2_read_page;
+		if (nand->mtd_read_pages != NULL) {
+			nand->mtd_read_pages = stm32_fmc2_read_pages;
+		}
 
 		pcr &= ~FMC2_PCR_ECCALG;
 		pcr &= ~FMC2_PCR_BCHECC;
@@ -782,7 +857,8 @@ static void stm32_fmc2_setup(struct nand_device *nand)
 
 static const struct nand_ctrl_ops ctrl_ops = {
 	.setup = stm32_fmc2_setup,
-	.exec = stm32_fmc2_exec
+	.exec = stm32_fmc2_exec,
+	.setup_timings = stm32_fmc2_setup_timings,
 };
 
 int stm32_fmc2_init(void)
@@ -925,8 +1001,8 @@ int stm32_fmc2_init(void)
 	/* Setup default IP registers */
 	stm32_fmc2_ctrl_init();
 
-	/* Setup default timings */
-	stm32_fmc2_nand_setup_timing();
+	/* Setup default timings, ONFI mode 0 */
+	stm32_fmc2_nand_setup_timing(nand_onfi_sdr_timings(0U));
 
 	/* Init NAND RAW framework */
 	nand_raw_ctrl_init(&ctrl_ops);
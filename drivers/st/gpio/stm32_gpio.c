@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2016-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -20,6 +20,7 @@
 #include <drivers/st/stm32mp_clkfunc.h>
 #include <dt-bindings/gpio/stm32-gpio.h>
 #include <lib/mmio.h>
+#include <lib/utils.h>
 #include <lib/utils_def.h>
 
 #define DT_GPIO_BANK_SHIFT	12
@@ -28,9 +29,32 @@
 #define DT_GPIO_PIN_MASK	GENMASK(11, 8)
 #define DT_GPIO_MODE_MASK	GENMASK(7, 0)
 
-static void set_gpio(uint32_t bank, uint32_t pin, uint32_t mode, uint32_t type,
-		     uint32_t speed, uint32_t pull, uint32_t od,
-		     uint32_t alternate, uint8_t status);
+/* Banks configured at once, enough for the pins of a device */
+#define GPIO_BATCH_NB_BANKS	6U
+
+/* Configuration of the pins of a bank, register fields laid out as in the bank */
+struct gpio_bank_cfg {
+	uint32_t bank;
+	uint32_t pins;
+	uint32_t mode;
+	uint32_t type;
+	uint32_t speed;
+	uint32_t pull;
+	uint32_t od;
+	uint32_t secure;
+	uint64_t alternate;
+};
+
+struct gpio_batch {
+	struct gpio_bank_cfg cfg[GPIO_BATCH_NB_BANKS];
+	unsigned int nb_banks;
+};
+
+static void gpio_batch_flush(struct gpio_batch *batch);
+static void gpio_batch_add(struct gpio_batch *batch, uint32_t bank,
+			   uint32_t pin, uint32_t mode, uint32_t type,
+			   uint32_t speed, uint32_t pull, uint32_t od,
+			   uint32_t alternate, uint8_t status);
 
 /*******************************************************************************
  * This function gets GPIO bank node in DT.
@@ -68,7 +92,8 @@ static int ckeck_gpio_bank(void *fdt, uint32_t bank, int pinctrl_node)
  * When analyze and parsing is done, set the GPIO registers.
  * Returns 0 on success and a negative FDT error code on failure.
  ******************************************************************************/
-static int dt_set_gpio_config(void *fdt, int node, uint8_t status)
+static int dt_set_gpio_config(void *fdt, int node, uint8_t status,
+			      struct gpio_batch *batch)
 {
 	const fdt32_t *cuint, *slewrate;
 	int len;
@@ -170,7 +195,8 @@ static int dt_set_gpio_config(void *fdt, int node, uint8_t status)
 		/* Platform knows the clock: assert it is okay */
 		assert((unsigned long)clk == stm32_get_gpio_bank_clock(bank));
 
-		set_gpio(bank, pin, mode, type, speed, pull, od, alternate, status);
+		gpio_batch_add(batch, bank, pin, mode, type, speed, pull, od,
+			       alternate, status);
 	}
 
 	return 0;
@@ -178,7 +204,8 @@ static int dt_set_gpio_config(void *fdt, int node, uint8_t status)
 
 /*******************************************************************************
  * This function gets the pin settings from DT information.
- * When analyze and parsing is done, set the GPIO registers.
+ * When analyze and parsing is done, set the GPIO registers, each register of
+ * a bank being written once for all the pins of the node.
  * Returns 0 on success and a negative FDT/ERRNO error code on failure.
  ******************************************************************************/
 int dt_set_pinctrl_config(int node)
@@ -188,6 +215,8 @@ int dt_set_pinctrl_config(int node)
 	uint32_t i;
 	uint8_t status;
 	void *fdt;
+	struct gpio_batch batch = { .nb_banks = 0U };
+	int ret = 0;
 
 	if (fdt_get_address(&fdt) == 0) {
 		return -FDT_ERR_NOTFOUND;
@@ -206,67 +235,97 @@ int dt_set_pinctrl_config(int node)
 	for (i = 0; i < ((uint32_t)lenp / 4U); i++) {
 		int p_node, p_subnode;
 
-		p_node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*cuint));
+		p_node = dt_node_offset_by_phandle(fdt32_to_cpu(*cuint));
 		if (p_node < 0) {
-			return -FDT_ERR_NOTFOUND;
+			ret = -FDT_ERR_NOTFOUND;
+			break;
 		}
 
 		fdt_for_each_subnode(p_subnode, fdt, p_node) {
-			int ret = dt_set_gpio_config(fdt, p_subnode, status);
-
+			ret = dt_set_gpio_config(fdt, p_subnode, status,
+						 &batch);
 			if (ret < 0) {
-				return ret;
+				break;
 			}
 		}
 
+		if (ret < 0) {
+			break;
+		}
+
 		cuint++;
 	}
 
-	return 0;
+	/* Pins parsed before an error are configured, as done one by one */
+	gpio_batch_flush(&batch);
+
+	return ret;
 }
 
-static void set_gpio(uint32_t bank, uint32_t pin, uint32_t mode, uint32_t type,
-		     uint32_t speed, uint32_t pull, uint32_t od,
-		     uint32_t alternate, uint8_t status)
+/* Mask of the 2-bit fields of the given pins */
+static uint32_t gpio_pins_mask2(uint32_t pins)
 {
-	uintptr_t base = stm32_get_gpio_bank_base(bank);
-	unsigned long clock = stm32_get_gpio_bank_clock(bank);
+	uint32_t mask = 0U;
+	uint32_t pin;
 
-	assert(pin <= GPIO_PIN_MAX);
+	for (pin = 0U; pin <= GPIO_PIN_MAX; pin++) {
+		if ((pins & BIT(pin)) != 0U) {
+			mask |= GENMASK_32((pin << 1) + 1U, pin << 1);
+		}
+	}
 
-	clk_enable(clock);
+	return mask;
+}
 
-	mmio_clrsetbits_32(base + GPIO_MODE_OFFSET,
-			   (uint32_t)GPIO_MODE_MASK << (pin << 1),
-			   mode << (pin << 1));
+/* Mask of the 4-bit alternate function fields of the given pins */
+static uint64_t gpio_pins_mask4(uint32_t pins)
+{
+	uint64_t mask = 0ULL;
+	uint32_t pin;
 
-	mmio_clrsetbits_32(base + GPIO_TYPE_OFFSET,
-			   (uint32_t)GPIO_TYPE_MASK << pin,
-			   type << pin);
+	for (pin = 0U; pin <= GPIO_PIN_MAX; pin++) {
+		if ((pins & BIT(pin)) != 0U) {
+			mask |= (uint64_t)GPIO_ALTERNATE_MASK << (pin << 2);
+		}
+	}
 
-	mmio_clrsetbits_32(base + GPIO_SPEED_OFFSET,
-			   (uint32_t)GPIO_SPEED_MASK << (pin << 1),
-			   speed << (pin << 1));
+	return mask;
+}
 
-	mmio_clrsetbits_32(base + GPIO_PUPD_OFFSET,
-			   (uint32_t)GPIO_PULL_MASK << (pin << 1),
-			   pull << (pin << 1));
+/*
+ * Write the configuration of the pins of a bank, one access per register.
+ * The mode is written last, so that a pin is driven once fully configured.
+ */
+static void gpio_bank_cfg_apply(struct gpio_bank_cfg *cfg)
+{
+	uint32_t bank = cfg->bank;
+	uintptr_t base = stm32_get_gpio_bank_base(bank);
+	unsigned long clock = stm32_get_gpio_bank_clock(bank);
+	uint32_t mask2 = gpio_pins_mask2(cfg->pins);
+	uint64_t mask4 = gpio_pins_mask4(cfg->pins);
 
-	if (pin < GPIO_ALT_LOWER_LIMIT) {
-		mmio_clrsetbits_32(base + GPIO_AFRL_OFFSET,
-				   (uint32_t)GPIO_ALTERNATE_MASK << (pin << 2),
-				   alternate << (pin << 2));
-	} else {
-		size_t shift = (pin - GPIO_ALT_LOWER_LIMIT) << 2;
+	clk_enable(clock);
+
+	if ((uint32_t)mask4 != 0U) {
+		mmio_clrsetbits_32(base + GPIO_AFRL_OFFSET, (uint32_t)mask4,
+				   (uint32_t)cfg->alternate);
+	}
 
+	if ((uint32_t)(mask4 >> 32) != 0U) {
 		mmio_clrsetbits_32(base + GPIO_AFRH_OFFSET,
-				   (uint32_t)GPIO_ALTERNATE_MASK << shift,
-				   alternate << shift);
+				   (uint32_t)(mask4 >> 32),
+				   (uint32_t)(cfg->alternate >> 32));
 	}
 
-	mmio_clrsetbits_32(base + GPIO_OD_OFFSET,
-			   (uint32_t)GPIO_OD_MASK << pin,
-			   od << pin);
+	mmio_clrsetbits_32(base + GPIO_OD_OFFSET, cfg->pins, cfg->od);
+	mmio_clrsetbits_32(base + GPIO_TYPE_OFFSET, cfg->pins, cfg->type);
+	mmio_clrsetbits_32(base + GPIO_SPEED_OFFSET, mask2, cfg->speed);
+	mmio_clrsetbits_32(base + GPIO_PUPD_OFFSET, mask2, cfg->pull);
+	mmio_clrsetbits_32(base + GPIO_MODE_OFFSET, mask2, cfg->mode);
+
+#if !IMAGE_BL2
+	mmio_clrsetbits_32(base + GPIO_SECR_OFFSET, cfg->pins, cfg->secure);
+#endif
 
 	VERBOSE("GPIO %u mode set to 0x%x\n", bank,
 		mmio_read_32(base + GPIO_MODE_OFFSET));
@@ -284,21 +343,85 @@ static void set_gpio(uint32_t bank, uint32_t pin, uint32_t mode, uint32_t type,
 		mmio_read_32(base + GPIO_OD_OFFSET));
 
 	clk_disable(clock);
+}
+
+static void gpio_batch_flush(struct gpio_batch *batch)
+{
+	unsigned int i;
+
+	for (i = 0U; i < batch->nb_banks; i++) {
+		gpio_bank_cfg_apply(&batch->cfg[i]);
+	}
+
+	batch->nb_banks = 0U;
+}
+
+/* Record the configuration of a pin, written by gpio_batch_flush() */
+static void gpio_batch_add(struct gpio_batch *batch, uint32_t bank,
+			   uint32_t pin, uint32_t mode, uint32_t type,
+			   uint32_t speed, uint32_t pull, uint32_t od,
+			   uint32_t alternate, uint8_t status)
+{
+	struct gpio_bank_cfg *cfg = NULL;
+	uint32_t shift2 = pin << 1;
+	uint32_t shift4 = pin << 2;
+	unsigned int i;
+
+	assert(pin <= GPIO_PIN_MAX);
+
+	for (i = 0U; i < batch->nb_banks; i++) {
+		if (batch->cfg[i].bank == bank) {
+			cfg = &batch->cfg[i];
+			break;
+		}
+	}
+
+	if (cfg == NULL) {
+		if (batch->nb_banks == GPIO_BATCH_NB_BANKS) {
+			gpio_batch_flush(batch);
+		}
+
+		cfg = &batch->cfg[batch->nb_banks];
+		batch->nb_banks++;
+		zeromem(cfg, sizeof(*cfg));
+		cfg->bank = bank;
+	}
+
+	/* A pin listed again takes its last configuration */
+	cfg->pins |= BIT(pin);
+	cfg->mode = (cfg->mode & ~((uint32_t)GPIO_MODE_MASK << shift2)) |
+		    (mode << shift2);
+	cfg->type = (cfg->type & ~((uint32_t)GPIO_TYPE_MASK << pin)) |
+		    (type << pin);
+	cfg->speed = (cfg->speed & ~((uint32_t)GPIO_SPEED_MASK << shift2)) |
+		     (speed << shift2);
+	cfg->pull = (cfg->pull & ~((uint32_t)GPIO_PULL_MASK << shift2)) |
+		    (pull << shift2);
+	cfg->od = (cfg->od & ~((uint32_t)GPIO_OD_MASK << pin)) | (od << pin);
+	cfg->alternate = (cfg->alternate &
+			  ~((uint64_t)GPIO_ALTERNATE_MASK << shift4)) |
+			 ((uint64_t)alternate << shift4);
 
 	if (status == DT_SECURE) {
 		stm32mp_register_secure_gpio(bank, pin);
-#if !IMAGE_BL2
-		set_gpio_secure_cfg(bank, pin, true);
-#endif
-
+		cfg->secure |= BIT(pin);
 	} else {
 		stm32mp_register_non_secure_gpio(bank, pin);
-#if !IMAGE_BL2
-		set_gpio_secure_cfg(bank, pin, false);
-#endif
+		cfg->secure &= ~BIT(pin);
 	}
 }
 
+static void set_gpio(uint32_t bank, uint32_t pin, uint32_t mode, uint32_t type,
+		     uint32_t speed, uint32_t pull, uint32_t od,
+		     uint32_t alternate, uint8_t status)
+{
+	struct gpio_batch batch = { .nb_banks = 0U };
+
+	gpio_batch_add(&batch, bank, pin, mode, type, speed, pull, od,
+		       alternate, status);
+	gpio_batch_flush(&batch);
+}
+
 void set_gpio_secure_cfg(uint32_t bank, uint32_t pin, bool secure)
 {
 	uintptr_t base = stm32_get_gpio_bank_base(bank);
@@ -39,6 +39,11 @@
 
 #define MAX_NBYTE_SIZE		255U
 
+/* Interrupts waking up the core waiting for a transfer event */
+#define I2C_WAIT_IT_MASK	(I2C_CR1_TXIE | I2C_CR1_RXIE | \
+				 I2C_CR1_NACKIE | I2C_CR1_STOPIE | \
+				 I2C_CR1_TCIE | I2C_CR1_ERRIE)
+
 #define I2C_NSEC_PER_SEC	1000000000L
 
 /*
@@ -422,6 +427,80 @@ static int i2c_setup_timing(struct i2c_handle_s *hi2c,
 	return 0;
 }
 
+#if defined(IMAGE_BL32)
+static bool i2c_wait_it_supported(struct i2c_handle_s *hi2c)
+{
+	return (hi2c->irq_event >= 0) && (hi2c->irq_error >= 0);
+}
+
+/*
+ * @brief  Enable the transfer interrupts so that the core waits for the I2C
+ *	   events in WFI rather than polling the status register. Interrupts
+ *	   are only wakeup events, they are masked back at the end of the
+ *	   transfer, before FIQs can be unmasked.
+ * @param  hi2c: Pointer to a struct i2c_handle_s structure that contains
+ *               the configuration information for the specified I2C.
+ * @retval None
+ */
+static void i2c_wait_it_enable(struct i2c_handle_s *hi2c)
+{
+	if (!i2c_wait_it_supported(hi2c)) {
+		return;
+	}
+
+	stm32mp_gic_enable_wakeup_spi((unsigned int)hi2c->irq_event);
+	stm32mp_gic_enable_wakeup_spi((unsigned int)hi2c->irq_error);
+
+	mmio_setbits_32(hi2c->i2c_base_addr + I2C_CR1, I2C_WAIT_IT_MASK);
+}
+
+static void i2c_wait_it_disable(struct i2c_handle_s *hi2c)
+{
+	if (!i2c_wait_it_supported(hi2c)) {
+		return;
+	}
+
+	mmio_clrbits_32(hi2c->i2c_base_addr + I2C_CR1, I2C_WAIT_IT_MASK);
+}
+
+/*
+ * @brief  Wait for the next I2C event, when the transfer interrupts are
+ *	   enabled. Events already pending do not enter WFI.
+ * @param  hi2c: Pointer to a struct i2c_handle_s structure that contains
+ *               the configuration information for the specified I2C.
+ * @retval None
+ */
+static void i2c_wait_event(struct i2c_handle_s *hi2c)
+{
+	if (i2c_wait_it_supported(hi2c) &&
+	    ((mmio_read_32(hi2c->i2c_base_addr + I2C_CR1) &
+	      I2C_WAIT_IT_MASK) != 0U) &&
+	    stm32mp_gic_wait_spi()) {
+		return;
+	}
+
+	timeout_wait_event();
+}
+#else
+static bool i2c_wait_it_supported(struct i2c_handle_s *hi2c)
+{
+	return false;
+}
+
+static void i2c_wait_it_enable(struct i2c_handle_s *hi2c)
+{
+}
+
+static void i2c_wait_it_disable(struct i2c_handle_s *hi2c)
+{
+}
+
+static void i2c_wait_event(struct i2c_handle_s *hi2c)
+{
+	timeout_wait_event();
+}
+#endif
+
 /*
  * @brief  Configure I2C Analog noise filter.
  * @param  hi2c: Pointer to a struct i2c_handle_s structure that contains
@@ -570,6 +649,17 @@ int stm32_i2c_init(struct i2c_handle_s *hi2c,
 		      init_data->general_call_mode |
 		      init_data->no_stretch_mode);
 
+	/*
+	 * When waiting for events in WFI, bound the time a device can hold
+	 * SCL low: the timeout raises an error interrupt waking up the core.
+	 */
+	if (i2c_wait_it_supported(hi2c)) {
+		mmio_write_32(hi2c->i2c_base_addr + I2C_TIMEOUTR,
+			      I2C_TIMEOUTR_TIMEOUTA);
+		mmio_setbits_32(hi2c->i2c_base_addr + I2C_TIMEOUTR,
+				I2C_TIMEOUTR_TIMOUTEN);
+	}
+
 	/* Enable the selected I2C peripheral */
 	mmio_setbits_32(hi2c->i2c_base_addr + I2C_CR1, I2C_CR1_PE);
 
@@ -640,6 +730,8 @@ static int i2c_wait_flag(struct i2c_handle_s *hi2c, uint32_t flag,
 
 			return -EIO;
 		}
+
+		i2c_wait_event(hi2c);
 	}
 }
 
@@ -669,6 +761,8 @@ static int i2c_ack_failed(struct i2c_handle_s *hi2c, uint64_t timeout_ref)
 
 			return -EIO;
 		}
+
+		i2c_wait_event(hi2c);
 	}
 
 	mmio_write_32(hi2c->i2c_base_addr + I2C_ICR, I2C_FLAG_AF);
@@ -710,6 +804,8 @@ static int i2c_wait_txis(struct i2c_handle_s *hi2c, uint64_t timeout_ref)
 
 			return -EIO;
 		}
+
+		i2c_wait_event(hi2c);
 	}
 
 	return 0;
@@ -737,6 +833,8 @@ static int i2c_wait_stop(struct i2c_handle_s *hi2c, uint64_t timeout_ref)
 
 			return -EIO;
 		}
+
+		i2c_wait_event(hi2c);
 	}
 
 	return 0;
@@ -923,6 +1021,8 @@ static int i2c_write(struct i2c_handle_s *hi2c, uint16_t dev_addr,
 	hi2c->i2c_mode = mode;
 	hi2c->i2c_err = I2C_ERROR_NONE;
 
+	i2c_wait_it_enable(hi2c);
+
 	timeout_ref = timeout_init_us(timeout_ms * 1000);
 
 	if (mode == I2C_MODE_MEM) {
@@ -1009,6 +1109,7 @@ static int i2c_write(struct i2c_handle_s *hi2c, uint16_t dev_addr,
 	rc = 0;
 
 bail:
+	i2c_wait_it_disable(hi2c);
 	hi2c->lock = 0;
 	clk_disable(hi2c->clock);
 
@@ -1104,6 +1205,8 @@ static int i2c_read(struct i2c_handle_s *hi2c, uint16_t dev_addr,
 	hi2c->i2c_mode = mode;
 	hi2c->i2c_err = I2C_ERROR_NONE;
 
+	i2c_wait_it_enable(hi2c);
+
 	if (mode == I2C_MODE_MEM) {
 		/* Send Memory Address */
 		if (i2c_request_memory_read(hi2c, dev_addr, mem_addr,
@@ -1178,6 +1281,7 @@ static int i2c_read(struct i2c_handle_s *hi2c, uint16_t dev_addr,
 	rc = 0;
 
 bail:
+	i2c_wait_it_disable(hi2c);
 	hi2c->lock = 0;
 	clk_disable(hi2c->clock);
 
@@ -1290,6 +1394,8 @@ bool stm32_i2c_is_device_ready(struct i2c_handle_s *hi2c,
 				notif_i2c_timeout(hi2c);
 				goto bail;
 			}
+
+			i2c_wait_event(hi2c);
 		} while (true);
 
 		if ((mmio_read_32(hi2c->i2c_base_addr + I2C_ISR) &
@@ -177,7 +177,8 @@ static int stm32_iwdg_conf_etimeout(int node, struct stm32_iwdg_instance *iwdg)
 		mdelay(1);
 	} while ((status != 0U) && (timeout != 0U));
 
-	iwdg->num_irq = stm32mp_gic_enable_spi(node, NULL);
+	iwdg->num_irq = stm32mp_gic_enable_spi_prio(node, NULL,
+					STM32MP_IRQ_SEC_CRITICAL_PRIO);
 	if (iwdg->num_irq < 0) {
 		panic();
 	}
@@ -101,7 +101,7 @@ static void configure_privilege(bool privilege)
  * @param  config: Ref to the region configuration structure.
  * @retval 0 if OK, negative value else.
  */
-static int check_region_settings(struct stm32_mce_region_s *config)
+static int check_region_settings(const struct stm32_mce_region_s *config)
 {
 	uint32_t end;
 
@@ -137,23 +137,14 @@ static int check_region_settings(struct stm32_mce_region_s *config)
 }
 
 /*
- * @brief  Configure (and enable) the MCE region.
+ * @brief  Program (and enable) the MCE region, settings being checked.
  * @param  index: Region index (first region is 0).
  * @param  config: Ref to the region configuration structure.
  * @retval 0 if OK, negative value else.
  */
-static int stm32_mce_configure_region(uint32_t index, struct stm32_mce_region_s *config)
+static int program_region(uint32_t index, const struct stm32_mce_region_s *config)
 {
-	int ret;
-
-	if ((index >= MCE_IP_MAX_REGION_NB) || (config == NULL)) {
-		return -EINVAL;
-	}
-
-	ret = check_region_settings(config);
-	if (ret != 0) {
-		return ret;
-	}
+	assert(index < MCE_IP_MAX_REGION_NB);
 
 	mmio_clrbits_32(MCE_BASE + MCE_REGCR, MCE_REGCR_BREN);
 
@@ -177,6 +168,41 @@ static int stm32_mce_configure_region(uint32_t index, struct stm32_mce_region_s
 	return 0;
 }
 
+/*
+ * @brief  Configure (and enable) a table of MCE regions. All the settings
+ *	   are checked before the first region is programmed.
+ * @param  regions: Ref to the region configuration table.
+ * @param  nb_regions: Number of regions in the table, first region is 0.
+ * @retval 0 if OK, negative value else.
+ */
+int stm32_mce_configure_regions(const struct stm32_mce_region_s *regions,
+				uint32_t nb_regions)
+{
+	uint32_t idx;
+	int ret;
+
+	if ((nb_regions > MCE_IP_MAX_REGION_NB) ||
+	    ((regions == NULL) && (nb_regions != 0U))) {
+		return -EINVAL;
+	}
+
+	for (idx = 0U; idx < nb_regions; idx++) {
+		ret = check_region_settings(&regions[idx]);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	for (idx = 0U; idx < nb_regions; idx++) {
+		ret = program_region(idx, &regions[idx]);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * @brief  Initialize the MCE driver.
  * @param  None.
@@ -350,32 +376,34 @@ int stm32_mce_get_address_encryption_state(uint32_t address, uint32_t *state)
 
 void stm32_mce_reload_configuration(void)
 {
+	struct stm32_mce_region_s regions[MCE_IP_MAX_REGION_NB];
 	uint32_t idx;
 
 	for (idx = 0U; idx < MCE_IP_MAX_REGION_NB; idx++) {
-		struct stm32_mce_region_s region;
+		stm32mp1_pm_get_mce_region(idx, &regions[idx]);
 
-		stm32mp1_pm_get_mce_region(idx, &region);
-
-		if (region.end_address == 0U) {
+		if (regions[idx].end_address == 0U) {
 			break;
 		}
 
 		VERBOSE("%s: mce cell found with value = 0x%x 0x%x 0x%x\n", __func__,
-			region.start_address, region.end_address, region.encrypt_mode);
+			regions[idx].start_address, regions[idx].end_address,
+			regions[idx].encrypt_mode);
+	}
 
-		if (stm32_mce_configure_region(idx, &region) != 0) {
-			panic();
-		}
+	if (stm32_mce_configure_regions(regions, idx) != 0) {
+		panic();
 	}
 }
 
-static int fconf_populate_mce(uintptr_t config)
+static int fconf_populate_mce(uintptr_t config, int node)
 {
-	int node, len;
+	int len;
 	unsigned int i;
 	const struct mce_dt_id_attr *conf_list;
 	const void *dtb = (const void *)config;
+	struct stm32_mce_region_s regions[MCE_IP_MAX_REGION_NB];
+	unsigned int nb_regions;
 
 	/* Check the node offset point to "st,mem-encrypt" compatible property */
 	const char *compatible_str = "st,mem-encrypt";
@@ -384,7 +412,6 @@ static int fconf_populate_mce(uintptr_t config)
 		return 0;
 	}
 
-	node = fdt_node_offset_by_compatible(dtb, -1, compatible_str);
 	if (node < 0) {
 		ERROR("FCONF: Can't find %s compatible in dtb\n", compatible_str);
 		return node;
@@ -399,27 +426,36 @@ static int fconf_populate_mce(uintptr_t config)
 	/* Consider only complete set of values */
 	len -= len % MCE_REGION_PARAMS;
 
+	nb_regions = (unsigned int)(len / (sizeof(uint32_t) * MCE_REGION_PARAMS));
+	if (nb_regions > MCE_IP_MAX_REGION_NB) {
+		ERROR("FCONF: Too many MCE regions\n");
+		panic();
+	}
+
 	/* Locate the memory cells and read all values */
-	for (i = 0U; i < (unsigned int)(len / (sizeof(uint32_t) * MCE_REGION_PARAMS)); i++) {
+	for (i = 0U; i < nb_regions; i++) {
+		struct stm32_mce_region_s *region = &regions[i];
 		uint32_t size;
-		struct stm32_mce_region_s region;
 
-		region.start_address = fdt32_to_cpu(conf_list->id_attr[i * MCE_REGION_PARAMS]);
+		region->start_address = fdt32_to_cpu(conf_list->id_attr[i * MCE_REGION_PARAMS]);
 		size = fdt32_to_cpu(conf_list->id_attr[i * MCE_REGION_PARAMS + 1U]);
-		region.end_address = region.start_address + size - 1U;
-		region.encrypt_mode = fdt32_to_cpu(conf_list->id_attr[i * MCE_REGION_PARAMS + 2U]);
+		region->end_address = region->start_address + size - 1U;
+		region->encrypt_mode = fdt32_to_cpu(conf_list->id_attr[i * MCE_REGION_PARAMS + 2U]);
 
 		VERBOSE("FCONF: mce cell found with value = 0x%x 0x%x 0x%x\n",
-			region.start_address, size, region.encrypt_mode);
+			region->start_address, size, region->encrypt_mode);
+	}
 
-		if (stm32_mce_configure_region(i, &region) != 0) {
-			panic();
-		}
+	if (stm32_mce_configure_regions(regions, nb_regions) != 0) {
+		panic();
+	}
 
-		stm32mp1_pm_save_mce_region(i, &region);
+	for (i = 0U; i < nb_regions; i++) {
+		stm32mp1_pm_save_mce_region(i, &regions[i]);
 	}
 
 	return 0;
 }
 
-FCONF_REGISTER_POPULATOR(FW_CONFIG, mce_config, fconf_populate_mce);
+FCONF_REGISTER_NODE_POPULATOR(FW_CONFIG, mce_config, "st,mem-encrypt",
+			      fconf_populate_mce);
@@ -15,6 +15,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/clk.h>
 #include <drivers/delay_timer.h>
 #include <drivers/mmc.h>
@@ -52,6 +53,8 @@
 /* SDMMC power control register */
 #define SDMMC_POWER_PWRCTRL		GENMASK(1, 0)
 #define SDMMC_POWER_PWRCTRL_PWR_CYCLE	BIT(1)
+#define SDMMC_POWER_VSWITCH		BIT(2)
+#define SDMMC_POWER_VSWITCHEN		BIT(3)
 #define SDMMC_POWER_DIRPOL		BIT(4)
 
 /* SDMMC clock control register */
@@ -59,7 +62,10 @@
 #define SDMMC_CLKCR_WIDBUS_8		BIT(15)
 #define SDMMC_CLKCR_NEGEDGE		BIT(16)
 #define SDMMC_CLKCR_HWFC_EN		BIT(17)
+#define SDMMC_CLKCR_DDR			BIT(18)
+#define SDMMC_CLKCR_BUSSPEED		BIT(19)
 #define SDMMC_CLKCR_SELCLKRX_0		BIT(20)
+#define SDMMC_CLKCR_SELCLKRX_1		BIT(21)
 
 /* SDMMC command register */
 #define SDMMC_CMDR_CMDTRANS		BIT(6)
@@ -96,12 +102,38 @@
 #define SDMMC_STAR_DPSMACT		BIT(12)
 #define SDMMC_STAR_RXFIFOHF		BIT(15)
 #define SDMMC_STAR_RXFIFOE		BIT(19)
+#define SDMMC_STAR_BUSYD0		BIT(20)
+#define SDMMC_STAR_VSWEND		BIT(25)
+#define SDMMC_STAR_CKSTOP		BIT(26)
 #define SDMMC_STAR_IDMATE		BIT(27)
 #define SDMMC_STAR_IDMABTC		BIT(28)
 
 /* SDMMC DMA control register */
 #define SDMMC_IDMACTRLR_IDMAEN		BIT(0)
 
+/* Delay block registers offsets */
+#define DLYB_CR				0x00U
+#define DLYB_CFGR			0x04U
+
+/* Delay block control register */
+#define DLYB_CR_DEN			BIT(0)
+#define DLYB_CR_SEN			BIT(1)
+
+/* Delay block configuration register */
+#define DLYB_CFGR_SEL_MASK		GENMASK(3, 0)
+#define DLYB_CFGR_UNIT_MASK		GENMASK(14, 8)
+#define DLYB_CFGR_UNIT_SHIFT		8
+#define DLYB_CFGR_LNG_MASK		GENMASK(27, 16)
+#define DLYB_CFGR_LNG_SHIFT		16
+#define DLYB_CFGR_LNGF			BIT(31)
+
+#define DLYB_NB_DELAY			11U
+#define DLYB_CFGR_SEL_MAX		(DLYB_NB_DELAY + 1U)
+#define DLYB_CFGR_UNIT_MAX		127U
+
+/* Above this bus frequency, data are sampled with the delay block */
+#define DLYB_MIN_FREQ			U(50000000)
+
 #define SDMMC_STATIC_FLAGS		(SDMMC_STAR_CCRCFAIL | \
 					 SDMMC_STAR_DCRCFAIL | \
 					 SDMMC_STAR_CTIMEOUT | \
@@ -126,6 +158,10 @@
 #define POWER_OFF_DELAY			2
 #define POWER_ON_DELAY			1
 
+/* IO voltages in mV */
+#define SDMMC_SIGNAL_3V3		3300U
+#define SDMMC_SIGNAL_1V8		1800U
+
 #ifndef DT_SDMMC2_COMPAT
 #define DT_SDMMC2_COMPAT		"st,stm32-sdmmc2"
 #endif
@@ -137,6 +173,8 @@ static int stm32_sdmmc2_set_ios(unsigned int clk, unsigned int width);
 static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size);
 static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size);
 static int stm32_sdmmc2_write(int lba, uintptr_t buf, size_t size);
+static int stm32_sdmmc2_execute_tuning(void);
+static int stm32_sdmmc2_voltage_switch(void);
 
 static const struct mmc_ops stm32_sdmmc2_ops = {
 	.init		= stm32_sdmmc2_init,
@@ -145,12 +183,20 @@ static const struct mmc_ops stm32_sdmmc2_ops = {
 	.prepare	= stm32_sdmmc2_prepare,
 	.read		= stm32_sdmmc2_read,
 	.write		= stm32_sdmmc2_write,
+	.execute_tuning	= stm32_sdmmc2_execute_tuning,
+	.voltage_switch	= stm32_sdmmc2_voltage_switch,
 };
 
 static struct stm32_sdmmc2_params sdmmc2_params;
 
 static bool next_cmd_is_acmd;
 
+/* Set while the sampling point is tuned, expected errors are not reported */
+static bool tuning_ongoing;
+
+/* Set when the bus frequency requires the delay block */
+static bool dlyb_used;
+
 #pragma weak plat_sdmmc2_use_dma
 bool plat_sdmmc2_use_dma(unsigned int instance, unsigned int memory)
 {
@@ -171,6 +217,14 @@ static void stm32_sdmmc2_init(void)
 		regulator_disable(sdmmc2_params.vmmc_regu);
 	}
 
+	/* The card restarts with 3.3V signalling */
+	if (sdmmc2_params.vqmmc_regu != NULL) {
+		if (regulator_set_voltage(sdmmc2_params.vqmmc_regu,
+					  SDMMC_SIGNAL_3V3) != 0) {
+			WARN("%s: cannot set IO voltage to 3.3V\n", __func__);
+		}
+	}
+
 	mdelay(VCC_POWER_OFF_DELAY);
 
 	mmio_write_32(base + SDMMC_POWER,
@@ -253,6 +307,10 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 	case MMC_CMD(1):
 		arg_reg |= OCR_POWERUP;
 		break;
+	case MMC_CMD(11):
+		/* The clock is stopped after the response, for the switch */
+		mmio_setbits_32(base + SDMMC_POWER, SDMMC_POWER_VSWITCHEN);
+		break;
 	case MMC_CMD(6):
 		if ((sdmmc2_params.device_info->mmc_dev_type == MMC_IS_SD_HC) &&
 		    (!next_cmd_is_acmd)) {
@@ -277,14 +335,14 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 		break;
 	case MMC_CMD(17):
 	case MMC_CMD(18):
+	case MMC_CMD(19):
+	case MMC_CMD(21):
+		/*
+		 * The end of the data transfer is awaited in the read
+		 * function, so that the IDMA transfer runs in background
+		 * between mmc_read_blocks_start() and mmc_read_blocks_wait().
+		 */
 		cmd_reg |= SDMMC_CMDR_CMDTRANS;
-		if (sdmmc2_params.use_dma) {
-			flags_data |= SDMMC_STAR_DCRCFAIL |
-				      SDMMC_STAR_DTIMEOUT |
-				      SDMMC_STAR_DATAEND |
-				      SDMMC_STAR_RXOVERR |
-				      SDMMC_STAR_IDMATE;
-		}
 		break;
 	case MMC_ACMD(41):
 		arg_reg |= OCR_3_2_3_3 | OCR_3_3_3_4;
@@ -310,10 +368,11 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 
 	/*
 	 * Clear the SDMMC_DCTRLR if the command does not await data.
-	 * Skip CMD55 as the next command could be data related, and
-	 * the register could have been set in prepare function.
+	 * Skip CMD55 and CMD23 as the next command could be data related,
+	 * and the register could have been set in prepare function.
 	 */
-	if (((cmd_reg & SDMMC_CMDR_CMDTRANS) == 0U) && !next_cmd_is_acmd) {
+	if (((cmd_reg & SDMMC_CMDR_CMDTRANS) == 0U) && !next_cmd_is_acmd &&
+	    (cmd->cmd_idx != MMC_CMD(23))) {
 		mmio_write_32(base + SDMMC_DCTRLR, 0U);
 	}
 
@@ -337,6 +396,8 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 			goto err_exit;
 		}
 
+		timeout_wait_event();
+
 		status = mmio_read_32(base + SDMMC_STAR);
 	}
 
@@ -351,14 +412,17 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 			if (!((cmd->cmd_idx == MMC_CMD(1)) ||
 			      (cmd->cmd_idx == MMC_CMD(13)) ||
 			      ((cmd->cmd_idx == MMC_CMD(8)) &&
-			       (cmd->resp_type == MMC_RESPONSE_R7)))) {
+			       (cmd->resp_type == MMC_RESPONSE_R7)) ||
+			      tuning_ongoing)) {
 				ERROR("%s: CTIMEOUT (cmd = %d,status = %x)\n",
 				      __func__, cmd->cmd_idx, status);
 			}
 		} else {
 			err = -EIO;
-			ERROR("%s: CRCFAIL (cmd = %d,status = %x)\n",
-			      __func__, cmd->cmd_idx, status);
+			if (!tuning_ongoing) {
+				ERROR("%s: CRCFAIL (cmd = %d,status = %x)\n",
+				      __func__, cmd->cmd_idx, status);
+			}
 		}
 
 		goto err_exit;
@@ -404,6 +468,8 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 			goto err_exit;
 		}
 
+		timeout_wait_event();
+
 		status = mmio_read_32(base + SDMMC_STAR);
 	};
 
@@ -448,6 +514,10 @@ static int stm32_sdmmc2_send_cmd(struct mmc_cmd *cmd)
 			return 0; /* Retry managed by framework */
 		}
 
+		if (tuning_ongoing) {
+			return err; /* Next sampling point tried */
+		}
+
 		/* Command 8 is expected to fail for eMMC */
 		if (cmd->cmd_idx != MMC_CMD(8)) {
 			WARN(" CMD%u, Retry: %u, Error: %d\n",
@@ -464,9 +534,11 @@ static int stm32_sdmmc2_set_ios(unsigned int clk, unsigned int width)
 {
 	uintptr_t base = sdmmc2_params.reg_base;
 	uint32_t bus_cfg = 0;
-	uint32_t clock_div, max_freq, freq;
+	uint32_t clock_div, max_freq, freq, bus_freq;
 	uint32_t clk_rate = sdmmc2_params.clk_rate;
 	uint32_t max_bus_freq = sdmmc2_params.device_info->max_bus_freq;
+	uint32_t negedge = sdmmc2_params.negedge;
+	uint32_t pin_ckin = sdmmc2_params.pin_ckin;
 
 	switch (width) {
 	case MMC_BUS_WIDTH_1:
@@ -477,19 +549,34 @@ static int stm32_sdmmc2_set_ios(unsigned int clk, unsigned int width)
 	case MMC_BUS_WIDTH_8:
 		bus_cfg |= SDMMC_CLKCR_WIDBUS_8;
 		break;
+	case MMC_BUS_WIDTH_DDR_4:
+		bus_cfg |= SDMMC_CLKCR_WIDBUS_4 | SDMMC_CLKCR_DDR;
+		break;
+	case MMC_BUS_WIDTH_DDR_8:
+		bus_cfg |= SDMMC_CLKCR_WIDBUS_8 | SDMMC_CLKCR_DDR;
+		break;
 	default:
 		panic();
 		break;
 	}
 
 	if (sdmmc2_params.device_info->mmc_dev_type == MMC_IS_EMMC) {
-		if (max_bus_freq >= 52000000U) {
+		if (max_bus_freq > 52000000U) {
+			max_freq = STM32MP_EMMC_HS200_MAX_FREQ;
+			bus_cfg |= SDMMC_CLKCR_BUSSPEED;
+		} else if (max_bus_freq >= 52000000U) {
 			max_freq = STM32MP_EMMC_HIGH_SPEED_MAX_FREQ;
 		} else {
 			max_freq = STM32MP_EMMC_NORMAL_SPEED_MAX_FREQ;
 		}
 	} else {
-		if (max_bus_freq >= 50000000U) {
+		if (max_bus_freq > SD_SDR50_MAX_FREQ) {
+			max_freq = STM32MP_SD_SDR104_MAX_FREQ;
+			bus_cfg |= SDMMC_CLKCR_BUSSPEED;
+		} else if (max_bus_freq > 50000000U) {
+			max_freq = STM32MP_SD_SDR50_MAX_FREQ;
+			bus_cfg |= SDMMC_CLKCR_BUSSPEED;
+		} else if (max_bus_freq >= 50000000U) {
 			max_freq = STM32MP_SD_HIGH_SPEED_MAX_FREQ;
 		} else {
 			max_freq = STM32MP_SD_NORMAL_SPEED_MAX_FREQ;
@@ -502,16 +589,204 @@ static int stm32_sdmmc2_set_ios(unsigned int clk, unsigned int width)
 		freq = max_freq;
 	}
 
-	clock_div = div_round_up(clk_rate, freq * 2U);
+	/* The kernel clock cannot be bypassed in DDR mode */
+	if ((freq >= clk_rate) && ((bus_cfg & SDMMC_CLKCR_DDR) == 0U)) {
+		clock_div = 0U;
+		bus_freq = clk_rate;
+	} else {
+		clock_div = div_round_up(clk_rate, freq * 2U);
+		bus_freq = clk_rate / (clock_div * 2U);
+	}
+
+	/* Data and command are not output on the falling edge in DDR mode */
+	if ((bus_cfg & SDMMC_CLKCR_DDR) != 0U) {
+		negedge = 0U;
+	}
+
+	/* The feedback clock is delayed by the delay block, set by tuning */
+	dlyb_used = (bus_freq > DLYB_MIN_FREQ) &&
+		    (sdmmc2_params.dlyb_base != 0U);
+	if (dlyb_used) {
+		pin_ckin = SDMMC_CLKCR_SELCLKRX_1;
+	} else if (sdmmc2_params.dlyb_base != 0U) {
+		mmio_write_32(sdmmc2_params.dlyb_base + DLYB_CR, 0U);
+	}
 
 	mmio_write_32(base + SDMMC_CLKCR,
 		      SDMMC_CLKCR_HWFC_EN | clock_div | bus_cfg |
-		      sdmmc2_params.negedge |
-		      sdmmc2_params.pin_ckin);
+		      negedge | pin_ckin);
+
+	return 0;
+}
+
+static void stm32_sdmmc2_dlyb_set_cfgr(unsigned int unit, unsigned int phase,
+				       bool sampler)
+{
+	uintptr_t dlyb_base = sdmmc2_params.dlyb_base;
+
+	mmio_write_32(dlyb_base + DLYB_CR, DLYB_CR_SEN | DLYB_CR_DEN);
+
+	mmio_write_32(dlyb_base + DLYB_CFGR,
+		      ((unit << DLYB_CFGR_UNIT_SHIFT) & DLYB_CFGR_UNIT_MASK) |
+		      (phase & DLYB_CFGR_SEL_MASK));
+
+	if (!sampler) {
+		mmio_write_32(dlyb_base + DLYB_CR, DLYB_CR_DEN);
+	}
+}
+
+/*
+ * Find the delay unit for which one bus clock period is covered by the delay
+ * line, and the number of phases in this period.
+ */
+static int stm32_sdmmc2_dlyb_lng_tuning(unsigned int *unit,
+					unsigned int *max_phase)
+{
+	uintptr_t dlyb_base = sdmmc2_params.dlyb_base;
+	unsigned int i;
+
+	for (i = 0U; i <= DLYB_CFGR_UNIT_MAX; i++) {
+		uint64_t timeout;
+		uint32_t cfgr;
+		uint32_t lng;
+
+		stm32_sdmmc2_dlyb_set_cfgr(i, DLYB_CFGR_SEL_MAX, true);
+
+		timeout = timeout_init_us(TIMEOUT_US_1_MS);
+		do {
+			cfgr = mmio_read_32(dlyb_base + DLYB_CFGR);
+		} while (((cfgr & DLYB_CFGR_LNGF) == 0U) &&
+			 !timeout_elapsed(timeout));
+
+		if ((cfgr & DLYB_CFGR_LNGF) == 0U) {
+			continue;
+		}
+
+		lng = (cfgr & DLYB_CFGR_LNG_MASK) >> DLYB_CFGR_LNG_SHIFT;
+		if ((lng > 0U) && (lng < BIT(DLYB_NB_DELAY))) {
+			*unit = i;
+			*max_phase = 31U - __builtin_clz(lng);
+
+			return 0;
+		}
+	}
+
+	return -EIO;
+}
+
+/*
+ * HS200, SDR50 and SDR104 sampling point tuning: the tuning block is read for each phase of
+ * the delay block, the middle of the longest valid window is kept.
+ */
+static int stm32_sdmmc2_execute_tuning(void)
+{
+	unsigned int unit;
+	unsigned int max_phase;
+	unsigned int phase;
+	unsigned int cur_len = 0U;
+	unsigned int max_len = 0U;
+	unsigned int end_of_len = 0U;
+	int ret;
+
+	if (!dlyb_used) {
+		return 0;
+	}
+
+	ret = stm32_sdmmc2_dlyb_lng_tuning(&unit, &max_phase);
+	if (ret != 0) {
+		ERROR("%s: delay line length not found\n", __func__);
+		return ret;
+	}
+
+	tuning_ongoing = true;
+
+	for (phase = 0U; phase <= max_phase; phase++) {
+		stm32_sdmmc2_dlyb_set_cfgr(unit, phase, false);
+
+		if (mmc_send_tuning() != 0) {
+			cur_len = 0U;
+			continue;
+		}
+
+		cur_len++;
+		if (cur_len > max_len) {
+			max_len = cur_len;
+			end_of_len = phase;
+		}
+	}
+
+	tuning_ongoing = false;
+
+	if (max_len == 0U) {
+		ERROR("%s: no tuning point found\n", __func__);
+		return -EIO;
+	}
+
+	phase = end_of_len - (max_len / 2U);
+	stm32_sdmmc2_dlyb_set_cfgr(unit, phase, false);
+
+	VERBOSE("%s: unit %u, max phase %u, phase %u\n", __func__,
+		unit, max_phase, phase);
 
 	return 0;
 }
 
+/*
+ * Second part of the voltage switch sequence, after CMD11 response: once the
+ * bus clock is stopped, the IO lines are switched to 1.8V, then the clock is
+ * restarted by the hardware after 5ms. The card releases DAT0 when it has
+ * completed the switch.
+ */
+static int stm32_sdmmc2_voltage_switch(void)
+{
+	uintptr_t base = sdmmc2_params.reg_base;
+	uint64_t timeout;
+	uint32_t status;
+	int ret = 0;
+
+	if (sdmmc2_params.vqmmc_regu == NULL) {
+		ret = -ENOTSUP;
+		goto out;
+	}
+
+	timeout = timeout_init_us(TIMEOUT_US_10_MS);
+	while ((mmio_read_32(base + SDMMC_STAR) & SDMMC_STAR_CKSTOP) == 0U) {
+		if (timeout_elapsed(timeout)) {
+			ret = -ETIMEDOUT;
+			goto out;
+		}
+	}
+
+	ret = regulator_set_voltage(sdmmc2_params.vqmmc_regu,
+				    SDMMC_SIGNAL_1V8);
+	if (ret != 0) {
+		goto out;
+	}
+
+	mmio_setbits_32(base + SDMMC_POWER, SDMMC_POWER_VSWITCH);
+
+	timeout = timeout_init_us(TIMEOUT_US_10_MS);
+	do {
+		status = mmio_read_32(base + SDMMC_STAR);
+		if (timeout_elapsed(timeout)) {
+			ret = -ETIMEDOUT;
+			goto out;
+		}
+	} while ((status & SDMMC_STAR_VSWEND) == 0U);
+
+	if ((status & SDMMC_STAR_BUSYD0) != 0U) {
+		ret = -EIO;
+	}
+
+out:
+	mmio_write_32(base + SDMMC_ICR,
+		      SDMMC_STAR_CKSTOP | SDMMC_STAR_VSWEND);
+	mmio_clrbits_32(base + SDMMC_POWER,
+			SDMMC_POWER_VSWITCH | SDMMC_POWER_VSWITCHEN);
+
+	return ret;
+}
+
 static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size)
 {
 	struct mmc_cmd cmd;
@@ -541,16 +816,19 @@ static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size)
 
 	mmio_write_32(base + SDMMC_DCTRLR, 0);
 
-	zeromem(&cmd, sizeof(struct mmc_cmd));
+	/* The block length is fixed to 512 bytes in DDR mode */
+	if ((mmio_read_32(base + SDMMC_CLKCR) & SDMMC_CLKCR_DDR) == 0U) {
+		zeromem(&cmd, sizeof(struct mmc_cmd));
 
-	cmd.cmd_idx = MMC_CMD(16);
-	cmd.cmd_arg = arg_size;
-	cmd.resp_type = MMC_RESPONSE_R1;
+		cmd.cmd_idx = MMC_CMD(16);
+		cmd.cmd_arg = arg_size;
+		cmd.resp_type = MMC_RESPONSE_R1;
 
-	ret = stm32_sdmmc2_send_cmd(&cmd);
-	if (ret != 0) {
-		ERROR("CMD16 failed\n");
-		return ret;
+		ret = stm32_sdmmc2_send_cmd(&cmd);
+		if (ret != 0) {
+			ERROR("CMD16 failed\n");
+			return ret;
+		}
 	}
 
 	/* Prepare data command */
@@ -575,6 +853,56 @@ static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size)
 	return 0;
 }
 
+static int stm32_sdmmc2_wait_dma_end(uintptr_t buf, size_t size)
+{
+	uint32_t error_flags = SDMMC_STAR_RXOVERR | SDMMC_STAR_DCRCFAIL |
+			       SDMMC_STAR_DTIMEOUT | SDMMC_STAR_IDMATE;
+	uint32_t status;
+	uintptr_t base = sdmmc2_params.reg_base;
+	uint64_t timeout;
+	int ret = 0;
+
+	timeout = timeout_init_us(TIMEOUT_US_1_S);
+
+	do {
+		status = mmio_read_32(base + SDMMC_STAR);
+
+		if (timeout_elapsed(timeout)) {
+			ERROR("%s: timeout 1s (status = %x)\n",
+			      __func__, status);
+			ret = -ETIMEDOUT;
+			break;
+		}
+	} while ((status & (error_flags | SDMMC_STAR_DATAEND)) == 0U);
+
+	if ((status & error_flags) != 0U) {
+		if (!tuning_ongoing) {
+			ERROR("%s: Read error (status = %x)\n", __func__,
+			      status);
+		}
+		ret = -EIO;
+	}
+
+	mmio_write_32(base + SDMMC_ICR, SDMMC_STATIC_FLAGS);
+	mmio_clrbits_32(base + SDMMC_CMDR, SDMMC_CMDR_CMDTRANS);
+
+	if (ret != 0) {
+		if ((status & SDMMC_STAR_DPSMACT) != 0U) {
+			int ret_stop = stm32_sdmmc2_stop_transfer();
+
+			if (ret_stop != 0) {
+				return ret_stop;
+			}
+		}
+
+		return ret;
+	}
+
+	inv_dcache_range(buf, size);
+
+	return 0;
+}
+
 static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 {
 	uint32_t error_flags = SDMMC_STAR_RXOVERR | SDMMC_STAR_DCRCFAIL |
@@ -593,9 +921,7 @@ static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 	buffer = (uint32_t *)buf;
 
 	if (sdmmc2_params.use_dma) {
-		inv_dcache_range(buf, size);
-
-		return 0;
+		return stm32_sdmmc2_wait_dma_end(buf, size);
 	}
 
 	if (size <= MMC_BLOCK_SIZE) {
@@ -608,8 +934,10 @@ static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 		status = mmio_read_32(base + SDMMC_STAR);
 
 		if ((status & error_flags) != 0U) {
-			ERROR("%s: Read error (status = %x)\n", __func__,
-			      status);
+			if (!tuning_ongoing) {
+				ERROR("%s: Read error (status = %x)\n",
+				      __func__, status);
+			}
 			mmio_write_32(base + SDMMC_DCTRLR,
 				      SDMMC_DCTRLR_FIFORST);
 
@@ -736,8 +1064,43 @@ static int stm32_sdmmc2_dt_get_config(void)
 		sdmmc2_params.max_freq = fdt32_to_cpu(*cuint);
 	}
 
+	if (fdt_getprop(fdt, sdmmc_node, "cap-mmc-highspeed", NULL) != NULL) {
+		sdmmc2_params.flags |= MMC_FLAG_EMMC_HS;
+	}
+
+	if ((fdt_getprop(fdt, sdmmc_node, "mmc-ddr-3_3v", NULL) != NULL) ||
+	    (fdt_getprop(fdt, sdmmc_node, "mmc-ddr-1_8v", NULL) != NULL)) {
+		sdmmc2_params.flags |= MMC_FLAG_EMMC_DDR52;
+	}
+
+	/* HS200 requires the delay block, its registers are the second range */
+	if (fdt_get_reg_props_by_index(fdt, sdmmc_node, 1,
+				       &sdmmc2_params.dlyb_base, NULL) != 0) {
+		sdmmc2_params.dlyb_base = 0U;
+	} else if (fdt_getprop(fdt, sdmmc_node, "mmc-hs200-1_8v",
+			       NULL) != NULL) {
+		sdmmc2_params.flags |= MMC_FLAG_EMMC_HS200;
+	}
+
 	sdmmc2_params.vmmc_regu = regulator_get_by_supply_name(fdt, sdmmc_node, "vmmc");
 
+	/*
+	 * SD UHS-I modes require the 1.8V signalling, switched by the vqmmc
+	 * supply through the external level shifter, and the delay block.
+	 */
+	sdmmc2_params.vqmmc_regu = regulator_get_by_supply_name(fdt, sdmmc_node,
+								"vqmmc");
+	if ((sdmmc2_params.vqmmc_regu != NULL) &&
+	    (sdmmc2_params.dlyb_base != 0U)) {
+		if (fdt_getprop(fdt, sdmmc_node, "sd-uhs-sdr50", NULL) != NULL) {
+			sdmmc2_params.flags |= MMC_FLAG_SD_SDR50;
+		}
+
+		if (fdt_getprop(fdt, sdmmc_node, "sd-uhs-sdr104", NULL) != NULL) {
+			sdmmc2_params.flags |= MMC_FLAG_SD_SDR104;
+		}
+	}
+
 	return 0;
 }
 
@@ -746,7 +1109,11 @@ unsigned long long stm32_sdmmc2_mmc_get_device_size(void)
 	return sdmmc2_params.device_info->device_size;
 }
 
-int stm32_sdmmc2_mmc_init(struct stm32_sdmmc2_params *params)
+/*
+ * The card identification is completed with mmc_init_poll(), it can be stepped
+ * while the caller waits for other devices.
+ */
+int stm32_sdmmc2_mmc_init_start(struct stm32_sdmmc2_params *params)
 {
 	assert((params != NULL) &&
 	       ((params->reg_base & MMC_BLOCK_MASK) == 0U) &&
@@ -757,6 +1124,7 @@ int stm32_sdmmc2_mmc_init(struct stm32_sdmmc2_params *params)
 	memcpy(&sdmmc2_params, params, sizeof(struct stm32_sdmmc2_params));
 
 	sdmmc2_params.vmmc_regu = NULL;
+	sdmmc2_params.vqmmc_regu = NULL;
 
 	if (stm32_sdmmc2_dt_get_config() != 0) {
 		ERROR("%s: DT error\n", __func__);
@@ -783,7 +1151,23 @@ int stm32_sdmmc2_mmc_init(struct stm32_sdmmc2_params *params)
 	sdmmc2_params.clk_rate = clk_get_rate(sdmmc2_params.clock_id);
 	sdmmc2_params.device_info->ocr_voltage = OCR_3_2_3_3 | OCR_3_3_3_4;
 
-	return mmc_init(&stm32_sdmmc2_ops, sdmmc2_params.clk_rate,
-			sdmmc2_params.bus_width, sdmmc2_params.flags,
-			sdmmc2_params.device_info);
+	return mmc_init_start(&stm32_sdmmc2_ops, sdmmc2_params.clk_rate,
+			      sdmmc2_params.bus_width, sdmmc2_params.flags,
+			      sdmmc2_params.device_info);
+}
+
+int stm32_sdmmc2_mmc_init(struct stm32_sdmmc2_params *params)
+{
+	int ret;
+
+	ret = stm32_sdmmc2_mmc_init_start(params);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_init_poll();
+	} while (ret == -EAGAIN);
+
+	return ret;
 }
@@ -151,6 +151,16 @@ bool initialize_pmic_i2c(void)
 	i2c->dt_status			= i2c_info.status;
 	i2c->clock			= i2c_info.clock;
 	i2c->i2c_state			= I2C_STATE_RESET;
+	i2c->irq_event			= -1;
+	i2c->irq_error			= -1;
+#if defined(IMAGE_BL32)
+	/* Runtime transfers wait for the I2C events in WFI */
+	if (stm32mp1_i2c_get_irqs(i2c->i2c_base_addr, &i2c->irq_event,
+				  &i2c->irq_error) != 0) {
+		i2c->irq_event = -1;
+		i2c->irq_error = -1;
+	}
+#endif
 	i2c_init.own_address1		= pmic_i2c_addr;
 	i2c_init.addressing_mode	= I2C_ADDRESSINGMODE_7BIT;
 	i2c_init.dual_address_mode	= I2C_DUALADDRESS_DISABLE;
@@ -504,6 +514,16 @@ static int driver_suspend(const struct regul_description *desc, uint8_t state, u
 	return 0;
 }
 
+static int driver_batch_start(const struct regul_description *desc)
+{
+	return stpmic1_lp_batch_start();
+}
+
+static int driver_batch_commit(const struct regul_description *desc)
+{
+	return stpmic1_lp_batch_commit();
+}
+
 static void driver_lock(const struct regul_description *desc)
 {
 	if (stm32mp_lock_available()) {
@@ -530,6 +550,8 @@ struct regul_ops pmic_ops = {
 	.lock = driver_lock,
 	.unlock = driver_unlock,
 	.suspend = driver_suspend,
+	.batch_start = driver_batch_start,
+	.batch_commit = driver_batch_commit,
 #endif
 };
 
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <common/debug.h>
@@ -868,24 +870,45 @@ int stpmic1_regulator_levels_mv(const char *name, const uint16_t **levels,
 	return 0;
 }
 
-int stpmic1_regulator_voltage_get(const char *name)
+static bool regulator_voltage_is_readable(const char *name, uint8_t *mask)
 {
-	const struct regul_struct *regul = get_regulator_data(name);
-	uint8_t value;
-	uint8_t mask;
-	int status;
-
 	if ((strncmp(name, "ldo3", 4) == 0) && ldo3_special_mode) {
-		return 0;
+		return false;
 	}
 
 	/* Voltage can be set for buck<N> or ldo<N> (except ldo4) regulators */
 	if (strncmp(name, "buck", 4) == 0) {
-		mask = BUCK_VOLTAGE_MASK;
+		*mask = BUCK_VOLTAGE_MASK;
 	} else if ((strncmp(name, "ldo", 3) == 0) &&
 		   (strncmp(name, "ldo4", 4) != 0)) {
-		mask = LDO_VOLTAGE_MASK;
+		*mask = LDO_VOLTAGE_MASK;
 	} else {
+		return false;
+	}
+
+	return true;
+}
+
+static int regulator_voltage_decode(const struct regul_struct *regul,
+				    uint8_t mask, uint8_t value)
+{
+	value = (value & mask) >> LDO_BUCK_VOLTAGE_SHIFT;
+
+	if (value > regul->voltage_table_size) {
+		return -ERANGE;
+	}
+
+	return (int)regul->voltage_table[value];
+}
+
+int stpmic1_regulator_voltage_get(const char *name)
+{
+	const struct regul_struct *regul = get_regulator_data(name);
+	uint8_t value;
+	uint8_t mask;
+	int status;
+
+	if (!regulator_voltage_is_readable(name, &mask)) {
 		return 0;
 	}
 
@@ -894,16 +917,254 @@ int stpmic1_regulator_voltage_get(const char *name)
 		return status;
 	}
 
-	value = (value & mask) >> LDO_BUCK_VOLTAGE_SHIFT;
+	return regulator_voltage_decode(regul, mask, value);
+}
 
-	if (value > regul->voltage_table_size) {
-		return -ERANGE;
+/*
+ * Control registers of the buck and LDO regulators are contiguous: read them
+ * in a single I2C transfer.
+ */
+#define VOLTAGE_CTRL_FIRST_REG		BUCK1_CONTROL_REG
+#define VOLTAGE_CTRL_LAST_REG		LDO6_CONTROL_REG
+#define VOLTAGE_CTRL_REG_COUNT		(VOLTAGE_CTRL_LAST_REG - \
+					 VOLTAGE_CTRL_FIRST_REG + 1U)
+
+int stpmic1_regulators_voltage_get(const char * const *names, int *millivolts,
+				   size_t count)
+{
+	uint8_t ctrl[VOLTAGE_CTRL_REG_COUNT];
+	size_t i;
+	int status;
+
+	status = stpmic1_register_read_multi(VOLTAGE_CTRL_FIRST_REG, ctrl,
+					     sizeof(ctrl));
+	if (status != 0) {
+		return status;
 	}
 
-	return (int)regul->voltage_table[value];
+	for (i = 0U; i < count; i++) {
+		const struct regul_struct *regul = get_regulator_data(names[i]);
+		uint8_t value;
+		uint8_t mask;
+
+		if (!regulator_voltage_is_readable(names[i], &mask) ||
+		    (regul->control_reg < VOLTAGE_CTRL_FIRST_REG) ||
+		    (regul->control_reg > VOLTAGE_CTRL_LAST_REG)) {
+			millivolts[i] = 0;
+			continue;
+		}
+
+		value = ctrl[regul->control_reg - VOLTAGE_CTRL_FIRST_REG];
+
+		if ((value & regul->enable_mask) != regul->enable_mask) {
+			millivolts[i] = 0;
+			continue;
+		}
+
+		millivolts[i] = regulator_voltage_decode(regul, mask, value);
+	}
+
+	return 0;
 }
 
-int stpmic1_register_read(uint8_t register_id,  uint8_t *value)
+#if defined(IMAGE_BL32)
+/*
+ * Control and low power control registers of the buck and LDO regulators are
+ * contiguous. While a batch is open, they are read and written in a shadow
+ * copy, only registers changed from the values known to be in the PMIC being
+ * written, in a single I2C transfer per register range, when the batch is
+ * committed.
+ */
+#define LP_CTRL_FIRST_REG		BUCK1_PWRCTRL_REG
+#define LP_CTRL_LAST_REG		LDO6_PWRCTRL_REG
+#define LP_CTRL_REG_COUNT		(LP_CTRL_LAST_REG - \
+					 LP_CTRL_FIRST_REG + 1U)
+
+static struct {
+	bool open;
+	bool cached;
+	uint8_t ctrl[VOLTAGE_CTRL_REG_COUNT];
+	uint8_t ctrl_pmic[VOLTAGE_CTRL_REG_COUNT];
+	uint8_t pmic[LP_CTRL_REG_COUNT];
+	uint8_t lp[LP_CTRL_REG_COUNT];
+} lp_batch;
+
+static bool lp_batch_read(uint8_t register_id, uint8_t *value)
+{
+	if (!lp_batch.open) {
+		return false;
+	}
+
+	if ((register_id >= LP_CTRL_FIRST_REG) &&
+	    (register_id <= LP_CTRL_LAST_REG)) {
+		*value = lp_batch.lp[register_id - LP_CTRL_FIRST_REG];
+		return true;
+	}
+
+	if ((register_id >= VOLTAGE_CTRL_FIRST_REG) &&
+	    (register_id <= VOLTAGE_CTRL_LAST_REG)) {
+		*value = lp_batch.ctrl[register_id - VOLTAGE_CTRL_FIRST_REG];
+		return true;
+	}
+
+	return false;
+}
+
+static bool lp_batch_write(uint8_t register_id, uint8_t value)
+{
+	if (!lp_batch.open) {
+		return false;
+	}
+
+	if ((register_id >= LP_CTRL_FIRST_REG) &&
+	    (register_id <= LP_CTRL_LAST_REG)) {
+		lp_batch.lp[register_id - LP_CTRL_FIRST_REG] = value;
+		return true;
+	}
+
+	if ((register_id >= VOLTAGE_CTRL_FIRST_REG) &&
+	    (register_id <= VOLTAGE_CTRL_LAST_REG)) {
+		lp_batch.ctrl[register_id - VOLTAGE_CTRL_FIRST_REG] = value;
+		return true;
+	}
+
+	return false;
+}
+
+/* Keep the shadow copy in sync with registers written to the PMIC */
+static void lp_batch_written(uint8_t register_id, uint8_t value)
+{
+	if (lp_batch.cached && (register_id >= LP_CTRL_FIRST_REG) &&
+	    (register_id <= LP_CTRL_LAST_REG)) {
+		lp_batch.pmic[register_id - LP_CTRL_FIRST_REG] = value;
+	}
+}
+
+int stpmic1_lp_batch_start(void)
+{
+	int status;
+
+	assert(!lp_batch.open);
+
+	status = stpmic1_register_read_multi(VOLTAGE_CTRL_FIRST_REG,
+					     lp_batch.ctrl,
+					     sizeof(lp_batch.ctrl));
+	if (status != 0) {
+		return status;
+	}
+
+	memcpy(lp_batch.ctrl_pmic, lp_batch.ctrl, sizeof(lp_batch.ctrl_pmic));
+
+	/* Low power registers are only written by this driver */
+	if (!lp_batch.cached) {
+		status = stpmic1_register_read_multi(LP_CTRL_FIRST_REG,
+						     lp_batch.pmic,
+						     sizeof(lp_batch.pmic));
+		if (status != 0) {
+			return status;
+		}
+
+		lp_batch.cached = true;
+	}
+
+	memcpy(lp_batch.lp, lp_batch.pmic, sizeof(lp_batch.lp));
+	lp_batch.open = true;
+
+	return 0;
+}
+
+/*
+ * Write the registers of a shadow copy that differ from the PMIC values, from
+ * the first to the last changed one, then update the PMIC values.
+ */
+static int lp_batch_write_range(uint8_t first_reg, uint8_t *shadow,
+				uint8_t *pmic, size_t size)
+{
+	size_t first = 0U;
+	size_t last = size;
+	size_t count;
+	int status;
+
+	while ((first < size) && (shadow[first] == pmic[first])) {
+		first++;
+	}
+
+	if (first == size) {
+		return 0;
+	}
+
+	while (shadow[last - 1U] == pmic[last - 1U]) {
+		last--;
+	}
+
+	count = last - first;
+
+	status = stm32_i2c_mem_write(pmic_i2c_handle, pmic_i2c_addr,
+				     (uint16_t)(first_reg + first),
+				     I2C_MEMADD_SIZE_8BIT, &shadow[first],
+				     (uint16_t)count, I2C_TIMEOUT_MS);
+	if (status != 0) {
+		return status;
+	}
+
+#if ENABLE_ASSERTIONS
+	status = stpmic1_register_read_multi(first_reg + first, &pmic[first],
+					     count);
+	if (status != 0) {
+		return status;
+	}
+
+	if (memcmp(&pmic[first], &shadow[first], count) != 0) {
+		return -EIO;
+	}
+#else
+	memcpy(&pmic[first], &shadow[first], count);
+#endif
+
+	return 0;
+}
+
+int stpmic1_lp_batch_commit(void)
+{
+	int status;
+
+	assert(lp_batch.open);
+
+	lp_batch.open = false;
+
+	status = lp_batch_write_range(VOLTAGE_CTRL_FIRST_REG, lp_batch.ctrl,
+				      lp_batch.ctrl_pmic,
+				      sizeof(lp_batch.ctrl));
+	if (status != 0) {
+		return status;
+	}
+
+	status = lp_batch_write_range(LP_CTRL_FIRST_REG, lp_batch.lp,
+				      lp_batch.pmic, sizeof(lp_batch.lp));
+	if (status != 0) {
+		lp_batch.cached = false;
+		return status;
+	}
+
+	return 0;
+}
+#else
+static bool lp_batch_read(uint8_t register_id, uint8_t *value)
+{
+	return false;
+}
+
+static bool lp_batch_write(uint8_t register_id, uint8_t value)
+{
+	return false;
+}
+
+static void lp_batch_written(uint8_t register_id, uint8_t value)
+{
+}
+#endif
+
+static int pmic_register_read(uint8_t register_id, uint8_t *value)
 {
 	return stm32_i2c_mem_read(pmic_i2c_handle, pmic_i2c_addr,
 				  (uint16_t)register_id,
@@ -911,10 +1172,32 @@ int stpmic1_register_read(uint8_t register_id,  uint8_t *value)
 				  1, I2C_TIMEOUT_MS);
 }
 
+int stpmic1_register_read(uint8_t register_id,  uint8_t *value)
+{
+	if (lp_batch_read(register_id, value)) {
+		return 0;
+	}
+
+	return pmic_register_read(register_id, value);
+}
+
+int stpmic1_register_read_multi(uint8_t register_id, uint8_t *values,
+				size_t count)
+{
+	return stm32_i2c_mem_read(pmic_i2c_handle, pmic_i2c_addr,
+				  (uint16_t)register_id,
+				  I2C_MEMADD_SIZE_8BIT, values,
+				  (uint16_t)count, I2C_TIMEOUT_MS);
+}
+
 int stpmic1_register_write(uint8_t register_id, uint8_t value)
 {
 	int status;
 
+	if (lp_batch_write(register_id, value)) {
+		return 0;
+	}
+
 	status = stm32_i2c_mem_write(pmic_i2c_handle, pmic_i2c_addr,
 				     (uint16_t)register_id,
 				     I2C_MEMADD_SIZE_8BIT, &value,
@@ -928,7 +1211,7 @@ int stpmic1_register_write(uint8_t register_id, uint8_t value)
 	if ((register_id != WATCHDOG_CONTROL_REG) && (register_id <= 0x40U)) {
 		uint8_t readval;
 
-		status = stpmic1_register_read(register_id, &readval);
+		status = pmic_register_read(register_id, &readval);
 		if (status != 0) {
 			return status;
 		}
@@ -939,6 +1222,10 @@ int stpmic1_register_write(uint8_t register_id, uint8_t value)
 	}
 #endif
 
+	if (status == 0) {
+		lp_batch_written(register_id, value);
+	}
+
 	return status;
 }
 
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2018-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2018-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <errno.h>
 #include <limits.h>
+#include <stdbool.h>
 
 #include <platform_def.h>
 
@@ -26,48 +27,109 @@ static uint8_t id2reg_bit_pos(unsigned int reset_id)
 	return (uint8_t)(reset_id & GENMASK(4, 0));
 }
 
-int stm32mp_reset_assert(uint32_t id, unsigned int to_us)
+/* True if no reset before the i-th one of the list is in the same register */
+static bool first_in_bank(const uint32_t *id, unsigned int i)
 {
-	uint32_t offset = id2reg_offset(id);
-	uint32_t bitmsk = BIT(id2reg_bit_pos(id));
-	uintptr_t rcc_base = stm32mp_rcc_base();
+	unsigned int j;
 
-	mmio_write_32(rcc_base + offset, bitmsk);
+	for (j = 0U; j < i; j++) {
+		if (id2reg_offset(id[j]) == id2reg_offset(id[i])) {
+			return false;
+		}
+	}
 
-	if (to_us != 0U) {
-		uint64_t timeout_ref = timeout_init_us(to_us);
+	return true;
+}
 
-		while ((mmio_read_32(rcc_base + offset) & bitmsk) == 0U) {
-			if (timeout_elapsed(timeout_ref)) {
-				return -ETIMEDOUT;
-			}
+/* Bits of the resets of the list in the same register as the i-th one */
+static uint32_t bank_mask(const uint32_t *id, unsigned int count,
+			  unsigned int i)
+{
+	uint32_t bitmsk = 0U;
+	unsigned int j;
+
+	for (j = i; j < count; j++) {
+		if (id2reg_offset(id[j]) == id2reg_offset(id[i])) {
+			bitmsk |= BIT(id2reg_bit_pos(id[j]));
 		}
 	}
 
-	return 0;
+	return bitmsk;
 }
 
-int stm32mp_reset_deassert(uint32_t id, unsigned int to_us)
+/*
+ * Write the set or clear register of each bank once, then poll all the banks
+ * under a single timeout.
+ */
+static int reset_multi(const uint32_t *id, unsigned int count,
+		       unsigned int to_us, bool assert_not_deassert)
 {
-	uint32_t offset = id2reg_offset(id) + RCC_RSTCLRR_OFFSET;
-	uint32_t bitmsk = BIT(id2reg_bit_pos(id));
+	uint32_t clr_offset = assert_not_deassert ? 0U : RCC_RSTCLRR_OFFSET;
 	uintptr_t rcc_base = stm32mp_rcc_base();
+	uint64_t timeout_ref;
+	unsigned int i;
+	bool done;
+
+	for (i = 0U; i < count; i++) {
+		if (first_in_bank(id, i)) {
+			mmio_write_32(rcc_base + id2reg_offset(id[i]) +
+				      clr_offset, bank_mask(id, count, i));
+		}
+	}
 
-	mmio_write_32(rcc_base + offset, bitmsk);
+	if (to_us == 0U) {
+		return 0;
+	}
+
+	timeout_ref = timeout_init_us(to_us);
 
-	if (to_us != 0U) {
-		uint64_t timeout_ref = timeout_init_us(to_us);
+	do {
+		done = true;
 
-		while ((mmio_read_32(rcc_base + offset) & bitmsk) != 0U) {
-			if (timeout_elapsed(timeout_ref)) {
-				return -ETIMEDOUT;
+		for (i = 0U; (i < count) && done; i++) {
+			uint32_t bitmsk;
+			uint32_t expected;
+
+			if (!first_in_bank(id, i)) {
+				continue;
 			}
+
+			bitmsk = bank_mask(id, count, i);
+			expected = assert_not_deassert ? bitmsk : 0U;
+			done = (mmio_read_32(rcc_base + id2reg_offset(id[i]) +
+					     clr_offset) & bitmsk) == expected;
 		}
-	}
+
+		if (!done && timeout_elapsed(timeout_ref)) {
+			return -ETIMEDOUT;
+		}
+	} while (!done);
 
 	return 0;
 }
 
+int stm32mp_reset_assert_multi(const uint32_t *id, unsigned int count,
+			       unsigned int to_us)
+{
+	return reset_multi(id, count, to_us, true);
+}
+
+int stm32mp_reset_deassert_multi(const uint32_t *id, unsigned int count,
+				 unsigned int to_us)
+{
+	return reset_multi(id, count, to_us, false);
+}
+
+int stm32mp_reset_assert(uint32_t id, unsigned int to_us)
+{
+	return reset_multi(&id, 1U, to_us, true);
+}
+
+int stm32mp_reset_deassert(uint32_t id, unsigned int to_us)
+{
+	return reset_multi(&id, 1U, to_us, false);
+}
+
 #if STM32MP15
 void stm32mp_reset_assert_deassert_to_mcu(bool assert_not_deassert)
 {
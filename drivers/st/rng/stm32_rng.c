@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2018-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -18,6 +18,12 @@
 #include <drivers/st/stm32_rng.h>
 #include <drivers/st/stm32mp_reset.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
+#include <plat/common/platform.h>
+
+#if defined(IMAGE_BL32) && STM32MP_RNG_POOL
+#include <stm32mp_sec_timer.h>
+#endif
 
 #if STM32MP13
 #define DT_RNG_COMPAT		"st,stm32mp13-rng"
@@ -45,6 +51,18 @@
 
 #define TIMEOUT_US_1MS		U(1000)
 
+#define RNG_FIFO_WORDS		4U
+
+#if STM32MP_RNG_POOL
+#ifndef RNG_POOL_WORDS
+#define RNG_POOL_WORDS		32U
+#endif
+
+/* Pool refill period and slack without RNG interrupt, in milliseconds */
+#define RNG_POOL_REFILL_MS	1U
+#define RNG_POOL_SLACK_MS	10U
+#endif
+
 struct stm32_rng_instance {
 	uintptr_t base;
 	unsigned long clock;
@@ -52,6 +70,41 @@ struct stm32_rng_instance {
 
 static struct stm32_rng_instance stm32_rng;
 
+#if STM32MP_RNG_POOL
+/*
+ * Random words read ahead, served before polling the RNG. The pool is filled
+ * at init, then refilled on RNG interrupt when there is one for the secure
+ * world, else from a secure timer task.
+ */
+static struct {
+	uint32_t word[RNG_POOL_WORDS];
+	unsigned int first;
+	unsigned int count;
+	int irq;
+	int timer_id;
+	bool timer_armed;
+} rng_pool = {
+	.irq = -1,
+	.timer_id = -1,
+};
+
+static spinlock_t rng_spinlock;
+
+static void stm32_rng_lock(void)
+{
+	if (stm32mp_lock_available()) {
+		spin_lock(&rng_spinlock);
+	}
+}
+
+static void stm32_rng_unlock(void)
+{
+	if (stm32mp_lock_available()) {
+		spin_unlock(&rng_spinlock);
+	}
+}
+#endif
+
 static void seed_error_recovery(void)
 {
 	uint8_t i __unused;
@@ -111,13 +164,7 @@ static int stm32_rng_enable(void)
 	return 0;
 }
 
-/*
- * stm32_rng_read - Read a number of random bytes from RNG
- * out: pointer to the output buffer
- * size: number of bytes to be read
- * Return 0 on success, non-0 on failure
- */
-int stm32_rng_read(uint8_t *out, uint32_t size)
+static int stm32_rng_read_hw(uint8_t *out, uint32_t size)
 {
 	uint8_t *buf = out;
 	size_t len = size;
@@ -126,10 +173,6 @@ int stm32_rng_read(uint8_t *out, uint32_t size)
 	int rc = 0;
 	int count;
 
-	if (stm32_rng.base == 0U) {
-		return -EPERM;
-	}
-
 	while (len != 0U) {
 		nb_tries = RNG_TIMEOUT_US / RNG_TIMEOUT_STEP_US;
 		do {
@@ -148,7 +191,7 @@ int stm32_rng_read(uint8_t *out, uint32_t size)
 		} while ((mmio_read_32(stm32_rng.base + RNG_SR) &
 			  RNG_SR_DRDY) == 0U);
 
-		count = 4;
+		count = RNG_FIFO_WORDS;
 		while (len != 0U) {
 			data32 = mmio_read_32(stm32_rng.base + RNG_DR);
 			count--;
@@ -171,6 +214,203 @@ bail:
 	return rc;
 }
 
+#if STM32MP_RNG_POOL
+static size_t rng_pool_get(uint8_t *out, size_t len)
+{
+	size_t done = 0U;
+
+	while ((done < len) && (rng_pool.count != 0U)) {
+		size_t n = MIN(len - done, sizeof(uint32_t));
+
+		memcpy(out + done, &rng_pool.word[rng_pool.first], n);
+		rng_pool.word[rng_pool.first] = 0U;
+		rng_pool.first = (rng_pool.first + 1U) % RNG_POOL_WORDS;
+		rng_pool.count--;
+		done += n;
+	}
+
+	return done;
+}
+
+/* Move the words ready in the RNG FIFO to the pool, without waiting */
+static void rng_pool_fill_ready(void)
+{
+	uint32_t sr = mmio_read_32(stm32_rng.base + RNG_SR);
+	unsigned int i;
+
+	if ((sr & (RNG_SR_SECS | RNG_SR_SEIS)) != 0U) {
+		seed_error_recovery();
+		return;
+	}
+
+	if ((sr & RNG_SR_DRDY) == 0U) {
+		return;
+	}
+
+	for (i = 0U; (i < RNG_FIFO_WORDS) && (rng_pool.count < RNG_POOL_WORDS);
+	     i++) {
+		unsigned int idx = (rng_pool.first + rng_pool.count) %
+				   RNG_POOL_WORDS;
+
+		rng_pool.word[idx] = mmio_read_32(stm32_rng.base + RNG_DR);
+		rng_pool.count++;
+	}
+}
+
+/* Let the RNG interrupt or the timer task refill the pool, until it is full */
+static void rng_pool_refill(void)
+{
+#if defined(IMAGE_BL32)
+	if ((rng_pool.timer_id >= 0) && !rng_pool.timer_armed &&
+	    (rng_pool.count < RNG_POOL_WORDS)) {
+		rng_pool.timer_armed = true;
+		stm32mp_sec_timer_arm((unsigned int)rng_pool.timer_id,
+				      ((uint64_t)plat_get_syscnt_freq2() *
+				       RNG_POOL_REFILL_MS) / 1000U);
+	}
+#endif
+
+	if (rng_pool.irq < 0) {
+		return;
+	}
+
+	if (rng_pool.count < RNG_POOL_WORDS) {
+		mmio_setbits_32(stm32_rng.base + RNG_CR, RNG_CR_IE);
+	} else {
+		mmio_clrbits_32(stm32_rng.base + RNG_CR, RNG_CR_IE);
+	}
+}
+
+#if defined(IMAGE_BL32)
+static void rng_pool_timer_task(void)
+{
+	stm32_rng_lock();
+	rng_pool.timer_armed = false;
+	rng_pool_fill_ready();
+	rng_pool_refill();
+	stm32_rng_unlock();
+}
+#endif
+
+static int rng_pool_init(void *fdt, int node)
+{
+	int ret;
+
+	ret = stm32_rng_read_hw((uint8_t *)rng_pool.word,
+				sizeof(rng_pool.word));
+	if (ret != 0) {
+		return ret;
+	}
+
+	rng_pool.first = 0U;
+	rng_pool.count = RNG_POOL_WORDS;
+
+#if defined(IMAGE_BL32)
+	if (fdt_getprop(fdt, node, "interrupts", NULL) != NULL) {
+		rng_pool.irq = stm32mp_gic_enable_spi(node, NULL);
+	} else {
+		uint64_t slack = ((uint64_t)plat_get_syscnt_freq2() *
+				  RNG_POOL_SLACK_MS) / 1000U;
+
+		rng_pool.timer_id =
+			stm32mp_sec_timer_register(rng_pool_timer_task, slack);
+	}
+#endif
+
+	return 0;
+}
+
+/*
+ * stm32_rng_it_handler - Refill the pool on RNG interrupt
+ * id: interrupt ID
+ * Return true if the interrupt is the RNG one
+ */
+bool stm32_rng_it_handler(uint32_t id)
+{
+	if ((rng_pool.irq < 0) || (id != (uint32_t)rng_pool.irq)) {
+		return false;
+	}
+
+	stm32_rng_lock();
+	rng_pool_fill_ready();
+	rng_pool_refill();
+	stm32_rng_unlock();
+
+	return true;
+}
+
+/*
+ * stm32_rng_read_pool - Read random bytes without waiting for the RNG
+ * out: pointer to the output buffer
+ * size: number of bytes to be read
+ * Return 0 on success, -EAGAIN if the pool is being refilled, another
+ * non-0 value on failure. Without RNG interrupt nor timer task, the RNG is
+ * polled when the pool is empty, as with stm32_rng_read().
+ */
+int stm32_rng_read_pool(uint8_t *out, uint32_t size)
+{
+	if (stm32_rng.base == 0U) {
+		return -EPERM;
+	}
+
+	if ((rng_pool.irq < 0) && (rng_pool.timer_id < 0)) {
+		return stm32_rng_read(out, size);
+	}
+
+	stm32_rng_lock();
+
+	if ((rng_pool.count * sizeof(uint32_t)) < size) {
+		stm32_rng_unlock();
+		return -EAGAIN;
+	}
+
+	(void)rng_pool_get(out, size);
+	rng_pool_refill();
+
+	stm32_rng_unlock();
+
+	return 0;
+}
+#endif /* STM32MP_RNG_POOL */
+
+/*
+ * stm32_rng_read - Read a number of random bytes from RNG
+ * out: pointer to the output buffer
+ * size: number of bytes to be read
+ * Return 0 on success, non-0 on failure
+ */
+int stm32_rng_read(uint8_t *out, uint32_t size)
+{
+#if STM32MP_RNG_POOL
+	size_t done;
+	int rc = 0;
+#endif
+
+	if (stm32_rng.base == 0U) {
+		return -EPERM;
+	}
+
+#if STM32MP_RNG_POOL
+	stm32_rng_lock();
+
+	done = rng_pool_get(out, size);
+	if (done < size) {
+		rc = stm32_rng_read_hw(out + done, size - done);
+		if (rc != 0) {
+			memset(out, 0, done);
+		}
+	}
+
+	rng_pool_refill();
+
+	stm32_rng_unlock();
+
+	return rc;
+#else
+	return stm32_rng_read_hw(out, size);
+#endif
+}
+
 /*
  * stm32_rng_init: Initialize rng from DT
  * return 0 on success, negative value on failure
@@ -180,6 +420,7 @@ int stm32_rng_init(void)
 	void *fdt;
 	struct dt_node_info dt_rng;
 	int node;
+	int ret;
 
 	if (stm32_rng.base != 0U) {
 		/* Driver is already initialized */
@@ -225,8 +466,6 @@ int stm32_rng_init(void)
 	clk_enable(stm32_rng.clock);
 
 	if (dt_rng.reset >= 0) {
-		int ret;
-
 		ret = stm32mp_reset_assert((unsigned long)dt_rng.reset,
 					   TIMEOUT_US_1MS);
 		if (ret != 0) {
@@ -242,5 +481,14 @@ int stm32_rng_init(void)
 		}
 	}
 
+#if STM32MP_RNG_POOL
+	ret = stm32_rng_enable();
+	if (ret != 0) {
+		return ret;
+	}
+
+	return rng_pool_init(fdt, node);
+#else
 	return stm32_rng_enable();
+#endif
 }
@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2018-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2018-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <platform_def.h>
 
@@ -49,8 +50,11 @@
 
 #define RTC_ICSR_ALRAWF		BIT(0)
 #define RTC_ICSR_RSF		BIT(5)
+#define RTC_ICSR_BIN_MASK	GENMASK(9, 8)
 
 #define RTC_PRER_PREDIV_S_MASK	GENMASK(14, 0)
+#define RTC_PRER_PREDIV_A_MASK	GENMASK(22, 16)
+#define RTC_PRER_PREDIV_A_SHIFT	16
 
 #define RTC_CR_BYPSHAD		BIT(5)
 #define RTC_CR_BYPSHAD_SHIFT	5
@@ -67,7 +71,16 @@
 #define RTC_TSDR_MU_MASK	GENMASK(11, 8)
 #define RTC_TSDR_MU_SHIFT	8
 
+#define RTC_ALRMAR_MSK1		BIT(7)
+#define RTC_ALRMAR_MSK2		BIT(15)
+#define RTC_ALRMAR_MSK3		BIT(23)
+#define RTC_ALRMAR_DATE_MASK	GENMASK(29, 24)
 #define RTC_ALRMAR_DU_SHIFT	24
+#define RTC_ALRMAR_WDSEL	BIT(30)
+#define RTC_ALRMAR_MSK4		BIT(31)
+#define RTC_ALRMAR_MSK_ALL	(RTC_ALRMAR_MSK1 | RTC_ALRMAR_MSK2 | \
+				 RTC_ALRMAR_MSK3 | RTC_ALRMAR_MSK4)
+#define RTC_ALRMAR_TIME_MASK	(GENMASK(22, 0) & ~RTC_ALRMAR_MSK_ALL)
 
 #define RTC_SR_TSF		BIT(3)
 #define RTC_SR_TSOVF		BIT(4)
@@ -231,169 +244,202 @@ void stm32_rtc_get_calendar(struct stm32_rtc_calendar *calendar)
 }
 
 /*******************************************************************************
- * This function computes the second fraction in milliseconds.
- * The returned value is a uint32_t between 0 and 1000.
+ * This function gets the RTC calendar register values straight from the
+ * counters, bypassing the shadow registers, so that it does not wait for their
+ * synchronisation after a low power mode exit. The time and date are read
+ * again until they match, the sub-second value then belongs to the same second.
+ * RTC_CR is modified: this service is only used while the non-secure world is
+ * not running, when entering or exiting a low power mode.
  ******************************************************************************/
-static uint32_t stm32_rtc_get_second_fraction(struct stm32_rtc_calendar *cal)
+void stm32_rtc_get_calendar_nowait(struct stm32_rtc_calendar *calendar)
 {
-	uint32_t prediv_s = mmio_read_32(rtc_dev.base + RTC_PRER) &
-			    RTC_PRER_PREDIV_S_MASK;
-	uint32_t ss = cal->ssr & RTC_SSR_SS_MASK;
+	uint32_t tr;
+	uint32_t dr;
+	bool bypshad;
 
-	return ((prediv_s - ss) * 1000U) / (prediv_s + 1U);
+	stm32_rtc_regs_lock();
+	clk_enable(rtc_dev.clock);
+
+	bypshad = stm32_rtc_get_bypshad();
+	if (!bypshad) {
+		stm32_rtc_write_unprotect();
+		mmio_setbits_32(rtc_dev.base + RTC_CR, RTC_CR_BYPSHAD);
+	}
+
+	do {
+		tr = mmio_read_32(rtc_dev.base + RTC_TR);
+		dr = mmio_read_32(rtc_dev.base + RTC_DR);
+		calendar->ssr = mmio_read_32(rtc_dev.base + RTC_SSR);
+		calendar->tr = mmio_read_32(rtc_dev.base + RTC_TR);
+		calendar->dr = mmio_read_32(rtc_dev.base + RTC_DR);
+	} while ((calendar->tr != tr) || (calendar->dr != dr));
+
+	if (!bypshad) {
+		mmio_clrbits_32(rtc_dev.base + RTC_CR, RTC_CR_BYPSHAD);
+		stm32_rtc_write_protect();
+	}
+
+	clk_disable(rtc_dev.clock);
+	stm32_rtc_regs_unlock();
 }
 
 /*******************************************************************************
- * This function computes the fraction difference between two timestamps.
- * Here again the returned value is in milliseconds.
+ * This function returns true if the sub-second register is a binary counter
+ * (binary or mixed mode, available on STM32MP13). The field reads as 0 on
+ * STM32MP15.
  ******************************************************************************/
-static signed long long stm32_rtc_diff_frac(struct stm32_rtc_calendar *cur,
-					    struct stm32_rtc_calendar *ref)
+static bool stm32_rtc_is_binary(void)
 {
-	return (signed long long)stm32_rtc_get_second_fraction(cur) -
-	       (signed long long)stm32_rtc_get_second_fraction(ref);
+	return (mmio_read_32(rtc_dev.base + RTC_ICSR) & RTC_ICSR_BIN_MASK) != 0U;
 }
 
 /*******************************************************************************
- * This function computes the time difference between two timestamps.
- * It includes seconds, minutes and hours.
- * Here again the returned value is in milliseconds.
+ * This function computes the time in milliseconds elapsed between two values
+ * of the binary sub-second down-counter, clocked by ck_apre.
  ******************************************************************************/
-static signed long long stm32_rtc_diff_time(struct stm32_rtc_time *current,
-					    struct stm32_rtc_time *ref)
+static unsigned long long stm32_rtc_diff_binary(struct stm32_rtc_calendar *cur,
+						struct stm32_rtc_calendar *ref)
 {
-	signed long long curr_s;
-	signed long long ref_s;
+	uint32_t prediv_a = (mmio_read_32(rtc_dev.base + RTC_PRER) &
+			     RTC_PRER_PREDIV_A_MASK) >> RTC_PRER_PREDIV_A_SHIFT;
+	unsigned long long ck_apre = clk_get_rate(RTC) / (prediv_a + 1U);
+	uint32_t ticks = ref->ssr - cur->ssr;
 
-	curr_s = (signed long long)current->sec +
-		 (((signed long long)current->min +
-		  (((signed long long)current->hour * 60))) * 60);
-
-	ref_s = (signed long long)ref->sec +
-		(((signed long long)ref->min +
-		 (((signed long long)ref->hour * 60))) * 60);
+	if (ck_apre == 0ULL) {
+		return 0ULL;
+	}
 
-	return (curr_s - ref_s) * 1000;
+	return ((unsigned long long)ticks * 1000ULL) / ck_apre;
 }
 
 /*******************************************************************************
- * This function determines if the year is leap or not.
- * Returned value is true or false.
+ * This function computes the second fraction in milliseconds.
+ * The returned value is a uint32_t between 0 and 1000.
  ******************************************************************************/
-static bool stm32_is_a_leap_year(uint32_t year)
+static uint32_t stm32_rtc_get_second_fraction(struct stm32_rtc_calendar *cal)
 {
-	return ((year % 4U) == 0U) &&
-	       (((year % 100U) != 0U) || ((year % 400U) == 0U));
+	uint32_t prediv_s = mmio_read_32(rtc_dev.base + RTC_PRER) &
+			    RTC_PRER_PREDIV_S_MASK;
+	uint32_t ss = cal->ssr & RTC_SSR_SS_MASK;
+
+	return ((prediv_s - ss) * 1000U) / (prediv_s + 1U);
 }
 
 /*******************************************************************************
- * This function computes the date difference between two timestamps.
- * It includes days, months, years, with exceptions.
- * Here again the returned value is in milliseconds.
+ * This function converts a calendar into milliseconds from a fixed origin.
+ * The day count is computed in constant time, March being taken as the first
+ * month of the year so that the leap day is the last day of the year.
  ******************************************************************************/
-static signed long long stm32_rtc_diff_date(struct stm32_rtc_time *current,
-					    struct stm32_rtc_time *ref)
+static signed long long stm32_rtc_calendar_to_ms(struct stm32_rtc_calendar *cal)
 {
-	uint32_t diff_in_days = 0;
-	uint32_t m;
-	static const uint8_t month_len[NB_MONTHS] = {
-		31, 28, 31, 30, 31, 30,
-		31, 31, 30, 31, 30, 31
-	};
-
-	/* Get the number of non-entire month days */
-	if (current->day >= ref->day) {
-		diff_in_days += current->day - ref->day;
+	struct stm32_rtc_time tm;
+	signed long long days;
+	uint32_t year;
+	uint32_t month;
+
+	stm32_rtc_get_date(cal, &tm);
+	stm32_rtc_get_time(cal, &tm);
+
+	year = tm.year;
+	month = (uint32_t)tm.month;
+	if (month <= (uint32_t)FEBRUARY) {
+		year--;
+		month += 9U;
 	} else {
-		diff_in_days += (uint32_t)month_len[ref->month - 1U] -
-				ref->day + current->day;
+		month -= 3U;
 	}
 
-	/* Get the number of entire months, and compute the related days */
-	if (current->month > (ref->month + 1U)) {
-		for (m = (ref->month + 1U); (m < current->month) &&
-		     (m < 12U); m++) {
-			diff_in_days += (uint32_t)month_len[m - 1U];
-		}
-	}
+	days = (signed long long)((year * 365U) + (year / 4U) -
+				  (year / 100U) + (year / 400U) +
+				  (((153U * month) + 2U) / 5U) + tm.day - 1U);
 
-	if (current->month < (ref->month - 1U)) {
-		for (m = 1U; (m < current->month) && (m < 12U); m++) {
-			diff_in_days += (uint32_t)month_len[m - 1U];
-		}
+	return ((((((days * 24) + (signed long long)tm.hour) * 60) +
+		  (signed long long)tm.min) * 60) +
+		(signed long long)tm.sec) * 1000 +
+	       (signed long long)stm32_rtc_get_second_fraction(cal);
+}
 
-		for (m = (ref->month + 1U); m < 12U; m++) {
-			diff_in_days += (uint32_t)month_len[m - 1U];
-		}
-	}
+/*******************************************************************************
+ * This function computes the date difference between two rtc value.
+ * Here again the returned value is in milliseconds.
+ ******************************************************************************/
+unsigned long long stm32_rtc_diff_calendar(struct stm32_rtc_calendar *cur,
+					   struct stm32_rtc_calendar *ref)
+{
+	signed long long diff_in_ms;
 
-	/* Get complete years */
-	if (current->year > (ref->year + 1U)) {
-		diff_in_days += (current->year - ref->year - 1U) * 365U;
-	}
+	clk_enable(rtc_dev.clock);
 
-	/* Particular cases: leap years (one day more) */
-	if (diff_in_days > 0U) {
-		if (current->year == ref->year) {
-			if (stm32_is_a_leap_year(current->year)) {
-				if ((ref->month <= 2U) &&
-				    (current->month >= 3U) &&
-				    (current->day <= 28U)) {
-					diff_in_days++;
-				}
-			}
-		} else {
-			uint32_t y;
-
-			/* Ref year is leap */
-			if ((stm32_is_a_leap_year(ref->year)) &&
-			    (ref->month <= 2U) && (ref->day <= 28U)) {
-				diff_in_days++;
-			}
-
-			/* Current year is leap */
-			if ((stm32_is_a_leap_year(current->year)) &&
-			    (current->month >= 3U)) {
-				diff_in_days++;
-			}
-
-			/* Interleaved years are leap */
-			for (y = ref->year + 1U; y < current->year; y++) {
-				if (stm32_is_a_leap_year(y)) {
-					diff_in_days++;
-				}
-			}
-		}
+	if (stm32_rtc_is_binary()) {
+		diff_in_ms = (signed long long)stm32_rtc_diff_binary(cur, ref);
+	} else {
+		diff_in_ms = stm32_rtc_calendar_to_ms(cur) -
+			     stm32_rtc_calendar_to_ms(ref);
 	}
 
-	return (24 * 60 * 60 * 1000) * (signed long long)diff_in_days;
+	clk_disable(rtc_dev.clock);
+
+	return (unsigned long long)diff_in_ms;
 }
 
 /*******************************************************************************
- * This function computes the date difference between two rtc value.
- * Here again the returned value is in milliseconds.
+ * This function gets the delay in milliseconds to the RTC alarm A, when it is
+ * enabled with its interrupt on a date and time of the current month. Alarms
+ * repeating on masked fields or set on a week day, or in binary mode, are not
+ * handled.
+ * Returns 0 on success, -ENOENT if no such alarm is pending.
  ******************************************************************************/
-unsigned long long stm32_rtc_diff_calendar(struct stm32_rtc_calendar *cur,
-					   struct stm32_rtc_calendar *ref)
+int stm32_rtc_get_alarm_delay(unsigned long long *delay_ms)
 {
-	signed long long diff_in_ms = 0;
-	struct stm32_rtc_time curr_t;
-	struct stm32_rtc_time ref_t;
+	struct stm32_rtc_calendar now;
+	struct stm32_rtc_calendar alarm;
+	uint32_t cr;
+	uint32_t alrmar;
+	signed long long diff_in_ms;
+	bool binary;
+
+	stm32_rtc_get_calendar(&now);
 
 	clk_enable(rtc_dev.clock);
 
-	stm32_rtc_get_date(cur, &curr_t);
-	stm32_rtc_get_date(ref, &ref_t);
-	stm32_rtc_get_time(cur, &curr_t);
-	stm32_rtc_get_time(ref, &ref_t);
+	cr = mmio_read_32(rtc_dev.base + RTC_CR);
+	alrmar = mmio_read_32(rtc_dev.base + RTC_ALRMAR);
+
+	/* A sub-second counter equal to PREDIV_S is the start of a second */
+	alarm.ssr = mmio_read_32(rtc_dev.base + RTC_PRER) &
+		    RTC_PRER_PREDIV_S_MASK;
 
-	diff_in_ms += stm32_rtc_diff_frac(cur, ref);
-	diff_in_ms += stm32_rtc_diff_time(&curr_t, &ref_t);
-	diff_in_ms += stm32_rtc_diff_date(&curr_t, &ref_t);
+	binary = stm32_rtc_is_binary();
 
 	clk_disable(rtc_dev.clock);
 
-	return (unsigned long long)diff_in_ms;
+	if (binary) {
+		return -ENOENT;
+	}
+
+	if ((cr & (RTC_CR_ALRAE | RTC_CR_ALRAIE)) !=
+	    (RTC_CR_ALRAE | RTC_CR_ALRAIE)) {
+		return -ENOENT;
+	}
+
+	if ((alrmar & (RTC_ALRMAR_MSK_ALL | RTC_ALRMAR_WDSEL)) != 0U) {
+		return -ENOENT;
+	}
+
+	/* Time fields of RTC_ALRMAR are laid out as in RTC_TR */
+	alarm.tr = alrmar & RTC_ALRMAR_TIME_MASK;
+	alarm.dr = (now.dr & ~(RTC_DR_DT_MASK | RTC_DR_DU_MASK)) |
+		   ((alrmar & RTC_ALRMAR_DATE_MASK) >> RTC_ALRMAR_DU_SHIFT);
+
+	diff_in_ms = (signed long long)stm32_rtc_diff_calendar(&alarm, &now);
+	if (diff_in_ms < 0) {
+		/* Alarm date is in a next month */
+		return -ENOENT;
+	}
+
+	*delay_ms = (unsigned long long)diff_in_ms;
+
+	return 0;
 }
 
 /*******************************************************************************
@@ -207,11 +207,39 @@ static int stm32_qspi_poll(const struct spi_mem_op *op)
 	return 0;
 }
 
+/*
+ * The memory mapped window is device memory: copy it with word accesses
+ * whenever source and destination alignments allow it, rather than with
+ * the byte accesses of the generic memcpy().
+ */
 static int stm32_qspi_mm(const struct spi_mem_op *op)
 {
-	memcpy(op->data.buf,
-	       (void *)(stm32_qspi.mm_base + (size_t)op->addr.val),
-	       op->data.nbytes);
+	uintptr_t src = stm32_qspi.mm_base + (size_t)op->addr.val;
+	uint8_t *buf = (uint8_t *)op->data.buf;
+	uint32_t len = op->data.nbytes;
+
+	if (((src ^ (uintptr_t)buf) & GENMASK_32(1, 0)) == 0U) {
+		while (((src & GENMASK_32(1, 0)) != 0U) && (len != 0U)) {
+			*buf = mmio_read_8(src);
+			buf++;
+			src++;
+			len--;
+		}
+
+		while (len >= sizeof(uint32_t)) {
+			*(uint32_t *)buf = mmio_read_32(src);
+			buf += sizeof(uint32_t);
+			src += sizeof(uint32_t);
+			len -= sizeof(uint32_t);
+		}
+	}
+
+	while (len != 0U) {
+		*buf = mmio_read_8(src);
+		buf++;
+		src++;
+		len--;
+	}
 
 	return 0;
 }
@@ -238,33 +266,16 @@ static unsigned int stm32_qspi_get_mode(uint8_t buswidth)
 	return buswidth;
 }
 
-static int stm32_qspi_exec_op(const struct spi_mem_op *op)
+static bool stm32_qspi_mm_allowed(const struct spi_mem_op *op)
 {
-	uint64_t timeout;
-	uint32_t ccr;
-	size_t addr_max;
-	uint8_t mode = QSPI_CCR_IND_WRITE;
-	int ret;
-
-	VERBOSE("%s: cmd:%x mode:%d.%d.%d.%d addr:%" PRIx64 " len:%x\n",
-		__func__, op->cmd.opcode, op->cmd.buswidth, op->addr.buswidth,
-		op->dummy.buswidth, op->data.buswidth,
-		op->addr.val, op->data.nbytes);
+	size_t addr_max = op->addr.val + op->data.nbytes + 1U;
 
-	addr_max = op->addr.val + op->data.nbytes + 1U;
-
-	if ((op->data.dir == SPI_MEM_DATA_IN) && (op->data.nbytes != 0U)) {
-		if ((addr_max < stm32_qspi.mm_size) &&
-		    (op->addr.buswidth != 0U)) {
-			mode = QSPI_CCR_MEM_MAP;
-		} else {
-			mode = QSPI_CCR_IND_READ;
-		}
-	}
+	return (addr_max < stm32_qspi.mm_size) && (op->addr.buswidth != 0U);
+}
 
-	if (op->data.nbytes != 0U) {
-		mmio_write_32(qspi_base() + QSPI_DLR, op->data.nbytes - 1U);
-	}
+static uint32_t stm32_qspi_ccr(const struct spi_mem_op *op, uint8_t mode)
+{
+	uint32_t ccr;
 
 	ccr = mode << QSPI_CCR_FMODE_SHIFT;
 	ccr |= op->cmd.opcode;
@@ -286,7 +297,53 @@ static int stm32_qspi_exec_op(const struct spi_mem_op *op)
 			QSPI_CCR_DMODE_SHIFT;
 	}
 
-	mmio_write_32(qspi_base() + QSPI_CCR, ccr);
+	return ccr;
+}
+
+static int stm32_qspi_abort(void)
+{
+	uint64_t timeout;
+	int ret = 0;
+
+	mmio_setbits_32(qspi_base() + QSPI_CR, QSPI_CR_ABORT);
+
+	/* Wait clear of abort bit by hardware */
+	timeout = timeout_init_us(QSPI_ABT_TIMEOUT_US);
+	while ((mmio_read_32(qspi_base() + QSPI_CR) & QSPI_CR_ABORT) != 0U) {
+		if (timeout_elapsed(timeout)) {
+			ret = -ETIMEDOUT;
+			break;
+		}
+	}
+
+	mmio_write_32(qspi_base() + QSPI_FCR, QSPI_FCR_CTCF);
+
+	return ret;
+}
+
+static int stm32_qspi_exec_op(const struct spi_mem_op *op)
+{
+	uint8_t mode = QSPI_CCR_IND_WRITE;
+	int ret;
+
+	VERBOSE("%s: cmd:%x mode:%d.%d.%d.%d addr:%" PRIx64 " len:%x\n",
+		__func__, op->cmd.opcode, op->cmd.buswidth, op->addr.buswidth,
+		op->dummy.buswidth, op->data.buswidth,
+		op->addr.val, op->data.nbytes);
+
+	if ((op->data.dir == SPI_MEM_DATA_IN) && (op->data.nbytes != 0U)) {
+		if (stm32_qspi_mm_allowed(op)) {
+			mode = QSPI_CCR_MEM_MAP;
+		} else {
+			mode = QSPI_CCR_IND_READ;
+		}
+	}
+
+	if (op->data.nbytes != 0U) {
+		mmio_write_32(qspi_base() + QSPI_DLR, op->data.nbytes - 1U);
+	}
+
+	mmio_write_32(qspi_base() + QSPI_CCR, stm32_qspi_ccr(op, mode));
 
 	if ((op->addr.nbytes != 0U) && (mode != QSPI_CCR_MEM_MAP)) {
 		mmio_write_32(qspi_base() + QSPI_AR, op->addr.val);
@@ -314,19 +371,10 @@ static int stm32_qspi_exec_op(const struct spi_mem_op *op)
 	return 0;
 
 abort:
-	mmio_setbits_32(qspi_base() + QSPI_CR, QSPI_CR_ABORT);
-
-	/* Wait clear of abort bit by hardware */
-	timeout = timeout_init_us(QSPI_ABT_TIMEOUT_US);
-	while ((mmio_read_32(qspi_base() + QSPI_CR) & QSPI_CR_ABORT) != 0U) {
-		if (timeout_elapsed(timeout)) {
-			ret = -ETIMEDOUT;
-			break;
-		}
+	if (stm32_qspi_abort() != 0) {
+		ret = -ETIMEDOUT;
 	}
 
-	mmio_write_32(qspi_base() + QSPI_FCR, QSPI_FCR_CTCF);
-
 	if (ret != 0) {
 		ERROR("%s: exec op error\n", __func__);
 	}
@@ -334,6 +382,39 @@ abort:
 	return ret;
 }
 
+/*
+ * Leave the memory mapped mode set for the read operation: the range is then
+ * read by a DMA, from the memory mapped window, until stm32_qspi_mm_unmap().
+ */
+static int stm32_qspi_mm_map(const struct spi_mem_op *op, uintptr_t *addr)
+{
+	int ret;
+
+	if ((op->data.dir != SPI_MEM_DATA_IN) || !stm32_qspi_mm_allowed(op)) {
+		return -ENOTSUP;
+	}
+
+	ret = stm32_qspi_wait_for_not_busy();
+	if (ret != 0) {
+		return ret;
+	}
+
+	mmio_write_32(qspi_base() + QSPI_CCR,
+		      stm32_qspi_ccr(op, QSPI_CCR_MEM_MAP));
+
+	*addr = stm32_qspi.mm_base + (size_t)op->addr.val;
+
+	return 0;
+}
+
+/* Stop the prefetch of the memory mapped mode */
+static void stm32_qspi_mm_unmap(void)
+{
+	if (stm32_qspi_abort() != 0) {
+		ERROR("%s: abort error\n", __func__);
+	}
+}
+
 static int stm32_qspi_claim_bus(unsigned int cs)
 {
 	uint32_t cr;
@@ -415,6 +496,13 @@ static int stm32_qspi_set_mode(unsigned int mode)
 		return -ENODEV;
 	}
 
+	/* Both banks are read in parallel, FSEL is then ignored */
+	if ((mode & SPI_DUAL_FLASH) != 0U) {
+		mmio_setbits_32(qspi_base() + QSPI_CR, QSPI_CR_DFM);
+	} else {
+		mmio_clrbits_32(qspi_base() + QSPI_CR, QSPI_CR_DFM);
+	}
+
 	VERBOSE("%s: mode=0x%x\n", __func__, mode);
 
 	if ((mode & SPI_RX_QUAD) != 0U) {
@@ -441,6 +529,8 @@ static const struct spi_bus_ops stm32_qspi_bus_ops = {
 	.release_bus = stm32_qspi_release_bus,
 	.set_speed = stm32_qspi_set_speed,
 	.set_mode = stm32_qspi_set_mode,
+	.mm_map = stm32_qspi_mm_map,
+	.mm_unmap = stm32_qspi_mm_unmap,
 	.exec_op = stm32_qspi_exec_op,
 };
 
@@ -20,6 +20,8 @@
 #include <drivers/st/stm32_tamp.h>
 #include <lib/mmio.h>
 
+#include <stm32mp_deferred_work.h>
+
 #define DT_TAMP_COMPAT			"st,stm32-tamp"
 /* STM32 Registers */
 #define _TAMP_CR1			0x00U
@@ -553,12 +555,9 @@ int stm32_tamp_configure_external(enum stm32_tamp_ext_id id, uint32_t mode,
 	return 0;
 }
 
-void stm32_tamp_it_handler(void)
+/* Deferred out of the tamper interrupt handler */
+static void stm32_tamp_log_timestamp(uintptr_t arg __unused)
 {
-	uint32_t it = mmio_read_32(stm32_tamp.base + _TAMP_SR);
-	uint32_t int_it = it & _TAMP_SR_ITAMPXF_MASK;
-	uint32_t ext_it = it & _TAMP_SR_ETAMPXF_MASK;
-	uint8_t tamp = 0;
 	struct stm32_rtc_time tamp_ts;
 
 	if (stm32_rtc_is_timestamp_enable()) {
@@ -568,6 +567,24 @@ void stm32_tamp_it_handler(void)
 		     tamp_ts.day, tamp_ts.month, tamp_ts.hour,
 		     tamp_ts.min, tamp_ts.sec);
 	}
+}
+
+/* Reset at once, after the deferred work that would be lost */
+static void __dead2 stm32_tamp_reset(void)
+{
+	stm32mp_deferred_work_flush();
+	stm32mp_system_reset();
+}
+
+void stm32_tamp_it_handler(void)
+{
+	uint32_t it = mmio_read_32(stm32_tamp.base + _TAMP_SR);
+	uint32_t int_it = it & _TAMP_SR_ITAMPXF_MASK;
+	uint32_t ext_it = it & _TAMP_SR_ETAMPXF_MASK;
+	uint8_t tamp = 0;
+
+	/* The RTC keeps the timestamp until it is read */
+	stm32mp_defer_work(stm32_tamp_log_timestamp, 0U);
 
 	while ((int_it != 0U) && (tamp < PLAT_MAX_TAMP_INT)) {
 		int ret = -1;
@@ -584,7 +601,7 @@ void stm32_tamp_it_handler(void)
 				ext_it &= ~_TAMP_SR_ITAMP(int_id);
 
 				if (ret > 0) {
-					stm32mp_system_reset();
+					stm32_tamp_reset();
 				}
 			}
 		}
@@ -608,7 +625,7 @@ void stm32_tamp_it_handler(void)
 				ext_it &= ~_TAMP_SR_ETAMP(ext_id);
 
 				if (ret > 0) {
-					stm32mp_system_reset();
+					stm32_tamp_reset();
 				}
 			}
 		}
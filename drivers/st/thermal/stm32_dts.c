@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <libfdt.h>
+
+#include <platform_def.h>
+
+#include <common/debug.h>
+#include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <drivers/st/stm32_dts.h>
+#include <lib/mmio.h>
+#include <lib/utils_def.h>
+
+#define DT_DTS_COMPAT			"st,stm32-thermal"
+
+#define DTS_CFGR1			0x00U
+#define DTS_T0VALR1			0x08U
+#define DTS_RAMPVALR			0x10U
+#define DTS_DR				0x1CU
+#define DTS_SR				0x20U
+
+#define DTS_CFGR1_TS1_EN		BIT(0)
+#define DTS_CFGR1_TS1_START		BIT(4)
+#define DTS_CFGR1_TS1_INTRIG_SEL_MASK	GENMASK(11, 8)
+#define DTS_CFGR1_TS1_SMP_TIME_MASK	GENMASK(19, 16)
+#define DTS_CFGR1_TS1_SMP_TIME_SHIFT	16
+#define DTS_CFGR1_REFCLK_SEL		BIT(20)
+#define DTS_CFGR1_Q_MEAS_OPT		BIT(21)
+#define DTS_CFGR1_HSREF_CLK_DIV_MASK	GENMASK(30, 24)
+#define DTS_CFGR1_HSREF_CLK_DIV_SHIFT	24
+
+#define DTS_T0VALR1_TS1_FMT0_MASK	GENMASK(15, 0)
+#define DTS_T0VALR1_TS1_T0_MASK		GENMASK(17, 16)
+#define DTS_T0VALR1_TS1_T0_SHIFT	16
+
+#define DTS_RAMPVALR_TS1_RAMP_MASK	GENMASK(15, 0)
+
+#define DTS_DR_TS1_MFREQ_MASK		GENMASK(15, 0)
+
+#define DTS_SR_TS_RDY			BIT(15)
+
+/* Calibration temperatures selected by TS1_T0 */
+#define DTS_T0_30C			30
+#define DTS_T0_130C			130
+
+/* TS1_FMT0 is expressed in 100Hz units */
+#define DTS_FMT0_UNIT_HZ		100U
+
+#define DTS_READY_TIMEOUT_US		1000U
+
+#define ONE_MHZ				1000000UL
+
+static struct {
+	uintptr_t base;
+	unsigned long clock;
+	uint32_t fmt0_hz;
+	uint32_t ramp_coeff;
+	int t0;
+} dts;
+
+int stm32_dts_get_temp(int *mcelsius)
+{
+	uint32_t smp_time;
+	uint32_t periods;
+	uint64_t freq_hz;
+	int64_t temp;
+
+	if (dts.base == 0U) {
+		return -ENODEV;
+	}
+
+	periods = mmio_read_32(dts.base + DTS_DR) & DTS_DR_TS1_MFREQ_MASK;
+	if (periods == 0U) {
+		return -EAGAIN;
+	}
+
+	smp_time = (mmio_read_32(dts.base + DTS_CFGR1) &
+		    DTS_CFGR1_TS1_SMP_TIME_MASK) >> DTS_CFGR1_TS1_SMP_TIME_SHIFT;
+
+	/* CLK_PTAT frequency from the reference clock periods sampled */
+	freq_hz = ((uint64_t)clk_get_rate(dts.clock) * smp_time) / periods;
+
+	temp = ((int64_t)freq_hz - (int64_t)dts.fmt0_hz) * 1000 /
+	       (int64_t)dts.ramp_coeff;
+	*mcelsius = (int)(temp + (int64_t)dts.t0 * 1000);
+
+	return 0;
+}
+
+static int dts_start(void)
+{
+	unsigned long clk_mhz = clk_get_rate(dts.clock) / ONE_MHZ;
+	uint32_t prescaler = 0U;
+	uint32_t cfgr;
+	uint32_t val;
+	uint64_t timeout;
+
+	val = mmio_read_32(dts.base + DTS_T0VALR1);
+	dts.fmt0_hz = (val & DTS_T0VALR1_TS1_FMT0_MASK) * DTS_FMT0_UNIT_HZ;
+	if (((val & DTS_T0VALR1_TS1_T0_MASK) >> DTS_T0VALR1_TS1_T0_SHIFT) ==
+	    0U) {
+		dts.t0 = DTS_T0_30C;
+	} else {
+		dts.t0 = DTS_T0_130C;
+	}
+
+	dts.ramp_coeff = mmio_read_32(dts.base + DTS_RAMPVALR) &
+			 DTS_RAMPVALR_TS1_RAMP_MASK;
+	if ((dts.fmt0_hz == 0U) || (dts.ramp_coeff == 0U)) {
+		return -EINVAL;
+	}
+
+	/* Reference clock prescaler, keeping the sampling clock below 1MHz */
+	if (clk_mhz != 0U) {
+		prescaler = (uint32_t)clk_mhz + 1U;
+	}
+
+	if (prescaler > (DTS_CFGR1_HSREF_CLK_DIV_MASK >>
+			 DTS_CFGR1_HSREF_CLK_DIV_SHIFT)) {
+		return -EINVAL;
+	}
+
+	/*
+	 * PCLK reference, maximal sampling time for best accuracy,
+	 * measurement with calibration, software trigger.
+	 */
+	cfgr = mmio_read_32(dts.base + DTS_CFGR1);
+	cfgr &= ~(DTS_CFGR1_HSREF_CLK_DIV_MASK | DTS_CFGR1_REFCLK_SEL |
+		  DTS_CFGR1_Q_MEAS_OPT | DTS_CFGR1_TS1_INTRIG_SEL_MASK);
+	cfgr |= (prescaler << DTS_CFGR1_HSREF_CLK_DIV_SHIFT) |
+		DTS_CFGR1_TS1_SMP_TIME_MASK;
+	mmio_write_32(dts.base + DTS_CFGR1, cfgr);
+
+	mmio_setbits_32(dts.base + DTS_CFGR1, DTS_CFGR1_TS1_EN);
+
+	timeout = timeout_init_us(DTS_READY_TIMEOUT_US);
+	while ((mmio_read_32(dts.base + DTS_SR) & DTS_SR_TS_RDY) == 0U) {
+		if (timeout_elapsed(timeout)) {
+			mmio_clrbits_32(dts.base + DTS_CFGR1, DTS_CFGR1_TS1_EN);
+			return -ETIMEDOUT;
+		}
+	}
+
+	/* Continuous measurement, the last result is always readable */
+	mmio_setbits_32(dts.base + DTS_CFGR1, DTS_CFGR1_TS1_START);
+
+	return 0;
+}
+
+int stm32_dts_init(void)
+{
+	struct dt_node_info dt_dts;
+	void *fdt;
+	int ret;
+
+	if (dts.base != 0U) {
+		/* Driver is already initialized */
+		return 1;
+	}
+
+	if (fdt_get_address(&fdt) == 0) {
+		panic();
+	}
+
+	if (dt_get_node(&dt_dts, -1, DT_DTS_COMPAT) < 0) {
+		return 0;
+	}
+
+	if ((dt_dts.status & DT_SECURE) == 0U) {
+		return 0;
+	}
+
+	assert(dt_dts.base != 0U);
+
+	if (dt_dts.clock < 0) {
+		panic();
+	}
+
+	dts.base = dt_dts.base;
+	dts.clock = (unsigned long)dt_dts.clock;
+
+	clk_enable(dts.clock);
+
+	ret = dts_start();
+	if (ret != 0) {
+		clk_disable(dts.clock);
+		dts.base = 0U;
+		return ret;
+	}
+
+	return 1;
+}
@@ -16,6 +16,7 @@
 #include <drivers/delay_timer.h>
 #include <drivers/st/stm32_timer.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
 
 #define TIM_CR1			0x00U		/* Control Register 1      */
 #define TIM_CR2			0x04U		/* Control Register 2      */
@@ -41,6 +42,7 @@
 #define TIM_TISEL		0x68U		/* Input Selection         */
 
 #define TIM_CR1_CEN		BIT(0)
+#define TIM_DIER_CC1IE		BIT(1)		/* CC1 interrupt enable    */
 #define TIM_SMCR_SMS		GENMASK(2, 0)	/* Slave mode selection */
 #define TIM_SMCR_TS		GENMASK(6, 4)	/* Trigger selection */
 #define TIM_CCMR_CC1S_TI1	BIT(0)		/* IC1/IC3 selects TI1/TI3 */
@@ -64,15 +66,40 @@
 #define TIM_PRESCAL_CSI		7U
 #define TIM_MIN_FREQ_CALIB	50000000U
 #define TIM_THRESHOLD		1U
+#define TIM_ASYNC_SKIP		2U
 
 struct stm32_timer_instance {
 	uintptr_t base;
 	unsigned long clk;
 	unsigned long freq;
+	int irq;
 	uint8_t cal_input;
 };
 
+/*
+ * Interrupt-driven measurement in progress. The HSI and CSI inputs may be
+ * captured by the same timer instance, so only one measurement runs at a time.
+ * @cb: Completion callback, NULL when no measurement is in progress
+ * @skip: Captures still to drop, the first ones may cover a partial period
+ * @count: Captures still to accumulate
+ * @captures: Number of captures to average
+ * @sum: Sum of the accumulated captures
+ * @timeout: Time after which a new request aborts this measurement
+ */
+struct stm32_timer_async {
+	struct stm32_timer_instance *timer;
+	enum timer_cal type;
+	stm32_timer_freq_cb_t cb;
+	unsigned int skip;
+	unsigned int count;
+	unsigned int captures;
+	uint64_t sum;
+	uint64_t timeout;
+};
+
 static struct stm32_timer_instance stm32_timer[TIM_MAX_INSTANCE];
+static struct stm32_timer_async stm32_timer_async;
+static spinlock_t stm32_timer_async_lock;
 
 static int stm32_timer_get_dt_node(struct dt_node_info *info, int offset)
 {
@@ -132,7 +159,8 @@ static uint32_t stm32_timer_start_capture(struct stm32_timer_instance *timer)
 	uint32_t old_counter;
 	uint64_t conv_timeout;
 
-	if (stm32_timer_config(timer) < 0) {
+	if ((stm32_timer_async.cb != NULL) ||
+	    (stm32_timer_config(timer) < 0)) {
 		return 0U;
 	}
 
@@ -229,6 +257,144 @@ unsigned long stm32_timer_csi_freq(void)
 	return csi_freq;
 }
 
+static unsigned int stm32_timer_prescal(enum timer_cal type)
+{
+	return (type == HSI_CAL) ? TIM_PRESCAL_HSI : TIM_PRESCAL_CSI;
+}
+
+/* Stop the measurement in progress, called with the lock held */
+static void stm32_timer_async_stop(struct stm32_timer_async *async)
+{
+	mmio_clrbits_32(async->timer->base + TIM_DIER, TIM_DIER_CC1IE);
+	mmio_write_32(async->timer->base + TIM_SR, 0U);
+	clk_disable(async->timer->clk);
+
+	async->cb = NULL;
+}
+
+static void stm32_timer_it_handler(uint32_t id __unused)
+{
+	struct stm32_timer_async *async = &stm32_timer_async;
+	stm32_timer_freq_cb_t cb;
+	enum timer_cal type;
+	unsigned long freq;
+
+	spin_lock(&stm32_timer_async_lock);
+
+	if (async->cb == NULL) {
+		spin_unlock(&stm32_timer_async_lock);
+		return;
+	}
+
+	/* Reading CCR1 clears the capture flag */
+	if ((mmio_read_32(async->timer->base + TIM_SR) & TIM_SR_CC1IF) != 0U) {
+		uint32_t counter = mmio_read_32(async->timer->base + TIM_CCR1);
+
+		if (async->skip != 0U) {
+			async->skip--;
+		} else {
+			async->sum += counter;
+			async->count--;
+		}
+	}
+
+	mmio_write_32(async->timer->base + TIM_SR, 0U);
+
+	if (async->count != 0U) {
+		spin_unlock(&stm32_timer_async_lock);
+		return;
+	}
+
+	freq = 0UL;
+	if (async->sum != 0U) {
+		freq = (unsigned long)(((uint64_t)async->timer->freq *
+					async->captures) / async->sum) <<
+		       stm32_timer_prescal(async->type);
+	}
+
+	cb = async->cb;
+	type = async->type;
+	stm32_timer_async_stop(async);
+
+	spin_unlock(&stm32_timer_async_lock);
+
+	VERBOSE("Timer %s freq %lu\n", (type == HSI_CAL) ? "HSI" : "CSI",
+		freq);
+
+	cb(type, freq);
+}
+
+/*
+ * Start an interrupt-driven measurement of a target clock frequency, averaged
+ * over several input periods. The callback is called from the timer interrupt
+ * handler with the measured frequency, or from this function with 0 when it
+ * aborts a measurement which did not complete in time.
+ * @type - Target clock calibration ID
+ * @captures - Number of input periods to average
+ * @cb - Completion callback
+ * Return 0 on success, -ENOTSUP if the timer has no secure interrupt, -EBUSY
+ * if a measurement is already in progress, or another negative errno.
+ */
+int stm32_timer_freq_async(enum timer_cal type, unsigned int captures,
+			   stm32_timer_freq_cb_t cb)
+{
+	struct stm32_timer_async *async = &stm32_timer_async;
+	struct stm32_timer_instance *timer;
+	stm32_timer_freq_cb_t aborted_cb = NULL;
+	enum timer_cal aborted_type = type;
+	int ret = 0;
+
+	assert((type == HSI_CAL) || (type == CSI_CAL));
+	assert((cb != NULL) && (captures != 0U));
+
+	timer = &stm32_timer[type];
+	if ((timer->base == 0U) || (timer->irq < 0)) {
+		return -ENOTSUP;
+	}
+
+	spin_lock(&stm32_timer_async_lock);
+
+	if (async->cb != NULL) {
+		if (!timeout_elapsed(async->timeout)) {
+			spin_unlock(&stm32_timer_async_lock);
+			return -EBUSY;
+		}
+
+		aborted_cb = async->cb;
+		aborted_type = async->type;
+		stm32_timer_async_stop(async);
+	}
+
+	if (stm32_timer_config(timer) < 0) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	async->timer = timer;
+	async->type = type;
+	async->cb = cb;
+	async->skip = TIM_ASYNC_SKIP;
+	async->count = captures;
+	async->captures = captures;
+	async->sum = 0U;
+	async->timeout = timeout_init_us(TIM_TIMEOUT_US);
+
+	clk_enable(timer->clk);
+
+	mmio_write_32(timer->base + TIM_SR, 0U);
+	mmio_setbits_32(timer->base + TIM_DIER, TIM_DIER_CC1IE);
+
+out:
+	spin_unlock(&stm32_timer_async_lock);
+
+	if (aborted_cb != NULL) {
+		WARN("Timer measurement timeout\n");
+		aborted_cb(aborted_type, 0UL);
+	}
+
+	return ret;
+}
+
 /*
  * Get the timer frequence callback function for a target clock calibration
  * @timer_freq_cb - Output callback function
@@ -255,6 +421,21 @@ void stm32_timer_freq_func(unsigned long (**timer_freq_cb)(void),
 	}
 }
 
+/* Secure interrupt of the timer, for asynchronous measurements, or -1 */
+static int stm32_timer_irq(int node)
+{
+	int irq = stm32mp_gic_enable_spi(node, NULL);
+
+	if (irq < 0) {
+		VERBOSE("Timer without interrupt, measurements are blocking\n");
+		return -1;
+	}
+
+	stm32mp_gic_register_handler((uint32_t)irq, stm32_timer_it_handler);
+
+	return irq;
+}
+
 /*
  * Initialize timer from DT
  * return 0 if disabled, 1 if enabled, else < 0
@@ -288,6 +469,7 @@ int stm32_timer_init(void)
 				timer->freq = clk_get_rate(timer->clk);
 				timer->cal_input =
 					(uint8_t)fdt32_to_cpu(*cuint);
+				timer->irq = stm32_timer_irq(node);
 				if (stm32_timer_config(timer) < 0) {
 					timer->base = 0;
 					continue;
@@ -303,6 +485,7 @@ int stm32_timer_init(void)
 				timer->freq = clk_get_rate(timer->clk);
 				timer->cal_input =
 					(uint8_t)fdt32_to_cpu(*cuint);
+				timer->irq = stm32_timer_irq(node);
 				if (stm32_timer_config(timer) < 0) {
 					timer->base = 0;
 					continue;
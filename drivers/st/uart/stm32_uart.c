@@ -391,6 +391,42 @@ int stm32_uart_putc(struct stm32_uart_handle_s *huart, int c)
 	return 0;
 }
 
+/*
+ * @brief  Transmit a buffer in no blocking mode, filling the TX FIFO as soon
+ *         as it is not full. Errors are checked once the buffer is queued.
+ * @param  huart: UART handle.
+ * @param  buf: data to sent.
+ * @param  len: number of bytes to sent.
+ * @retval UART status.
+ */
+int stm32_uart_write(struct stm32_uart_handle_s *huart, const uint8_t *buf,
+		     size_t len)
+{
+	size_t i;
+	int ret;
+
+	if ((huart == NULL) || (buf == NULL)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < len; i++) {
+		/* TXE is TXFNF when the FIFO is enabled */
+		ret = stm32_uart_wait_flag(huart, USART_ISR_TXE);
+		if (ret != 0) {
+			return ret;
+		}
+
+		mmio_write_32(huart->base + USART_TDR, buf[i]);
+	}
+
+	if (stm32_uart_error_detected(huart)) {
+		stm32_uart_error_clear(huart);
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
 /*
  * @brief  Flush TX Transmit fifo
  * @param  huart: UART handle.
@@ -438,3 +474,52 @@ int stm32_uart_getc(struct stm32_uart_handle_s *huart)
 
 	return (int)data;
 }
+
+/*
+ * @brief  Receive a buffer, reading the RX FIFO as soon as it is not empty.
+ *         Errors are checked once the buffer is received.
+ * @param  huart: UART handle.
+ * @param  buf: data received.
+ * @param  len: number of bytes to receive.
+ * @param  timeout_us: max delay waiting for each byte.
+ * @retval UART status.
+ */
+int stm32_uart_read(struct stm32_uart_handle_s *huart, uint8_t *buf,
+		    size_t len, uint64_t timeout_us)
+{
+	uint64_t timeout_ref = 0U;
+	bool waiting = false;
+	size_t i = 0U;
+
+	if ((huart == NULL) || (buf == NULL)) {
+		return -EINVAL;
+	}
+
+	while (i < len) {
+		/* RXNE is RXFNE when the FIFO is enabled */
+		if ((mmio_read_32(huart->base + USART_ISR) &
+		     USART_ISR_RXNE) == 0U) {
+			/* Timeout only started when the FIFO is empty */
+			if (!waiting) {
+				timeout_ref = timeout_init_us(timeout_us);
+				waiting = true;
+			} else if (timeout_elapsed(timeout_ref)) {
+				return -ETIMEDOUT;
+			}
+
+			continue;
+		}
+
+		waiting = false;
+		buf[i] = (uint8_t)(mmio_read_32(huart->base + USART_RDR) &
+				   huart->rdr_mask);
+		i++;
+	}
+
+	if (stm32_uart_error_detected(huart)) {
+		stm32_uart_error_clear(huart);
+		return -EFAULT;
+	}
+
+	return 0;
+}
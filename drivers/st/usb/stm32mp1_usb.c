@@ -5,6 +5,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include <arch_helpers.h>
 #include <common/debug.h>
@@ -81,6 +82,9 @@
 
 /* Bit definitions for OTG_GAHBCFG register */
 #define OTG_GAHBCFG_GINT			BIT(0)
+#define OTG_GAHBCFG_HBSTLEN			GENMASK(4, 1)
+#define OTG_GAHBCFG_HBSTLEN_INCR4		(3U << 1)
+#define OTG_GAHBCFG_DMAEN			BIT(5)
 
 /* Bit definitions for OTG_GUSBCFG register */
 #define OTG_GUSBCFG_TRDT			GENMASK(13, 10)
@@ -201,6 +205,10 @@
 #define OTG_DOEPTSIZ_PKTCNT			GENMASK(28, 19)
 #define OTG_DOEPTSIZ_RXDPID_STUPCNT		GENMASK(30, 29)
 
+/* Back-to-back SETUP packets received on EP0, as programmed in STUPCNT */
+#define USB_SETUP_PACKET_SIZE			8U
+#define USB_SETUP_PACKET_NB			3U
+
 /* Bit definitions for OTG_DOEPINTx registers */
 #define OTG_DOEPINT_XFRC			BIT(0)
 #define OTG_DOEPINT_STUP			BIT(3)
@@ -211,6 +219,23 @@
 #define EP_NB					15U
 #define EP_ALL					0x10U
 
+#if STM32MP_USB_DMA
+/*
+ * Buffer DMA mode: the core reads and writes the transfer buffers itself.
+ * EP0 goes through cache line aligned buffers, as its packets are at most
+ * EP0_FIFO_SIZE bytes and may be unaligned; the other EPs use the transfer
+ * buffer directly, 4 bytes aligned.
+ */
+static uint8_t usb_dwc2_setup_buf[EP0_FIFO_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+static uint8_t usb_dwc2_ep0_in_buf[EP0_FIFO_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+static uint8_t usb_dwc2_ep0_out_buf[EP0_FIFO_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+static bool usb_dwc2_ep0_out_data;
+static struct pcd_handle *usb_dwc2_pcd;
+#endif
+
 /*
  * Flush TX FIFO.
  * handle: PCD handle.
@@ -381,6 +406,28 @@ static enum usb_status usb_dwc2_activate_setup(void *handle)
 static enum usb_status usb_dwc2_ep0_out_start(void *handle)
 {
 	uintptr_t usb_base_addr = (uintptr_t)handle;
+#if STM32MP_USB_DMA
+	uintptr_t reg_offset = usb_base_addr + OTG_DOEP_BASE;
+
+	/* Already armed: a SETUP packet is always accepted */
+	if ((mmio_read_32(reg_offset + OTG_DOEPCTL) & OTG_DOEPCTL_EPENA) != 0U) {
+		return USBD_OK;
+	}
+
+	inv_dcache_range((uintptr_t)usb_dwc2_setup_buf,
+			 sizeof(usb_dwc2_setup_buf));
+
+	mmio_write_32(reg_offset + OTG_DOEPTSIZ,
+		      OTG_DIEPTSIZ_PKTCNT_1 | OTG_DOEPTSIZ_RXDPID_STUPCNT |
+		      (USB_SETUP_PACKET_NB * USB_SETUP_PACKET_SIZE));
+	mmio_write_32(reg_offset + OTG_DOEPDMA, (uintptr_t)usb_dwc2_setup_buf);
+
+	/* Also used for the status stage: ACK the OUT packets */
+	mmio_setbits_32(reg_offset + OTG_DOEPCTL,
+			OTG_DOEPCTL_CNAK | OTG_DOEPCTL_EPENA);
+
+	usb_dwc2_ep0_out_data = false;
+#else
 	uintptr_t reg_offset = usb_base_addr + OTG_DIEP_BASE + OTG_DIEPTSIZ;
 	uint32_t reg_value = 0U;
 
@@ -390,6 +437,7 @@ static enum usb_status usb_dwc2_ep0_out_start(void *handle)
 	reg_value |= OTG_DOEPTSIZ_RXDPID_STUPCNT;
 
 	mmio_write_32(reg_offset, reg_value);
+#endif
 
 	return USBD_OK;
 }
@@ -467,6 +515,13 @@ static enum usb_status usb_dwc2_ep_start_xfer(void *handle, struct usbd_ep *ep)
 	uint32_t reg_value;
 	uint32_t clear_value;
 
+#if STM32MP_USB_DMA
+	/* The DMA accesses the buffers by words */
+	if ((ep->xfer_len != 0U) && (((uintptr_t)ep->xfer_buff & 0x3U) != 0U)) {
+		return USBD_FAIL;
+	}
+#endif
+
 	if (ep->is_in) {
 		reg_offset = usb_base_addr + OTG_DIEP_BASE + (ep->num * OTG_DIEP_SIZE);
 		clear_value = OTG_DIEPTSIZ_PKTCNT | OTG_DIEPTSIZ_XFRSIZ;
@@ -492,10 +547,20 @@ static enum usb_status usb_dwc2_ep_start_xfer(void *handle, struct usbd_ep *ep)
 
 		mmio_clrsetbits_32(reg_offset + OTG_DIEPTSIZ, clear_value, reg_value);
 
+#if STM32MP_USB_DMA
+		if (ep->xfer_len > 0U) {
+			clean_dcache_range((uintptr_t)ep->xfer_buff,
+					   ep->xfer_len);
+		}
+
+		mmio_write_32(reg_offset + OTG_DIEPDMA,
+			      (uintptr_t)ep->xfer_buff);
+#else
 		if ((ep->type != EP_TYPE_ISOC) && (ep->xfer_len > 0U)) {
 			/* Enable the TX FIFO empty interrupt for this EP */
 			mmio_setbits_32(usb_base_addr + OTG_DIEPEMPMSK, BIT(ep->num));
 		}
+#endif
 
 		/* EP enable, IN data in FIFO */
 		reg_value = OTG_DIEPCTL_CNAK | OTG_DIEPCTL_EPENA;
@@ -510,9 +575,11 @@ static enum usb_status usb_dwc2_ep_start_xfer(void *handle, struct usbd_ep *ep)
 
 		mmio_setbits_32(reg_offset + OTG_DIEPCTL, reg_value);
 
+#if !STM32MP_USB_DMA
 		if (ep->type == EP_TYPE_ISOC) {
 			usb_dwc2_write_packet(handle, ep->xfer_buff, ep->num, ep->xfer_len);
 		}
+#endif
 	} else {
 		reg_offset = usb_base_addr + OTG_DOEP_BASE + (ep->num * OTG_DOEP_SIZE);
 		/*
@@ -533,6 +600,19 @@ static enum usb_status usb_dwc2_ep_start_xfer(void *handle, struct usbd_ep *ep)
 				   OTG_DOEPTSIZ_XFRSIZ & OTG_DOEPTSIZ_PKTCNT,
 				   reg_value);
 
+#if STM32MP_USB_DMA
+		if (ep->xfer_len > 0U) {
+			flush_dcache_range((uintptr_t)ep->xfer_buff,
+					   ep->xfer_len);
+			mmio_write_32(reg_offset + OTG_DOEPDMA,
+				      (uintptr_t)ep->xfer_buff);
+		} else {
+			/* Zero length packet expected, scratch buffer */
+			mmio_write_32(reg_offset + OTG_DOEPDMA,
+				      (uintptr_t)usb_dwc2_ep0_out_buf);
+		}
+#endif
+
 		/* EP enable */
 		reg_value = OTG_DOEPCTL_CNAK | OTG_DOEPCTL_EPENA;
 
@@ -587,11 +667,23 @@ static enum usb_status usb_dwc2_ep0_start_xfer(void *handle, struct usbd_ep *ep)
 				   OTG_DIEPTSIZ_XFRSIZ | OTG_DIEPTSIZ_PKTCNT,
 				   reg_value);
 
+#if STM32MP_USB_DMA
+		if (ep->xfer_len > 0U) {
+			(void)memcpy(usb_dwc2_ep0_in_buf, ep->xfer_buff,
+				     ep->xfer_len);
+			clean_dcache_range((uintptr_t)usb_dwc2_ep0_in_buf,
+					   sizeof(usb_dwc2_ep0_in_buf));
+		}
+
+		mmio_write_32(reg_offset + OTG_DIEPDMA,
+			      (uintptr_t)usb_dwc2_ep0_in_buf);
+#else
 		/* Enable the TX FIFO empty interrupt for this EP */
 		if (ep->xfer_len > 0U) {
 			mmio_setbits_32(usb_base_addr +	OTG_DIEPEMPMSK,
 					BIT(ep->num));
 		}
+#endif
 
 		/* EP enable, IN data in FIFO */
 		mmio_setbits_32(reg_offset + OTG_DIEPCTL,
@@ -600,6 +692,13 @@ static enum usb_status usb_dwc2_ep0_start_xfer(void *handle, struct usbd_ep *ep)
 		reg_offset = usb_base_addr + OTG_DOEP_BASE +
 			     (ep->num * OTG_DOEP_SIZE);
 
+#if STM32MP_USB_DMA
+		/* Status stage, or premature end of an IN data stage */
+		if (ep->xfer_len == 0U) {
+			return usb_dwc2_ep0_out_start(handle);
+		}
+#endif
+
 		/*
 		 * Program the transfer size and packet count as follows:
 		 * pktcnt = N
@@ -615,6 +714,14 @@ static enum usb_status usb_dwc2_ep0_start_xfer(void *handle, struct usbd_ep *ep)
 				   OTG_DIEPTSIZ_XFRSIZ | OTG_DIEPTSIZ_PKTCNT,
 				   reg_value);
 
+#if STM32MP_USB_DMA
+		inv_dcache_range((uintptr_t)usb_dwc2_ep0_out_buf,
+				 sizeof(usb_dwc2_ep0_out_buf));
+		mmio_write_32(reg_offset + OTG_DOEPDMA,
+			      (uintptr_t)usb_dwc2_ep0_out_buf);
+		usb_dwc2_ep0_out_data = true;
+#endif
+
 		/* EP enable */
 		mmio_setbits_32(reg_offset + OTG_DOEPCTL,
 				OTG_DOEPCTL_CNAK | OTG_DOEPCTL_EPENA);
@@ -659,6 +766,13 @@ static enum usb_status usb_dwc2_ep_set_stall(void *handle, struct usbd_ep *ep)
 		reg_value |= OTG_DOEPCTL_STALL;
 
 		mmio_write_32(reg_offset + OTG_DOEPCTL, reg_value);
+
+#if STM32MP_USB_DMA
+		/* The stall is cleared by the next SETUP packet */
+		if (ep->num == 0U) {
+			return usb_dwc2_ep0_out_start(handle);
+		}
+#endif
 	}
 
 	return USBD_OK;
@@ -781,6 +895,90 @@ static enum usb_status usb_dwc2_write_empty_tx_fifo(void *handle,
 	return USBD_OK;
 }
 
+#if STM32MP_USB_DMA
+/*
+ * Copy the last SETUP packet written by the DMA to the PCD setup buffer.
+ * usb_base_addr: USB global register base address.
+ */
+static void usb_dwc2_dma_setup_done(uintptr_t usb_base_addr)
+{
+	uintptr_t buf = (uintptr_t)usb_dwc2_setup_buf;
+	uintptr_t addr;
+
+	inv_dcache_range(buf, sizeof(usb_dwc2_setup_buf));
+
+	/* OTG_DOEPDMA points after the last SETUP packet received */
+	addr = mmio_read_32(usb_base_addr + OTG_DOEP_BASE + OTG_DOEPDMA);
+	if ((addr < (buf + USB_SETUP_PACKET_SIZE)) ||
+	    (addr > (buf + (USB_SETUP_PACKET_NB * USB_SETUP_PACKET_SIZE)))) {
+		addr = buf + USB_SETUP_PACKET_SIZE;
+	}
+
+	(void)memcpy(usb_dwc2_pcd->setup,
+		     (void *)(addr - USB_SETUP_PACKET_SIZE),
+		     USB_SETUP_PACKET_SIZE);
+}
+
+/*
+ * Update the OUT EP buffer with the data written by the DMA.
+ * usb_base_addr: USB global register base address.
+ * epnum: Endpoint number.
+ */
+static void usb_dwc2_dma_out_done(uintptr_t usb_base_addr, uint32_t epnum)
+{
+	struct usbd_ep *ep = &usb_dwc2_pcd->out_ep[epnum];
+	uintptr_t reg_offset = usb_base_addr + OTG_DOEP_BASE +
+			       (epnum * OTG_DOEP_SIZE);
+	uint32_t rem = mmio_read_32(reg_offset + OTG_DOEPTSIZ) &
+		       OTG_DOEPTSIZ_XFRSIZ;
+	uint32_t len;
+
+	if (epnum == 0U) {
+		if (!usb_dwc2_ep0_out_data) {
+			/* Status stage done, wait for the next SETUP */
+			(void)usb_dwc2_ep0_out_start((void *)usb_base_addr);
+			return;
+		}
+
+		usb_dwc2_ep0_out_data = false;
+		len = MIN(ep->maxpacket - rem, ep->xfer_len);
+		inv_dcache_range((uintptr_t)usb_dwc2_ep0_out_buf,
+				 sizeof(usb_dwc2_ep0_out_buf));
+		(void)memcpy(ep->xfer_buff, usb_dwc2_ep0_out_buf, len);
+	} else {
+		if (ep->xfer_len == 0U) {
+			return;
+		}
+
+		len = (div_round_up(ep->xfer_len, ep->maxpacket) *
+		       ep->maxpacket) - rem;
+		len = MIN(len, ep->xfer_len);
+		inv_dcache_range((uintptr_t)ep->xfer_buff, len);
+	}
+
+	ep->xfer_buff += len;
+	ep->xfer_count += len;
+}
+
+/*
+ * Update the IN EP buffer with the data read by the DMA.
+ * usb_base_addr: USB global register base address.
+ * epnum: Endpoint number.
+ */
+static void usb_dwc2_dma_in_done(uintptr_t usb_base_addr, uint32_t epnum)
+{
+	struct usbd_ep *ep = &usb_dwc2_pcd->in_ep[epnum];
+
+	ep->xfer_buff += ep->xfer_len;
+	ep->xfer_count += ep->xfer_len;
+
+	/* EP0 OUT is always armed for SETUP packets outside data stages */
+	if (epnum == 0U) {
+		(void)usb_dwc2_ep0_out_start((void *)usb_base_addr);
+	}
+}
+#endif
+
 /*
  * Handle PCD interrupt request.
  * handle: PCD handle.
@@ -825,8 +1023,22 @@ static enum usb_action usb_dwc2_it_handler(void *handle, uint32_t *param)
 
 		epint = usb_dwc2_out_ep_int(handle, epnum);
 
+#if STM32MP_USB_DMA
+		/* The SETUP transfer completion is also flagged by XFRC */
+		if ((epint & OTG_DOEPINT_STUP) == OTG_DOEPINT_STUP) {
+			mmio_write_32(reg_offset,
+				      OTG_DOEPINT_STUP | OTG_DOEPINT_XFRC);
+			usb_dwc2_dma_setup_done(usb_base_addr);
+
+			return USB_SETUP;
+		}
+#endif
+
 		if ((epint & OTG_DOEPINT_XFRC) == OTG_DOEPINT_XFRC) {
 			mmio_write_32(reg_offset, OTG_DOEPINT_XFRC);
+#if STM32MP_USB_DMA
+			usb_dwc2_dma_out_done(usb_base_addr, epnum);
+#endif
 			*param = epnum;
 
 			return USB_DATA_OUT;
@@ -862,6 +1074,9 @@ static enum usb_action usb_dwc2_it_handler(void *handle, uint32_t *param)
 		if ((epint & OTG_DIEPINT_XFRC) == OTG_DIEPINT_XFRC) {
 			mmio_clrbits_32(usb_base_addr + OTG_DIEPEMPMSK, BIT(epnum));
 			mmio_write_32(reg_offset, OTG_DIEPINT_XFRC);
+#if STM32MP_USB_DMA
+			usb_dwc2_dma_in_done(usb_base_addr, epnum);
+#endif
 			*param = epnum;
 
 			return USB_DATA_IN;
@@ -1056,6 +1271,16 @@ static enum usb_status usb_dwc2_start_device(void *handle)
 {
 	uintptr_t usb_base_addr = (uintptr_t)handle;
 
+#if STM32MP_USB_DMA
+	mmio_clrsetbits_32(usb_base_addr + OTG_GAHBCFG, OTG_GAHBCFG_HBSTLEN,
+			   OTG_GAHBCFG_HBSTLEN_INCR4 | OTG_GAHBCFG_DMAEN);
+
+	/* The RX FIFO is emptied by the DMA */
+	mmio_clrbits_32(usb_base_addr + OTG_GINTMSK, OTG_GINTSTS_RXFLVL);
+
+	(void)usb_dwc2_ep0_out_start(handle);
+#endif
+
 	mmio_clrbits_32(usb_base_addr + OTG_DCTL, OTG_DCTL_SDIS);
 	mmio_setbits_32(usb_base_addr + OTG_GAHBCFG, OTG_GAHBCFG_GINT);
 
@@ -1086,6 +1311,10 @@ void stm32mp1_usb_init_driver(struct usb_handle *usb_core_handle,
 			      struct pcd_handle *pcd_handle,
 			      void *base_register)
 {
+#if STM32MP_USB_DMA
+	usb_dwc2_pcd = pcd_handle;
+#endif
+
 	register_usb_driver(usb_core_handle, pcd_handle, &usb_dwc2driver,
 			    base_register);
 }
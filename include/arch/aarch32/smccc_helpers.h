@@ -172,6 +172,12 @@ void smc_set_next_ctx(unsigned int security_state);
 /* Get the pointer to next `smc_ctx_t` already set by `smc_set_next_ctx()`. */
 void *smc_get_next_ctx(void);
 
+/*
+ * Save the live banked mode registers to `smc_ctx_t`, when the BL does not
+ * save them on each SMC entry.
+ */
+void smc_ctx_save_banked_regs(smc_ctx_t *ctx);
+
 #endif /*__ASSEMBLER__*/
 
 #endif /* SMCCC_HELPERS_H */
@@ -142,6 +142,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle2is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 #elif ERRATA_A76_1286807
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle1)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle1is)
@@ -150,6 +151,7 @@ DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle2is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(vmalle1)
+DEFINE_TLBIOP_ERRATA_TYPE_FUNC(vmalle1is)
 #else
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle1)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle1is)
@@ -158,6 +160,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle2is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 #endif
 
 #if ERRATA_A57_813419
@@ -430,6 +433,7 @@ DEFINE_SYSREG_RW_FUNCS(cptr_el3)
 
 DEFINE_SYSREG_RW_FUNCS(cpacr_el1)
 DEFINE_SYSREG_RW_FUNCS(cntfrq_el0)
+DEFINE_SYSREG_RW_FUNCS(cntkctl_el1)
 DEFINE_SYSREG_RW_FUNCS(cnthp_ctl_el2)
 DEFINE_SYSREG_RW_FUNCS(cnthp_tval_el2)
 DEFINE_SYSREG_RW_FUNCS(cnthp_cval_el2)
@@ -185,6 +185,22 @@
 	. = . + (__PERCPU_TIMESTAMP_SIZE__ * (PLATFORM_CORE_COUNT - 1)); \
 	__PMF_TIMESTAMP_END__ = .;
 
+/*
+ * Per-CPU variables are stored in normal .bss memory
+ *
+ * The compiler will allocate enough memory for one CPU's variables, the
+ * copies of the other CPUs are allocated by the linker script. Each copy is
+ * padded to a cache line, so no line is shared between CPUs.
+ */
+#define PER_CPU_DATA					\
+	. = ALIGN(CACHE_WRITEBACK_GRANULE);		\
+	__PER_CPU_START__ = .;				\
+	*(per_cpu_data)					\
+	. = ALIGN(CACHE_WRITEBACK_GRANULE);		\
+	__PER_CPU_UNIT_END__ = .;			\
+	__PER_CPU_UNIT_SIZE__ = ABSOLUTE(. - __PER_CPU_START__); \
+	. = . + (__PER_CPU_UNIT_SIZE__ * (PLATFORM_CORE_COUNT - 1)); \
+	__PER_CPU_END__ = .;
 
 /*
  * The .bss section gets initialised to 0 at runtime.
@@ -198,6 +214,7 @@
 		*(COMMON)				\
 		BAKERY_LOCK_NORMAL			\
 		PMF_TIMESTAMP				\
+		PER_CPU_DATA				\
 		BASE_XLAT_TABLE_BSS			\
 		__BSS_END__ = .;			\
 	}
@@ -213,4 +230,18 @@
 		*(xlat_table)				\
 	}
 
+/*
+ * Format strings of the tokenised log messages. The section is not allocated:
+ * it is only kept in the ELF file, and its symbols are the offsets of the
+ * strings, used as tokens.
+ */
+#if ENABLE_LOG_TOKENS
+#define LOG_TOKENS_SECTION				\
+	.tf_log_fmt 0 (INFO) : {			\
+		*(.tf_log_fmt)				\
+	}
+#else
+#define LOG_TOKENS_SECTION
+#endif
+
 #endif /* BL_COMMON_LD_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,8 +59,22 @@
 		}					\
 	} while (false)
 
+/*
+ * With ENABLE_LOG_TOKENS, messages are written as tokens referring to their
+ * format string, see tf_log_tokens.h.
+ */
+#if ENABLE_LOG_TOKENS
+#include <common/tf_log_tokens.h>
+
+# define tf_log_msg(level, marker, ...)	\
+	TF_LOG_TOKEN(level, marker, __VA_ARGS__)
+#else
+# define tf_log_msg(level, marker, ...)	tf_log(marker __VA_ARGS__)
+#endif
+
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
-# define ERROR(...)	tf_log(LOG_MARKER_ERROR __VA_ARGS__)
+# define ERROR(...)	tf_log_msg(LOG_LEVEL_ERROR, LOG_MARKER_ERROR, \
+				   __VA_ARGS__)
 # define ERROR_NL()	tf_log_newline(LOG_MARKER_ERROR)
 #else
 # define ERROR(...)	no_tf_log(LOG_MARKER_ERROR __VA_ARGS__)
@@ -68,25 +82,29 @@
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_NOTICE
-# define NOTICE(...)	tf_log(LOG_MARKER_NOTICE __VA_ARGS__)
+# define NOTICE(...)	tf_log_msg(LOG_LEVEL_NOTICE, LOG_MARKER_NOTICE, \
+				   __VA_ARGS__)
 #else
 # define NOTICE(...)	no_tf_log(LOG_MARKER_NOTICE __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_WARNING
-# define WARN(...)	tf_log(LOG_MARKER_WARNING __VA_ARGS__)
+# define WARN(...)	tf_log_msg(LOG_LEVEL_WARNING, LOG_MARKER_WARNING, \
+				   __VA_ARGS__)
 #else
 # define WARN(...)	no_tf_log(LOG_MARKER_WARNING __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-# define INFO(...)	tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# define INFO(...)	tf_log_msg(LOG_LEVEL_INFO, LOG_MARKER_INFO, \
+				   __VA_ARGS__)
 #else
 # define INFO(...)	no_tf_log(LOG_MARKER_INFO __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-# define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# define VERBOSE(...)	tf_log_msg(LOG_LEVEL_VERBOSE, LOG_MARKER_VERBOSE, \
+				   __VA_ARGS__)
 #else
 # define VERBOSE(...)	no_tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
 #endif
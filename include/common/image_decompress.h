@@ -7,6 +7,7 @@
 #ifndef IMAGE_DECOMPRESS_H
 #define IMAGE_DECOMPRESS_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -21,4 +22,26 @@ void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
+/*
+ * Decompressor fed with the image chunks as they are read: update() returns 0
+ * while more input is expected, 1 at the end of the compressed stream.
+ */
+typedef struct decompressor_stream {
+	bool (*probe)(uintptr_t in_buf, size_t in_len);
+	int (*init)(uintptr_t out_buf, size_t out_len,
+		    uintptr_t work_buf, size_t work_len);
+	int (*update)(uintptr_t in_buf, size_t in_len);
+	int (*end)(uintptr_t *out_buf);
+} decompressor_stream_t;
+
+#if IMAGE_DECOMPRESS_STREAM
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  const decompressor_stream_t *decompressor);
+void image_decompress_stream_prepare(unsigned int image_id);
+bool image_decompress_stream_is_active(unsigned int image_id);
+int image_decompress_stream_read(uintptr_t image_handle,
+				 struct image_info *info, size_t image_size,
+				 size_t *bytes_read);
+#endif
+
 #endif /* IMAGE_DECOMPRESS_H */
@@ -134,5 +134,24 @@ void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 
+#if ENABLE_RT_SVC_STATS
+/*
+ * Calls handled by a runtime service on a CPU, with their durations in system
+ * counter ticks.
+ */
+typedef struct rt_svc_stats {
+	uint32_t count;
+	uint32_t max_ticks;
+	uint64_t total_ticks;
+} rt_svc_stats_t;
+
+uintptr_t handle_runtime_svc_stats(uint32_t smc_fid, u_register_t x1,
+				   u_register_t x2, u_register_t x3,
+				   u_register_t x4, void *cookie, void *handle,
+				   u_register_t flags);
+int rt_svc_get_stats(unsigned int core_pos, uint32_t smc_fid,
+		     rt_svc_stats_t *stats);
+#endif
+
 #endif /*__ASSEMBLER__*/
 #endif /* RUNTIME_SVC_H */
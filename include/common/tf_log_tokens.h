@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LOG_TOKENS_H
+#define TF_LOG_TOKENS_H
+
+#include <stdbool.h>
+
+/*
+ * Tokenised log messages, with ENABLE_LOG_TOKENS.
+ *
+ * The format string of each message is placed in the .tf_log_fmt section,
+ * which the linker scripts do not load, and the message is written to the
+ * console as a record made of the offset of its format string in that section
+ * and the raw values of its arguments. tools/log_tokens/decode_log_tokens.py
+ * formats the records back from the ELF file of the image.
+ *
+ * Record layout, little endian:
+ *   LOG_TOKEN_SYNC
+ *   uint8_t	image: 1 for BL1, 2 for BL2, 3 for BL2U, 31 for BL31, 32 for BL32
+ *   uint32_t	offset of the format string, its log marker included
+ *   uint8_t	number of arguments
+ *   uint16_t	bit n set if argument n is 8 bytes long, else 4 bytes long
+ *   arguments
+ * Within a record, the LOG_TOKEN_SYNC, LOG_TOKEN_ESC, '\n' and '\r' bytes are
+ * sent as LOG_TOKEN_ESC followed by the byte XORed with LOG_TOKEN_ESC_XOR, so
+ * that records can be mixed with text and go through CRLF translation.
+ */
+#define LOG_TOKEN_SYNC			0xA5U
+#define LOG_TOKEN_ESC			0xA6U
+#define LOG_TOKEN_ESC_XOR		0x20U
+
+#define LOG_TOKEN_MAX_ARGS		16U
+
+/* Second argument of tf_log_token() */
+#define LOG_TOKEN_INFO(level, nargs, wide) \
+	((level) | ((nargs) << 8) | ((wide) << 16))
+#define LOG_TOKEN_LEVEL(info)		((info) & 0xFFU)
+#define LOG_TOKEN_NARGS(info)		(((info) >> 8) & 0x1FU)
+#define LOG_TOKEN_WIDE_MASK(info)	((info) >> 16)
+
+#define LOG_TOKEN_CAT_(a, b)		a##b
+#define LOG_TOKEN_CAT(a, b)		LOG_TOKEN_CAT_(a, b)
+
+#define LOG_TOKEN_COUNT_(_, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10,	\
+			 a11, a12, a13, a14, a15, a16, n, ...)	n
+#define LOG_TOKEN_COUNT(...)						\
+	LOG_TOKEN_COUNT_(_, ##__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, \
+			 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/* Size of an argument once passed as variadic argument, arrays decayed */
+#define LOG_TOKEN_WIDE(n, x) \
+	((sizeof(true ? (x) : (x)) > 4U) ? (1U << (n)) : 0U)
+
+#define LOG_TOKEN_WIDE_0()		0U
+#define LOG_TOKEN_WIDE_1(a1)	LOG_TOKEN_WIDE(0, a1)
+#define LOG_TOKEN_WIDE_2(a1, a2) \
+	(LOG_TOKEN_WIDE_1(a1) | LOG_TOKEN_WIDE(1, a2))
+#define LOG_TOKEN_WIDE_3(a1, a2, a3) \
+	(LOG_TOKEN_WIDE_2(a1, a2) | LOG_TOKEN_WIDE(2, a3))
+#define LOG_TOKEN_WIDE_4(a1, a2, a3, a4) \
+	(LOG_TOKEN_WIDE_3(a1, a2, a3) | LOG_TOKEN_WIDE(3, a4))
+#define LOG_TOKEN_WIDE_5(a1, a2, a3, a4, a5) \
+	(LOG_TOKEN_WIDE_4(a1, a2, a3, a4) | LOG_TOKEN_WIDE(4, a5))
+#define LOG_TOKEN_WIDE_6(a1, a2, a3, a4, a5, a6) \
+	(LOG_TOKEN_WIDE_5(a1, a2, a3, a4, a5) | LOG_TOKEN_WIDE(5, a6))
+#define LOG_TOKEN_WIDE_7(a1, a2, a3, a4, a5, a6, a7) \
+	(LOG_TOKEN_WIDE_6(a1, a2, a3, a4, a5, a6) | LOG_TOKEN_WIDE(6, a7))
+#define LOG_TOKEN_WIDE_8(a1, a2, a3, a4, a5, a6, a7, a8) \
+	(LOG_TOKEN_WIDE_7(a1, a2, a3, a4, a5, a6, a7) | LOG_TOKEN_WIDE(7, a8))
+#define LOG_TOKEN_WIDE_9(a1, a2, a3, a4, a5, a6, a7, a8, a9) \
+	(LOG_TOKEN_WIDE_8(a1, a2, a3, a4, a5, a6, a7, a8) | LOG_TOKEN_WIDE(8, a9))
+#define LOG_TOKEN_WIDE_10(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10) \
+	(LOG_TOKEN_WIDE_9(a1, a2, a3, a4, a5, a6, a7, a8, a9) | LOG_TOKEN_WIDE(9, a10))
+#define LOG_TOKEN_WIDE_11(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11) \
+	(LOG_TOKEN_WIDE_10(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10) | LOG_TOKEN_WIDE(10, a11))
+#define LOG_TOKEN_WIDE_12(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12) \
+	(LOG_TOKEN_WIDE_11(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11) | LOG_TOKEN_WIDE(11, a12))
+#define LOG_TOKEN_WIDE_13(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13) \
+	(LOG_TOKEN_WIDE_12(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12) | LOG_TOKEN_WIDE(12, a13))
+#define LOG_TOKEN_WIDE_14(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14) \
+	(LOG_TOKEN_WIDE_13(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13) | LOG_TOKEN_WIDE(13, a14))
+#define LOG_TOKEN_WIDE_15(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15) \
+	(LOG_TOKEN_WIDE_14(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14) | LOG_TOKEN_WIDE(14, a15))
+#define LOG_TOKEN_WIDE_16(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16) \
+	(LOG_TOKEN_WIDE_15(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15) | LOG_TOKEN_WIDE(15, a16))
+
+#define LOG_TOKEN_WIDE_ARGS(...) \
+	LOG_TOKEN_CAT(LOG_TOKEN_WIDE_, LOG_TOKEN_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+#define TF_LOG_TOKEN(level, marker, fmt, ...)				\
+	do {								\
+		static const char _tf_log_fmt[]				\
+			__section(".tf_log_fmt") = marker fmt;		\
+									\
+		no_tf_log(marker fmt, ##__VA_ARGS__);			\
+		tf_log_token(_tf_log_fmt,				\
+			     LOG_TOKEN_INFO(level,			\
+				LOG_TOKEN_COUNT(__VA_ARGS__),		\
+				LOG_TOKEN_WIDE_ARGS(__VA_ARGS__)),	\
+			     ##__VA_ARGS__);				\
+	} while (false)
+
+void tf_log_token(const char *fmt, unsigned int info, ...);
+
+#endif /* TF_LOG_TOKENS_H */
@@ -83,6 +83,11 @@
 #define TZC_400_REGION_ATTR_FILTER_BIT(x)	(U(1) << (x))
 #define TZC_400_REGION_ATTR_FILTER_BIT_ALL	TZC_400_REGION_ATTR_F_EN_MASK
 
+/* Region attributes register value, filters given as a bitmap */
+#define TZC_400_REGION_ATTR(sec_attr, filters)				\
+	(((sec_attr) << TZC_REGION_ATTR_SEC_SHIFT) |			\
+	 ((filters) << TZC_REGION_ATTR_F_EN_SHIFT))
+
 /*
  * All TZC region configuration registers are placed one after another. It
  * depicts size of block of registers for programming each region.
@@ -97,6 +102,18 @@
 #include <cdefs.h>
 #include <stdint.h>
 
+/*
+ * Register content of a TZC-400 region, used to program several regions at
+ * once. attributes is built with TZC_400_REGION_ATTR() and holds the real
+ * filter bitmap.
+ */
+struct tzc400_region {
+	unsigned long long base;
+	unsigned long long top;
+	unsigned int attributes;
+	unsigned int id_access;
+};
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
@@ -110,6 +127,11 @@ void tzc400_configure_region(unsigned int filters,
 			  unsigned int sec_attr,
 			  unsigned int nsaid_permissions);
 void tzc400_update_filters(unsigned int region, unsigned int filters);
+void tzc400_get_regions(unsigned int first, struct tzc400_region *regions,
+			unsigned int count);
+unsigned int tzc400_configure_regions(unsigned int first,
+				      const struct tzc400_region *regions,
+				      unsigned int count);
 void tzc400_set_action(unsigned int action);
 void tzc400_enable_filters(void);
 void tzc400_disable_filters(void);
@@ -9,6 +9,9 @@
 
 #if TRUSTED_BOARD_BOOT
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <common/tbbr/cot_def.h>
 #include <common/tbbr/tbbr_img_def.h>
 #include <drivers/auth/auth_common.h>
@@ -51,6 +54,18 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_get_img_hash(unsigned int img_id, void **hash_der_ptr,
+			  unsigned int *hash_der_len);
+#if AUTH_STREAM_HASH
+int auth_mod_stream_hash_start(unsigned int img_id);
+int auth_mod_stream_hash_update(void *data_ptr, unsigned int data_len);
+bool auth_mod_stream_hash_is_active(void);
+#endif
+#if MEASURED_BOOT
+int auth_mod_get_img_digest_info(uintptr_t data_base, unsigned int data_len,
+				 const void **digest_info_ptr,
+				 unsigned int *digest_info_len);
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
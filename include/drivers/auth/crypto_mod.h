@@ -107,4 +107,81 @@ int crypto_mod_calc_hash(unsigned int alg, void *data_ptr,
 
 extern const crypto_lib_desc_t crypto_lib_desc;
 
+#if AUTH_STREAM_HASH
+/*
+ * Streaming hash verification, for data that is hashed while it is loaded
+ */
+typedef struct crypto_hash_stream_desc_s {
+	/* Start a hash whose result is to be compared with a DigestInfo */
+	int (*start)(void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Add data to the hash in progress */
+	int (*update)(void *data_ptr, unsigned int data_len);
+
+	/*
+	 * Complete the hash and compare it with the expected one. Return one
+	 * of the 'enum crypto_ret_value' options
+	 */
+	int (*finish)(void);
+} crypto_hash_stream_desc_t;
+
+int crypto_mod_hash_stream_start(void *digest_info_ptr,
+				 unsigned int digest_info_len);
+int crypto_mod_hash_stream_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_stream_finish(void);
+
+/* Macro to register the streaming hash operations of a cryptographic library */
+#define REGISTER_CRYPTO_HASH_STREAM(_start, _update, _finish) \
+	const crypto_hash_stream_desc_t crypto_hash_stream_desc = { \
+		.start = _start, \
+		.update = _update, \
+		.finish = _finish \
+	}
+
+extern const crypto_hash_stream_desc_t crypto_hash_stream_desc;
+#endif /* AUTH_STREAM_HASH */
+
+#if DECRYPTION_STREAM
+/*
+ * Streaming authenticated decryption, for data that is decrypted in place
+ * while it is loaded
+ */
+typedef struct crypto_dec_stream_desc_s {
+	/* Start a decryption with the key and IV of the encryption header */
+	int (*start)(enum crypto_dec_algo dec_algo, const void *key,
+		     unsigned int key_len, unsigned int key_flags,
+		     const void *iv, unsigned int iv_len);
+
+	/*
+	 * Decrypt in place a part of the payload. All parts but the last one
+	 * have a size multiple of the cipher block size.
+	 */
+	int (*update)(void *data_ptr, size_t len);
+
+	/*
+	 * Complete the decryption and check the tag. Return one of the
+	 * 'enum crypto_ret_value' options
+	 */
+	int (*finish)(const void *tag, unsigned int tag_len);
+} crypto_dec_stream_desc_t;
+
+int crypto_mod_auth_decrypt_stream_start(enum crypto_dec_algo dec_algo,
+					 const void *key, unsigned int key_len,
+					 unsigned int key_flags,
+					 const void *iv, unsigned int iv_len);
+int crypto_mod_auth_decrypt_stream_update(void *data_ptr, size_t len);
+int crypto_mod_auth_decrypt_stream_finish(const void *tag,
+					  unsigned int tag_len);
+
+/* Macro to register the streaming decryption operations of a cryptographic library */
+#define REGISTER_CRYPTO_DEC_STREAM(_start, _update, _finish) \
+	const crypto_dec_stream_desc_t crypto_dec_stream_desc = { \
+		.start = _start, \
+		.update = _update, \
+		.finish = _finish \
+	}
+
+extern const crypto_dec_stream_desc_t crypto_dec_stream_desc;
+#endif /* DECRYPTION_STREAM */
+
 #endif /* CRYPTO_MOD_H */
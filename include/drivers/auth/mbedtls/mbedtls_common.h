@@ -7,6 +7,12 @@
 #ifndef MBEDTLS_COMMON_H
 #define MBEDTLS_COMMON_H
 
+#include <stddef.h>
+
 void mbedtls_init(void);
+#if TF_MBEDTLS_HEAP_ARENA
+void mbedtls_heap_print_usage(void);
+void mbedtls_heap_get_usage(size_t *max_used, size_t *size);
+#endif
 
 #endif /* MBEDTLS_COMMON_H */
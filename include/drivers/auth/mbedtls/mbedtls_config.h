@@ -75,6 +75,13 @@
 #define MBEDTLS_SHA512_C
 #endif
 
+#if TF_MBEDTLS_SHA_NEON
+#define MBEDTLS_SHA256_PROCESS_ALT
+#if (TF_MBEDTLS_HASH_ALG_ID != TF_MBEDTLS_SHA256)
+#define MBEDTLS_SHA512_PROCESS_ALT
+#endif
+#endif
+
 #define MBEDTLS_VERSION_C
 
 #define MBEDTLS_X509_USE_C
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MBEDTLS_SHA_NEON_H
+#define MBEDTLS_SHA_NEON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Block functions, data being made of 'blocks' complete blocks */
+void sha256_block_neon(uint32_t state[8], const uint8_t *data, size_t blocks);
+void sha512_block_neon(uint64_t state[8], const uint8_t *data, size_t blocks);
+
+#endif /* MBEDTLS_SHA_NEON_H */
@@ -46,8 +46,17 @@ static inline bool timeout_elapsed(uint64_t expire_cnt)
 	return read_cntpct_el0() > expire_cnt;
 }
 
+/*
+ * Wait for an event before polling a condition again. Once the generic timer
+ * event stream is set with timer_evtstrm_init(), the core sleeps in WFE for
+ * at most one event stream period instead of spinning. Otherwise, return
+ * immediately.
+ */
+void timeout_wait_event(void);
+
 void mdelay(uint32_t msec);
 void udelay(uint32_t usec);
 void timer_init(const timer_ops_t *ops_ptr);
+void timer_evtstrm_init(uint32_t period_us);
 
 #endif /* DELAY_TIMER_H */
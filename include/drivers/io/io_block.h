@@ -13,12 +13,37 @@
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	/* Optional split-phase read, used by the direct read mode */
+	int	(*read_start)(int lba, uintptr_t buf, size_t size);
+	size_t	(*read_wait)(void);
+	/*
+	 * Optional scatter read: a single transfer of consecutive blocks
+	 * into the buffers of the list, in order. Returns the number of
+	 * bytes read.
+	 */
+	size_t	(*readv)(int lba, const io_vec_t *vec, unsigned int count);
 } io_block_ops_t;
 
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Optional direct read mode: when non-zero, the block-aligned part of
+	 * a read request whose destination is aligned on this value is read
+	 * straight into the caller buffer with a single ops->read() call.
+	 * Only the unaligned head and tail go through the temporary buffer.
+	 */
+	size_t		direct_read_align;
+	/*
+	 * Optional consumer of the read data, called in order on each part of
+	 * the caller buffer once it is filled. With the split-phase read ops,
+	 * direct reads are split in read_chunk_size pieces and the transfer of
+	 * the next piece is in progress while the hook processes the current
+	 * one.
+	 */
+	void		(*read_hook)(uintptr_t buf, size_t size);
+	size_t		read_chunk_size;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -48,6 +48,11 @@ typedef struct io_dev_funcs {
 	int (*close)(io_entity_t *entity);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
+	/* Optional: address of the remaining entity data, if memory-mapped */
+	int (*map)(io_entity_t *entity, uintptr_t *base, size_t *length);
+	/* Optional: read consecutive data into several buffers at once */
+	int (*readv)(io_entity_t *entity, const io_vec_t *vec,
+			unsigned int count, size_t *length_read);
 } io_dev_funcs_t;
 
 
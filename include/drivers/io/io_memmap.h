@@ -7,8 +7,15 @@
 #ifndef IO_MEMMAP_H
 #define IO_MEMMAP_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 struct io_dev_connector;
 
+/* Copy function used by the reads, e.g. to offload them to a DMA */
+typedef void (*io_memmap_copy_t)(uintptr_t dst, uintptr_t src, size_t size);
+
 int register_io_dev_memmap(const struct io_dev_connector **dev_con);
+void io_memmap_set_copy(io_memmap_copy_t copy);
 
 #endif /* IO_MEMMAP_H */
@@ -56,11 +56,21 @@ typedef struct io_mtd_ops {
 	int (*seek)(uintptr_t base, unsigned int offset, size_t *extra_offset);
 } io_mtd_ops_t;
 
+/*
+ * MTD device specification.
+ *
+ * @read_cache: optional read-ahead buffer, reads smaller than half of its
+ *	size are served from a window of @read_cache_size bytes fetched at
+ *	once. Only used when there is no seek op, as the window cannot follow
+ *	the offsets of skipped bad blocks.
+ */
 typedef struct io_mtd_dev_spec {
 	unsigned long long device_size;
 	unsigned int erase_size;
 	size_t offset;
 	io_mtd_ops_t ops;
+	uintptr_t read_cache;
+	size_t read_cache_size;
 } io_mtd_dev_spec_t;
 
 struct io_dev_connector;
@@ -63,6 +63,12 @@ typedef struct io_block_spec {
 	size_t length;
 } io_block_spec_t;
 
+/* Destination of one part of a vectored read */
+typedef struct io_vec {
+	uintptr_t buffer;
+	size_t length;
+} io_vec_t;
+
 
 /* Access modes used when accessing data on a device */
 #define IO_MODE_INVALID (0)
@@ -94,10 +100,17 @@ int io_size(uintptr_t handle, size_t *length);
 int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
 		size_t *length_read);
 
+int io_readv(uintptr_t handle, const io_vec_t *vec, unsigned int count,
+		size_t *length_read);
+
 int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 		size_t *length_written);
 
 int io_close(uintptr_t handle);
 
+int io_map(uintptr_t handle, uintptr_t *base, size_t *length);
+
+unsigned int io_get_handles_max_used(void);
+
 
 #endif /* IO_STORAGE_H */
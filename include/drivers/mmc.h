@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -24,6 +24,7 @@
 #define OCR_BYTE_MODE			(U(0) << 29)
 #define OCR_SECTOR_MODE			(U(2) << 29)
 #define OCR_ACCESS_MODE_MASK		(U(3) << 29)
+#define OCR_S18R			BIT(24)
 #define OCR_3_5_3_6			BIT(23)
 #define OCR_3_4_3_5			BIT(22)
 #define OCR_3_3_3_4			BIT(21)
@@ -60,8 +61,13 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_PART_SWITCH_TIME	199
 #define CMD_EXTCSD_SEC_CNT		212
+#define CMD_EXTCSD_BOOT_SIZE_MULT	226
+
+/* Unit of the boot partition size, 128KB */
+#define MMC_BOOT_SIZE_MULT_UNIT		U(0x20000)
 
 #define EXT_CSD_PART_CONFIG_ACC_MASK	GENMASK(2, 0)
 #define PART_CFG_BOOT_PARTITION1_ENABLE	(U(1) << 3)
@@ -80,6 +86,11 @@
 #define MMC_BOOT_MODE_BACKWARD		(U(0) << 3)
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
+#define MMC_HS_TIMING_HS		U(1)
+#define MMC_HS_TIMING_HS200		U(2)
+#define MMC_DEVICE_TYPE_HS_52		BIT(1)
+#define MMC_DEVICE_TYPE_DDR_52_1V8_3V	BIT(2)
+#define MMC_DEVICE_TYPE_HS200_1V8	BIT(4)
 
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
@@ -111,16 +122,35 @@
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
 #define MMC_FLAG_SD_CMD6		(U(1) << 1)
+#define MMC_FLAG_EMMC_HS		(U(1) << 2)
+#define MMC_FLAG_EMMC_DDR52		(U(1) << 3)
+#define MMC_FLAG_EMMC_HS200		(U(1) << 4)
+/* Use CMD23 if the card supports it, MMC_FLAG_CMD23 forces it */
+#define MMC_FLAG_CMD23_AUTO		(U(1) << 5)
+#define MMC_FLAG_SD_SDR50		(U(1) << 6)
+#define MMC_FLAG_SD_SDR104		(U(1) << 7)
+
+#define MMC_HS_52_MAX_FREQ		U(52000000)
+#define MMC_HS200_MAX_FREQ		U(200000000)
+#define SD_SDR25_MAX_FREQ		U(50000000)
+#define SD_SDR50_MAX_FREQ		U(100000000)
+#define SD_SDR104_MAX_FREQ		U(208000000)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
 
 #define SD_SCR_BUS_WIDTH_1		BIT(8)
 #define SD_SCR_BUS_WIDTH_4		BIT(10)
+#define SD_SCR_CMD23_SUPPORT		BIT(25)
 
 #define SD_SWITCH_FUNC_CHECK		0U
 #define SD_SWITCH_FUNC_SWITCH		1U
 
+/* Access mode functions of the switch function group 1 */
+#define SD_SWITCH_FUNC_SDR25		1U
+#define SD_SWITCH_FUNC_SDR50		2U
+#define SD_SWITCH_FUNC_SDR104		3U
+
 struct mmc_cmd {
 	unsigned int	cmd_idx;
 	unsigned int	cmd_arg;
@@ -135,6 +165,16 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional, HS200, SDR50 and SDR104 sampling point tuning with
+	 * mmc_send_tuning()
+	 */
+	int (*execute_tuning)(void);
+	/*
+	 * Optional, switch the IO lines to 1.8V once CMD11 is accepted, and
+	 * check that the card completed the switch. Required for SD UHS-I.
+	 */
+	int (*voltage_switch)(void);
 };
 
 struct mmc_csd_emmc {
@@ -256,14 +296,44 @@ struct mmc_device_info {
 };
 
 size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size);
+/*
+ * Split-phase read: mmc_read_blocks_start() sends the read command and
+ * returns while the data transfer is ongoing, mmc_read_blocks_wait() waits
+ * for its completion and returns the read size, or 0 on error. No other
+ * MMC operation can be issued in between.
+ */
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t mmc_read_blocks_wait(void);
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_erase_blocks(int lba, size_t size);
 size_t mmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
 size_t mmc_rpmb_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_rpmb_erase_blocks(int lba, size_t size);
+/*
+ * Boot partition reads leave the partition selected, the next user area
+ * access switches back to it.
+ */
 size_t mmc_boot_part_read_blocks(int lba, uintptr_t buf, size_t size);
+int mmc_boot_part_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t mmc_boot_part_size(void);
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info);
+/*
+ * Split-phase init: mmc_init_start() resets the card and starts its power-up,
+ * mmc_init_poll() returns -EAGAIN while the card is busy, and completes the
+ * identification once it is ready. The card power-up can take tens of
+ * milliseconds, the caller can do other things in between.
+ */
+int mmc_init_start(const struct mmc_ops *ops_ptr, unsigned int clk,
+		   unsigned int width, unsigned int flags,
+		   struct mmc_device_info *device_info);
+int mmc_init_poll(void);
+/*
+ * Send CMD21 (eMMC) or CMD19 (SD) and check the received tuning block, for
+ * the execute_tuning() callback. Return 0 if the current sampling point is
+ * valid.
+ */
+int mmc_send_tuning(void);
 
 #endif /* MMC_H */
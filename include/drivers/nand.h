@@ -31,6 +31,13 @@ struct nand_device {
 	int (*mtd_block_is_bad)(unsigned int block);
 	int (*mtd_read_page)(struct nand_device *nand, unsigned int page,
 			     uintptr_t buffer);
+	/*
+	 * Optional: read nb_pages consecutive full pages from the same block
+	 * using the device sequential/cache read commands, so that the array
+	 * read of the next page overlaps the transfer of the current one.
+	 */
+	int (*mtd_read_pages)(struct nand_device *nand, unsigned int page,
+			      unsigned int nb_pages, uintptr_t buffer);
 };
 
 void plat_get_scratch_buffer(void **buffer_addr, size_t *buf_size);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,7 @@
 #define DRIVERS_RAW_NAND_H
 
 #include <cdefs.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <drivers/nand.h>
@@ -66,15 +67,26 @@
 #define NAND_CMD_CHANGE_1ST		0x05U
 #define NAND_CMD_READID_SIG_ADDR	0x20U
 #define NAND_CMD_READ_2ND		0x30U
+#define NAND_CMD_READ_CACHE_SEQ		0x31U
+#define NAND_CMD_READ_CACHE_END		0x3FU
 #define NAND_CMD_STATUS			0x70U
 #define NAND_CMD_READID			0x90U
 #define NAND_CMD_CHANGE_2ND		0xE0U
 #define NAND_CMD_READ_PARAM_PAGE	0xECU
+#define NAND_CMD_GET_FEATURES		0xEEU
+#define NAND_CMD_SET_FEATURES		0xEFU
 #define NAND_CMD_RESET			0xFFU
 
 #define ONFI_REV_21			BIT(3)
 #define ONFI_FEAT_BUS_WIDTH_16		BIT(0)
 #define ONFI_FEAT_EXTENDED_PARAM	BIT(7)
+#define ONFI_OPT_CMD_READ_CACHE		BIT(1)
+#define ONFI_OPT_CMD_SET_GET_FEATURES	BIT(2)
+
+/* ONFI features */
+#define ONFI_FEATURE_ADDR_TIMING_MODE	0x01U
+#define ONFI_SUBFEATURE_PARAM_LEN	4U
+#define ONFI_SDR_TIMING_MODES		6U
 
 /* NAND ECC type */
 #define NAND_ECC_NONE			U(0)
@@ -158,14 +170,48 @@ struct nand_param_page {
 	uint16_t crc16;
 } __packed;
 
+/* ONFI SDR interface timings, in picoseconds */
+struct nand_sdr_timings {
+	unsigned long tADL_min;
+	unsigned long tALH_min;
+	unsigned long tAR_min;
+	unsigned long tCH_min;
+	unsigned long tCLH_min;
+	unsigned long tCLR_min;
+	unsigned long tCOH_min;
+	unsigned long tCS_min;
+	unsigned long tDH_min;
+	unsigned long tDS_min;
+	unsigned long tRC_min;
+	unsigned long tREA_max;
+	unsigned long tREH_min;
+	unsigned long tRHW_min;
+	unsigned long tRP_min;
+	unsigned long tWB_max;
+	unsigned long tWC_min;
+	unsigned long tWH_min;
+	unsigned long tWHR_min;
+	unsigned long tWP_min;
+};
+
 struct nand_ctrl_ops {
 	int (*exec)(struct nand_req *req);
 	void (*setup)(struct nand_device *nand);
+	/*
+	 * Optional: program the interface timings, or only check them if
+	 * check_only is set. Return -ENOTSUP if the controller cannot reach
+	 * them.
+	 */
+	int (*setup_timings)(const struct nand_sdr_timings *timings,
+			     bool check_only);
 };
 
 struct rawnand_device {
 	struct nand_device *nand_dev;
 	const struct nand_ctrl_ops *ops;
+	bool read_cache; /* Device supports READ CACHE SEQUENTIAL/END */
+	bool set_features; /* Device supports SET/GET FEATURES */
+	uint16_t sdr_timing_modes; /* Bit n set if ONFI timing mode n works */
 };
 
 int nand_raw_init(unsigned long long *size, unsigned int *erase_size);
@@ -174,7 +220,9 @@ int nand_read_page_cmd(unsigned int page, unsigned int offset,
 		       uintptr_t buffer, unsigned int len);
 int nand_change_read_column_cmd(unsigned int offset, uintptr_t buffer,
 				unsigned int len);
+int nand_read_cache_cmd(bool last, uintptr_t buffer, unsigned int len);
 void nand_raw_ctrl_init(const struct nand_ctrl_ops *ops);
+const struct nand_sdr_timings *nand_onfi_sdr_timings(unsigned int mode);
 
 /*
  * Platform can implement this to override default raw NAND instance
@@ -52,11 +52,11 @@ struct rdev *regulator_get_by_supply_name(const void *fdt, int node, const char
 
 int regulator_enable(struct rdev *rdev);
 int regulator_disable(struct rdev *rdev);
-int regulator_is_enabled(const struct rdev *rdev);
+int regulator_is_enabled(struct rdev *rdev);
 
 int regulator_set_voltage(struct rdev *rdev, uint16_t volt);
 int regulator_set_min_voltage(struct rdev *rdev);
-int regulator_get_voltage(const struct rdev *rdev);
+int regulator_get_voltage(struct rdev *rdev);
 
 int regulator_list_voltages(const struct rdev *rdev, const uint16_t **levels, size_t *count);
 void regulator_get_range(const struct rdev *rdev, uint16_t *min_mv, uint16_t *max_mv);
@@ -97,6 +97,8 @@ struct regul_ops {
 #if defined(IMAGE_BL32)
 	int (*suspend)(const struct regul_description *desc, uint8_t state,
 		       uint16_t mv);
+	int (*batch_start)(const struct regul_description *desc);
+	int (*batch_commit)(const struct regul_description *desc);
 #endif
 };
 
@@ -118,6 +120,11 @@ struct rdev {
 	uint16_t flags;
 
 	uint32_t enable_ramp_delay;
+
+	/* Last voltage and state read from or written to the regulator */
+	uint16_t cached_mv;
+	bool cached_state;
+	uint8_t cache_flags;
 #if defined(IMAGE_BL32)
 	const char *reg_name;
 
@@ -143,6 +150,14 @@ int regulator_core_cleanup(void);
 int regulator_core_suspend(int mode);
 int regulator_core_resume(void);
 
+/*
+ * Group regulator changes: drivers may defer their writes until the batch is
+ * committed, and the enable ramp delays are waited for once, on commit.
+ * Batches can be nested, only the outermost commit applies the changes.
+ */
+int regulator_core_batch_start(void);
+int regulator_core_batch_commit(void);
+
 void regulator_core_backup_context(void *backup_area, size_t backup_size);
 void regulator_core_restore_context(void *backup_area, size_t backup_size);
 
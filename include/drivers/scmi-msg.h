@@ -11,6 +11,11 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/* Count the messages processed, with their processing time */
+#ifndef SCMI_MSG_STATS
+#define SCMI_MSG_STATS		0
+#endif
+
 /* Minimum size expected for SMT based shared memory message buffers */
 #define SMT_BUF_SLOT_SIZE	128U
 
@@ -22,14 +27,20 @@ struct scmi_msg_channel;
  *
  * @shm_addr: Address of the shared memory for the SCMI channel
  * @shm_size: Byte size of the shared memory for the SCMI channel
- * @busy: True when channel is busy, flase when channel is free
+ * @busy: True when channel is busy, flase when channel is free, only accessed
+ *	with atomic operations
  * @agent_name: Agent name, SCMI protocol exposes 16 bytes max, or NULL
+ * @p2a_shm_addr: Address of the shared memory for server-to-agent delayed
+ *	responses, or 0 if the agent does not support them
+ * @p2a_shm_size: Byte size of the shared memory for delayed responses
  */
 struct scmi_msg_channel {
 	uintptr_t shm_addr;
 	size_t shm_size;
 	bool busy;
 	const char *agent_name;
+	uintptr_t p2a_shm_addr;
+	size_t p2a_shm_size;
 };
 
 /*
@@ -49,6 +60,27 @@ void scmi_smt_init_agent_channel(struct scmi_msg_channel *chan);
  */
 void scmi_smt_fastcall_smc_entry(unsigned int agent_id);
 
+/* Maximum number of payload words of a message passed in registers */
+#define SCMI_REGS_PAYLOAD_U32_MAX	4U
+
+/*
+ * Process a message passed in registers, without shared memory, in a fastcall
+ * SMC execution context. Only a few short messages are supported: the clock
+ * CLOCK_RATE_GET and the performance PERFORMANCE_LEVEL_GET/SET messages.
+ * The message shares the ownership of the SMT channel of the agent.
+ *
+ * @agent_id: SCMI agent ID
+ * @msg_header: Message header, in SMT format: message, protocol and token
+ * @in: Request payload, SCMI_REGS_PAYLOAD_U32_MAX words
+ * @out: Response payload, SCMI_REGS_PAYLOAD_U32_MAX words
+ * @out_size: Output byte length of the response payload
+ * Return 0 on success, -ENOTSUP if the message cannot be passed in registers,
+ * -ENOENT if the agent has no channel or -EBUSY if its channel is busy
+ */
+int scmi_regs_fastcall_entry(unsigned int agent_id, uint32_t msg_header,
+			     const uint32_t *in, uint32_t *out,
+			     size_t *out_size);
+
 /*
  * Process SMT formatted message in a secure interrupt execution context.
  * Called by platform interrupt handler. When returning, output message is
@@ -58,6 +90,50 @@ void scmi_smt_fastcall_smc_entry(unsigned int agent_id);
  */
 void scmi_smt_interrupt_entry(unsigned int agent_id);
 
+/*
+ * Complete the operations deferred by asynchronous agent requests and
+ * post their delayed responses. Called by platform from the execution
+ * context raised by plat_scmi_delayed_response_kick().
+ */
+void scmi_delayed_response_process(void);
+
+#if SCMI_MSG_STATS
+/* Messages counted per agent, from SCMI_PROTOCOL_ID_BASE, and per ID */
+#ifndef SCMI_MSG_STATS_AGENTS
+#define SCMI_MSG_STATS_AGENTS		3U
+#endif
+#define SCMI_MSG_STATS_PROTOCOLS	7U
+#define SCMI_MSG_STATS_MESSAGES		12U
+
+/*
+ * struct scmi_msg_stats - Processing statistics of a message
+ *
+ * @count: Number of messages processed
+ * @max_ticks: Longest processing, in system counter ticks
+ * @total_ticks: Cumulated processing time, in system counter ticks
+ */
+struct scmi_msg_stats {
+	uint32_t count;
+	uint32_t max_ticks;
+	uint64_t total_ticks;
+};
+
+/*
+ * Get the statistics of a message of an agent
+ * Return 0 on success, -EINVAL if the message is not counted
+ */
+int scmi_msg_stats_get(unsigned int agent_id, unsigned int protocol_id,
+		       unsigned int message_id, struct scmi_msg_stats *stats);
+
+/* Get how many times a message was dropped as the agent channel was busy */
+uint32_t scmi_msg_stats_get_busy(unsigned int agent_id);
+
+void scmi_msg_stats_reset(void);
+
+/* Print the statistics of the messages processed at least once */
+void scmi_msg_stats_dump(void);
+#endif /* SCMI_MSG_STATS */
+
 /* Platform callback functions */
 
 /*
@@ -67,6 +143,20 @@ void scmi_smt_interrupt_entry(unsigned int agent_id);
  */
 struct scmi_msg_channel *plat_scmi_get_channel(unsigned int agent_id);
 
+/*
+ * Request platform to call scmi_delayed_response_process() from an
+ * execution context other than the current agent request.
+ * Return true on success, false if delayed responses are not supported
+ */
+bool plat_scmi_delayed_response_kick(void);
+
+/*
+ * Notify an agent that a delayed response is available in its
+ * server-to-agent channel
+ * @agent_id: SCMI agent ID
+ */
+void plat_scmi_delayed_response_notify(unsigned int agent_id);
+
 /*
  * Return how many SCMI protocols supported by the platform
  * According to the SCMI specification, this function does not target
@@ -167,6 +257,99 @@ int32_t plat_scmi_clock_get_state(unsigned int agent_id, unsigned int scmi_id);
 int32_t plat_scmi_clock_set_state(unsigned int agent_id, unsigned int scmi_id,
 				  bool enable_not_disable);
 
+/* Handlers for SCMI Performance Domain protocol services */
+
+/*
+ * Return number of performance domains for an agent
+ * @agent_id: SCMI agent ID
+ * Return number of performance domains
+ */
+size_t plat_scmi_perf_count(unsigned int agent_id);
+
+/*
+ * Get performance domain string ID (aka name)
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * Return pointer to name or NULL
+ */
+const char *plat_scmi_perf_get_name(unsigned int agent_id,
+				    unsigned int scmi_id);
+
+/*
+ * Get performance domain levels, in ascending order. Levels are the
+ * domain frequencies in kHz.
+ *
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @start_index: Index of the first level to return
+ * @levels: If NULL, function returns the number of levels in @nb_elts,
+ *	else output levels array
+ * @nb_elts: Array size of @levels, updated with the number of levels set
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_levels_array(unsigned int agent_id,
+				    unsigned int scmi_id, size_t start_index,
+				    unsigned int *levels, size_t *nb_elts);
+
+/*
+ * Get current performance level of a domain
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @level: Output current level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_level_get(unsigned int agent_id, unsigned int scmi_id,
+				 unsigned int *level);
+
+/*
+ * Set performance level of a domain, including the related voltage change
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @level: Target level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_level_set(unsigned int agent_id, unsigned int scmi_id,
+				 unsigned int level);
+
+/* Handlers for SCMI Sensor protocol services */
+
+/*
+ * Return number of sensors for an agent
+ * @agent_id: SCMI agent ID
+ * Return number of sensors
+ */
+size_t plat_scmi_sensor_count(unsigned int agent_id);
+
+/*
+ * Get sensor string ID (aka name)
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI sensor ID
+ * Return pointer to name or NULL
+ */
+const char *plat_scmi_sensor_get_name(unsigned int agent_id,
+				      unsigned int scmi_id);
+
+/*
+ * Get the unit of a sensor values
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI sensor ID
+ * @type: Output SCMI sensor type, that is the value unit
+ * @scale: Output power-of-10 exponent applied to the unit, from -16 to 15
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_sensor_get_unit(unsigned int agent_id, unsigned int scmi_id,
+				  unsigned int *type, int *scale);
+
+/*
+ * Read the current value of a sensor
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI sensor ID
+ * @value: Output sensor value, in the sensor unit and scale
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_sensor_reading_get(unsigned int agent_id,
+				     unsigned int scmi_id, int64_t *value);
+
 /* Handlers for SCMI Reset Domain protocol services */
 
 /*
@@ -204,4 +387,31 @@ int32_t plat_scmi_rstd_autonomous(unsigned int agent_id, unsigned int scmi_id,
 int32_t plat_scmi_rstd_set_state(unsigned int agent_id, unsigned int scmi_id,
 				 bool assert_not_deassert);
 
+/* Maximum number of reset domains in a group request (vendor extension) */
+#define SCMI_RESET_DOMAIN_GROUP_MAX	16U
+
+/*
+ * Perform a reset cycle on several reset domains at once (vendor extension)
+ * @agent_id: SCMI agent ID
+ * @scmi_id: Array of SCMI reset domain IDs
+ * @count: Number of IDs in @scmi_id
+ * @state: Target reset state (see SCMI specification, 0 means context loss)
+ * Return a compliant SCMI error code
+ */
+int32_t plat_scmi_rstd_group_autonomous(unsigned int agent_id,
+					const uint32_t *scmi_id, size_t count,
+					unsigned int state);
+
+/*
+ * Assert or deassert several reset domains at once (vendor extension)
+ * @agent_id: SCMI agent ID
+ * @scmi_id: Array of SCMI reset domain IDs
+ * @count: Number of IDs in @scmi_id
+ * @assert_not_deassert: Assert domains if true, otherwise deassert domains
+ * Return a compliant SCMI error code
+ */
+int32_t plat_scmi_rstd_group_set_state(unsigned int agent_id,
+				       const uint32_t *scmi_id, size_t count,
+				       bool assert_not_deassert);
+
 #endif /* SCMI_MSG_H */
@@ -26,4 +26,8 @@
 #define SCMI_HARDWARE_ERROR		(-9)
 #define SCMI_PROTOCOL_ERROR		(-10)
 
+/* SCMI sensor types, that are the units of the sensor values */
+#define SCMI_SENSOR_TYPE_DEGREES_C	2U
+#define SCMI_SENSOR_TYPE_VOLTS		5U
+
 #endif /* SCMI_MSG_SCMI_H */
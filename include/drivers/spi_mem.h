@@ -82,6 +82,7 @@ struct spi_mem_op {
 #define SPI_TX_QUAD	BIT(7)			/* transmit with 4 wires */
 #define SPI_RX_DUAL	BIT(8)			/* receive with 2 wires */
 #define SPI_RX_QUAD	BIT(9)			/* receive with 4 wires */
+#define SPI_DUAL_FLASH	BIT(10)			/* 2 devices in parallel */
 
 struct spi_bus_ops {
 	/*
@@ -121,9 +122,27 @@ struct spi_bus_ops {
 	 * Returns: 0 on success, a negative error code otherwise.
 	 */
 	int (*exec_op)(const struct spi_mem_op *op);
+
+	/*
+	 * Map a read operation in the memory, for reads by a DMA. Optional.
+	 *
+	 * @op:	The read operation, with the address and size of the range.
+	 * @addr: Filled with the address of the range in the memory.
+	 * Returns: 0 on success, a negative error code otherwise.
+	 */
+	int (*mm_map)(const struct spi_mem_op *op, uintptr_t *addr);
+
+	/*
+	 * Stop the memory mapped reads started by mm_map.
+	 */
+	void (*mm_unmap)(void);
 };
 
+bool spi_mem_supports_op(const struct spi_mem_op *op);
+bool spi_mem_is_dual_flash(void);
 int spi_mem_exec_op(const struct spi_mem_op *op);
+int spi_mem_mm_map(const struct spi_mem_op *op, uintptr_t *addr);
+void spi_mem_mm_unmap(void);
 int spi_mem_init_slave(void *fdt, int bus_node,
 		       const struct spi_bus_ops *ops);
 
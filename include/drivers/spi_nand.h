@@ -14,10 +14,13 @@
 #define SPI_NAND_OP_SET_FEATURE		0x1FU
 #define SPI_NAND_OP_READ_ID		0x9FU
 #define SPI_NAND_OP_LOAD_PAGE		0x13U
+#define SPI_NAND_OP_READ_CACHE_RANDOM	0x30U
+#define SPI_NAND_OP_READ_CACHE_LAST	0x3FU
 #define SPI_NAND_OP_RESET		0xFFU
 #define SPI_NAND_OP_READ_FROM_CACHE	0x03U
 #define SPI_NAND_OP_READ_FROM_CACHE_2X	0x3BU
 #define SPI_NAND_OP_READ_FROM_CACHE_4X	0x6BU
+#define SPI_NAND_OP_READ_FROM_CACHE_QUAD_IO	0xEBU
 
 /* Configuration register */
 #define SPI_NAND_REG_CFG		0xB0U
@@ -33,6 +36,7 @@ struct spinand_device {
 	struct nand_device *nand_dev;
 	struct spi_mem_op spi_read_cache_op;
 	uint8_t cfg_cache; /* Cached value of SPI NAND device register CFG */
+	bool read_cache; /* Device supports READ PAGE CACHE RANDOM/LAST */
 };
 
 int spi_nand_init(unsigned long long *size, unsigned int *erase_size);
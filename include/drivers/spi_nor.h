@@ -18,6 +18,7 @@
 #define SPI_NOR_OP_READ_FSR	0x70U	/* Read flag status register */
 #define SPINOR_OP_RDEAR		0xC8U	/* Read Extended Address Register */
 #define SPINOR_OP_WREAR		0xC5U	/* Write Extended Address Register */
+#define SPI_NOR_OP_READ_SFDP	0x5AU	/* Read SFDP parameters */
 
 /* Used for Spansion flashes only. */
 #define SPINOR_OP_BRWR		0x17U	/* Bank register write */
@@ -30,9 +31,21 @@
 #define SPI_NOR_OP_READ_1_1_4	0x6BU	/* Read data bytes (Quad Output SPI) */
 #define SPI_NOR_OP_READ_1_4_4	0xEBU	/* Read data bytes (Quad I/O SPI) */
 
+/* 4-byte address opcodes */
+#define SPI_NOR_OP_READ_4B	0x13U	/* Read data bytes (low frequency) */
+#define SPI_NOR_OP_READ_FAST_4B	0x0CU	/* Read data bytes (high frequency) */
+#define SPI_NOR_OP_READ_1_1_2_4B 0x3CU	/* Read data bytes (Dual Output SPI) */
+#define SPI_NOR_OP_READ_1_2_2_4B 0xBCU	/* Read data bytes (Dual I/O SPI) */
+#define SPI_NOR_OP_READ_1_1_4_4B 0x6CU	/* Read data bytes (Quad Output SPI) */
+#define SPI_NOR_OP_READ_1_4_4_4B 0xECU	/* Read data bytes (Quad I/O SPI) */
+
 /* Flags for NOR specific configuration */
 #define SPI_NOR_USE_FSR		BIT(0)
 #define SPI_NOR_USE_BANK	BIT(1)
+/* Select the read operation from the SFDP tables of the device */
+#define SPI_NOR_USE_SFDP	BIT(2)
+/* Two identical devices in parallel, set from the bus configuration */
+#define SPI_NOR_DUAL_FLASH	BIT(3)
 
 struct nor_device {
 	struct spi_mem_op read_op;
@@ -46,6 +59,8 @@ struct nor_device {
 int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
 		 size_t *length_read);
 int spi_nor_init(unsigned long long *device_size, unsigned int *erase_size);
+int spi_nor_mm_map(unsigned int offset, size_t length, uintptr_t *addr);
+void spi_nor_mm_unmap(void);
 
 /*
  * Platform can implement this to override default NOR instance configuration.
@@ -97,6 +97,7 @@ uint32_t bsec_set_config(struct bsec_config *cfg);
 uint32_t bsec_get_config(struct bsec_config *cfg);
 
 uint32_t bsec_shadow_register(uint32_t otp);
+uint32_t bsec_shadow_range(uint32_t first, uint32_t count);
 uint32_t bsec_read_otp(uint32_t *val, uint32_t otp);
 uint32_t bsec_write_otp(uint32_t val, uint32_t otp);
 uint32_t bsec_program_otp(uint32_t val, uint32_t otp);
@@ -125,5 +126,6 @@ uint32_t bsec_otp_lock(uint32_t service);
 
 uint32_t bsec_shadow_read_otp(uint32_t *otp_value, uint32_t word);
 uint32_t bsec_check_nsec_access_rights(uint32_t otp);
+uint32_t bsec_check_nsec_access_rights_range(uint32_t first, uint32_t count);
 
 #endif /* BSEC_H */
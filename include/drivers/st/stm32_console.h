@@ -11,6 +11,7 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*
@@ -22,6 +23,13 @@
 int console_stm32_register(uintptr_t baseaddr, uint32_t clock, uint32_t baud,
 			   console_t *console);
 
+/*
+ * Output |len| characters of |buf| on an STM32 console registered with
+ * console_stm32_register(), queued in the UART TX FIFO as soon as it has room.
+ * Returns |len| on success, -1 on error.
+ */
+int console_stm32_write(console_t *console, const char *buf, size_t len);
+
 #endif /*__ASSEMBLER__*/
 
 #endif /* STM32_CONSOLE_H */
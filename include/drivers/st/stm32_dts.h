@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32_DTS_H
+#define STM32_DTS_H
+
+/*
+ * Probe the digital temperature sensor and start its continuous measurement.
+ * Return 1 if the secure world owns the sensor, 0 if not, a negative errno
+ * compliant value on failure.
+ */
+int stm32_dts_init(void);
+
+/* Get the last measured temperature in millidegree Celsius */
+int stm32_dts_get_temp(int *mcelsius);
+
+#endif /* STM32_DTS_H */
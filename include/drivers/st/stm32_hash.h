@@ -7,6 +7,22 @@
 #ifndef STM32_HASH_H
 #define STM32_HASH_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Context swap registers HASH_CSRx, the SHA-512 ones included on STM32MP13,
+ * and largest first block, with its extra word.
+ */
+#if STM32MP13
+#define HASH_CSR_NB		103U
+#define HASH_CTX_BLOCK_MAX	(128U + sizeof(uint32_t))
+#else
+#define HASH_CSR_NB		54U
+#define HASH_CTX_BLOCK_MAX	(64U + sizeof(uint32_t))
+#endif
+
 enum stm32_hash_algo_mode {
 #if STM32MP15
 	HASH_MD5SUM,
@@ -20,6 +36,28 @@ enum stm32_hash_algo_mode {
 #endif
 };
 
+/*
+ * struct stm32_hash_context - Digest interleaved with others on the HASH
+ * @imr, @str, @cr, @csr: Peripheral registers, saved when another digest
+ *			  uses the peripheral
+ * @block: Data not written yet, less than a block and its extra word
+ * @block_len: Number of bytes in @block
+ * @digest_size: Digest size in bytes
+ * @mode: Algorithm
+ * @started: A first block was written to the peripheral
+ */
+struct stm32_hash_context {
+	uint32_t imr;
+	uint32_t str;
+	uint32_t cr;
+	uint32_t csr[HASH_CSR_NB];
+	uint8_t block[HASH_CTX_BLOCK_MAX];
+	size_t block_len;
+	size_t digest_size;
+	enum stm32_hash_algo_mode mode;
+	bool started;
+};
+
 int stm32_hash_update(const uint8_t *buffer, size_t length);
 int stm32_hash_final(uint8_t *digest);
 int stm32_hash_final_update(const uint8_t *buffer, uint32_t buf_length,
@@ -27,4 +65,10 @@ int stm32_hash_final_update(const uint8_t *buffer, uint32_t buf_length,
 void stm32_hash_init(enum stm32_hash_algo_mode mode);
 int stm32_hash_register(void);
 
+void stm32_hash_ctx_init(struct stm32_hash_context *ctx,
+			 enum stm32_hash_algo_mode mode);
+int stm32_hash_ctx_update(struct stm32_hash_context *ctx,
+			  const uint8_t *buffer, size_t length);
+int stm32_hash_ctx_final(struct stm32_hash_context *ctx, uint8_t *digest);
+
 #endif /* STM32_HASH_H */
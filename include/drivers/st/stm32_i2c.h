@@ -244,6 +244,8 @@ struct i2c_handle_s {
 	uint32_t i2c_err;			/* Error code             */
 	uint32_t saved_timing;			/* Saved timing value     */
 	uint32_t saved_frequency;		/* Saved frequency value  */
+	int irq_event;				/* Event IT, <0 if polled */
+	int irq_error;				/* Error IT, <0 if polled */
 };
 
 #define I2C_ADDRESSINGMODE_7BIT		0x00000001U
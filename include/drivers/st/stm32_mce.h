@@ -31,6 +31,8 @@ struct stm32_mce_region_s {
 };
 
 void stm32_mce_init(void);
+int stm32_mce_configure_regions(const struct stm32_mce_region_s *regions,
+				uint32_t nb_regions);
 
 int stm32_mce_write_master_key(uint8_t *mkey);
 void stm32_mce_lock_master_key(void);
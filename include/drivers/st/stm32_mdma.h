@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32_MDMA_H
+#define STM32_MDMA_H
+
+#include <cdefs.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Maximum number of bytes of a descriptor */
+#define STM32_MDMA_MAX_LEN		0x10000U
+
+/* No hardware request: the transfer is started by software */
+#define STM32_MDMA_SW_REQUEST		(-1)
+
+/*
+ * Linked-list item, in the layout of the channel registers loaded from it.
+ * Items are aligned on a cache line, for the cache maintenance done on them.
+ */
+struct stm32_mdma_desc {
+	uint32_t ctcr;
+	uint32_t cbndtr;
+	uint32_t csar;
+	uint32_t cdar;
+	uint32_t cbrur;
+	uint32_t clar;
+	uint32_t ctbr;
+	uint32_t reserved;
+	uint32_t cmar;
+	uint32_t cmdr;
+} __aligned(64);
+
+/*
+ * Transfer of a descriptor:
+ * src, dst: source and destination addresses
+ * len: number of bytes, up to STM32_MDMA_MAX_LEN
+ * width: data size in bytes (1, 2, 4 or 8) of both source and destination
+ * src_inc, dst_inc: increment the address, false for a peripheral register
+ * request: hardware request of a peripheral, transferring one buffer each,
+ *	or STM32_MDMA_SW_REQUEST for a memory to memory transfer
+ * buffer_len: bytes moved per request, from width to 128; 0 for 128
+ */
+struct stm32_mdma_cfg {
+	uintptr_t src;
+	uintptr_t dst;
+	size_t len;
+	unsigned int width;
+	bool src_inc;
+	bool dst_inc;
+	int request;
+	unsigned int buffer_len;
+};
+
+int stm32_mdma_init(void);
+int stm32_mdma_get_channel(void);
+void stm32_mdma_put_channel(unsigned int channel);
+int stm32_mdma_desc_fill(struct stm32_mdma_desc *desc,
+			 const struct stm32_mdma_cfg *cfg);
+void stm32_mdma_desc_link(struct stm32_mdma_desc *desc,
+			  struct stm32_mdma_desc *next);
+int stm32_mdma_start(unsigned int channel, struct stm32_mdma_desc *desc);
+int stm32_mdma_poll(unsigned int channel);
+int stm32_mdma_wait(unsigned int channel, uint32_t timeout_us);
+void stm32_mdma_abort(unsigned int channel);
+int stm32_mdma_memcpy(uintptr_t dst, uintptr_t src, size_t size);
+
+/* Cache maintenance around a transfer of a cacheable buffer */
+void stm32_mdma_prepare_src(uintptr_t base, size_t size);
+void stm32_mdma_prepare_dst(uintptr_t base, size_t size);
+void stm32_mdma_complete_dst(uintptr_t base, size_t size);
+
+#endif /* STM32_MDMA_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2020-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -43,4 +43,22 @@ int stm32_pka_ecdsa_verif(void *hash, unsigned int hash_size,
 			  void *pk_y_ptr, unsigned int pk_y_size,
 			  enum stm32_pka_ecdsa_curve_id cid);
 
+/*
+ * Verify several signatures on the same curve without reloading
+ * the curve parameters: start, run for each signature, then end.
+ */
+int stm32_pka_ecdsa_verif_session_start(enum stm32_pka_ecdsa_curve_id cid);
+int stm32_pka_ecdsa_verif_session_run(void *hash, unsigned int hash_size,
+				      void *sig_r_ptr, unsigned int sig_r_size,
+				      void *sig_s_ptr, unsigned int sig_s_size,
+				      void *pk_x_ptr, unsigned int pk_x_size,
+				      void *pk_y_ptr, unsigned int pk_y_size);
+void stm32_pka_ecdsa_verif_session_end(void);
+
+#if PKA_USE_RSA
+int stm32_pka_rsa_public(const void *n, unsigned int n_size,
+			 const void *e, unsigned int e_size,
+			 const void *in, void *out);
+#endif
+
 #endif /* STM32_PKA_H */
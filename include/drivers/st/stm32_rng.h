@@ -7,7 +7,25 @@
 #ifndef STM32_RNG_H
 #define STM32_RNG_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 int stm32_rng_read(uint8_t *out, uint32_t size);
 int stm32_rng_init(void);
 
+#if STM32MP_RNG_POOL
+int stm32_rng_read_pool(uint8_t *out, uint32_t size);
+bool stm32_rng_it_handler(uint32_t id);
+#else
+static inline int stm32_rng_read_pool(uint8_t *out, uint32_t size)
+{
+	return stm32_rng_read(out, size);
+}
+
+static inline bool stm32_rng_it_handler(uint32_t id)
+{
+	return false;
+}
+#endif
+
 #endif /* STM32_RNG_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -64,8 +64,10 @@ struct stm32_rtc_time {
 };
 
 void stm32_rtc_get_calendar(struct stm32_rtc_calendar *calendar);
+void stm32_rtc_get_calendar_nowait(struct stm32_rtc_calendar *calendar);
 unsigned long long stm32_rtc_diff_calendar(struct stm32_rtc_calendar *current,
 					   struct stm32_rtc_calendar *ref);
+int stm32_rtc_get_alarm_delay(unsigned long long *delay_ms);
 void stm32_rtc_set_tamper_timestamp(void);
 bool stm32_rtc_is_timestamp_enable(void);
 void stm32_rtc_get_timestamp(struct stm32_rtc_time *tamp_ts);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -24,12 +24,15 @@ struct stm32_sdmmc2_params {
 	unsigned int		clock_id;
 	unsigned int		reset_id;
 	unsigned int		max_freq;
+	uintptr_t		dlyb_base;
 	bool			use_dma;
 	struct rdev		*vmmc_regu;
+	struct rdev		*vqmmc_regu;
 };
 
 unsigned long long stm32_sdmmc2_mmc_get_device_size(void);
 int stm32_sdmmc2_mmc_init(struct stm32_sdmmc2_params *params);
+int stm32_sdmmc2_mmc_init_start(struct stm32_sdmmc2_params *params);
 bool plat_sdmmc2_use_dma(unsigned int instance, unsigned int memory);
 
 #endif /* STM32_SDMMC2_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2018-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,10 +12,15 @@ enum timer_cal {
 	CSI_CAL
 };
 
+/* Completion callback of an asynchronous measurement, @freq is 0 on error */
+typedef void (*stm32_timer_freq_cb_t)(enum timer_cal type, unsigned long freq);
+
 unsigned long stm32_timer_hsi_freq(void);
 unsigned long stm32_timer_csi_freq(void);
 void stm32_timer_freq_func(unsigned long (**timer_freq_cb)(void),
 			   enum timer_cal type);
+int stm32_timer_freq_async(enum timer_cal type, unsigned int captures,
+			   stm32_timer_freq_cb_t cb);
 int stm32_timer_init(void);
 
 #endif /* STM32_TIMER_H */
@@ -7,6 +7,9 @@
 #ifndef STM32_UART_H
 #define STM32_UART_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* UART word length */
 #define STM32_UART_WORDLENGTH_7B		USART_CR1_M1
 #define STM32_UART_WORDLENGTH_8B		0x00000000U
@@ -153,7 +156,11 @@ int stm32_uart_init(struct stm32_uart_handle_s *huart,
 		    const struct stm32_uart_init_s *init);
 void stm32_uart_stop(uintptr_t base_addr);
 int stm32_uart_putc(struct stm32_uart_handle_s *huart, int c);
+int stm32_uart_write(struct stm32_uart_handle_s *huart, const uint8_t *buf,
+		     size_t len);
 int stm32_uart_flush(struct stm32_uart_handle_s *huart);
 int stm32_uart_getc(struct stm32_uart_handle_s *huart);
+int stm32_uart_read(struct stm32_uart_handle_s *huart, uint8_t *buf,
+		    size_t len, uint64_t timeout_us);
 
 #endif /* STM32_UART_H */
@@ -24,10 +24,17 @@ extern const char *stm32mp_osc_node_label[NB_OSC];
 
 #define PLL1_SETTINGS_VALID_ID	U(0x504C4C31) /* "PLL1" */
 
+/* Size of the PLL1 settings saved and loaded by the clock driver */
+#define PLL1_SETTINGS_SIZE	(((PLAT_MAX_OPP_NB * \
+				   (PLAT_MAX_PLLCFG_NB + 3)) + 1) * \
+				 sizeof(uint32_t))
+
 int stm32mp1_clk_probe(void);
 int stm32mp1_clk_init(uint32_t pll1_freq_mhz);
+void stm32mp1_clk_lse_wait_ready(void);
 
 int stm32mp1_clk_compute_all_pll1_settings(uint32_t buck1_voltage);
+bool stm32mp1_clk_pll1_settings_are_valid(void);
 void stm32mp1_clk_lp_save_opp_pll1_settings(uint8_t *data, size_t size);
 void stm32mp1_clk_lp_load_opp_pll1_settings(uint8_t *data, size_t size);
 
@@ -17,6 +17,12 @@ enum stm32mp1_ddr_sr_mode {
 	DDR_ASR_MODE,
 };
 
+enum stm32mp1_ddr_freq_mode {
+	DDR_FREQ_NOMINAL = 0,
+	DDR_FREQ_LOW,
+	DDR_FREQ_NB
+};
+
 void ddr_enable_clock(void);
 int ddr_sw_self_refresh_exit(void);
 uint32_t ddr_get_io_calibration_val(void);
@@ -24,5 +30,13 @@ int ddr_standby_sr_entry(void);
 enum stm32mp1_ddr_sr_mode ddr_read_sr_mode(void);
 void ddr_set_sr_mode(enum stm32mp1_ddr_sr_mode mode);
 bool ddr_is_nonsecured_area(uintptr_t address, uint32_t length);
+#if STM32MP_DDR_FREQ_SCALING
+int ddr_set_freq_mode(enum stm32mp1_ddr_freq_mode mode);
+enum stm32mp1_ddr_freq_mode ddr_get_freq_mode(void);
+#endif
+#if STM32MP_DDR_QOS_PROFILES
+int ddr_qos_set_profile(unsigned int id);
+int ddr_qos_get_profile(unsigned int *id, unsigned int *nb);
+#endif
 
 #endif /* STM32MP1_DDR_HELPERS_H */
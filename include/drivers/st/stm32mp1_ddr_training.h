@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_DDR_TRAINING_H
+#define STM32MP1_DDR_TRAINING_H
+
+#include <stdbool.h>
+
+#include <drivers/st/stm32mp1_ddr.h>
+
+#if STM32MP_DDR_TRAINING_CACHE
+/*
+ * Restore the DQS training results saved at a previous cold boot, with the
+ * same DDR settings and in the same temperature band. Return false when the
+ * training has to be run.
+ */
+bool stm32mp1_ddr_training_restore(struct stm32mp_ddr_priv *priv,
+				   const struct stm32mp_ddr_config *config);
+
+/* Save the DQS training results, once the DDR has been tested */
+void stm32mp1_ddr_training_save(struct stm32mp_ddr_priv *priv,
+				const struct stm32mp_ddr_config *config);
+
+/* Drop the saved results, so that the next cold boot runs the training */
+void stm32mp1_ddr_training_invalidate(void);
+#else
+static inline bool
+stm32mp1_ddr_training_restore(struct stm32mp_ddr_priv *priv,
+			      const struct stm32mp_ddr_config *config)
+{
+	return false;
+}
+
+static inline void
+stm32mp1_ddr_training_save(struct stm32mp_ddr_priv *priv,
+			   const struct stm32mp_ddr_config *config)
+{
+}
+
+static inline void stm32mp1_ddr_training_invalidate(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_DDR_TRAINING_H */
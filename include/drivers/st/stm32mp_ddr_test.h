@@ -7,9 +7,20 @@
 #ifndef STM32MP_DDR_TEST_H
 #define STM32MP_DDR_TEST_H
 
+#include <stdint.h>
+
 uint32_t stm32mp_ddr_test_rw_access(void);
 uint32_t stm32mp_ddr_test_data_bus(void);
 uint32_t stm32mp_ddr_test_addr_bus(uint64_t size);
 uint32_t stm32mp_ddr_check_size(void);
 
+#if STM32MP_DDR_FULL_TEST
+uint32_t stm32mp_ddr_test_full(uint32_t size);
+#else
+static inline uint32_t stm32mp_ddr_test_full(uint32_t size)
+{
+	return 0U;
+}
+#endif
+
 #endif /* STM32MP_DDR_TEST_H */
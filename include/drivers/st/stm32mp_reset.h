@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2018-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -47,6 +47,29 @@ static inline void stm32mp_reset_release(uint32_t reset_id)
 	(void)stm32mp_reset_deassert(reset_id, 0U);
 }
 
+/*
+ * Assert several resets at once: the set register of each RCC bank is written
+ * once, then, if @to_us non null, all resets are polled under a single timeout
+ *
+ * @reset_id: Array of reset controller IDs
+ * @count: Number of IDs in @reset_id
+ * @to_us: Timeout in microsecond, or 0 if not waiting
+ * Return 0 on success and -ETIMEDOUT if waiting and timeout expired
+ */
+int stm32mp_reset_assert_multi(const uint32_t *reset_id, unsigned int count,
+			       unsigned int to_us);
+
+/*
+ * Deassert several resets at once, see stm32mp_reset_assert_multi()
+ *
+ * @reset_id: Array of reset controller IDs
+ * @count: Number of IDs in @reset_id
+ * @to_us: Timeout in microsecond, or 0 if not waiting
+ * Return 0 on success and -ETIMEDOUT if waiting and timeout expired
+ */
+int stm32mp_reset_deassert_multi(const uint32_t *reset_id, unsigned int count,
+				 unsigned int to_us);
+
 /*
  * Manage reset control for the MCU reset
  *
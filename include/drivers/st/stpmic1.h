@@ -175,6 +175,8 @@
 int stpmic1_powerctrl_on(void);
 int stpmic1_switch_off(void);
 int stpmic1_register_read(uint8_t register_id, uint8_t *value);
+int stpmic1_register_read_multi(uint8_t register_id, uint8_t *values,
+				size_t count);
 int stpmic1_register_write(uint8_t register_id, uint8_t value);
 int stpmic1_register_update(uint8_t register_id, uint8_t value, uint8_t mask);
 int stpmic1_regulator_enable(const char *name);
@@ -184,6 +186,12 @@ int stpmic1_regulator_voltage_set(const char *name, uint16_t millivolts);
 int stpmic1_regulator_levels_mv(const char *name, const uint16_t **levels,
 				size_t *levels_count);
 int stpmic1_regulator_voltage_get(const char *name);
+/*
+ * Get the voltage of several regulators from a single I2C transfer.
+ * Disabled regulators and regulators without voltage setting read 0mV.
+ */
+int stpmic1_regulators_voltage_get(const char * const *names, int *millivolts,
+				   size_t count);
 int stpmic1_regulator_pull_down_set(const char *name);
 int stpmic1_regulator_mask_reset_set(const char *name);
 int stpmic1_regulator_icc_set(const char *name);
@@ -194,6 +202,13 @@ int stpmic1_lp_copy_reg(const char *name);
 int stpmic1_lp_reg_on_off(const char *name, uint8_t enable);
 int stpmic1_lp_set_mode(const char *name, uint8_t hplp);
 int stpmic1_lp_set_voltage(const char *name, uint16_t millivolts);
+/*
+ * Gather the buck and LDO control and low power register changes between the
+ * two calls, then write the changed registers in one I2C transfer per
+ * register range.
+ */
+int stpmic1_lp_batch_start(void);
+int stpmic1_lp_batch_commit(void);
 void stpmic1_bind_i2c(struct i2c_handle_s *i2c_handle, uint16_t i2c_addr);
 
 int stpmic1_get_version(unsigned long *version);
@@ -275,4 +275,7 @@
 #define CK_SCMI1_PLL3_R		1
 #define CK_SCMI1_MCU		2
 
+#define CK_SCMI2_PLL3_Q		0
+#define CK_SCMI2_PLL3_R		1
+
 #endif /* _DT_BINDINGS_STM32MP1_CLKS_H_ */
@@ -120,4 +120,8 @@
 #define RST_SCMI0_MCU		10
 #define RST_SCMI0_MCU_HOLD_BOOT	11
 
+#define RST_SCMI2_SPI6		0
+#define RST_SCMI2_I2C6		1
+#define RST_SCMI2_USART1	2
+
 #endif /* _DT_BINDINGS_STM32MP15_RESET_H_ */
@@ -25,6 +25,8 @@
 
 #define IMAGE_ATTRIB_SKIP_LOADING	U(0x02)
 #define IMAGE_ATTRIB_PLAT_SETUP		U(0x04)
+/* Image left to a later stage, BL2 only authenticates its parents */
+#define IMAGE_ATTRIB_DEFERRED		U(0x08)
 
 #define INVALID_IMAGE_ID		U(0xFFFFFFFF)
 
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BL2_LOAD_INSTR_H
+#define BL2_LOAD_INSTR_H
+
+#include <lib/pmf/pmf.h>
+#include <lib/utils_def.h>
+
+/*
+ * Timestamps taken by BL2 for each image it loads, indexed by image id:
+ * before the image is opened, before it is read, once it is closed and,
+ * with TRUSTED_BOARD_BOOT, once it is authenticated.
+ */
+#define BL2_LOAD_INSTR_OPEN		U(0)
+#define BL2_LOAD_INSTR_READ		U(1)
+#define BL2_LOAD_INSTR_CLOSE		U(2)
+#define BL2_LOAD_INSTR_AUTH		U(3)
+#define BL2_LOAD_INSTR_POINTS		U(4)
+
+#define BL2_LOAD_INSTR_TID(_id, _point)	\
+	(((_id) * BL2_LOAD_INSTR_POINTS) + (_point))
+#define BL2_LOAD_INSTR_TOTAL_IDS	(MAX_NUMBER_IDS * BL2_LOAD_INSTR_POINTS)
+
+#ifndef __ASSEMBLER__
+PMF_DECLARE_CAPTURE_TIMESTAMP(bl2_load_instr_svc)
+PMF_DECLARE_GET_TIMESTAMP(bl2_load_instr_svc)
+#endif /* __ASSEMBLER__ */
+
+#endif /* BL2_LOAD_INSTR_H */
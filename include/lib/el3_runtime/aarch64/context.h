@@ -63,7 +63,10 @@
 #define CTX_IS_IN_EL3		U(0x30)
 #define CTX_CPTR_EL3		U(0x38)
 #define CTX_ZCR_EL3		U(0x40)
-#define CTX_EL3STATE_END	U(0x50) /* Align to the next 16 byte boundary */
+#define CTX_LAZY_SIMD_AREA	U(0x48)
+/* SCR_EL3 value the EL2 and extension registers were last set up for */
+#define CTX_EXIT_SCR_EL3	U(0x50)
+#define CTX_EL3STATE_END	U(0x60) /* Align to the next 16 byte boundary */
 
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MPAM_MSC_H
+#define MPAM_MSC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+#include <platform_def.h>
+
+/* Memory-mapped registers of an MPAM memory-system component (MSC) */
+#define MPAMF_IDR			U(0x0000)
+#define MPAMF_CPOR_IDR			U(0x0030)
+#define MPAMF_MBW_IDR			U(0x0040)
+#define MPAMCFG_PART_SEL		U(0x0100)
+#define MPAMCFG_MBW_MIN			U(0x0200)
+#define MPAMCFG_MBW_MAX			U(0x0208)
+#define MPAMCFG_CPBM(n)			(U(0x1000) + ((n) * 4U))
+
+#define MPAMF_IDR_PARTID_MAX_MASK	ULL(0xFFFF)
+#define MPAMF_IDR_HAS_CPOR_PART		BIT_64(25)
+#define MPAMF_IDR_HAS_MBW_PART		BIT_64(26)
+#define MPAMF_CPOR_IDR_CPBM_WD_MASK	U(0xFFFF)
+#define MPAMF_MBW_IDR_BWA_WD_MASK	U(0x3F)
+#define MPAMF_MBW_IDR_HAS_MIN		BIT_32(10)
+#define MPAMF_MBW_IDR_HAS_MAX		BIT_32(11)
+#define MPAMCFG_MBW_MASK		U(0xFFFF)
+
+/* Largest cache portion bitmap handled, in bits */
+#define MPAM_MSC_CPBM_MAX_WD		U(64)
+
+#ifndef PLAT_MPAM_MSC_MAX
+#define PLAT_MPAM_MSC_MAX		U(8)
+#endif
+
+#ifndef PLAT_MPAM_MSC_MAX_PARTS
+#define PLAT_MPAM_MSC_MAX_PARTS		U(32)
+#endif
+
+/* Settings of a partition, and whether the non-secure world may update them */
+#define MPAM_MSC_PART_CPBM		BIT_32(0)
+#define MPAM_MSC_PART_MBW_MAX		BIT_32(1)
+#define MPAM_MSC_PART_MBW_MIN		BIT_32(2)
+#define MPAM_MSC_PART_RUNTIME		BIT_32(3)
+
+struct mpam_msc_part {
+	unsigned int msc;
+	unsigned int partid;
+	uint32_t flags;
+	uint64_t cpbm;
+	/* Bandwidth limits, in percent of the bandwidth of the MSC */
+	unsigned int mbw_max;
+	unsigned int mbw_min;
+};
+
+struct mpam_msc_topology {
+	uintptr_t msc_base[PLAT_MPAM_MSC_MAX];
+	unsigned int num_msc;
+	struct mpam_msc_part parts[PLAT_MPAM_MSC_MAX_PARTS];
+	unsigned int num_parts;
+};
+
+/* SiP function IDs of the MPAM MSC service */
+#define MPAM_MSC_FID_VALUE		U(0x40)
+#define MPAM_MSC_FID_MASK		U(0xFFF0)
+#define is_mpam_msc_fid(_fid)	\
+	(((_fid) & MPAM_MSC_FID_MASK) == MPAM_MSC_FID_VALUE)
+
+#define MPAM_MSC_FID_VERSION		U(0x82000040)
+#define MPAM_MSC_FID_GET		U(0xC2000041)
+#define MPAM_MSC_FID_SET_CPBM		U(0xC2000042)
+#define MPAM_MSC_FID_SET_MBW		U(0x82000043)
+#define MPAM_MSC_NUM_SMC_CALLS		4
+
+#define MPAM_MSC_VERSION_MAJOR		U(1)
+#define MPAM_MSC_VERSION_MINOR		U(0)
+
+/* Error codes of the MPAM MSC service */
+#define MPAM_MSC_E_SUCCESS		0
+#define MPAM_MSC_E_NOT_SUPPORTED	(-1)
+#define MPAM_MSC_E_INVALID_PARAMS	(-2)
+#define MPAM_MSC_E_DENIED		(-3)
+
+int mpam_msc_setup(void);
+uintptr_t mpam_msc_smc_handler(unsigned int smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3,
+			       u_register_t x4, void *cookie, void *handle,
+			       u_register_t flags);
+
+#endif /* MPAM_MSC_H */
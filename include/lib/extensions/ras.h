@@ -1,6 +1,7 @@
 /*
  * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
  * Copyright (c) 2020, NVIDIA Corporation. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -55,6 +56,30 @@
 		ERR_RECORD_COMMON_(_probe, _handler, _aux) \
 	}
 
+/*
+ * Error records in Standard Error Record format, probed 64 records at a time
+ * by the RAS framework. The handler is called once for each record in error.
+ */
+#define ERR_RECORD_MEMMAP_BATCH_V1(_base_addr, _size_num_k, _handler, _aux) \
+	{ \
+		.version = 1, \
+		.memmap.base_addr = _base_addr, \
+		.memmap.size_num_k = _size_num_k, \
+		.access = ERR_ACCESS_MEMMAP, \
+		.probe_batch = ras_err_ser_probe_batch_memmap, \
+		ERR_RECORD_COMMON_(ras_err_ser_probe_memmap, _handler, _aux) \
+	}
+
+#define ERR_RECORD_SYSREG_BATCH_V1(_idx_start, _num_idx, _handler, _aux) \
+	{ \
+		.version = 1, \
+		.sysreg.idx_start = _idx_start, \
+		.sysreg.num_idx = _num_idx, \
+		.access = ERR_ACCESS_SYSREG, \
+		.probe_batch = ras_err_ser_probe_batch_sysreg, \
+		ERR_RECORD_COMMON_(ras_err_ser_probe_sysreg, _handler, _aux) \
+	}
+
 /*
  * Macro to be used to name and declare an array of RAS interrupts along with
  * their handlers.
@@ -111,6 +136,15 @@ struct err_handler_data {
 	unsigned int interrupt;
 };
 
+/*
+ * Function to probe up to 64 records of an error record group for errors, from
+ * record 'first'. Bit i of 'pending' is set for the record 'first + i' in
+ * error. Returns the number of records probed, 0 past the end of the group.
+ */
+typedef unsigned int (*err_record_probe_batch_t)(
+		const struct err_record_info *info, unsigned int first,
+		uint64_t *pending);
+
 /* Function to handle error from an error record group */
 typedef int (*err_record_handler_t)(const struct err_record_info *info,
 		int probe_data, const struct err_handler_data *const data);
@@ -123,6 +157,13 @@ struct err_record_info {
 	/* Function to handle error record group errors */
 	err_record_handler_t handler;
 
+	/*
+	 * Optional function to probe the records of the group in batches. When
+	 * set, the handler is called for each record in error, with the index
+	 * of the record as probe data.
+	 */
+	err_record_probe_batch_t probe_batch;
+
 	/* Opaque group-specific data */
 	void *aux_data;
 
@@ -193,6 +234,26 @@ static inline int ras_err_ser_probe_sysreg(const struct err_record_info *info,
 			probe_data);
 }
 
+static inline unsigned int ras_err_ser_probe_batch_memmap(
+		const struct err_record_info *info, unsigned int first,
+		uint64_t *pending)
+{
+	assert(info->version == ERR_HANDLER_VERSION);
+
+	return ser_probe_batch_memmap(info->memmap.base_addr,
+			info->memmap.size_num_k, first, pending);
+}
+
+static inline unsigned int ras_err_ser_probe_batch_sysreg(
+		const struct err_record_info *info, unsigned int first,
+		uint64_t *pending)
+{
+	assert(info->version == ERR_HANDLER_VERSION);
+
+	return ser_probe_batch_sysreg(info->sysreg.idx_start,
+			info->sysreg.num_idx, first, pending);
+}
+
 const char *ras_serr_to_str(unsigned int serr);
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
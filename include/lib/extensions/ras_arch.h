@@ -260,6 +260,10 @@ static inline void ser_sys_select_record(unsigned int idx)
 /* Library functions to probe Standard Error Record */
 int ser_probe_memmap(uintptr_t base, unsigned int size_num_k, int *probe_data);
 int ser_probe_sysreg(unsigned int idx_start, unsigned int num_idx, int *probe_data);
+unsigned int ser_probe_batch_memmap(uintptr_t base, unsigned int size_num_k,
+		unsigned int first, uint64_t *pending);
+unsigned int ser_probe_batch_sysreg(unsigned int idx_start, unsigned int num_idx,
+		unsigned int first, uint64_t *pending);
 #endif /* __ASSEMBLER__ */
 
 #endif /* RAS_ARCH_H */
@@ -9,7 +9,30 @@
 
 #include <context.h>
 
+/*******************************************************************************
+ * Offsets in the per-cpu save area of the lazy SIMD context switch. The
+ * non-secure Z and P registers are saved at the maximum vector length allowed
+ * by sve_enable(), 512 bits.
+ ******************************************************************************/
+#define SVE_LAZY_NS_Z		U(0x0)
+#define SVE_LAZY_NS_P		U(0x800)
+#define SVE_LAZY_NS_FFR		U(0x880)
+#define SVE_LAZY_NS_FPSR	U(0x888)
+#define SVE_LAZY_NS_FPCR	U(0x890)
+#define SVE_LAZY_S_FPSR		U(0x898)
+#define SVE_LAZY_S_FPCR		U(0x8a0)
+#define SVE_LAZY_S_CTX		U(0x8a8)
+#define SVE_LAZY_S_Q		U(0x8b0)
+
+#ifndef __ASSEMBLER__
+
 void sve_enable(cpu_context_t *context);
 void sve_disable(cpu_context_t *context);
 
+#if CTX_LAZY_SIMD_REGS
+void sve_lazy_trap_handler(cpu_context_t *context);
+#endif
+
+#endif /* __ASSEMBLER__ */
+
 #endif /* SVE_H */
@@ -26,6 +26,21 @@
 		.populate = (callback)						\
 	};
 
+/*
+ * Same as FCONF_REGISTER_POPULATOR, for a callback that reads the first node
+ * compatible with the compatible string. The nodes of all these populators
+ * are located in a single pass over the config dtb, and each callback gets
+ * its node offset, or a negative libfdt error if there is no such node.
+ */
+#define FCONF_REGISTER_NODE_POPULATOR(config, name, compat, callback)		\
+	__attribute__((used, section(".fconf_populator")))			\
+	const struct fconf_populator (name##__populator) = {			\
+		.config_type = (#config),					\
+		.info = (#name),						\
+		.compatible = (compat),						\
+		.populate_node = (callback)					\
+	};
+
 /*
  * Populator callback
  *
@@ -41,6 +56,12 @@ struct fconf_populator {
 	 * Return 0 on success, err_code < 0 otherwise.
 	 */
 	int (*populate)(uintptr_t config);
+
+	/* Callback used with the offset of the node compatible with compatible.
+	 * Return 0 on success, err_code < 0 otherwise.
+	 */
+	const char *compatible;
+	int (*populate_node)(uintptr_t config, int node);
 };
 
 /* This function supports to load tb_fw_config and fw_config dtb */
@@ -55,6 +76,14 @@ int fconf_load_config(unsigned int image_id);
  */
 void fconf_populate(const char *config_type, uintptr_t config);
 
+/*
+ * Optional platform lookup of the first node compatible with compat in the
+ * config dtb, for instance from an index of a DT already walked. Returns the
+ * node offset or a negative libfdt error, or -ENOTSUP when the platform does
+ * not know this dtb and fconf has to walk it.
+ */
+int plat_fconf_node_offset_by_compatible(uintptr_t config, const char *compat);
+
 /* FCONF specific getter */
 #define fconf__dtb_getter(prop)	fconf_dtb_info.prop
 
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FCONF_MPAM_MSC_GETTER_H
+#define FCONF_MPAM_MSC_GETTER_H
+
+#include <lib/extensions/mpam_msc.h>
+
+#define mpam_msc__config_getter(id)	fconf_mpam_msc_config.id
+
+struct fconf_mpam_msc_config {
+	const struct mpam_msc_topology *topology;
+};
+
+extern struct fconf_mpam_msc_config fconf_mpam_msc_config;
+
+#endif /* FCONF_MPAM_MSC_GETTER_H */
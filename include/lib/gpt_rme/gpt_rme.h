@@ -256,7 +256,8 @@ void gpt_disable(void);
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned atomically: if any granule in it cannot
+ * be transitioned, none of them is.
  *
  * Parameters
  *   base: Base address of the region to transition, must be aligned to granule
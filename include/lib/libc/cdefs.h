@@ -24,6 +24,12 @@
 #define __init
 #endif
 
+/*
+ * Functions on runtime hot paths. The SP_MIN linker script groups them at
+ * the start of the code, away from the boot time code.
+ */
+#define __hot		__section(".text.hot." __FILE__ "." __XSTRING(__LINE__))
+
 #define __printflike(fmtarg, firstvararg) \
 		__attribute__((__format__ (__printf__, fmtarg, firstvararg)))
 
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_UNLZ4_H
+#define TF_UNLZ4_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/image_decompress.h>
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+bool unlz4_stream_probe(uintptr_t in_buf, size_t in_len);
+int unlz4_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		      size_t work_len);
+int unlz4_stream_update(uintptr_t in_buf, size_t in_len);
+int unlz4_stream_end(uintptr_t *out_buf);
+
+extern const decompressor_stream_t unlz4_stream;
+
+#endif /* TF_UNLZ4_H */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PER_CPU_H
+#define PER_CPU_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+
+/*
+ * Per-CPU variables are stored in normal .bss memory, in the per_cpu_data
+ * section. The compiler allocates the copy of CPU 0, the linker script
+ * reserves the copies of the other CPUs. Each copy of the section starts on a
+ * cache writeback granule boundary, so that the data written by a CPU in its
+ * hot paths never shares a cache line with the data of another CPU.
+ */
+#define DEFINE_PER_CPU(_type, _name)	\
+	_type _name __section("per_cpu_data")
+
+extern char __PER_CPU_START__[];
+extern char __PER_CPU_UNIT_END__[];
+
+static inline uintptr_t per_cpu_addr(const void *cpu0_addr, unsigned int cpu)
+{
+	uintptr_t unit_size = (uintptr_t)__PER_CPU_UNIT_END__ -
+			      (uintptr_t)__PER_CPU_START__;
+
+	assert(cpu < PLATFORM_CORE_COUNT);
+
+	return (uintptr_t)cpu0_addr + (cpu * unit_size);
+}
+
+/* Pointer to the copy of a per-CPU variable of a given CPU */
+#define PER_CPU_BY_INDEX(_name, _cpu)	\
+	((__typeof__(_name) *)per_cpu_addr(&(_name), (_cpu)))
+
+/* Pointer to the copy of a per-CPU variable of the calling CPU */
+#define PER_CPU_CUR(_name)		\
+	PER_CPU_BY_INDEX(_name, plat_my_core_pos())
+
+/*
+ * Debug check against false sharing: the per-CPU copies are padded to
+ * CACHE_WRITEBACK_GRANULE, which must not be smaller than the coherency
+ * granule reported by the CPU. Compiled out in release builds.
+ */
+static inline void per_cpu_check_granule(void)
+{
+#if ENABLE_ASSERTIONS
+	unsigned int cwg = (unsigned int)(read_ctr_el0() >> CTR_CWG_SHIFT) &
+			   CTR_CWG_MASK;
+
+	/* CWG is the log2 of a number of words, 0 if not reported */
+	assert((cwg == 0U) || ((U(4) << cwg) <= CACHE_WRITEBACK_GRANULE));
+	assert(((uintptr_t)__PER_CPU_START__ %
+		CACHE_WRITEBACK_GRANULE) == 0U);
+#endif
+}
+
+#endif /* PER_CPU_H */
@@ -35,6 +35,12 @@
 #define PMF_CACHE_MAINT		(U(1) << 0)
 #define PMF_NO_CACHE_MAINT	U(0)
 
+/*
+ * Flag passed to PMF_CAPTURE_TIMESTAMP: the cache maintenance is deferred to
+ * the next pmf_flush_deferred_timestamps() call of the same CPU.
+ */
+#define PMF_CACHE_MAINT_DEFER	(U(1) << 1)
+
 /*
  * Defines for PMF SMC function ids.
  */
@@ -53,6 +59,7 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_BL2_LOAD_INSTR_SVC_ID	2
 
 /*******************************************************************************
  * Function & variable prototypes
@@ -63,6 +70,7 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		unsigned int flags,
 		unsigned long long *ts_value);
 int pmf_setup(void);
+void pmf_flush_deferred_timestamps(void);
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
 		u_register_t x2,
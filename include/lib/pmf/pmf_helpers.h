@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -52,6 +53,9 @@ typedef struct pmf_svc_desc {
 				unsigned int tid,		\
 				unsigned long long ts);		\
 	void pmf_capture_timestamp_ ## _name(			\
+				unsigned int tid,		\
+				unsigned long long ts);		\
+	void pmf_capture_timestamp_deferred_ ## _name(		\
 				unsigned int tid,		\
 				unsigned long long ts);
 
@@ -60,6 +64,8 @@ typedef struct pmf_svc_desc {
 		unsigned long long ts = read_cntpct_el0();		\
 		if (((_flags) & PMF_CACHE_MAINT) != 0U)			\
 			pmf_capture_timestamp_with_cache_maint_ ## _name((_tid), ts);\
+		else if (((_flags) & PMF_CACHE_MAINT_DEFER) != 0U)	\
+			pmf_capture_timestamp_deferred_ ## _name((_tid), ts);\
 		else							\
 			pmf_capture_timestamp_ ## _name((_tid), ts);	\
 	} while (0)
@@ -70,6 +76,8 @@ typedef struct pmf_svc_desc {
 		CASSERT(sizeof(_tsval) == sizeof(unsigned long long), invalid_tsval_size);\
 		if (((_flags) & PMF_CACHE_MAINT) != 0U)			\
 			pmf_capture_timestamp_with_cache_maint_ ## _name((_tid), (_tsval));\
+		else if (((_flags) & PMF_CACHE_MAINT_DEFER) != 0U)	\
+			pmf_capture_timestamp_deferred_ ## _name((_tid), (_tsval));\
 		else							\
 			pmf_capture_timestamp_ ## _name((_tid), (_tsval));\
 	} while (0)
@@ -79,6 +87,8 @@ typedef struct pmf_svc_desc {
 		CASSERT(sizeof(_wrval) == sizeof(unsigned long long), invalid_wrval_size);\
 		if (((_flags) & PMF_CACHE_MAINT) != 0U)			\
 			pmf_capture_timestamp_with_cache_maint_ ## _name((_tid), (_wrval));\
+		else if (((_flags) & PMF_CACHE_MAINT_DEFER) != 0U)	\
+			pmf_capture_timestamp_deferred_ ## _name((_tid), (_wrval));\
 		else							\
 			pmf_capture_timestamp_ ## _name((_tid), (_wrval));\
 	} while (0)
@@ -194,6 +204,19 @@ typedef struct pmf_svc_desc {
 				base_addr, (uint64_t)tid, ts);		\
 		if (((_flags) & PMF_DUMP_ENABLE) != 0)			\
 			__pmf_dump_timestamp((uint64_t)tid, ts);	\
+	}								\
+	void pmf_capture_timestamp_deferred_ ## _name(			\
+			unsigned int tid,				\
+			unsigned long long ts)				\
+	{								\
+		CASSERT(_flags != 0, select_proper_config);		\
+		PMF_VALIDATE_TID(_name, (uint64_t)tid);			\
+		uintptr_t base_addr = (uintptr_t) pmf_ts_mem_ ## _name;	\
+		if (((_flags) & PMF_STORE_ENABLE) != 0)			\
+			__pmf_store_timestamp_deferred(			\
+				base_addr, (uint64_t)tid, ts);		\
+		if (((_flags) & PMF_DUMP_ENABLE) != 0)			\
+			__pmf_dump_timestamp((uint64_t)tid, ts);	\
 	}
 
 /*
@@ -249,6 +272,9 @@ void __pmf_store_timestamp(uintptr_t base_addr,
 void __pmf_store_timestamp_with_cache_maint(uintptr_t base_addr,
 		unsigned int tid,
 		unsigned long long ts);
+void __pmf_store_timestamp_deferred(uintptr_t base_addr,
+		unsigned int tid,
+		unsigned long long ts);
 unsigned long long __pmf_get_timestamp(uintptr_t base_addr,
 		unsigned int tid,
 		unsigned int cpuid,
@@ -84,6 +84,20 @@
 #define is_psci_fid(_fid) \
 	(((_fid) & PSCI_FID_MASK) == PSCI_FID_VALUE)
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+/*
+ * Histograms of the CPU power domain statistics. Bucket n counts the values
+ * from 2^n to 2^(n+1) - 1 microseconds, the first bucket also counting 0 and
+ * the last bucket also counting larger values.
+ */
+#define PSCI_STAT_HIST_BUCKETS		U(16)
+
+#define PSCI_STAT_HIST_RESIDENCY	U(0)
+#define PSCI_STAT_HIST_ENTRY_LATENCY	U(1)
+#define PSCI_STAT_HIST_EXIT_LATENCY	U(2)
+#define PSCI_STAT_HIST_TYPES		U(3)
+#endif
+
 /*******************************************************************************
  * PSCI Migrate and friends
  ******************************************************************************/
@@ -296,6 +310,7 @@ typedef struct psci_cpu_data {
 typedef struct plat_psci_ops {
 	void (*cpu_standby)(plat_local_state_t cpu_state);
 	int (*pwr_domain_on)(u_register_t mpidr);
+	void (*pwr_domain_on_batch_end)(void);
 	void (*pwr_domain_off)(const psci_power_state_t *target_state);
 	void (*pwr_domain_suspend_pwrdown_early)(
 				const psci_power_state_t *target_state);
@@ -334,6 +349,8 @@ unsigned int psci_version(void);
 int psci_cpu_on(u_register_t target_cpu,
 		uintptr_t entrypoint,
 		u_register_t context_id);
+int psci_cpu_on_batch(const u_register_t *target_cpus, unsigned int count,
+		      uintptr_t entrypoint, u_register_t context_id);
 int psci_cpu_suspend(unsigned int power_state,
 		     uintptr_t entrypoint,
 		     u_register_t context_id);
@@ -351,6 +368,14 @@ void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 unsigned int psci_is_last_on_cpu(void);
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+int psci_stat_histogram(u_register_t target_cpu, unsigned int power_state,
+			unsigned int type, unsigned int bucket,
+			u_register_t *count);
+void psci_stats_hw_low_pwr_enter(plat_local_state_t cpu_state);
+void psci_stats_hw_low_pwr_exit(plat_local_state_t cpu_state);
+#endif
+
 #endif /*__ASSEMBLER__*/
 
 #endif /* PSCI_H */
@@ -15,7 +15,11 @@
 #define RT_INSTR_EXIT_HW_LOW_PWR	U(3)
 #define RT_INSTR_ENTER_CFLUSH		U(4)
 #define RT_INSTR_EXIT_CFLUSH		U(5)
-#define RT_INSTR_TOTAL_IDS		U(6)
+#define RT_INSTR_ENTER_SPD		U(6)
+#define RT_INSTR_ENTER_SP		U(7)
+#define RT_INSTR_EXIT_SP		U(8)
+#define RT_INSTR_EXIT_SPD		U(9)
+#define RT_INSTR_TOTAL_IDS		U(10)
 
 #ifndef __ASSEMBLER__
 PMF_DECLARE_CAPTURE_TIMESTAMP(rt_instr_svc)
@@ -9,14 +9,34 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef struct spinlock {
 	volatile uint32_t lock;
 } spinlock_t;
 
+/* Owner in the lower half, next ticket in the upper half */
+typedef struct ticketlock {
+	volatile uint32_t lock;
+} ticketlock_t;
+
+/* Writer flag in bit 31, readers count in the lower bits */
+typedef struct rwlock {
+	volatile uint32_t lock;
+} rwlock_t;
+
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
+bool spin_trylock(spinlock_t *lock);
+
+void ticket_lock(ticketlock_t *lock);
+void ticket_unlock(ticketlock_t *lock);
+
+void rw_read_lock(rwlock_t *lock);
+void rw_read_unlock(rwlock_t *lock);
+void rw_write_lock(rwlock_t *lock);
+void rw_write_unlock(rwlock_t *lock);
 
 #else
 
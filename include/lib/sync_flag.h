@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SYNC_FLAG_H
+#define SYNC_FLAG_H
+
+#include <platform_def.h>
+
+#ifndef __ASSEMBLER__
+#include <cdefs.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * State published by one CPU and awaited by others. A flag has a single
+ * writer and fills its own cache writeback granule, so that it can be
+ * maintained to the point of coherency without affecting other data:
+ * writers and waiters may run with data caches enabled or disabled.
+ */
+typedef struct sync_flag {
+	volatile uint32_t state;
+} __aligned(CACHE_WRITEBACK_GRANULE) sync_flag_t;
+
+void sync_flag_set(sync_flag_t *flag, uint32_t state);
+bool sync_flag_test(sync_flag_t *flag, uint32_t state);
+void sync_flag_wait(sync_flag_t *flag, uint32_t state);
+
+#endif /* __ASSEMBLER__ */
+#endif /* SYNC_FLAG_H */
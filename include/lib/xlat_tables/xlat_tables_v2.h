@@ -337,6 +337,19 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
 				uintptr_t base_va,
 				size_t size);
 
+/*
+ * Group dynamic regions additions and removals. Between these calls, the
+ * translation tables are updated without barriers nor TLB invalidation by VA:
+ * removed regions may still be accessible and added regions may not be
+ * accessible yet. The commit issues the barriers and, if regions were
+ * removed, a single invalidation of all the TLB entries of the translation
+ * regime. Batches can't be nested.
+ */
+void mmap_dynamic_batch_begin(void);
+void mmap_dynamic_batch_begin_ctx(xlat_ctx_t *ctx);
+void mmap_dynamic_batch_commit(void);
+void mmap_dynamic_batch_commit_ctx(xlat_ctx_t *ctx);
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 /*
@@ -412,5 +425,20 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				uint32_t *attr);
 int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr);
 
+/*
+ * Query the most sub-tables in use at once in a set of translation tables,
+ * base table excluded, and the number of sub-tables of the context.
+ *
+ * ctx
+ *   Translation context to work on.
+ * max_used
+ *   Output parameter where to store the most sub-tables in use at once.
+ * total
+ *   Output parameter where to store the number of sub-tables.
+ */
+void xlat_get_tables_usage_ctx(const xlat_ctx_t *ctx, unsigned int *max_used,
+			       unsigned int *total);
+void xlat_get_tables_usage(unsigned int *max_used, unsigned int *total);
+
 #endif /*__ASSEMBLER__*/
 #endif /* XLAT_TABLES_V2_H */
@@ -80,6 +80,9 @@ struct xlat_ctx {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+
+	/* Most sub-tables in use at once, as they are freed when unmapped */
+	int tables_max_used;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 	int next_table;
@@ -105,6 +108,14 @@ struct xlat_ctx {
 	/* Set to true when the translation tables are initialized. */
 	bool initialized;
 
+	/*
+	 * Set to true between mmap_dynamic_batch_begin_ctx() and
+	 * mmap_dynamic_batch_commit_ctx(). batch_tlbi is set when entries
+	 * removed during the batch still have to be invalidated from the TLBs.
+	 */
+	bool batch;
+	bool batch_tlbi;
+
 	/*
 	 * Translation regime managed by this xlat_ctx_t. It should be one of
 	 * the EL*_REGIME defines.
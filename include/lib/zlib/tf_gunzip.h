@@ -7,10 +7,21 @@
 #ifndef TF_GUNZIP_H
 #define TF_GUNZIP_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include <common/image_decompress.h>
+
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+bool gunzip_stream_probe(uintptr_t in_buf, size_t in_len);
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len);
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len);
+int gunzip_stream_end(uintptr_t *out_buf);
+
+extern const decompressor_stream_t gunzip_stream;
+
 #endif /* TF_GUNZIP_H */
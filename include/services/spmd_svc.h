@@ -20,6 +20,11 @@ uint64_t spmd_smc_handler(uint32_t smc_fid,
 			  void *cookie,
 			  void *handle,
 			  uint64_t flags);
+#if SPMD_DIRECT_MSG_STATS
+int spmd_get_direct_msg_stats(uint64_t mpidr, uint32_t smc_fid,
+			      uint64_t *count, uint64_t *total_ticks,
+			      uint64_t *max_ticks);
+#endif
 #endif /* __ASSEMBLER__ */
 
 #endif /* SPMD_SVC_H */
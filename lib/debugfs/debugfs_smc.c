@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
@@ -31,6 +32,9 @@
 /* This is the virtual address to which we map the NS shared buffer */
 #define DEBUGFS_SHARED_BUF_VIRT		((void *)0x81000000U)
 
+/* Largest shared buffer, a READ returns at most this many bytes */
+#define DEBUGFS_SHARED_BUF_MAX_SIZE	(16U * PAGE_SIZE_4KB)
+
 static union debugfs_parms {
 	struct {
 		char fname[MAX_PATH_LEN];
@@ -59,6 +63,8 @@ static spinlock_t debugfs_access_lock;
 
 static bool debugfs_initialized;
 
+static size_t debugfs_shared_buf_size;
+
 uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 			      u_register_t cmd,
 			      u_register_t arg2,
@@ -99,14 +105,22 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 
 	switch (cmd) {
 	case INIT:
-		if (debugfs_initialized == false) {
+		/* A zero size keeps the original single page buffer */
+		if (arg3 == 0U) {
+			arg3 = PAGE_SIZE_4KB;
+		}
+
+		if ((debugfs_initialized == false) &&
+		    ((arg3 & PAGE_SIZE_MASK) == 0U) &&
+		    (arg3 <= DEBUGFS_SHARED_BUF_MAX_SIZE)) {
 			/* TODO: check PA validity e.g. whether */
 			/* it is an NS region.                  */
 			ret = mmap_add_dynamic_region(arg2,
 				(uintptr_t)DEBUGFS_SHARED_BUF_VIRT,
-				PAGE_SIZE_4KB,
+				arg3,
 				MT_MEMORY | MT_RW | MT_NS);
 			if (ret == 0) {
+				debugfs_shared_buf_size = arg3;
 				debugfs_initialized = true;
 				smc_ret = SMC_OK;
 				smc_resp = 0;
@@ -146,6 +160,15 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 		break;
 
 	case READ:
+		if ((debugfs_initialized == false) || (arg3 > INT_MAX)) {
+			break;
+		}
+
+		/* Reads larger than the shared buffer are truncated */
+		if (arg3 > debugfs_shared_buf_size) {
+			arg3 = debugfs_shared_buf_size;
+		}
+
 		ret = read(arg2, DEBUGFS_SHARED_BUF_VIRT, arg3);
 		if (ret >= 0) {
 			smc_ret = SMC_OK;
@@ -203,6 +226,7 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 int debugfs_smc_setup(void)
 {
 	debugfs_initialized = false;
+	debugfs_shared_buf_size = 0U;
 	debugfs_access_lock.lock = 0;
 
 	return 0;
@@ -350,6 +350,7 @@ void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
 	 */
 	state = get_el3state_ctx(ctx);
 	write_ctx_reg(state, CTX_SCR_EL3, scr_el3);
+	write_ctx_reg(state, CTX_EXIT_SCR_EL3, 0U);
 	write_ctx_reg(state, CTX_ELR_EL3, ep->pc);
 	write_ctx_reg(state, CTX_SPSR_EL3, ep->spsr);
 
@@ -466,6 +467,29 @@ void cm_init_my_context(const entry_point_info_t *ep)
 	cm_setup_context(ctx, ep);
 }
 
+/*******************************************************************************
+ * The EL2 and extension registers set up for an exit to the normal world are
+ * kept by the CPU until its context is set up again, on the power up paths.
+ * They only depend on SCR_EL3: they are set up again when the context SCR_EL3
+ * differs from the value they were set up for, e.g. after
+ * cm_write_scr_el3_bit() or an extension manager changed it.
+ ******************************************************************************/
+static bool cm_exit_state_valid(cpu_context_t *ctx)
+{
+	el3_state_t *state = get_el3state_ctx(ctx);
+
+	return read_ctx_reg(state, CTX_EXIT_SCR_EL3) ==
+	       read_ctx_reg(state, CTX_SCR_EL3);
+}
+
+static void cm_exit_state_save(cpu_context_t *ctx)
+{
+	el3_state_t *state = get_el3state_ctx(ctx);
+
+	write_ctx_reg(state, CTX_EXIT_SCR_EL3,
+		      read_ctx_reg(state, CTX_SCR_EL3));
+}
+
 /*******************************************************************************
  * Prepare the CPU system registers for first entry into realm, secure, or
  * normal world.
@@ -484,7 +508,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
 
 	assert(ctx != NULL);
 
-	if (security_state == NON_SECURE) {
+	if ((security_state == NON_SECURE) && !cm_exit_state_valid(ctx)) {
 		scr_el3 = read_ctx_reg(get_el3state_ctx(ctx),
 						 CTX_SCR_EL3);
 		if ((scr_el3 & SCR_HCE_BIT) != 0U) {
@@ -685,6 +709,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
 						~(CNTHP_CTL_ENABLE_BIT));
 		}
 		manage_extensions_nonsecure(el2_unused, ctx);
+		cm_exit_state_save(ctx);
 	}
 
 	cm_el1_sysregs_context_restore(security_state);
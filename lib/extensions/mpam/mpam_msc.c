@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <common/runtime_svc.h>
+#include <lib/extensions/mpam_msc.h>
+#include <lib/fconf/fconf.h>
+#include <lib/fconf/fconf_mpam_msc_getter.h>
+#include <lib/mmio.h>
+#include <lib/spinlock.h>
+#include <smccc_helpers.h>
+
+/* Current settings of the partitions, as programmed in the MSCs */
+static struct mpam_msc_part mpam_msc_parts[PLAT_MPAM_MSC_MAX_PARTS];
+static unsigned int mpam_msc_num_parts;
+static const struct mpam_msc_topology *mpam_msc_topology;
+
+/* Serializes the partition selection and configuration of the MSCs */
+static spinlock_t mpam_msc_lock;
+
+/* Convert a percentage to the bandwidth fraction of an MSC */
+static uint32_t mpam_msc_mbw_fraction(uintptr_t base, unsigned int percent)
+{
+	uint32_t bwa_wd = mmio_read_32(base + MPAMF_MBW_IDR) &
+			  MPAMF_MBW_IDR_BWA_WD_MASK;
+	uint32_t frac = (percent * MPAMCFG_MBW_MASK) / 100U;
+
+	/* Only the BWA_WD most significant bits of the fraction exist */
+	if ((bwa_wd == 0U) || (bwa_wd >= 16U)) {
+		return frac;
+	}
+
+	return frac & ~(BIT_32(16U - bwa_wd) - 1U) & MPAMCFG_MBW_MASK;
+}
+
+/* Check that an MSC implements the settings of a partition */
+static int mpam_msc_check(const struct mpam_msc_part *part)
+{
+	uintptr_t base = mpam_msc_topology->msc_base[part->msc];
+	uint64_t idr = mmio_read_64(base + MPAMF_IDR);
+	uint32_t mbw_idr;
+
+	if (part->partid > (idr & MPAMF_IDR_PARTID_MAX_MASK)) {
+		return MPAM_MSC_E_INVALID_PARAMS;
+	}
+
+	if ((part->flags & MPAM_MSC_PART_CPBM) != 0U) {
+		uint32_t wd = mmio_read_32(base + MPAMF_CPOR_IDR) &
+			      MPAMF_CPOR_IDR_CPBM_WD_MASK;
+
+		if (((idr & MPAMF_IDR_HAS_CPOR_PART) == 0U) ||
+		    (wd > MPAM_MSC_CPBM_MAX_WD)) {
+			return MPAM_MSC_E_NOT_SUPPORTED;
+		}
+
+		if ((wd < 64U) && ((part->cpbm >> wd) != 0U)) {
+			return MPAM_MSC_E_INVALID_PARAMS;
+		}
+	}
+
+	if ((part->flags & (MPAM_MSC_PART_MBW_MAX | MPAM_MSC_PART_MBW_MIN)) ==
+	    0U) {
+		return MPAM_MSC_E_SUCCESS;
+	}
+
+	if ((idr & MPAMF_IDR_HAS_MBW_PART) == 0U) {
+		return MPAM_MSC_E_NOT_SUPPORTED;
+	}
+
+	mbw_idr = mmio_read_32(base + MPAMF_MBW_IDR);
+	if ((((part->flags & MPAM_MSC_PART_MBW_MAX) != 0U) &&
+	     ((mbw_idr & MPAMF_MBW_IDR_HAS_MAX) == 0U)) ||
+	    (((part->flags & MPAM_MSC_PART_MBW_MIN) != 0U) &&
+	     ((mbw_idr & MPAMF_MBW_IDR_HAS_MIN) == 0U))) {
+		return MPAM_MSC_E_NOT_SUPPORTED;
+	}
+
+	if (((part->flags & MPAM_MSC_PART_MBW_MAX) != 0U) &&
+	    ((part->flags & MPAM_MSC_PART_MBW_MIN) != 0U) &&
+	    (part->mbw_min > part->mbw_max)) {
+		return MPAM_MSC_E_INVALID_PARAMS;
+	}
+
+	return MPAM_MSC_E_SUCCESS;
+}
+
+/* Program the settings of a partition in its MSC, with the lock held */
+static void mpam_msc_program(const struct mpam_msc_part *part)
+{
+	uintptr_t base = mpam_msc_topology->msc_base[part->msc];
+	uint32_t wd;
+	unsigned int i;
+
+	mmio_write_32(base + MPAMCFG_PART_SEL, part->partid);
+
+	if ((part->flags & MPAM_MSC_PART_CPBM) != 0U) {
+		wd = mmio_read_32(base + MPAMF_CPOR_IDR) &
+		     MPAMF_CPOR_IDR_CPBM_WD_MASK;
+
+		for (i = 0U; (i * 32U) < wd; i++) {
+			mmio_write_32(base + MPAMCFG_CPBM(i),
+				      (uint32_t)(part->cpbm >> (i * 32U)));
+		}
+	}
+
+	if ((part->flags & MPAM_MSC_PART_MBW_MAX) != 0U) {
+		mmio_write_32(base + MPAMCFG_MBW_MAX,
+			      mpam_msc_mbw_fraction(base, part->mbw_max));
+	}
+
+	if ((part->flags & MPAM_MSC_PART_MBW_MIN) != 0U) {
+		mmio_write_32(base + MPAMCFG_MBW_MIN,
+			      mpam_msc_mbw_fraction(base, part->mbw_min));
+	}
+}
+
+/*
+ * Program the MSC partitions described in the HW_CONFIG. The MSCs must be
+ * mapped by the platform. Partitions the MSC cannot implement are skipped.
+ */
+int mpam_msc_setup(void)
+{
+	unsigned int i;
+	int ret;
+
+	mpam_msc_topology = FCONF_GET_PROPERTY(mpam_msc, config, topology);
+	if (mpam_msc_topology == NULL) {
+		return 0;
+	}
+
+	for (i = 0U; i < mpam_msc_topology->num_parts; i++) {
+		const struct mpam_msc_part *part = &mpam_msc_topology->parts[i];
+
+		ret = mpam_msc_check(part);
+		if (ret != MPAM_MSC_E_SUCCESS) {
+			WARN("MPAM: MSC %u PARTID %u not configured (%d)\n",
+			     part->msc, part->partid, ret);
+			continue;
+		}
+
+		mpam_msc_program(part);
+		mpam_msc_parts[mpam_msc_num_parts++] = *part;
+	}
+
+	INFO("MPAM: %u partitions configured\n", mpam_msc_num_parts);
+
+	return 0;
+}
+
+static struct mpam_msc_part *mpam_msc_find(u_register_t msc,
+					   u_register_t partid)
+{
+	unsigned int i;
+
+	for (i = 0U; i < mpam_msc_num_parts; i++) {
+		if ((mpam_msc_parts[i].msc == msc) &&
+		    (mpam_msc_parts[i].partid == partid)) {
+			return &mpam_msc_parts[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Update the settings of a partition, from the non-secure world */
+static int mpam_msc_update(struct mpam_msc_part *part,
+			   const struct mpam_msc_part *update)
+{
+	int ret;
+
+	/* Only the settings given in the HW_CONFIG can be changed */
+	if (((part->flags & MPAM_MSC_PART_RUNTIME) == 0U) ||
+	    (update->flags == 0U) || ((update->flags & ~part->flags) != 0U)) {
+		return MPAM_MSC_E_DENIED;
+	}
+
+	ret = mpam_msc_check(update);
+	if (ret != MPAM_MSC_E_SUCCESS) {
+		return ret;
+	}
+
+	spin_lock(&mpam_msc_lock);
+	mpam_msc_program(update);
+	part->cpbm = update->cpbm;
+	part->mbw_max = update->mbw_max;
+	part->mbw_min = update->mbw_min;
+	spin_unlock(&mpam_msc_lock);
+
+	return MPAM_MSC_E_SUCCESS;
+}
+
+/*
+ * Handle the MPAM MSC SiP calls:
+ * - VERSION: returns the major and minor versions of the interface.
+ * - GET(msc, partid): returns the status, the cache portion bitmap, and the
+ *   maximum and minimum bandwidths in percent.
+ * - SET_CPBM(msc, partid, bitmap): sets the cache portion bitmap.
+ * - SET_MBW(msc, partid, max, min): sets the bandwidth limits, in percent.
+ */
+uintptr_t mpam_msc_smc_handler(unsigned int smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3,
+			       u_register_t x4, void *cookie, void *handle,
+			       u_register_t flags)
+{
+	struct mpam_msc_part update;
+	struct mpam_msc_part *part;
+
+	/* Allow calls from non-secure only */
+	if (!is_caller_non_secure(flags)) {
+		SMC_RET1(handle, MPAM_MSC_E_DENIED);
+	}
+
+	if (smc_fid == MPAM_MSC_FID_VERSION) {
+		SMC_RET2(handle, MPAM_MSC_VERSION_MAJOR,
+			 MPAM_MSC_VERSION_MINOR);
+	}
+
+	part = mpam_msc_find(x1, x2);
+
+	switch (smc_fid) {
+	case MPAM_MSC_FID_GET:
+		if (part == NULL) {
+			SMC_RET1(handle, MPAM_MSC_E_INVALID_PARAMS);
+		}
+
+		SMC_RET4(handle, MPAM_MSC_E_SUCCESS, part->cpbm, part->mbw_max,
+			 part->mbw_min);
+
+	case MPAM_MSC_FID_SET_CPBM:
+	case MPAM_MSC_FID_SET_MBW:
+		if (part == NULL) {
+			SMC_RET1(handle, MPAM_MSC_E_INVALID_PARAMS);
+		}
+
+		update = *part;
+		if (smc_fid == MPAM_MSC_FID_SET_CPBM) {
+			update.flags = MPAM_MSC_PART_CPBM;
+			update.cpbm = x3;
+		} else {
+			if ((x3 > 100U) || (x4 > 100U)) {
+				SMC_RET1(handle, MPAM_MSC_E_INVALID_PARAMS);
+			}
+
+			update.flags = part->flags & (MPAM_MSC_PART_MBW_MAX |
+						      MPAM_MSC_PART_MBW_MIN);
+			update.mbw_max = (unsigned int)x3;
+			update.mbw_min = (unsigned int)x4;
+		}
+
+		SMC_RET1(handle, mpam_msc_update(part, &update));
+
+	default:
+		WARN("Unimplemented MPAM MSC call: 0x%x\n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
@@ -1,11 +1,13 @@
 /*
  * Copyright (c) 2018-2021, ARM Limited and Contributors. All rights reserved.
  * Copyright (c) 2020, NVIDIA Corporation. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <arch_helpers.h>
 #include <bl31/ea_handle.h>
@@ -19,6 +21,17 @@
 # error Platform must define RAS priority value
 #endif
 
+/*
+ * RAS interrupts with a number below this value are found with a direct lookup,
+ * others with a binary search. The default covers the SGI, PPI and SPI ranges.
+ */
+#ifndef PLAT_RAS_INTR_INDEX_SIZE
+# define PLAT_RAS_INTR_INDEX_SIZE	1020U
+#endif
+
+/* Position of each interrupt in ras_interrupt_mappings plus one, 0 if none */
+static uint16_t ras_intr_index[PLAT_RAS_INTR_INDEX_SIZE];
+
 /*
  * Function to convert architecturally-defined primary error code SERR,
  * bits[7:0] from ERR<n>STATUS to its corresponding error string.
@@ -60,11 +73,43 @@ const char *ras_serr_to_str(unsigned int serr)
 	return str[serr];
 }
 
+/*
+ * Probe all the records of a group supporting batched probes, and call the
+ * handler for each record in error. Return the first non-zero value returned by
+ * the handler, 0 otherwise.
+ */
+static int ras_handle_batch(const struct err_record_info *info,
+		const struct err_handler_data *err_data, unsigned int *n_handled)
+{
+	unsigned int first, num;
+	uint64_t pending;
+	int ret;
+
+	for (first = 0U; ; first += num) {
+		num = info->probe_batch(info, first, &pending);
+		if (num == 0U)
+			break;
+
+		while (pending != 0ULL) {
+			ret = info->handler(info,
+					(int)first + __builtin_ctzll(pending),
+					err_data);
+			if (ret != 0)
+				return ret;
+
+			(*n_handled)++;
+			pending &= pending - 1ULL;
+		}
+	}
+
+	return 0;
+}
+
 /* Handler that receives External Aborts on RAS-capable systems */
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
 {
-	unsigned int i, n_handled = 0;
+	unsigned int i, n_handled = 0, n_batch;
 	int probe_data, ret;
 	struct err_record_info *info;
 
@@ -82,6 +127,18 @@ int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		assert(info->probe != NULL);
 		assert(info->handler != NULL);
 
+		if (info->probe_batch != NULL) {
+			/* Probe again until a pass over the group finds no error */
+			do {
+				n_batch = n_handled;
+				ret = ras_handle_batch(info, &err_data, &n_handled);
+				if (ret != 0)
+					return ret;
+			} while (n_handled != n_batch);
+
+			continue;
+		}
+
 		/* Continue probing until the record group signals no error */
 		while (true) {
 			if (info->probe(info, &probe_data) == 0)
@@ -116,35 +173,25 @@ static void assert_interrupts_sorted(void)
 }
 #endif
 
-/*
- * Given an RAS interrupt number, locate the registered handler and call it. If
- * no handler was found for the interrupt number, this function panics.
- */
-static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
-		void *handle, void *cookie)
+/* Locate the registered RAS interrupt, NULL if there is none */
+static struct ras_interrupt *ras_find_interrupt(uint32_t intr_raw)
 {
 	struct ras_interrupt *ras_inrs = ras_interrupt_mappings.intrs;
-	struct ras_interrupt *selected = NULL;
-	int probe_data = 0;
-	int start, end, mid, ret __unused;
+	int start, end, mid;
 
-	const struct err_handler_data err_data = {
-		.version = ERR_HANDLER_VERSION,
-		.interrupt = intr_raw,
-		.flags = flags,
-		.cookie = cookie,
-		.handle = handle
-	};
+	if (intr_raw < PLAT_RAS_INTR_INDEX_SIZE) {
+		if (ras_intr_index[intr_raw] == 0U)
+			return NULL;
 
-	assert(ras_interrupt_mappings.num_intrs > 0UL);
+		return &ras_inrs[ras_intr_index[intr_raw] - 1U];
+	}
 
 	start = 0;
 	end = (int)ras_interrupt_mappings.num_intrs - 1;
 	while (start <= end) {
 		mid = ((end + start) / 2);
 		if (intr_raw == ras_inrs[mid].intr_number) {
-			selected = &ras_inrs[mid];
-			break;
+			return &ras_inrs[mid];
 		} else if (intr_raw < ras_inrs[mid].intr_number) {
 			/* Move left */
 			end = mid - 1;
@@ -154,18 +201,54 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 		}
 	}
 
+	return NULL;
+}
+
+/*
+ * Given an RAS interrupt number, locate the registered handler and call it. If
+ * no handler was found for the interrupt number, this function panics.
+ */
+static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
+		void *handle, void *cookie)
+{
+	struct ras_interrupt *selected;
+	unsigned int n_handled = 0U;
+	int probe_data = 0;
+	int ret __unused;
+
+	const struct err_handler_data err_data = {
+		.version = ERR_HANDLER_VERSION,
+		.interrupt = intr_raw,
+		.flags = flags,
+		.cookie = cookie,
+		.handle = handle
+	};
+
+	assert(ras_interrupt_mappings.num_intrs > 0UL);
+
+	selected = ras_find_interrupt(intr_raw);
 	if (selected == NULL) {
 		ERROR("RAS interrupt %u has no handler!\n", intr_raw);
 		panic();
 	}
 
+	/*
+	 * Handle all the records in error of the group at once. Records of the
+	 * group may have been handled already, with an earlier interrupt.
+	 */
+	assert(selected->err_record->handler != NULL);
+	if (selected->err_record->probe_batch != NULL) {
+		(void) ras_handle_batch(selected->err_record, &err_data,
+				&n_handled);
+		return 0;
+	}
+
 	if (selected->err_record->probe != NULL) {
 		ret = selected->err_record->probe(selected->err_record, &probe_data);
 		assert(ret != 0);
 	}
 
 	/* Call error handler for the record group */
-	assert(selected->err_record->handler != NULL);
 	(void) selected->err_record->handler(selected->err_record, probe_data,
 			&err_data);
 
@@ -174,11 +257,23 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 
 void __init ras_init(void)
 {
+	struct ras_interrupt *ras_inrs = ras_interrupt_mappings.intrs;
+	unsigned int i;
+
 #if ENABLE_ASSERTIONS
 	/* Check RAS interrupts are sorted */
 	assert_interrupts_sorted();
 #endif
 
+	/* Index the interrupts for a direct lookup */
+	assert(ras_interrupt_mappings.num_intrs < UINT16_MAX);
+	for (i = 0U; i < ras_interrupt_mappings.num_intrs; i++) {
+		if (ras_inrs[i].intr_number < PLAT_RAS_INTR_INDEX_SIZE) {
+			ras_intr_index[ras_inrs[i].intr_number] =
+				(uint16_t)(i + 1U);
+		}
+	}
+
 	/* Register RAS priority handler */
 	ehf_register_priority_handler(PLAT_RAS_PRI, ras_interrupt_handler);
 }
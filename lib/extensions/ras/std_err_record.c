@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -77,3 +78,66 @@ int ser_probe_sysreg(unsigned int idx_start, unsigned int num_idx, int *probe_da
 
 	return 0;
 }
+
+/*
+ * Probe up to 64 memory-mapped error records in Standard Error Record format,
+ * from record index 'first', a multiple of 64, with a single read of the group
+ * status register. Bit i of 'pending' is set when record 'first + i' is in
+ * error. Return the number of records probed, 0 once past the last record.
+ */
+unsigned int ser_probe_batch_memmap(uintptr_t base, unsigned int size_num_k,
+		unsigned int first, uint64_t *pending)
+{
+	unsigned int num_records;
+
+	assert(base != 0UL);
+	assert((first & 63U) == 0U);
+
+	/* Only 4K supported for now */
+	assert(size_num_k == STD_ERR_NODE_SIZE_NUM_K);
+
+	num_records = (unsigned int)
+		(mmio_read_32(ERR_DEVID(base, size_num_k)) & ERR_DEVID_MASK);
+	if (first >= num_records)
+		return 0U;
+
+	*pending = mmio_read_64(ERR_GSR(base, size_num_k, first >> 6U));
+
+	return MIN(num_records - first, 64U);
+}
+
+/*
+ * Probe up to 64 error records in Standard Error Record format accessed through
+ * System Registers, from index 'first' of the group, in one pass. Bit i of
+ * 'pending' is set when the record 'first + i' of the group is in error.
+ * Return the number of records probed, 0 once past the end of the group.
+ */
+unsigned int ser_probe_batch_sysreg(unsigned int idx_start, unsigned int num_idx,
+		unsigned int first, uint64_t *pending)
+{
+	unsigned int i, num;
+	uint64_t status;
+	unsigned int max_idx __unused =
+		((unsigned int) read_erridr_el1()) & ERRIDR_MASK;
+
+	assert(idx_start < max_idx);
+	assert(check_u32_overflow(idx_start, num_idx) == 0);
+	assert((idx_start + num_idx - 1U) < max_idx);
+
+	if (first >= num_idx)
+		return 0U;
+
+	num = MIN(num_idx - first, 64U);
+	*pending = 0ULL;
+
+	for (i = 0; i < num; i++) {
+		write_errselr_el1(idx_start + first + i);
+		isb();
+
+		status = read_erxstatus_el1();
+		if (ERR_STATUS_GET_FIELD(status, V) != 0U)
+			*pending |= BIT_64(i);
+	}
+
+	return num;
+}
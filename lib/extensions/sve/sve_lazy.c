@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/cassert.h>
+#include <lib/el3_runtime/context_mgmt.h>
+#include <lib/extensions/sve.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+
+/*
+ * SIMD registers of both worlds, while the secure world owns the registers.
+ * The secure state stays here across world switches.
+ */
+struct sve_lazy_area {
+	uint8_t ns_z[32][64];
+	uint64_t ns_p[16];
+	uint64_t ns_ffr;
+	uint64_t ns_fpsr;
+	uint64_t ns_fpcr;
+	uint64_t s_fpsr;
+	uint64_t s_fpcr;
+	cpu_context_t *s_ctx;
+	uint8_t s_q[32][16];
+} __aligned(64);
+
+CASSERT(SVE_LAZY_NS_P == __builtin_offsetof(struct sve_lazy_area, ns_p),
+	assert_sve_lazy_ns_p_offset_mismatch);
+CASSERT(SVE_LAZY_NS_FFR == __builtin_offsetof(struct sve_lazy_area, ns_ffr),
+	assert_sve_lazy_ns_ffr_offset_mismatch);
+CASSERT(SVE_LAZY_NS_FPSR == __builtin_offsetof(struct sve_lazy_area, ns_fpsr),
+	assert_sve_lazy_ns_fpsr_offset_mismatch);
+CASSERT(SVE_LAZY_S_FPSR == __builtin_offsetof(struct sve_lazy_area, s_fpsr),
+	assert_sve_lazy_s_fpsr_offset_mismatch);
+CASSERT(SVE_LAZY_S_CTX == __builtin_offsetof(struct sve_lazy_area, s_ctx),
+	assert_sve_lazy_s_ctx_offset_mismatch);
+CASSERT(SVE_LAZY_S_Q == __builtin_offsetof(struct sve_lazy_area, s_q),
+	assert_sve_lazy_s_q_offset_mismatch);
+
+static struct sve_lazy_area sve_lazy_areas[PLATFORM_CORE_COUNT];
+
+void sve_lazy_save_ns(struct sve_lazy_area *area);
+void sve_lazy_load_secure(struct sve_lazy_area *area);
+
+/*
+ * Handle the first FP/SIMD access of the secure world since it was entered:
+ * save the non-secure SVE state, load the secure FP/SIMD state and let the
+ * trapped instruction run again. el3_exit() switches back when it returns to
+ * the non-secure world.
+ */
+void sve_lazy_trap_handler(cpu_context_t *context)
+{
+	struct sve_lazy_area *area = &sve_lazy_areas[plat_my_core_pos()];
+	el3_state_t *ns_state = get_el3state_ctx(cm_get_context(NON_SECURE));
+	el3_state_t *state = get_el3state_ctx(context);
+
+	if ((read_scr_el3() & SCR_NS_BIT) != 0U) {
+		ERROR("FP/SIMD access trapped from the non-secure world\n");
+		panic();
+	}
+
+	assert(read_ctx_reg(ns_state, CTX_LAZY_SIMD_AREA) == 0U);
+
+	/* Access the whole SVE state, at the non-secure vector length */
+	write_cptr_el3((read_cptr_el3() | CPTR_EZ_BIT) & ~TFP_BIT);
+	isb();
+	write_zcr_el3(read_ctx_reg(ns_state, CTX_ZCR_EL3));
+	isb();
+
+	sve_lazy_save_ns(area);
+	sve_lazy_load_secure(area);
+
+	area->s_ctx = context;
+	write_ctx_reg(ns_state, CTX_LAZY_SIMD_AREA, (u_register_t)area);
+	write_ctx_reg(state, CTX_CPTR_EL3,
+		      read_ctx_reg(state, CTX_CPTR_EL3) & ~TFP_BIT);
+}
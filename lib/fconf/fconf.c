@@ -1,19 +1,32 @@
 /*
  * Copyright (c) 2019-2020, ARM Limited. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
+#include <lib/utils_def.h>
 #include <libfdt.h>
 #include <plat/common/platform.h>
 #include <platform_def.h>
 
+/* Node populators of a config type, tracked in a bitmap */
+#define FCONF_NODE_POPULATORS_MAX	32U
+
+#pragma weak plat_fconf_node_offset_by_compatible
+
+int plat_fconf_node_offset_by_compatible(uintptr_t config, const char *compat)
+{
+	return -ENOTSUP;
+}
+
 int fconf_load_config(unsigned int image_id)
 {
 	int err;
@@ -47,8 +60,64 @@ int fconf_load_config(unsigned int image_id)
 	return 0;
 }
 
+/*
+ * Locate the nodes of the node populators in the pending bitmap, either with
+ * the platform lookup or with a single walk of the dtb, stopping once all of
+ * them are found. The nodes that are not found are left to -FDT_ERR_NOTFOUND.
+ */
+static void fconf_find_nodes(const void *dtb,
+			     const struct fconf_populator *start,
+			     uint32_t pending, int *nodes)
+{
+	const char *compat;
+	unsigned int i;
+	int node;
+	int len;
+
+	for (i = 0U; i < FCONF_NODE_POPULATORS_MAX; i++) {
+		nodes[i] = -FDT_ERR_NOTFOUND;
+	}
+
+	for (i = 0U; i < FCONF_NODE_POPULATORS_MAX; i++) {
+		if ((pending & BIT_32(i)) == 0U) {
+			continue;
+		}
+
+		node = plat_fconf_node_offset_by_compatible((uintptr_t)dtb,
+							    start[i].compatible);
+		if (node == -ENOTSUP) {
+			break;
+		}
+
+		nodes[i] = node;
+		pending &= ~BIT_32(i);
+	}
+
+	for (node = fdt_next_node(dtb, -1, NULL);
+	     (node >= 0) && (pending != 0U);
+	     node = fdt_next_node(dtb, node, NULL)) {
+		compat = fdt_getprop(dtb, node, "compatible", &len);
+		if (compat == NULL) {
+			continue;
+		}
+
+		for (i = 0U; i < FCONF_NODE_POPULATORS_MAX; i++) {
+			if (((pending & BIT_32(i)) != 0U) &&
+			    (fdt_stringlist_contains(compat, len,
+						     start[i].compatible) != 0)) {
+				nodes[i] = node;
+				pending &= ~BIT_32(i);
+			}
+		}
+	}
+}
+
 void fconf_populate(const char *config_type, uintptr_t config)
 {
+	int nodes[FCONF_NODE_POPULATORS_MAX];
+	uint32_t pending = 0U;
+	int ret;
+
 	assert(config != 0UL);
 
 	/* Check if the pointer to DTB is correct */
@@ -65,11 +134,35 @@ void fconf_populate(const char *config_type, uintptr_t config)
 	const struct fconf_populator *populator;
 
 	for (populator = start; populator != end; populator++) {
-		assert((populator->info != NULL) && (populator->populate != NULL));
+		assert((populator->info != NULL) &&
+		       ((populator->populate != NULL) ||
+			((populator->populate_node != NULL) &&
+			 (populator->compatible != NULL))));
+
+		if ((populator->populate_node != NULL) &&
+		    (strcmp(populator->config_type, config_type) == 0)) {
+			assert((populator - start) <
+			       (int)FCONF_NODE_POPULATORS_MAX);
+			pending |= BIT_32((uint32_t)(populator - start));
+		}
+	}
+
+	/* One pass over the dtb for all the node populators */
+	if (pending != 0U) {
+		fconf_find_nodes((const void *)config, start, pending, nodes);
+	}
 
+	for (populator = start; populator != end; populator++) {
 		if (strcmp(populator->config_type, config_type) == 0) {
 			INFO("FCONF: Reading firmware configuration information for: %s\n", populator->info);
-			if (populator->populate(config) != 0) {
+			if (populator->populate_node != NULL) {
+				ret = populator->populate_node(config,
+							       nodes[populator - start]);
+			} else {
+				ret = populator->populate(config);
+			}
+
+			if (ret != 0) {
 				/* TODO: handle property miss */
 				panic();
 			}
@@ -15,5 +15,8 @@ FCONF_DYN_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
 FCONF_AMU_SOURCES	:=	lib/fconf/fconf_amu_getter.c
 FCONF_AMU_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
 
+FCONF_MPAM_MSC_SOURCES	:=	lib/fconf/fconf_mpam_msc_getter.c
+FCONF_MPAM_MSC_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
+
 FCONF_MPMM_SOURCES	:=	lib/fconf/fconf_mpmm_getter.c
 FCONF_MPMM_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <common/fdt_wrappers.h>
+#include <lib/fconf/fconf.h>
+#include <lib/fconf/fconf_mpam_msc_getter.h>
+#include <libfdt.h>
+
+struct fconf_mpam_msc_config fconf_mpam_msc_config;
+static struct mpam_msc_topology fconf_mpam_msc_topology;
+
+/*
+ * Read an optional percentage property of a partition node, and set `flag` in
+ * the partition flags when it is present.
+ *
+ * Returns `0` on success, or a negative integer representing an error code.
+ */
+static int fconf_read_mpam_percent(const void *fdt, int node, const char *prop,
+				   uint32_t flag, struct mpam_msc_part *part,
+				   unsigned int *value)
+{
+	uint32_t percent;
+	int ret;
+
+	ret = fdt_read_uint32(fdt, node, prop, &percent);
+	if (ret == -FDT_ERR_NOTFOUND) {
+		return 0;
+	}
+
+	if ((ret < 0) || (percent > 100U)) {
+		return -FDT_ERR_BADVALUE;
+	}
+
+	*value = percent;
+	part->flags |= flag;
+
+	return 0;
+}
+
+/*
+ * Populate the partitions described by the `partition-*` subnodes of an MSC.
+ *
+ * Returns `0` on success, or a negative integer representing an error code.
+ */
+static int fconf_populate_mpam_msc_parts(const void *fdt, int parent,
+					 unsigned int msc)
+{
+	int node = 0;
+	int ret = 0;
+
+	fdt_for_each_subnode(node, fdt, parent) {
+		struct mpam_msc_topology *topology = &fconf_mpam_msc_topology;
+		struct mpam_msc_part *part;
+		const char *name;
+		uint32_t partid;
+		int len;
+
+		name = fdt_get_name(fdt, node, &len);
+		if (strncmp(name, "partition-", 10) != 0) {
+			continue;
+		}
+
+		if (topology->num_parts == PLAT_MPAM_MSC_MAX_PARTS) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		part = &topology->parts[topology->num_parts];
+		part->msc = msc;
+
+		ret = fdt_read_uint32(fdt, node, "partid", &partid);
+		if (ret < 0) {
+			break;
+		}
+
+		part->partid = partid;
+
+		ret = fdt_read_uint64(fdt, node, "cache-portions", &part->cpbm);
+		if (ret == 0) {
+			part->flags |= MPAM_MSC_PART_CPBM;
+		} else if (ret != -FDT_ERR_NOTFOUND) {
+			break;
+		}
+
+		ret = fconf_read_mpam_percent(fdt, node, "mbw-max-percent",
+					      MPAM_MSC_PART_MBW_MAX, part,
+					      &part->mbw_max);
+		if (ret < 0) {
+			break;
+		}
+
+		ret = fconf_read_mpam_percent(fdt, node, "mbw-min-percent",
+					      MPAM_MSC_PART_MBW_MIN, part,
+					      &part->mbw_min);
+		if (ret < 0) {
+			break;
+		}
+
+		if (fdt_getprop(fdt, node, "runtime-update", NULL) != NULL) {
+			part->flags |= MPAM_MSC_PART_RUNTIME;
+		}
+
+		topology->num_parts++;
+	}
+
+	if ((node < 0) && (node != -FDT_ERR_NOTFOUND)) {
+		return node;
+	}
+
+	return ret;
+}
+
+/*
+ * Populates the global `fconf_mpam_msc_config` structure with the MPAM
+ * partition settings described by the hardware configuration device tree
+ * blob. A missing node is not an error, and leaves the MSCs unconfigured.
+ *
+ * The device tree is expected to provide the settings like so:
+ *
+ *     mpam-msc-config {
+ *         compatible = "arm,mpam-msc-config";
+ *         #address-cells = <2>;
+ *         #size-cells = <2>;
+ *
+ *         msc-0 {
+ *             reg = <0x0 0x2a4c0000 0x0 0x4000>;
+ *
+ *             partition-1 {
+ *                 partid = <1>;
+ *                 cache-portions = <0x0 0xff>;
+ *                 mbw-max-percent = <50>;
+ *                 mbw-min-percent = <10>;
+ *                 runtime-update;
+ *             };
+ *         };
+ *     };
+ */
+static int fconf_populate_mpam_msc(uintptr_t config)
+{
+	const void *fdt = (const void *)config;
+	struct mpam_msc_topology *topology = &fconf_mpam_msc_topology;
+	int parent;
+	int node;
+	int ret = 0;
+
+	parent = fdt_node_offset_by_compatible(fdt, -1, "arm,mpam-msc-config");
+	if (parent < 0) {
+		return 0;
+	}
+
+	fdt_for_each_subnode(node, fdt, parent) {
+		uintptr_t base;
+
+		if (topology->num_msc == PLAT_MPAM_MSC_MAX) {
+			ret = -FDT_ERR_NOSPACE;
+			break;
+		}
+
+		ret = fdt_get_reg_props_by_index(fdt, node, 0, &base, NULL);
+		if (ret < 0) {
+			break;
+		}
+
+		topology->msc_base[topology->num_msc] = base;
+
+		ret = fconf_populate_mpam_msc_parts(fdt, node,
+						    topology->num_msc);
+		if (ret < 0) {
+			break;
+		}
+
+		topology->num_msc++;
+	}
+
+	if (ret == 0) {
+		fconf_mpam_msc_config.topology = topology;
+	} else {
+		ERROR("FCONF: failed to parse MPAM MSC information: %d\n", ret);
+	}
+
+	return ret;
+}
+
+FCONF_REGISTER_POPULATOR(HW_CONFIG, mpam_msc, fconf_populate_mpam_msc);
@@ -1005,13 +1005,164 @@ static int gpt_check_transition_gpi(unsigned int src_sec_state,
 	return 0;
 }
 
+/*
+ * Get the L1 descriptor covering a PA. The L0 descriptor for the PA must be a
+ * table descriptor.
+ *
+ * Parameters
+ *   pa			PA to get the L1 descriptor of.
+ *
+ * Return
+ *   Pointer to the L1 descriptor.
+ */
+static uint64_t *gpt_get_l1_desc_addr(uint64_t pa)
+{
+	uint64_t *gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	uint64_t *gpt_l1_addr = GPT_L0_TBLD_ADDR(gpt_l0_base[GPT_L0_IDX(pa)]);
+
+	return &gpt_l1_addr[GPT_L1_IDX(gpt_config.p, pa)];
+}
+
+/*
+ * Get the number of granules from a PA to the end of its L1 descriptor, capped
+ * to the end of the range being transitioned.
+ *
+ * Parameters
+ *   pa			Current PA, aligned to the granule size.
+ *   end_pa		End PA of the range, aligned to the granule size.
+ *
+ * Return
+ *   Number of granules to process in the L1 descriptor.
+ */
+static unsigned int gpt_get_l1_desc_gran_cnt(uint64_t pa, uint64_t end_pa)
+{
+	unsigned int first = GPT_L1_GPI_IDX(gpt_config.p, pa);
+	uint64_t left = (end_pa - pa) >> gpt_config.p;
+
+	if (left < (GPT_L1_GPI_IDX_MASK + 1U - first)) {
+		return (unsigned int)left;
+	}
+
+	return GPT_L1_GPI_IDX_MASK + 1U - first;
+}
+
+/*
+ * Transition a range of granules to a new PAS. The whole range is checked
+ * before any descriptor is changed so that the request either fully succeeds
+ * or leaves the tables untouched. L1 descriptors fully covered by the range
+ * are checked and written as a whole, and the GPT TLB entries are invalidated
+ * once at the end.
+ *
+ * Parameters
+ *   base		Base address of the region to transition, aligned to
+ *			granule size.
+ *   size		Size of region to transition, aligned to granule size.
+ *   src_sec_state	Security state of the caller.
+ *   target_pas		Target PAS of the specified memory region.
+ *
+ * Return
+ *    Negative Linux error code in the event of a failure, 0 for success.
+ */
+static int gpt_transition_pas_range(uint64_t base, size_t size,
+				    unsigned int src_sec_state,
+				    unsigned int target_pas)
+{
+	uint64_t *gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	uint64_t *gpt_l1_desc_addr;
+	uint64_t gpt_l1_desc;
+	uint64_t end_pa = base + size;
+	uint64_t pa;
+	unsigned int gran_cnt;
+	unsigned int gpi_shift;
+	unsigned int gpi;
+	unsigned int i;
+
+	/* L0 descriptors do not change at runtime, check them all first. */
+	for (pa = base; pa < end_pa;
+	     pa = (pa & ~(GPT_L0_REGION_SIZE - 1U)) + GPT_L0_REGION_SIZE) {
+		if (GPT_L0_TYPE(gpt_l0_base[GPT_L0_IDX(pa)]) !=
+		    GPT_L0_TYPE_TBL_DESC) {
+			VERBOSE("[GPT] Granule is not covered by a table descriptor!\n");
+			VERBOSE("      Base=0x%" PRIx64 "\n", pa);
+			return -EINVAL;
+		}
+	}
+
+	spin_lock(&gpt_lock);
+
+	/* Make sure caller state and PAS are allowed for every granule. */
+	for (pa = base; pa < end_pa; pa += (uint64_t)gran_cnt << gpt_config.p) {
+		gpt_l1_desc = *gpt_get_l1_desc_addr(pa);
+		gran_cnt = gpt_get_l1_desc_gran_cnt(pa, end_pa);
+		gpi_shift = GPT_L1_GPI_IDX(gpt_config.p, pa) << 2;
+
+		for (i = 0U; i < gran_cnt; i++) {
+			gpi = (gpt_l1_desc >> (gpi_shift + (i << 2))) &
+			      GPT_L1_GRAN_DESC_GPI_MASK;
+
+			/* A uniform descriptor only needs one check. */
+			if ((i == 0U) &&
+			    (gran_cnt == (GPT_L1_GPI_IDX_MASK + 1U)) &&
+			    (gpt_l1_desc == GPT_BUILD_L1_DESC(gpi))) {
+				i = gran_cnt - 1U;
+			}
+
+			if (gpt_check_transition_gpi(src_sec_state, gpi,
+						     target_pas) < 0) {
+				spin_unlock(&gpt_lock);
+				VERBOSE("[GPT] Invalid caller state and PAS combo!\n");
+				VERBOSE("      Caller: %u, Current GPI: %u, Target GPI: %u\n",
+					src_sec_state, gpi, target_pas);
+				return -EPERM;
+			}
+		}
+	}
+
+	/* Transition the granules, a whole descriptor at a time if possible. */
+	for (pa = base; pa < end_pa; pa += (uint64_t)gran_cnt << gpt_config.p) {
+		gpt_l1_desc_addr = gpt_get_l1_desc_addr(pa);
+		gran_cnt = gpt_get_l1_desc_gran_cnt(pa, end_pa);
+
+		if (gran_cnt == (GPT_L1_GPI_IDX_MASK + 1U)) {
+			*gpt_l1_desc_addr = GPT_BUILD_L1_DESC(target_pas);
+			continue;
+		}
+
+		gpt_l1_desc = *gpt_l1_desc_addr;
+		gpi_shift = GPT_L1_GPI_IDX(gpt_config.p, pa) << 2;
+		for (i = 0U; i < gran_cnt; i++) {
+			gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK <<
+					 (gpi_shift + (i << 2)));
+			gpt_l1_desc |= (uint64_t)target_pas <<
+				       (gpi_shift + (i << 2));
+		}
+		*gpt_l1_desc_addr = gpt_l1_desc;
+	}
+
+	/* Ensure that the write operations will be observed by GPC */
+	dsbishst();
+
+	/* Unlock access to the L1 tables. */
+	spin_unlock(&gpt_lock);
+
+	/* A single invalidation covers the whole range. */
+	tlbipaallos();
+	dsb();
+	/*
+	 * The isb() will be done as part of context
+	 * synchronization when returning to lower EL
+	 */
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI->0x%x\n",
+		base, end_pa - 1U, target_pas);
+
+	return 0;
+}
+
 /*
  * This function is the core of the granule transition service. When a granule
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
- *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
@@ -1061,11 +1212,8 @@ int gpt_transition_pas(uint64_t base, size_t size, unsigned int src_sec_state,
 
 	/* See if this is a single granule transition or a range of granules. */
 	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		/*
-		 * TODO: Add support for transitioning multiple granules with a
-		 * single call to this function.
-		 */
-		panic();
+		return gpt_transition_pas_range(base, size, src_sec_state,
+						target_pas);
 	}
 
 	/* Get the L0 descriptor and make sure it is for a table. */
@@ -30,7 +30,8 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 			strtoul.c			\
 			strtoll.c			\
 			strtoull.c			\
-			strtol.c)
+			strtol.c			\
+			timingsafe_bcmp.c)
 
 ifeq (${ARCH},aarch64)
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
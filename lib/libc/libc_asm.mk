@@ -10,8 +10,6 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 			exit.c				\
 			memchr.c			\
 			memcmp.c			\
-			memcpy.c			\
-			memmove.c			\
 			memrchr.c			\
 			printf.c			\
 			putchar.c			\
@@ -29,16 +27,38 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 			strtoul.c			\
 			strtoll.c			\
 			strtoull.c			\
-			strtol.c)
+			strtol.c			\
+			timingsafe_bcmp.c)
 
 ifeq (${ARCH},aarch64)
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
+			memcpy.S			\
+			memmove.S			\
 			memset.S			\
 			setjmp.S)
 else
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch32/,	\
+			memcpy.S			\
+			memmove.S			\
 			memset.S)
 endif
 
+# The platform may set 'LIBC_ASM_NEON' to 1 so that the AArch32 memcpy and
+# memmove copy large blocks with NEON registers, when enabled in FPEXC. It
+# must not be set for images sharing NEON registers with the normal world.
+LIBC_ASM_NEON	?=	0
+$(eval $(call assert_boolean,LIBC_ASM_NEON))
+
+ifeq (${LIBC_ASM_NEON},1)
+    ifneq (${ARCH},aarch32)
+        $(error "LIBC_ASM_NEON=1 requires ARCH=aarch32")
+    endif
+    ifneq (${ARM_WITH_NEON},yes)
+        $(error "LIBC_ASM_NEON=1 requires ARM_WITH_NEON=yes")
+    endif
+endif
+
+$(eval $(call add_define,LIBC_ASM_NEON))
+
 INCLUDES	+=	-Iinclude/lib/libc		\
 			-Iinclude/lib/libc/$(ARCH)	\
@@ -5,6 +5,7 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 int memcmp(const void *s1, const void *s2, size_t len)
@@ -14,6 +15,24 @@ int memcmp(const void *s1, const void *s2, size_t len)
 	unsigned char sc;
 	unsigned char dc;
 
+	/*
+	 * Skip identical words when both buffers are word aligned, the first
+	 * different byte is then found by the byte loop.
+	 */
+	if ((((uintptr_t)s | (uintptr_t)d) & (sizeof(unsigned long) - 1U)) == 0U) {
+		const unsigned long *sw = (const unsigned long *)s;
+		const unsigned long *dw = (const unsigned long *)d;
+
+		while ((len >= sizeof(unsigned long)) && (*sw == *dw)) {
+			sw++;
+			dw++;
+			len -= sizeof(unsigned long);
+		}
+
+		s = (const unsigned char *)sw;
+		d = (const unsigned char *)dw;
+	}
+
 	while (len--) {
 		sc = *s++;
 		dc = *d++;
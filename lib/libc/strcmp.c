@@ -37,14 +37,37 @@
  * All rights reserved.
  */
 
+#include <stdint.h>
 #include <string.h>
 
+/* Non-zero if one of the bytes of x is zero */
+#define WORD_ONES	((unsigned long)-1 / 0xFFU)
+#define WORD_HAS_ZERO(x) \
+	(((x) - WORD_ONES) & ~(x) & (WORD_ONES * 0x80U))
+
 /*
  * Compare strings.
  */
 int
 strcmp(const char *s1, const char *s2)
 {
+	/*
+	 * Skip identical words without terminating byte when both strings are
+	 * word aligned. Aligned word reads never cross the end of a page.
+	 */
+	if ((((uintptr_t)s1 | (uintptr_t)s2) & (sizeof(unsigned long) - 1U)) == 0U) {
+		const unsigned long *w1 = (const unsigned long *)s1;
+		const unsigned long *w2 = (const unsigned long *)s2;
+
+		while ((*w1 == *w2) && (WORD_HAS_ZERO(*w1) == 0UL)) {
+			w1++;
+			w2++;
+		}
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
 	while (*s1 == *s2++)
 		if (*s1++ == '\0')
 			return (0);
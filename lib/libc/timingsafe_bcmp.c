@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Compare len bytes, return 0 if identical, non-zero otherwise. The execution
+ * time only depends on len, not on the buffers content, so it is used to
+ * check digests and other secret-dependent values.
+ */
+int timingsafe_bcmp(const void *b1, const void *b2, size_t len)
+{
+	const volatile unsigned char *p1 = b1;
+	const volatile unsigned char *p2 = b2;
+	unsigned char diff = 0U;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		diff |= p1[i] ^ p2[i];
+	}
+
+	return (int)diff;
+}
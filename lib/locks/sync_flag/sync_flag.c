@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+
+#include <arch_helpers.h>
+#include <lib/sync_flag.h>
+
+/*
+ * Publish a new state and wake up the CPUs waiting in WFE. The flag is
+ * cleaned to the point of coherency for waiters running with caches off.
+ */
+void sync_flag_set(sync_flag_t *flag, uint32_t state)
+{
+	assert(((uintptr_t)flag & (CACHE_WRITEBACK_GRANULE - 1U)) == 0U);
+
+	flag->state = state;
+
+	/* Cache maintenance completes with a DSB, ordering the store */
+	flush_dcache_range((uintptr_t)flag, sizeof(*flag));
+
+	sev();
+}
+
+/*
+ * Check the published state. A stale copy of the flag is invalidated first
+ * as the writer may run with caches off.
+ */
+bool sync_flag_test(sync_flag_t *flag, uint32_t state)
+{
+	inv_dcache_range((uintptr_t)flag, sizeof(*flag));
+
+	return flag->state == state;
+}
+
+/*
+ * Wait in WFE until the flag holds the awaited state. A SEV issued between
+ * the test and the WFE sets the event register, WFE then returns at once.
+ */
+void sync_flag_wait(sync_flag_t *flag, uint32_t state)
+{
+	while (!sync_flag_test(flag, state)) {
+		wfe();
+	}
+}
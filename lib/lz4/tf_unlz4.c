@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <common/image_decompress.h>
+#include <lib/utils_def.h>
+#include <tf_unlz4.h>
+
+/*
+ * LZ4 frame decoder, as produced by the lz4 command line tool. The decoder is
+ * a state machine that can be given the frame in chunks of any size. The
+ * output buffer holds the whole decompressed data, linked blocks matches are
+ * then read back in the output. Dictionaries are not supported, header, block
+ * and content checksums are skipped.
+ */
+
+#define LZ4_FRAME_MAGIC		0x184D2204U
+
+#define LZ4_FLG_VERSION_MASK	0xC0U
+#define LZ4_FLG_VERSION		0x40U
+#define LZ4_FLG_B_CHECKSUM	0x10U
+#define LZ4_FLG_C_SIZE		0x08U
+#define LZ4_FLG_C_CHECKSUM	0x04U
+#define LZ4_FLG_DICT_ID		0x01U
+
+#define LZ4_BD_MAX_SIZE_SHIFT	4
+#define LZ4_BD_MAX_SIZE_MASK	0x70U
+#define LZ4_BD_MAX_SIZE_MIN	4U
+
+#define LZ4_BLOCK_RAW		0x80000000U
+#define LZ4_BLOCK_SIZE_MASK	0x7FFFFFFFU
+
+#define LZ4_CHECKSUM_SIZE	4U
+#define LZ4_C_SIZE_SIZE		8U
+#define LZ4_HC_SIZE		1U
+
+#define LZ4_RUN_MASK		0x0FU
+#define LZ4_MIN_MATCH		4U
+
+enum lz4_step {
+	LZ4_MAGIC,
+	LZ4_FLG,
+	LZ4_BD,
+	LZ4_SKIP,
+	LZ4_BLOCK_SIZE,
+	LZ4_BLOCK_RAW_DATA,
+	LZ4_TOKEN,
+	LZ4_LIT_EXT,
+	LZ4_LITERALS,
+	LZ4_OFFSET_LO,
+	LZ4_OFFSET_HI,
+	LZ4_MATCH_EXT,
+	LZ4_MATCH_COPY,
+	LZ4_DONE,
+};
+
+struct lz4_state {
+	uint8_t *out_start;
+	uint8_t *out;
+	uint8_t *out_end;
+	enum lz4_step step;
+	enum lz4_step next;
+	uint32_t field;
+	unsigned int field_pos;
+	uint32_t skip;
+	uint8_t flg;
+	uint32_t block_max;
+	uint32_t block_left;
+	size_t lit_len;
+	size_t match_len;
+	uint32_t offset;
+};
+
+static struct lz4_state lz4_stream_state;
+
+static void lz4_init(struct lz4_state *s, uintptr_t out_buf, size_t out_len)
+{
+	memset(s, 0, sizeof(*s));
+	s->out_start = (uint8_t *)out_buf;
+	s->out = s->out_start;
+	s->out_end = s->out_start + out_len;
+	s->step = LZ4_MAGIC;
+}
+
+/* Skip len bytes of the frame, checksums or content size, then go on */
+static void lz4_skip(struct lz4_state *s, uint32_t len, enum lz4_step next)
+{
+	s->skip = len;
+	s->next = next;
+	s->step = (len != 0U) ? LZ4_SKIP : next;
+	s->field = 0U;
+}
+
+static void lz4_block_end(struct lz4_state *s)
+{
+	lz4_skip(s, ((s->flg & LZ4_FLG_B_CHECKSUM) != 0U) ?
+		 LZ4_CHECKSUM_SIZE : 0U, LZ4_BLOCK_SIZE);
+}
+
+/* Accumulate a little endian 32-bit field, return true once complete */
+static bool lz4_field(struct lz4_state *s, uint8_t byte)
+{
+	s->field |= (uint32_t)byte << (8U * s->field_pos);
+	s->field_pos++;
+
+	if (s->field_pos < sizeof(uint32_t)) {
+		return false;
+	}
+
+	s->field_pos = 0U;
+
+	return true;
+}
+
+/* Read the next byte of the current block */
+static int lz4_block_byte(struct lz4_state *s, const uint8_t **in,
+			  uint8_t *byte)
+{
+	if (s->block_left == 0U) {
+		ERROR("lz4: truncated block\n");
+		return -EIO;
+	}
+
+	*byte = *(*in)++;
+	s->block_left--;
+
+	return 0;
+}
+
+static int lz4_copy(struct lz4_state *s, const uint8_t **in,
+		    const uint8_t *in_end, size_t *left)
+{
+	size_t len = MIN(*left, (size_t)(in_end - *in));
+
+	if (len > (size_t)(s->out_end - s->out)) {
+		ERROR("lz4: output buffer full\n");
+		return -EFBIG;
+	}
+
+	memcpy(s->out, *in, len);
+	s->out += len;
+	*in += len;
+	*left -= len;
+	s->block_left -= len;
+
+	return 0;
+}
+
+static int lz4_match_copy(struct lz4_state *s)
+{
+	const uint8_t *src = s->out - s->offset;
+	size_t len = s->match_len + LZ4_MIN_MATCH;
+	size_t i;
+
+	if (len > (size_t)(s->out_end - s->out)) {
+		ERROR("lz4: output buffer full\n");
+		return -EFBIG;
+	}
+
+	if (s->offset >= len) {
+		memcpy(s->out, src, len);
+	} else {
+		/* Overlapping match, repeating the last offset bytes */
+		for (i = 0U; i < len; i++) {
+			s->out[i] = src[i];
+		}
+	}
+
+	s->out += len;
+
+	return 0;
+}
+
+/*
+ * Process the input available, return 0 once all of it is consumed, 1 at the
+ * end of the frame, a negative error code otherwise. *in is updated to the
+ * first byte not consumed.
+ */
+static int lz4_run(struct lz4_state *s, const uint8_t **in,
+		   const uint8_t *in_end)
+{
+	uint8_t byte;
+	int ret = 0;
+
+	while (ret == 0) {
+		if (s->step == LZ4_DONE) {
+			return 1;
+		}
+
+		if ((*in == in_end) && (s->step != LZ4_MATCH_COPY)) {
+			return 0;
+		}
+
+		switch (s->step) {
+		case LZ4_MAGIC:
+			if (lz4_field(s, *(*in)++)) {
+				if (s->field != LZ4_FRAME_MAGIC) {
+					ERROR("lz4: bad frame magic\n");
+					return -EIO;
+				}
+
+				s->step = LZ4_FLG;
+			}
+			break;
+
+		case LZ4_FLG:
+			s->flg = *(*in)++;
+			if (((s->flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+			    ((s->flg & LZ4_FLG_DICT_ID) != 0U)) {
+				ERROR("lz4: unsupported frame flags 0x%x\n",
+				      s->flg);
+				return -EIO;
+			}
+
+			s->step = LZ4_BD;
+			break;
+
+		case LZ4_BD:
+			byte = (*(*in)++ & LZ4_BD_MAX_SIZE_MASK) >>
+			       LZ4_BD_MAX_SIZE_SHIFT;
+			if (byte < LZ4_BD_MAX_SIZE_MIN) {
+				ERROR("lz4: bad block maximum size\n");
+				return -EIO;
+			}
+
+			/* Block maximum sizes 4 to 7 are 64KB to 4MB */
+			s->block_max = 1U << (8U + (2U * byte));
+			lz4_skip(s, (((s->flg & LZ4_FLG_C_SIZE) != 0U) ?
+				     LZ4_C_SIZE_SIZE : 0U) + LZ4_HC_SIZE,
+				 LZ4_BLOCK_SIZE);
+			break;
+
+		case LZ4_SKIP:
+			(*in)++;
+			s->skip--;
+			if (s->skip == 0U) {
+				s->step = s->next;
+			}
+			break;
+
+		case LZ4_BLOCK_SIZE:
+			if (!lz4_field(s, *(*in)++)) {
+				break;
+			}
+
+			s->block_left = s->field & LZ4_BLOCK_SIZE_MASK;
+			if (s->field == 0U) {
+				/* EndMark */
+				lz4_skip(s, ((s->flg & LZ4_FLG_C_CHECKSUM) != 0U) ?
+					 LZ4_CHECKSUM_SIZE : 0U, LZ4_DONE);
+				break;
+			}
+
+			if ((s->block_left == 0U) ||
+			    (s->block_left > s->block_max)) {
+				ERROR("lz4: bad block size 0x%x\n",
+				      s->block_left);
+				return -EIO;
+			}
+
+			if ((s->field & LZ4_BLOCK_RAW) != 0U) {
+				s->step = LZ4_BLOCK_RAW_DATA;
+			} else {
+				s->step = LZ4_TOKEN;
+			}
+			break;
+
+		case LZ4_BLOCK_RAW_DATA:
+			s->lit_len = s->block_left;
+			ret = lz4_copy(s, in, in_end, &s->lit_len);
+			if ((ret == 0) && (s->block_left == 0U)) {
+				lz4_block_end(s);
+			}
+			break;
+
+		case LZ4_TOKEN:
+			ret = lz4_block_byte(s, in, &byte);
+			if (ret != 0) {
+				break;
+			}
+
+			s->lit_len = byte >> 4;
+			s->match_len = byte & LZ4_RUN_MASK;
+			s->step = (s->lit_len == LZ4_RUN_MASK) ?
+				  LZ4_LIT_EXT : LZ4_LITERALS;
+			break;
+
+		case LZ4_LIT_EXT:
+			ret = lz4_block_byte(s, in, &byte);
+			if (ret != 0) {
+				break;
+			}
+
+			s->lit_len += byte;
+			if (byte != UINT8_MAX) {
+				s->step = LZ4_LITERALS;
+			}
+			break;
+
+		case LZ4_LITERALS:
+			if (s->lit_len > s->block_left) {
+				ERROR("lz4: literals out of block\n");
+				return -EIO;
+			}
+
+			ret = lz4_copy(s, in, in_end, &s->lit_len);
+			if ((ret != 0) || (s->lit_len != 0U)) {
+				break;
+			}
+
+			if (s->block_left == 0U) {
+				/* Last sequence of the block has no match */
+				lz4_block_end(s);
+			} else {
+				s->step = LZ4_OFFSET_LO;
+			}
+			break;
+
+		case LZ4_OFFSET_LO:
+			ret = lz4_block_byte(s, in, &byte);
+			if (ret != 0) {
+				break;
+			}
+
+			s->offset = byte;
+			s->step = LZ4_OFFSET_HI;
+			break;
+
+		case LZ4_OFFSET_HI:
+			ret = lz4_block_byte(s, in, &byte);
+			if (ret != 0) {
+				break;
+			}
+
+			s->offset |= (uint32_t)byte << 8;
+			if ((s->offset == 0U) ||
+			    (s->offset > (size_t)(s->out - s->out_start))) {
+				ERROR("lz4: bad match offset 0x%x\n",
+				      s->offset);
+				return -EIO;
+			}
+
+			s->step = (s->match_len == LZ4_RUN_MASK) ?
+				  LZ4_MATCH_EXT : LZ4_MATCH_COPY;
+			break;
+
+		case LZ4_MATCH_EXT:
+			ret = lz4_block_byte(s, in, &byte);
+			if (ret != 0) {
+				break;
+			}
+
+			s->match_len += byte;
+			if (byte != UINT8_MAX) {
+				s->step = LZ4_MATCH_COPY;
+			}
+			break;
+
+		case LZ4_MATCH_COPY:
+			ret = lz4_match_copy(s);
+			if (s->block_left == 0U) {
+				lz4_block_end(s);
+			} else {
+				s->step = LZ4_TOKEN;
+			}
+			break;
+
+		default:
+			return -EIO;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * unlz4 - decompress a LZ4 frame
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace, unused
+ * @work_len: length of workspace
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	struct lz4_state s;
+	const uint8_t *in = (const uint8_t *)*in_buf;
+	int ret;
+
+	lz4_init(&s, *out_buf, out_len);
+
+	ret = lz4_run(&s, &in, in + in_len);
+	if (ret == 0) {
+		ERROR("lz4: truncated frame\n");
+		ret = -EIO;
+	}
+
+	VERBOSE("lz4: %lu byte input\n", (unsigned long)(in - (const uint8_t *)*in_buf));
+	VERBOSE("lz4: %lu byte output\n", (unsigned long)(s.out - s.out_start));
+
+	*in_buf = (uintptr_t)in;
+	*out_buf = (uintptr_t)s.out;
+
+	return (ret < 0) ? ret : 0;
+}
+
+/*
+ * unlz4_stream_probe - check whether data starts with a LZ4 frame magic
+ * @in_buf: first bytes of the data
+ * @in_len: number of bytes available in in_buf
+ */
+bool unlz4_stream_probe(uintptr_t in_buf, size_t in_len)
+{
+	const uint8_t *magic = (const uint8_t *)in_buf;
+
+	return (in_len >= sizeof(uint32_t)) &&
+	       ((magic[0] | ((uint32_t)magic[1] << 8) |
+		 ((uint32_t)magic[2] << 16) | ((uint32_t)magic[3] << 24)) ==
+		LZ4_FRAME_MAGIC);
+}
+
+/*
+ * unlz4_stream_init - start decompressing a LZ4 frame given in chunks
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace, unused
+ * @work_len: length of workspace
+ */
+int unlz4_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		      size_t work_len)
+{
+	lz4_init(&lz4_stream_state, out_buf, out_len);
+
+	return 0;
+}
+
+/*
+ * unlz4_stream_update - decompress the next chunk of a LZ4 frame
+ * @in_buf: chunk of compressed input
+ * @in_len: length of in_buf
+ *
+ * Return 0 when more input is expected, 1 once the end of the frame is
+ * reached, a negative error code otherwise.
+ */
+int unlz4_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	const uint8_t *in = (const uint8_t *)in_buf;
+
+	return lz4_run(&lz4_stream_state, &in, in + in_len);
+}
+
+/*
+ * unlz4_stream_end - complete the decompression of a LZ4 frame
+ * @out_buf: upon exit, the end of output
+ */
+int unlz4_stream_end(uintptr_t *out_buf)
+{
+	struct lz4_state *s = &lz4_stream_state;
+
+	VERBOSE("lz4: %lu byte output\n", (unsigned long)(s->out - s->out_start));
+
+	*out_buf = (uintptr_t)s->out;
+
+	return 0;
+}
+
+const decompressor_stream_t unlz4_stream = {
+	.probe = unlz4_stream_probe,
+	.init = unlz4_stream_init,
+	.update = unlz4_stream_update,
+	.end = unlz4_stream_end,
+};
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -49,6 +50,16 @@ static int pmf_svc_descs_indices[PMF_SVC_DESCS_MAX];
  */
 static int pmf_num_services;
 
+/*
+ * Range of the timestamps of each CPU stored without cache maintenance since
+ * the last pmf_flush_deferred_timestamps(). A CPU only writes its own entry,
+ * which is cache line aligned.
+ */
+static struct pmf_deferred_range {
+	uintptr_t start;
+	uintptr_t end;
+} __aligned(CACHE_WRITEBACK_GRANULE) pmf_deferred[PLATFORM_CORE_COUNT];
+
 /*
  * This is the main PMF function that initialize registered
  * PMF services and also sort them in ascending order.
@@ -235,6 +246,48 @@ void __pmf_store_timestamp_with_cache_maint(uintptr_t base_addr,
 	flush_dcache_range((uintptr_t)ts_addr, sizeof(unsigned long long));
 }
 
+/*
+ * This is the deferred version of `pmf_store_my_timestamp`: the timestamp is
+ * only added to the range of the current cpu that the next
+ * pmf_flush_deferred_timestamps() cleans, with a single cache maintenance for
+ * all the timestamps of a group of events.
+ */
+void __pmf_store_timestamp_deferred(uintptr_t base_addr,
+			unsigned int tid,
+			unsigned long long ts)
+{
+	struct pmf_deferred_range *range = &pmf_deferred[plat_my_core_pos()];
+	uintptr_t ts_addr = calc_ts_addr(base_addr, tid, plat_my_core_pos());
+
+	*(unsigned long long *)ts_addr = ts;
+
+	if ((range->end == 0U) || (ts_addr < range->start)) {
+		range->start = ts_addr;
+	}
+
+	if ((ts_addr + sizeof(unsigned long long)) > range->end) {
+		range->end = ts_addr + sizeof(unsigned long long);
+	}
+}
+
+/*
+ * Clean the timestamps stored with PMF_CACHE_MAINT_DEFER by the current cpu,
+ * at the end of a group of events, so that they can be read from the other
+ * cpus or with caches disabled.
+ */
+void pmf_flush_deferred_timestamps(void)
+{
+	struct pmf_deferred_range *range = &pmf_deferred[plat_my_core_pos()];
+
+	if (range->end == 0U) {
+		return;
+	}
+
+	flush_dcache_range(range->start, range->end - range->start);
+	range->start = 0U;
+	range->end = 0U;
+}
+
 /*
  * This function retrieves the `ts` value from the storage identified by
  * `base_addr`, `tid` and `cpuid`.
@@ -46,6 +46,40 @@ int psci_cpu_on(u_register_t target_cpu,
 	return psci_cpu_on_start(target_cpu, &ep);
 }
 
+/*******************************************************************************
+ * Turn on a set of cpus, all entering the non-secure world at the same entry
+ * point. This is not a PSCI spec call: a platform may expose it through its
+ * SiP service, to boot many secondary cpus in one SMC.
+ ******************************************************************************/
+int psci_cpu_on_batch(const u_register_t *target_cpus, unsigned int count,
+		      uintptr_t entrypoint, u_register_t context_id)
+{
+	int rc;
+	unsigned int i;
+	entry_point_info_t ep;
+
+	if ((target_cpus == NULL) || (count == 0U) ||
+	    (count > psci_plat_core_count)) {
+		return PSCI_E_INVALID_PARAMS;
+	}
+
+	/* Determine if the cpus exist or not */
+	for (i = 0U; i < count; i++) {
+		rc = psci_validate_mpidr(target_cpus[i]);
+		if (rc != PSCI_E_SUCCESS) {
+			return PSCI_E_INVALID_PARAMS;
+		}
+	}
+
+	/* Validate the entry point and get the entry_point_info */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS) {
+		return rc;
+	}
+
+	return psci_cpu_on_batch_start(target_cpus, count, &ep);
+}
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
@@ -95,6 +129,11 @@ int psci_cpu_suspend(unsigned int power_state,
 		cpu_pd_state = state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
 		psci_set_cpu_local_state(cpu_pd_state);
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+		/* Mark the start of the entry for latency histograms */
+		psci_stats_update_pwr_down(PSCI_CPU_PWR_LVL, &state_info);
+#endif
+
 #if ENABLE_PSCI_STAT
 		plat_psci_stat_accounting_start(&state_info);
 #endif
@@ -373,14 +412,14 @@ int psci_features(unsigned int psci_fid)
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
-u_register_t psci_smc_handler(uint32_t smc_fid,
-			  u_register_t x1,
-			  u_register_t x2,
-			  u_register_t x3,
-			  u_register_t x4,
-			  void *cookie,
-			  void *handle,
-			  u_register_t flags)
+u_register_t __hot psci_smc_handler(uint32_t smc_fid,
+				    u_register_t x1,
+				    u_register_t x2,
+				    u_register_t x3,
+				    u_register_t x4,
+				    void *cookie,
+				    void *handle,
+				    u_register_t flags)
 {
 	u_register_t ret;
 
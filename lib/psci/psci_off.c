@@ -98,12 +98,14 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
 	/*
-	 * Flush cache line so that even if CPU power down happens
-	 * the timestamp update is reflected in memory.
+	 * Flush the cache lines of the timestamps of this PSCI call at once,
+	 * so that even if CPU power down happens the timestamp updates are
+	 * reflected in memory.
 	 */
 	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
 		RT_INSTR_ENTER_CFLUSH,
-		PMF_CACHE_MAINT);
+		PMF_CACHE_MAINT_DEFER);
+	pmf_flush_deferred_timestamps();
 #endif
 
 	/*
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include <arch.h>
@@ -161,6 +162,127 @@ exit:
 	return rc;
 }
 
+/*******************************************************************************
+ * Same as psci_cpu_on_start() for a set of target cpus, all entering the
+ * non-secure world at the same entry point. The targets are checked and
+ * marked ON_PENDING together, with one cache flush of the per-cpu data, then
+ * the platform starts powering each of them on. The optional
+ * pwr_domain_on_batch_end() hook is then called once, so that the platform
+ * can overlap the power up sequences of all targets before waiting for them.
+ *
+ * Either all the targets are OFF and are turned on, or none is.
+ ******************************************************************************/
+int psci_cpu_on_batch_start(const u_register_t *target_cpus,
+			    unsigned int count,
+			    const entry_point_info_t *ep)
+{
+	bool target[PLATFORM_CORE_COUNT] = { false };
+	unsigned int idx;
+	unsigned int i;
+	int rc = PSCI_E_SUCCESS;
+
+	assert((target_cpus != NULL) && (ep != NULL));
+	assert((psci_plat_pm_ops->pwr_domain_on != NULL) &&
+	       (psci_plat_pm_ops->pwr_domain_on_finish != NULL));
+
+	for (i = 0U; i < count; i++) {
+		int ret = plat_core_pos_by_mpidr(target_cpus[i]);
+
+		/* Calling function must supply valid input arguments */
+		assert(ret >= 0);
+		target[ret] = true;
+	}
+
+	/* Take the target locks in index order, to not deadlock */
+	for (idx = 0U; idx < psci_plat_core_count; idx++) {
+		if (target[idx]) {
+			psci_spin_lock_cpu(idx);
+		}
+	}
+
+	/* Flush all the target states at once, see psci_cpu_on_start() */
+	flush_dcache_range((uintptr_t)percpu_data,
+			   sizeof(cpu_data_t) * psci_plat_core_count);
+
+	for (idx = 0U; idx < psci_plat_core_count; idx++) {
+		if (!target[idx]) {
+			continue;
+		}
+
+		rc = cpu_on_validate_state(psci_get_aff_info_state_by_idx(idx));
+		if (rc != PSCI_E_SUCCESS) {
+			goto exit;
+		}
+	}
+
+	for (idx = 0U; idx < psci_plat_core_count; idx++) {
+		if (!target[idx]) {
+			continue;
+		}
+
+		if ((psci_spd_pm != NULL) && (psci_spd_pm->svc_on != NULL)) {
+			psci_spd_pm->svc_on(psci_cpu_pd_nodes[idx].mpidr);
+		}
+
+		psci_set_aff_info_state_by_idx(idx, AFF_STATE_ON_PENDING);
+	}
+
+	flush_dcache_range((uintptr_t)percpu_data,
+			   sizeof(cpu_data_t) * psci_plat_core_count);
+
+	for (idx = 0U; idx < psci_plat_core_count; idx++) {
+		if (!target[idx]) {
+			continue;
+		}
+
+		/* A target still powering down may have dropped the update */
+		if (psci_get_aff_info_state_by_idx(idx) != AFF_STATE_ON_PENDING) {
+			assert(psci_get_aff_info_state_by_idx(idx) ==
+			       AFF_STATE_OFF);
+			psci_set_aff_info_state_by_idx(idx,
+						       AFF_STATE_ON_PENDING);
+			flush_cpu_data_by_index(idx,
+						psci_svc_cpu_data.aff_info_state);
+		}
+	}
+
+	for (idx = 0U; idx < psci_plat_core_count; idx++) {
+		int ret;
+
+		if (!target[idx]) {
+			continue;
+		}
+
+		ret = psci_plat_pm_ops->pwr_domain_on(
+					psci_cpu_pd_nodes[idx].mpidr);
+		assert((ret == PSCI_E_SUCCESS) || (ret == PSCI_E_INTERN_FAIL));
+
+		if (ret == PSCI_E_SUCCESS) {
+			/* Store the non-secure world re-entry information */
+			cm_init_context_by_index(idx, ep);
+		} else {
+			/* Restore the state on error. */
+			psci_set_aff_info_state_by_idx(idx, AFF_STATE_OFF);
+			flush_cpu_data_by_index(idx,
+						psci_svc_cpu_data.aff_info_state);
+			rc = ret;
+		}
+	}
+
+	if (psci_plat_pm_ops->pwr_domain_on_batch_end != NULL) {
+		psci_plat_pm_ops->pwr_domain_on_batch_end();
+	}
+
+exit:
+	for (idx = psci_plat_core_count; idx > 0U; idx--) {
+		if (target[idx - 1U]) {
+			psci_spin_unlock_cpu(idx - 1U);
+		}
+	}
+
+	return rc;
+}
+
 /*******************************************************************************
  * The following function finish an earlier power on request. They
  * are called by the common finisher routine in psci_common.c. The `state_info`
@@ -7,6 +7,7 @@
 #ifndef PSCI_PRIVATE_H
 #define PSCI_PRIVATE_H
 
+#include <assert.h>
 #include <stdbool.h>
 
 #include <arch.h>
@@ -204,12 +205,27 @@ static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 }
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
+#if PSCI_SINGLE_CLUSTER_LOCKS
+/*
+ * On single cluster systems that enable the data cache early on warm boot,
+ * locks are only taken by coherent CPUs. Use one spinlock word per power
+ * domain, alone in its cache line as a CPU may release it after it left
+ * coherency.
+ */
+typedef struct psci_spinlock {
+	spinlock_t lock;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_spinlock_t;
+
+#define DEFINE_PSCI_LOCK(_name)		psci_spinlock_t _name
+#define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
+#else
 /*
  * Use bakery locks for state coordination as not all PSCI participants are
  * cache coherent.
  */
 #define DEFINE_PSCI_LOCK(_name)		DEFINE_BAKERY_LOCK(_name)
 #define DECLARE_PSCI_LOCK(_name)	DECLARE_BAKERY_LOCK(_name)
+#endif
 
 /* One lock is required per non-CPU power domain node */
 DECLARE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
@@ -231,6 +247,49 @@ static inline void psci_dsbish(void)
 	dsbish();
 }
 
+#if PSCI_SINGLE_CLUSTER_LOCKS
+static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	spinlock_t *lock = &psci_locks[non_cpu_pd_node->lock_index].lock;
+
+	assert(is_dcache_enabled());
+
+	for (;;) {
+		/* Drop a stale copy of a lock released with caches disabled */
+		dccivac((uintptr_t)lock);
+		dsbish();
+
+		if (spin_trylock(lock)) {
+			break;
+		}
+
+		/* The release is always followed by an event */
+		wfe();
+	}
+}
+
+static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	spinlock_t *lock = &psci_locks[non_cpu_pd_node->lock_index].lock;
+
+	if (is_dcache_enabled()) {
+		spin_unlock(lock);
+		return;
+	}
+
+	/*
+	 * This CPU left coherency: write the lock to memory and invalidate
+	 * the copy that may remain in an outer cache from the power down
+	 * cache flush.
+	 */
+	dmbish();
+	lock->lock = 0U;
+	dsbish();
+	dcivac((uintptr_t)lock);
+	dsbish();
+	sev();
+}
+#else
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	bakery_lock_get(&psci_locks[non_cpu_pd_node->lock_index]);
@@ -240,6 +299,7 @@ static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	bakery_lock_release(&psci_locks[non_cpu_pd_node->lock_index]);
 }
+#endif /* PSCI_SINGLE_CLUSTER_LOCKS */
 
 #endif /* HW_ASSISTED_COHERENCY */
 
@@ -302,6 +362,9 @@ void psci_do_pwrdown_sequence(unsigned int power_level);
 void prepare_cpu_pwr_dwn(unsigned int power_level);
 
 /* Private exported functions from psci_on.c */
+int psci_cpu_on_batch_start(const u_register_t *target_cpus,
+			    unsigned int count,
+			    const entry_point_info_t *ep);
 int psci_cpu_on_start(u_register_t target_cpu,
 		      const entry_point_info_t *ep);
 
@@ -13,6 +13,7 @@
 #include <context.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/cpus/errata_report.h>
+#include <lib/per_cpu.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -29,7 +30,7 @@ CASSERT(PLATFORM_CORE_COUNT <= (PSCI_MAX_CPUS_INDEX + 1U), assert_psci_cores_ove
  * TODO: Use the memory allocator to set aside memory for the contexts instead
  * of relying on platform defined constants.
  ******************************************************************************/
-static cpu_context_t psci_ns_context[PLATFORM_CORE_COUNT];
+static DEFINE_PER_CPU(cpu_context_t, psci_ns_context);
 
 /******************************************************************************
  * Define the psci capability variable.
@@ -78,7 +79,7 @@ static void __init psci_init_pwr_domain_node(uint16_t node_idx,
 						 sizeof(*svc_cpu_data));
 
 		cm_set_context_by_index(node_idx,
-					(void *) &psci_ns_context[node_idx],
+					(void *)PER_CPU_BY_INDEX(psci_ns_context, node_idx),
 					NON_SECURE);
 	}
 }
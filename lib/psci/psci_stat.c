@@ -8,7 +8,9 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
+#include <lib/per_cpu.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -34,11 +36,117 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
+static DEFINE_PER_CPU(psci_stat_t, psci_cpu_stat[PLAT_MAX_PWR_LVL_STATES]);
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+/* Following structure is used for PSCI STAT histograms of a CPU power state */
+typedef struct psci_stat_hist {
+	u_register_t count[PSCI_STAT_HIST_TYPES][PSCI_STAT_HIST_BUCKETS];
+} psci_stat_hist_t;
+
+/*
+ * Following structure stores the timestamps of the last low power entry of a
+ * CPU: when PSCI starts powering down, when the platform enters and when it
+ * exits the hardware low power state. The latter ones may be captured with
+ * caches off, so timestamps are kept in their own cache lines, cleaned after
+ * each capture on the power down path and invalidated before being read.
+ */
+typedef struct psci_stat_ts {
+	unsigned long long pwr_down;
+	unsigned long long hw_enter;
+	unsigned long long hw_exit;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_stat_ts_t;
+
+static DEFINE_PER_CPU(psci_stat_hist_t,
+		      psci_cpu_stat_hist[PLAT_MAX_PWR_LVL_STATES]);
+static DEFINE_PER_CPU(psci_stat_ts_t, psci_cpu_stat_ts);
+
+static void stat_ts_capture(unsigned long long *ts,
+			    plat_local_state_t cpu_state)
+{
+	*ts = read_cntpct_el0();
+
+	if (is_local_state_off(cpu_state) != 0)
+		flush_dcache_range((uintptr_t)ts, sizeof(*ts));
+}
+
+static unsigned int stat_hist_bucket(u_register_t value)
+{
+	unsigned int bucket = 0U;
+
+	while ((value > 1U) && (bucket < (PSCI_STAT_HIST_BUCKETS - 1U))) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+static u_register_t stat_ticks_to_us(unsigned long long ticks)
+{
+	u_register_t ticks_per_us = read_cntfrq_el0() / MHZ_TICKS_PER_SEC;
+
+	assert(ticks_per_us > 0U);
+
+	return (u_register_t)(ticks / ticks_per_us);
+}
+
+/*******************************************************************************
+ * Platform hooks capturing when the CPU enters and exits the hardware low power
+ * state of `cpu_state`, the local state of the CPU power domain. They are
+ * optional: latencies are only accounted when both timestamps are captured.
+ ******************************************************************************/
+void psci_stats_hw_low_pwr_enter(plat_local_state_t cpu_state)
+{
+	psci_stat_ts_t *ts = PER_CPU_CUR(psci_cpu_stat_ts);
+
+	stat_ts_capture(&ts->hw_enter, cpu_state);
+}
+
+void psci_stats_hw_low_pwr_exit(plat_local_state_t cpu_state)
+{
+	psci_stat_ts_t *ts = PER_CPU_CUR(psci_cpu_stat_ts);
+
+	stat_ts_capture(&ts->hw_exit, cpu_state);
+}
+
+/*
+ * This function updates the histograms of the CPU power state `stat_idx`
+ * with the residency and, when the platform captured them, the entry and exit
+ * latencies of the low power state the CPU has just left.
+ */
+static void stat_hist_update_pwr_up(unsigned int cpu_idx, int stat_idx,
+				    plat_local_state_t cpu_state,
+				    u_register_t residency)
+{
+	psci_stat_hist_t *hist =
+		&(*PER_CPU_BY_INDEX(psci_cpu_stat_hist, cpu_idx))[stat_idx];
+	psci_stat_ts_t *ts = PER_CPU_BY_INDEX(psci_cpu_stat_ts, cpu_idx);
+	unsigned long long pwr_up = read_cntpct_el0();
+	u_register_t latency;
+
+	hist->count[PSCI_STAT_HIST_RESIDENCY][stat_hist_bucket(residency)]++;
+
+	if (is_local_state_off(cpu_state) != 0)
+		inv_dcache_range((uintptr_t)ts, sizeof(*ts));
+
+	if ((ts->hw_enter != 0U) && (ts->hw_exit != 0U)) {
+		latency = stat_ticks_to_us(ts->hw_enter - ts->pwr_down);
+		hist->count[PSCI_STAT_HIST_ENTRY_LATENCY]
+			   [stat_hist_bucket(latency)]++;
+
+		latency = stat_ticks_to_us(pwr_up - ts->hw_exit);
+		hist->count[PSCI_STAT_HIST_EXIT_LATENCY]
+			   [stat_hist_bucket(latency)]++;
+	}
+
+	ts->hw_enter = 0U;
+	ts->hw_exit = 0U;
+}
+#endif /* ENABLE_PSCI_STAT_HISTOGRAM */
+
 /*
  * This functions returns the index into the `psci_stat_t` array given the
  * local power state and power domain level. If the platform implements the
@@ -78,10 +186,20 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 {
 	unsigned int lvl, parent_idx;
 	unsigned int cpu_idx = plat_my_core_pos();
+#if ENABLE_PSCI_STAT_HISTOGRAM
+	psci_stat_ts_t *ts = PER_CPU_BY_INDEX(psci_cpu_stat_ts, cpu_idx);
+#endif
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info != NULL);
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+	ts->hw_enter = 0U;
+	ts->hw_exit = 0U;
+	stat_ts_capture(&ts->pwr_down,
+			state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+#endif
+
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 
 	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
@@ -114,6 +232,7 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	int stat_idx;
 	plat_local_state_t local_state;
 	u_register_t residency;
+	psci_stat_t *stat;
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info != NULL);
@@ -127,8 +246,13 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	stat = &(*PER_CPU_BY_INDEX(psci_cpu_stat, cpu_idx))[stat_idx];
+	stat->residency += residency;
+	stat->count++;
+
+#if ENABLE_PSCI_STAT_HISTOGRAM
+	stat_hist_update_pwr_up(cpu_idx, stat_idx, local_state, residency);
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
@@ -168,16 +292,16 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 }
 
 /*******************************************************************************
- * This function returns the appropriate count and residency time of the
- * local state for the highest power level expressed in the `power_state`
- * for the node represented by `target_cpu`.
+ * This function returns the highest power level expressed in the `power_state`,
+ * the index of the power domain node at this level for the node represented by
+ * `target_cpu`, and the index of its local state into the stats arrays.
  ******************************************************************************/
-static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
-			 psci_stat_t *psci_stat)
+static int psci_get_stat_idx(u_register_t target_cpu, unsigned int power_state,
+			     unsigned int *pwrlvl, unsigned int *node_idx,
+			     int *stat_idx)
 {
 	int rc;
-	unsigned int pwrlvl, lvl, parent_idx, target_idx;
-	int stat_idx;
+	unsigned int lvl, parent_idx, target_idx;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 	plat_local_state_t local_state;
 
@@ -197,32 +321,95 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 		return PSCI_E_INVALID_PARAMS;
 
 	/* Find the highest power level */
-	pwrlvl = psci_find_target_suspend_lvl(&state_info);
-	if (pwrlvl == PSCI_INVALID_PWR_LVL) {
+	*pwrlvl = psci_find_target_suspend_lvl(&state_info);
+	if (*pwrlvl == PSCI_INVALID_PWR_LVL) {
 		ERROR("Invalid target power level for PSCI statistics operation\n");
 		panic();
 	}
 
 	/* Get the index into the stats array */
-	local_state = state_info.pwr_domain_state[pwrlvl];
-	stat_idx = get_stat_idx(local_state, pwrlvl);
+	local_state = state_info.pwr_domain_state[*pwrlvl];
+	*stat_idx = get_stat_idx(local_state, *pwrlvl);
 
-	if (pwrlvl > PSCI_CPU_PWR_LVL) {
+	if (*pwrlvl > PSCI_CPU_PWR_LVL) {
 		/* Get the power domain index */
 		parent_idx = SPECULATION_SAFE_VALUE(psci_cpu_pd_nodes[target_idx].parent_node);
-		for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < pwrlvl; lvl++)
+		for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < *pwrlvl; lvl++)
 			parent_idx = SPECULATION_SAFE_VALUE(psci_non_cpu_pd_nodes[parent_idx].parent_node);
 
+		*node_idx = parent_idx;
+	} else {
+		*node_idx = target_idx;
+	}
+
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * This function returns the appropriate count and residency time of the
+ * local state for the highest power level expressed in the `power_state`
+ * for the node represented by `target_cpu`.
+ ******************************************************************************/
+static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
+			 psci_stat_t *psci_stat)
+{
+	int rc;
+	unsigned int pwrlvl, node_idx;
+	int stat_idx;
+
+	rc = psci_get_stat_idx(target_cpu, power_state, &pwrlvl, &node_idx,
+			       &stat_idx);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	if (pwrlvl > PSCI_CPU_PWR_LVL) {
 		/* Get the non cpu power domain stats */
-		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
+		*psci_stat = psci_non_cpu_stat[node_idx][stat_idx];
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat =
+			(*PER_CPU_BY_INDEX(psci_cpu_stat, node_idx))[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
 }
 
+#if ENABLE_PSCI_STAT_HISTOGRAM
+/*******************************************************************************
+ * This function returns the count of the bucket `bucket` of the histogram
+ * `type` of the CPU local state expressed in the `power_state` for the CPU
+ * represented by `target_cpu`. Only CPU power domain histograms are kept.
+ ******************************************************************************/
+int psci_stat_histogram(u_register_t target_cpu, unsigned int power_state,
+			unsigned int type, unsigned int bucket,
+			u_register_t *count)
+{
+	int rc;
+	unsigned int pwrlvl, node_idx;
+	int stat_idx;
+	const psci_stat_hist_t *hist;
+
+	if ((type >= PSCI_STAT_HIST_TYPES) ||
+	    (bucket >= PSCI_STAT_HIST_BUCKETS))
+		return PSCI_E_INVALID_PARAMS;
+
+	rc = psci_get_stat_idx(target_cpu, power_state, &pwrlvl, &node_idx,
+			       &stat_idx);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	if (pwrlvl != PSCI_CPU_PWR_LVL)
+		return PSCI_E_INVALID_PARAMS;
+
+	type = SPECULATION_SAFE_VALUE(type);
+	bucket = SPECULATION_SAFE_VALUE(bucket);
+	hist = &(*PER_CPU_BY_INDEX(psci_cpu_stat_hist, node_idx))[stat_idx];
+	*count = hist->count[type][bucket];
+
+	return PSCI_E_SUCCESS;
+}
+#endif /* ENABLE_PSCI_STAT_HISTOGRAM */
+
 /* This is the top level function for PSCI_STAT_RESIDENCY SMC. */
 u_register_t psci_stat_residency(u_register_t target_cpu,
 		unsigned int power_state)
@@ -119,6 +119,22 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+void xlat_arch_tlbi_all(int xlat_regime)
+{
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		tlbiallis();
+	} else {
+		assert(xlat_regime == EL2_REGIME);
+		tlbiallhis();
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/* Invalidate all entries from branch predictors. */
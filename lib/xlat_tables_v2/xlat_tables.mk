@@ -14,6 +14,17 @@ XLAT_TABLES_LIB_SRCS	:=	$(addprefix lib/xlat_tables_v2/,	\
 XLAT_TABLES_LIB_V2	:=	1
 $(eval $(call add_define,XLAT_TABLES_LIB_V2))
 
+# Set the contiguous hint on groups of block or page descriptors mapping
+# contiguous memory with the same attributes. Attributes of these pages can't
+# be changed afterwards.
+XLAT_TABLES_CONT_HINT	?=	0
+$(eval $(call assert_boolean,XLAT_TABLES_CONT_HINT))
+$(eval $(call add_define,XLAT_TABLES_CONT_HINT))
+
+ifeq (${XLAT_TABLES_CONT_HINT}-${ALLOW_RO_XLAT_TABLES},1-1)
+    $(error "XLAT_TABLES_CONT_HINT can't be used with ALLOW_RO_XLAT_TABLES")
+endif
+
 ifeq (${ALLOW_RO_XLAT_TABLES}, 1)
     include lib/xlat_tables_v2/ro_xlat_tables.mk
 endif
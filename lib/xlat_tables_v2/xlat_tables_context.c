@@ -90,6 +90,16 @@ int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
 					base_va, size);
 }
 
+void mmap_dynamic_batch_begin(void)
+{
+	mmap_dynamic_batch_begin_ctx(&tf_xlat_ctx);
+}
+
+void mmap_dynamic_batch_commit(void)
+{
+	mmap_dynamic_batch_commit_ctx(&tf_xlat_ctx);
+}
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 void __init init_xlat_tables(void)
@@ -115,6 +125,11 @@ int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr)
 	return xlat_get_mem_attributes_ctx(&tf_xlat_ctx, base_va, attr);
 }
 
+void xlat_get_tables_usage(unsigned int *max_used, unsigned int *total)
+{
+	xlat_get_tables_usage_ctx(&tf_xlat_ctx, max_used, total);
+}
+
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr)
 {
 	return xlat_change_mem_attributes_ctx(&tf_xlat_ctx, base_va, size, attr);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -28,6 +28,19 @@ static inline __attribute__((unused)) void xlat_clean_dcache_range(uintptr_t add
 		clean_dcache_range(addr, size);
 }
 
+/*
+ * Invalidate all the entries of a translation table. Tables are only cleared
+ * when they are used, rather than all of them when the context is initialized,
+ * as this is done with the data cache disabled on cold boot.
+ */
+static uint64_t *xlat_table_clear(uint64_t *table)
+{
+	for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++)
+		table[i] = INVALID_DESC;
+
+	return table;
+}
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 
 /*
@@ -55,14 +68,29 @@ static int xlat_table_get_index(const xlat_ctx_t *ctx, const uint64_t *table)
 	return -1;
 }
 
-/* Returns a pointer to an empty translation table. */
-static uint64_t *xlat_table_get_empty(const xlat_ctx_t *ctx)
+/*
+ * Returns a pointer to an empty translation table, with all its entries
+ * invalid.
+ */
+static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables_mapped_regions[i] == 0)
-			return ctx->tables[i];
+	uint64_t *table = NULL;
+	int used = 1;
+
+	for (int i = 0; i < ctx->tables_num; i++) {
+		if (ctx->tables_mapped_regions[i] != 0)
+			used++;
+		else if (table == NULL)
+			table = ctx->tables[i];
+	}
+
+	if (table == NULL)
+		return NULL;
 
-	return NULL;
+	if (used > ctx->tables_max_used)
+		ctx->tables_max_used = used;
+
+	return xlat_table_clear(table);
 }
 
 /* Increments region count for a given table. */
@@ -91,12 +119,15 @@ static bool xlat_table_is_empty(const xlat_ctx_t *ctx, const uint64_t *table)
 
 #else /* PLAT_XLAT_TABLES_DYNAMIC */
 
-/* Returns a pointer to the first empty translation table. */
+/*
+ * Returns a pointer to the first empty translation table, with all its entries
+ * invalid.
+ */
 static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
 	assert(ctx->next_table < ctx->tables_num);
 
-	return ctx->tables[ctx->next_table++];
+	return xlat_table_clear(ctx->tables[ctx->next_table++]);
 }
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
@@ -350,6 +381,34 @@ static action_t xlat_tables_unmap_region_action(const mmap_region_t *mm,
 
 	return action;
 }
+/*
+ * Invalidate the TLB entries of a descriptor that has just been removed, or
+ * record it for the end of the current batch of dynamic regions updates.
+ */
+static void xlat_tables_tlbi_va(xlat_ctx_t *ctx, uintptr_t va)
+{
+	if (ctx->batch) {
+		ctx->batch_tlbi = true;
+	} else {
+		xlat_arch_tlbi_va(va, ctx->xlat_regime);
+	}
+}
+
+/*
+ * Complete the translation tables updates of a batch: a single invalidation of
+ * all TLB entries replaces the invalidations by VA of the removed descriptors.
+ */
+static void xlat_tables_batch_sync(xlat_ctx_t *ctx)
+{
+	if (ctx->batch_tlbi) {
+		xlat_arch_tlbi_all(ctx->xlat_regime);
+		xlat_arch_tlbi_va_sync();
+		ctx->batch_tlbi = false;
+	} else {
+		dsbishst();
+	}
+}
+
 /*
  * Recursive function that writes to the translation tables and unmaps the
  * specified region.
@@ -389,7 +448,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
+			xlat_tables_tlbi_va(ctx, table_idx_va);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -408,8 +467,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			 */
 			if (xlat_table_is_empty(ctx, subtable)) {
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
+				xlat_tables_tlbi_va(ctx, table_idx_va);
 			}
 
 		} else {
@@ -667,6 +725,95 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	return table_idx_va - 1U;
 }
 
+#if XLAT_TABLES_CONT_HINT
+/*
+ * Number of adjacent entries the contiguous hint applies to, with the 4KB
+ * translation granule.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
+
+/*
+ * Recursive function that sets the contiguous hint on each aligned group of
+ * block or page entries mapping the specified region, when the group maps a
+ * contiguous output range with the same attributes. The TLBs can then cache
+ * the whole group with a single entry. Only groups fully covered by the region
+ * are considered, so that they are unmapped together with a dynamic region.
+ */
+static void xlat_tables_set_cont_hint(xlat_ctx_t *ctx, const mmap_region_t *mm,
+				      const uintptr_t table_base_va,
+				      uint64_t *const table_base,
+				      const unsigned int table_entries,
+				      const unsigned int level)
+{
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+	size_t block_size = XLAT_BLOCK_SIZE(level);
+	size_t group_size = XLAT_CONT_ENTRIES * block_size;
+	uint64_t block_type = (level == XLAT_TABLE_LEVEL_MAX) ? PAGE_DESC :
+								BLOCK_DESC;
+	bool updated __unused = false;
+	unsigned int idx;
+	unsigned int i;
+
+	for (idx = 0U; idx < table_entries; idx++) {
+		uintptr_t va = table_base_va + (idx * block_size);
+		uint64_t desc = table_base[idx];
+
+		if ((va > mm_end_va) || ((va + block_size - 1U) < mm->base_va)) {
+			continue;
+		}
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			xlat_tables_set_cont_hint(ctx, mm, va,
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1U);
+		}
+	}
+
+	if (level < MIN_LVL_BLOCK_DESC) {
+		return;
+	}
+
+	for (idx = 0U; (idx + XLAT_CONT_ENTRIES) <= table_entries;
+	     idx += XLAT_CONT_ENTRIES) {
+		uintptr_t va = table_base_va + (idx * block_size);
+		uint64_t first = table_base[idx];
+		unsigned long long pa = first & TABLE_ADDR_MASK;
+		bool cont = (va >= mm->base_va) &&
+			    ((va + group_size - 1U) <= mm_end_va) &&
+			    ((first & DESC_MASK) == block_type) &&
+			    ((first & UPPER_ATTRS(CONT_HINT)) == 0ULL) &&
+			    ((pa & (group_size - 1U)) == 0U);
+
+		for (i = 1U; cont && (i < XLAT_CONT_ENTRIES); i++) {
+			uint64_t desc = table_base[idx + i];
+
+			cont = ((desc & ~TABLE_ADDR_MASK) ==
+				(first & ~TABLE_ADDR_MASK)) &&
+			       ((desc & TABLE_ADDR_MASK) ==
+				(pa + (i * block_size)));
+		}
+
+		if (!cont) {
+			continue;
+		}
+
+		for (i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+			table_base[idx + i] |= UPPER_ATTRS(CONT_HINT);
+		}
+
+		updated = true;
+	}
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	if (updated) {
+		xlat_clean_dcache_range((uintptr_t)table_base,
+					table_entries * sizeof(uint64_t));
+	}
+#endif
+}
+#endif /* XLAT_TABLES_CONT_HINT */
+
 /*
  * Function that verifies that a region can be mapped.
  * Returns:
@@ -1001,6 +1148,14 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	 * not, this region will be mapped when they are initialized.
 	 */
 	if (ctx->initialized) {
+		/*
+		 * Entries removed earlier in the batch may still be cached in
+		 * the TLBs, they must not apply to the VAs mapped now.
+		 */
+		if (ctx->batch_tlbi) {
+			xlat_tables_batch_sync(ctx);
+		}
+
 		end_va = xlat_tables_map_region(ctx, mm_cursor,
 				0U, ctx->base_table, ctx->base_table_entries,
 				ctx->base_level);
@@ -1040,13 +1195,22 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			return -ENOMEM;
 		}
 
+#if XLAT_TABLES_CONT_HINT
+		xlat_tables_set_cont_hint(ctx, mm_cursor, 0U, ctx->base_table,
+					  ctx->base_table_entries,
+					  ctx->base_level);
+#endif
+
 		/*
 		 * Make sure that all entries are written to the memory. There
 		 * is no need to invalidate entries when mapping dynamic regions
 		 * because new table/block/page descriptors only replace old
-		 * invalid descriptors, that aren't TLB cached.
+		 * invalid descriptors, that aren't TLB cached. In a batch, this
+		 * is done once when it is committed.
 		 */
-		dsbishst();
+		if (!ctx->batch) {
+			dsbishst();
+		}
 	}
 
 	if (end_pa > ctx->max_pa)
@@ -1123,7 +1287,9 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
-		xlat_arch_tlbi_va_sync();
+		if (!ctx->batch) {
+			xlat_arch_tlbi_va_sync();
+		}
 	}
 
 	/* Remove this region by moving the rest down by one place. */
@@ -1153,6 +1319,24 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 	return 0;
 }
 
+void mmap_dynamic_batch_begin_ctx(xlat_ctx_t *ctx)
+{
+	assert(!ctx->batch);
+
+	ctx->batch = true;
+}
+
+void mmap_dynamic_batch_commit_ctx(xlat_ctx_t *ctx)
+{
+	assert(ctx->batch);
+
+	ctx->batch = false;
+
+	if (ctx->initialized) {
+		xlat_tables_batch_sync(ctx);
+	}
+}
+
 void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 			    uintptr_t va_max, struct mmap_region *mmap,
 			    unsigned int mmap_num, uint64_t **tables,
@@ -1185,6 +1369,7 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+
 void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 {
 	assert(ctx != NULL);
@@ -1203,18 +1388,18 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 
 	xlat_mmap_print(mm);
 
-	/* All tables must be zeroed before mapping any region. */
+	/*
+	 * The base table must be zeroed before mapping any region. Other
+	 * tables are zeroed when they are allocated.
+	 */
 
 	for (unsigned int i = 0U; i < ctx->base_table_entries; i++)
 		ctx->base_table[i] = INVALID_DESC;
 
-	for (int j = 0; j < ctx->tables_num; j++) {
 #if PLAT_XLAT_TABLES_DYNAMIC
+	for (int j = 0; j < ctx->tables_num; j++)
 		ctx->tables_mapped_regions[j] = 0;
 #endif
-		for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++)
-			ctx->tables[j][i] = INVALID_DESC;
-	}
 
 	while (mm->size != 0U) {
 		uintptr_t end_va = xlat_tables_map_region(ctx, mm, 0U,
@@ -1238,6 +1423,14 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	assert(ctx->max_va <= ctx->va_max_address);
 	assert(ctx->max_pa <= ctx->pa_max_address);
 
+#if XLAT_TABLES_CONT_HINT
+	for (mm = ctx->mmap; mm->size != 0U; mm++) {
+		xlat_tables_set_cont_hint(ctx, mm, 0U, ctx->base_table,
+					  ctx->base_table_entries,
+					  ctx->base_level);
+	}
+#endif
+
 	ctx->initialized = true;
 
 	xlat_tables_print(ctx);
@@ -113,6 +113,10 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 	printf(((LOWER_ATTRS(NS) & desc) != 0ULL) ? "-NS" : "-S");
 #endif
 
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+		printf("-CONT");
+	}
+
 #ifdef __aarch64__
 	/* Check Guarded Page bit */
 	if ((desc & GP) != 0ULL) {
@@ -131,6 +135,10 @@ static const char * const level_spacers[] = {
 static const char *invalid_descriptors_ommited =
 		"%s(%d invalid descriptors omitted)\n";
 
+/* Block and page descriptors found per lookup level, and with the hint */
+static unsigned int xlat_desc_count[XLAT_TABLE_LEVEL_MAX + 1U];
+static unsigned int xlat_cont_desc_count;
+
 /*
  * Recursive function that reads the translation tables passed as an argument
  * and prints their status.
@@ -205,6 +213,11 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 				       level_size);
 				xlat_desc_print(ctx, desc);
 				printf("\n");
+
+				xlat_desc_count[level]++;
+				if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+					xlat_cont_desc_count++;
+				}
 			}
 		}
 
@@ -255,8 +268,20 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 		used_page_tables, ctx->tables_num,
 		ctx->tables_num - used_page_tables);
 
+	for (unsigned int i = 0U; i <= XLAT_TABLE_LEVEL_MAX; i++) {
+		xlat_desc_count[i] = 0U;
+	}
+	xlat_cont_desc_count = 0U;
+
 	xlat_tables_print_internal(ctx, 0U, ctx->base_table,
 				   ctx->base_table_entries, ctx->base_level);
+
+	for (unsigned int i = ctx->base_level; i <= XLAT_TABLE_LEVEL_MAX; i++) {
+		VERBOSE("  Level %u descriptors of size 0x%zx: %u\n", i,
+			(size_t)XLAT_BLOCK_SIZE(i), xlat_desc_count[i]);
+	}
+	VERBOSE("  Descriptors with contiguous hint: %u\n",
+		xlat_cont_desc_count);
 }
 
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
@@ -443,6 +468,18 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
+void xlat_get_tables_usage_ctx(const xlat_ctx_t *ctx, unsigned int *max_used,
+			       unsigned int *total)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	*max_used = (unsigned int)ctx->tables_max_used;
+#else
+	*max_used = (unsigned int)ctx->next_table;
+#endif
+	*total = (unsigned int)ctx->tables_num;
+}
+
+
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
@@ -518,6 +555,16 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 			return -EINVAL;
 		}
 
+		/*
+		 * The contiguous hint must be the same on a whole group of
+		 * entries, it can't be changed page by page.
+		 */
+		if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+			WARN("Address 0x%lx is mapped with the contiguous hint.\n",
+			     base_va);
+			return -EINVAL;
+		}
+
 		/*
 		 * If the region type is device, it shouldn't be executable.
 		 */
@@ -6,15 +6,19 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <common/debug.h>
+#include <common/image_decompress.h>
 #include <common/tf_crc32.h>
 #include <lib/utils.h>
 #include <tf_gunzip.h>
 
 #include "zutil.h"
 
+#pragma weak tf_crc32
+
 /*
  * memory allocated by malloc() is supposed to be aligned for any built-in type
  */
@@ -102,7 +106,118 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
-/* Wrapper function to calculate CRC
+static z_stream gunzip_stream_state;
+
+/*
+ * gunzip_stream_probe - check whether data starts with a gzip header
+ * @in_buf: first bytes of the data
+ * @in_len: number of bytes available in in_buf
+ */
+bool gunzip_stream_probe(uintptr_t in_buf, size_t in_len)
+{
+	const uint8_t *magic = (const uint8_t *)in_buf;
+
+	return (in_len >= 2U) && (magic[0] == 0x1fU) && (magic[1] == 0x8bU);
+}
+
+/*
+ * gunzip_stream_init - start decompressing gzip data given in chunks
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace, used until gunzip_stream_end()
+ * @work_len: length of workspace
+ */
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len)
+{
+	z_stream *stream = &gunzip_stream_state;
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	stream->next_in = Z_NULL;
+	stream->avail_in = 0U;
+	stream->next_out = (typeof(stream->next_out))out_buf;
+	stream->avail_out = out_len;
+	stream->zalloc = zcalloc;
+	stream->zfree = zfree;
+	stream->opaque = (voidpf)0;
+
+	zret = inflateInit(stream);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next chunk of gzip data
+ * @in_buf: chunk of compressed input
+ * @in_len: length of in_buf
+ *
+ * Return 0 when more input is expected, 1 once the end of the compressed
+ * stream is reached, a negative error code otherwise.
+ */
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	z_stream *stream = &gunzip_stream_state;
+	int zret;
+
+	stream->next_in = (typeof(stream->next_in))in_buf;
+	stream->avail_in = in_len;
+
+	zret = inflate(stream, Z_NO_FLUSH);
+	switch (zret) {
+	case Z_STREAM_END:
+		return 1;
+	case Z_OK:
+	case Z_BUF_ERROR:
+		if (stream->avail_in == 0U) {
+			return 0;
+		}
+
+		ERROR("zlib: output buffer full\n");
+		return -EFBIG;
+	default:
+		if (stream->msg)
+			ERROR("%s\n", stream->msg);
+		ERROR("zlib: inflate failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+}
+
+/*
+ * gunzip_stream_end - complete the decompression of gzip data
+ * @out_buf: upon exit, the end of output
+ */
+int gunzip_stream_end(uintptr_t *out_buf)
+{
+	z_stream *stream = &gunzip_stream_state;
+	int zret;
+
+	VERBOSE("zlib: %lu byte input\n", stream->total_in);
+	VERBOSE("zlib: %lu byte output\n", stream->total_out);
+
+	*out_buf = (uintptr_t)stream->next_out;
+
+	zret = inflateEnd(stream);
+
+	return (zret == Z_OK) ? 0 : -EIO;
+}
+
+const decompressor_stream_t gunzip_stream = {
+	.probe = gunzip_stream_probe,
+	.init = gunzip_stream_init,
+	.update = gunzip_stream_update,
+	.end = gunzip_stream_end,
+};
+
+/* Wrapper function to calculate CRC, unless the platform links a faster
+ * tf_crc32() backend (common/tf_crc32.c or common/tf_crc32_slice8.c)
  * @crc: previous accumulated CRC
  * @buf: buffer base address
  * @size: size of the buffer
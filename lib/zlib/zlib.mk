@@ -23,3 +23,10 @@ INCLUDES	+=	-Iinclude/lib/zlib
 
 # REVISIT: the following flags need not be given globally
 TF_CFLAGS	+=	-DZ_SOLO -DDEF_WBITS=31
+
+# Slicing-by-4 CRC32 of gzip data, with 8KB of tables instead of 1KB
+ZLIB_CRC32_BYFOUR ?=	0
+
+ifeq (${ZLIB_CRC32_BYFOUR},1)
+TF_CFLAGS	+=	-DZ_U4=unsigned
+endif
@@ -258,6 +258,15 @@ endef
 
 GZIP_SUFFIX := .gz
 
+# LZ4 frame, with linked blocks
+define LZ4_RULE
+$(1): $(2)
+	$(ECHO) "  LZ4     $$@"
+	$(Q)lz4 -9 -BD -f -c $$< > $$@
+endef
+
+LZ4_SUFFIX := .lz4
+
 ################################################################################
 # Auxiliary macros to build TF images from sources
 ################################################################################
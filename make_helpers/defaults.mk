@@ -26,6 +26,14 @@ ARM_ARCH_FEATURE		:= none
 ARM_ARCH_MAJOR			:= 8
 ARM_ARCH_MINOR			:= 0
 
+# Cache verified certificates and their extracted parameters, so that a parent
+# certificate shared by several images is only authenticated once per boot.
+AUTH_CERT_CACHE			:= 0
+
+# Hash raw images while they are loaded, instead of reading them again after
+# the load to authenticate them.
+AUTH_STREAM_HASH		:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
@@ -42,6 +50,12 @@ BL2_IN_XIP_MEM			:= 0
 # Do dcache invalidate upon BL2 entry at EL3
 BL2_INV_DCACHE			:= 1
 
+# Let the platform flush loaded images at BL2 exit, instead of after each load
+BL2_DEFER_IMAGE_FLUSH		:= 0
+
+# Timestamp the open, read and authentication of each image loaded by BL2
+BL2_LOAD_INSTRUMENTATION	:= 0
+
 # Select the branch protection features to use.
 BRANCH_PROTECTION		:= 0
 
@@ -68,6 +82,10 @@ CTX_INCLUDE_FPREGS		:= 0
 # world. It is not needed to use it in the Non-secure world.
 CTX_INCLUDE_PAUTH_REGS		:= 0
 
+# Switch the FP/SIMD registers to the secure world on its first FP/SIMD access
+# only, instead of trapping them.
+CTX_LAZY_SIMD_REGS		:= 0
+
 # Include Nested virtualization control (Armv8.4-NV) registers in cpu context.
 # This must be set to 1 if architecture implements Nested Virtualization
 # Extension and platform wants to use this feature in the Secure world
@@ -76,6 +94,9 @@ CTX_INCLUDE_NEVE_REGS		:= 0
 # Debug build
 DEBUG				:= 0
 
+# Option to decrypt encrypted images chunk by chunk while they are read
+DECRYPTION_STREAM		:= 0
+
 # By default disable authenticated decryption support.
 DECRYPTION_SUPPORT		:= none
 
@@ -93,9 +114,17 @@ DISABLE_MTPMU			:= 0
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Write log messages as tokens referring to their format string, which is not
+# loaded with the images
+ENABLE_LOG_TOKENS		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
+# Flag to program the MPAM memory-system component partitions from the
+# HW_CONFIG, and let the non-secure world update them through SiP calls.
+ENABLE_MPAM_MSC			:= 0
+
 # Enable the Maximum Power Mitigation Mechanism on supporting cores.
 ENABLE_MPMM			:= 0
 
@@ -111,9 +140,15 @@ ENABLE_PMF			:= 0
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
+# Flag to enable PSCI STATs histograms of CPU residencies and latencies
+ENABLE_PSCI_STAT_HISTOGRAM	:= 0
+
 # Flag to enable Realm Management Extension (FEAT_RME)
 ENABLE_RME			:= 0
 
+# Flag to count runtime service calls and their duration per OEN and CPU
+ENABLE_RT_SVC_STATS		:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
@@ -176,6 +211,10 @@ GENERATE_COT			:= 0
 # default, they are for Secure EL1.
 GICV2_G0_FOR_EL3		:= 0
 
+# Check the CRC32 of the GPT header and partition entries, the platform must
+# provide tf_crc32().
+GPT_CRC_CHECK			:= 0
+
 # Route External Aborts to EL3. Disabled by default; External Aborts are handled
 # by lower ELs.
 HANDLE_EA_EL3_FIRST		:= 0
@@ -188,6 +227,10 @@ HASH_ALG			:= sha256
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Inflate the images selected by the platform while they are read, chunk by
+# chunk, instead of loading them first in a temporary buffer.
+IMAGE_DECOMPRESS_STREAM		:= 0
+
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
@@ -215,6 +258,11 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to coordinate PSCI power domains with one spinlock word per domain
+# instead of bakery locks, on single cluster platforms without hardware
+# assisted coherency.
+PSCI_SINGLE_CLUSTER_LOCKS	:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
@@ -10,6 +10,7 @@
 #include <common/runtime_svc.h>
 #include <drivers/arm/ethosn.h>
 #include <lib/debugfs.h>
+#include <lib/extensions/mpam_msc.h>
 #include <lib/pmf/pmf.h>
 #include <plat/arm/common/arm_sip_svc.h>
 #include <plat/arm/common/plat_arm.h>
@@ -34,6 +35,14 @@ static int arm_sip_setup(void)
 
 #endif /* USE_DEBUGFS */
 
+#if ENABLE_MPAM_MSC
+
+	if (mpam_msc_setup() != 0) {
+		return 1;
+	}
+
+#endif /* ENABLE_MPAM_MSC */
+
 	return 0;
 }
 
@@ -82,6 +91,15 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 
 #endif /* ARM_ETHOSN_NPU_DRIVER */
 
+#if ENABLE_MPAM_MSC
+
+	if (is_mpam_msc_fid(smc_fid)) {
+		return mpam_msc_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					    handle, flags);
+	}
+
+#endif /* ENABLE_MPAM_MSC */
+
 	switch (smc_fid) {
 	case ARM_SIP_SVC_EXE_STATE_SWITCH: {
 		/* Execution state can be switched only if EL3 is AArch64 */
@@ -111,6 +129,11 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		call_count += ETHOSN_NUM_SMC_CALLS;
 #endif /* ARM_ETHOSN_NPU_DRIVER */
 
+#if ENABLE_MPAM_MSC
+		/* MPAM MSC calls */
+		call_count += MPAM_MSC_NUM_SMC_CALLS;
+#endif /* ENABLE_MPAM_MSC */
+
 		/* State switch call */
 		call_count += 1;
 
@@ -61,6 +61,26 @@ static u_register_t calc_stat_residency(unsigned long long pwrupts,
 	return res / residency_div;
 }
 
+/*
+ * If power down is requested, then timestamp capture will be with caches OFF.
+ * Hence we have to do cache maintenance when capturing and reading the
+ * timestamp. Retention states keep the caches coherent, so that the CPU
+ * standby fast path does no cache maintenance.
+ */
+static unsigned int stat_pmf_flags(const psci_power_state_t *state_info)
+{
+	plat_local_state_t state;
+
+	state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
+	if (is_local_state_off(state) != 0) {
+		return PMF_CACHE_MAINT;
+	}
+
+	assert(is_local_state_retn(state) == 1);
+
+	return PMF_NO_CACHE_MAINT;
+}
+
 /*
  * Capture timestamp before entering a low power state.
  * Cache maintenance may be needed when reading these timestamps.
@@ -70,7 +90,7 @@ void plat_psci_stat_accounting_start(
 {
 	assert(state_info != NULL);
 	PMF_CAPTURE_TIMESTAMP(psci_svc, PSCI_STAT_ID_ENTER_LOW_PWR,
-		PMF_CACHE_MAINT);
+		stat_pmf_flags(state_info));
 }
 
 /*
@@ -82,7 +102,7 @@ void plat_psci_stat_accounting_stop(
 {
 	assert(state_info != NULL);
 	PMF_CAPTURE_TIMESTAMP(psci_svc, PSCI_STAT_ID_EXIT_LOW_PWR,
-		PMF_CACHE_MAINT);
+		stat_pmf_flags(state_info));
 }
 
 /*
@@ -93,7 +113,6 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 	const psci_power_state_t *state_info,
 	unsigned int last_cpu_idx)
 {
-	plat_local_state_t state;
 	unsigned long long pwrup_ts = 0, pwrdn_ts = 0;
 	unsigned int pmf_flags;
 
@@ -104,18 +123,7 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 	if (lvl == PSCI_CPU_PWR_LVL)
 		assert(last_cpu_idx == plat_my_core_pos());
 
-	/*
-	 * If power down is requested, then timestamp capture will
-	 * be with caches OFF.  Hence we have to do cache maintenance
-	 * when reading the timestamp.
-	 */
-	state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
-	if (is_local_state_off(state) != 0) {
-		pmf_flags = PMF_CACHE_MAINT;
-	} else {
-		assert(is_local_state_retn(state) == 1);
-		pmf_flags = PMF_NO_CACHE_MAINT;
-	}
+	pmf_flags = stat_pmf_flags(state_info);
 
 	PMF_GET_TIMESTAMP_BY_INDEX(psci_svc,
 		PSCI_STAT_ID_ENTER_LOW_PWR,
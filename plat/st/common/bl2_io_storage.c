@@ -5,11 +5,13 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
+#include <common/image_decompress.h>
 #include <drivers/fwu/fwu.h>
 #include <drivers/fwu/fwu_metadata.h>
 #include <drivers/io/io_block.h>
@@ -29,6 +31,7 @@
 #include <drivers/st/stm32_fmc2_nand.h>
 #include <drivers/st/stm32_qspi.h>
 #include <drivers/st/stm32_sdmmc2.h>
+#include <drivers/st/stm32mp1_ddr.h>
 #include <drivers/usb_device.h>
 #include <lib/fconf/fconf.h>
 #include <lib/mmio.h>
@@ -38,9 +41,13 @@
 
 #include <platform_def.h>
 #include <stm32cubeprogrammer.h>
+#include <stm32mp1_bl2_smp.h>
+#include <stm32mp_boot_timeline.h>
+#include <stm32mp_dma_memcpy.h>
 #include <stm32mp_efi.h>
 #include <stm32mp_fconf_getter.h>
 #include <stm32mp_io_storage.h>
+#include <stm32mp_striped_load.h>
 #include <usb_dfu.h>
 
 /* IO devices */
@@ -69,19 +76,31 @@ static io_block_dev_spec_t mmc_block_dev_spec = {
 	.ops = {
 		.read = mmc_read_blocks,
 		.write = NULL,
+		.read_start = mmc_read_blocks_start,
+		.read_wait = mmc_read_blocks_wait,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	/* Complete blocks are read directly into the image destination */
+	.direct_read_align = sizeof(uint32_t),
 };
 
 static const io_dev_connector_t *mmc_dev_con;
+
+/* Card identification in progress, on this SDMMC instance */
+static bool mmc_init_pending;
+static uint16_t mmc_init_instance;
 #endif /* STM32MP_SDMMC || STM32MP_EMMC */
 
 #if STM32MP_SPI_NOR
+static uint8_t spi_nor_read_cache[SPI_NOR_READ_CACHE_SIZE];
+
 static io_mtd_dev_spec_t spi_nor_dev_spec = {
 	.ops = {
 		.init = spi_nor_init,
 		.read = spi_nor_read,
 	},
+	.read_cache = (uintptr_t)spi_nor_read_cache,
+	.read_cache_size = sizeof(spi_nor_read_cache),
 };
 #endif
 
@@ -193,7 +212,6 @@ static void print_boot_device(boot_api_context_t *boot_context)
 static void boot_mmc(enum mmc_device_type mmc_dev_type,
 		     uint16_t boot_interface_instance)
 {
-	int io_result __unused;
 	struct stm32_sdmmc2_params params;
 
 	zeromem(&params, sizeof(struct stm32_sdmmc2_params));
@@ -220,16 +238,45 @@ static void boot_mmc(enum mmc_device_type mmc_dev_type,
 		break;
 	}
 
+	params.flags = MMC_FLAG_CMD23_AUTO;
 	if (mmc_dev_type == MMC_IS_SD) {
-		params.flags = MMC_FLAG_SD_CMD6;
+		params.flags |= MMC_FLAG_SD_CMD6;
 	}
 
 	params.device_info = &mmc_info;
-	if (stm32_sdmmc2_mmc_init(&params) != 0) {
+	if (stm32_sdmmc2_mmc_init_start(&params) != 0) {
 		ERROR("SDMMC%u init failed\n", boot_interface_instance);
 		panic();
 	}
 
+	mmc_init_instance = boot_interface_instance;
+	mmc_init_pending = true;
+
+#if !STM32MP_MMC_ASYNC_INIT
+	stm32mp_io_setup_wait();
+#endif
+}
+
+static bool boot_mmc_step(void)
+{
+	int io_result;
+
+	if (!mmc_init_pending) {
+		return false;
+	}
+
+	io_result = mmc_init_poll();
+	if (io_result == -EAGAIN) {
+		return true;
+	}
+
+	mmc_init_pending = false;
+
+	if (io_result != 0) {
+		ERROR("SDMMC%u init failed\n", mmc_init_instance);
+		panic();
+	}
+
 	/* Open MMC as a block device to read GPT table */
 	io_result = register_io_dev_block(&mmc_dev_con);
 	if (io_result != 0) {
@@ -239,7 +286,53 @@ static void boot_mmc(enum mmc_device_type mmc_dev_type,
 	io_result = io_dev_open(mmc_dev_con, (uintptr_t)&mmc_block_dev_spec,
 				&storage_dev_handle);
 	assert(io_result == 0);
+
+	return false;
+}
+
+#if STM32MP_EMMC_BOOT && !PSA_FWU_SUPPORT
+/*
+ * Look for a FIP after the FSBL in the eMMC boot partition. When found, it is
+ * read from there without any GPT lookup: the boot partition is selected by
+ * the first read and stays selected for the following ones.
+ */
+static bool emmc_boot_part_fip_found(void)
+{
+	uint32_t toc_name = 0U;
+	size_t length_read;
+	uintptr_t handle;
+	int ret;
+
+	if (mmc_boot_part_size() <= PLAT_EMMC_BOOT_SSBL_OFFSET) {
+		return false;
+	}
+
+	mmc_block_dev_spec.ops.read = mmc_boot_part_read_blocks;
+	mmc_block_dev_spec.ops.read_start = mmc_boot_part_read_blocks_start;
+
+	image_block_spec.offset = PLAT_EMMC_BOOT_SSBL_OFFSET;
+	image_block_spec.length = mmc_boot_part_size() -
+				  PLAT_EMMC_BOOT_SSBL_OFFSET;
+
+	ret = io_open(storage_dev_handle, (uintptr_t)&image_block_spec,
+		      &handle);
+	if (ret == 0) {
+		ret = io_read(handle, (uintptr_t)&toc_name, sizeof(toc_name),
+			      &length_read);
+		(void)io_close(handle);
+	}
+
+	if ((ret == 0) && (toc_name == TOC_HEADER_NAME)) {
+		INFO("FIP found in eMMC boot partition\n");
+		return true;
+	}
+
+	mmc_block_dev_spec.ops.read = mmc_read_blocks;
+	mmc_block_dev_spec.ops.read_start = mmc_read_blocks_start;
+
+	return false;
 }
+#endif /* STM32MP_EMMC_BOOT && !PSA_FWU_SUPPORT */
 #endif /* STM32MP_SDMMC || STM32MP_EMMC */
 
 #if STM32MP_SPI_NOR
@@ -314,6 +407,28 @@ static void mmap_io_setup(void)
 	io_result = io_dev_open(memmap_dev_con, (uintptr_t)NULL,
 				&storage_dev_handle);
 	assert(io_result == 0);
+
+	stm32mp_dma_memcpy_init();
+}
+
+/*
+ * The images that BL2 does not read once loaded, neither to authenticate
+ * nor to decompress them, are copied from the download buffer in background.
+ */
+static bool dma_memcpy_async_image(unsigned int image_id)
+{
+#if TRUSTED_BOARD_BOOT || STM32MP_DECOMPRESS_STREAM
+	return false;
+#else
+	switch (image_id) {
+	case BL32_EXTRA1_IMAGE_ID:
+	case BL32_EXTRA2_IMAGE_ID:
+	case BL33_IMAGE_ID:
+		return true;
+	default:
+		return false;
+	}
+#endif
 }
 
 #if STM32MP_UART_PROGRAMMER
@@ -426,15 +541,64 @@ void stm32mp_io_setup(void)
 	}
 }
 
+/*
+ * Step the boot device initialisation started by stm32mp_io_setup(), it
+ * returns true while the device is not ready. Only the SD and eMMC card
+ * identification, waiting for the card power-up, is split.
+ */
+bool stm32mp_io_setup_step(void)
+{
+#if STM32MP_SDMMC || STM32MP_EMMC
+	return boot_mmc_step();
+#else
+	return false;
+#endif
+}
+
+void stm32mp_io_setup_wait(void)
+{
+	while (stm32mp_io_setup_step()) {
+		;
+	}
+}
+
+/*
+ * The partial blocks at the start and the end of the images, and the reads
+ * to unaligned destinations, then use large transfers instead of 512 bytes
+ * ones. No read is ongoing, io_block reads the buffer spec for each read.
+ */
+void stm32mp_io_use_ddr_buffers(void)
+{
+#if (STM32MP_SDMMC || STM32MP_EMMC) && (STM32MP_MMC_DDR_BUFFER_KB != 0)
+	mmc_block_dev_spec.buffer.offset = STM32MP_MMC_DDR_BUFFER_BASE;
+	mmc_block_dev_spec.buffer.length = STM32MP_MMC_DDR_BUFFER_SIZE;
+#endif
+}
+
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
 	static bool gpt_init_done __unused;
 	uint16_t boot_itf = stm32mp_get_boot_itf_selected();
 
+	stm32mp_boot_timeline_mark(BOOT_TL_IMAGE_LOAD_START, image_id);
+	stm32mp1_bl2_smp_set_image(image_id);
+
 	if (stm32mp_skip_boot_device_after_standby()) {
 		return 0;
 	}
 
+#if STM32MP_DECOMPRESS_STREAM
+	switch (image_id) {
+	case BL32_EXTRA1_IMAGE_ID:
+	case BL32_EXTRA2_IMAGE_ID:
+	case BL33_IMAGE_ID:
+		image_decompress_stream_prepare(image_id);
+		break;
+	default:
+		break;
+	}
+#endif
+
 	switch (boot_itf) {
 #if STM32MP_SDMMC || STM32MP_EMMC
 	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_SD:
@@ -450,6 +614,15 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 			const struct efi_guid img_type_guid = STM32MP_FIP_GUID;
 			uuid_t img_type_uuid;
 
+#if STM32MP_EMMC_BOOT
+			if ((boot_itf ==
+			     BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_EMMC) &&
+			    emmc_boot_part_fip_found()) {
+				gpt_init_done = true;
+				break;
+			}
+#endif
+
 			guidcpy(&img_type_uuid, &img_type_guid);
 			partition_init(GPT_IMAGE_ID);
 			entry = get_partition_entry_by_type(&img_type_uuid);
@@ -467,11 +640,6 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 			image_block_spec.length = entry->length;
 #endif
 			gpt_init_done = true;
-		} else {
-			bl_mem_params_node_t *bl_mem_params = get_bl_mem_params_node(image_id);
-
-			mmc_block_dev_spec.buffer.offset = bl_mem_params->image_info.image_base;
-			mmc_block_dev_spec.buffer.length = bl_mem_params->image_info.image_max_size;
 		}
 
 		break;
@@ -510,6 +678,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 
 #if STM32MP_UART_PROGRAMMER
 	case BOOT_API_CTX_BOOT_INTERFACE_SEL_SERIAL_UART:
+		stm32mp_dma_memcpy_set_async(dma_memcpy_async_image(image_id));
 		if (image_id == FW_CONFIG_ID) {
 			stm32cubeprogrammer_uart();
 			/* FIP loaded at DWL address */
@@ -520,6 +689,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 #endif
 #if STM32MP_USB_PROGRAMMER
 	case BOOT_API_CTX_BOOT_INTERFACE_SEL_SERIAL_USB:
+		stm32mp_dma_memcpy_set_async(dma_memcpy_async_image(image_id));
 		if (image_id == FW_CONFIG_ID) {
 			stm32cubeprogrammer_usb();
 			/* FIP loaded at DWL address */
@@ -534,6 +704,19 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 		panic();
 	}
 
+#if STM32MP_STRIPED_LOAD
+	/* The SPI-NOR extent is copied while the FIP entry is read */
+	if (((boot_itf == BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_SD) ||
+	     (boot_itf == BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_EMMC)) &&
+	    stm32mp_striped_load_start(image_id)) {
+		mmc_block_dev_spec.read_hook = stm32mp_striped_load_hook;
+		mmc_block_dev_spec.read_chunk_size =
+			STM32MP_STRIPED_LOAD_MMC_CHUNK;
+	} else {
+		mmc_block_dev_spec.read_hook = NULL;
+	}
+#endif
+
 	return 0;
 }
 
@@ -607,6 +790,8 @@ int plat_try_backup_partitions(unsigned int image_id)
  *       "accepted' field
  *     - we already boot FWU_MAX_TRIAL_REBOOT times in trial mode.
  * we select the previous_active_index.
+ * With STM32MP_FWU_IWDG_FALLBACK, it is also selected when a previous trial
+ * boot ended with an IWDG reset.
  */
 #define INVALID_BOOT_IDX		0xFFFFFFFF
 
@@ -627,6 +812,9 @@ uint32_t plat_fwu_get_boot_idx(void)
 			if (stm32_get_and_dec_fwu_trial_boot_cnt() == 0U) {
 				WARN("Trial FWU fails to many times");
 				memoize_boot_idx = data->previous_active_index;
+			} else if (stm32_fwu_trial_failed_on_iwdg()) {
+				WARN("Trial FWU ends with a watchdog reset");
+				memoize_boot_idx = data->previous_active_index;
 			}
 		} else {
 			stm32_set_max_fwu_trial_boot_cnt();
@@ -649,6 +837,11 @@ static void *stm32_get_image_spec(const uuid_t *img_type_uuid)
 	return NULL;
 }
 
+/*
+ * Called once per boot by fwu_init(): the image sources of the boot bank are
+ * resolved in the IO policies specs, plat_get_image_source() then only reads
+ * the policy of the image, without any UUID or partition lookup.
+ */
 void plat_fwu_set_images_source(const struct fwu_metadata *metadata)
 {
 	unsigned int i;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_BOOT_TIMELINE_H
+#define STM32MP_BOOT_TIMELINE_H
+
+#include <stdint.h>
+
+/*
+ * Boot timeline markers. Values are part of the format shared with the
+ * non-secure world and must not be renumbered.
+ */
+#define BOOT_TL_BL2_ENTRY		1U
+#define BOOT_TL_BL2_ARCH_SETUP_END	2U
+#define BOOT_TL_DDR_INIT_START		3U
+#define BOOT_TL_DDR_INIT_END		4U
+#define BOOT_TL_IO_SETUP_START		5U
+#define BOOT_TL_IO_SETUP_END		6U
+#define BOOT_TL_IMAGE_LOAD_START	7U	/* arg: image ID */
+#define BOOT_TL_IMAGE_LOAD_END		8U	/* arg: image ID */
+#define BOOT_TL_BL2_EXIT		9U
+#define BOOT_TL_BL32_ENTRY		10U
+#define BOOT_TL_BL32_SETUP_END		11U
+
+#define BOOT_TL_MAGIC			0x4E4C5442U	/* "BTLN" */
+
+/*
+ * Layout of the timeline stored at STM32MP_BOOT_TIMELINE_BASE.
+ * Timestamps are in microseconds since the system counter start.
+ */
+struct stm32mp_boot_tl_entry {
+	uint16_t id;
+	uint16_t arg;
+	uint32_t time_us;
+};
+
+struct stm32mp_boot_tl {
+	uint32_t magic;
+	uint32_t count;
+	uint32_t max;
+	uint32_t reserved;
+	struct stm32mp_boot_tl_entry entry[];
+};
+
+#if STM32MP_BOOT_TIMELINE
+void stm32mp_boot_timeline_init(void);
+void stm32mp_boot_timeline_mark(unsigned int id, unsigned int arg);
+void stm32mp_boot_timeline_dump(void);
+#else
+static inline void stm32mp_boot_timeline_init(void)
+{
+}
+
+static inline void stm32mp_boot_timeline_mark(unsigned int id,
+					      unsigned int arg)
+{
+}
+
+static inline void stm32mp_boot_timeline_dump(void)
+{
+}
+#endif
+
+#endif /* STM32MP_BOOT_TIMELINE_H */
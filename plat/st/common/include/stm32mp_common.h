@@ -24,6 +24,13 @@ bool stm32mp_is_single_core(void);
 bool stm32mp_is_closed_device(void);
 bool stm32mp_is_auth_supported(void);
 
+/* Read once the root public key hash from OTP, or drop the kept copy */
+int stm32mp_rotpk_hash_load(void);
+void stm32mp_rotpk_hash_invalidate(void);
+
+/* Wipe the firmware encryption key kept for the next encrypted images */
+void stm32mp_crypto_enc_key_wipe(void);
+
 /* Return the base address of the DDR controller */
 uintptr_t stm32mp_ddrctrl_base(void);
 
@@ -36,9 +43,17 @@ uintptr_t stm32mp_pwr_base(void);
 /* Return the base address of the RCC peripheral */
 uintptr_t stm32mp_rcc_base(void);
 
+typedef void (*stm32mp_gic_handler_t)(uint32_t id);
+
 void stm32mp_gic_pcpu_init(void);
 void stm32mp_gic_init(void);
 int stm32mp_gic_enable_spi(int node, const char *name);
+int stm32mp_gic_enable_spi_prio(int node, const char *name,
+				unsigned int priority);
+void stm32mp_gic_register_handler(uint32_t id, stm32mp_gic_handler_t handler);
+bool stm32mp_gic_dispatch(uint32_t id);
+void stm32mp_gic_enable_wakeup_spi(unsigned int id);
+bool stm32mp_gic_wait_spi(void);
 
 /* Check MMU status to allow spinlock use */
 bool stm32mp_lock_available(void);
@@ -125,6 +140,13 @@ bool stm32mp_supports_cpu_opp(uint32_t opp_id);
 /* Initialise the IO layer and register platform IO devices */
 void stm32mp_io_setup(void);
 
+/* Step or complete the boot device initialisation started by stm32mp_io_setup */
+bool stm32mp_io_setup_step(void);
+void stm32mp_io_setup_wait(void);
+
+/* Move the boot device buffers to DDR, once it is mapped */
+void stm32mp_io_use_ddr_buffers(void);
+
 /* Functions to map DDR in MMU with non-cacheable attribute, and unmap it */
 int stm32mp_map_ddr_non_cacheable(void);
 int stm32mp_unmap_ddr(void);
@@ -138,6 +160,14 @@ bool stm32_boot_is_serial(void);
 void stm32mp1_fwu_set_boot_idx(void);
 uint32_t stm32_get_and_dec_fwu_trial_boot_cnt(void);
 void stm32_set_max_fwu_trial_boot_cnt(void);
+#if STM32MP_FWU_IWDG_FALLBACK
+bool stm32_fwu_trial_failed_on_iwdg(void);
+#else
+static inline bool stm32_fwu_trial_failed_on_iwdg(void)
+{
+	return false;
+}
+#endif
 #endif /* PSA_FWU_SUPPORT */
 
 #endif /* STM32MP_COMMON_H */
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_DEFERRED_IMAGES_H
+#define STM32MP_DEFERRED_IMAGES_H
+
+#include <common/bl_common.h>
+
+/*
+ * Images marked IMAGE_ATTRIB_DEFERRED are not loaded by BL2. They are listed
+ * in the non-secure DT (HW_CONFIG) when BL2 exits, for BL33 to load them. The
+ * /firmware/deferred-images node, compatible with "st,stm32mp-deferred-images",
+ * has one subnode per image with:
+ * - image-id: <u32> TBBR image ID
+ * - uuid: 16 bytes, FIP entry UUID
+ * - load-address: <u64> and max-size: <u32>, as in FW_CONFIG
+ * - digest-info: DER encoded hash the image must match, with its algorithm,
+ *   extracted from its certificate authenticated by BL2 (TRUSTED_BOARD_BOOT)
+ */
+#if STM32MP_DEFER_NT_FW_CONFIG
+int stm32mp_deferred_image_add(unsigned int image_id,
+			       const image_info_t *image_info);
+int stm32mp_deferred_images_handoff(void);
+#else
+static inline int stm32mp_deferred_image_add(unsigned int image_id,
+					     const image_info_t *image_info)
+{
+	return 0;
+}
+
+static inline int stm32mp_deferred_images_handoff(void)
+{
+	return 0;
+}
+#endif
+
+#endif /* STM32MP_DEFERRED_IMAGES_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_DEFERRED_WORK_H
+#define STM32MP_DEFERRED_WORK_H
+
+#include <stdint.h>
+
+/*
+ * Work deferred by the secure interrupt handlers of SP_min, run on the same
+ * CPU from the STM32MP_IRQ_SEC_DEFERRED_WORK SGI, which has the lowest secure
+ * priority. The handler only keeps the time critical steps and returns
+ * sooner to the non-secure world. These functions are called from the FIQ
+ * handlers only, with FIQ masked.
+ */
+void stm32mp_defer_work(void (*fn)(uintptr_t arg), uintptr_t arg);
+void stm32mp_deferred_work_flush(void);
+void stm32mp_deferred_work_it_handler(void);
+
+#endif /* STM32MP_DEFERRED_WORK_H */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_DMA_MEMCPY_H
+#define STM32MP_DMA_MEMCPY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/* Largest copy left running by an asynchronous call */
+#define STM32MP_DMA_MEMCPY_ASYNC_MAX	U(0x100000)
+
+#if STM32MP_DMA_MEMCPY
+void stm32mp_dma_memcpy_init(void);
+void stm32mp_dma_memcpy(uintptr_t dst, uintptr_t src, size_t size);
+void stm32mp_dma_memcpy_set_async(bool async);
+void stm32mp_dma_memcpy_wait(void);
+bool stm32mp_dma_memcpy_poll(void);
+#else
+static inline void stm32mp_dma_memcpy_init(void)
+{
+}
+
+static inline void stm32mp_dma_memcpy_set_async(bool async)
+{
+}
+
+static inline void stm32mp_dma_memcpy_wait(void)
+{
+}
+
+static inline bool stm32mp_dma_memcpy_poll(void)
+{
+	return false;
+}
+#endif
+
+#endif /* STM32MP_DMA_MEMCPY_H */
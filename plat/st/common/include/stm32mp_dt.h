@@ -30,6 +30,8 @@ struct dt_node_info {
  ******************************************************************************/
 int dt_open_and_check(uintptr_t dt_addr);
 int fdt_get_address(void **fdt_addr);
+int dt_node_offset_by_compatible(int offset, const char *compat);
+int dt_node_offset_by_phandle(uint32_t phandle);
 bool fdt_check_node(int node);
 uint8_t fdt_get_status(int node);
 int fdt_get_interrupt(int node, const fdt32_t **array, int *len,
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_DT_VARIANTS_H
+#define STM32MP_DT_VARIANTS_H
+
+#include <common/bl_common.h>
+
+/*
+ * Board variants sharing a FIP. The FW_CONFIG DT lists them under a node
+ * compatible with "st,stm32mp-dt-variants", with one subnode per variant:
+ * - board-id: <value mask>, matched against the BOARD_ID OTP
+ * - hw-config, tos-fw-config: optional DT overlay blobs, applied to the
+ *   HW_CONFIG and TOS_FW_CONFIG DTs once they are loaded
+ * The first matching variant is used.
+ */
+#if STM32MP_DT_VARIANTS
+void stm32mp_dt_variant_select(void *fw_config);
+int stm32mp_dt_variant_apply(unsigned int image_id, image_info_t *image_info);
+int stm32mp_dt_overlay_apply(void *fdt, void *fdto);
+#else
+static inline void stm32mp_dt_variant_select(void *fw_config)
+{
+}
+
+static inline int stm32mp_dt_variant_apply(unsigned int image_id,
+					   image_info_t *image_info)
+{
+	return 0;
+}
+#endif
+
+#endif /* STM32MP_DT_VARIANTS_H */
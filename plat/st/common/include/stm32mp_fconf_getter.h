@@ -26,6 +26,6 @@ struct plat_io_policy {
 };
 
 extern struct plat_io_policy policies[];
-int fconf_populate_stm32mp_io_policies(uintptr_t config);
+int fconf_populate_stm32mp_io_policies(uintptr_t config, int node);
 
 #endif /* STM32MP_FCONF_GETTER */
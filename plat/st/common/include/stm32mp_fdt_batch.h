@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_FDT_BATCH_H
+#define STM32MP_FDT_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Edits of a device tree are recorded against the node offsets of the
+ * unmodified tree, then applied all at once by stm32mp_fdt_batch_apply().
+ * Nodes added by stm32mp_fdt_batch_add_subnode() are referred to by the
+ * handle it returns, which can be used as a node offset in the other calls.
+ */
+#define FDT_BATCH_NEW_NODE		0x40000000
+
+void stm32mp_fdt_batch_init(const void *fdt);
+int stm32mp_fdt_batch_setprop(int nodeoffset, const char *name,
+			      const void *val, int len);
+int stm32mp_fdt_batch_setprop_u32(int nodeoffset, const char *name,
+				  uint32_t val);
+int stm32mp_fdt_batch_setprop_string(int nodeoffset, const char *name,
+				     const char *str);
+int stm32mp_fdt_batch_delprop(int nodeoffset, const char *name);
+int stm32mp_fdt_batch_del_node(int nodeoffset);
+int stm32mp_fdt_batch_add_subnode(int parentoffset, const char *name);
+int stm32mp_fdt_batch_add_reserved_memory(const char *node_name,
+					  uintptr_t base, size_t size);
+int stm32mp_fdt_batch_apply(void *fdt, size_t bufsize);
+
+#endif /* STM32MP_FDT_BATCH_H */
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_INIT_TASKS_H
+#define STM32MP_INIT_TASKS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STM32MP_INIT_TASKS_MAX		32U
+
+/*
+ * struct stm32mp_init_task - BL2 initialisation split around its waits
+ * @name: Name, for the traces
+ * @deps: Mask of the indexes, in the same table, of the tasks to complete
+ *	  before this one is started
+ * @start: Start the initialisation, it panics on error. NULL if nothing is
+ *	   started by the scheduler: the task is then completed by
+ *	   stm32mp_init_task_complete(), as a milestone of a blocking sequence.
+ * @poll: Step the initialisation, returns true while it is not done. It must
+ *	  return quickly, it panics on error. NULL if done once started.
+ */
+struct stm32mp_init_task {
+	const char *name;
+	uint32_t deps;
+	void (*start)(void);
+	bool (*poll)(void);
+};
+
+/*
+ * The tasks are run cooperatively, on the calling CPU: each step starts the
+ * tasks whose dependencies are completed, and polls the started ones once.
+ * The blocking sequences call stm32mp_init_tasks_step() from their own waits,
+ * so that the waits of the tasks are interleaved with them.
+ */
+void stm32mp_init_tasks_register(const struct stm32mp_init_task *tasks,
+				 unsigned int nb);
+void stm32mp_init_tasks_step(void);
+void stm32mp_init_task_complete(unsigned int id);
+void stm32mp_init_tasks_wait(uint32_t mask);
+bool stm32mp_init_tasks_done(uint32_t mask);
+
+#endif /* STM32MP_INIT_TASKS_H */
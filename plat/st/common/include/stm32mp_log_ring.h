@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_LOG_RING_H
+#define STM32MP_LOG_RING_H
+
+#include <stdint.h>
+
+#include <drivers/console.h>
+
+#define LOG_RING_MAGIC			0x474F4C54U	/* "TLOG" */
+
+/*
+ * Layout of the per-CPU log rings stored at STM32MP_LOG_RING_BASE, one every
+ * STM32MP_LOG_RING_SIZE / PLATFORM_CORE_COUNT bytes. head and tail are free
+ * running counts of the characters written and drained to the UART: the last
+ * size characters written are kept in data[], at their count modulo size.
+ */
+struct stm32mp_log_ring {
+	uint32_t magic;
+	uint32_t size;
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	char data[];
+};
+
+#if STM32MP_LOG_RING
+void stm32mp_log_ring_init(void);
+void stm32mp_log_ring_set_uart(console_t *uart, unsigned int scope);
+void stm32mp_log_ring_drain(void);
+void stm32mp_log_ring_handoff(void);
+int stm32mp_log_ring_dt_fixup(void);
+#else
+static inline void stm32mp_log_ring_init(void)
+{
+}
+
+static inline void stm32mp_log_ring_drain(void)
+{
+}
+
+static inline void stm32mp_log_ring_handoff(void)
+{
+}
+#endif
+
+#endif /* STM32MP_LOG_RING_H */
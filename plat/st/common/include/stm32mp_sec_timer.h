@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_SEC_TIMER_H
+#define STM32MP_SEC_TIMER_H
+
+#include <stdint.h>
+
+/*
+ * Deadlines of the periodic secure tasks of SP_min, multiplexed on the secure
+ * physical timer. A task armed with a delay and a slack runs once, at any time
+ * from the delay to the delay plus the slack: the timer is programmed to the
+ * earliest latest time, and all the tasks already due then run together. A
+ * periodic task arms itself again from its function. No interrupt is left
+ * pending while no task is armed.
+ */
+#define STM32MP_SEC_TIMER_NB	4U
+
+int stm32mp_sec_timer_register(void (*fn)(void), uint64_t slack_ticks);
+void stm32mp_sec_timer_arm(unsigned int id, uint64_t delay_ticks);
+void stm32mp_sec_timer_arm_at(unsigned int id, uint64_t deadline);
+void stm32mp_sec_timer_cancel(unsigned int id);
+void stm32mp_sec_timer_it_handler(void);
+
+#endif /* STM32MP_SEC_TIMER_H */
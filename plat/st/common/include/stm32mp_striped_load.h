@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_STRIPED_LOAD_H
+#define STM32MP_STRIPED_LOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/bl_common.h>
+#include <lib/utils_def.h>
+
+/* SD/eMMC reads between two steps of the SPI-NOR copy */
+#define STM32MP_STRIPED_LOAD_MMC_CHUNK	U(0x40000)
+
+/*
+ * Images split between the FIP, on the SD card or eMMC, and the SPI-NOR.
+ * The FW_CONFIG node compatible with "st,io-fip-handle" lists the extents:
+ * <name>_extent = <nor_offset image_offset size>, with the FIP entry holding
+ * the first image_offset bytes of the image and the SPI-NOR the next size
+ * bytes, at nor_offset. The extent is copied from the QUADSPI memory mapped
+ * window by the MDMA while the SDMMC IDMA reads the FIP entry.
+ */
+#if STM32MP_STRIPED_LOAD
+int stm32mp_striped_load_populate(const void *fdt, int node);
+bool stm32mp_striped_load_start(unsigned int image_id);
+void stm32mp_striped_load_hook(uintptr_t buf, size_t size);
+int stm32mp_striped_load_complete(unsigned int image_id,
+				  image_info_t *image_info);
+#else
+static inline int stm32mp_striped_load_populate(const void *fdt, int node)
+{
+	return 0;
+}
+
+static inline int stm32mp_striped_load_complete(unsigned int image_id,
+						image_info_t *image_info)
+{
+	return 0;
+}
+#endif
+
+#endif /* STM32MP_STRIPED_LOAD_H */
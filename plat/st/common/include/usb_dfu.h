@@ -13,8 +13,8 @@
 
 #define DFU_DESCRIPTOR_TYPE		0x21U
 
-/* Max DFU Packet Size = 1024 bytes */
-#define USBD_DFU_XFER_SIZE		1024U
+/* Max DFU Packet Size, wTransferSize of the DFU functional descriptor */
+#define USBD_DFU_XFER_SIZE		U(STM32MP_USB_DFU_XFER_SIZE)
 
 #define TRANSFER_SIZE_BYTES(size) \
 	((uint8_t)((size) & 0xFF)), /* XFERSIZEB0 */\
@@ -84,12 +84,8 @@ struct stm32prog_uart_handle_s {
 
 static int uart_write(const uint8_t *addr, uint16_t size)
 {
-	while (size != 0U) {
-		if (stm32_uart_putc(&handle.uart, *addr) != 0) {
-			return -EIO;
-		}
-		size--;
-		addr++;
+	if (stm32_uart_write(&handle.uart, addr, size) != 0) {
+		return -EIO;
 	}
 
 	return 0;
@@ -329,14 +325,15 @@ static int uart_download_part(void)
 		return 0;
 	}
 
-	for (i = 0U; i < packet_size; i++) {
-		ret = uart_read_8(&byte);
-		if (ret != 0) {
-			return ret;
-		}
+	/* Whole packet read from the RX FIFO, checksum computed after */
+	ret = stm32_uart_read(&handle.uart, handle.addr, packet_size,
+			      PROGRAMMER_TIMEOUT_US);
+	if (ret != 0) {
+		return ret;
+	}
 
-		*(handle.addr + i) = byte;
-		xor ^= byte;
+	for (i = 0U; i < packet_size; i++) {
+		xor ^= *(handle.addr + i);
 	}
 
 	/* Checksum */
@@ -141,6 +141,11 @@ static int dfu_callback_upload(uint8_t alt, uintptr_t *buffer, uint32_t *len,
 	return result;
 }
 
+/*
+ * Each block is received in place, at its final address in the load buffer:
+ * nothing is done per block, the next DNLOAD is accepted as soon as the
+ * GETSTATUS is answered. The image is only checked at manifestation.
+ */
 static int dfu_callback_download(uint8_t alt, uintptr_t *buffer, uint32_t *len,
 				 void *user_data)
 {
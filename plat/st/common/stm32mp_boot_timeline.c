@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_boot_timeline.h>
+
+#define BOOT_TL_MAX_ENTRIES	((STM32MP_BOOT_TIMELINE_SIZE - \
+				  sizeof(struct stm32mp_boot_tl)) / \
+				 sizeof(struct stm32mp_boot_tl_entry))
+
+CASSERT(STM32MP_BOOT_TIMELINE_SIZE > sizeof(struct stm32mp_boot_tl),
+	assert_boot_timeline_size);
+
+static struct stm32mp_boot_tl *boot_tl(void)
+{
+	return (struct stm32mp_boot_tl *)STM32MP_BOOT_TIMELINE_BASE;
+}
+
+static const char *boot_timeline_name(unsigned int id)
+{
+	static const char * const names[] = {
+		[BOOT_TL_BL2_ENTRY] = "BL2 entry",
+		[BOOT_TL_BL2_ARCH_SETUP_END] = "BL2 arch setup",
+		[BOOT_TL_DDR_INIT_START] = "DDR init start",
+		[BOOT_TL_DDR_INIT_END] = "DDR init end",
+		[BOOT_TL_IO_SETUP_START] = "IO setup start",
+		[BOOT_TL_IO_SETUP_END] = "IO setup end",
+		[BOOT_TL_IMAGE_LOAD_START] = "Image load start",
+		[BOOT_TL_IMAGE_LOAD_END] = "Image load end",
+		[BOOT_TL_BL2_EXIT] = "BL2 exit",
+		[BOOT_TL_BL32_ENTRY] = "BL32 entry",
+		[BOOT_TL_BL32_SETUP_END] = "BL32 setup",
+	};
+
+	if ((id >= ARRAY_SIZE(names)) || (names[id] == NULL)) {
+		return "?";
+	}
+
+	return names[id];
+}
+
+/*
+ * The system counter rate may be changed during clock setup, the counter
+ * value being rescaled accordingly: convert each timestamp when taken.
+ */
+static uint32_t boot_timeline_now_us(void)
+{
+	uint64_t freq = read_cntfrq_el0();
+
+	if (freq == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)((read_cntpct_el0() * 1000000ULL) / freq);
+}
+
+void stm32mp_boot_timeline_init(void)
+{
+	struct stm32mp_boot_tl *tl = boot_tl();
+
+	tl->magic = BOOT_TL_MAGIC;
+	tl->count = 0U;
+	tl->max = BOOT_TL_MAX_ENTRIES;
+	tl->reserved = 0U;
+}
+
+void stm32mp_boot_timeline_mark(unsigned int id, unsigned int arg)
+{
+	struct stm32mp_boot_tl *tl = boot_tl();
+	struct stm32mp_boot_tl_entry *entry;
+
+	if ((tl->magic != BOOT_TL_MAGIC) || (tl->count >= tl->max)) {
+		return;
+	}
+
+	entry = &tl->entry[tl->count];
+	entry->id = (uint16_t)id;
+	entry->arg = (uint16_t)arg;
+	entry->time_us = boot_timeline_now_us();
+
+	tl->count++;
+}
+
+void stm32mp_boot_timeline_dump(void)
+{
+	struct stm32mp_boot_tl *tl = boot_tl();
+	uint32_t prev_us = 0U;
+	unsigned int i;
+
+	if (tl->magic != BOOT_TL_MAGIC) {
+		return;
+	}
+
+	NOTICE("Boot timeline (us):\n");
+
+	for (i = 0U; i < tl->count; i++) {
+		struct stm32mp_boot_tl_entry *entry = &tl->entry[i];
+
+		if ((entry->id == BOOT_TL_IMAGE_LOAD_START) ||
+		    (entry->id == BOOT_TL_IMAGE_LOAD_END)) {
+			NOTICE("  %08u +%07u %s (%u)\n", entry->time_us,
+			       entry->time_us - prev_us,
+			       boot_timeline_name(entry->id), entry->arg);
+		} else {
+			NOTICE("  %08u +%07u %s\n", entry->time_us,
+			       entry->time_us - prev_us,
+			       boot_timeline_name(entry->id));
+		}
+
+		prev_us = entry->time_us;
+	}
+
+	/* Make the timeline visible to the next stages */
+	flush_dcache_range((uintptr_t)tl, STM32MP_BOOT_TIMELINE_SIZE);
+}
@@ -22,6 +22,8 @@
 
 #include <platform_def.h>
 
+#include <stm32mp_log_ring.h>
+
 #define HEADER_VERSION_MAJOR_MASK	GENMASK(23, 16)
 #define RESET_TIMEOUT_US_1MS		1000U
 
@@ -118,8 +120,15 @@ int stm32mp_map_ddr_non_cacheable(void)
 
 int stm32mp_unmap_ddr(void)
 {
-	return  mmap_remove_dynamic_region(STM32MP_DDR_BASE,
-					   STM32MP_DDR_MAX_SIZE);
+	int ret;
+
+	/* One TLB invalidation for the whole DDR, instead of one per entry */
+	mmap_dynamic_batch_begin();
+	ret = mmap_remove_dynamic_region(STM32MP_DDR_BASE,
+					 STM32MP_DDR_MAX_SIZE);
+	mmap_dynamic_batch_commit();
+
+	return ret;
 }
 
 int stm32_get_otp_index(const char *otp_name, uint32_t *otp_idx,
@@ -192,6 +201,18 @@ static void reset_uart(uint32_t reset)
 }
 #endif
 
+static void set_console_scope(unsigned int console_flags)
+{
+#if STM32MP_LOG_RING
+	/* Messages are written in the log rings, drained to the UART */
+	stm32mp_log_ring_set_uart(&console, console_flags &
+				  (CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME));
+	console_flags &= ~(CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME);
+#endif
+
+	console_set_scope(&console, console_flags);
+}
+
 static void set_console(uintptr_t base, uint32_t clk_rate)
 {
 	unsigned int console_flags;
@@ -207,7 +228,7 @@ static void set_console(uintptr_t base, uint32_t clk_rate)
 	console_flags |= CONSOLE_FLAG_RUNTIME;
 #endif
 
-	console_set_scope(&console, console_flags);
+	set_console_scope(console_flags);
 }
 
 int stm32mp_uart_console_setup(void)
@@ -280,7 +301,7 @@ void stm32mp_set_console_after_standby(void)
 		console_flags |= CONSOLE_FLAG_RUNTIME;
 #endif
 	}
-	console_set_scope(&console, console_flags);
+	set_console_scope(console_flags);
 }
 
 /*****************************************************************************
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <endian.h>
 #include <errno.h>
+#include <stdbool.h>
 
 #include <mbedtls/asn1.h>
 #include <mbedtls/md.h>
@@ -24,16 +25,20 @@
 #include <drivers/st/stm32_rng.h>
 #include <drivers/st/stm32_saes.h>
 #endif
+#include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <plat/common/platform.h>
 #include <tools_share/firmware_encrypted.h>
 
 #include <platform_def.h>
+#include <stm32mp1_bl2_smp.h>
 
 #define CRYPTO_HASH_MAX_SIZE	32U
+#define CRYPTO_DIGEST_MAX_SIZE	64U
 #define CRYPTO_SIGN_MAX_SIZE	64U
 #define CRYPTO_PUBKEY_MAX_SIZE	64U
 #define CRYPTO_MAX_TAG_SIZE	16U
+#define CRYPTO_RSA_MAX_SIZE	512U
 
 #if STM32MP15
 struct stm32mp_auth_ops {
@@ -45,6 +50,9 @@ static struct stm32mp_auth_ops auth_ops;
 
 #endif
 
+/* Cleared if the HASH peripheral cannot be used, digests are then in software */
+static bool hash_hw_ready;
+
 static void crypto_lib_init(void)
 {
 #if STM32MP15
@@ -58,8 +66,15 @@ static void crypto_lib_init(void)
 
 	ret = stm32_hash_register();
 	if (ret != 0) {
-		ERROR("HASH init (%d)\n", ret);
-		panic();
+		WARN("HASH init (%d), digests computed in software\n", ret);
+	} else {
+		hash_hw_ready = true;
+	}
+
+	/* Read once the root public key hash used for each root certificate */
+	ret = stm32mp_rotpk_hash_load();
+	if (ret != 0) {
+		VERBOSE("ROTPK hash not loaded (%d)\n", ret);
 	}
 
 	if (!stm32mp_is_closed_device() && !stm32mp_is_auth_supported()) {
@@ -172,14 +187,28 @@ static uint32_t verify_signature(uint8_t *hash_in, uint8_t *pubkey_in,
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	ret = stm32_pka_ecdsa_verif(hash_in,
-				    BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES,
-				    signature, BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
-				    signature + BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
-				    BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
-				    pubkey_in, BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U,
-				    pubkey_in + BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U,
-				    BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U, cid);
+	/*
+	 * The whole chain of trust is verified on the same curve: keep the
+	 * PKA session opened, curve parameters are only loaded on the first
+	 * verification. The session is closed when BL2 exits.
+	 */
+	ret = stm32_pka_ecdsa_verif_session_start(cid);
+	if (ret < 0) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	ret = stm32_pka_ecdsa_verif_session_run(hash_in,
+						BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES,
+						signature,
+						BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
+						signature +
+						BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
+						BOOT_API_ECDSA_SIGNATURE_LEN_IN_BYTES / 2U,
+						pubkey_in,
+						BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U,
+						pubkey_in +
+						BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U,
+						BOOT_API_ECDSA_PUB_KEY_LEN_IN_BYTES / 2U);
 	if (ret < 0) {
 		return CRYPTO_ERR_SIGNATURE;
 	}
@@ -248,6 +277,87 @@ int plat_get_hashed_pk(void *full_pk_ptr, unsigned int full_pk_len,
 }
 #endif
 
+static size_t crypto_md_size(mbedtls_md_type_t md_alg)
+{
+	switch (md_alg) {
+	case MBEDTLS_MD_SHA1:
+		return 20U;
+	case MBEDTLS_MD_SHA224:
+		return 28U;
+	case MBEDTLS_MD_SHA256:
+		return 32U;
+	case MBEDTLS_MD_SHA384:
+		return 48U;
+	case MBEDTLS_MD_SHA512:
+		return 64U;
+	default:
+		return 0U;
+	}
+}
+
+/* HASH peripheral mode for the algorithm, false if it is not supported */
+static bool crypto_hash_hw_mode(mbedtls_md_type_t md_alg,
+				enum stm32_hash_algo_mode *mode)
+{
+	if (!hash_hw_ready) {
+		return false;
+	}
+
+	switch (md_alg) {
+	case MBEDTLS_MD_SHA1:
+		*mode = HASH_SHA1;
+		break;
+	case MBEDTLS_MD_SHA224:
+		*mode = HASH_SHA224;
+		break;
+	case MBEDTLS_MD_SHA256:
+		*mode = HASH_SHA256;
+		break;
+#if STM32MP13
+	case MBEDTLS_MD_SHA384:
+		*mode = HASH_SHA384;
+		break;
+	case MBEDTLS_MD_SHA512:
+		*mode = HASH_SHA512;
+		break;
+#endif
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Compute a digest with the HASH peripheral, or in software if the peripheral
+ * does not support the algorithm or fails. Used for image and key digests,
+ * and for measured boot.
+ */
+static int crypto_calc_hash(unsigned int alg, void *data_ptr,
+			    unsigned int data_len, unsigned char *output)
+{
+	const mbedtls_md_info_t *md_info;
+	enum stm32_hash_algo_mode mode;
+
+	if (crypto_hash_hw_mode((mbedtls_md_type_t)alg, &mode)) {
+		stm32_hash_init(mode);
+
+		if (stm32_hash_final_update(data_ptr, data_len, output) == 0) {
+			return CRYPTO_SUCCESS;
+		}
+
+		WARN("%s: HASH failed, computed in software\n", __func__);
+	}
+
+	md_info = mbedtls_md_info_from_type((mbedtls_md_type_t)alg);
+	if ((md_info == NULL) ||
+	    (mbedtls_md(md_info, data_ptr, data_len, output) != 0)) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
 static int get_plain_digest_from_asn1(void *digest_ptr, unsigned int digest_len,
 				      uint8_t **out, size_t *out_len, mbedtls_md_type_t *md_alg)
 {
@@ -285,7 +395,7 @@ static int get_plain_digest_from_asn1(void *digest_ptr, unsigned int digest_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES) {
+	if ((len == 0U) || (len != crypto_md_size(*md_alg))) {
 		return -1;
 	}
 
@@ -295,6 +405,277 @@ static int get_plain_digest_from_asn1(void *digest_ptr, unsigned int digest_len,
 	return 0;
 }
 
+#if PKA_USE_RSA
+/* Get the modulus and the public exponent of a SubjectPublicKeyInfo */
+static int get_rsa_pk_from_asn1(void *pk_ptr, unsigned int pk_len,
+				unsigned char **n, size_t *n_len,
+				unsigned char **e, size_t *e_len)
+{
+	mbedtls_asn1_buf alg_oid, alg_params;
+	mbedtls_pk_type_t pk_alg;
+	unsigned char *p, *end;
+	size_t len;
+
+	p = (unsigned char *)pk_ptr;
+	end = p + pk_len;
+
+	if (mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				 MBEDTLS_ASN1_SEQUENCE) != 0) {
+		return -EINVAL;
+	}
+
+	end = p + len;
+	if ((mbedtls_asn1_get_alg(&p, end, &alg_oid, &alg_params) != 0) ||
+	    (mbedtls_oid_get_pk_alg(&alg_oid, &pk_alg) != 0) ||
+	    (pk_alg != MBEDTLS_PK_RSA)) {
+		return -EINVAL;
+	}
+
+	/* RSAPublicKey ::= SEQUENCE { modulus INTEGER, publicExponent INTEGER } */
+	if ((mbedtls_asn1_get_bitstring_null(&p, end, &len) != 0) ||
+	    (mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				  MBEDTLS_ASN1_SEQUENCE) != 0) ||
+	    (mbedtls_asn1_get_tag(&p, end, n_len, MBEDTLS_ASN1_INTEGER) != 0)) {
+		return -EINVAL;
+	}
+
+	*n = p;
+	p += *n_len;
+
+	if (mbedtls_asn1_get_tag(&p, end, e_len, MBEDTLS_ASN1_INTEGER) != 0) {
+		return -EINVAL;
+	}
+
+	*e = p;
+
+	/* Remove the sign byte of the modulus */
+	while ((*n_len > 0U) && (**n == 0U)) {
+		(*n)++;
+		(*n_len)--;
+	}
+
+	if ((*n_len == 0U) || (*n_len > CRYPTO_RSA_MAX_SIZE) || (*e_len == 0U)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* EMSA-PKCS1-v1_5 encoded message check (RFC 8017 section 9.2) */
+static int rsa_pkcs1_v15_check(const uint8_t *em, size_t em_len,
+			       mbedtls_md_type_t md_alg,
+			       const uint8_t *digest, size_t digest_len)
+{
+	/* DigestInfo header, the algorithm is set in byte 14 */
+	static const uint8_t digest_info[] = {
+		0x30, 0x00, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01,
+		0x65, 0x03, 0x04, 0x02, 0x00, 0x05, 0x00, 0x04, 0x00,
+	};
+	uint8_t header[sizeof(digest_info)];
+	size_t t_len = sizeof(header) + digest_len;
+	size_t i;
+
+	memcpy(header, digest_info, sizeof(header));
+
+	switch (md_alg) {
+	case MBEDTLS_MD_SHA256:
+		header[14] = 0x01;
+		break;
+	case MBEDTLS_MD_SHA384:
+		header[14] = 0x02;
+		break;
+	case MBEDTLS_MD_SHA512:
+		header[14] = 0x03;
+		break;
+	default:
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	header[1] = (uint8_t)(t_len - 2U);
+	header[18] = (uint8_t)digest_len;
+
+	/* 0x00 || 0x01 || PS (at least 8 0xff) || 0x00 || T */
+	if ((em_len < (t_len + 11U)) || (em[0] != 0x00U) || (em[1] != 0x01U)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	for (i = 2U; i < (em_len - t_len - 1U); i++) {
+		if (em[i] != 0xffU) {
+			return CRYPTO_ERR_SIGNATURE;
+		}
+	}
+
+	if ((em[i] != 0x00U) ||
+	    (memcmp(&em[i + 1U], header, sizeof(header)) != 0) ||
+	    (timingsafe_bcmp(&em[i + 1U + sizeof(header)], digest,
+			     digest_len) != 0)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/* EMSA-PSS encoded message check (RFC 8017 section 9.1.2), em is unmasked */
+static int rsa_pss_check(uint8_t *em, size_t em_len, unsigned int em_bits,
+			 mbedtls_md_type_t md_alg, mbedtls_md_type_t mgf_md,
+			 int salt_len, const uint8_t *digest, size_t digest_len)
+{
+	uint8_t m_prime[8U + (2U * CRYPTO_DIGEST_MAX_SIZE)];
+	uint8_t mgf_in[CRYPTO_DIGEST_MAX_SIZE + sizeof(uint32_t)];
+	uint8_t mask[CRYPTO_DIGEST_MAX_SIZE];
+	uint8_t calc_hash[CRYPTO_DIGEST_MAX_SIZE];
+	size_t mgf_len = crypto_md_size(mgf_md);
+	size_t db_len;
+	size_t slen;
+	uint8_t top_mask;
+	uint8_t *h;
+	uint32_t counter;
+	size_t i;
+
+	/* The encoded message has one byte less if em_bits is a multiple of 8 */
+	if ((em_bits % 8U) == 0U) {
+		if (em[0] != 0x00U) {
+			return CRYPTO_ERR_SIGNATURE;
+		}
+
+		em++;
+		em_len--;
+	}
+
+	if ((salt_len < 0) || ((size_t)salt_len > CRYPTO_DIGEST_MAX_SIZE) ||
+	    (mgf_len == 0U) ||
+	    (em_len < (digest_len + (size_t)salt_len + 2U)) ||
+	    (em[em_len - 1U] != 0xbcU)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	slen = (size_t)salt_len;
+	db_len = em_len - digest_len - 1U;
+	h = &em[db_len];
+	top_mask = (uint8_t)(0xffU >> ((8U * em_len) - em_bits));
+
+	if ((em[0] & ~top_mask) != 0U) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	/* DB = maskedDB xor MGF1(H) */
+	memcpy(mgf_in, h, digest_len);
+	for (i = 0U, counter = 0U; i < db_len; counter++) {
+		size_t j;
+
+		mgf_in[digest_len] = (uint8_t)(counter >> 24);
+		mgf_in[digest_len + 1U] = (uint8_t)(counter >> 16);
+		mgf_in[digest_len + 2U] = (uint8_t)(counter >> 8);
+		mgf_in[digest_len + 3U] = (uint8_t)counter;
+
+		if (crypto_calc_hash(mgf_md, mgf_in, digest_len + 4U,
+				     mask) != 0) {
+			return CRYPTO_ERR_SIGNATURE;
+		}
+
+		for (j = 0U; (j < mgf_len) && (i < db_len); j++, i++) {
+			em[i] ^= mask[j];
+		}
+	}
+
+	em[0] &= top_mask;
+
+	/* DB = PS (zeros) || 0x01 || salt */
+	for (i = 0U; i < (db_len - slen - 1U); i++) {
+		if (em[i] != 0x00U) {
+			return CRYPTO_ERR_SIGNATURE;
+		}
+	}
+
+	if (em[i] != 0x01U) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	/* M' = 8 zero bytes || mHash || salt */
+	memset(m_prime, 0, 8U);
+	memcpy(&m_prime[8], digest, digest_len);
+	memcpy(&m_prime[8U + digest_len], &em[db_len - slen], slen);
+
+	if ((crypto_calc_hash(md_alg, m_prime, 8U + digest_len + slen,
+			      calc_hash) != 0) ||
+	    (timingsafe_bcmp(calc_hash, h, digest_len) != 0)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * RSA PKCS#1 v1.5 and PSS signature verification, the public exponentiation
+ * being computed by the PKA.
+ */
+static int crypto_verify_rsa_signature(void *data_ptr, unsigned int data_len,
+				       void *sig_ptr, unsigned int sig_len,
+				       mbedtls_asn1_buf *sig_params,
+				       mbedtls_md_type_t md_alg,
+				       mbedtls_pk_type_t pk_alg,
+				       void *pk_ptr, unsigned int pk_len)
+{
+	static uint8_t em[CRYPTO_RSA_MAX_SIZE];
+	uint8_t digest[CRYPTO_DIGEST_MAX_SIZE];
+	mbedtls_md_type_t mgf_md = md_alg;
+	int salt_len = 0;
+	unsigned char *n, *e, *s, *end;
+	size_t n_len, e_len, s_len, digest_len;
+	unsigned int n_bits;
+	int ret;
+
+	if (pk_alg == MBEDTLS_PK_RSASSA_PSS) {
+		ret = mbedtls_x509_get_rsassa_pss_params(sig_params, &md_alg,
+							 &mgf_md, &salt_len);
+		if (ret != 0) {
+			VERBOSE("%s: PSS parameters (%d)\n", __func__, ret);
+			return CRYPTO_ERR_SIGNATURE;
+		}
+	}
+
+	digest_len = crypto_md_size(md_alg);
+	if (digest_len == 0U) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	ret = get_rsa_pk_from_asn1(pk_ptr, pk_len, &n, &n_len, &e, &e_len);
+	if (ret != 0) {
+		VERBOSE("%s: get_rsa_pk_from_asn1 (%d)\n", __func__, ret);
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	/* The signature is an integer of the size of the modulus */
+	s = (unsigned char *)sig_ptr;
+	end = s + sig_len;
+	ret = mbedtls_asn1_get_bitstring_null(&s, end, &s_len);
+	if ((ret != 0) || (s_len != n_len)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	ret = stm32_pka_rsa_public(n, n_len, e, e_len, s, em);
+	if (ret != 0) {
+		VERBOSE("%s: stm32_pka_rsa_public (%d)\n", __func__, ret);
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	ret = crypto_calc_hash(md_alg, data_ptr, data_len, digest);
+	if (ret != 0) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	if (pk_alg == MBEDTLS_PK_RSA) {
+		return rsa_pkcs1_v15_check(em, n_len, md_alg, digest,
+					   digest_len);
+	}
+
+	n_bits = (n_len * 8U) - ((unsigned int)__builtin_clz(n[0]) - 24U);
+
+	return rsa_pss_check(em, n_len, n_bits - 1U, md_alg, mgf_md, salt_len,
+			     digest, digest_len);
+}
+#endif /* PKA_USE_RSA */
+
 static int crypto_verify_signature(void *data_ptr, unsigned int data_len,
 				   void *sig_ptr, unsigned int sig_len,
 				   void *sig_alg, unsigned int sig_alg_len,
@@ -335,6 +716,15 @@ static int crypto_verify_signature(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
+#if PKA_USE_RSA
+	if ((pk_alg == MBEDTLS_PK_RSA) || (pk_alg == MBEDTLS_PK_RSASSA_PSS)) {
+		return crypto_verify_rsa_signature(data_ptr, data_len,
+						   sig_ptr, sig_len,
+						   &sig_params, md_alg, pk_alg,
+						   pk_ptr, pk_len);
+	}
+#endif
+
 	if ((md_alg != MBEDTLS_MD_SHA256) || (pk_alg != MBEDTLS_PK_ECDSA)) {
 		VERBOSE("%s: md_alg=%d pk_alg=%d\n", __func__, md_alg, pk_alg);
 		return CRYPTO_ERR_SIGNATURE;
@@ -424,23 +814,91 @@ static int crypto_verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_free(seq.next);
 
 	/* Compute hash for the data covered by the signature */
-	stm32_hash_init(HASH_SHA256);
-
-	ret = stm32_hash_final_update((uint8_t *)data_ptr, data_len, image_hash);
+	ret = crypto_calc_hash(MBEDTLS_MD_SHA256, data_ptr, data_len,
+			       image_hash);
 	if (ret != 0) {
-		VERBOSE("%s: stm32_hash_final_update (%d)\n", __func__, ret);
+		VERBOSE("%s: crypto_calc_hash (%d)\n", __func__, ret);
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
 	return verify_signature(image_hash, my_pk, sig, curve_id);
 }
 
+#if STM32MP_BL2_SMP_CRYPTO
+/* One entry per queued job, reused once the job is completed */
+static struct deferred_hash {
+	void *data;
+	unsigned int len;
+	mbedtls_md_type_t md_alg;
+	size_t digest_len;
+	uint8_t digest[CRYPTO_DIGEST_MAX_SIZE];
+} deferred_hash[STM32MP1_BL2_SMP_QUEUE_SIZE];
+static unsigned int deferred_hash_count;
+
+/*
+ * Executed on the secondary core. The software implementation is used,
+ * the HASH peripheral remaining available for core 0 certificates.
+ */
+static int crypto_deferred_hash_job(void *arg)
+{
+	struct deferred_hash *hash = arg;
+	const mbedtls_md_info_t *md_info;
+	uint8_t calc_hash[CRYPTO_DIGEST_MAX_SIZE];
+	int ret;
+
+	md_info = mbedtls_md_info_from_type(hash->md_alg);
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	ret = mbedtls_md(md_info, hash->data, hash->len, calc_hash);
+	if (ret != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (timingsafe_bcmp(calc_hash, hash->digest, hash->digest_len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Hashes are queued in load order, core 0 only waits when the queue is
+ * full. Images are loaded after their parent certificate is authenticated
+ * on core 0, results are all collected before BL2 exits.
+ */
+static int crypto_defer_hash(void *data_ptr, unsigned int data_len,
+			     mbedtls_md_type_t md_alg, void *digest_ptr,
+			     size_t digest_len)
+{
+	struct deferred_hash *hash =
+		&deferred_hash[deferred_hash_count % STM32MP1_BL2_SMP_QUEUE_SIZE];
+	int ret;
+
+	stm32mp1_bl2_smp_reserve();
+
+	hash->data = data_ptr;
+	hash->len = data_len;
+	hash->md_alg = md_alg;
+	hash->digest_len = digest_len;
+	memcpy(hash->digest, digest_ptr, digest_len);
+
+	ret = stm32mp1_bl2_smp_run(crypto_deferred_hash_job, hash);
+	if (ret == 0) {
+		deferred_hash_count++;
+	}
+
+	return ret;
+}
+#endif /* STM32MP_BL2_SMP_CRYPTO */
+
 static int crypto_verify_hash(void *data_ptr, unsigned int data_len,
 			      void *digest_info_ptr,
 			      unsigned int digest_info_len)
 {
 	int ret;
-	uint8_t calc_hash[BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES];
+	uint8_t calc_hash[CRYPTO_DIGEST_MAX_SIZE];
 	unsigned char *p;
 	mbedtls_md_type_t md_alg;
 	size_t len;
@@ -449,22 +907,130 @@ static int crypto_verify_hash(void *data_ptr, unsigned int data_len,
 	ret = get_plain_digest_from_asn1(digest_info_ptr,
 					 digest_info_len, &p, &len,
 					 &md_alg);
-	if ((ret != 0) || (md_alg != MBEDTLS_MD_SHA256) || (len != sizeof(calc_hash))) {
+	if (ret != 0) {
 		return CRYPTO_ERR_HASH;
 	}
 
 	digest_info_ptr = p;
 	digest_info_len = len;
 
-	stm32_hash_init(HASH_SHA256);
+#if STM32MP_BL2_SMP_CRYPTO
+	/* Image is checked in background, result collected before BL2 exits */
+	if (stm32mp1_bl2_smp_image_deferrable() &&
+	    (crypto_defer_hash(data_ptr, data_len, md_alg, digest_info_ptr,
+			       len) == 0)) {
+		return CRYPTO_SUCCESS;
+	}
+#endif
+
+	ret = crypto_calc_hash(md_alg, data_ptr, data_len, calc_hash);
+	if (ret != 0) {
+		VERBOSE("%s: hash failed\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	ret = timingsafe_bcmp(calc_hash, digest_info_ptr, digest_info_len);
+	if (ret != 0) {
+		VERBOSE("%s: not expected digest\n", __func__);
+		ret = CRYPTO_ERR_HASH;
+	}
+
+	return ret;
+}
+
+#if AUTH_STREAM_HASH
+static uint8_t stream_digest[CRYPTO_DIGEST_MAX_SIZE];
+static size_t stream_digest_len;
+
+/*
+ * HASH peripheral context, saved if another digest is computed while the
+ * image is streamed. Software context, used if the HASH peripheral does not
+ * support the digest.
+ */
+static struct stm32_hash_context stream_hw_ctx;
+static mbedtls_md_context_t stream_md_ctx;
+static bool stream_sw;
+
+static int crypto_hash_stream_start(void *digest_info_ptr,
+				    unsigned int digest_info_len)
+{
+	int ret;
+	unsigned char *p;
+	mbedtls_md_type_t md_alg;
+	size_t len;
+
+	enum stm32_hash_algo_mode mode;
+	const mbedtls_md_info_t *md_info;
+
+	ret = get_plain_digest_from_asn1(digest_info_ptr,
+					 digest_info_len, &p, &len,
+					 &md_alg);
+	if (ret != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	memcpy(stream_digest, p, len);
+	stream_digest_len = len;
+
+	stream_sw = !crypto_hash_hw_mode(md_alg, &mode);
+	if (!stream_sw) {
+		stm32_hash_ctx_init(&stream_hw_ctx, mode);
+
+		return CRYPTO_SUCCESS;
+	}
+
+	md_info = mbedtls_md_info_from_type(md_alg);
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	mbedtls_md_init(&stream_md_ctx);
+	if ((mbedtls_md_setup(&stream_md_ctx, md_info, 0) != 0) ||
+	    (mbedtls_md_starts(&stream_md_ctx) != 0)) {
+		mbedtls_md_free(&stream_md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_hash_stream_update(void *data_ptr, unsigned int data_len)
+{
+	int ret;
+
+	if (stream_sw) {
+		ret = mbedtls_md_update(&stream_md_ctx, data_ptr, data_len);
+	} else {
+		ret = stm32_hash_ctx_update(&stream_hw_ctx, data_ptr,
+					    data_len);
+	}
+
+	if (ret != 0) {
+		VERBOSE("%s: hash failed\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_hash_stream_finish(void)
+{
+	int ret;
+	uint8_t calc_hash[CRYPTO_DIGEST_MAX_SIZE];
+
+	if (stream_sw) {
+		ret = mbedtls_md_finish(&stream_md_ctx, calc_hash);
+		mbedtls_md_free(&stream_md_ctx);
+	} else {
+		ret = stm32_hash_ctx_final(&stream_hw_ctx, calc_hash);
+	}
 
-	ret = stm32_hash_final_update(data_ptr, data_len, calc_hash);
 	if (ret != 0) {
 		VERBOSE("%s: hash failed\n", __func__);
 		return CRYPTO_ERR_HASH;
 	}
 
-	ret = memcmp(calc_hash, digest_info_ptr, digest_info_len);
+	ret = timingsafe_bcmp(calc_hash, stream_digest, stream_digest_len);
 	if (ret != 0) {
 		VERBOSE("%s: not expected digest\n", __func__);
 		ret = CRYPTO_ERR_HASH;
@@ -473,7 +1039,29 @@ static int crypto_verify_hash(void *data_ptr, unsigned int data_len,
 	return ret;
 }
 
+REGISTER_CRYPTO_HASH_STREAM(crypto_hash_stream_start,
+			    crypto_hash_stream_update,
+			    crypto_hash_stream_finish);
+#endif /* AUTH_STREAM_HASH */
+
 #if STM32MP13 && !defined(DECRYPTION_SUPPORT_none)
+/*
+ * Key returned by plat_get_enc_key_info(), kept in BL2 secure memory for the
+ * next encrypted images: it does not depend on the image. Wiped before BL2
+ * exits.
+ */
+static struct {
+	uint8_t key[32];
+	size_t len;
+	unsigned int flags;
+	bool valid;
+} enc_key_cache;
+
+void stm32mp_crypto_enc_key_wipe(void)
+{
+	zeromem(&enc_key_cache, sizeof(enc_key_cache));
+}
+
 int derive_key(uint8_t *key, size_t *key_len, size_t len,
 	       unsigned int *flags, const uint8_t *img_id, size_t img_id_len)
 {
@@ -512,6 +1100,14 @@ int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key,
 		return -EINVAL;
 	}
 
+	if (enc_key_cache.valid && (*key_len >= enc_key_cache.len)) {
+		memcpy(key, enc_key_cache.key, enc_key_cache.len);
+		*key_len = enc_key_cache.len;
+		*flags = enc_key_cache.flags;
+
+		return 0;
+	}
+
 	if (stm32_get_otp_index(ENCKEY_OTP, &otp_idx, &otp_len) != 0) {
 		VERBOSE("%s: get %s index error\n", __func__, ENCKEY_OTP);
 		return -EINVAL;
@@ -546,6 +1142,13 @@ int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key,
 		return -EINVAL;
 	}
 
+	if (*key_len <= sizeof(enc_key_cache.key)) {
+		memcpy(enc_key_cache.key, key, *key_len);
+		enc_key_cache.len = *key_len;
+		enc_key_cache.flags = *flags;
+		enc_key_cache.valid = true;
+	}
+
 	return 0;
 }
 
@@ -642,17 +1245,116 @@ static int crypto_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr, si
 	return CRYPTO_SUCCESS;
 }
 
+#if DECRYPTION_STREAM
+static struct stm32_saes_context dec_stream_ctx;
+
+static int crypto_auth_decrypt_stream_start(enum crypto_dec_algo dec_algo,
+					    const void *key, unsigned int key_len,
+					    unsigned int key_flags,
+					    const void *iv, unsigned int iv_len)
+{
+	int ret;
+	uint32_t real_iv[4];
+
+	if (dec_algo != CRYPTO_GCM_DECRYPT) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	/* Same nonce and counter as for crypto_auth_decrypt() */
+	memcpy(real_iv, iv, iv_len);
+	real_iv[3] = htobe32(0x2U);
+
+	ret = stm32_saes_init(&dec_stream_ctx, true, STM32_SAES_MODE_GCM,
+			      select_key(key_flags), key, key_len,
+			      real_iv, sizeof(real_iv));
+	if (ret != 0) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	ret = stm32_saes_update_assodata(&dec_stream_ctx, true, NULL, 0U);
+	if (ret != 0) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_auth_decrypt_stream_update(void *data_ptr, size_t len)
+{
+	int ret;
+
+	/* Only the last part can be a partial block, already managed here */
+	ret = stm32_saes_update_load(&dec_stream_ctx, true, data_ptr, data_ptr,
+				     len);
+	if (ret != 0) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_auth_decrypt_stream_finish(const void *tag,
+					     unsigned int tag_len)
+{
+	int ret;
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	unsigned int diff, i;
+
+	ret = stm32_saes_final(&dec_stream_ctx, tag_buf, sizeof(tag_buf));
+
+	/* Context holds a copy of the key */
+	memset(&dec_stream_ctx, 0, sizeof(dec_stream_ctx));
+
+	if (ret != 0) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	/* Check tag in "constant-time" */
+	for (diff = 0U, i = 0U; i < tag_len; i++) {
+		diff |= ((const unsigned char *)tag)[i] ^ tag_buf[i];
+	}
+
+	if (diff != 0U) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+REGISTER_CRYPTO_DEC_STREAM(crypto_auth_decrypt_stream_start,
+			   crypto_auth_decrypt_stream_update,
+			   crypto_auth_decrypt_stream_finish);
+#endif /* DECRYPTION_STREAM */
+
+#if MEASURED_BOOT
+REGISTER_CRYPTO_LIB("stm32_crypto_lib",
+		    crypto_lib_init,
+		    crypto_verify_signature,
+		    crypto_verify_hash,
+		    crypto_calc_hash,
+		    crypto_auth_decrypt);
+#else
 REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
 		    crypto_verify_signature,
 		    crypto_verify_hash,
 		    crypto_auth_decrypt);
+#endif
 
 #else /* No decryption support */
+#if MEASURED_BOOT
 REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
 		    crypto_verify_signature,
 		    crypto_verify_hash,
+		    crypto_calc_hash,
 		    NULL);
+#else
+REGISTER_CRYPTO_LIB("stm32_crypto_lib",
+		    crypto_lib_init,
+		    crypto_verify_signature,
+		    crypto_verify_hash,
+		    NULL);
+#endif
 
 #endif
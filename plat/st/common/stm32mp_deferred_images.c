@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/bl_common.h>
+#include <common/debug.h>
+#include <common/desc_image_load.h>
+#include <drivers/auth/auth_mod.h>
+#include <drivers/io/io_storage.h>
+#include <plat/common/platform.h>
+#include <tools_share/uuid.h>
+
+#include <stm32mp_deferred_images.h>
+
+#define DEFERRED_IMAGES_MAX		2U
+/* SHA-512 DigestInfo is 83 bytes */
+#define DEFERRED_DIGEST_INFO_MAX_SIZE	96U
+
+struct deferred_image {
+	unsigned int image_id;
+	uintptr_t base;
+	uint32_t max_size;
+	uuid_t uuid;
+	unsigned int digest_info_len;
+	uint8_t digest_info[DEFERRED_DIGEST_INFO_MAX_SIZE];
+};
+
+static struct deferred_image deferred_images[DEFERRED_IMAGES_MAX];
+static unsigned int deferred_images_nb;
+
+/*
+ * Called once the parents of the image are authenticated: the expected hash
+ * is copied, certificates being loaded again over their buffers.
+ */
+int stm32mp_deferred_image_add(unsigned int image_id,
+			       const image_info_t *image_info)
+{
+	struct deferred_image *image;
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
+	int ret;
+
+	if (deferred_images_nb == DEFERRED_IMAGES_MAX) {
+		return -ENOMEM;
+	}
+
+	image = &deferred_images[deferred_images_nb];
+	image->image_id = image_id;
+	image->base = image_info->image_base;
+	image->max_size = image_info->image_max_size;
+
+	ret = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (ret != 0) {
+		return ret;
+	}
+
+	image->uuid = ((const io_uuid_spec_t *)image_spec)->uuid;
+
+	image->digest_info_len = 0U;
+#if TRUSTED_BOARD_BOOT
+	{
+		void *digest_info_ptr;
+		unsigned int digest_info_len;
+
+		ret = auth_mod_get_img_hash(image_id, &digest_info_ptr,
+					    &digest_info_len);
+		if ((ret != 0) ||
+		    (digest_info_len > sizeof(image->digest_info))) {
+			return -EINVAL;
+		}
+
+		(void)memcpy(image->digest_info, digest_info_ptr,
+			     digest_info_len);
+		image->digest_info_len = digest_info_len;
+	}
+#endif
+
+	deferred_images_nb++;
+
+	INFO("BL2: Image id %u left to the next stages\n", image_id);
+
+	return 0;
+}
+
+static int deferred_image_dt_add(void *fdt, int node,
+				 const struct deferred_image *image)
+{
+	char name[16];
+	int subnode;
+	int ret;
+
+	(void)snprintf(name, sizeof(name), "image-%u", image->image_id);
+
+	subnode = fdt_add_subnode(fdt, node, name);
+	if (subnode < 0) {
+		return subnode;
+	}
+
+	ret = fdt_setprop_u32(fdt, subnode, "image-id", image->image_id);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = fdt_setprop(fdt, subnode, "uuid", &image->uuid,
+			  sizeof(image->uuid));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = fdt_setprop_u64(fdt, subnode, "load-address", image->base);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = fdt_setprop_u32(fdt, subnode, "max-size", image->max_size);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (image->digest_info_len != 0U) {
+		ret = fdt_setprop(fdt, subnode, "digest-info",
+				  image->digest_info, image->digest_info_len);
+	}
+
+	return ret;
+}
+
+/*
+ * List the deferred images in HW_CONFIG, once its own hash is checked: BL2
+ * must not modify it before all image checks are completed.
+ */
+int stm32mp_deferred_images_handoff(void)
+{
+	bl_mem_params_node_t *hw_config = get_bl_mem_params_node(HW_CONFIG_ID);
+	image_info_t *image_info;
+	void *fdt;
+	unsigned int i;
+	int node;
+	int ret;
+
+	if (deferred_images_nb == 0U) {
+		return 0;
+	}
+
+	assert(hw_config != NULL);
+	image_info = &hw_config->image_info;
+
+	if ((image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING) != 0U) {
+		WARN("BL2: No HW_CONFIG to list deferred images\n");
+		return 0;
+	}
+
+	fdt = (void *)image_info->image_base;
+
+	ret = fdt_open_into(fdt, fdt, image_info->image_max_size);
+	if (ret < 0) {
+		return ret;
+	}
+
+	node = fdt_path_offset(fdt, "/firmware");
+	if (node == -FDT_ERR_NOTFOUND) {
+		node = fdt_add_subnode(fdt, 0, "firmware");
+	}
+
+	if (node < 0) {
+		return node;
+	}
+
+	node = fdt_add_subnode(fdt, node, "deferred-images");
+	if (node < 0) {
+		return node;
+	}
+
+	ret = fdt_setprop_string(fdt, node, "compatible",
+				 "st,stm32mp-deferred-images");
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < deferred_images_nb; i++) {
+		ret = deferred_image_dt_add(fdt, node, &deferred_images[i]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	ret = fdt_pack(fdt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	image_info->image_size = fdt_totalsize(fdt);
+	flush_dcache_range(image_info->image_base, image_info->image_size);
+
+	return 0;
+}
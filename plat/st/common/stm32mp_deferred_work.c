@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <drivers/arm/gicv2.h>
+#include <plat/common/platform.h>
+
+#include <stm32mp_deferred_work.h>
+
+#define DEFERRED_WORK_NB	8U
+
+struct deferred_work {
+	void (*fn)(uintptr_t arg);
+	uintptr_t arg;
+};
+
+/* Per-CPU queue, only accessed by its CPU with FIQ masked */
+static struct {
+	struct deferred_work work[DEFERRED_WORK_NB];
+	unsigned int count;
+} queue[PLATFORM_CORE_COUNT];
+
+/*
+ * Queue fn(arg) on the current CPU. When the queue is full, the work is done
+ * at once, as it was before being deferred.
+ */
+void stm32mp_defer_work(void (*fn)(uintptr_t arg), uintptr_t arg)
+{
+	unsigned int cpu = plat_my_core_pos();
+
+	if (queue[cpu].count == DEFERRED_WORK_NB) {
+		fn(arg);
+		return;
+	}
+
+	queue[cpu].work[queue[cpu].count].fn = fn;
+	queue[cpu].work[queue[cpu].count].arg = arg;
+
+	if (queue[cpu].count++ == 0U) {
+		gicv2_raise_sgi(STM32MP_IRQ_SEC_DEFERRED_WORK, (int)cpu);
+	}
+}
+
+/* Run the work queued on the current CPU, in order */
+void stm32mp_deferred_work_flush(void)
+{
+	unsigned int cpu = plat_my_core_pos();
+	unsigned int i;
+
+	for (i = 0U; i < queue[cpu].count; i++) {
+		queue[cpu].work[i].fn(queue[cpu].work[i].arg);
+	}
+
+	queue[cpu].count = 0U;
+}
+
+void stm32mp_deferred_work_it_handler(void)
+{
+	stm32mp_deferred_work_flush();
+}
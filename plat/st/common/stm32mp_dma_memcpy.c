@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/io/io_memmap.h>
+#include <drivers/st/stm32_mdma.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_dma_memcpy.h>
+
+/* Smaller copies, e.g. of FIP headers and certificates, stay on the CPU */
+#define DMA_MEMCPY_MIN_SIZE		U(0x1000)
+
+/* Linked-list items, a list copies up to 1MB */
+#define DMA_MEMCPY_LIST_SIZE		STM32MP_DMA_MEMCPY_ASYNC_MAX
+#define DMA_MEMCPY_DESC_NB		(DMA_MEMCPY_LIST_SIZE / STM32_MDMA_MAX_LEN)
+
+#define DMA_MEMCPY_TIMEOUT_US		U(1000000)
+
+static struct stm32_mdma_desc dma_memcpy_desc[DMA_MEMCPY_DESC_NB];
+
+/* Copy left running by the last call, size is 0 if none */
+static struct {
+	uintptr_t dst;
+	uintptr_t src;
+	size_t size;
+} dma_memcpy_pending;
+
+static int dma_memcpy_channel = -1;
+static bool dma_memcpy_async;
+
+/* Start the copy of up to DMA_MEMCPY_LIST_SIZE bytes, return the size */
+static size_t dma_memcpy_start(uintptr_t dst, uintptr_t src, size_t size,
+			       unsigned int width)
+{
+	struct stm32_mdma_cfg cfg = {
+		.width = width,
+		.src_inc = true,
+		.dst_inc = true,
+		.request = STM32_MDMA_SW_REQUEST,
+	};
+	size_t done = 0U;
+	unsigned int i;
+
+	for (i = 0U; (i < DMA_MEMCPY_DESC_NB) && (done < size); i++) {
+		cfg.src = src + done;
+		cfg.dst = dst + done;
+		cfg.len = MIN(size - done, (size_t)STM32_MDMA_MAX_LEN);
+
+		if (stm32_mdma_desc_fill(&dma_memcpy_desc[i], &cfg) != 0) {
+			return 0U;
+		}
+
+		if (i != 0U) {
+			stm32_mdma_desc_link(&dma_memcpy_desc[i - 1U],
+					     &dma_memcpy_desc[i]);
+		}
+
+		done += cfg.len;
+	}
+
+	if (stm32_mdma_start((unsigned int)dma_memcpy_channel,
+			     dma_memcpy_desc) != 0) {
+		return 0U;
+	}
+
+	return done;
+}
+
+/*
+ * Copy with the MDMA. Only the last list of a copy is left running when
+ * asynchronous copies are allowed, other copies are awaited. A failed
+ * copy is done again by the CPU.
+ */
+void stm32mp_dma_memcpy(uintptr_t dst, uintptr_t src, size_t size)
+{
+	uintptr_t align = dst | src | size;
+	unsigned int width = 1U;
+	size_t done = 0U;
+
+	if ((size < DMA_MEMCPY_MIN_SIZE) || (dma_memcpy_channel < 0)) {
+		(void)memcpy((void *)dst, (void *)src, size);
+		return;
+	}
+
+	/* One copy at a time on the channel */
+	stm32mp_dma_memcpy_wait();
+
+	if ((align % 8U) == 0U) {
+		width = 8U;
+	} else if ((align % 4U) == 0U) {
+		width = 4U;
+	}
+
+	stm32_mdma_prepare_src(src, size);
+	stm32_mdma_prepare_dst(dst, size);
+
+	dma_memcpy_pending.dst = dst;
+	dma_memcpy_pending.src = src;
+	dma_memcpy_pending.size = size;
+
+	while (done < size) {
+		size_t len = dma_memcpy_start(dst + done, src + done,
+					      size - done, width);
+
+		if (len == 0U) {
+			break;
+		}
+
+		done += len;
+		if ((done == size) && dma_memcpy_async) {
+			return;
+		}
+
+		if (stm32_mdma_wait((unsigned int)dma_memcpy_channel,
+				    DMA_MEMCPY_TIMEOUT_US) != 0) {
+			done -= len;
+			break;
+		}
+	}
+
+	stm32_mdma_complete_dst(dst, size);
+	dma_memcpy_pending.size = 0U;
+
+	if (done != size) {
+		WARN("DMA copy failed, done by CPU\n");
+		(void)memcpy((void *)(dst + done), (void *)(src + done),
+			     size - done);
+	}
+}
+
+/* Allow the copies to complete after the call, until the next wait */
+void stm32mp_dma_memcpy_set_async(bool async)
+{
+	dma_memcpy_async = async;
+}
+
+/* Complete the copy left running, with the status of its channel */
+static void dma_memcpy_complete(int ret)
+{
+	size_t size = dma_memcpy_pending.size;
+	size_t last;
+
+	stm32_mdma_complete_dst(dma_memcpy_pending.dst, size);
+	dma_memcpy_pending.size = 0U;
+
+	if (ret != 0) {
+		/* The last list is copied again, the previous ones are done */
+		last = size % DMA_MEMCPY_LIST_SIZE;
+		if (last == 0U) {
+			last = DMA_MEMCPY_LIST_SIZE;
+		}
+
+		WARN("DMA copy failed, done by CPU\n");
+		(void)memcpy((void *)(dma_memcpy_pending.dst + size - last),
+			     (void *)(dma_memcpy_pending.src + size - last),
+			     last);
+	}
+}
+
+/* Complete the copy left running, if any */
+void stm32mp_dma_memcpy_wait(void)
+{
+	if (dma_memcpy_pending.size == 0U) {
+		return;
+	}
+
+	dma_memcpy_complete(stm32_mdma_wait((unsigned int)dma_memcpy_channel,
+					    DMA_MEMCPY_TIMEOUT_US));
+}
+
+/* Return true while the copy left running is not completed */
+bool stm32mp_dma_memcpy_poll(void)
+{
+	int ret;
+
+	if (dma_memcpy_pending.size == 0U) {
+		return false;
+	}
+
+	ret = stm32_mdma_poll((unsigned int)dma_memcpy_channel);
+	if (ret == -EBUSY) {
+		return true;
+	}
+
+	dma_memcpy_complete(ret);
+
+	return false;
+}
+
+/* Copy the images read with io_memmap with the MDMA */
+void stm32mp_dma_memcpy_init(void)
+{
+	if (stm32_mdma_init() != 0) {
+		return;
+	}
+
+	dma_memcpy_channel = stm32_mdma_get_channel();
+	if (dma_memcpy_channel < 0) {
+		return;
+	}
+
+	io_memmap_set_copy(stm32mp_dma_memcpy);
+}
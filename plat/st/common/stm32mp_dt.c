@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include <libfdt.h>
 
@@ -16,11 +17,123 @@
 #include <common/fdt_wrappers.h>
 #include <drivers/regulator.h>
 #include <drivers/st/stm32_gpio.h>
+#include <lib/fconf/fconf.h>
+#include <lib/utils.h>
 
 #include <stm32mp_dt.h>
 
 static void *fdt;
 
+#if STM32MP_DT_INDEX
+#define DT_INDEX_COMPAT_MAX	U(256)
+#define DT_INDEX_PHANDLE_MAX	U(128)
+
+#define FNV1A_OFFSET_BASIS	U(0x811C9DC5)
+#define FNV1A_PRIME		U(0x01000193)
+
+struct dt_index_entry {
+	uint32_t key;
+	int32_t node;
+};
+
+/*
+ * Node offsets of the DT, in the tree order, for each compatible string
+ * (keyed by its hash) and for each phandle. The index is only used when it
+ * covers the whole DT, lookups fall back to libfdt otherwise.
+ */
+static struct {
+	struct dt_index_entry compat[DT_INDEX_COMPAT_MAX];
+	struct dt_index_entry phandle[DT_INDEX_PHANDLE_MAX];
+	unsigned int compat_nb;
+	unsigned int phandle_nb;
+	bool valid;
+} dt_index;
+
+static uint32_t dt_index_hash(const char *str, size_t len)
+{
+	uint32_t hash = FNV1A_OFFSET_BASIS;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash = (hash ^ (uint8_t)str[i]) * FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+static int dt_index_add_compat(int node)
+{
+	const char *compat;
+	int len;
+
+	compat = fdt_getprop(fdt, node, "compatible", &len);
+	while ((compat != NULL) && (len > 0)) {
+		size_t str_len = strnlen(compat, (size_t)len);
+
+		if (dt_index.compat_nb == DT_INDEX_COMPAT_MAX) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		dt_index.compat[dt_index.compat_nb].key =
+			dt_index_hash(compat, str_len);
+		dt_index.compat[dt_index.compat_nb].node = node;
+		dt_index.compat_nb++;
+
+		compat += str_len + 1U;
+		len -= (int)str_len + 1;
+	}
+
+	return 0;
+}
+
+static int dt_index_add_phandle(int node)
+{
+	uint32_t phandle = fdt_get_phandle(fdt, node);
+
+	if (phandle == 0U) {
+		return 0;
+	}
+
+	if (dt_index.phandle_nb == DT_INDEX_PHANDLE_MAX) {
+		return -FDT_ERR_NOSPACE;
+	}
+
+	dt_index.phandle[dt_index.phandle_nb].key = phandle;
+	dt_index.phandle[dt_index.phandle_nb].node = node;
+	dt_index.phandle_nb++;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function indexes the nodes of the DT, in a single pass over the tree.
+ ******************************************************************************/
+static void dt_index_build(void)
+{
+	int node;
+
+	zeromem(&dt_index, sizeof(dt_index));
+
+	for (node = fdt_next_node(fdt, -1, NULL); node >= 0;
+	     node = fdt_next_node(fdt, node, NULL)) {
+		if ((dt_index_add_compat(node) != 0) ||
+		    (dt_index_add_phandle(node) != 0)) {
+			WARN("DT index too small, not used\n");
+			return;
+		}
+	}
+
+	if (node != -FDT_ERR_NOTFOUND) {
+		return;
+	}
+
+	dt_index.valid = true;
+
+	VERBOSE("DT index: %u compatible, %u phandle\n",
+		dt_index.compat_nb, dt_index.phandle_nb);
+}
+#endif /* STM32MP_DT_INDEX */
+
 /*******************************************************************************
  * This function checks device tree file with its header.
  * Returns 0 on success and a negative FDT error code on failure.
@@ -32,6 +145,9 @@ int dt_open_and_check(uintptr_t dt_addr)
 	ret = fdt_check_header((void *)dt_addr);
 	if (ret == 0) {
 		fdt = (void *)dt_addr;
+#if STM32MP_DT_INDEX
+		dt_index_build();
+#endif
 	}
 
 	return ret;
@@ -53,6 +169,79 @@ int fdt_get_address(void **fdt_addr)
 	return 1;
 }
 
+/*******************************************************************************
+ * This function returns the offset of the first node after offset (or the
+ * first node if offset is -1) compatible with compat, using the DT index.
+ * Returns node offset on success and a negative FDT error code on failure.
+ ******************************************************************************/
+int dt_node_offset_by_compatible(int offset, const char *compat)
+{
+#if STM32MP_DT_INDEX
+	if (dt_index.valid) {
+		uint32_t hash = dt_index_hash(compat, strlen(compat));
+		unsigned int i;
+
+		for (i = 0U; i < dt_index.compat_nb; i++) {
+			const struct dt_index_entry *entry = &dt_index.compat[i];
+
+			if ((entry->node > offset) && (entry->key == hash) &&
+			    (fdt_node_check_compatible(fdt, entry->node,
+						       compat) == 0)) {
+				return entry->node;
+			}
+		}
+
+		return -FDT_ERR_NOTFOUND;
+	}
+#endif
+
+	return fdt_node_offset_by_compatible(fdt, offset, compat);
+}
+
+#if STM32MP_DT_INDEX
+/*******************************************************************************
+ * This function locates the nodes of the fconf populators in the DT index,
+ * when the config is the indexed DT, as for the TB_FW config of BL2.
+ * Returns -ENOTSUP for other configs, fconf then walks them.
+ ******************************************************************************/
+int plat_fconf_node_offset_by_compatible(uintptr_t config, const char *compat)
+{
+	if (!dt_index.valid || (config != (uintptr_t)fdt)) {
+		return -ENOTSUP;
+	}
+
+	return dt_node_offset_by_compatible(-1, compat);
+}
+#endif
+
+/*******************************************************************************
+ * This function returns the offset of the node with the given phandle, using
+ * the DT index.
+ * Returns node offset on success and a negative FDT error code on failure.
+ ******************************************************************************/
+int dt_node_offset_by_phandle(uint32_t phandle)
+{
+#if STM32MP_DT_INDEX
+	if (dt_index.valid) {
+		unsigned int i;
+
+		if ((phandle == 0U) || (phandle == UINT32_MAX)) {
+			return -FDT_ERR_BADPHANDLE;
+		}
+
+		for (i = 0U; i < dt_index.phandle_nb; i++) {
+			if (dt_index.phandle[i].key == phandle) {
+				return dt_index.phandle[i].node;
+			}
+		}
+
+		return -FDT_ERR_NOTFOUND;
+	}
+#endif
+
+	return fdt_node_offset_by_phandle(fdt, phandle);
+}
+
 /*******************************************************************************
  * This function check the presence of a node (generic use of fdt library).
  * Returns true if present, else return false.
@@ -199,7 +388,7 @@ int dt_get_node(struct dt_node_info *info, int offset, const char *compat)
 {
 	int node;
 
-	node = fdt_node_offset_by_compatible(fdt, offset, compat);
+	node = dt_node_offset_by_compatible(offset, compat);
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -236,7 +425,8 @@ int dt_match_instance_by_compatible(const char *compatible, uintptr_t address)
 {
 	int node;
 
-	fdt_for_each_compatible_node(fdt, node, compatible) {
+	for (node = dt_node_offset_by_compatible(-1, compatible); node >= 0;
+	     node = dt_node_offset_by_compatible(node, compatible)) {
 		const fdt32_t *cuint;
 
 		assert(fdt_get_node_parent_address_cells(node) == 1);
@@ -267,7 +457,7 @@ uint32_t dt_get_ddr_size(void)
 		return size;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	node = dt_node_offset_by_compatible(-1, DT_DDR_COMPAT);
 	if (node < 0) {
 		INFO("%s: Cannot read DDR node in DT\n", __func__);
 		return 0;
@@ -286,7 +476,7 @@ uint32_t dt_get_ddr_size(void)
  ******************************************************************************/
 static int dt_get_opp_table_node(void)
 {
-	return fdt_node_offset_by_compatible(fdt, -1, DT_OPP_COMPAT);
+	return dt_node_offset_by_compatible(-1, DT_OPP_COMPAT);
 }
 
 /*******************************************************************************
@@ -469,7 +659,7 @@ uint32_t dt_get_pwr_vdd_voltage(void)
  ******************************************************************************/
 struct rdev *dt_get_vdd_regulator(void)
 {
-	int node = fdt_node_offset_by_compatible(fdt, -1, DT_PWR_COMPAT);
+	int node = dt_node_offset_by_compatible(-1, DT_PWR_COMPAT);
 
 	if (node < 0) {
 		return NULL;
@@ -500,7 +690,7 @@ struct rdev *dt_get_cpu_regulator(void)
  ******************************************************************************/
 struct rdev *dt_get_usb_phy_regulator(void)
 {
-	int node = fdt_node_offset_by_compatible(fdt, -1, DT_USBPHYC_COMPAT);
+	int node = dt_node_offset_by_compatible(-1, DT_USBPHYC_COMPAT);
 	int subnode;
 
 	if (node < 0) {
@@ -551,7 +741,7 @@ int dt_find_otp_name(const char *name, uint32_t *otp, uint32_t *otp_len)
 		return -FDT_ERR_BADVALUE;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_BSEC_COMPAT);
+	node = dt_node_offset_by_compatible(-1, DT_BSEC_COMPAT);
 	if (node < 0) {
 		return node;
 	}
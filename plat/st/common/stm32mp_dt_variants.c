@@ -0,0 +1,575 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <common/tbbr/tbbr_img_def.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_common.h>
+#include <stm32mp_dt_variants.h>
+
+#define DT_VARIANTS_COMPAT	"st,stm32mp-dt-variants"
+
+#define DT_OVL_DEPTH_MAX	16
+#define DT_OVL_FRAGMENTS_MAX	32U
+
+#define FNV1A_OFFSET_BASIS	U(0x811C9DC5)
+#define FNV1A_PRIME		U(0x01000193)
+
+struct dt_ovl_node {
+	uint32_t path_hash;
+	uint32_t phandle;
+	int32_t node;
+};
+
+#define DT_OVL_INDEX_MAX	(STM32MP_DT_OVERLAY_BUF_SIZE / \
+				 sizeof(struct dt_ovl_node))
+
+/*
+ * Index of the base DT, built in a single pass: the node offsets, in the
+ * tree order, with the hash of their path and their phandle, in a DDR
+ * buffer. It replaces the
+ * tree walks libfdt does for each phandle and path lookup of an overlay.
+ */
+static struct {
+	struct dt_ovl_node *nodes;
+	unsigned int nb;
+	int symbols;
+} ovl_index;
+
+struct dt_ovl_fragment {
+	int target;
+	int overlay;
+};
+
+/* Overlays of the selected variant, in FW_CONFIG */
+static void *variant_hw_config;
+static void *variant_tos_fw_config;
+
+static uint32_t dt_ovl_hash(uint32_t hash, const char *str, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash = (hash ^ (uint8_t)str[i]) * FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+static int dt_ovl_index_build(const void *fdt)
+{
+	uint32_t hash[DT_OVL_DEPTH_MAX + 1];
+	int depth = -1;
+	int node;
+
+	ovl_index.nodes = (struct dt_ovl_node *)STM32MP_DT_OVERLAY_BUF_BASE;
+	ovl_index.nb = 0U;
+	ovl_index.symbols = -FDT_ERR_NOTFOUND;
+
+	hash[0] = FNV1A_OFFSET_BASIS;
+
+	for (node = fdt_next_node(fdt, -1, &depth); node >= 0;
+	     node = fdt_next_node(fdt, node, &depth)) {
+		struct dt_ovl_node *entry = &ovl_index.nodes[ovl_index.nb];
+
+		if ((depth > DT_OVL_DEPTH_MAX) ||
+		    (ovl_index.nb == DT_OVL_INDEX_MAX)) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		if (depth > 0) {
+			const char *name;
+			int len;
+
+			name = fdt_get_name(fdt, node, &len);
+			if (name == NULL) {
+				return len;
+			}
+
+			hash[depth] = dt_ovl_hash(dt_ovl_hash(hash[depth - 1],
+							      "/", 1U),
+						  name, (size_t)len);
+
+			if ((depth == 1) && (strcmp(name, "__symbols__") == 0)) {
+				ovl_index.symbols = node;
+			}
+		}
+
+		entry->path_hash = hash[depth];
+		entry->phandle = fdt_get_phandle(fdt, node);
+		entry->node = node;
+
+		ovl_index.nb++;
+	}
+
+	if (node != -FDT_ERR_NOTFOUND) {
+		return node;
+	}
+
+	return 0;
+}
+
+static int dt_ovl_node_by_phandle(uint32_t phandle)
+{
+	unsigned int i;
+
+	if ((phandle == 0U) || (phandle == UINT32_MAX)) {
+		return -FDT_ERR_BADPHANDLE;
+	}
+
+	for (i = 0U; i < ovl_index.nb; i++) {
+		if (ovl_index.nodes[i].phandle == phandle) {
+			return ovl_index.nodes[i].node;
+		}
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+/* Look a full path up in the index, aliases through libfdt */
+static int dt_ovl_node_by_path(const void *fdt, const char *path, size_t len)
+{
+	const char *last = memrchr(path, '/', len);
+	uint32_t hash;
+	unsigned int i;
+
+	if (last == NULL) {
+		return fdt_path_offset_namelen(fdt, path, (int)len);
+	}
+
+	if (len == 1U) {
+		return 0;
+	}
+
+	hash = dt_ovl_hash(FNV1A_OFFSET_BASIS, path, len);
+	last++;
+
+	for (i = 0U; i < ovl_index.nb; i++) {
+		const char *name;
+		int name_len;
+
+		if (ovl_index.nodes[i].path_hash != hash) {
+			continue;
+		}
+
+		name = fdt_get_name(fdt, ovl_index.nodes[i].node, &name_len);
+		if ((name != NULL) &&
+		    ((size_t)name_len == (size_t)(path + len - last)) &&
+		    (memcmp(name, last, (size_t)name_len) == 0)) {
+			return ovl_index.nodes[i].node;
+		}
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+/*
+ * The fast path does not renumber the phandles of the overlay: it only
+ * supports overlays that do not define any, nor reference them.
+ */
+static bool dt_ovl_is_supported(const void *fdto)
+{
+	int node;
+
+	if (fdt_subnode_offset(fdto, 0, "__local_fixups__") >= 0) {
+		return false;
+	}
+
+	for (node = fdt_next_node(fdto, -1, NULL); node >= 0;
+	     node = fdt_next_node(fdto, node, NULL)) {
+		if (fdt_get_phandle(fdto, node) != 0U) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Set the phandle of a base DT label in the overlay properties using it */
+static int dt_ovl_fixup(const void *fdt, void *fdto, int property)
+{
+	const char *value;
+	const char *label;
+	const char *symbol_path;
+	fdt32_t phandle;
+	int path_len;
+	int node;
+	int len;
+
+	value = fdt_getprop_by_offset(fdto, property, &label, &len);
+	if (value == NULL) {
+		return len;
+	}
+
+	if (ovl_index.symbols < 0) {
+		return ovl_index.symbols;
+	}
+
+	symbol_path = fdt_getprop(fdt, ovl_index.symbols, label, &path_len);
+	if (symbol_path == NULL) {
+		return path_len;
+	}
+
+	node = dt_ovl_node_by_path(fdt, symbol_path,
+				   strnlen(symbol_path, (size_t)path_len));
+	if (node < 0) {
+		return node;
+	}
+
+	phandle = cpu_to_fdt32(fdt_get_phandle(fdt, node));
+	if (phandle == 0U) {
+		return -FDT_ERR_NOTFOUND;
+	}
+
+	/* Each fixup is "path:property:offset" */
+	while (len > 0) {
+		const char *fixup_end = memchr(value, '\0', (size_t)len);
+		const char *name;
+		const char *sep;
+		char *endptr;
+		unsigned long poffset;
+		int fixup_node;
+		int ret;
+
+		if (fixup_end == NULL) {
+			return -FDT_ERR_BADOVERLAY;
+		}
+
+		sep = memchr(value, ':', (size_t)(fixup_end - value));
+		if (sep == NULL) {
+			return -FDT_ERR_BADOVERLAY;
+		}
+
+		name = sep + 1;
+		sep = memchr(name, ':', (size_t)(fixup_end - name));
+		if ((sep == NULL) || (sep == name)) {
+			return -FDT_ERR_BADOVERLAY;
+		}
+
+		poffset = strtoul(sep + 1, &endptr, 10);
+		if ((endptr != fixup_end) || (endptr == (sep + 1))) {
+			return -FDT_ERR_BADOVERLAY;
+		}
+
+		fixup_node = fdt_path_offset_namelen(fdto, value,
+						     (int)(name - 1 - value));
+		if (fixup_node < 0) {
+			return -FDT_ERR_BADOVERLAY;
+		}
+
+		ret = fdt_setprop_inplace_namelen_partial(fdto, fixup_node,
+							  name,
+							  (int)(sep - name),
+							  (uint32_t)poffset,
+							  &phandle,
+							  sizeof(phandle));
+		if (ret != 0) {
+			return ret;
+		}
+
+		len -= (int)(fixup_end - value) + 1;
+		value = fixup_end + 1;
+	}
+
+	return 0;
+}
+
+static int dt_ovl_fixups(const void *fdt, void *fdto)
+{
+	int fixups;
+	int property;
+
+	fixups = fdt_subnode_offset(fdto, 0, "__fixups__");
+	if (fixups == -FDT_ERR_NOTFOUND) {
+		return 0;
+	}
+
+	if (fixups < 0) {
+		return fixups;
+	}
+
+	fdt_for_each_property_offset(property, fdto, fixups) {
+		int ret = dt_ovl_fixup(fdt, fdto, property);
+
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int dt_ovl_target(const void *fdt, const void *fdto, int fragment)
+{
+	const fdt32_t *cuint;
+	const char *path;
+	int len;
+
+	cuint = fdt_getprop(fdto, fragment, "target", &len);
+	if (cuint != NULL) {
+		if (len != (int)sizeof(*cuint)) {
+			return -FDT_ERR_BADPHANDLE;
+		}
+
+		return dt_ovl_node_by_phandle(fdt32_to_cpu(*cuint));
+	}
+
+	path = fdt_getprop(fdto, fragment, "target-path", &len);
+	if (path == NULL) {
+		return -FDT_ERR_BADOVERLAY;
+	}
+
+	return dt_ovl_node_by_path(fdt, path, strnlen(path, (size_t)len));
+}
+
+/* Same merge as libfdt */
+static int dt_ovl_merge_node(void *fdt, int target, const void *fdto, int node)
+{
+	int property;
+	int subnode;
+
+	fdt_for_each_property_offset(property, fdto, node) {
+		const char *name;
+		const void *prop;
+		int len;
+		int ret;
+
+		prop = fdt_getprop_by_offset(fdto, property, &name, &len);
+		if (prop == NULL) {
+			return len;
+		}
+
+		ret = fdt_setprop(fdt, target, name, prop, len);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	fdt_for_each_subnode(subnode, fdto, node) {
+		const char *name = fdt_get_name(fdto, subnode, NULL);
+		int child;
+		int ret;
+
+		child = fdt_add_subnode(fdt, target, name);
+		if (child == -FDT_ERR_EXISTS) {
+			child = fdt_subnode_offset(fdt, target, name);
+		}
+
+		if (child < 0) {
+			return child;
+		}
+
+		ret = dt_ovl_merge_node(fdt, child, fdto, subnode);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Returns -ENOTSUP, with both DTs unchanged, if the overlay needs the libfdt
+ * path.
+ */
+static int dt_ovl_apply_fast(void *fdt, void *fdto)
+{
+	struct dt_ovl_fragment frag[DT_OVL_FRAGMENTS_MAX];
+	unsigned int nb = 0U;
+	unsigned int i;
+	int fragment;
+	int ret;
+
+	if (!dt_ovl_is_supported(fdto) || (dt_ovl_index_build(fdt) != 0)) {
+		return -ENOTSUP;
+	}
+
+	fdt_for_each_subnode(fragment, fdto, 0) {
+		int overlay = fdt_subnode_offset(fdto, fragment, "__overlay__");
+
+		if (overlay < 0) {
+			continue;
+		}
+
+		if (nb == DT_OVL_FRAGMENTS_MAX) {
+			return -ENOTSUP;
+		}
+
+		frag[nb].overlay = overlay;
+		nb++;
+	}
+
+	ret = dt_ovl_fixups(fdt, fdto);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/*
+	 * Merge the fragments from the last target in the base DT: a merge
+	 * only moves the nodes after its target, the offsets of the next
+	 * targets are kept.
+	 */
+	for (i = 0U; i < nb; i++) {
+		struct dt_ovl_fragment tmp;
+		unsigned int j;
+
+		tmp.overlay = frag[i].overlay;
+		tmp.target = dt_ovl_target(fdt, fdto,
+					   fdt_parent_offset(fdto,
+							     tmp.overlay));
+		if (tmp.target < 0) {
+			return tmp.target;
+		}
+
+		for (j = i; (j > 0U) && (frag[j - 1U].target < tmp.target);
+		     j--) {
+			frag[j] = frag[j - 1U];
+		}
+
+		frag[j] = tmp;
+	}
+
+	for (i = 0U; i < nb; i++) {
+		ret = dt_ovl_merge_node(fdt, frag[i].target, fdto,
+					frag[i].overlay);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Apply an overlay, the base DT having room for it. The overlay is damaged.
+ * The symbols of the overlay are not added to the base DT.
+ */
+int stm32mp_dt_overlay_apply(void *fdt, void *fdto)
+{
+	int ret;
+
+	ret = dt_ovl_apply_fast(fdt, fdto);
+	if (ret == -ENOTSUP) {
+		VERBOSE("DT overlay: libfdt path\n");
+		ret = fdt_overlay_apply(fdt, fdto);
+	}
+
+	return ret;
+}
+
+static void *dt_variant_overlay(void *fw_config, int node, const char *name)
+{
+	void *fdto;
+	int len;
+
+	fdto = fdt_getprop_w(fw_config, node, name, &len);
+	if (fdto == NULL) {
+		return NULL;
+	}
+
+	if ((fdt_check_header(fdto) != 0) ||
+	    (fdt_totalsize(fdto) > (uint32_t)len)) {
+		ERROR("DT variant: invalid %s overlay\n", name);
+		panic();
+	}
+
+	return fdto;
+}
+
+/* Select the overlays of the board, once FW_CONFIG is loaded */
+void stm32mp_dt_variant_select(void *fw_config)
+{
+	uint32_t board_id;
+	int variants;
+	int node;
+
+	variants = fdt_node_offset_by_compatible(fw_config, -1,
+						 DT_VARIANTS_COMPAT);
+	if (variants < 0) {
+		return;
+	}
+
+	if (stm32_get_otp_value(BOARD_ID_OTP, &board_id) != 0) {
+		WARN("DT variant: no board ID\n");
+		return;
+	}
+
+	fdt_for_each_subnode(node, fw_config, variants) {
+		const fdt32_t *cuint;
+		int len;
+
+		cuint = fdt_getprop(fw_config, node, "board-id", &len);
+		if ((cuint == NULL) || (len != (int)(2U * sizeof(uint32_t))) ||
+		    ((board_id & fdt32_to_cpu(cuint[1])) !=
+		     fdt32_to_cpu(cuint[0]))) {
+			continue;
+		}
+
+		INFO("DT variant: %s\n", fdt_get_name(fw_config, node, NULL));
+
+		variant_hw_config = dt_variant_overlay(fw_config, node,
+						       "hw-config");
+		variant_tos_fw_config = dt_variant_overlay(fw_config, node,
+							   "tos-fw-config");
+		return;
+	}
+
+	VERBOSE("DT variant: none for board ID 0x%x\n", board_id);
+}
+
+/* Apply the overlay of the selected variant to a loaded config DT */
+int stm32mp_dt_variant_apply(unsigned int image_id, image_info_t *image_info)
+{
+	void *fdt = (void *)image_info->image_base;
+	void *fdto;
+	int ret;
+
+	switch (image_id) {
+	case HW_CONFIG_ID:
+		fdto = variant_hw_config;
+		break;
+	case TOS_FW_CONFIG_ID:
+		fdto = variant_tos_fw_config;
+		break;
+	default:
+		return 0;
+	}
+
+	if (fdto == NULL) {
+		return 0;
+	}
+
+	ret = fdt_open_into(fdt, fdt, (int)image_info->image_max_size);
+	if (ret == 0) {
+		ret = stm32mp_dt_overlay_apply(fdt, fdto);
+	}
+
+	if (ret == 0) {
+		ret = fdt_pack(fdt);
+	}
+
+	if (ret != 0) {
+		ERROR("DT variant: overlay of image %u failed (%d)\n",
+		      image_id, ret);
+		return -EINVAL;
+	}
+
+	flush_dcache_range(image_info->image_base, fdt_totalsize(fdt));
+
+	return 0;
+}
@@ -19,6 +19,7 @@
 #include <stm32mp_efi.h>
 #include <stm32mp_fconf_getter.h>
 #include <stm32mp_io_storage.h>
+#include <stm32mp_striped_load.h>
 
 #if STM32MP_SDMMC || STM32MP_EMMC
 static io_block_spec_t gpt_block_spec = {
@@ -74,7 +75,11 @@ struct plat_io_policy policies[MAX_NUMBER_IDS] = {
 #endif /* PSA_FWU_SUPPORT */
 };
 
+#if STM32MP_DEFER_NT_FW_CONFIG
+#define DEFAULT_UUID_NUMBER	U(8)
+#else
 #define DEFAULT_UUID_NUMBER	U(7)
+#endif
 
 #if TRUSTED_BOARD_BOOT
 #define TBBR_UUID_NUMBER	U(6)
@@ -82,8 +87,17 @@ struct plat_io_policy policies[MAX_NUMBER_IDS] = {
 #define TBBR_UUID_NUMBER	U(0)
 #endif
 
+#if STM32MP_M4_EARLY_BOOT && TRUSTED_BOARD_BOOT
+#define M4_UUID_NUMBER		U(3)
+#elif STM32MP_M4_EARLY_BOOT
+#define M4_UUID_NUMBER		U(1)
+#else
+#define M4_UUID_NUMBER		U(0)
+#endif
+
 #define FCONF_ST_IO_UUID_NUMBER	(DEFAULT_UUID_NUMBER + \
-				 TBBR_UUID_NUMBER)
+				 TBBR_UUID_NUMBER + \
+				 M4_UUID_NUMBER)
 
 static io_uuid_spec_t fconf_stm32mp_uuids[FCONF_ST_IO_UUID_NUMBER];
 static OBJECT_POOL_ARRAY(fconf_stm32mp_uuids_pool, fconf_stm32mp_uuids);
@@ -102,6 +116,9 @@ static const struct policies_load_info load_info[FCONF_ST_IO_UUID_NUMBER] = {
 	{BL33_IMAGE_ID, "bl33_uuid"},
 	{HW_CONFIG_ID, "hw_cfg_uuid"},
 	{TOS_FW_CONFIG_ID, "tos_fw_cfg_uuid"},
+#if STM32MP_DEFER_NT_FW_CONFIG
+	{NT_FW_CONFIG_ID, "nt_fw_cfg_uuid"},
+#endif
 #if TRUSTED_BOARD_BOOT
 	{STM32MP_CONFIG_CERT_ID, "stm32mp_cfg_cert_uuid"},
 	{TRUSTED_KEY_CERT_ID, "t_key_cert_uuid"},
@@ -110,11 +127,17 @@ static const struct policies_load_info load_info[FCONF_ST_IO_UUID_NUMBER] = {
 	{TRUSTED_OS_FW_CONTENT_CERT_ID, "tos_fw_content_cert_uuid"},
 	{NON_TRUSTED_FW_CONTENT_CERT_ID, "nt_fw_content_cert_uuid"},
 #endif /* TRUSTED_BOARD_BOOT */
+#if STM32MP_M4_EARLY_BOOT
+	{SCP_BL2_IMAGE_ID, "scp_bl2_uuid"},
+#if TRUSTED_BOARD_BOOT
+	{SCP_FW_KEY_CERT_ID, "scp_fw_key_cert_uuid"},
+	{SCP_FW_CONTENT_CERT_ID, "scp_fw_content_cert_uuid"},
+#endif
+#endif /* STM32MP_M4_EARLY_BOOT */
 };
 
-int fconf_populate_stm32mp_io_policies(uintptr_t config)
+int fconf_populate_stm32mp_io_policies(uintptr_t config, int node)
 {
-	int node;
 	unsigned int i;
 
 	/* As libfdt uses void *, we can't avoid this cast */
@@ -123,7 +146,6 @@ int fconf_populate_stm32mp_io_policies(uintptr_t config)
 	/* Assert the node offset point to "st,io-fip-handle" compatible property */
 	const char *compatible_str = "st,io-fip-handle";
 
-	node = fdt_node_offset_by_compatible(dtb, -1, compatible_str);
 	if (node < 0) {
 		ERROR("FCONF: Can't find %s compatible in dtb\n", compatible_str);
 		return node;
@@ -175,7 +197,8 @@ int fconf_populate_stm32mp_io_policies(uintptr_t config)
 		}
 	}
 
-	return 0;
+	return stm32mp_striped_load_populate(dtb, node);
 }
 
-FCONF_REGISTER_POPULATOR(TB_FW, stm32mp_io, fconf_populate_stm32mp_io_policies);
+FCONF_REGISTER_NODE_POPULATOR(TB_FW, stm32mp_io, "st,io-fip-handle",
+			      fconf_populate_stm32mp_io_policies);
@@ -0,0 +1,685 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#include <common/debug.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_fdt_batch.h>
+
+#define FDT_BATCH_MAX_EDITS		16U
+#define FDT_BATCH_POOL_SIZE		512U
+#define FDT_BATCH_MAX_DEPTH		32
+
+#define HIGH_BITS(x) ((sizeof(x) > 4) ? ((x) >> 32) : (typeof(x))0)
+
+enum fdt_batch_op {
+	FDT_BATCH_SETPROP,
+	FDT_BATCH_DELPROP,
+	FDT_BATCH_DEL_NODE,
+	FDT_BATCH_ADD_NODE,
+};
+
+/*
+ * node is an offset in the recorded tree or a new node handle. name and val
+ * are copied in the pool, as callers often build them on their stack.
+ */
+struct fdt_batch_edit {
+	enum fdt_batch_op op;
+	int node;
+	const char *name;
+	const void *val;
+	int len;
+	bool done;
+};
+
+static struct {
+	const void *fdt;
+	unsigned int nb_edits;
+	size_t pool_used;
+	struct fdt_batch_edit edits[FDT_BATCH_MAX_EDITS];
+	uint8_t pool[FDT_BATCH_POOL_SIZE];
+} batch;
+
+static void *batch_alloc(const void *data, size_t size)
+{
+	void *p;
+
+	if (size > (FDT_BATCH_POOL_SIZE - batch.pool_used)) {
+		return NULL;
+	}
+
+	p = &batch.pool[batch.pool_used];
+	memcpy(p, data, size);
+	batch.pool_used += size;
+
+	return p;
+}
+
+static bool batch_node_is_new(int node)
+{
+	unsigned int idx;
+
+	if (node < FDT_BATCH_NEW_NODE) {
+		return false;
+	}
+
+	idx = (unsigned int)(node - FDT_BATCH_NEW_NODE);
+
+	return (idx < batch.nb_edits) &&
+	       (batch.edits[idx].op == FDT_BATCH_ADD_NODE);
+}
+
+static int batch_record(enum fdt_batch_op op, int node, const char *name,
+			const void *val, int len)
+{
+	struct fdt_batch_edit *edit;
+
+	if (batch.fdt == NULL) {
+		return -FDT_ERR_BADSTATE;
+	}
+
+	if ((node < 0) ||
+	    ((node >= FDT_BATCH_NEW_NODE) && !batch_node_is_new(node))) {
+		return -FDT_ERR_BADOFFSET;
+	}
+
+	if (batch.nb_edits == FDT_BATCH_MAX_EDITS) {
+		return -FDT_ERR_NOSPACE;
+	}
+
+	edit = &batch.edits[batch.nb_edits];
+	edit->name = NULL;
+	edit->val = NULL;
+
+	if (name != NULL) {
+		edit->name = batch_alloc(name, strlen(name) + 1U);
+		if (edit->name == NULL) {
+			return -FDT_ERR_NOSPACE;
+		}
+	}
+
+	if (len > 0) {
+		edit->val = batch_alloc(val, (size_t)len);
+		if (edit->val == NULL) {
+			return -FDT_ERR_NOSPACE;
+		}
+	}
+
+	edit->op = op;
+	edit->node = node;
+	edit->len = len;
+	edit->done = false;
+	batch.nb_edits++;
+
+	return 0;
+}
+
+/* Start recording edits of a tree, which is not modified until applied */
+void stm32mp_fdt_batch_init(const void *fdt)
+{
+	batch.fdt = fdt;
+	batch.nb_edits = 0U;
+	batch.pool_used = 0U;
+}
+
+int stm32mp_fdt_batch_setprop(int nodeoffset, const char *name,
+			      const void *val, int len)
+{
+	if (len < 0) {
+		return -FDT_ERR_BADVALUE;
+	}
+
+	return batch_record(FDT_BATCH_SETPROP, nodeoffset, name, val, len);
+}
+
+int stm32mp_fdt_batch_setprop_u32(int nodeoffset, const char *name,
+				  uint32_t val)
+{
+	fdt32_t tmp = cpu_to_fdt32(val);
+
+	return stm32mp_fdt_batch_setprop(nodeoffset, name, &tmp, sizeof(tmp));
+}
+
+int stm32mp_fdt_batch_setprop_string(int nodeoffset, const char *name,
+				     const char *str)
+{
+	return stm32mp_fdt_batch_setprop(nodeoffset, name, str,
+					 (int)strlen(str) + 1);
+}
+
+int stm32mp_fdt_batch_delprop(int nodeoffset, const char *name)
+{
+	return batch_record(FDT_BATCH_DELPROP, nodeoffset, name, NULL, 0);
+}
+
+/* Only nodes of the recorded tree can be deleted */
+int stm32mp_fdt_batch_del_node(int nodeoffset)
+{
+	if (nodeoffset >= FDT_BATCH_NEW_NODE) {
+		return -FDT_ERR_BADOFFSET;
+	}
+
+	return batch_record(FDT_BATCH_DEL_NODE, nodeoffset, NULL, NULL, 0);
+}
+
+/* Return the handle of the new node, or a negative error value */
+int stm32mp_fdt_batch_add_subnode(int parentoffset, const char *name)
+{
+	int handle = FDT_BATCH_NEW_NODE + (int)batch.nb_edits;
+	int ret;
+
+	if ((batch.fdt != NULL) && (parentoffset >= 0) &&
+	    (parentoffset < FDT_BATCH_NEW_NODE) &&
+	    (fdt_subnode_offset(batch.fdt, parentoffset, name) >= 0)) {
+		return -FDT_ERR_EXISTS;
+	}
+
+	ret = batch_record(FDT_BATCH_ADD_NODE, parentoffset, name, NULL, 0);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return handle;
+}
+
+/*
+ * Record a region in the /reserved-memory node, created if needed, the same
+ * way as fdt_add_reserved_memory() does.
+ */
+int stm32mp_fdt_batch_add_reserved_memory(const char *node_name,
+					  uintptr_t base, size_t size)
+{
+	uint32_t addresses[4];
+	unsigned int idx = 0U;
+	int offs;
+	int ac;
+	int sc;
+	int ret;
+
+	if (batch.fdt == NULL) {
+		return -FDT_ERR_BADSTATE;
+	}
+
+	ac = fdt_address_cells(batch.fdt, 0);
+	sc = fdt_size_cells(batch.fdt, 0);
+
+	offs = fdt_path_offset(batch.fdt, "/reserved-memory");
+	if (offs < 0) {
+		offs = stm32mp_fdt_batch_add_subnode(0, "reserved-memory");
+		if (offs < 0) {
+			return offs;
+		}
+
+		ret = stm32mp_fdt_batch_setprop_u32(offs, "#address-cells",
+						    (uint32_t)ac);
+		if (ret == 0) {
+			ret = stm32mp_fdt_batch_setprop_u32(offs,
+							    "#size-cells",
+							    (uint32_t)sc);
+		}
+		if (ret == 0) {
+			ret = stm32mp_fdt_batch_setprop(offs, "ranges",
+							NULL, 0);
+		}
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (ac > 1) {
+		addresses[idx] = cpu_to_fdt32(HIGH_BITS(base));
+		idx++;
+	}
+	addresses[idx] = cpu_to_fdt32(base & 0xffffffff);
+	idx++;
+	if (sc > 1) {
+		addresses[idx] = cpu_to_fdt32(HIGH_BITS(size));
+		idx++;
+	}
+	addresses[idx] = cpu_to_fdt32(size & 0xffffffff);
+	idx++;
+
+	offs = stm32mp_fdt_batch_add_subnode(offs, node_name);
+	if (offs < 0) {
+		return offs;
+	}
+
+	ret = stm32mp_fdt_batch_setprop(offs, "no-map", NULL, 0);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return stm32mp_fdt_batch_setprop(offs, "reg", addresses,
+					 (int)(idx * sizeof(uint32_t)));
+}
+
+/* Last property edit recorded for this node and name, it overrides others */
+static struct fdt_batch_edit *batch_find_prop(int node, const char *name)
+{
+	struct fdt_batch_edit *found = NULL;
+	unsigned int i;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		struct fdt_batch_edit *edit = &batch.edits[i];
+
+		if (((edit->op == FDT_BATCH_SETPROP) ||
+		     (edit->op == FDT_BATCH_DELPROP)) &&
+		    (edit->node == node) && (strcmp(edit->name, name) == 0)) {
+			edit->done = true;
+			found = edit;
+		}
+	}
+
+	return found;
+}
+
+static bool batch_node_deleted(int node)
+{
+	unsigned int i;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		if ((batch.edits[i].op == FDT_BATCH_DEL_NODE) &&
+		    (batch.edits[i].node == node)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Write the properties added to a node, once its own ones are copied */
+static int batch_emit_props(void *dst, int node)
+{
+	unsigned int i;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		struct fdt_batch_edit *edit = &batch.edits[i];
+		int ret;
+
+		if ((edit->op != FDT_BATCH_SETPROP) || (edit->node != node) ||
+		    edit->done) {
+			continue;
+		}
+
+		edit = batch_find_prop(node, edit->name);
+		if (edit->op != FDT_BATCH_SETPROP) {
+			continue;
+		}
+
+		ret = fdt_property(dst, edit->name, edit->val, edit->len);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Write the nodes added under a node, before its end tag */
+static int batch_emit_new_nodes(void *dst, int parent)
+{
+	unsigned int i;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		const struct fdt_batch_edit *edit = &batch.edits[i];
+		int handle = FDT_BATCH_NEW_NODE + (int)i;
+		int ret;
+
+		if ((edit->op != FDT_BATCH_ADD_NODE) || (edit->node != parent)) {
+			continue;
+		}
+
+		ret = fdt_begin_node(dst, edit->name);
+		if (ret == 0) {
+			ret = batch_emit_props(dst, handle);
+		}
+		if (ret == 0) {
+			ret = batch_emit_new_nodes(dst, handle);
+		}
+		if (ret == 0) {
+			ret = fdt_end_node(dst);
+		}
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int batch_copy_prop(const void *fdt, void *dst, int node, int offset)
+{
+	const struct fdt_property *prop;
+	const struct fdt_batch_edit *edit;
+	const char *name;
+	int len;
+
+	prop = fdt_get_property_by_offset(fdt, offset, &len);
+	if (prop == NULL) {
+		return len;
+	}
+
+	name = fdt_string(fdt, (int)fdt32_to_cpu(prop->nameoff));
+	if (name == NULL) {
+		return -FDT_ERR_BADSTRUCTURE;
+	}
+
+	edit = batch_find_prop(node, name);
+	if (edit == NULL) {
+		return fdt_property(dst, name, prop->data, len);
+	}
+
+	if (edit->op == FDT_BATCH_DELPROP) {
+		return 0;
+	}
+
+	return fdt_property(dst, name, edit->val, edit->len);
+}
+
+/* Return the offset following the end of the node */
+static int batch_skip_node(const void *fdt, int offset)
+{
+	int depth = 0;
+	int next;
+
+	do {
+		switch (fdt_next_tag(fdt, offset, &next)) {
+		case FDT_BEGIN_NODE:
+			depth++;
+			break;
+		case FDT_END_NODE:
+			depth--;
+			break;
+		case FDT_END:
+			return (next < 0) ? next : -FDT_ERR_BADSTRUCTURE;
+		default:
+			break;
+		}
+
+		offset = next;
+	} while (depth > 0);
+
+	return offset;
+}
+
+/*
+ * Write the edited tree in dst with the sequential write functions, in a
+ * single walk of the recorded tree. Properties must precede subnodes, so
+ * the added ones are written when the first subnode or the end of the node
+ * is met.
+ */
+static int batch_rebuild(const void *fdt, void *dst, int dstsize)
+{
+	int stack[FDT_BATCH_MAX_DEPTH];
+	int depth = 0;
+	bool props_open = false;
+	int offset = 0;
+	int next = 0;
+	uint32_t tag;
+	int ret;
+	int i;
+
+	ret = fdt_create(dst, dstsize);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0; i < fdt_num_mem_rsv(fdt); i++) {
+		uint64_t address;
+		uint64_t size;
+
+		ret = fdt_get_mem_rsv(fdt, i, &address, &size);
+		if (ret == 0) {
+			ret = fdt_add_reservemap_entry(dst, address, size);
+		}
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	ret = fdt_finish_reservemap(dst);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		tag = fdt_next_tag(fdt, offset, &next);
+
+		if (props_open &&
+		    ((tag == FDT_BEGIN_NODE) || (tag == FDT_END_NODE))) {
+			ret = batch_emit_props(dst, stack[depth - 1]);
+			if (ret != 0) {
+				return ret;
+			}
+			props_open = false;
+		}
+
+		switch (tag) {
+		case FDT_BEGIN_NODE:
+			if (batch_node_deleted(offset)) {
+				next = batch_skip_node(fdt, offset);
+				break;
+			}
+
+			if (depth == FDT_BATCH_MAX_DEPTH) {
+				return -FDT_ERR_NOSPACE;
+			}
+
+			ret = fdt_begin_node(dst, fdt_get_name(fdt, offset, NULL));
+			stack[depth] = offset;
+			depth++;
+			props_open = true;
+			break;
+		case FDT_PROP:
+			if (depth == 0) {
+				return -FDT_ERR_BADSTRUCTURE;
+			}
+
+			ret = batch_copy_prop(fdt, dst, stack[depth - 1], offset);
+			break;
+		case FDT_END_NODE:
+			if (depth == 0) {
+				return -FDT_ERR_BADSTRUCTURE;
+			}
+
+			depth--;
+			ret = batch_emit_new_nodes(dst, stack[depth]);
+			if (ret == 0) {
+				ret = fdt_end_node(dst);
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (ret != 0) {
+			return ret;
+		}
+		if (next < 0) {
+			return next;
+		}
+
+		offset = next;
+	} while (tag != FDT_END);
+
+	ret = fdt_finish(dst);
+	if (ret != 0) {
+		return ret;
+	}
+
+	fdt_set_boot_cpuid_phys(dst, fdt_boot_cpuid_phys(fdt));
+
+	return 0;
+}
+
+/*
+ * Apply the edits of a node with the read-write functions: properties first,
+ * as they move the subnodes, then each added subnode with its own content,
+ * and the node deletion last.
+ */
+static int batch_replay_node(void *fdt, int node, int offset)
+{
+	bool del_node = false;
+	unsigned int i;
+	int ret;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		struct fdt_batch_edit *edit = &batch.edits[i];
+
+		if ((edit->node != node) || edit->done) {
+			continue;
+		}
+
+		switch (edit->op) {
+		case FDT_BATCH_SETPROP:
+			edit->done = true;
+			ret = fdt_setprop(fdt, offset, edit->name, edit->val,
+					  edit->len);
+			break;
+		case FDT_BATCH_DELPROP:
+			edit->done = true;
+			ret = fdt_delprop(fdt, offset, edit->name);
+			if (ret == -FDT_ERR_NOTFOUND) {
+				ret = 0;
+			}
+			break;
+		case FDT_BATCH_DEL_NODE:
+			edit->done = true;
+			del_node = true;
+			ret = 0;
+			break;
+		default:
+			ret = 0;
+			break;
+		}
+
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		struct fdt_batch_edit *edit = &batch.edits[i];
+
+		if ((edit->op != FDT_BATCH_ADD_NODE) || (edit->node != node) ||
+		    edit->done) {
+			continue;
+		}
+
+		edit->done = true;
+		ret = fdt_add_subnode(fdt, offset, edit->name);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = batch_replay_node(fdt, FDT_BATCH_NEW_NODE + (int)i, ret);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (del_node) {
+		return fdt_del_node(fdt, offset);
+	}
+
+	return 0;
+}
+
+/*
+ * Apply the edits of the recorded nodes from the last one in the tree: the
+ * offsets of the nodes before an edited one are not changed by the edit.
+ */
+static int batch_replay(void *fdt)
+{
+	for (;;) {
+		int node = -1;
+		unsigned int i;
+		int ret;
+
+		for (i = 0U; i < batch.nb_edits; i++) {
+			const struct fdt_batch_edit *edit = &batch.edits[i];
+
+			if (!edit->done && (edit->node < FDT_BATCH_NEW_NODE) &&
+			    (edit->node > node)) {
+				node = edit->node;
+			}
+		}
+
+		if (node < 0) {
+			return 0;
+		}
+
+		ret = batch_replay_node(fdt, node, node);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+}
+
+static void batch_reset_done(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < batch.nb_edits; i++) {
+		batch.edits[i].done = false;
+	}
+}
+
+/*
+ * Apply the recorded edits to the tree, in a buffer of bufsize bytes. The
+ * edited tree is written once after the recorded one and moved back, instead
+ * of moving the end of the tree for each edit. If the buffer cannot hold
+ * both trees, the edits are applied in place. The tree is returned packed.
+ */
+int stm32mp_fdt_batch_apply(void *fdt, size_t bufsize)
+{
+	uintptr_t dst;
+	size_t dst_offset;
+	int ret = -FDT_ERR_NOSPACE;
+
+	assert(fdt == batch.fdt);
+
+	batch.fdt = NULL;
+
+	if (batch.nb_edits == 0U) {
+		return 0;
+	}
+
+	dst = round_up((uintptr_t)fdt + fdt_totalsize(fdt), 8U);
+	dst_offset = dst - (uintptr_t)fdt;
+
+	if (dst_offset < bufsize) {
+		ret = batch_rebuild(fdt, (void *)dst,
+				    (int)(bufsize - dst_offset));
+		if (ret == 0) {
+			ret = fdt_move((void *)dst, fdt,
+				       (int)fdt_totalsize((void *)dst));
+		}
+	}
+
+	if (ret == -FDT_ERR_NOSPACE) {
+		VERBOSE("DT edited in place\n");
+
+		batch_reset_done();
+
+		ret = fdt_open_into(fdt, fdt, (int)bufsize);
+		if (ret == 0) {
+			ret = batch_replay(fdt);
+		}
+		if (ret == 0) {
+			ret = fdt_pack(fdt);
+		}
+	}
+
+	return ret;
+}
@@ -10,18 +10,28 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <drivers/arm/gicv2.h>
 #include <dt-bindings/interrupt-controller/arm-gic.h>
+#include <lib/mmio.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
+/* Maximum number of secure interrupt handlers that can be registered */
+#define STM32MP_GIC_MAX_HANDLERS	16U
+
 struct stm32mp_gic_instance {
 	uint32_t cells;
 	uint32_t phandle_node;
 };
 
+struct stm32mp_gic_handler {
+	uint32_t id;
+	stm32mp_gic_handler_t handler;
+};
+
 /******************************************************************************
  * On a GICv2 system, the Group 1 secure interrupts are treated as Group 0
  * interrupts.
@@ -43,7 +53,11 @@ static gicv2_driver_data_t platform_gic_data = {
 
 static struct stm32mp_gic_instance stm32mp_gic;
 
-static uint32_t enable_gic_interrupt(const fdt32_t *array)
+static struct stm32mp_gic_handler gic_handlers[STM32MP_GIC_MAX_HANDLERS];
+static unsigned int gic_handlers_nb;
+
+static uint32_t enable_gic_interrupt(const fdt32_t *array,
+				     unsigned int priority)
 {
 	unsigned int id, cfg;
 
@@ -68,7 +82,7 @@ static uint32_t enable_gic_interrupt(const fdt32_t *array)
 	if ((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID)) {
 		VERBOSE("Enable IT %i\n", id);
 		gicv2_set_interrupt_type(id, GICV2_INTR_GROUP0);
-		gicv2_set_interrupt_priority(id, STM32MP_IRQ_SEC_SPI_PRIO);
+		gicv2_set_interrupt_priority(id, priority);
 		gicv2_set_spi_routing(id, STM32MP_PRIMARY_CPU);
 		gicv2_interrupt_set_cfg(id, cfg);
 		gicv2_enable_interrupt(id);
@@ -89,7 +103,7 @@ static void find_next_interrupt(const fdt32_t **array)
 		panic();
 	}
 
-	node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(**array));
+	node = dt_node_offset_by_phandle(fdt32_to_cpu(**array));
 	if (node < 0) {
 		panic();
 	}
@@ -152,7 +166,32 @@ void stm32mp_gic_pcpu_init(void)
 	gicv2_cpuif_enable();
 }
 
-int stm32mp_gic_enable_spi(int node, const char *name)
+/*
+ * Return the priority of the index-th secure interrupt of the node: the
+ * "st,secure-interrupt-priority" property holds either one cell for all the
+ * interrupts of the node or one cell per interrupt. Fall back to the priority
+ * given by the driver when the node does not set it.
+ */
+static unsigned int get_interrupt_priority(void *fdt, int node, int index,
+					   unsigned int priority)
+{
+	const fdt32_t *cuint;
+	int len;
+
+	cuint = fdt_getprop(fdt, node, "st,secure-interrupt-priority", &len);
+	if (cuint == NULL) {
+		return priority;
+	}
+
+	if ((index > 0) && ((len / (int)sizeof(uint32_t)) > index)) {
+		cuint += index;
+	}
+
+	return fdt32_to_cpu(*cuint) & GIC_PRI_MASK;
+}
+
+int stm32mp_gic_enable_spi_prio(int node, const char *name,
+				unsigned int priority)
 {
 	const fdt32_t *cuint;
 	void *fdt;
@@ -198,14 +237,19 @@ int stm32mp_gic_enable_spi(int node, const char *name)
 	while ((t_array < max) && ((i <= index) || (index == -1))) {
 		if (!extended) {
 			if ((index == -1) || (i == index)) {
-				id = enable_gic_interrupt(t_array);
+				id = enable_gic_interrupt(t_array,
+					get_interrupt_priority(fdt, node, i,
+							       priority));
 			}
 			t_array += stm32mp_gic.cells;
 		} else {
 			if (fdt32_to_cpu(*t_array) == stm32mp_gic.phandle_node) {
 				t_array++;
 				if ((index == -1) || (i == index)) {
-					id = enable_gic_interrupt(t_array);
+					id = enable_gic_interrupt(t_array,
+						get_interrupt_priority(fdt,
+								       node, i,
+								       priority));
 				}
 				t_array += stm32mp_gic.cells;
 			} else {
@@ -217,3 +261,87 @@ int stm32mp_gic_enable_spi(int node, const char *name)
 
 	return id;
 }
+
+int stm32mp_gic_enable_spi(int node, const char *name)
+{
+	return stm32mp_gic_enable_spi_prio(node, name,
+					   STM32MP_IRQ_SEC_SPI_PRIO);
+}
+
+/*
+ * Register the handler of a secure interrupt, called from
+ * stm32mp_gic_dispatch() with the acknowledged interrupt ID.
+ */
+void stm32mp_gic_register_handler(uint32_t id, stm32mp_gic_handler_t handler)
+{
+	unsigned int i;
+
+	assert(handler != NULL);
+
+	for (i = 0U; i < gic_handlers_nb; i++) {
+		if (gic_handlers[i].id == id) {
+			gic_handlers[i].handler = handler;
+			return;
+		}
+	}
+
+	if (gic_handlers_nb == STM32MP_GIC_MAX_HANDLERS) {
+		panic();
+	}
+
+	gic_handlers[gic_handlers_nb].id = id;
+	gic_handlers[gic_handlers_nb].handler = handler;
+	gic_handlers_nb++;
+}
+
+/*
+ * Call the handler registered for an acknowledged secure interrupt.
+ * Return false if no handler is registered for this interrupt.
+ */
+bool stm32mp_gic_dispatch(uint32_t id)
+{
+	unsigned int i;
+
+	for (i = 0U; i < gic_handlers_nb; i++) {
+		if (gic_handlers[i].id == id) {
+			gic_handlers[i].handler(id);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Configure a secure level SPI only used to wake up the calling core from
+ * WFI, routed to this core. The interrupt source must be masked before
+ * returning to a context where FIQs are unmasked.
+ */
+void stm32mp_gic_enable_wakeup_spi(unsigned int id)
+{
+	assert((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID));
+
+	gicv2_set_interrupt_type(id, GICV2_INTR_GROUP0);
+	gicv2_set_interrupt_priority(id, STM32MP_IRQ_SEC_SPI_PRIO);
+	gicv2_set_spi_routing(id, (int)plat_my_core_pos());
+	gicv2_interrupt_set_cfg(id, GIC_INTR_CFG_LEVEL);
+	gicv2_enable_interrupt(id);
+}
+
+/*
+ * Wait in WFI for a wakeup SPI, or any other interrupt. Return false without
+ * waiting when the priority mask prevents the SPI from being signalled.
+ */
+bool stm32mp_gic_wait_spi(void)
+{
+	uint32_t pmr = mmio_read_32(platform_gic_data.gicc_base + GICC_PMR);
+
+	if (STM32MP_IRQ_SEC_SPI_PRIO >= (pmr & GIC_PRI_MASK)) {
+		return false;
+	}
+
+	dsb();
+	wfi();
+
+	return true;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_init_tasks.h>
+
+static const struct stm32mp_init_task *init_tasks;
+static unsigned int init_tasks_nb;
+static uint32_t started_mask;
+static uint32_t done_mask;
+
+/* Set while a step runs, the tasks may call a wait that steps the others */
+static bool stepping;
+
+void stm32mp_init_tasks_register(const struct stm32mp_init_task *tasks,
+				 unsigned int nb)
+{
+	unsigned int i;
+
+	assert((init_tasks == NULL) && (nb <= STM32MP_INIT_TASKS_MAX));
+
+	for (i = 0U; i < nb; i++) {
+		/* A task only depends on the previous ones: no cycle */
+		assert((tasks[i].deps & ~(BIT_32(i) - 1U)) == 0U);
+	}
+
+	init_tasks = tasks;
+	init_tasks_nb = nb;
+	started_mask = 0U;
+	done_mask = 0U;
+}
+
+static void init_task_step(unsigned int id)
+{
+	const struct stm32mp_init_task *task = &init_tasks[id];
+	uint32_t bit = BIT_32(id);
+
+	if ((done_mask & bit) != 0U) {
+		return;
+	}
+
+	if ((started_mask & bit) == 0U) {
+		/* Milestones are only completed by their blocking sequence */
+		if (((task->deps & ~done_mask) != 0U) || (task->start == NULL)) {
+			return;
+		}
+
+		VERBOSE("Init task %s: start\n", task->name);
+		started_mask |= bit;
+		task->start();
+
+		if (task->poll != NULL) {
+			return;
+		}
+	} else if (task->poll()) {
+		return;
+	} else {
+		/* Completed */
+	}
+
+	VERBOSE("Init task %s: done\n", task->name);
+	done_mask |= bit;
+}
+
+/* Start the ready tasks and poll the started ones, once */
+void stm32mp_init_tasks_step(void)
+{
+	unsigned int i;
+
+	if (stepping || (init_tasks == NULL)) {
+		return;
+	}
+
+	stepping = true;
+
+	for (i = 0U; i < init_tasks_nb; i++) {
+		init_task_step(i);
+	}
+
+	stepping = false;
+}
+
+void stm32mp_init_task_complete(unsigned int id)
+{
+	assert(id < init_tasks_nb);
+	assert(init_tasks[id].start == NULL);
+	assert((init_tasks[id].deps & ~done_mask) == 0U);
+
+	started_mask |= BIT_32(id);
+	done_mask |= BIT_32(id);
+}
+
+bool stm32mp_init_tasks_done(uint32_t mask)
+{
+	return (mask & ~done_mask) == 0U;
+}
+
+/*
+ * Step all the tasks until the ones of the mask are completed. As a task only
+ * depends on the previous ones, a step starts all the ready tasks: when none
+ * remains started, the mask waits for a milestone that cannot complete.
+ */
+void stm32mp_init_tasks_wait(uint32_t mask)
+{
+	assert(!stepping);
+
+	while (!stm32mp_init_tasks_done(mask)) {
+		stm32mp_init_tasks_step();
+
+		if ((started_mask & ~done_mask) == 0U) {
+			if (stm32mp_init_tasks_done(mask)) {
+				break;
+			}
+
+			ERROR("Init task %s not completed\n",
+			      init_tasks[__builtin_ctz(mask & ~done_mask)].name);
+			panic();
+		}
+	}
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/console.h>
+#include <drivers/st/stm32_console.h>
+#include <lib/cassert.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#include <stm32mp_common.h>
+#include <stm32mp_fdt_batch.h>
+#include <stm32mp_log_ring.h>
+
+#define LOG_RING_STRIDE		(STM32MP_LOG_RING_SIZE / PLATFORM_CORE_COUNT)
+#define LOG_RING_DATA_SIZE	(LOG_RING_STRIDE - sizeof(struct stm32mp_log_ring))
+
+CASSERT(LOG_RING_STRIDE > sizeof(struct stm32mp_log_ring),
+	assert_log_ring_size);
+
+static int log_ring_putc(int c, console_t *console);
+static void log_ring_flush(console_t *console);
+
+static console_t log_ring_console = {
+	.putc = log_ring_putc,
+};
+
+/* Flush only console, given the scope of the UART the rings are drained to */
+static console_t log_ring_drain_console = {
+	.flush = log_ring_flush,
+};
+
+static console_t *log_ring_uart;
+static struct spinlock log_ring_lock;
+
+static struct stm32mp_log_ring *log_ring(unsigned int core)
+{
+	return (struct stm32mp_log_ring *)(STM32MP_LOG_RING_BASE +
+					   (core * LOG_RING_STRIDE));
+}
+
+/*
+ * Only the owner core writes in its ring, with interrupts masked: no lock is
+ * needed. The ring may be modified by the non-secure world, the size is
+ * therefore never read back.
+ */
+static int log_ring_putc(int c, console_t *console)
+{
+	struct stm32mp_log_ring *ring = log_ring(plat_my_core_pos());
+	uint32_t head = ring->head;
+
+	ring->data[head % LOG_RING_DATA_SIZE] = (char)c;
+	dmbish();
+	ring->head = head + 1U;
+
+	return c;
+}
+
+static void log_ring_drain_core(unsigned int core)
+{
+	struct stm32mp_log_ring *ring = log_ring(core);
+	uint32_t head = ring->head;
+	uint32_t tail = ring->tail;
+
+	if (ring->magic != LOG_RING_MAGIC) {
+		return;
+	}
+
+	/* Read the characters once head is read */
+	dmbish();
+
+	if ((head - tail) > LOG_RING_DATA_SIZE) {
+		/* Oldest characters were overwritten */
+		tail = head - LOG_RING_DATA_SIZE;
+	}
+
+	/* At most two contiguous chunks, before and after the ring wraps */
+	while (tail != head) {
+		uint32_t offset = tail % LOG_RING_DATA_SIZE;
+		uint32_t len = MIN(head - tail, LOG_RING_DATA_SIZE - offset);
+
+		if (console_stm32_write(log_ring_uart, &ring->data[offset],
+					len) < 0) {
+			break;
+		}
+
+		tail += len;
+	}
+
+	ring->tail = tail;
+}
+
+static void log_ring_flush(console_t *console)
+{
+	bool lock = stm32mp_lock_available();
+	unsigned int core;
+
+	if (log_ring_uart == NULL) {
+		return;
+	}
+
+	if (lock) {
+		spin_lock(&log_ring_lock);
+	}
+
+	for (core = 0U; core < PLATFORM_CORE_COUNT; core++) {
+		log_ring_drain_core(core);
+	}
+
+	log_ring_uart->flush(log_ring_uart);
+
+	if (lock) {
+		spin_unlock(&log_ring_lock);
+	}
+}
+
+/*
+ * BL2 starts new rings on each boot, BL32 appends to the rings left by BL2
+ * so that the whole boot log is kept.
+ */
+void stm32mp_log_ring_init(void)
+{
+	unsigned int core;
+
+	for (core = 0U; core < PLATFORM_CORE_COUNT; core++) {
+		struct stm32mp_log_ring *ring = log_ring(core);
+
+#if !defined(IMAGE_BL2)
+		if ((ring->magic == LOG_RING_MAGIC) &&
+		    (ring->size == LOG_RING_DATA_SIZE)) {
+			continue;
+		}
+#endif
+
+		ring->magic = LOG_RING_MAGIC;
+		ring->size = LOG_RING_DATA_SIZE;
+		ring->head = 0U;
+		ring->tail = 0U;
+	}
+
+	console_set_scope(&log_ring_console,
+			  CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME);
+	(void)console_register(&log_ring_console);
+
+	console_set_scope(&log_ring_drain_console, 0U);
+	(void)console_register(&log_ring_drain_console);
+}
+
+/*
+ * Messages are then only written in the rings: the UART, an STM32 console, is
+ * used in its scope when consoles are flushed, and remains the crash console.
+ */
+void stm32mp_log_ring_set_uart(console_t *uart, unsigned int scope)
+{
+	log_ring_uart = uart;
+	console_set_scope(&log_ring_drain_console, scope);
+}
+
+/* Drain the rings in an idle window, if the UART is in scope */
+void stm32mp_log_ring_drain(void)
+{
+	console_flush();
+}
+
+void stm32mp_log_ring_handoff(void)
+{
+	console_flush();
+
+	/* Make the rings visible to the next stages */
+	flush_dcache_range(STM32MP_LOG_RING_BASE, STM32MP_LOG_RING_SIZE);
+}
+
+#if defined(IMAGE_BL32)
+/*
+ * Reserve the rings in the non-secure DT, for the non-secure world to read.
+ * The node is recorded in the DT update batch.
+ */
+int stm32mp_log_ring_dt_fixup(void)
+{
+	char name[24];
+
+	(void)snprintf(name, sizeof(name), "tf-a-log@%x",
+		       (unsigned int)STM32MP_LOG_RING_BASE);
+
+	return stm32mp_fdt_batch_add_reserved_memory(name,
+						     STM32MP_LOG_RING_BASE,
+						     STM32MP_LOG_RING_SIZE);
+}
+#endif
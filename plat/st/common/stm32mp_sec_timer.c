@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+
+#include <stm32mp_sec_timer.h>
+
+#define SEC_TIMER_TVAL_MAX	U(0x7FFFFFFF)
+
+struct sec_timer_task {
+	void (*fn)(void);
+	uint64_t slack;
+	uint64_t deadline;
+	bool armed;
+};
+
+static struct sec_timer_task task[STM32MP_SEC_TIMER_NB];
+static unsigned int task_count;
+static spinlock_t sec_timer_lock;
+
+/* Program the timer to the earliest latest time of the armed tasks */
+static void sec_timer_update(void)
+{
+	uint64_t expiry = UINT64_MAX;
+	uint64_t now;
+	unsigned int i;
+
+	for (i = 0U; i < task_count; i++) {
+		if (task[i].armed) {
+			expiry = MIN(expiry, task[i].deadline + task[i].slack);
+		}
+	}
+
+	if (expiry == UINT64_MAX) {
+		write_cntp_ctl(0U);
+		return;
+	}
+
+	now = read_cntpct_el0();
+	if (expiry <= now) {
+		write_cntp_tval(0U);
+	} else {
+		write_cntp_tval((uint32_t)MIN(expiry - now,
+					      (uint64_t)SEC_TIMER_TVAL_MAX));
+	}
+
+	write_cntp_ctl(BIT(0));
+}
+
+/*
+ * Register a task, not armed. slack_ticks is how late the task can run to
+ * share a wake-up with another one.
+ * Return the task ID or -ENOMEM.
+ */
+int stm32mp_sec_timer_register(void (*fn)(void), uint64_t slack_ticks)
+{
+	int id;
+
+	assert(fn != NULL);
+
+	spin_lock(&sec_timer_lock);
+
+	if (task_count == STM32MP_SEC_TIMER_NB) {
+		spin_unlock(&sec_timer_lock);
+		return -ENOMEM;
+	}
+
+	task[task_count].fn = fn;
+	task[task_count].slack = slack_ticks;
+	task[task_count].armed = false;
+	id = (int)task_count;
+	task_count++;
+
+	spin_unlock(&sec_timer_lock);
+
+	return id;
+}
+
+/* Run the task once, at a system counter value, as stm32mp_sec_timer_arm() */
+void stm32mp_sec_timer_arm_at(unsigned int id, uint64_t deadline)
+{
+	assert(id < task_count);
+
+	spin_lock(&sec_timer_lock);
+
+	task[id].deadline = deadline;
+	task[id].armed = true;
+	sec_timer_update();
+
+	spin_unlock(&sec_timer_lock);
+}
+
+/* Run the task once, delay_ticks from now. A pending deadline is replaced. */
+void stm32mp_sec_timer_arm(unsigned int id, uint64_t delay_ticks)
+{
+	stm32mp_sec_timer_arm_at(id, read_cntpct_el0() + delay_ticks);
+}
+
+void stm32mp_sec_timer_cancel(unsigned int id)
+{
+	assert(id < task_count);
+
+	spin_lock(&sec_timer_lock);
+
+	task[id].armed = false;
+	sec_timer_update();
+
+	spin_unlock(&sec_timer_lock);
+}
+
+/* Run the tasks which are due, then program the next wake-up */
+void stm32mp_sec_timer_it_handler(void)
+{
+	uint64_t now;
+	unsigned int i;
+
+	spin_lock(&sec_timer_lock);
+
+	now = read_cntpct_el0();
+
+	for (i = 0U; i < task_count; i++) {
+		if (task[i].armed && (task[i].deadline <= now)) {
+			task[i].armed = false;
+
+			/* The task may arm itself again */
+			spin_unlock(&sec_timer_lock);
+			task[i].fn();
+			spin_lock(&sec_timer_lock);
+		}
+	}
+
+	sec_timer_update();
+
+	spin_unlock(&sec_timer_lock);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <common/desc_image_load.h>
+#include <common/fdt_wrappers.h>
+#include <drivers/spi_nor.h>
+#include <drivers/st/stm32_qspi.h>
+#include <libfdt.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+#include <stm32mp_dma_memcpy.h>
+#include <stm32mp_striped_load.h>
+
+/* The head and the extent of an image do not share a cache line */
+#define STRIPED_LOAD_ALIGN	U(0x1000)
+
+struct striped_extent {
+	unsigned int image_id;
+	const char *name;
+	uint32_t nor_offset;
+	uint32_t image_offset;
+	uint32_t size;
+};
+
+static struct striped_extent striped_extents[] = {
+	{ .image_id = BL32_EXTRA1_IMAGE_ID, .name = "bl32_extra1_extent" },
+	{ .image_id = BL32_EXTRA2_IMAGE_ID, .name = "bl32_extra2_extent" },
+	{ .image_id = BL33_IMAGE_ID, .name = "bl33_extent" },
+};
+
+/* Extent being copied, the copy is issued by lists of the DMA memcpy */
+static struct {
+	const struct striped_extent *extent;
+	uintptr_t src;
+	uintptr_t dst;
+	size_t issued;
+} striped_copy;
+
+static bool striped_nor_ready;
+
+int stm32mp_striped_load_populate(const void *fdt, int node)
+{
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(striped_extents); i++) {
+		struct striped_extent *extent = &striped_extents[i];
+		uint32_t cells[3];
+		int err;
+
+		err = fdt_read_uint32_array(fdt, node, extent->name, 3U, cells);
+		if (err == -FDT_ERR_NOTFOUND) {
+			continue;
+		}
+
+		if ((err < 0) || (cells[2] == 0U) ||
+		    ((cells[1] % STRIPED_LOAD_ALIGN) != 0U)) {
+			WARN("FCONF: Invalid %s\n", extent->name);
+			return -FDT_ERR_BADVALUE;
+		}
+
+		extent->nor_offset = cells[0];
+		extent->image_offset = cells[1];
+		extent->size = cells[2];
+
+		VERBOSE("FCONF: %s 0x%x bytes at 0x%x, SPI-NOR 0x%x\n",
+			extent->name, extent->size, extent->image_offset,
+			extent->nor_offset);
+	}
+
+	return 0;
+}
+
+static const struct striped_extent *striped_find(unsigned int image_id)
+{
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(striped_extents); i++) {
+		if ((striped_extents[i].image_id == image_id) &&
+		    (striped_extents[i].size != 0U)) {
+			return &striped_extents[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void striped_nor_init(void)
+{
+	unsigned long long size;
+	unsigned int erase_size;
+
+	if (striped_nor_ready) {
+		return;
+	}
+
+	if ((stm32_qspi_init() != 0) || (spi_nor_init(&size, &erase_size) != 0)) {
+		ERROR("SPI-NOR init failed\n");
+		panic();
+	}
+
+	stm32mp_dma_memcpy_init();
+	striped_nor_ready = true;
+}
+
+/* Issue the next list of the copy once the previous one is completed */
+static void striped_copy_step(void)
+{
+	const struct striped_extent *extent = striped_copy.extent;
+	size_t len;
+
+	if ((extent == NULL) || stm32mp_dma_memcpy_poll() ||
+	    (striped_copy.issued == extent->size)) {
+		return;
+	}
+
+	len = MIN(extent->size - striped_copy.issued,
+		  (size_t)STM32MP_DMA_MEMCPY_ASYNC_MAX);
+	stm32mp_dma_memcpy(striped_copy.dst + striped_copy.issued,
+			   striped_copy.src + striped_copy.issued, len);
+	striped_copy.issued += len;
+}
+
+/*
+ * Start the copy of the SPI-NOR extent of the image, if any. Return true
+ * when started: the SD/eMMC reads of the image then call the hook.
+ */
+bool stm32mp_striped_load_start(unsigned int image_id)
+{
+	const struct striped_extent *extent = striped_find(image_id);
+	bl_mem_params_node_t *bl_mem_params;
+	uintptr_t src;
+	int ret;
+
+	assert(striped_copy.extent == NULL);
+
+	if (extent == NULL) {
+		return false;
+	}
+
+	bl_mem_params = get_bl_mem_params_node(image_id);
+	assert(bl_mem_params != NULL);
+
+	if ((extent->image_offset + extent->size) >
+	    bl_mem_params->image_info.image_max_size) {
+		ERROR("%s exceeds the image area\n", extent->name);
+		panic();
+	}
+
+	striped_nor_init();
+
+	ret = spi_nor_mm_map(extent->nor_offset, extent->size, &src);
+	if (ret != 0) {
+		ERROR("%s not mapped (%d)\n", extent->name, ret);
+		panic();
+	}
+
+	striped_copy.extent = extent;
+	striped_copy.src = src;
+	striped_copy.dst = bl_mem_params->image_info.image_base +
+			   extent->image_offset;
+	striped_copy.issued = 0U;
+
+	stm32mp_dma_memcpy_set_async(true);
+	striped_copy_step();
+
+	return true;
+}
+
+void stm32mp_striped_load_hook(uintptr_t buf, size_t size)
+{
+	striped_copy_step();
+}
+
+/*
+ * Wait for the copy of the extent, once the FIP entry is loaded, and add
+ * the extent to the image size.
+ */
+int stm32mp_striped_load_complete(unsigned int image_id,
+				  image_info_t *image_info)
+{
+	const struct striped_extent *extent = striped_copy.extent;
+
+	if ((extent == NULL) || (extent->image_id != image_id)) {
+		return 0;
+	}
+
+	while (striped_copy.issued != extent->size) {
+		striped_copy_step();
+	}
+
+	stm32mp_dma_memcpy_wait();
+	stm32mp_dma_memcpy_set_async(false);
+	spi_nor_mm_unmap();
+	striped_copy.extent = NULL;
+
+	if (image_info->image_size != extent->image_offset) {
+		ERROR("%s does not follow the FIP entry (0x%x bytes)\n",
+		      extent->name, image_info->image_size);
+		return -EINVAL;
+	}
+
+	image_info->image_size += extent->size;
+
+	return 0;
+}
@@ -7,6 +7,7 @@
 #include <endian.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdbool.h>
 
 #include <common/debug.h>
 #include <common/tbbr/cot_def.h>
@@ -15,6 +16,7 @@
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/fconf/fconf_tbbr_getter.h>
 #include <lib/mmio.h>
+#include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <plat/common/platform.h>
 
@@ -27,6 +29,12 @@ static uint8_t der_sha256_header[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60,
 	0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20};
 static uint8_t root_pk_hash[HASH_DER_LEN];
 
+/* Root public key hash state, read once and kept until invalidated */
+static struct {
+	bool valid;
+	bool deployed;
+} rotpk_cache;
+
 static int copy_hash_from_otp(const char *otp_name, uint8_t *hash, size_t len)
 {
 	uint32_t otp_idx;
@@ -81,7 +89,7 @@ static int copy_hash_from_otp(const char *otp_name, uint8_t *hash, size_t len)
 }
 
 #if STM32MP13
-static int get_rotpk_hash(void *cookie, uint8_t *hash, size_t len)
+static int get_rotpk_hash(uint8_t *hash, size_t len)
 {
 	int ret;
 	uint32_t pk_idx = 0U;
@@ -92,10 +100,6 @@ static int get_rotpk_hash(void *cookie, uint8_t *hash, size_t len)
 	boot_extension_header_t *ext_header = (boot_extension_header_t *)hdr->ext_header;
 	boot_ext_header_params_authentication_t *param;
 
-	if (cookie != NULL) {
-		return -EINVAL;
-	}
-
 	if (hdr->header_version != BOOT_API_HEADER_VERSION) {
 		VERBOSE("%s: unexpected header_version\n", __func__);
 		return -EINVAL;
@@ -135,36 +139,59 @@ static int get_rotpk_hash(void *cookie, uint8_t *hash, size_t len)
 #endif
 
 #if STM32MP15
-static int get_rotpk_hash(void *cookie, uint8_t *hash, size_t len)
+static int get_rotpk_hash(uint8_t *hash, size_t len)
 {
-	if (cookie != NULL) {
-		return -EINVAL;
-	}
-
 	return copy_hash_from_otp(PKH_OTP, hash, len);
 }
 #endif
 
-int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
-			unsigned int *flags)
+/*
+ * Read the root public key hash, and keep it in secure memory for the
+ * certificates authenticated afterwards.
+ */
+int stm32mp_rotpk_hash_load(void)
 {
-	size_t start_copy_idx = 0U;
 	int res;
 
+	stm32mp_rotpk_hash_invalidate();
+
 	memcpy(root_pk_hash, der_sha256_header, sizeof(der_sha256_header));
-	start_copy_idx = sizeof(der_sha256_header);
 
-	res = get_rotpk_hash(cookie, root_pk_hash + start_copy_idx,
+	res = get_rotpk_hash(root_pk_hash + sizeof(der_sha256_header),
 			     BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES);
 	if (res < 0) {
 		return -EINVAL;
 	}
 
+	rotpk_cache.deployed = (res != 0);
+	rotpk_cache.valid = true;
+
+	return 0;
+}
+
+/* Drop the root public key hash, it is read again on next use */
+void stm32mp_rotpk_hash_invalidate(void)
+{
+	rotpk_cache.valid = false;
+	zeromem(root_pk_hash, sizeof(root_pk_hash));
+}
+
+int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
+			unsigned int *flags)
+{
+	if (cookie != NULL) {
+		return -EINVAL;
+	}
+
+	if (!rotpk_cache.valid && (stm32mp_rotpk_hash_load() != 0)) {
+		return -EINVAL;
+	}
+
 	*key_len = HASH_DER_LEN;
 	*key_ptr = &root_pk_hash;
 	*flags = ROTPK_IS_HASH;
 
-	if ((res == 0) && !stm32mp_is_closed_device()) {
+	if (!rotpk_cache.deployed && !stm32mp_is_closed_device()) {
 		*flags |= ROTPK_NOT_DEPLOYED;
 	}
 
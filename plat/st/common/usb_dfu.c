@@ -330,7 +330,12 @@ static void usb_dfu_get_status(struct usb_handle *pdev)
 	/* next step */
 	switch (hdfu->dev_state) {
 	case STATE_DFU_DNLOAD_SYNC:
+		/*
+		 * The block is already received on EP0: report the next state,
+		 * sparing the host a second GETSTATUS per block.
+		 */
 		hdfu->dev_state = STATE_DFU_DNLOAD_IDLE;
+		hdfu->status[4] = STATE_DFU_DNLOAD_IDLE;
 		break;
 	case STATE_DFU_MANIFEST_SYNC:
 		/* the device is 'ManifestationTolerant' */
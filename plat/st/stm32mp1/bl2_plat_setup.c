@@ -14,6 +14,10 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
+#include <common/image_decompress.h>
+#if TRUSTED_BOARD_BOOT
+#include <drivers/auth/mbedtls/mbedtls_common.h>
+#endif
 #include <drivers/clk.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/mmc.h>
@@ -23,6 +27,9 @@
 #include <drivers/st/stm32_iwdg.h>
 #if STM32MP13
 #include <drivers/st/stm32_mce.h>
+#if TRUSTED_BOARD_BOOT
+#include <drivers/st/stm32_pka.h>
+#endif
 #include <drivers/st/stm32_rng.h>
 #endif
 #include <drivers/st/stm32_uart.h>
@@ -30,19 +37,56 @@
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_pwr.h>
 #include <drivers/st/stm32mp1_ram.h>
+#include <drivers/st/stm32mp_reset.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/mmio.h>
 #include <lib/optee_utils.h>
+#include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <plat/common/platform.h>
+#if STM32MP_DECOMPRESS_STREAM
+#if STM32MP_DECOMPRESS_LZ4
+#include <tf_unlz4.h>
+#else
+#include <tf_gunzip.h>
+#endif
+#endif
 
+#include <stm32mp1_bl2_smp.h>
+#include <stm32mp1_boot_trace.h>
+#include <stm32mp1_cache_bench.h>
 #include <stm32mp1_context.h>
+#include <stm32mp1_crypto_bench.h>
 #include <stm32mp1_dbgmcu.h>
+#include <stm32mp1_handoff.h>
+#include <stm32mp1_mce_bench.h>
+#include <stm32mp1_mem_bench.h>
+#include <stm32mp1_mem_usage.h>
+#include <stm32mp1_storage_bench.h>
+#include <stm32mp_boot_timeline.h>
 #include <stm32mp_common.h>
+#include <stm32mp_deferred_images.h>
+#include <stm32mp_dma_memcpy.h>
+#include <stm32mp_dt_variants.h>
+#include <stm32mp_init_tasks.h>
+#include <stm32mp_log_ring.h>
+#include <stm32mp_striped_load.h>
 
 #define PLL1_NOMINAL_FREQ_IN_KHZ	650000U /* 650MHz */
 
+#if STM32MP_M4_EARLY_BOOT
+/* Co-processor state, from which Linux remoteproc attaches to the M4 */
+#define TAMP_COPRO_STATE_REG_ID		U(18)
+#define TAMP_COPRO_STATE_CRUN		U(2)
+#endif
+
+#if STM32MP13
+/* MCE master key, drawn from the RNG while the DDR PHY is trained */
+static uint8_t mce_mkey[MCE_KEY_SIZE_IN_BYTES];
+static unsigned int mce_mkey_len = MCE_KEY_SIZE_IN_BYTES;
+#endif
+
 static const char debug_msg[626] = {
 	"***************************************************\n"
 	"** NOTICE   NOTICE   NOTICE   NOTICE   NOTICE    **\n"
@@ -152,21 +196,120 @@ void bl2_el3_early_platform_setup(u_register_t arg0,
 				  u_register_t arg2 __unused,
 				  u_register_t arg3 __unused)
 {
+	stm32mp1_mem_usage_paint_stacks();
+
+	stm32mp_boot_timeline_init();
+	stm32mp_boot_timeline_mark(BOOT_TL_BL2_ENTRY, 0U);
+
+	stm32mp_log_ring_init();
+
 	stm32mp_setup_early_console();
 
 	stm32mp_save_boot_ctx_address(arg0);
 }
 
+#if STM32MP13
+/* A new MCE master key is needed, unless exiting from Standby */
+static void mce_mkey_start(void)
+{
+	if ((stm32mp_is_closed_device() || stm32mp_is_auth_supported()) &&
+	    !stm32mp1_is_wakeup_from_standby()) {
+		mce_mkey_len = 0U;
+	}
+}
+
+/* Read one word of the MCE master key, return true while it is incomplete */
+static bool mce_mkey_step(void)
+{
+	if (mce_mkey_len == MCE_KEY_SIZE_IN_BYTES) {
+		return false;
+	}
+
+	if (stm32_rng_read(mce_mkey + mce_mkey_len, sizeof(uint32_t)) != 0) {
+		panic();
+	}
+
+	mce_mkey_len += sizeof(uint32_t);
+
+	return mce_mkey_len != MCE_KEY_SIZE_IN_BYTES;
+}
+#endif
+
+static void boot_device_start(void)
+{
+	if (stm32mp_skip_boot_device_after_standby()) {
+		bl_mem_params_node_t *bl_mem_params = get_bl_mem_params_node(FW_CONFIG_ID);
+
+		assert(bl_mem_params != NULL);
+
+		bl_mem_params->image_info.h.attr |= IMAGE_ATTRIB_SKIP_LOADING;
+	} else {
+		stm32mp_boot_timeline_mark(BOOT_TL_IO_SETUP_START, 0U);
+		stm32mp_io_setup();
+		stm32mp_boot_timeline_mark(BOOT_TL_IO_SETUP_END, 0U);
+	}
+}
+
+/*
+ * Initialisations interleaved by the BL2 init scheduler: the ones with a
+ * start step run from the waits of the others, and of the DDR init. The DDR
+ * is a milestone, initialised by the blocking bl2_platform_setup() sequence.
+ */
+enum bl2_init_task_id {
+	BL2_INIT_TASK_BOOT_DEVICE,
+#if STM32MP13
+	BL2_INIT_TASK_MCE_KEY,
+#endif
+	BL2_INIT_TASK_DDR,
+	BL2_INIT_TASK_NB
+};
+
+static const struct stm32mp_init_task bl2_init_tasks[BL2_INIT_TASK_NB] = {
+	[BL2_INIT_TASK_BOOT_DEVICE] = {
+		.name = "boot device",
+		.start = boot_device_start,
+		.poll = stm32mp_io_setup_step,
+	},
+#if STM32MP13
+	[BL2_INIT_TASK_MCE_KEY] = {
+		.name = "MCE key",
+		.start = mce_mkey_start,
+		.poll = mce_mkey_step,
+	},
+#endif
+	[BL2_INIT_TASK_DDR] = {
+		.name = "DDR",
+	},
+};
+
+/*
+ * Step the initialisations that do not need the DDR while the DDR PHY is
+ * initialised and trained.
+ */
+void plat_ddrphy_wait_step(void)
+{
+	stm32mp_init_tasks_step();
+}
+
 void bl2_platform_setup(void)
 {
 	int ret;
 
+	stm32mp_boot_timeline_mark(BOOT_TL_DDR_INIT_START, 0U);
+
 	ret = stm32mp1_ddr_probe();
 	if (ret < 0) {
 		ERROR("Invalid DDR init: error %d\n", ret);
 		panic();
 	}
 
+	stm32mp_boot_timeline_mark(BOOT_TL_DDR_INIT_END, 0U);
+
+	stm32mp_init_task_complete(BL2_INIT_TASK_DDR);
+
+	/* The other tasks may have progressed during DDR init */
+	stm32mp_init_tasks_wait(BIT_32(BL2_INIT_TASK_NB) - 1U);
+
 	if (!stm32mp1_ddr_is_restored()) {
 #if STM32MP15
 		uintptr_t bkpr_core1_magic =
@@ -191,6 +334,23 @@ void bl2_platform_setup(void)
 		ERROR("DDR mapping: error %d\n", ret);
 		panic();
 	}
+
+	/* DDR content is preserved when exiting from Standby */
+	if (!stm32mp1_ddr_is_restored()) {
+		stm32mp1_mem_bench();
+		stm32mp1_cache_bench();
+		stm32mp_io_use_ddr_buffers();
+	}
+
+#if STM32MP_DECOMPRESS_STREAM
+	image_decompress_stream_init(STM32MP_DECOMPRESS_BUF_BASE,
+				     STM32MP_DECOMPRESS_BUF_SIZE,
+#if STM32MP_DECOMPRESS_LZ4
+				     &unlz4_stream);
+#else
+				     &gunzip_stream);
+#endif
+#endif
 }
 
 #if STM32MP15
@@ -232,6 +392,7 @@ static void update_monotonic_counter(void)
 void bl2_el3_plat_arch_setup(void)
 {
 	const char *board_model;
+	bool wakeup_standby;
 	boot_api_context_t *boot_context =
 		(boot_api_context_t *)stm32mp_get_boot_ctx_address();
 	uintptr_t pwr_base;
@@ -245,6 +406,8 @@ void bl2_el3_plat_arch_setup(void)
 		panic();
 	}
 
+	stm32mp1_boot_trace_start();
+
 	mmap_add_region(BL_CODE_BASE, BL_CODE_BASE,
 			BL_CODE_END - BL_CODE_BASE,
 			MT_CODE | MT_SECURE);
@@ -310,6 +473,9 @@ void bl2_el3_plat_arch_setup(void)
 		panic();
 	}
 
+	/* Context validity is checked once, as early as clocks allow it */
+	wakeup_standby = stm32mp1_is_wakeup_from_standby();
+
 	stm32_save_boot_interface(boot_context->boot_interface_selected,
 				  boot_context->boot_interface_instance);
 
@@ -325,6 +491,11 @@ void bl2_el3_plat_arch_setup(void)
 	/* Enter in boot mode */
 	stm32mp1_syscfg_boot_mode_enable();
 
+	/* Banner was printed at cold boot, do not delay the resume path */
+	if (wakeup_standby) {
+		goto skip_console_init;
+	}
+
 	stm32mp_print_cpuinfo();
 
 	board_model = dt_get_board_model();
@@ -361,12 +532,14 @@ skip_console_init:
 
 	if (dt_pmic_status() > 0) {
 		initialize_pmic();
-		if (!stm32mp1_is_wakeup_from_standby() &&
-		    pmic_voltages_init() != 0) {
-			ERROR("PMIC voltages init failed\n");
-			panic();
+		if (!wakeup_standby) {
+			if (pmic_voltages_init() != 0) {
+				ERROR("PMIC voltages init failed\n");
+				panic();
+			}
+
+			print_pmic_info_and_debug();
 		}
-		print_pmic_info_and_debug();
 	}
 
 	stm32mp1_syscfg_init();
@@ -401,40 +574,70 @@ skip_console_init:
 
 	fconf_populate("TB_FW", STM32MP_DTB_BASE);
 
-	if (stm32mp_skip_boot_device_after_standby()) {
-		bl_mem_params_node_t *bl_mem_params = get_bl_mem_params_node(FW_CONFIG_ID);
+	stm32mp_boot_timeline_mark(BOOT_TL_BL2_ARCH_SETUP_END, 0U);
 
-		assert(bl_mem_params != NULL);
+	/* Start the tasks that do not depend on the DDR */
+	stm32mp_init_tasks_register(bl2_init_tasks, BL2_INIT_TASK_NB);
+	stm32mp_init_tasks_step();
 
-		bl_mem_params->image_info.h.attr |= IMAGE_ATTRIB_SKIP_LOADING;
-	} else {
-		stm32mp_io_setup();
+#if STM32MP_M4_EARLY_BOOT
+	/* The M4 is restarted by Linux after standby, as it was stopped */
+	if (stm32mp1_is_wakeup_from_standby()) {
+		bl_mem_params_node_t *m4_mem_params = get_bl_mem_params_node(SCP_BL2_IMAGE_ID);
+
+		assert(m4_mem_params != NULL);
+
+		m4_mem_params->image_info.h.attr |= IMAGE_ATTRIB_SKIP_LOADING;
 	}
+#endif
 }
 
+#if STM32MP_M4_EARLY_BOOT
+/*
+ * Release the M4 from its hold boot once its firmware is in RETRAM, it runs
+ * while BL2 loads the next images.
+ */
+static void start_m4_firmware(const image_info_t *image_info)
+{
+	flush_dcache_range(image_info->image_base, image_info->image_size);
+
+	/* The MCU must not change its clocks while BL2 configures the RCC */
+	stm32mp1_clk_mcuss_protect(true);
+
+	clk_enable(RTCAPB);
+	mmio_write_32(tamp_bkpr(TAMP_COPRO_STATE_REG_ID),
+		      TAMP_COPRO_STATE_CRUN);
+	clk_disable(RTCAPB);
+
+	stm32mp_reset_assert_deassert_to_mcu(false);
+
+	INFO("M4 firmware started\n");
+}
+#endif
+
 #if STM32MP13
 static void prepare_encryption(void)
 {
-	uint8_t mkey[MCE_KEY_SIZE_IN_BYTES];
-
 	stm32_mce_init();
 
 	if (stm32mp1_is_wakeup_from_standby()) {
-		stm32mp1_pm_get_mce_mkey_from_context(mkey);
+		stm32mp1_pm_get_mce_mkey_from_context(mce_mkey);
 		stm32_mce_reload_configuration();
 	} else {
-		/* Generate MCE master key from RNG */
-		if (stm32_rng_read(mkey, MCE_KEY_SIZE_IN_BYTES) != 0) {
-			panic();
+		/* Complete the MCE master key started during DDR training */
+		while (mce_mkey_step()) {
+			;
 		}
 
-		stm32mp1_pm_save_mce_mkey_in_context(mkey);
+		stm32mp1_pm_save_mce_mkey_in_context(mce_mkey);
 	}
 
-	if (stm32_mce_write_master_key(mkey) != 0) {
+	if (stm32_mce_write_master_key(mce_mkey) != 0) {
 		panic();
 	}
 
+	zeromem(mce_mkey, sizeof(mce_mkey));
+
 	stm32_mce_lock_master_key();
 }
 #endif
@@ -461,10 +664,21 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 		BL33_IMAGE_ID,
 		HW_CONFIG_ID,
 		TOS_FW_CONFIG_ID,
+#if STM32MP_DEFER_NT_FW_CONFIG
+		NT_FW_CONFIG_ID,
+#endif
 	};
 
+	stm32mp_boot_timeline_mark(BOOT_TL_IMAGE_LOAD_END, image_id);
+
 	assert(bl_mem_params != NULL);
 
+	err = stm32mp_striped_load_complete(image_id,
+					    &bl_mem_params->image_info);
+	if (err != 0) {
+		return err;
+	}
+
 	switch (image_id) {
 	case FW_CONFIG_ID:
 #if STM32MP13
@@ -479,12 +693,24 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 		/* Set global DTB info for fixed fw_config information */
 		set_config_info(STM32MP_FW_CONFIG_BASE, STM32MP_FW_CONFIG_MAX_SIZE, FW_CONFIG_ID);
 		fconf_populate("FW_CONFIG", STM32MP_FW_CONFIG_BASE);
+		stm32mp_dt_variant_select((void *)STM32MP_FW_CONFIG_BASE);
+
+#if STM32MP13
+		if (stm32mp_is_closed_device() || stm32mp_is_auth_supported()) {
+			stm32mp1_mce_bench();
+		}
+#endif
 
-		idx = dyn_cfg_dtb_info_get_index(TOS_FW_CONFIG_ID);
+		stm32mp1_crypto_bench();
+		stm32mp1_storage_bench();
 
 		/* Iterate through all the fw config IDs */
 		for (i = 0U; i < ARRAY_SIZE(image_ids); i++) {
-			if ((image_ids[i] == TOS_FW_CONFIG_ID) && (idx == FCONF_INVALID_IDX)) {
+			/* TOS_FW_CONFIG and NT_FW_CONFIG are optional */
+			idx = dyn_cfg_dtb_info_get_index(image_ids[i]);
+			if (((image_ids[i] == TOS_FW_CONFIG_ID) ||
+			     (image_ids[i] == NT_FW_CONFIG_ID)) &&
+			    (idx == FCONF_INVALID_IDX)) {
 				continue;
 			}
 
@@ -541,6 +767,7 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 
 			case HW_CONFIG_ID:
 			case TOS_FW_CONFIG_ID:
+			case NT_FW_CONFIG_ID:
 				break;
 
 			default:
@@ -596,6 +823,8 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 			bl_mem_params->image_info.image_max_size +=
 				tos_fw_mem_params->image_info.image_max_size;
 			bl_mem_params->ep_info.args.arg0 = 0;
+			bl_mem_params->ep_info.args.arg3 =
+				stm32mp1_handoff_prepare();
 		}
 
 		if (bl_mem_params->ep_info.pc >= STM32MP_DDR_BASE) {
@@ -614,6 +843,27 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 #endif /* PSA_FWU_SUPPORT */
 		break;
 
+	case HW_CONFIG_ID:
+	case TOS_FW_CONFIG_ID:
+		if ((bl_mem_params->image_info.h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
+			err = stm32mp_dt_variant_apply(image_id, &bl_mem_params->image_info);
+		}
+		break;
+
+	case NT_FW_CONFIG_ID:
+		if ((bl_mem_params->image_info.h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
+			err = stm32mp_deferred_image_add(image_id, &bl_mem_params->image_info);
+		}
+		break;
+
+#if STM32MP_M4_EARLY_BOOT
+	case SCP_BL2_IMAGE_ID:
+		if ((bl_mem_params->image_info.h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
+			start_m4_firmware(&bl_mem_params->image_info);
+		}
+		break;
+#endif
+
 	default:
 		/* Do nothing in default case */
 		break;
@@ -625,20 +875,54 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 	 * We take the worst case which is 2 MMC blocks.
 	 */
 	if ((image_id != FW_CONFIG_ID) &&
-	    ((bl_mem_params->image_info.h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U)) {
+	    ((bl_mem_params->image_info.h.attr &
+	      (IMAGE_ATTRIB_SKIP_LOADING | IMAGE_ATTRIB_DEFERRED)) == 0U)) {
+#if STM32MP_BL2_EARLY_DCACHE
+		/* Image last cache line is still dirty, it must not be dropped */
+		flush_dcache_range(bl_mem_params->image_info.image_base +
+				   bl_mem_params->image_info.image_size,
+				   2U * MMC_BLOCK_SIZE);
+#else
 		inv_dcache_range(bl_mem_params->image_info.image_base +
 				 bl_mem_params->image_info.image_size,
 				 2U * MMC_BLOCK_SIZE);
+#endif
 	}
 #endif /* STM32MP_SDMMC || STM32MP_EMMC */
 
 	return err;
 }
 
+#if STM32MP_BL2_EARLY_DCACHE
+/*
+ * Images are loaded and authenticated in data cache, flush them all before
+ * the next image is started, possibly with MMU and caches off.
+ */
+static void flush_loaded_images(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < bl_mem_params_desc_num; i++) {
+		image_info_t *image_info = &bl_mem_params_desc_ptr[i].image_info;
+
+		if (((image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING) != 0U) ||
+		    (image_info->image_size == 0U)) {
+			continue;
+		}
+
+		flush_dcache_range(image_info->image_base,
+				   image_info->image_size);
+	}
+}
+#endif
+
 void bl2_el3_plat_prepare_exit(void)
 {
 	uint16_t boot_itf = stm32mp_get_boot_itf_selected();
 
+	/* Images copied in background must be in place */
+	stm32mp_dma_memcpy_wait();
+
 	switch (boot_itf) {
 #if STM32MP_UART_PROGRAMMER || STM32MP_USB_PROGRAMMER
 	case BOOT_API_CTX_BOOT_INTERFACE_SEL_SERIAL_UART:
@@ -652,8 +936,51 @@ void bl2_el3_plat_prepare_exit(void)
 		break;
 	}
 
+#if STM32MP15
+	/* Next stages expect the LSE ready, as left by the clock init */
+	stm32mp1_clk_lse_wait_ready();
+#endif
+
+	/* Background image checks must be completed before leaving BL2 */
+	if (stm32mp1_bl2_smp_stop() != 0) {
+		ERROR("Deferred image authentication failed\n");
+		panic();
+	}
+
+	/* HW_CONFIG is checked, the images left to BL33 can be listed in it */
+	if (stm32mp_deferred_images_handoff() != 0) {
+		ERROR("Cannot list deferred images in HW_CONFIG\n");
+		panic();
+	}
+
+#if STM32MP13 && TRUSTED_BOARD_BOOT
+	/* All images are authenticated, release the PKA */
+	stm32_pka_ecdsa_verif_session_end();
+#if !defined(DECRYPTION_SUPPORT_none)
+	/* All images are decrypted, the key is not left to the next stages */
+	stm32mp_crypto_enc_key_wipe();
+#endif
+#endif
+
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA && !STM32MP_MEM_USAGE
+	mbedtls_heap_print_usage();
+#endif
+
+	stm32mp1_mem_usage_print();
+
+#if STM32MP_BL2_EARLY_DCACHE
+	flush_loaded_images();
+#endif
+
 	stm32mp1_security_setup();
 
 	/* end of boot mode */
 	stm32mp1_syscfg_boot_mode_disable();
+
+	stm32mp1_boot_trace_stop();
+
+	stm32mp_boot_timeline_mark(BOOT_TL_BL2_EXIT, 0U);
+	stm32mp_boot_timeline_dump();
+
+	stm32mp_log_ring_handoff();
 }
@@ -21,6 +21,10 @@
 #undef HW_CONFIG_ID
 #undef GPT_IMAGE_ID
 #undef ENC_IMAGE_ID
+#undef NT_FW_CONFIG_ID
+#undef SCP_BL2_IMAGE_ID
+#undef SCP_FW_KEY_CERT_ID
+#undef SCP_FW_CONTENT_CERT_ID
 
 /* Define the STM32MP1 used ID */
 #define FW_CONFIG_ID			U(1)
@@ -33,8 +37,14 @@
 #define BKUP_FWU_METADATA_IMAGE_ID	U(13)
 #define TOS_FW_CONFIG_ID		U(16)
 #define STM32MP_CONFIG_CERT_ID		U(17)
+#define NT_FW_CONFIG_ID			U(18)
+
+/* M4 firmware, packed and authenticated as the SCP firmware */
+#define SCP_BL2_IMAGE_ID		U(19)
+#define SCP_FW_KEY_CERT_ID		U(20)
+#define SCP_FW_CONTENT_CERT_ID		U(21)
 
 /* Increase the MAX_NUMBER_IDS to match the authentication pool required */
-#define MAX_NUMBER_IDS			U(19)
+#define MAX_NUMBER_IDS			U(22)
 
 #endif	/* STM32MP1_IMG_DEF_H */
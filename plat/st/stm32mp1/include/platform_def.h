@@ -44,6 +44,9 @@
 #define MAX_IO_BLOCK_DEVICES		U(1)
 #define MAX_IO_MTD_DEVICES		U(1)
 
+/* Read-ahead window of the SPI-NOR, for the small reads of FIP and certs */
+#define SPI_NOR_READ_CACHE_SIZE		U(0x1000)
+
 /*******************************************************************************
  * BL2 specific defines.
  ******************************************************************************/
@@ -89,6 +92,20 @@
 /* Needed by STM32CubeProgrammer support */
 #define DWL_BUFFER_SIZE			U(0x01000000)
 
+/* Chunk and workspace to inflate images while loaded, above download buffer */
+#define STM32MP_DECOMPRESS_BUF_BASE	(DWL_BUFFER_BASE + DWL_BUFFER_SIZE)
+#define STM32MP_DECOMPRESS_BUF_SIZE	U(0x00020000)
+
+/* SD/eMMC io_block buffer once DDR is initialised, above decompression one */
+#define STM32MP_MMC_DDR_BUFFER_BASE	(STM32MP_DECOMPRESS_BUF_BASE + \
+					 STM32MP_DECOMPRESS_BUF_SIZE)
+#define STM32MP_MMC_DDR_BUFFER_SIZE	(U(STM32MP_MMC_DDR_BUFFER_KB) * U(1024))
+
+/* Index of the DT an overlay is applied to, above SD/eMMC buffer */
+#define STM32MP_DT_OVERLAY_BUF_BASE	(STM32MP_MMC_DDR_BUFFER_BASE + \
+					 STM32MP_MMC_DDR_BUFFER_SIZE)
+#define STM32MP_DT_OVERLAY_BUF_SIZE	U(0x00010000)
+
 /*
  * SSBL offset in case it's stored in eMMC boot partition.
  * We can fix it to 256K because TF-A size can't be bigger than SRAM
@@ -136,11 +153,25 @@
 #define ARM_IRQ_SEC_SGI_6		U(14)
 #define ARM_IRQ_SEC_SGI_7		U(15)
 
-/* Platform IRQ Priority */
+/*
+ * Platform IRQ Priority
+ * The IWDG pre-timeout is acknowledged before the calibration and RCC wakeup
+ * interrupts when they are pending together.
+ */
+#define STM32MP_IRQ_SEC_CRITICAL_PRIO	U(0x4)
 #define STM32MP1_IRQ_RCC_SEC_PRIO	U(0x6)
 #define STM32MP_IRQ_SEC_SPI_PRIO	U(0x10)
+#define STM32MP_IRQ_SEC_TIMER_PRIO	U(0x10)
+#define STM32MP_IRQ_SEC_DEFERRED_PRIO	U(0x70)
+
+/* SGI running the work deferred by the secure interrupt handlers */
+#define STM32MP_IRQ_SEC_DEFERRED_WORK	ARM_IRQ_SEC_SGI_7
 
 #define STM32MP1_IRQ_TZC400		U(36)
+#define STM32MP1_IRQ_I2C4_EV		U(127)
+#define STM32MP1_IRQ_I2C4_ER		U(128)
+#define STM32MP1_IRQ_I2C6_EV		U(167)
+#define STM32MP1_IRQ_I2C6_ER		U(168)
 #define STM32MP1_IRQ_MCU_SEV		U(176)
 #define STM32MP1_IRQ_RCC_WAKEUP		U(177)
 #define STM32MP1_IRQ_IWDG1		U(182)
@@ -155,7 +186,7 @@
  */
 #define PLATFORM_G1S_PROPS(grp) \
 	INTR_PROP_DESC(ARM_IRQ_SEC_PHY_TIMER,		\
-		       GIC_HIGHEST_SEC_PRIORITY,	\
+		       STM32MP_IRQ_SEC_TIMER_PRIO,	\
 		       grp, GIC_INTR_CFG_LEVEL),	\
 	INTR_PROP_DESC(STM32MP1_IRQ_AXIERRIRQ,		\
 		       GIC_HIGHEST_SEC_PRIORITY,	\
@@ -178,8 +209,8 @@
 	INTR_PROP_DESC(ARM_IRQ_SEC_SGI_5,		\
 		       GIC_HIGHEST_SEC_PRIORITY,	\
 		       grp, GIC_INTR_CFG_EDGE),		\
-	INTR_PROP_DESC(ARM_IRQ_SEC_SGI_7,		\
-		       GIC_HIGHEST_SEC_PRIORITY,	\
+	INTR_PROP_DESC(STM32MP_IRQ_SEC_DEFERRED_WORK,	\
+		       STM32MP_IRQ_SEC_DEFERRED_PRIO,	\
 		       grp, GIC_INTR_CFG_EDGE)
 
 #define PLATFORM_G0_PROPS(grp) \
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2015-2022, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,7 +9,8 @@
 /*
  * Key algorithms currently supported on mbed TLS libraries
  */
-#define TF_MBEDTLS_USE_RSA	0
+/* RSA object identifiers are parsed when the PKA verifies RSA signatures */
+#define TF_MBEDTLS_USE_RSA	PKA_USE_RSA
 #define TF_MBEDTLS_USE_ECDSA	1
 
 /*
@@ -69,6 +70,13 @@
 #define MBEDTLS_SHA512_C
 #endif
 
+#if TF_MBEDTLS_SHA_NEON
+#define MBEDTLS_SHA256_PROCESS_ALT
+#if (TF_MBEDTLS_HASH_ALG_ID != TF_MBEDTLS_SHA256)
+#define MBEDTLS_SHA512_PROCESS_ALT
+#endif
+#endif
+
 #define MBEDTLS_VERSION_C
 
 #define MBEDTLS_X509_USE_C
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_BL2_SMP_H
+#define STM32MP1_BL2_SMP_H
+
+#define STM32MP1_BL2_SMP_STACK_SIZE	0x800
+#define STM32MP1_BL2_SMP_QUEUE_SIZE	4U
+
+#ifndef __ASSEMBLER__
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+#if STM32MP_BL2_SMP
+/*
+ * Secondary core helper for BL2: jobs queued by core 0 are executed in order
+ * on core 1 while core 0 goes on with the boot.
+ */
+void stm32mp1_bl2_smp_set_image(unsigned int image_id);
+bool stm32mp1_bl2_smp_image_deferrable(void);
+void stm32mp1_bl2_smp_reserve(void);
+int stm32mp1_bl2_smp_run(int (*job)(void *arg), void *arg);
+bool stm32mp1_bl2_smp_pending(void);
+int stm32mp1_bl2_smp_wait(void);
+int stm32mp1_bl2_smp_stop(void);
+
+void stm32mp1_bl2_smp_entrypoint(void);
+void __dead2 stm32mp1_bl2_smp_power_down(uintptr_t rcc_base);
+#else
+static inline void stm32mp1_bl2_smp_set_image(unsigned int image_id)
+{
+}
+
+static inline bool stm32mp1_bl2_smp_image_deferrable(void)
+{
+	return false;
+}
+
+static inline void stm32mp1_bl2_smp_reserve(void)
+{
+}
+
+static inline int stm32mp1_bl2_smp_run(int (*job)(void *arg), void *arg)
+{
+	return -ENOTSUP;
+}
+
+static inline bool stm32mp1_bl2_smp_pending(void)
+{
+	return false;
+}
+
+static inline int stm32mp1_bl2_smp_wait(void)
+{
+	return 0;
+}
+
+static inline int stm32mp1_bl2_smp_stop(void)
+{
+	return 0;
+}
+#endif /* STM32MP_BL2_SMP */
+#endif /* __ASSEMBLER__ */
+
+#endif /* STM32MP1_BL2_SMP_H */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_BOOT_TRACE_H
+#define STM32MP1_BOOT_TRACE_H
+
+#include <stdint.h>
+
+#define BOOT_TRACE_MAGIC		0x43525442U	/* "BTRC" */
+
+/* Header flags */
+#define BOOT_TRACE_WRAPPED		0x1U	/* Oldest trace overwritten */
+
+/*
+ * Layout of the dumps stored at the end of the DDR, BL2 one in the first
+ * half of STM32MP_BOOT_TRACE_SIZE and SP_min one in the second half. data[]
+ * holds size bytes of formatted CoreSight trace, as drained from the ETF,
+ * with the ETMv3.5 stream of trace_id.
+ */
+struct stm32mp1_boot_trace {
+	uint32_t magic;
+	uint32_t image;
+	uint32_t trace_id;
+	uint32_t flags;
+	uint32_t size;
+	uint32_t reserved[3];
+	uint32_t data[];
+};
+
+#if STM32MP_BOOT_TRACE
+void stm32mp1_boot_trace_start(void);
+void stm32mp1_boot_trace_stop(void);
+int stm32mp1_boot_trace_dt_fixup(void);
+#else
+static inline void stm32mp1_boot_trace_start(void)
+{
+}
+
+static inline void stm32mp1_boot_trace_stop(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_BOOT_TRACE_H */
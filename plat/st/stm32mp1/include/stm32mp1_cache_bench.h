@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_CACHE_BENCH_H
+#define STM32MP1_CACHE_BENCH_H
+
+#if STM32MP_CACHE_BENCH
+/*
+ * Measure the flush of growing dirty DDR buffers by MVA and by set/way, to
+ * tune STM32MP_BL2_DCACHE_SW_KB. The buffers are at BL33 base address, up to
+ * 4MB are overwritten.
+ */
+void stm32mp1_cache_bench(void);
+#else
+static inline void stm32mp1_cache_bench(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_CACHE_BENCH_H */
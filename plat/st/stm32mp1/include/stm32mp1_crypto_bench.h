@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_CRYPTO_BENCH_H
+#define STM32MP1_CRYPTO_BENCH_H
+
+#if STM32MP_CRYPTO_BENCH
+/*
+ * Measure the SHA-256, AES-128 and ECDSA P-256 throughput of the crypto
+ * peripherals, or of the ROM services, against the mbedTLS implementations.
+ * The first 64KB of the BL33 area are overwritten.
+ */
+void stm32mp1_crypto_bench(void);
+#else
+static inline void stm32mp1_crypto_bench(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_CRYPTO_BENCH_H */
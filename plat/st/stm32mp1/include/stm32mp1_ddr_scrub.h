@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_DDR_SCRUB_H
+#define STM32MP1_DDR_SCRUB_H
+
+#include <stdint.h>
+
+/*
+ * struct stm32mp1_ddr_scrub_status - Background DDR test progress
+ * @offset: Next offset to test from the DDR base, in bytes
+ * @passes: Number of complete passes over the DDR, modulo 65536
+ * @errors: Number of failing words, saturated at UINT16_MAX
+ * @first_fail: Address of the first failing word, 0 if none
+ */
+struct stm32mp1_ddr_scrub_status {
+	uint32_t offset;
+	uint32_t passes;
+	uint32_t errors;
+	uint32_t first_fail;
+};
+
+#if STM32MP_DDR_SCRUB
+void stm32mp1_ddr_scrub_init(void);
+void stm32mp1_ddr_scrub_cpu_idle(void);
+void stm32mp1_ddr_scrub_cpu_busy(void);
+void stm32mp1_ddr_scrub_get(struct stm32mp1_ddr_scrub_status *status);
+void stm32mp1_ddr_scrub_clear(void);
+#else
+static inline void stm32mp1_ddr_scrub_init(void)
+{
+}
+
+static inline void stm32mp1_ddr_scrub_cpu_idle(void)
+{
+}
+
+static inline void stm32mp1_ddr_scrub_cpu_busy(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_DDR_SCRUB_H */
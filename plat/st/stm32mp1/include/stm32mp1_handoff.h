@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_HANDOFF_H
+#define STM32MP1_HANDOFF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <drivers/st/stm32mp1_clk.h>
+
+#define STM32MP1_HANDOFF_MAGIC		U(0x48414E44) /* "HAND" */
+#define STM32MP1_HANDOFF_VERSION	U(1)
+
+/*
+ * Platform settings resolved by BL2 on cold boot, passed to SP_min in arg3
+ * so that it does not compute them again. The structure lives in BL2 memory
+ * and is copied by SP_min in its early setup, as the BL33 entry point.
+ * @cpu_voltage_mv: CPU supply voltage the PLL1 settings were computed for,
+ *	0 without PMIC
+ * @pll1_settings: PLL1 settings of each OPP of the DT, in clock driver
+ *	format
+ */
+struct stm32mp1_handoff {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;
+	uint32_t cpu_voltage_mv;
+	uint8_t pll1_settings[PLL1_SETTINGS_SIZE];
+};
+
+#if STM32MP_BL2_HANDOFF
+uintptr_t stm32mp1_handoff_prepare(void);
+void stm32mp1_handoff_init(uintptr_t addr);
+bool stm32mp1_handoff_load_pll1_settings(uint32_t cpu_voltage_mv);
+#else
+static inline uintptr_t stm32mp1_handoff_prepare(void)
+{
+	return 0U;
+}
+
+static inline void stm32mp1_handoff_init(uintptr_t addr)
+{
+}
+
+static inline bool stm32mp1_handoff_load_pll1_settings(uint32_t cpu_voltage_mv)
+{
+	return false;
+}
+#endif
+
+#endif /* STM32MP1_HANDOFF_H */
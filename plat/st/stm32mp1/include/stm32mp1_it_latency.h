@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_IT_LATENCY_H
+#define STM32MP1_IT_LATENCY_H
+
+#include <stdint.h>
+
+/*
+ * struct stm32mp1_it_latency_stats - Secure timer interrupt latency
+ * @count: Number of measured interrupts
+ * @min: Shortest latency, in system counter ticks
+ * @max: Longest latency, in system counter ticks
+ * @avg: Average latency, in system counter ticks
+ */
+struct stm32mp1_it_latency_stats {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint32_t avg;
+};
+
+#if STM32MP_IT_LATENCY
+void stm32mp1_it_latency_init(void);
+int stm32mp1_it_latency_start(uint32_t period_us);
+void stm32mp1_it_latency_stop(void);
+void stm32mp1_it_latency_get(struct stm32mp1_it_latency_stats *stats);
+int stm32mp1_it_latency_hist(unsigned int bucket, uint32_t *count);
+#else
+static inline void stm32mp1_it_latency_init(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_IT_LATENCY_H */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_LP_GOVERNOR_H
+#define STM32MP1_LP_GOVERNOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* No wake-up deadline known */
+#define LP_GOV_NO_DEADLINE		UINT64_MAX
+
+#if STM32MP_LP_GOVERNOR
+uint64_t stm32mp1_lp_governor_get_deadline_us(void);
+bool stm32mp1_lp_governor_fits(uint32_t mode, uint64_t deadline_us);
+void stm32mp1_lp_governor_enter(uint32_t mode);
+void stm32mp1_lp_governor_sleep(void);
+void stm32mp1_lp_governor_wakeup(void);
+void stm32mp1_lp_governor_stgen_restore_start(void);
+void stm32mp1_lp_governor_stgen_restore_end(void);
+void stm32mp1_lp_governor_exit(void);
+#else
+static inline uint64_t stm32mp1_lp_governor_get_deadline_us(void)
+{
+	return LP_GOV_NO_DEADLINE;
+}
+
+static inline bool stm32mp1_lp_governor_fits(uint32_t mode,
+					     uint64_t deadline_us)
+{
+	return true;
+}
+
+static inline void stm32mp1_lp_governor_enter(uint32_t mode)
+{
+}
+
+static inline void stm32mp1_lp_governor_sleep(void)
+{
+}
+
+static inline void stm32mp1_lp_governor_wakeup(void)
+{
+}
+
+static inline void stm32mp1_lp_governor_stgen_restore_start(void)
+{
+}
+
+static inline void stm32mp1_lp_governor_stgen_restore_end(void)
+{
+}
+
+static inline void stm32mp1_lp_governor_exit(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_LP_GOVERNOR_H */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_LP_TIMELINE_H
+#define STM32MP1_LP_TIMELINE_H
+
+#include <stdint.h>
+
+/*
+ * Low power entry and exit steps, each marked when the step ends. Values
+ * are reported through the STM32_SMC_LP_TIMELINE SiP call and must not be
+ * renumbered.
+ *
+ * The system counter is restored with the low power mode duration when
+ * exiting, which is then accounted in LP_TL_STGEN_RESTORE for Stop modes
+ * and in LP_TL_STANDBY_RESUME, which also covers the BL2 boot, for Standby.
+ */
+#define LP_TL_ENTER_START		0U
+#define LP_TL_IO_COMP_DISABLE		1U
+#define LP_TL_CONTEXT_CLEAN		2U
+#define LP_TL_PMIC_SUSPEND		3U
+#define LP_TL_CLOCK_SAVE		4U
+#define LP_TL_CONTEXT_SAVE		5U
+#define LP_TL_DDR_SR_ENTRY		6U
+#define LP_TL_WAKEUP			7U
+#define LP_TL_DDR_SR_EXIT		8U
+#define LP_TL_EXIT_START		9U
+#define LP_TL_STGEN_RESTORE		10U
+#define LP_TL_CLOCK_RESUME		11U
+#define LP_TL_REGUL_RESUME		12U
+#define LP_TL_EXIT_END			13U
+#define LP_TL_STANDBY_RESUME		14U
+#define LP_TL_STEP_NB			15U
+
+#if STM32MP_LP_TIMELINE
+void stm32mp1_lp_timeline_start(uint32_t mode);
+void stm32mp1_lp_timeline_mark(unsigned int step);
+void stm32mp1_lp_timeline_end(unsigned int step);
+int stm32mp1_lp_timeline_get(unsigned int cycle, unsigned int step,
+			     uint32_t *duration_us, uint32_t *mode);
+#else
+static inline void stm32mp1_lp_timeline_start(uint32_t mode)
+{
+}
+
+static inline void stm32mp1_lp_timeline_mark(unsigned int step)
+{
+}
+
+static inline void stm32mp1_lp_timeline_end(unsigned int step)
+{
+}
+#endif
+
+#endif /* STM32MP1_LP_TIMELINE_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_MCE_BENCH_H
+#define STM32MP1_MCE_BENCH_H
+
+#if STM32MP_MCE_BENCH
+/*
+ * Measure the DDR write and read throughput through the first MCE region,
+ * in each encryption mode, then restore the MCE regions saved in context.
+ * The first MB of the region is overwritten.
+ */
+void stm32mp1_mce_bench(void);
+#else
+static inline void stm32mp1_mce_bench(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_MCE_BENCH_H */
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_MEM_BENCH_H
+#define STM32MP1_MEM_BENCH_H
+
+#if STM32MP_MEM_BENCH
+/*
+ * Measure the read, write and copy bandwidths and the load latency of the
+ * DDR and of the internal RAMs, with the memory attributes they can be
+ * mapped with. The first 4MB of DDR are overwritten, the DDR must be mapped
+ * and not hold any data.
+ */
+void stm32mp1_mem_bench(void);
+#else
+static inline void stm32mp1_mem_bench(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_MEM_BENCH_H */
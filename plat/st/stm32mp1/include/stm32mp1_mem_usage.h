@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_MEM_USAGE_H
+#define STM32MP1_MEM_USAGE_H
+
+#include <stdint.h>
+
+#if STM32MP_MEM_USAGE
+void stm32mp1_mem_usage_paint_stacks(void);
+void stm32mp1_mem_usage_print(void);
+int stm32mp1_mem_usage_get(unsigned int id, unsigned int index,
+			   uint32_t *max_used, uint32_t *size);
+#else
+static inline void stm32mp1_mem_usage_paint_stacks(void)
+{
+}
+
+static inline void stm32mp1_mem_usage_print(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_MEM_USAGE_H */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_PERF_SNAPSHOT_H
+#define STM32MP1_PERF_SNAPSHOT_H
+
+#include <stdint.h>
+
+/*
+ * struct stm32mp1_perf_snapshot - Last counters snapshot of a CPU
+ * @timestamp: System counter value, the time base of the PSCI statistics
+ * @cycles: PMU cycle counter value
+ * @flags: PMU cycle counter state (STM32_SMC_PERF_SNAPSHOT_xxx flags)
+ * @seq: Number of snapshots taken by the CPU
+ */
+struct stm32mp1_perf_snapshot {
+	uint64_t timestamp;
+	uint32_t cycles;
+	uint32_t flags;
+	uint32_t seq;
+};
+
+void stm32mp1_perf_snapshot_capture(void);
+int stm32mp1_perf_snapshot_get(unsigned int core,
+			       struct stm32mp1_perf_snapshot *snapshot);
+
+#endif /* STM32MP1_PERF_SNAPSHOT_H */
@@ -7,6 +7,7 @@
 #ifndef STM32MP1_PRIVATE_H
 #define STM32MP1_PRIVATE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <drivers/st/etzpc.h>
@@ -24,6 +25,7 @@ bool stm32mp1_is_wakeup_from_standby(void);
 
 #if defined(IMAGE_BL32)
 enum etzpc_decprot_attributes stm32mp_etzpc_binding2decprot(uint32_t mode);
+int stm32mp1_i2c_get_irqs(uintptr_t base, int *irq_event, int *irq_error);
 #endif
 
 void stm32mp1_syscfg_init(void);
@@ -44,6 +46,22 @@ static inline void stm32mp1_syscfg_boot_mode_disable(void){}
 void stm32mp1_deconfigure_uart_pins(void);
 
 void stm32mp1_init_scmi_server(void);
+#if STM32MP_SCMI_DELAYED_RESP
+bool stm32mp1_scmi_it_handler(uint32_t id);
+#else
+static inline bool stm32mp1_scmi_it_handler(uint32_t id)
+{
+	return false;
+}
+#endif
+#if STM32MP_SCMI_M4_AGENT
+bool stm32mp1_scmi_m4_it_handler(void);
+#else
+static inline bool stm32mp1_scmi_m4_it_handler(void)
+{
+	return false;
+}
+#endif
 void stm32mp1_pm_save_scmi_state(uint8_t *state, size_t size);
 void stm32mp1_pm_restore_scmi_state(uint8_t *state, size_t size);
 
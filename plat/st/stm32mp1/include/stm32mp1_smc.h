@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2016-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,6 +59,15 @@
  * Argument a2: (input) OTP index
  *		(output) OTP read value, if applicable
  * Argument a3: (input) OTP value if applicable
+ *
+ * With STM32_SMC_READ_SHADOW_MULTI and STM32_SMC_READ_OTP_MULTI:
+ * Argument a2: (input) First OTP index
+ * Argument a3: (input) Number of OTPs, up to STM32_SMC_BSEC_MULTI_MAX
+ * Arguments a1 to a6: (output) OTP read values, 0 past the requested ones
+ *
+ * With STM32MP_SIP_RESUMABLE, STM32_SMC_WRITE_ALL returns
+ * STM32_SMC_INTERRUPTED on a pending non-secure interrupt: issue the same
+ * call again, with the same buffer, to resume it from the next OTP.
  */
 #define STM32_SMC_BSEC			0x82001003
 
@@ -82,6 +91,159 @@
  */
 #define STM32_SMC_AUTO_STOP		0x8200100a
 
+/*
+ * STM32_SMC_SVC_STATS call API, with STM32MP_SIP_SVC_STATS
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_SVC_STATS_xxx)
+ *		(output) Read value, if applicable
+ * Argument a2: (input) Queried STM32 SiP function ID
+ * Argument a3: (input) Histogram bucket index, if applicable
+ */
+#define STM32_SMC_SVC_STATS		0x82001010
+
+/*
+ * STM32_SMC_PSCI_STAT_HIST call API, with ENABLE_PSCI_STAT_HISTOGRAM
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Target CPU MPIDR
+ *		(output) Count of the histogram bucket
+ * Argument a2: (input) CPU_SUSPEND power_state of the queried CPU state
+ * Argument a3: (input) Histogram ID and bucket index, formatted with
+ *		STM32_SMC_PSCI_STAT_HIST_ARG()
+ */
+#define STM32_SMC_PSCI_STAT_HIST	0x82001011
+
+/*
+ * STM32_SMC_LP_TIMELINE call API, with STM32MP_LP_TIMELINE
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Low power cycle index, 0 for the last one
+ *		(output) Step duration in microseconds
+ * Argument a2: (input) Step ID (LP_TL_xxx)
+ *		(output) Low power mode of the cycle (STM32_PM_xxx)
+ */
+#define STM32_SMC_LP_TIMELINE		0x82001012
+
+/*
+ * STM32_SMC_PERF_SNAPSHOT call API, with STM32MP_PERF_SNAPSHOT
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_PERF_SNAPSHOT_xxx)
+ *		(output) System counter value, low 32 bits
+ * Argument a2: (input) Queried CPU index, for STM32_SMC_PERF_SNAPSHOT_READ
+ *		(output) System counter value, high 32 bits
+ * Argument a3: (output) PMU cycle counter value
+ * Argument a4: (output) Cycle counter flags (STM32_SMC_PERF_SNAPSHOT_xxx)
+ * Argument a5: (output) Number of snapshots taken by the CPU
+ */
+#define STM32_SMC_PERF_SNAPSHOT		0x82001013
+
+/*
+ * STM32_SMC_DDR_FREQ call API, with STM32MP_DDR_FREQ_SCALING
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_DDR_FREQ_SET/GET)
+ *		(output) DDR frequency mode (STM32_SMC_DDR_FREQ_xxx)
+ * Argument a2: (input) DDR frequency mode to set
+ *		(output) DDR clock frequency in kHz
+ */
+#define STM32_SMC_DDR_FREQ		0x82001014
+
+/*
+ * STM32_SMC_DDR_QOS call API, with STM32MP_DDR_QOS_PROFILES
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_DDR_QOS_SET/GET)
+ *		(output) Current profile index, number of profiles if the
+ *		DDRCTRL settings match none of them
+ * Argument a2: (input) Profile index to set, 0 for the boot settings
+ *		(output) Number of profiles
+ *
+ * With STM32MP_SIP_RESUMABLE, STM32_SMC_DDR_QOS_SET may return
+ * STM32_SMC_INTERRUPTED: issue the same call again to complete it.
+ */
+#define STM32_SMC_DDR_QOS		0x82001015
+
+/*
+ * STM32_SMC_REG_BATCH call API, with STM32MP_SIP_REG_BATCH
+ * Executes a list of STM32_SMC_RCC and STM32_SMC_PWR register accesses,
+ * entries of 4 words: operation (STM32_SMC_REG_BATCH_OP()), register offset,
+ * value and mask of the bits to access. No access is done if an entry is
+ * invalid.
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Physical address of the list, in non-secure DDR
+ *		(output) Number of entries executed
+ * Argument a2: (input) Number of entries, up to STM32_SMC_REG_BATCH_MAX
+ */
+#define STM32_SMC_REG_BATCH		0x82001016
+
+/*
+ * STM32_SMC_SCMI_STATS call API, with STM32MP_SCMI_STATS
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_SCMI_STATS_xxx)
+ *		(output) Number of messages, or of busy channel collisions
+ * Argument a2: (input) Agent, protocol and message IDs, formatted with
+ *		STM32_SMC_SCMI_STATS_MSG(), only the agent ID for busy count
+ *		(output) Longest message processing, in system counter ticks
+ * Argument a3: (output) Cumulated processing time, low 32 bits
+ * Argument a4: (output) Cumulated processing time, high 32 bits
+ */
+#define STM32_SMC_SCMI_STATS		0x82001017
+
+/*
+ * STM32_SMC_MEM_USAGE call API, with STM32MP_MEM_USAGE
+ * High-water marks of the SP_MIN memory resources since its cold boot.
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Resource ID (STM32_SMC_MEM_USAGE_xxx)
+ *		(output) Most of the resource used at once
+ * Argument a2: (input) Queried CPU index, for STM32_SMC_MEM_USAGE_STACK
+ *		(output) Size of the resource
+ */
+#define STM32_SMC_MEM_USAGE		0x82001018
+
+/*
+ * STM32_SMC_DDR_SCRUB call API, with STM32MP_DDR_SCRUB
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_DDR_SCRUB_xxx)
+ *		(output) Next DDR offset to test, in bytes
+ * Argument a2: (output) Number of complete passes, modulo 65536
+ * Argument a3: (output) Number of failing words
+ * Argument a4: (output) Address of the first failing word, 0 if none
+ */
+#define STM32_SMC_DDR_SCRUB		0x82001019
+
+/*
+ * STM32_SMC_IT_LATENCY call API, with STM32MP_IT_LATENCY
+ * Latency of a periodic secure timer interrupt, from its expiry to its
+ * handler, in system counter ticks. The timer runs on the calling CPU.
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) Service ID (STM32_SMC_IT_LATENCY_xxx)
+ *		(output) Number of interrupts, or of interrupts in the bucket
+ * Argument a2: (input) Period in microseconds, for STM32_SMC_IT_LATENCY_START
+ *		Histogram bucket index, for STM32_SMC_IT_LATENCY_HIST
+ *		(output) Minimum latency, for STM32_SMC_IT_LATENCY_READ
+ * Argument a3: (output) Maximum latency, for STM32_SMC_IT_LATENCY_READ
+ * Argument a4: (output) Average latency, for STM32_SMC_IT_LATENCY_READ
+ */
+#define STM32_SMC_IT_LATENCY		0x8200101a
+
 /*
  * STM32_SIP_SMC_SCMI_AGENT0
  * STM32_SIP_SMC_SCMI_AGENT1
@@ -92,6 +254,24 @@
 #define STM32_SIP_SMC_SCMI_AGENT0	0x82002000
 #define STM32_SIP_SMC_SCMI_AGENT1	0x82002001
 
+/*
+ * STM32_SIP_SMC_SCMI_REGS_AGENT0
+ * STM32_SIP_SMC_SCMI_REGS_AGENT1
+ * Process an SCMI message passed in registers, without shared memory. Only
+ * CLOCK_RATE_GET and PERFORMANCE_LEVEL_GET/SET messages are supported.
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) SCMI message header (message, protocol and token)
+ *		(output) SCMI status of the response
+ * Argument a2: (input) First word of the message payload
+ *		(output) Second word of the response payload, if any
+ * Argument a3: (input) Second word of the message payload, if any
+ *		(output) Third word of the response payload, if any
+ */
+#define STM32_SIP_SMC_SCMI_REGS_AGENT0	0x82002002
+#define STM32_SIP_SMC_SCMI_REGS_AGENT1	0x82002003
+
 /* SMC function IDs for SiP Service queries */
 #define STM32_SIP_SVC_CALL_COUNT	0x8200ff00
 #define STM32_SIP_SVC_UID		0x8200ff01
@@ -103,7 +283,17 @@
 #define STM32_SIP_SVC_VERSION_MINOR	0x1
 
 /* Number of STM32 SiP Calls implemented */
-#define STM32_COMMON_SIP_NUM_CALLS	9
+#define STM32_COMMON_SIP_NUM_CALLS	(11 + STM32MP_SIP_SVC_STATS + \
+					 ENABLE_PSCI_STAT_HISTOGRAM + \
+					 STM32MP_LP_TIMELINE + \
+					 STM32MP_PERF_SNAPSHOT + \
+					 STM32MP_DDR_FREQ_SCALING + \
+					 STM32MP_DDR_QOS_PROFILES + \
+					 STM32MP_SIP_REG_BATCH + \
+					 STM32MP_SCMI_STATS + \
+					 STM32MP_MEM_USAGE + \
+					 STM32MP_DDR_SCRUB + \
+					 STM32MP_IT_LATENCY)
 
 /* Service ID for STM32_SMC_RCC/_PWR */
 #define STM32_SMC_REG_READ		0x0
@@ -111,6 +301,17 @@
 #define STM32_SMC_REG_SET		0x2
 #define STM32_SMC_REG_CLEAR		0x3
 
+/* Operation of a STM32_SMC_REG_BATCH entry: target and STM32_SMC_REG_xxx */
+#define STM32_SMC_REG_BATCH_RCC		0x0
+#define STM32_SMC_REG_BATCH_PWR		0x1
+
+#define STM32_SMC_REG_BATCH_OP(_target, _req)	(((_target) << 8) | (_req))
+#define STM32_SMC_REG_BATCH_TARGET(_op)		((_op) >> 8)
+#define STM32_SMC_REG_BATCH_REQ(_op)		((_op) & 0xFFU)
+
+/* Maximum number of entries of a STM32_SMC_REG_BATCH list */
+#define STM32_SMC_REG_BATCH_MAX		16U
+
 /* Service for BSEC */
 #define STM32_SMC_READ_SHADOW		0x01
 #define STM32_SMC_PROG_OTP		0x02
@@ -119,11 +320,86 @@
 #define STM32_SMC_READ_ALL		0x05
 #define STM32_SMC_WRITE_ALL		0x06
 #define STM32_SMC_WRLOCK_OTP		0x07
+#define STM32_SMC_READ_SHADOW_MULTI	0x08
+#define STM32_SMC_READ_OTP_MULTI	0x09
+
+/* Maximum number of OTPs returned by a BSEC multi-word read */
+#define STM32_SMC_BSEC_MULTI_MAX	6U
+
+/* Service for SiP statistics */
+#define STM32_SMC_SVC_STATS_COUNT	0x0
+#define STM32_SMC_SVC_STATS_HIST	0x1
+#define STM32_SMC_SVC_STATS_RESET	0x2
+
+/* Number of SiP call duration histogram buckets */
+#define STM32_SMC_SVC_STATS_BUCKETS	16U
+
+/* Histograms of a CPU low power state, each with 16 log2 buckets in us */
+#define STM32_SMC_PSCI_STAT_HIST_RESIDENCY	0x0
+#define STM32_SMC_PSCI_STAT_HIST_ENTRY_LATENCY	0x1
+#define STM32_SMC_PSCI_STAT_HIST_EXIT_LATENCY	0x2
+
+#define STM32_SMC_PSCI_STAT_HIST_ARG(_id, _bucket) \
+	(((_id) << 16) | ((_bucket) & 0xFFFFU))
+#define STM32_SMC_PSCI_STAT_HIST_ID(_arg)	((_arg) >> 16)
+#define STM32_SMC_PSCI_STAT_HIST_BUCKET(_arg)	((_arg) & 0xFFFFU)
+
+/* Service for counters snapshot */
+#define STM32_SMC_PERF_SNAPSHOT_CAPTURE		0x0
+#define STM32_SMC_PERF_SNAPSHOT_READ		0x1
+
+/* Cycle counter is enabled by the non-secure world */
+#define STM32_SMC_PERF_SNAPSHOT_CYCLES_ON	BIT_32(0)
+/* Cycle counter counts every 64 clock cycles */
+#define STM32_SMC_PERF_SNAPSHOT_CYCLES_DIV64	BIT_32(1)
+
+/* Service ID for STM32_SMC_DDR_FREQ */
+#define STM32_SMC_DDR_FREQ_SET		0x0
+#define STM32_SMC_DDR_FREQ_GET		0x1
+
+/* DDR frequency modes for STM32_SMC_DDR_FREQ */
+#define STM32_SMC_DDR_FREQ_NOMINAL	0x0
+#define STM32_SMC_DDR_FREQ_LOW		0x1
+
+/* Service ID for STM32_SMC_DDR_QOS */
+#define STM32_SMC_DDR_QOS_SET		0x0
+#define STM32_SMC_DDR_QOS_GET		0x1
+
+/* Service for SCMI message statistics */
+#define STM32_SMC_SCMI_STATS_READ	0x0
+#define STM32_SMC_SCMI_STATS_BUSY	0x1
+#define STM32_SMC_SCMI_STATS_RESET	0x2
+#define STM32_SMC_SCMI_STATS_DUMP	0x3
+
+#define STM32_SMC_SCMI_STATS_MSG(_agent, _prot, _msg) \
+	(((_agent) << 16) | (((_prot) & 0xFFU) << 8) | ((_msg) & 0xFFU))
+#define STM32_SMC_SCMI_STATS_AGENT(_arg)	((_arg) >> 16)
+#define STM32_SMC_SCMI_STATS_PROT(_arg)		(((_arg) >> 8) & 0xFFU)
+#define STM32_SMC_SCMI_STATS_MSG_ID(_arg)	((_arg) & 0xFFU)
+
+/* Resource ID for STM32_SMC_MEM_USAGE, sizes in bytes or in tables */
+#define STM32_SMC_MEM_USAGE_STACK	0x0
+#define STM32_SMC_MEM_USAGE_XLAT_TABLES	0x1
+
+/* Service ID for STM32_SMC_DDR_SCRUB */
+#define STM32_SMC_DDR_SCRUB_READ	0x0
+#define STM32_SMC_DDR_SCRUB_CLEAR	0x1
+
+/* Service ID for STM32_SMC_IT_LATENCY */
+#define STM32_SMC_IT_LATENCY_START	0x0
+#define STM32_SMC_IT_LATENCY_STOP	0x1
+#define STM32_SMC_IT_LATENCY_READ	0x2
+#define STM32_SMC_IT_LATENCY_HIST	0x3
+
+/* Number of interrupt latency histogram buckets */
+#define STM32_SMC_IT_LATENCY_BUCKETS	16U
 
 /* SMC error codes */
 #define STM32_SMC_OK			0x00000000U
 #define STM32_SMC_NOT_SUPPORTED		0xFFFFFFFFU
 #define STM32_SMC_FAILED		0xFFFFFFFEU
 #define STM32_SMC_INVALID_PARAMS	0xFFFFFFFDU
+/* Interrupted resumable call, to be issued again with the same arguments */
+#define STM32_SMC_INTERRUPTED		0xFFFFFFFCU
 
 #endif /* STM32MP1_SMC_H */
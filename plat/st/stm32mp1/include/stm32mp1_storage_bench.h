@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP1_STORAGE_BENCH_H
+#define STM32MP1_STORAGE_BENCH_H
+
+#if STM32MP_STORAGE_BENCH
+/*
+ * Measure the boot device reads, from the FIP offset, through the raw driver
+ * read and through io_storage (io_block or io_mtd, and io_fip for BL33).
+ * The buffers are at BL33 base address, up to 1MB is overwritten.
+ */
+void stm32mp1_storage_bench(void);
+#else
+static inline void stm32mp1_storage_bench(void)
+{
+}
+#endif
+
+#endif /* STM32MP1_STORAGE_BENCH_H */
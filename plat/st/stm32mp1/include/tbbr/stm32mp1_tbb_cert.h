@@ -13,7 +13,8 @@
  * Enumerate the certificates that are used to establish the chain of trust
  */
 enum {
-	STM32MP_CONFIG_CERT = FWU_CERT + 1
+	STM32MP_CONFIG_CERT = FWU_CERT + 1,
+	STM32MP_FIP_MANIFEST_CERT
 };
 
 #endif /* STM32MP1_TBB_CERT_H */
@@ -34,6 +34,25 @@ static bl_mem_params_node_t bl2_mem_params_descs[] = {
 
 		.next_handoff_image_id = INVALID_IMAGE_ID,
 	},
+#if STM32MP_M4_EARLY_BOOT
+	/*
+	 * Fill M4 firmware related information, loaded first in RETRAM
+	 * where the MCU boots from, to run while the next images are loaded.
+	 */
+	{
+		.image_id = SCP_BL2_IMAGE_ID,
+		SET_STATIC_PARAM_HEAD(ep_info, PARAM_IMAGE_BINARY,
+				      VERSION_2, entry_point_info_t,
+				      NON_SECURE | NON_EXECUTABLE),
+		SET_STATIC_PARAM_HEAD(image_info, PARAM_IMAGE_BINARY,
+				      VERSION_2, image_info_t, 0),
+
+		.image_info.image_base = RETRAM_BASE,
+		.image_info.image_max_size = RETRAM_SIZE,
+
+		.next_handoff_image_id = INVALID_IMAGE_ID,
+	},
+#endif
 
 	/* Fill BL32 related information */
 	{
@@ -132,7 +151,25 @@ static bl_mem_params_node_t bl2_mem_params_descs[] = {
 				      IMAGE_ATTRIB_SKIP_LOADING),
 
 		.next_handoff_image_id = INVALID_IMAGE_ID,
-	}
+	},
+#if STM32MP_DEFER_NT_FW_CONFIG
+	/*
+	 * Fill NT_FW_CONFIG related information if it exists, the image is
+	 * loaded by BL33 when needed, BL2 only authenticates its certificate.
+	 */
+	{
+		.image_id = NT_FW_CONFIG_ID,
+		SET_STATIC_PARAM_HEAD(ep_info, PARAM_IMAGE_BINARY,
+				      VERSION_2, entry_point_info_t,
+				      NON_SECURE | NON_EXECUTABLE),
+		SET_STATIC_PARAM_HEAD(image_info, PARAM_IMAGE_BINARY,
+				      VERSION_2, image_info_t,
+				      IMAGE_ATTRIB_SKIP_LOADING |
+				      IMAGE_ATTRIB_DEFERRED),
+
+		.next_handoff_image_id = INVALID_IMAGE_ID,
+	},
+#endif
 };
 
 REGISTER_BL_IMAGE_DESCS(bl2_mem_params_descs)
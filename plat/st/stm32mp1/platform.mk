@@ -9,6 +9,10 @@ ARM_WITH_NEON		:=	yes
 BL2_AT_EL3		:=	1
 USE_COHERENT_MEM	:=	0
 
+# Single cluster: cores are coherent as soon as their data cache is enabled
+WARMBOOT_ENABLE_DCACHE_EARLY :=	1
+PSCI_SINGLE_CLUSTER_LOCKS :=	1
+
 STM32MP_EARLY_CONSOLE	?=	0
 STM32MP_RECONFIGURE_CONSOLE ?=	0
 STM32MP_UART_BAUDRATE	?=	115200
@@ -21,6 +25,169 @@ VERSION_STRING		:=	v${VERSION_MAJOR}.${VERSION_MINOR}-${PLAT}-${ST_VERSION}(${BU
 TRUSTED_BOARD_BOOT	?=	0
 STM32MP_USE_EXTERNAL_HEAP ?=	0
 
+# Record boot timeline markers in non-secure SYSRAM
+STM32MP_BOOT_TIMELINE	?=	0
+
+# Trace BL2 and SP_MIN boot with the ETM in the ETF, dumped at the end of DDR
+STM32MP_BOOT_TRACE	?=	0
+
+# Run DDR march tests on cold boot, mask of the tests to run:
+# 0x1: walking ones, 0x2: checkerboard, 0x4: MATS+
+STM32MP_DDR_FULL_TEST	?=	0
+
+# Split the DDR march tests between both cores
+STM32MP_DDR_FULL_TEST_SMP ?=	0
+
+# Save DDR training results in Backup SRAM, restored on next cold boots
+STM32MP_DDR_TRAINING_CACHE ?=	0
+
+# Index DT compatible strings and phandles when the DT is opened
+STM32MP_DT_INDEX	?=	1
+
+# Apply the DT overlays of the board variant, listed in FW_CONFIG
+STM32MP_DT_VARIANTS	?=	0
+
+# Compute PLL1 settings of all OPPs in BL2 and pass them to SP_MIN
+STM32MP_BL2_HANDOFF	?=	0
+
+# Keep BL2 loaded images in data cache, flushed once before BL2 exits
+STM32MP_BL2_EARLY_DCACHE ?=	0
+BL2_DEFER_IMAGE_FLUSH	:=	${STM32MP_BL2_EARLY_DCACHE}
+
+# Size in KB from which BL2 flushes and invalidates the whole data cache by
+# set/way instead of by MVA (0: always by MVA)
+STM32MP_BL2_DCACHE_SW_KB ?=	0
+
+# Slicing-by-8 CRC32 for tf_crc32() users and slicing-by-4 for gzip data
+STM32MP_CRC32_SLICE8	?=	0
+ZLIB_CRC32_BYFOUR	:=	${STM32MP_CRC32_SLICE8}
+
+# Inflate gzip compressed BL33 and OP-TEE pager/pageable images while read
+STM32MP_DECOMPRESS_STREAM ?=	0
+IMAGE_DECOMPRESS_STREAM	:=	${STM32MP_DECOMPRESS_STREAM}
+
+# Use LZ4 frames instead of gzip for the images inflated while read
+STM32MP_DECOMPRESS_LZ4	?=	0
+
+# Compress the images inflated while read when they are added to the FIP
+ifeq (${STM32MP_DECOMPRESS_STREAM},1)
+ifeq (${STM32MP_DECOMPRESS_LZ4},1)
+STM32MP_COMPRESS_FILTER	:=	LZ4
+else
+STM32MP_COMPRESS_FILTER	:=	GZIP
+endif
+BL32_EXTRA1_PRE_TOOL_FILTER ?=	${STM32MP_COMPRESS_FILTER}
+BL32_EXTRA2_PRE_TOOL_FILTER ?=	${STM32MP_COMPRESS_FILTER}
+BL33_PRE_TOOL_FILTER	?=	${STM32MP_COMPRESS_FILTER}
+endif
+
+# Leave NT_FW_CONFIG to BL33, BL2 lists it with its hash in HW_CONFIG
+STM32MP_DEFER_NT_FW_CONFIG ?=	0
+
+# Check image hashes on the secondary core while BL2 loads next images
+STM32MP_BL2_SMP_CRYPTO	?=	0
+
+# With PSA_FWU_SUPPORT, boot the previous bank as soon as a trial boot ends
+# with a watchdog reset
+STM32MP_FWU_IWDG_FALLBACK ?=	0
+
+# BL2 secondary core helper, for the options using core 1
+ifneq ($(filter 1,${STM32MP_BL2_SMP_CRYPTO} ${STM32MP_DDR_FULL_TEST_SMP}),)
+STM32MP_BL2_SMP		:=	1
+else
+STM32MP_BL2_SMP		:=	0
+endif
+
+# Load the M4 firmware given as SCP_BL2 in RETRAM and start it from BL2
+STM32MP_M4_EARLY_BOOT	?=	0
+
+# Complete the SD/eMMC card identification while the DDR is initialised
+STM32MP_MMC_ASYNC_INIT	?=	0
+
+# Size in KB of the SD/eMMC block buffer moved to DDR once it is initialised
+# (0: only the 512 bytes buffer in SYSRAM)
+STM32MP_MMC_DDR_BUFFER_KB ?=	0
+
+# Write logs in per-CPU rings in non-secure SYSRAM, drained to the UART later
+STM32MP_LOG_RING	?=	0
+
+# Read random numbers ahead in a pool, refilled on RNG interrupt in SP_MIN
+STM32MP_RNG_POOL	?=	0
+
+# Defer asynchronous SCMI clock rate changes, posting delayed responses
+STM32MP_SCMI_DELAYED_RESP ?=	0
+
+# Serve a SCMI agent for the Cortex-M4, rung through IPCC and MCU SEV
+STM32MP_SCMI_M4_AGENT	?=	0
+
+# Count SCMI messages per agent, protocol and message, with their duration
+STM32MP_SCMI_STATS	?=	0
+
+# Execute a list of RCC and PWR register accesses in one SiP call, in SP_MIN
+STM32MP_SIP_REG_BATCH	?=	0
+
+# Return from long SiP calls on pending non-secure interrupts, to be resumed
+STM32MP_SIP_RESUMABLE	?=	0
+
+# Count STM32 SiP calls in SP_MIN, with a histogram of their durations
+STM32MP_SIP_SVC_STATS	?=	0
+
+# Record low power entry and exit steps duration in Backup SRAM, in SP_MIN
+STM32MP_LP_TIMELINE	?=	0
+
+# Select the system suspend mode from measured latencies and the next wake-up
+STM32MP_LP_GOVERNOR	?=	0
+
+# Snapshot the system and PMU cycle counters per CPU on SiP call, in SP_MIN
+STM32MP_PERF_SNAPSHOT	?=	0
+
+# Paint the stacks and report the memory resources high-water marks
+STM32MP_MEM_USAGE	?=	0
+
+# Switch the DDR to half its nominal frequency on SiP call, in SP_MIN
+STM32MP_DDR_FREQ_SCALING ?=	0
+
+# Switch between the DDRCTRL QoS profiles of the DT on SiP call, in SP_MIN
+STM32MP_DDR_QOS_PROFILES ?=	0
+
+# Test the DDR in the background, in slices of at most the given duration,
+# when all CPUs are idle in SP_MIN
+STM32MP_DDR_SCRUB	?=	0
+STM32MP_DDR_SCRUB_SLICE_US ?=	50
+
+# Measure the secure timer interrupt latency on SiP call, in SP_MIN
+STM32MP_IT_LATENCY	?=	0
+
+# Print the DDR throughput through the first MCE region, in each mode
+STM32MP_MCE_BENCH	?=	0
+
+# Print the data cache flush time by MVA and by set/way for growing sizes
+STM32MP_CACHE_BENCH	?=	0
+
+# Print the HASH, SAES and PKA throughput against mbedTLS, in BL2
+STM32MP_CRYPTO_BENCH	?=	0
+
+# Print the boot device read throughput, raw and through io_storage, in BL2
+STM32MP_STORAGE_BENCH	?=	0
+
+# Print the DDR and internal RAMs bandwidth and latency, per memory attribute
+STM32MP_MEM_BENCH	?=	0
+
+# Build the MDMA driver, for firmware transfers on secure channels
+STM32MP_MDMA		?=	0
+
+# Copy the images from the UART/USB download buffer with the MDMA
+STM32MP_DMA_MEMCPY	?=	0
+
+# Load the image extents stored on SPI-NOR while reading the SD/eMMC FIP
+STM32MP_STRIPED_LOAD	?=	0
+
+# Verify RSA signatures of the chain of trust with the PKA (STM32MP13)
+PKA_USE_RSA		?=	0
+
+# Authenticate all FIP images with the hashes of the STM32MP config certificate
+STM32MP_FIP_MANIFEST_CERT ?=	0
+
 # Please don't increment this value without good understanding of
 # the monotonic counter
 STM32_TF_VERSION	?=	0
@@ -91,6 +258,13 @@ ifeq ($(AARCH32_SP),sp_min)
 TF_CFLAGS		+=	-mfloat-abi=soft
 endif
 
+# Override the standard libc with optimised libc_asm
+OVERRIDE_LIBC		:=	1
+ifneq ($(AARCH32_SP),sp_min)
+LIBC_ASM_NEON		?=	1
+endif
+include lib/libc/libc_asm.mk
+
 TF_CFLAGS		+=	-Wsign-compare
 
 # Not needed for Cortex-A7
@@ -133,6 +307,12 @@ STM32MP_EMMC_BOOT	?=	0
 STM32MP_USB_PROGRAMMER	?=	0
 STM32MP_UART_PROGRAMMER	?=	0
 
+# Use the USB OTG buffer DMA mode instead of the FIFO accesses
+STM32MP_USB_DMA		?=	0
+
+# wTransferSize of the USB DFU descriptor, max block size of a DFU DNLOAD
+STM32MP_USB_DFU_XFER_SIZE ?=	1024
+
 # Download load address for serial boot devices
 DWL_BUFFER_BASE 	?=	0xC7000000
 
@@ -189,11 +369,24 @@ endif
 $(eval $(call TOOL_ADD_PAYLOAD,${STM32MP_FW_CONFIG},--fw-config))
 # Add the HW_CONFIG to FIP and specify the same to certtool
 $(eval $(call TOOL_ADD_PAYLOAD,${STM32MP_HW_CONFIG},--hw-config))
+ifeq (${STM32MP_DEFER_NT_FW_CONFIG},1)
+ifeq (${NT_FW_CONFIG},)
+$(error STM32MP_DEFER_NT_FW_CONFIG requires NT_FW_CONFIG to be set)
+endif
+# Add the NT_FW_CONFIG to FIP and specify the same to certtool
+$(eval $(call TOOL_ADD_PAYLOAD,${NT_FW_CONFIG},--nt-fw-config))
+endif
 ifeq ($(GENERATE_COT),1)
 STM32MP_CFG_CERT	:=	$(BUILD_PLAT)/stm32mp_cfg_cert.crt
+ifeq (${STM32MP_FIP_MANIFEST_CERT},1)
+# Add the STM32MP_CFG_CERT to FIP, certtool creates it with all image hashes
+FIP_ARGS		+=	--stm32mp-cfg-cert ${STM32MP_CFG_CERT}
+$(eval $(call CERT_ADD_CMD_OPT,${STM32MP_CFG_CERT},--stm32mp-fip-manifest-cert))
+else
 # Add the STM32MP_CFG_CERT to FIP and specify the same to certtool
 $(eval $(call TOOL_ADD_PAYLOAD,${STM32MP_CFG_CERT},--stm32mp-cfg-cert))
 endif
+endif
 ifeq ($(AARCH32_SP),sp_min)
 STM32MP_TOS_FW_CONFIG	:= $(addprefix ${BUILD_PLAT}/fdts/, $(patsubst %.dtb,%-bl32.dtb,$(DTB_FILE_NAME)))
 $(eval $(call TOOL_ADD_PAYLOAD,${STM32MP_TOS_FW_CONFIG},--tos-fw-config))
@@ -214,20 +407,64 @@ $(eval $(call assert_booleans,\
 		BL33_HYP \
 		PKA_USE_BRAINPOOL_P256T1 \
 		PKA_USE_NIST_P256 \
+		PKA_USE_RSA \
 		PLAT_TBBR_IMG_DEF \
 		PLAT_XLAT_TABLES_DYNAMIC \
+		STM32MP_BL2_EARLY_DCACHE \
+		STM32MP_BL2_HANDOFF \
+		STM32MP_BL2_SMP \
+		STM32MP_BL2_SMP_CRYPTO \
+		STM32MP_BOOT_TIMELINE \
+		STM32MP_BOOT_TRACE \
+		STM32MP_CACHE_BENCH \
+		STM32MP_CRC32_SLICE8 \
+		STM32MP_CRYPTO_BENCH \
 		STM32MP_DDR_32BIT_INTERFACE \
 		STM32MP_DDR_DUAL_AXI_PORT \
+		STM32MP_DDR_FREQ_SCALING \
+		STM32MP_DDR_FULL_TEST_SMP \
+		STM32MP_DDR_QOS_PROFILES \
+		STM32MP_DDR_SCRUB \
+		STM32MP_DDR_TRAINING_CACHE \
+		STM32MP_DECOMPRESS_LZ4 \
+		STM32MP_DECOMPRESS_STREAM \
+		STM32MP_DEFER_NT_FW_CONFIG \
+		STM32MP_DMA_MEMCPY \
+		STM32MP_DT_INDEX \
+		STM32MP_DT_VARIANTS \
 		STM32MP_EARLY_CONSOLE \
 		STM32MP_EMMC \
 		STM32MP_EMMC_BOOT \
+		STM32MP_FIP_MANIFEST_CERT \
+		STM32MP_FWU_IWDG_FALLBACK \
+		STM32MP_IT_LATENCY \
+		STM32MP_LOG_RING \
+		STM32MP_LP_GOVERNOR \
+		STM32MP_LP_TIMELINE \
+		STM32MP_M4_EARLY_BOOT \
+		STM32MP_MCE_BENCH \
+		STM32MP_MDMA \
+		STM32MP_MEM_BENCH \
+		STM32MP_MEM_USAGE \
+		STM32MP_MMC_ASYNC_INIT \
+		STM32MP_PERF_SNAPSHOT \
 		STM32MP_RAW_NAND \
 		STM32MP_RECONFIGURE_CONSOLE \
+		STM32MP_RNG_POOL \
+		STM32MP_SCMI_DELAYED_RESP \
+		STM32MP_SCMI_M4_AGENT \
+		STM32MP_SCMI_STATS \
 		STM32MP_SDMMC \
+		STM32MP_SIP_REG_BATCH \
+		STM32MP_SIP_RESUMABLE \
+		STM32MP_SIP_SVC_STATS \
 		STM32MP_SPI_NAND \
 		STM32MP_SPI_NOR \
 		STM32MP_SSP \
+		STM32MP_STORAGE_BENCH \
+		STM32MP_STRIPED_LOAD \
 		STM32MP_UART_PROGRAMMER \
+		STM32MP_USB_DMA \
 		STM32MP_USB_PROGRAMMER \
 		STM32MP_USE_EXTERNAL_HEAP \
 		STM32MP13 \
@@ -239,7 +476,11 @@ $(eval $(call assert_numerics,\
 		PLAT_PARTITION_MAX_ENTRIES \
 		STM32_TF_A_COPIES \
 		STM32_TF_VERSION \
+		STM32MP_BL2_DCACHE_SW_KB \
+		STM32MP_DDR_FULL_TEST \
+		STM32MP_MMC_DDR_BUFFER_KB \
 		STM32MP_UART_BAUDRATE \
+		STM32MP_USB_DFU_XFER_SIZE \
 )))
 
 $(eval $(call add_defines,\
@@ -248,24 +489,72 @@ $(eval $(call add_defines,\
 		DWL_BUFFER_BASE \
 		PKA_USE_BRAINPOOL_P256T1 \
 		PKA_USE_NIST_P256 \
+		PKA_USE_RSA \
 		PLAT_PARTITION_MAX_ENTRIES \
 		PLAT_TBBR_IMG_DEF \
 		PLAT_XLAT_TABLES_DYNAMIC \
 		STM32_TF_A_COPIES \
 		STM32_TF_VERSION \
+		STM32MP_BL2_EARLY_DCACHE \
+		STM32MP_BL2_HANDOFF \
+		STM32MP_BL2_SMP \
+		STM32MP_BL2_SMP_CRYPTO \
+		STM32MP_BOOT_TIMELINE \
+		STM32MP_BOOT_TRACE \
+		STM32MP_CACHE_BENCH \
+		STM32MP_CRC32_SLICE8 \
+		STM32MP_CRYPTO_BENCH \
 		STM32MP_DDR_32BIT_INTERFACE \
 		STM32MP_DDR_DUAL_AXI_PORT \
+		STM32MP_DDR_FREQ_SCALING \
+		STM32MP_DDR_FULL_TEST \
+		STM32MP_DDR_FULL_TEST_SMP \
+		STM32MP_DDR_QOS_PROFILES \
+		STM32MP_DDR_SCRUB \
+		STM32MP_DDR_SCRUB_SLICE_US \
+		STM32MP_DDR_TRAINING_CACHE \
+		STM32MP_DECOMPRESS_LZ4 \
+		STM32MP_DECOMPRESS_STREAM \
+		STM32MP_DEFER_NT_FW_CONFIG \
+		STM32MP_DMA_MEMCPY \
+		STM32MP_DT_INDEX \
+		STM32MP_DT_VARIANTS \
 		STM32MP_EARLY_CONSOLE \
 		STM32MP_EMMC \
 		STM32MP_EMMC_BOOT \
+		STM32MP_FIP_MANIFEST_CERT \
+		STM32MP_FWU_IWDG_FALLBACK \
+		STM32MP_IT_LATENCY \
+		STM32MP_LOG_RING \
+		STM32MP_LP_GOVERNOR \
+		STM32MP_LP_TIMELINE \
+		STM32MP_M4_EARLY_BOOT \
+		STM32MP_MCE_BENCH \
+		STM32MP_MDMA \
+		STM32MP_MEM_BENCH \
+		STM32MP_MEM_USAGE \
+		STM32MP_MMC_ASYNC_INIT \
+		STM32MP_PERF_SNAPSHOT \
+		STM32MP_MMC_DDR_BUFFER_KB \
 		STM32MP_RAW_NAND \
 		STM32MP_RECONFIGURE_CONSOLE \
+		STM32MP_RNG_POOL \
+		STM32MP_SCMI_DELAYED_RESP \
+		STM32MP_SCMI_M4_AGENT \
+		STM32MP_SCMI_STATS \
 		STM32MP_SDMMC \
+		STM32MP_SIP_REG_BATCH \
+		STM32MP_SIP_RESUMABLE \
+		STM32MP_SIP_SVC_STATS \
 		STM32MP_SPI_NAND \
 		STM32MP_SPI_NOR \
 		STM32MP_SSP \
+		STM32MP_STORAGE_BENCH \
+		STM32MP_STRIPED_LOAD \
 		STM32MP_UART_BAUDRATE \
 		STM32MP_UART_PROGRAMMER \
+		STM32MP_USB_DFU_XFER_SIZE \
+		STM32MP_USB_DMA \
 		STM32MP_USB_PROGRAMMER \
 		STM32MP_USE_EXTERNAL_HEAP \
 		STM32MP13 \
@@ -285,10 +574,31 @@ PLAT_BL_COMMON_SOURCES	:=	common/uuid.c						\
 
 PLAT_BL_COMMON_SOURCES	+=	drivers/st/uart/aarch32/stm32_console.S
 
+ifeq (${STM32MP_BOOT_TIMELINE},1)
+PLAT_BL_COMMON_SOURCES	+=	plat/st/common/stm32mp_boot_timeline.c
+endif
+
+ifeq (${STM32MP_BOOT_TRACE},1)
+ifneq ($(STM32MP15)-$(AARCH32_SP),1-sp_min)
+$(error STM32MP_BOOT_TRACE is only supported on STM32MP15 with SP_min)
+endif
+PLAT_BL_COMMON_SOURCES	+=	plat/st/stm32mp1/stm32mp1_boot_trace.c
+endif
+
+ifeq (${STM32MP_LOG_RING},1)
+PLAT_BL_COMMON_SOURCES	+=	plat/st/common/stm32mp_log_ring.c
+endif
+
+ifeq (${STM32MP_MEM_USAGE},1)
+PLAT_BL_COMMON_SOURCES	+=	plat/st/stm32mp1/stm32mp1_mem_usage.c
+endif
+
 ifneq (${ENABLE_STACK_PROTECTOR},0)
 PLAT_BL_COMMON_SOURCES	+=	plat/st/stm32mp1/stm32mp1_stack_protector.c
 endif
 
+# Memory attributes are not changed after the translation tables setup
+XLAT_TABLES_CONT_HINT	?=	1
 include lib/xlat_tables_v2/xlat_tables.mk
 PLAT_BL_COMMON_SOURCES	+=	${XLAT_TABLES_LIB_SRCS}
 
@@ -331,16 +641,43 @@ BL2_SOURCES		+=	${FCONF_SOURCES} ${FCONF_DYN_SOURCES}
 BL2_SOURCES		+=	drivers/io/io_fip.c					\
 				plat/st/common/bl2_io_storage.c				\
 				plat/st/common/stm32mp_fconf_io.c			\
+				plat/st/common/stm32mp_init_tasks.c			\
 				plat/st/stm32mp1/plat_bl2_mem_params_desc.c		\
 				plat/st/stm32mp1/stm32mp1_fconf_firewall.c
 
-ifeq (${PSA_FWU_SUPPORT},1)
+ifneq ($(filter 1,${PSA_FWU_SUPPORT} ${GPT_CRC_CHECK})$(filter GZIP,${STM32MP_COMPRESS_FILTER}),)
 include lib/zlib/zlib.mk
-include drivers/fwu/fwu.mk
 
 BL2_SOURCES		+=	$(ZLIB_SOURCES)
 endif
 
+ifeq (${STM32MP_COMPRESS_FILTER},LZ4)
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	$(LZ4_SOURCES)
+endif
+
+ifeq (${PSA_FWU_SUPPORT},1)
+include drivers/fwu/fwu.mk
+endif
+
+ifeq (${STM32MP_CRC32_SLICE8},1)
+BL2_SOURCES		+=	common/tf_crc32_slice8.c
+endif
+
+ifeq (${STM32MP_DECOMPRESS_STREAM},1)
+BL2_SOURCES		+=	common/image_decompress.c
+endif
+
+ifeq (${STM32MP_DEFER_NT_FW_CONFIG},1)
+BL2_SOURCES		+=	plat/st/common/stm32mp_deferred_images.c
+endif
+
+ifeq (${STM32MP_DT_VARIANTS},1)
+BL2_SOURCES		+=	lib/libfdt/fdt_overlay.c				\
+				plat/st/common/stm32mp_dt_variants.c
+endif
+
 BL2_SOURCES		+=	drivers/io/io_block.c					\
 				drivers/io/io_mtd.c					\
 				drivers/io/io_storage.c					\
@@ -355,6 +692,73 @@ ifeq ($(STM32MP13),1)
 BL2_SOURCES		+=	drivers/st/mce/stm32_mce.c
 endif
 
+ifeq (${STM32MP_BL2_HANDOFF},1)
+ifneq (${STM32MP15},1)
+$(error STM32MP_BL2_HANDOFF is only supported on STM32MP15)
+endif
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_handoff.c
+endif
+
+ifeq (${STM32MP_MDMA},1)
+PLAT_BL_COMMON_SOURCES	+=	drivers/st/dma/stm32_mdma.c
+endif
+
+ifeq (${STM32MP_DMA_MEMCPY},1)
+ifneq (${STM32MP_MDMA},1)
+$(error STM32MP_DMA_MEMCPY requires STM32MP_MDMA)
+endif
+BL2_SOURCES		+=	plat/st/common/stm32mp_dma_memcpy.c
+endif
+
+ifeq (${STM32MP_STRIPED_LOAD},1)
+ifneq (${STM32MP_DMA_MEMCPY}-${STM32MP_SPI_NOR},1-1)
+$(error STM32MP_STRIPED_LOAD requires STM32MP_DMA_MEMCPY and STM32MP_SPI_NOR)
+endif
+ifeq ($(filter 1,${STM32MP_SDMMC} ${STM32MP_EMMC}),)
+$(error STM32MP_STRIPED_LOAD requires STM32MP_SDMMC or STM32MP_EMMC)
+endif
+ifneq ($(filter 1,${TRUSTED_BOARD_BOOT} ${STM32MP_DECOMPRESS_STREAM} ${PSA_FWU_SUPPORT}),)
+$(error STM32MP_STRIPED_LOAD is not supported with TRUSTED_BOARD_BOOT, STM32MP_DECOMPRESS_STREAM or PSA_FWU_SUPPORT)
+endif
+BL2_SOURCES		+=	plat/st/common/stm32mp_striped_load.c
+endif
+
+ifneq (${STM32MP_BL2_DCACHE_SW_KB},0)
+ifeq (${STM32MP_BL2_SMP},1)
+$(error STM32MP_BL2_DCACHE_SW_KB is not supported when BL2 runs on both cores)
+endif
+BL2_CPPFLAGS		+=	-DDCACHE_SW_OP_THRESHOLD=$(shell echo $$((${STM32MP_BL2_DCACHE_SW_KB} * 1024)))
+endif
+
+ifeq (${STM32MP_CACHE_BENCH},1)
+ifneq (${STM32MP_BL2_DCACHE_SW_KB},0)
+$(error STM32MP_CACHE_BENCH measures the flush by MVA, it requires STM32MP_BL2_DCACHE_SW_KB=0)
+endif
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_cache_bench.c
+endif
+
+ifeq (${STM32MP_CRYPTO_BENCH},1)
+ifneq (${TRUSTED_BOARD_BOOT},1)
+$(error STM32MP_CRYPTO_BENCH compares with mbedTLS, it requires TRUSTED_BOARD_BOOT=1)
+endif
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_crypto_bench.c
+endif
+
+ifeq (${STM32MP_MCE_BENCH},1)
+ifneq (${STM32MP13},1)
+$(error STM32MP_MCE_BENCH is only supported on STM32MP13)
+endif
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_mce_bench.c
+endif
+
+ifeq (${STM32MP_STORAGE_BENCH},1)
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_storage_bench.c
+endif
+
+ifeq (${STM32MP_MEM_BENCH},1)
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_mem_bench.c
+endif
+
 ifeq (${TRUSTED_BOARD_BOOT},1)
 AUTH_SOURCES		:=	drivers/auth/auth_mod.c					\
 				drivers/auth/crypto_mod.c				\
@@ -392,6 +796,51 @@ endif
 
 BL2_SOURCES		+=	$(AUTH_SOURCES)						\
 				plat/st/common/stm32mp_trusted_boot.c
+
+endif
+
+ifeq (${STM32MP_BL2_SMP},1)
+ifneq (${STM32MP15},1)
+$(error STM32MP_BL2_SMP_CRYPTO and STM32MP_DDR_FULL_TEST_SMP are only supported on STM32MP15)
+endif
+BL2_SOURCES		+=	plat/st/stm32mp1/stm32mp1_bl2_smp.c			\
+				plat/st/stm32mp1/stm32mp1_bl2_smp_entry.S
+endif
+
+ifeq (${STM32MP_BL2_SMP_CRYPTO},1)
+ifneq (${TRUSTED_BOARD_BOOT},1)
+$(error STM32MP_BL2_SMP_CRYPTO requires TRUSTED_BOARD_BOOT=1)
+endif
+endif
+
+ifeq (${PKA_USE_RSA},1)
+ifneq (${STM32MP13}-${TRUSTED_BOARD_BOOT},1-1)
+$(error PKA_USE_RSA requires STM32MP13=1 and TRUSTED_BOARD_BOOT=1)
+endif
+endif
+
+ifeq (${STM32MP_FIP_MANIFEST_CERT},1)
+ifneq (${TRUSTED_BOARD_BOOT},1)
+$(error STM32MP_FIP_MANIFEST_CERT requires TRUSTED_BOARD_BOOT=1)
+endif
+endif
+
+ifeq (${STM32MP_M4_EARLY_BOOT},1)
+ifneq (${STM32MP15},1)
+$(error STM32MP_M4_EARLY_BOOT is only supported on STM32MP15)
+endif
+ifeq (${SCP_BL2},)
+$(error STM32MP_M4_EARLY_BOOT requires SCP_BL2 to be set to the M4 firmware)
+endif
+ifeq (${STM32MP_FIP_MANIFEST_CERT},1)
+$(error STM32MP_M4_EARLY_BOOT is not supported with STM32MP_FIP_MANIFEST_CERT)
+endif
+endif
+
+ifeq (${STM32MP_SCMI_M4_AGENT},1)
+ifneq (${STM32MP15},1)
+$(error STM32MP_SCMI_M4_AGENT is only supported on STM32MP15)
+endif
 endif
 
 ifneq ($(filter 1,${STM32MP_EMMC} ${STM32MP_SDMMC}),)
@@ -459,6 +908,16 @@ BL2_SOURCES		+=	drivers/st/ddr/stm32mp_ddr_test.c			\
 				drivers/st/ddr/stm32mp1_ddr.c				\
 				drivers/st/ddr/stm32mp1_ram.c
 
+ifneq ($(STM32MP_DDR_FULL_TEST),0)
+BL2_SOURCES		+=	drivers/st/ddr/stm32mp_ddr_test_full.c			\
+				drivers/st/ddr/aarch32/stm32mp_ddr_test_neon.S
+endif
+
+ifeq ($(STM32MP_DDR_TRAINING_CACHE),1)
+BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr_training.c			\
+				drivers/st/thermal/stm32_dts.c
+endif
+
 BL2_SOURCES		+=	common/desc_image_load.c				\
 				plat/st/stm32mp1/plat_image_load.c
 
@@ -471,6 +930,10 @@ ifeq ($(STM32MP_SSP),1)
 include plat/st/stm32mp1/stm32mp1_ssp.mk
 endif
 
+ifeq ($(AARCH32_SP),sp_min)
+include plat/st/stm32mp1/stm32mp1_smc_bench.mk
+endif
+
 # Compilation rules
 .PHONY: check_dtc_version stm32image clean_stm32image check_boot_device
 .SUFFIXES:
@@ -19,6 +19,7 @@
 #include <drivers/st/stm32mp1_ddr_helpers.h>
 #include <drivers/st/stpmic1.h>
 #include <lib/mmio.h>
+#include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <services/std_svc.h>
 
@@ -27,6 +28,7 @@
 #include <stm32mp1_smc.h>
 
 #include "bsec_svc.h"
+#include "resume_svc.h"
 
 /*
  * version of STM32_SMC_READ_ALL / STM32_SMC_WRITE_ALL service
@@ -50,6 +52,9 @@
 #define LOCK_SHADOW_P			BIT(27)
 #define LOCK_ERROR			BIT(26)
 
+/* bsec_write_all_bsec() interrupted, not a BSEC driver status */
+#define BSEC_SVC_INTERRUPTED		U(0x1)
+
 struct otp_state {
 	uint32_t value;
 	uint32_t state;
@@ -71,6 +76,7 @@ static uint32_t bsec_read_all_bsec(struct otp_exchange *exchange)
 	uint32_t permanent_lock[3];
 	uint32_t bsec_base;
 	uint32_t status;
+	bool shadow_all;
 
 	if (exchange == NULL) {
 		return BSEC_ERROR;
@@ -102,6 +108,12 @@ static uint32_t bsec_read_all_bsec(struct otp_exchange *exchange)
 		shadow_write_lock[i] = mmio_read_32(bsec_base + BSEC_SWLOCK(i));
 	}
 
+	/*
+	 * Refresh all OTPs with a single SAFMEM power cycle, and only fall
+	 * back to one OTP at a time to locate the failing ones on error.
+	 */
+	shadow_all = bsec_shadow_range(0U, STM32MP1_OTP_MAX_ID + 1U) == BSEC_OK;
+
 	for (i = 0U; i <= STM32MP1_OTP_MAX_ID; i++) {
 		uint32_t offset = i / __WORD_BIT;
 		uint32_t bits = BIT(i % __WORD_BIT);
@@ -109,7 +121,10 @@ static uint32_t bsec_read_all_bsec(struct otp_exchange *exchange)
 		exchange->otp[i].value = 0U;
 		exchange->otp[i].state = 0U;
 
-		result = bsec_shadow_register(i);
+		result = BSEC_OK;
+		if (!shadow_all) {
+			result = bsec_shadow_register(i);
+		}
 		if (result == BSEC_OK) {
 			result = bsec_read_otp(&exchange->otp[i].value, i);
 		}
@@ -134,8 +149,13 @@ static uint32_t bsec_read_all_bsec(struct otp_exchange *exchange)
 	return BSEC_OK;
 }
 
+/*
+ * Program, write and lock the requested OTPs from the first one. A pending
+ * non-secure interrupt stops the loop before the next requested OTP, for the
+ * call to be resumed from it rather than restarted on already locked OTPs.
+ */
 static uint32_t bsec_write_all_bsec(struct otp_exchange *exchange,
-				    uint32_t *ret_otp_value)
+				    uint32_t first, uint32_t *ret_otp_value)
 {
 	uint32_t i;
 	uint32_t ret;
@@ -150,10 +170,13 @@ static uint32_t bsec_write_all_bsec(struct otp_exchange *exchange,
 		return BSEC_ERROR;
 	}
 
-	for (i = 0U; i <= STM32MP1_OTP_MAX_ID; i++) {
+	for (i = first; i <= STM32MP1_OTP_MAX_ID; i++) {
 		if ((exchange->otp[i].state & OTP_UPDATE_REQ) == 0U) {
 			continue;
 		}
+		if ((i > first) && resume_svc_yield(i)) {
+			return BSEC_SVC_INTERRUPTED;
+		}
 		if (exchange->otp[i].value != 0U) {
 			ret = bsec_program_otp(exchange->otp[i].value, i);
 			if (ret == BSEC_OK) {
@@ -199,6 +222,61 @@ static uint32_t bsec_write_all_bsec(struct otp_exchange *exchange,
 	return BSEC_OK;
 }
 
+/*
+ * Read up to STM32_SMC_BSEC_MULTI_MAX consecutive OTPs in a single call,
+ * the access rights being checked once for the whole range. As with
+ * STM32_SMC_READ_OTP, STM32_SMC_READ_OTP_MULTI reads the OTPs from SAFMEM
+ * but leaves the shadow registers unchanged.
+ */
+uint32_t bsec_read_multi(uint32_t service, uint32_t first, uint32_t count,
+			 uint32_t *otp_values)
+{
+	uint32_t shadow[STM32_SMC_BSEC_MULTI_MAX];
+	uint32_t result = BSEC_OK;
+	uint32_t i;
+
+	if ((service != STM32_SMC_READ_SHADOW_MULTI) &&
+	    (service != STM32_SMC_READ_OTP_MULTI)) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	if ((count > STM32_SMC_BSEC_MULTI_MAX) ||
+	    (bsec_check_nsec_access_rights_range(first, count) != BSEC_OK)) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	if (service == STM32_SMC_READ_OTP_MULTI) {
+		for (i = 0U; (result == BSEC_OK) && (i < count); i++) {
+			result = bsec_read_otp(&shadow[i], first + i);
+		}
+
+		if (result != BSEC_OK) {
+			return STM32_SMC_FAILED;
+		}
+
+		result = bsec_shadow_range(first, count);
+	}
+
+	for (i = 0U; (result == BSEC_OK) && (i < count); i++) {
+		result = bsec_read_otp(&otp_values[i], first + i);
+	}
+
+	if (service == STM32_SMC_READ_OTP_MULTI) {
+		for (i = 0U; i < count; i++) {
+			if (bsec_write_otp(shadow[i], first + i) != BSEC_OK) {
+				result = BSEC_ERROR;
+			}
+		}
+	}
+
+	if (result != BSEC_OK) {
+		zeromem(otp_values, count * sizeof(uint32_t));
+		return STM32_SMC_FAILED;
+	}
+
+	return STM32_SMC_OK;
+}
+
 uint32_t bsec_main(uint32_t x1, uint32_t x2, uint32_t x3,
 		   uint32_t *ret_otp_value)
 {
@@ -284,7 +362,10 @@ uint32_t bsec_main(uint32_t x1, uint32_t x2, uint32_t x3,
 		result = bsec_read_all_bsec(otp_exch);
 		break;
 	case STM32_SMC_WRITE_ALL:
-		result = bsec_write_all_bsec(otp_exch, ret_otp_value);
+		result = bsec_write_all_bsec(otp_exch,
+					     resume_svc_start(STM32_SMC_BSEC,
+							      x1, x2),
+					     ret_otp_value);
 		break;
 	case STM32_SMC_WRLOCK_OTP:
 		result = bsec_permanent_lock_otp(x2);
@@ -298,5 +379,9 @@ uint32_t bsec_main(uint32_t x1, uint32_t x2, uint32_t x3,
 		assert(ret == 0);
 	}
 
+	if (result == BSEC_SVC_INTERRUPTED) {
+		return STM32_SMC_INTERRUPTED;
+	}
+
 	return (result == BSEC_OK) ? STM32_SMC_OK : STM32_SMC_FAILED;
 }
@@ -11,5 +11,7 @@
 
 uint32_t bsec_main(uint32_t x1, uint32_t x2, uint32_t x3,
 		   uint32_t *ret_otp_value);
+uint32_t bsec_read_multi(uint32_t service, uint32_t first, uint32_t count,
+			 uint32_t *otp_values);
 
 #endif /* BSEC_SVC_H */
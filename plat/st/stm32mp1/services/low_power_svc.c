@@ -6,6 +6,7 @@
 
 #include <smccc_helpers.h>
 
+#include <stm32mp1_lp_timeline.h>
 #include <stm32mp1_power_config.h>
 #include <stm32mp1_smc.h>
 
@@ -20,3 +21,15 @@ uint32_t pm_domain_scv_handler(uint32_t x1, uint32_t x2)
 
 	return STM32_SMC_OK;
 }
+
+#if STM32MP_LP_TIMELINE
+uint32_t lp_timeline_scv_handler(uint32_t x1, uint32_t x2, uint32_t *ret1,
+				 uint32_t *ret2)
+{
+	if (stm32mp1_lp_timeline_get(x1, x2, ret1, ret2) != 0) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	return STM32_SMC_OK;
+}
+#endif
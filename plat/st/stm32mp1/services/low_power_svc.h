@@ -10,5 +10,7 @@
 #include <stdint.h>
 
 uint32_t pm_domain_scv_handler(uint32_t x1, uint32_t x2);
+uint32_t lp_timeline_scv_handler(uint32_t x1, uint32_t x2, uint32_t *ret1,
+				 uint32_t *ret2);
 
 #endif /* LOW_POWER_SVC_H */
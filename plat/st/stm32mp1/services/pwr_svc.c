@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,8 +15,8 @@
 
 #include "pwr_svc.h"
 
-static void access_allowed_mask(uint32_t request, uint32_t offset,
-				uint32_t value, uint32_t allowed_mask)
+void pwr_scv_access(uint32_t request, uint32_t offset, uint32_t value,
+		    uint32_t allowed_mask)
 {
 	uint32_t addr = stm32mp_pwr_base() + offset;
 	uint32_t masked_value = value & allowed_mask;
@@ -49,31 +49,32 @@ static void access_allowed_mask(uint32_t request, uint32_t offset,
 	stm32mp_pwr_regs_unlock();
 }
 
-static void raw_allowed_access_request(uint32_t request,
-				       uint32_t offset, uint32_t value)
+/* Bits of a PWR register the non-secure world may access, 0 if none */
+uint32_t pwr_scv_allowed_mask(uint32_t offset)
 {
-	uint32_t allowed_mask = 0;
-
 	switch (offset) {
 	case PWR_CR3:
-		allowed_mask |= PWR_CR3_VBE | PWR_CR3_VBRS | PWR_CR3_USB33DEN |
-				PWR_CR3_REG18EN | PWR_CR3_REG11EN;
-		break;
+		return PWR_CR3_VBE | PWR_CR3_VBRS | PWR_CR3_USB33DEN |
+		       PWR_CR3_REG18EN | PWR_CR3_REG11EN;
 
 	case PWR_WKUPCR:
-		allowed_mask |= PWR_WKUPCR_MASK;
-		break;
+		return PWR_WKUPCR_MASK;
 
 	case PWR_MPUWKUPENR:
-		allowed_mask |= PWR_MPUWKUPENR_MASK;
-		break;
+		return PWR_MPUWKUPENR_MASK;
 
 	default:
-		return;
+		return 0U;
 	}
+}
+
+static void raw_allowed_access_request(uint32_t request,
+				       uint32_t offset, uint32_t value)
+{
+	uint32_t allowed_mask = pwr_scv_allowed_mask(offset);
 
 	if (allowed_mask != 0U) {
-		access_allowed_mask(request, offset, value, allowed_mask);
+		pwr_scv_access(request, offset, value, allowed_mask);
 	}
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -29,8 +29,8 @@ static bool offset_is_clear_register(uint32_t __unused offset)
 	return false;
 }
 
-static void access_allowed_mask(uint32_t request, uint32_t offset,
-				uint32_t value, uint32_t allowed_mask)
+void rcc_scv_access(uint32_t request, uint32_t offset, uint32_t value,
+		    uint32_t allowed_mask)
 {
 	uint32_t addr = stm32mp_rcc_base() + offset;
 	uint32_t masked_value = value & allowed_mask;
@@ -72,24 +72,29 @@ static void access_allowed_mask(uint32_t request, uint32_t offset,
 	}
 }
 
-static uint32_t raw_allowed_access_request(uint32_t request,
-					   uint32_t offset, uint32_t value)
+/* Bits of an RCC register the non-secure world may access, 0 if none */
+uint32_t rcc_scv_allowed_mask(uint32_t offset)
 {
-	uint32_t allowed_mask = 0;
-
 	switch (offset) {
 	case RCC_MP_CIER:
 	case RCC_MP_CIFR:
-		allowed_mask = RCC_MP_CIFR_WKUPF;
-		break;
+		return RCC_MP_CIFR_WKUPF;
 	default:
-		return STM32_SMC_INVALID_PARAMS;
+		return 0U;
 	}
+}
 
-	if (allowed_mask != 0U) {
-		access_allowed_mask(request, offset, value, allowed_mask);
+static uint32_t raw_allowed_access_request(uint32_t request,
+					   uint32_t offset, uint32_t value)
+{
+	uint32_t allowed_mask = rcc_scv_allowed_mask(offset);
+
+	if (allowed_mask == 0U) {
+		return STM32_SMC_INVALID_PARAMS;
 	}
 
+	rcc_scv_access(request, offset, value, allowed_mask);
+
 	return STM32_SMC_OK;
 }
 
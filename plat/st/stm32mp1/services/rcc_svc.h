@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,9 @@
 #define RCC_SVC_H
 
 uint32_t rcc_scv_handler(uint32_t x1, uint32_t x2, uint32_t x3);
+uint32_t rcc_scv_allowed_mask(uint32_t offset);
+void rcc_scv_access(uint32_t request, uint32_t offset, uint32_t value,
+		    uint32_t allowed_mask);
 uint32_t rcc_cal_scv_handler(uint32_t x1);
 
 #endif /* RCC_SVC_H */
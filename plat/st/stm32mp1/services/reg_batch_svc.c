@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <drivers/st/stm32mp1_ddr_helpers.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include <stm32mp1_smc.h>
+
+#include "pwr_svc.h"
+#include "rcc_svc.h"
+#include "reg_batch_svc.h"
+
+/* Layout of an entry of the STM32_SMC_REG_BATCH list, in non-secure memory */
+struct reg_batch_entry {
+	uint32_t op;
+	uint32_t offset;
+	uint32_t value;
+	uint32_t mask;
+};
+
+static bool batch_request_is_valid(uint32_t request)
+{
+	return (request == STM32_SMC_REG_WRITE) ||
+	       (request == STM32_SMC_REG_SET) ||
+	       (request == STM32_SMC_REG_CLEAR);
+}
+
+/* Bits of the entry register the caller may access, 0 if the entry is invalid */
+static uint32_t batch_entry_mask(const struct reg_batch_entry *entry)
+{
+	uint32_t request = STM32_SMC_REG_BATCH_REQ(entry->op);
+
+	if (!batch_request_is_valid(request)) {
+		return 0U;
+	}
+
+	switch (STM32_SMC_REG_BATCH_TARGET(entry->op)) {
+	case STM32_SMC_REG_BATCH_RCC:
+		return rcc_scv_allowed_mask(entry->offset) & entry->mask;
+	case STM32_SMC_REG_BATCH_PWR:
+		return pwr_scv_allowed_mask(entry->offset) & entry->mask;
+	default:
+		return 0U;
+	}
+}
+
+/* Copy the list from non-secure memory, which is then no longer accessed */
+static uint32_t batch_copy(uintptr_t base, size_t size,
+			   struct reg_batch_entry *entry)
+{
+	uintptr_t map_begin = round_down(base, PAGE_SIZE);
+	size_t map_size;
+	uint32_t ret = STM32_SMC_OK;
+
+	if ((base + size) < base) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	map_size = round_up(base + size, PAGE_SIZE) - map_begin;
+
+	if (!ddr_is_nonsecured_area(map_begin, map_size)) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	if (mmap_add_dynamic_region(map_begin, map_begin, map_size,
+				    MT_MEMORY | MT_RO | MT_NS) != 0) {
+		return STM32_SMC_FAILED;
+	}
+
+	(void)memcpy(entry, (void *)base, size);
+
+	if (mmap_remove_dynamic_region(map_begin, map_size) != 0) {
+		ret = STM32_SMC_FAILED;
+	}
+
+	return ret;
+}
+
+/*
+ * Execute a list of RCC and PWR register accesses. The whole list is checked
+ * before the first access: no register is written if an entry is invalid.
+ * x1: physical address of the list, in non-secure DDR
+ * x2: number of entries, up to STM32_SMC_REG_BATCH_MAX
+ * done: number of entries executed
+ */
+uint32_t reg_batch_scv_handler(uint32_t x1, uint32_t x2, uint32_t *done)
+{
+	struct reg_batch_entry entry[STM32_SMC_REG_BATCH_MAX];
+	uint32_t ret;
+	uint32_t i;
+
+	*done = 0U;
+
+	if ((x2 == 0U) || (x2 > STM32_SMC_REG_BATCH_MAX) ||
+	    ((x1 % sizeof(uint32_t)) != 0U)) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	ret = batch_copy(x1, x2 * sizeof(struct reg_batch_entry), entry);
+	if (ret != STM32_SMC_OK) {
+		return ret;
+	}
+
+	/* The mask of an entry is replaced by the bits to access */
+	for (i = 0U; i < x2; i++) {
+		entry[i].mask = batch_entry_mask(&entry[i]);
+		if (entry[i].mask == 0U) {
+			return STM32_SMC_INVALID_PARAMS;
+		}
+	}
+
+	for (i = 0U; i < x2; i++) {
+		uint32_t request = STM32_SMC_REG_BATCH_REQ(entry[i].op);
+
+		if (STM32_SMC_REG_BATCH_TARGET(entry[i].op) ==
+		    STM32_SMC_REG_BATCH_RCC) {
+			rcc_scv_access(request, entry[i].offset,
+				       entry[i].value, entry[i].mask);
+		} else {
+			pwr_scv_access(request, entry[i].offset,
+				       entry[i].value, entry[i].mask);
+		}
+	}
+
+	*done = x2;
+
+	return STM32_SMC_OK;
+}
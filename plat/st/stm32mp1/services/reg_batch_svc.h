@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef REG_BATCH_SVC_H
+#define REG_BATCH_SVC_H
+
+#include <stdint.h>
+
+uint32_t reg_batch_scv_handler(uint32_t x1, uint32_t x2, uint32_t *done);
+
+#endif /* REG_BATCH_SVC_H */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <lib/spinlock.h>
+#include <plat/common/platform.h>
+
+#include "resume_svc.h"
+
+/*
+ * struct resume_state - Interrupted SiP call
+ * @smc_fid: Function ID of the call
+ * @x1: First argument of the call, the service ID of most SiP calls
+ * @x2: Second argument of the call
+ * @step: Step to resume the call from
+ * @saved: The call was interrupted and not resumed yet
+ */
+struct resume_state {
+	uint32_t smc_fid;
+	uint32_t x1;
+	uint32_t x2;
+	unsigned int step;
+	bool saved;
+};
+
+static spinlock_t resume_lock;
+static struct resume_state resume;
+/* Call run by each CPU, saved on interruption */
+static struct resume_state running[PLATFORM_CORE_COUNT];
+
+/* Return the step to run first: 0, or the saved step of the same call */
+unsigned int resume_svc_start(uint32_t smc_fid, uint32_t x1, uint32_t x2)
+{
+	struct resume_state *call;
+	unsigned int step = 0U;
+
+	spin_lock(&resume_lock);
+
+	if (resume.saved && (resume.smc_fid == smc_fid) &&
+	    (resume.x1 == x1) && (resume.x2 == x2)) {
+		step = resume.step;
+	}
+
+	resume.saved = false;
+
+	spin_unlock(&resume_lock);
+
+	call = &running[plat_my_core_pos()];
+	call->smc_fid = smc_fid;
+	call->x1 = x1;
+	call->x2 = x2;
+
+	return step;
+}
+
+/*
+ * Called at a safe point, before next_step. Return true if the call is to
+ * return STM32_SMC_INTERRUPTED, its progress being saved.
+ */
+bool resume_svc_yield(unsigned int next_step)
+{
+	if (read_isr() == 0U) {
+		return false;
+	}
+
+	spin_lock(&resume_lock);
+
+	resume = running[plat_my_core_pos()];
+	resume.step = next_step;
+	resume.saved = true;
+
+	spin_unlock(&resume_lock);
+
+	return true;
+}
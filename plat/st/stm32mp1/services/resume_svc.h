@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RESUME_SVC_H
+#define RESUME_SVC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Resumable SiP calls. SP_min runs the SiP calls with the interrupts masked:
+ * a long call checks at its safe points, between two steps, whether a
+ * non-secure interrupt is pending. It then saves its next step and returns
+ * STM32_SMC_INTERRUPTED, the caller handles the interrupt and issues the
+ * same call again, which resumes from the saved step. A single call is
+ * interrupted at a time, identified by its function ID and first arguments:
+ * starting any resumable call drops the saved step.
+ */
+#if STM32MP_SIP_RESUMABLE
+unsigned int resume_svc_start(uint32_t smc_fid, uint32_t x1, uint32_t x2);
+bool resume_svc_yield(unsigned int next_step);
+#else
+static inline unsigned int resume_svc_start(uint32_t smc_fid, uint32_t x1,
+					    uint32_t x2)
+{
+	return 0U;
+}
+
+static inline bool resume_svc_yield(unsigned int next_step)
+{
+	return false;
+}
+#endif
+
+#endif /* RESUME_SVC_H */
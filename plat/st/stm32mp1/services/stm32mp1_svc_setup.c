@@ -4,116 +4,659 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <drivers/clk.h>
 #include <drivers/scmi-msg.h>
+#include <drivers/st/stm32mp1_ddr_helpers.h>
+#include <lib/cassert.h>
 #include <lib/psci/psci.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
 #include <tools_share/uuid.h>
 
+#include <platform_def.h>
+#include <stm32mp1_ddr_scrub.h>
+#include <stm32mp1_it_latency.h>
 #include <stm32mp1_low_power.h>
+#include <stm32mp1_mem_usage.h>
+#include <stm32mp1_perf_snapshot.h>
 #include <stm32mp1_smc.h>
 
 #include "bsec_svc.h"
 #include "low_power_svc.h"
 #include "pwr_svc.h"
 #include "rcc_svc.h"
+#include "reg_batch_svc.h"
+#include "resume_svc.h"
 
 /* STM32 SiP Service UUID */
 DEFINE_SVC_UUID2(stm32_sip_svc_uid,
 		 0xa778aa50, 0xf49b, 0x144a, 0x8a, 0x5e,
 		 0x26, 0x4d, 0x59, 0x94, 0xc2, 0x14);
 
-/* Setup STM32MP1 Standard Services */
-static int32_t stm32mp1_svc_setup(void)
+typedef uintptr_t (*stm32_sip_handler_t)(uint32_t smc_fid, u_register_t x1,
+					 u_register_t x2, u_register_t x3,
+					 void *handle);
+
+static uintptr_t sip_rcc(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+			 u_register_t x3, void *handle)
 {
-	/*
-	 * PSCI is the only specification implemented as a Standard Service.
-	 * Invoke PSCI setup from here.
-	 */
-	return 0;
+	SMC_RET1(handle, rcc_scv_handler(x1, x2, x3));
 }
 
-/*
- * Top-level Standard Service SMC handler. This handler will in turn dispatch
- * calls to PSCI SMC handler.
- */
-static uintptr_t stm32mp1_svc_smc_handler(uint32_t smc_fid, u_register_t x1,
-					  u_register_t x2, u_register_t x3,
-					  u_register_t x4, void *cookie,
-					  void *handle, u_register_t flags)
+static uintptr_t sip_pwr(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+			 u_register_t x3, void *handle)
 {
-	uint32_t ret1 = 0U, ret2 = 0U;
-	bool ret_uid = false, ret2_enabled = false;
+	SMC_RET1(handle, pwr_scv_handler(x1, x2, x3));
+}
 
-	switch (smc_fid) {
-	case STM32_SIP_SVC_CALL_COUNT:
-		ret1 = STM32_COMMON_SIP_NUM_CALLS;
-		break;
+static uintptr_t sip_rcc_cal(uint32_t smc_fid, u_register_t x1,
+			     u_register_t x2, u_register_t x3, void *handle)
+{
+	SMC_RET1(handle, rcc_cal_scv_handler(x1));
+}
 
-	case STM32_SIP_SVC_UID:
-		/* Return UUID to the caller */
-		ret_uid = true;
-		break;
+static uintptr_t sip_bsec(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+			  u_register_t x3, void *handle)
+{
+	uint32_t ret1;
+	uint32_t ret2 = 0U;
 
-	case STM32_SIP_SVC_VERSION:
-		/* Return the version of current implementation */
-		ret1 = STM32_SIP_SVC_VERSION_MAJOR;
-		ret2 = STM32_SIP_SVC_VERSION_MINOR;
-		ret2_enabled = true;
-		break;
+	if ((x1 == STM32_SMC_READ_SHADOW_MULTI) ||
+	    (x1 == STM32_SMC_READ_OTP_MULTI)) {
+		uint32_t val[STM32_SMC_BSEC_MULTI_MAX] = { 0U };
+
+		ret1 = bsec_read_multi(x1, x2, x3, val);
+
+		SMC_RET7(handle, ret1, val[0], val[1], val[2], val[3], val[4],
+			 val[5]);
+	}
+
+	ret1 = bsec_main(x1, x2, x3, &ret2);
 
-	case STM32_SMC_BSEC:
-		ret1 = bsec_main(x1, x2, x3, &ret2);
-		ret2_enabled = true;
+	SMC_RET2(handle, ret1, ret2);
+}
+
+static uintptr_t sip_pd_domain(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	SMC_RET1(handle, pm_domain_scv_handler(x1, x2));
+}
+
+static uintptr_t sip_auto_stop(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	stm32_auto_stop();
+
+	SMC_RET1(handle, STM32_SMC_OK);
+}
+
+static uintptr_t sip_scmi(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+			  u_register_t x3, void *handle)
+{
+	scmi_smt_fastcall_smc_entry(smc_fid - STM32_SIP_SMC_SCMI_AGENT0);
+
+	SMC_RET1(handle, 0U);
+}
+
+static uintptr_t sip_scmi_regs(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	uint32_t in[SCMI_REGS_PAYLOAD_U32_MAX] = { x2, x3 };
+	uint32_t out[SCMI_REGS_PAYLOAD_U32_MAX] = { 0U };
+	size_t out_size = 0U;
+	int ret;
+
+	ret = scmi_regs_fastcall_entry(smc_fid - STM32_SIP_SMC_SCMI_REGS_AGENT0,
+				       x1, in, out, &out_size);
+	switch (ret) {
+	case 0:
 		break;
+	case -ENOTSUP:
+		SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+	default:
+		SMC_RET1(handle, STM32_SMC_FAILED);
+	}
+
+	SMC_RET4(handle, STM32_SMC_OK, out[0], out[1], out[2]);
+}
+
+static uintptr_t sip_call_count(uint32_t smc_fid, u_register_t x1,
+				u_register_t x2, u_register_t x3, void *handle)
+{
+	SMC_RET1(handle, STM32_COMMON_SIP_NUM_CALLS);
+}
+
+static uintptr_t sip_uid(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+			 u_register_t x3, void *handle)
+{
+	/* Return UUID to the caller */
+	SMC_UUID_RET(handle, stm32_sip_svc_uid);
+}
+
+static uintptr_t sip_version(uint32_t smc_fid, u_register_t x1,
+			     u_register_t x2, u_register_t x3, void *handle)
+{
+	/* Return the version of current implementation */
+	SMC_RET2(handle, STM32_SIP_SVC_VERSION_MAJOR,
+		 STM32_SIP_SVC_VERSION_MINOR);
+}
+
+#if STM32MP_SIP_SVC_STATS
+static uintptr_t sip_svc_stats(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle);
+#endif
 
-	case STM32_SMC_RCC:
-		ret1 = rcc_scv_handler(x1, x2, x3);
+#if ENABLE_PSCI_STAT_HISTOGRAM
+CASSERT(STM32_SMC_PSCI_STAT_HIST_RESIDENCY == PSCI_STAT_HIST_RESIDENCY,
+	assert_psci_stat_hist_residency_id);
+CASSERT(STM32_SMC_PSCI_STAT_HIST_ENTRY_LATENCY == PSCI_STAT_HIST_ENTRY_LATENCY,
+	assert_psci_stat_hist_entry_latency_id);
+CASSERT(STM32_SMC_PSCI_STAT_HIST_EXIT_LATENCY == PSCI_STAT_HIST_EXIT_LATENCY,
+	assert_psci_stat_hist_exit_latency_id);
+
+static uintptr_t sip_psci_stat_hist(uint32_t smc_fid, u_register_t x1,
+				    u_register_t x2, u_register_t x3,
+				    void *handle)
+{
+	u_register_t count = 0U;
+
+	if (psci_stat_histogram(x1, x2, STM32_SMC_PSCI_STAT_HIST_ID(x3),
+				STM32_SMC_PSCI_STAT_HIST_BUCKET(x3),
+				&count) != PSCI_E_SUCCESS) {
+		SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+	}
+
+	SMC_RET2(handle, STM32_SMC_OK, count);
+}
+#endif
+
+#if STM32MP_LP_TIMELINE
+static uintptr_t sip_lp_timeline(uint32_t smc_fid, u_register_t x1,
+				 u_register_t x2, u_register_t x3,
+				 void *handle)
+{
+	uint32_t ret1;
+	uint32_t ret2 = 0U;
+	uint32_t ret3 = 0U;
+
+	ret1 = lp_timeline_scv_handler(x1, x2, &ret2, &ret3);
+
+	SMC_RET3(handle, ret1, ret2, ret3);
+}
+#endif
+
+#if STM32MP_PERF_SNAPSHOT
+static uintptr_t sip_perf_snapshot(uint32_t smc_fid, u_register_t x1,
+				   u_register_t x2, u_register_t x3,
+				   void *handle)
+{
+	struct stm32mp1_perf_snapshot snapshot;
+
+	switch (x1) {
+	case STM32_SMC_PERF_SNAPSHOT_CAPTURE:
+		stm32mp1_perf_snapshot_capture();
+		x2 = plat_my_core_pos();
+		break;
+	case STM32_SMC_PERF_SNAPSHOT_READ:
 		break;
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
 
-	case STM32_SMC_RCC_CAL:
-		ret1 = rcc_cal_scv_handler(x1);
+	if (stm32mp1_perf_snapshot_get(x2, &snapshot) != 0) {
+		SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+	}
+
+	SMC_RET6(handle, STM32_SMC_OK, (uint32_t)snapshot.timestamp,
+		 (uint32_t)(snapshot.timestamp >> 32), snapshot.cycles,
+		 snapshot.flags, snapshot.seq);
+}
+#endif
+
+#if STM32MP_DDR_FREQ_SCALING
+CASSERT(STM32_SMC_DDR_FREQ_NOMINAL == DDR_FREQ_NOMINAL,
+	assert_ddr_freq_nominal_id);
+CASSERT(STM32_SMC_DDR_FREQ_LOW == DDR_FREQ_LOW, assert_ddr_freq_low_id);
+
+static uintptr_t sip_ddr_freq(uint32_t smc_fid, u_register_t x1,
+			      u_register_t x2, u_register_t x3, void *handle)
+{
+	switch (x1) {
+	case STM32_SMC_DDR_FREQ_SET:
+		if (x2 >= DDR_FREQ_NB) {
+			SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+		}
+
+		if (ddr_set_freq_mode(x2) != 0) {
+			SMC_RET1(handle, STM32_SMC_FAILED);
+		}
+		break;
+	case STM32_SMC_DDR_FREQ_GET:
 		break;
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
 
+	SMC_RET3(handle, STM32_SMC_OK, ddr_get_freq_mode(),
+		 clk_get_rate(DDRPHYC) / 1000UL);
+}
+#endif
 
-	case STM32_SMC_PWR:
-		ret1 = pwr_scv_handler(x1, x2, x3);
+#if STM32MP_DDR_QOS_PROFILES
+static uintptr_t sip_ddr_qos(uint32_t smc_fid, u_register_t x1,
+			     u_register_t x2, u_register_t x3, void *handle)
+{
+	unsigned int id;
+	unsigned int nb;
+
+	switch (x1) {
+	case STM32_SMC_DDR_QOS_SET:
+#if STM32MP_SIP_RESUMABLE
+		/*
+		 * The first call parses the DT profiles, the other steps
+		 * being short: give way to a pending interrupt in between.
+		 */
+		if ((resume_svc_start(smc_fid, x1, x2) == 0U) &&
+		    (ddr_qos_get_profile(&id, &nb) == 0) &&
+		    resume_svc_yield(1U)) {
+			SMC_RET1(handle, STM32_SMC_INTERRUPTED);
+		}
+#endif
+		if (ddr_qos_set_profile(x2) != 0) {
+			SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+		}
+		break;
+	case STM32_SMC_DDR_QOS_GET:
 		break;
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
+
+	if (ddr_qos_get_profile(&id, &nb) != 0) {
+		SMC_RET1(handle, STM32_SMC_FAILED);
+	}
+
+	SMC_RET3(handle, STM32_SMC_OK, id, nb);
+}
+#endif
+
+#if STM32MP_SIP_REG_BATCH
+static uintptr_t sip_reg_batch(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	uint32_t ret1;
+	uint32_t ret2;
+
+	ret1 = reg_batch_scv_handler(x1, x2, &ret2);
 
-	case STM32_SMC_PD_DOMAIN:
-		ret1 = pm_domain_scv_handler(x1, x2);
+	SMC_RET2(handle, ret1, ret2);
+}
+#endif
+
+#if STM32MP_SCMI_STATS
+static uintptr_t sip_scmi_stats(uint32_t smc_fid, u_register_t x1,
+				u_register_t x2, u_register_t x3, void *handle)
+{
+	struct scmi_msg_stats stats;
+
+	switch (x1) {
+	case STM32_SMC_SCMI_STATS_READ:
+		if (scmi_msg_stats_get(STM32_SMC_SCMI_STATS_AGENT(x2),
+				       STM32_SMC_SCMI_STATS_PROT(x2),
+				       STM32_SMC_SCMI_STATS_MSG_ID(x2),
+				       &stats) != 0) {
+			SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+		}
+
+		SMC_RET5(handle, STM32_SMC_OK, stats.count, stats.max_ticks,
+			 (uint32_t)stats.total_ticks,
+			 (uint32_t)(stats.total_ticks >> 32));
+	case STM32_SMC_SCMI_STATS_BUSY:
+		SMC_RET2(handle, STM32_SMC_OK, scmi_msg_stats_get_busy(x2));
+	case STM32_SMC_SCMI_STATS_RESET:
+		scmi_msg_stats_reset();
+		break;
+	case STM32_SMC_SCMI_STATS_DUMP:
+		scmi_msg_stats_dump();
 		break;
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
+
+	SMC_RET1(handle, STM32_SMC_OK);
+}
+#endif
+
+#if STM32MP_MEM_USAGE
+static uintptr_t sip_mem_usage(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	uint32_t max_used;
+	uint32_t size;
 
-	case STM32_SMC_AUTO_STOP:
-		stm32_auto_stop();
-		ret1 = STM32_SMC_OK;
+	switch (stm32mp1_mem_usage_get(x1, x2, &max_used, &size)) {
+	case 0:
 		break;
+	case -EINVAL:
+		SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
+
+	SMC_RET3(handle, STM32_SMC_OK, max_used, size);
+}
+#endif
+
+#if STM32MP_DDR_SCRUB
+static uintptr_t sip_ddr_scrub(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	struct stm32mp1_ddr_scrub_status status;
 
-	case STM32_SIP_SMC_SCMI_AGENT0:
-		scmi_smt_fastcall_smc_entry(0);
+	switch (x1) {
+	case STM32_SMC_DDR_SCRUB_READ:
 		break;
-	case STM32_SIP_SMC_SCMI_AGENT1:
-		scmi_smt_fastcall_smc_entry(1);
+	case STM32_SMC_DDR_SCRUB_CLEAR:
+		stm32mp1_ddr_scrub_clear();
 		break;
+	default:
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+	}
+
+	stm32mp1_ddr_scrub_get(&status);
+
+	SMC_RET5(handle, STM32_SMC_OK, status.offset, status.passes,
+		 status.errors, status.first_fail);
+}
+#endif
 
+#if STM32MP_IT_LATENCY
+static uintptr_t sip_it_latency(uint32_t smc_fid, u_register_t x1,
+				u_register_t x2, u_register_t x3, void *handle)
+{
+	struct stm32mp1_it_latency_stats stats;
+	uint32_t count;
+
+	switch (x1) {
+	case STM32_SMC_IT_LATENCY_START:
+		if (stm32mp1_it_latency_start(x2) != 0) {
+			SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+		}
+
+		SMC_RET1(handle, STM32_SMC_OK);
+	case STM32_SMC_IT_LATENCY_STOP:
+		stm32mp1_it_latency_stop();
+		SMC_RET1(handle, STM32_SMC_OK);
+	case STM32_SMC_IT_LATENCY_READ:
+		stm32mp1_it_latency_get(&stats);
+		SMC_RET5(handle, STM32_SMC_OK, stats.count, stats.min,
+			 stats.max, stats.avg);
+	case STM32_SMC_IT_LATENCY_HIST:
+		if (stm32mp1_it_latency_hist(x2, &count) != 0) {
+			SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+		}
+
+		SMC_RET2(handle, STM32_SMC_OK, count);
 	default:
-		WARN("Unimplemented STM32MP1 Service Call: 0x%x\n", smc_fid);
-		ret1 = STM32_SMC_NOT_SUPPORTED;
-		break;
+		SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
 	}
+}
+#endif
+
+/*
+ * Handlers are looked up by function number, in one table per range of
+ * contiguous STM32 SiP function IDs.
+ */
+#define SIP_SVC_INDEX(_fid)	((_fid) - STM32_SMC_RCC)
+#define SIP_SCMI_INDEX(_fid)	((_fid) - STM32_SIP_SMC_SCMI_AGENT0)
+#define SIP_QUERY_INDEX(_fid)	((_fid) - STM32_SIP_SVC_CALL_COUNT)
+
+static const stm32_sip_handler_t sip_svc_handler[] = {
+	[SIP_SVC_INDEX(STM32_SMC_RCC)] = sip_rcc,
+	[SIP_SVC_INDEX(STM32_SMC_PWR)] = sip_pwr,
+	[SIP_SVC_INDEX(STM32_SMC_RCC_CAL)] = sip_rcc_cal,
+	[SIP_SVC_INDEX(STM32_SMC_BSEC)] = sip_bsec,
+	[SIP_SVC_INDEX(STM32_SMC_PD_DOMAIN)] = sip_pd_domain,
+	[SIP_SVC_INDEX(STM32_SMC_AUTO_STOP)] = sip_auto_stop,
+#if STM32MP_SIP_SVC_STATS
+	[SIP_SVC_INDEX(STM32_SMC_SVC_STATS)] = sip_svc_stats,
+#endif
+#if ENABLE_PSCI_STAT_HISTOGRAM
+	[SIP_SVC_INDEX(STM32_SMC_PSCI_STAT_HIST)] = sip_psci_stat_hist,
+#endif
+#if STM32MP_LP_TIMELINE
+	[SIP_SVC_INDEX(STM32_SMC_LP_TIMELINE)] = sip_lp_timeline,
+#endif
+#if STM32MP_PERF_SNAPSHOT
+	[SIP_SVC_INDEX(STM32_SMC_PERF_SNAPSHOT)] = sip_perf_snapshot,
+#endif
+#if STM32MP_DDR_FREQ_SCALING
+	[SIP_SVC_INDEX(STM32_SMC_DDR_FREQ)] = sip_ddr_freq,
+#endif
+#if STM32MP_DDR_QOS_PROFILES
+	[SIP_SVC_INDEX(STM32_SMC_DDR_QOS)] = sip_ddr_qos,
+#endif
+#if STM32MP_SIP_REG_BATCH
+	[SIP_SVC_INDEX(STM32_SMC_REG_BATCH)] = sip_reg_batch,
+#endif
+#if STM32MP_SCMI_STATS
+	[SIP_SVC_INDEX(STM32_SMC_SCMI_STATS)] = sip_scmi_stats,
+#endif
+#if STM32MP_MEM_USAGE
+	[SIP_SVC_INDEX(STM32_SMC_MEM_USAGE)] = sip_mem_usage,
+#endif
+#if STM32MP_DDR_SCRUB
+	[SIP_SVC_INDEX(STM32_SMC_DDR_SCRUB)] = sip_ddr_scrub,
+#endif
+#if STM32MP_IT_LATENCY
+	[SIP_SVC_INDEX(STM32_SMC_IT_LATENCY)] = sip_it_latency,
+#endif
+};
+
+static const stm32_sip_handler_t sip_scmi_handler[] = {
+	[SIP_SCMI_INDEX(STM32_SIP_SMC_SCMI_AGENT0)] = sip_scmi,
+	[SIP_SCMI_INDEX(STM32_SIP_SMC_SCMI_AGENT1)] = sip_scmi,
+	[SIP_SCMI_INDEX(STM32_SIP_SMC_SCMI_REGS_AGENT0)] = sip_scmi_regs,
+	[SIP_SCMI_INDEX(STM32_SIP_SMC_SCMI_REGS_AGENT1)] = sip_scmi_regs,
+};
+
+static const stm32_sip_handler_t sip_query_handler[] = {
+	[SIP_QUERY_INDEX(STM32_SIP_SVC_CALL_COUNT)] = sip_call_count,
+	[SIP_QUERY_INDEX(STM32_SIP_SVC_UID)] = sip_uid,
+	[SIP_QUERY_INDEX(STM32_SIP_SVC_VERSION)] = sip_version,
+};
 
-	if (ret_uid) {
-		SMC_UUID_RET(handle, stm32_sip_svc_uid);
+/*
+ * struct sip_range - Range of contiguous STM32 SiP function IDs
+ * @first_fid: First function ID of the range
+ * @handler: Handlers of the range, indexed from @first_fid
+ * @count: Number of function IDs in the range
+ * @slot: Index of the first function ID of the range in the statistics
+ */
+struct sip_range {
+	uint32_t first_fid;
+	const stm32_sip_handler_t *handler;
+	unsigned int count;
+	unsigned int slot;
+};
+
+static const struct sip_range sip_range[] = {
+	{
+		.first_fid = STM32_SMC_RCC,
+		.handler = sip_svc_handler,
+		.count = ARRAY_SIZE(sip_svc_handler),
+		.slot = 0U,
+	},
+	{
+		.first_fid = STM32_SIP_SMC_SCMI_AGENT0,
+		.handler = sip_scmi_handler,
+		.count = ARRAY_SIZE(sip_scmi_handler),
+		.slot = ARRAY_SIZE(sip_svc_handler),
+	},
+	{
+		.first_fid = STM32_SIP_SVC_CALL_COUNT,
+		.handler = sip_query_handler,
+		.count = ARRAY_SIZE(sip_query_handler),
+		.slot = ARRAY_SIZE(sip_svc_handler) +
+			ARRAY_SIZE(sip_scmi_handler),
+	},
+};
+
+#if STM32MP_SIP_SVC_STATS
+#define SIP_STATS_SLOTS		(ARRAY_SIZE(sip_svc_handler) + \
+				 ARRAY_SIZE(sip_scmi_handler) + \
+				 ARRAY_SIZE(sip_query_handler))
+
+/*
+ * Statistics are kept per CPU so that counting takes no lock. Bucket n of
+ * the histogram counts the calls lasting from 2^n to 2^(n+1) - 1 system
+ * counter ticks, the last bucket also counting longer calls.
+ */
+static struct sip_stats {
+	uint32_t count;
+	uint32_t hist[STM32_SMC_SVC_STATS_BUCKETS];
+} sip_stats[PLATFORM_CORE_COUNT][SIP_STATS_SLOTS];
+
+static unsigned int sip_stats_bucket(uint64_t ticks)
+{
+	unsigned int bucket = 0U;
+
+	while ((ticks > 1U) && (bucket < (STM32_SMC_SVC_STATS_BUCKETS - 1U))) {
+		ticks >>= 1;
+		bucket++;
 	}
 
-	if (ret2_enabled) {
-		SMC_RET2(handle, ret1, ret2);
+	return bucket;
+}
+
+static void sip_stats_update(unsigned int slot, uint64_t ticks)
+{
+	struct sip_stats *stats = &sip_stats[plat_my_core_pos()][slot];
+
+	stats->count++;
+	stats->hist[sip_stats_bucket(ticks)]++;
+}
+
+static bool sip_stats_find_slot(uint32_t smc_fid, unsigned int *slot)
+{
+	unsigned int n;
+
+	for (n = 0U; n < ARRAY_SIZE(sip_range); n++) {
+		uint32_t index = smc_fid - sip_range[n].first_fid;
+
+		if ((index < sip_range[n].count) &&
+		    (sip_range[n].handler[index] != NULL)) {
+			*slot = sip_range[n].slot + index;
+			return true;
+		}
 	}
 
-	SMC_RET1(handle, ret1);
+	return false;
+}
+
+static uintptr_t sip_svc_stats(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3, void *handle)
+{
+	uint32_t value = 0U;
+	unsigned int slot = 0U;
+	unsigned int core;
+
+	if (x1 == STM32_SMC_SVC_STATS_RESET) {
+		zeromem(sip_stats, sizeof(sip_stats));
+		SMC_RET1(handle, STM32_SMC_OK);
+	}
+
+	if (!sip_stats_find_slot(x2, &slot)) {
+		SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+	}
+
+	for (core = 0U; core < PLATFORM_CORE_COUNT; core++) {
+		const struct sip_stats *stats = &sip_stats[core][slot];
+
+		switch (x1) {
+		case STM32_SMC_SVC_STATS_COUNT:
+			value += stats->count;
+			break;
+		case STM32_SMC_SVC_STATS_HIST:
+			if (x3 >= STM32_SMC_SVC_STATS_BUCKETS) {
+				SMC_RET1(handle, STM32_SMC_INVALID_PARAMS);
+			}
+
+			value += stats->hist[x3];
+			break;
+		default:
+			SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
+		}
+	}
+
+	SMC_RET2(handle, STM32_SMC_OK, value);
+}
+#endif
+
+/* Setup STM32MP1 Standard Services */
+static int32_t stm32mp1_svc_setup(void)
+{
+	/*
+	 * PSCI is the only specification implemented as a Standard Service.
+	 * Invoke PSCI setup from here.
+	 */
+	return 0;
+}
+
+/*
+ * Top-level Standard Service SMC handler. This handler will in turn dispatch
+ * calls to PSCI SMC handler.
+ */
+static uintptr_t __hot stm32mp1_svc_smc_handler(uint32_t smc_fid,
+						u_register_t x1, u_register_t x2,
+						u_register_t x3, u_register_t x4,
+						void *cookie, void *handle,
+						u_register_t flags)
+{
+	unsigned int n;
+
+	for (n = 0U; n < ARRAY_SIZE(sip_range); n++) {
+		uint32_t index = smc_fid - sip_range[n].first_fid;
+		stm32_sip_handler_t handler;
+#if STM32MP_SIP_SVC_STATS
+		uint64_t start;
+		uintptr_t ret;
+#endif
+
+		/* Function IDs below the range wrap to large indexes */
+		if (index >= sip_range[n].count) {
+			continue;
+		}
+
+		index = SPECULATION_SAFE_VALUE(index);
+		handler = sip_range[n].handler[index];
+		if (handler == NULL) {
+			break;
+		}
+
+#if STM32MP_SIP_SVC_STATS
+		start = read_cntpct_el0();
+		ret = handler(smc_fid, x1, x2, x3, handle);
+		sip_stats_update(sip_range[n].slot + index,
+				 read_cntpct_el0() - start);
+
+		return ret;
+#else
+		return handler(smc_fid, x1, x2, x3, handle);
+#endif
+	}
+
+	WARN("Unimplemented STM32MP1 Service Call: 0x%x\n", smc_fid);
+
+	SMC_RET1(handle, STM32_SMC_NOT_SUPPORTED);
 }
 
 /* Register Standard Service Calls as runtime service */
@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Normal world payload, loaded in place of BL33, measuring the SP_MIN entry
+ * and exit latency of representative SMCs. Results are printed on the debug
+ * UART, one line per SMC and per counter:
+ *
+ * SMC_BENCH name=<smc> unit=<cycles|ticks> n=<calls> err=<failed calls>
+ *	min=<value> avg=<value> p99=<value> max=<value>
+ *
+ * Cycles are read from PMCCNTR. The cycle counter does not count in secure
+ * state when secure non-invasive debug is not allowed, generic timer ticks
+ * are then reported too to measure the whole round trip.
+ *
+ * With STM32MP_IT_LATENCY in SP_MIN, the latency of a periodic secure timer
+ * interrupt is then measured while the normal world idles, and while it
+ * issues the SMCs above in a loop, for the same duration:
+ *
+ * IT_LATENCY load=<idle|smc> unit=<ticks|cycles> n=<interrupts>
+ *	min=<value> avg=<value> max=<value>
+ * IT_LATENCY_HIST load=<idle|smc> ticks=<bucket low bound> n=<interrupts>
+ *
+ * The latency is measured by SP_MIN in ticks, from the timer expiry. It is
+ * converted to cycles with the PMCCNTR rate measured in the normal world.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <drivers/scmi.h>
+#include <drivers/st/stm32_uart_regs.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/mmio.h>
+#include <lib/psci/psci.h>
+#include <lib/utils_def.h>
+#include <services/trng_svc.h>
+
+#include <platform_def.h>
+#include <stm32mp1_smc.h>
+
+#ifndef SMC_BENCH_ITERATIONS
+#define SMC_BENCH_ITERATIONS		1000U
+#endif
+
+#ifndef SMC_BENCH_IT_PERIOD_US
+#define SMC_BENCH_IT_PERIOD_US		100U
+#endif
+
+#define SMC_BENCH_UART_BASE		STM32MP_DEBUG_USART_BASE
+
+/* Clock queried through SCMI, exposed to agent 0 on all STM32MP15 boards */
+#define SMC_BENCH_SCMI_CLOCK_ID		CK_SCMI0_MPU
+#define SMC_BENCH_SCMI_CLOCK_RATE_GET	0x6U
+
+/* OTP word read through the BSEC service */
+#define SMC_BENCH_BSEC_OTP		0U
+
+/* SMT shared memory layout, see drivers/scmi-msg/smt.c */
+struct smt_header {
+	uint32_t reserved0;
+	uint32_t status;
+	uint64_t reserved1;
+	uint32_t flags;
+	uint32_t length;
+	uint32_t message_header;
+	uint32_t payload[];
+};
+
+#define SMT_STATUS_ERROR		BIT_32(1)
+#define SMT_HEADER(_msg_id, _prot_id) \
+	(((_msg_id) & GENMASK_32(7, 0)) | \
+	 (((_prot_id) << 10) & GENMASK_32(17, 10)))
+
+struct smc_bench {
+	const char *name;
+	bool (*call)(void);
+};
+
+void smc_bench_main(void);
+
+static uint32_t cycles[SMC_BENCH_ITERATIONS];
+static uint32_t ticks[SMC_BENCH_ITERATIONS];
+
+static uint32_t smc_bench_smc(uint32_t fid, uint32_t a1, uint32_t a2,
+			      uint32_t a3)
+{
+	register uint32_t r0 __asm__("r0") = fid;
+	register uint32_t r1 __asm__("r1") = a1;
+	register uint32_t r2 __asm__("r2") = a2;
+	register uint32_t r3 __asm__("r3") = a3;
+
+	__asm__ volatile(".arch_extension sec\n"
+			 "smc	#0\n"
+			 : "+r" (r0), "+r" (r1), "+r" (r2), "+r" (r3)
+			 :
+			 : "memory");
+
+	return r0;
+}
+
+/* SMC returning values in r1 to r4 */
+static uint32_t smc_bench_smc_ret(uint32_t fid, uint32_t a1, uint32_t a2,
+				  uint32_t ret[4])
+{
+	register uint32_t r0 __asm__("r0") = fid;
+	register uint32_t r1 __asm__("r1") = a1;
+	register uint32_t r2 __asm__("r2") = a2;
+	register uint32_t r3 __asm__("r3") = 0U;
+	register uint32_t r4 __asm__("r4") = 0U;
+
+	__asm__ volatile(".arch_extension sec\n"
+			 "smc	#0\n"
+			 : "+r" (r0), "+r" (r1), "+r" (r2), "+r" (r3),
+			   "+r" (r4)
+			 :
+			 : "memory");
+
+	ret[0] = r1;
+	ret[1] = r2;
+	ret[2] = r3;
+	ret[3] = r4;
+
+	return r0;
+}
+
+static void smc_bench_putc(char c)
+{
+	while ((mmio_read_32(SMC_BENCH_UART_BASE + USART_ISR) &
+		USART_ISR_TXE) == 0U) {
+		;
+	}
+
+	mmio_write_32(SMC_BENCH_UART_BASE + USART_TDR, (uint32_t)c);
+}
+
+static void smc_bench_puts(const char *str)
+{
+	while (*str != '\0') {
+		if (*str == '\n') {
+			smc_bench_putc('\r');
+		}
+
+		smc_bench_putc(*str++);
+	}
+}
+
+/* Decimal output without division, no support library is linked */
+static void smc_bench_putu(uint32_t value)
+{
+	static const uint32_t pow10[] = {
+		1000000000U, 100000000U, 10000000U, 1000000U, 100000U,
+		10000U, 1000U, 100U, 10U, 1U,
+	};
+	bool leading = true;
+	unsigned int n;
+
+	for (n = 0U; n < ARRAY_SIZE(pow10); n++) {
+		char digit = '0';
+
+		while (value >= pow10[n]) {
+			value -= pow10[n];
+			digit++;
+		}
+
+		if ((digit != '0') || !leading || (pow10[n] == 1U)) {
+			smc_bench_putc(digit);
+			leading = false;
+		}
+	}
+}
+
+static void smc_bench_field(const char *name, uint32_t value)
+{
+	smc_bench_puts(name);
+	smc_bench_putu(value);
+}
+
+static uint32_t smc_bench_udiv64(uint64_t dividend, uint32_t divisor)
+{
+	uint64_t quotient = 0U;
+	uint64_t remainder = 0U;
+	int bit;
+
+	for (bit = 63; bit >= 0; bit--) {
+		remainder = (remainder << 1) | ((dividend >> bit) & 1U);
+		if (remainder >= divisor) {
+			remainder -= divisor;
+			quotient |= 1ULL << bit;
+		}
+	}
+
+	return (uint32_t)quotient;
+}
+
+static void smc_bench_sort(uint32_t *samples, unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 1U; i < count; i++) {
+		uint32_t value = samples[i];
+		unsigned int j = i;
+
+		while ((j > 0U) && (samples[j - 1U] > value)) {
+			samples[j] = samples[j - 1U];
+			j--;
+		}
+
+		samples[j] = value;
+	}
+}
+
+static void smc_bench_report(const char *name, const char *unit,
+			     uint32_t *samples, unsigned int count,
+			     unsigned int errors)
+{
+	uint64_t sum = 0U;
+	unsigned int n;
+
+	smc_bench_sort(samples, count);
+
+	for (n = 0U; n < count; n++) {
+		sum += samples[n];
+	}
+
+	smc_bench_puts("SMC_BENCH name=");
+	smc_bench_puts(name);
+	smc_bench_puts(" unit=");
+	smc_bench_puts(unit);
+	smc_bench_field(" n=", count);
+	smc_bench_field(" err=", errors);
+	smc_bench_field(" min=", samples[0]);
+	smc_bench_field(" avg=", smc_bench_udiv64(sum, count));
+	/* Sample below which 99% of the sorted samples lie */
+	smc_bench_field(" p99=", samples[count - 1U - (count / 100U)]);
+	smc_bench_field(" max=", samples[count - 1U]);
+	smc_bench_puts("\n");
+}
+
+static bool smc_bench_psci_version(void)
+{
+	return smc_bench_smc(PSCI_VERSION, 0U, 0U, 0U) !=
+	       (uint32_t)PSCI_E_NOT_SUPPORTED;
+}
+
+static bool smc_bench_trng_rnd32(void)
+{
+	return smc_bench_smc(ARM_TRNG_RND32, 32U, 0U, 0U) == 0U;
+}
+
+static bool smc_bench_bsec_read(void)
+{
+	return smc_bench_smc(STM32_SMC_BSEC, STM32_SMC_READ_SHADOW,
+			     SMC_BENCH_BSEC_OTP, 0U) == STM32_SMC_OK;
+}
+
+static bool smc_bench_scmi_clock_rate_get(void)
+{
+	struct smt_header *smt = (void *)STM32MP_SCMI_NS_SHM_BASE;
+
+	/* Message posted through the SMT is part of the measured call */
+	smt->message_header = SMT_HEADER(SMC_BENCH_SCMI_CLOCK_RATE_GET,
+					 SCMI_PROTOCOL_ID_CLOCK);
+	smt->payload[0] = SMC_BENCH_SCMI_CLOCK_ID;
+	smt->length = sizeof(smt->message_header) + sizeof(uint32_t);
+	smt->flags = 0U;
+	smt->status = 0U;
+	dsb();
+
+	smc_bench_smc(STM32_SIP_SMC_SCMI_AGENT0, 0U, 0U, 0U);
+
+	return ((smt->status & SMT_STATUS_ERROR) == 0U) &&
+	       (smt->payload[0] == (uint32_t)SCMI_SUCCESS);
+}
+
+static const struct smc_bench smc_bench[] = {
+	{
+		.name = "psci_version",
+		.call = smc_bench_psci_version,
+	},
+	{
+		.name = "scmi_clock_rate_get",
+		.call = smc_bench_scmi_clock_rate_get,
+	},
+	{
+		.name = "bsec_read_shadow",
+		.call = smc_bench_bsec_read,
+	},
+	{
+		.name = "trng_rnd32",
+		.call = smc_bench_trng_rnd32,
+	},
+};
+
+static void smc_bench_run(const struct smc_bench *bench)
+{
+	unsigned int errors = 0U;
+	unsigned int n;
+
+	/* Warm up caches and branch predictors on both sides */
+	for (n = 0U; n < 16U; n++) {
+		(void)bench->call();
+	}
+
+	for (n = 0U; n < SMC_BENCH_ITERATIONS; n++) {
+		uint32_t cycle_start;
+		uint64_t tick_start;
+		bool ok;
+
+		isb();
+		tick_start = read_cntpct_el0();
+		cycle_start = read_pmccntr();
+
+		ok = bench->call();
+
+		isb();
+		cycles[n] = read_pmccntr() - cycle_start;
+		ticks[n] = (uint32_t)(read_cntpct_el0() - tick_start);
+
+		if (!ok) {
+			errors++;
+		}
+	}
+
+	smc_bench_report(bench->name, "cycles", cycles, SMC_BENCH_ITERATIONS,
+			 errors);
+	smc_bench_report(bench->name, "ticks", ticks, SMC_BENCH_ITERATIONS,
+			 errors);
+}
+
+/* PMCCNTR cycles per generic timer tick, in 1/256 */
+static uint32_t smc_bench_cycles_per_tick(void)
+{
+	uint32_t cycle_start;
+	uint64_t tick_start;
+
+	isb();
+	tick_start = read_cntpct_el0();
+	cycle_start = read_pmccntr();
+
+	while ((read_cntpct_el0() - tick_start) < 4096U) {
+		;
+	}
+
+	return smc_bench_udiv64((uint64_t)(read_pmccntr() - cycle_start) << 8,
+				4096U);
+}
+
+static void smc_bench_it_field(const char *name, uint32_t ticks,
+			       uint32_t cycles_per_tick, bool cycles)
+{
+	if (cycles) {
+		ticks = (uint32_t)(((uint64_t)ticks * cycles_per_tick) >> 8);
+	}
+
+	smc_bench_field(name, ticks);
+}
+
+static void smc_bench_it_report(const char *load, uint32_t cycles_per_tick)
+{
+	uint32_t stats[4] = { 0U };
+	uint32_t bucket;
+	unsigned int unit;
+
+	if (smc_bench_smc_ret(STM32_SMC_IT_LATENCY, STM32_SMC_IT_LATENCY_READ,
+			      0U, stats) != STM32_SMC_OK) {
+		return;
+	}
+
+	for (unit = 0U; unit < 2U; unit++) {
+		bool cycles = unit != 0U;
+
+		smc_bench_puts("IT_LATENCY load=");
+		smc_bench_puts(load);
+		smc_bench_puts(cycles ? " unit=cycles" : " unit=ticks");
+		smc_bench_field(" n=", stats[0]);
+		smc_bench_it_field(" min=", stats[1], cycles_per_tick, cycles);
+		smc_bench_it_field(" avg=", stats[3], cycles_per_tick, cycles);
+		smc_bench_it_field(" max=", stats[2], cycles_per_tick, cycles);
+		smc_bench_puts("\n");
+	}
+
+	for (bucket = 0U; bucket < STM32_SMC_IT_LATENCY_BUCKETS; bucket++) {
+		uint32_t count[4] = { 0U };
+
+		if ((smc_bench_smc_ret(STM32_SMC_IT_LATENCY,
+				       STM32_SMC_IT_LATENCY_HIST, bucket,
+				       count) != STM32_SMC_OK) ||
+		    (count[0] == 0U)) {
+			continue;
+		}
+
+		smc_bench_puts("IT_LATENCY_HIST load=");
+		smc_bench_puts(load);
+		smc_bench_field(" ticks=", (bucket == 0U) ? 0U : BIT_32(bucket));
+		smc_bench_field(" n=", count[0]);
+		smc_bench_puts("\n");
+	}
+}
+
+/*
+ * Interrupt latency with the normal world issuing SMCs, during which the
+ * FIQ is masked, then idle for the same duration.
+ */
+static void smc_bench_it_latency(void)
+{
+	uint32_t cycles_per_tick = smc_bench_cycles_per_tick();
+	uint64_t tick_start;
+	uint64_t duration;
+	unsigned int n;
+	unsigned int i;
+
+	if (smc_bench_smc(STM32_SMC_IT_LATENCY, STM32_SMC_IT_LATENCY_START,
+			  SMC_BENCH_IT_PERIOD_US, 0U) != STM32_SMC_OK) {
+		smc_bench_puts("IT_LATENCY not supported\n");
+		return;
+	}
+
+	tick_start = read_cntpct_el0();
+
+	for (n = 0U; n < SMC_BENCH_ITERATIONS; n++) {
+		for (i = 0U; i < ARRAY_SIZE(smc_bench); i++) {
+			(void)smc_bench[i].call();
+		}
+	}
+
+	duration = read_cntpct_el0() - tick_start;
+
+	(void)smc_bench_smc(STM32_SMC_IT_LATENCY, STM32_SMC_IT_LATENCY_STOP,
+			    0U, 0U);
+	smc_bench_it_report("smc", cycles_per_tick);
+
+	(void)smc_bench_smc(STM32_SMC_IT_LATENCY, STM32_SMC_IT_LATENCY_START,
+			    SMC_BENCH_IT_PERIOD_US, 0U);
+
+	tick_start = read_cntpct_el0();
+	while ((read_cntpct_el0() - tick_start) < duration) {
+		;
+	}
+
+	(void)smc_bench_smc(STM32_SMC_IT_LATENCY, STM32_SMC_IT_LATENCY_STOP,
+			    0U, 0U);
+	smc_bench_it_report("idle", cycles_per_tick);
+}
+
+void smc_bench_main(void)
+{
+	unsigned int n;
+
+	/* Enable and reset the cycle counter, counting every cycle */
+	write_pmcr((read_pmcr() & ~(PMCR_DP_BIT | PMCR_LC_BIT)) |
+		   PMCR_E_BIT | PMCR_C_BIT);
+	write_pmcntenset(PMCNTENSET_C_BIT);
+	isb();
+
+	smc_bench_puts("SMC_BENCH_START");
+	smc_bench_field(" iterations=", SMC_BENCH_ITERATIONS);
+	smc_bench_field(" cntfrq=", read_cntfrq_el0());
+	smc_bench_puts("\n");
+
+	for (n = 0U; n < ARRAY_SIZE(smc_bench); n++) {
+		smc_bench_run(&smc_bench[n]);
+	}
+
+	/* Secure interrupts preempt the normal world */
+	enable_fiq();
+	smc_bench_it_latency();
+
+	smc_bench_puts("SMC_BENCH_END\n");
+}
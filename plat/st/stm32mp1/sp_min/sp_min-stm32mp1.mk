@@ -9,6 +9,7 @@ $(error "SP_min is not supported on STM32MP13 platform")
 endif
 
 SP_MIN_WITH_SECURE_FIQ	:=	1
+SP_MIN_LAZY_BANKED_REGS	:=	1
 
 override ENABLE_PIE	:=	1
 BL32_CFLAGS		+=	-fpie -DENABLE_PIE
@@ -21,8 +22,13 @@ BL32_SOURCES		+=	drivers/st/clk/stm32mp1_calib.c			\
 				drivers/st/rng/stm32_rng.c			\
 				drivers/st/rtc/stm32_rtc.c			\
 				drivers/st/tamper/stm32_tamp.c			\
+				drivers/st/thermal/stm32_dts.c			\
 				drivers/st/timer/stm32_timer.c 			\
+				lib/locks/sync_flag/sync_flag.c			\
 				plat/common/aarch32/platform_mp_stack.S		\
+				plat/st/common/stm32mp_deferred_work.c		\
+				plat/st/common/stm32mp_fdt_batch.c		\
+				plat/st/common/stm32mp_sec_timer.c		\
 				plat/st/stm32mp1/sp_min/sp_min_setup.c		\
 				plat/st/stm32mp1/stm32mp1_low_power.c		\
 				plat/st/stm32mp1/stm32mp1_pm.c			\
@@ -47,8 +53,11 @@ BL32_SOURCES		+=	plat/common/plat_psci_common.c
 # SCMI server drivers
 BL32_SOURCES		+=	drivers/scmi-msg/base.c		\
 				drivers/scmi-msg/clock.c		\
+				drivers/scmi-msg/delayed.c		\
 				drivers/scmi-msg/entry.c		\
+				drivers/scmi-msg/perf.c		\
 				drivers/scmi-msg/reset_domain.c	\
+				drivers/scmi-msg/sensor.c		\
 				drivers/scmi-msg/smt.c
 
 # stm32mp1 specific services
@@ -62,4 +71,47 @@ BL32_SOURCES		+=	plat/st/stm32mp1/services/bsec_svc.c		\
 # Arm Archtecture services
 BL32_SOURCES		+=	services/arm_arch_svc/arm_arch_svc_setup.c
 
+# TRNG service, using the RNG
+ifeq (${TRNG_SUPPORT},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_trng.c
+endif
+
 BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_critic_power.c
+
+ifeq (${STM32MP_LP_TIMELINE},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_lp_timeline.c
+endif
+
+ifeq (${STM32MP_LP_GOVERNOR},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_lp_governor.c
+endif
+
+ifeq (${STM32MP_BL2_HANDOFF},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_handoff.c
+endif
+
+ifeq (${STM32MP_DDR_SCRUB},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_ddr_scrub.c
+endif
+
+ifeq (${STM32MP_IT_LATENCY},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_it_latency.c
+endif
+
+ifeq (${STM32MP_PERF_SNAPSHOT},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/stm32mp1_perf_snapshot.c
+endif
+
+ifeq (${STM32MP_SCMI_STATS},1)
+BL32_CFLAGS		+=	-DSCMI_MSG_STATS=1
+BL32_SOURCES		+=	drivers/scmi-msg/stats.c
+endif
+
+ifeq (${STM32MP_SIP_REG_BATCH},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/services/reg_batch_svc.c
+endif
+
+ifeq (${STM32MP_SIP_RESUMABLE},1)
+BL32_SOURCES		+=	plat/st/stm32mp1/services/resume_svc.c
+endif
+
@@ -17,11 +17,13 @@
 #include <drivers/arm/gicv2.h>
 #include <drivers/arm/tzc400.h>
 #include <drivers/clk.h>
+#include <drivers/delay_timer.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/regulator.h>
 #include <drivers/st/bsec.h>
 #include <drivers/st/etzpc.h>
 #include <drivers/st/regulator_fixed.h>
+#include <drivers/st/stm32_dts.h>
 #include <drivers/st/stm32_gpio.h>
 #include <drivers/st/stm32_iwdg.h>
 #include <drivers/st/stm32_rng.h>
@@ -41,10 +43,25 @@
 #include <plat/common/platform.h>
 
 #include <platform_sp_min.h>
+#include <stm32mp1_boot_trace.h>
 #include <stm32mp1_context.h>
+#include <stm32mp1_ddr_scrub.h>
+#include <stm32mp1_handoff.h>
+#include <stm32mp1_it_latency.h>
 #include <stm32mp1_low_power.h>
+#include <stm32mp1_lp_governor.h>
+#include <stm32mp1_lp_timeline.h>
+#include <stm32mp1_mem_usage.h>
 #include <stm32mp1_power_config.h>
 #include <stm32mp1_smc.h>
+#include <stm32mp_boot_timeline.h>
+#include <stm32mp_deferred_work.h>
+#include <stm32mp_fdt_batch.h>
+#include <stm32mp_log_ring.h>
+#include <stm32mp_sec_timer.h>
+
+/* Longest sleep of the polling loops waiting for an event */
+#define STM32MP_EVTSTRM_PERIOD_US	U(10)
 
 /******************************************************************************
  * Placeholder variables for copying the arguments that have been passed to
@@ -71,7 +88,7 @@ static int stm32mp1_tamper_action(int id)
 	return 1; /* ack TAMPER and reset system */
 }
 
-static void stm32_sgi1_it_handler(void)
+static void stm32_sgi1_it_handler(uint32_t sgi_id)
 {
 	uint32_t id;
 
@@ -81,7 +98,7 @@ static void stm32_sgi1_it_handler(void)
 	stm32mp_dump_core_registers(false);
 #endif
 
-	gicv2_end_of_interrupt(ARM_IRQ_SEC_SGI_1);
+	gicv2_end_of_interrupt(sgi_id);
 
 	do {
 		id = plat_ic_get_pending_interrupt_id();
@@ -96,6 +113,76 @@ static void stm32_sgi1_it_handler(void)
 	stm32mp_wait_cpu_reset();
 }
 
+static void stm32_iwdg_fiq_handler(uint32_t id)
+{
+	(void)plat_crash_console_init();
+
+	stm32_iwdg_it_handler((int)id);
+}
+
+static void stm32_tamp_fiq_handler(uint32_t id __unused)
+{
+	stm32_tamp_it_handler();
+}
+
+static void stm32_deferred_work_fiq_handler(uint32_t id __unused)
+{
+	stm32mp_deferred_work_it_handler();
+}
+
+static void stm32_sec_timer_fiq_handler(uint32_t id __unused)
+{
+	stm32mp_sec_timer_it_handler();
+}
+
+static void stm32_sgi6_it_handler(uint32_t id)
+{
+	/* tell the primary cpu to exit from stm32_pwr_down_wfi() */
+	if (plat_my_core_pos() == STM32MP_PRIMARY_CPU) {
+		stm32mp1_calib_set_wakeup(true);
+	}
+
+	gicv2_end_of_interrupt(id);
+}
+
+/* The MCU event either rings the M4 SCMI doorbell or requests a calibration */
+static void stm32_mcu_sev_it_handler(uint32_t id)
+{
+	if (!stm32mp1_scmi_m4_it_handler()) {
+		stm32mp1_calib_it_handler(id);
+		return;
+	}
+
+	mmio_write_32(EXTI_BASE + EXTI_RPR3, EXTI_RPR3_RPIF65);
+	mmio_write_32(EXTI_BASE + EXTI_FPR3, EXTI_FPR3_FPIF65);
+
+	gicv2_end_of_interrupt(id);
+}
+
+/*
+ * Secure interrupts with a fixed ID. The IWDG pre-timeouts are registered
+ * first so that their lookup is the shortest.
+ */
+static void register_interrupt_handlers(void)
+{
+	stm32mp_gic_register_handler(STM32MP1_IRQ_IWDG1,
+				     stm32_iwdg_fiq_handler);
+	stm32mp_gic_register_handler(STM32MP1_IRQ_IWDG2,
+				     stm32_iwdg_fiq_handler);
+	stm32mp_gic_register_handler(ARM_IRQ_SEC_SGI_1, stm32_sgi1_it_handler);
+	stm32mp_gic_register_handler(ARM_IRQ_SEC_SGI_6, stm32_sgi6_it_handler);
+	stm32mp_gic_register_handler(STM32MP1_IRQ_RCC_WAKEUP,
+				     stm32mp1_calib_it_handler);
+	stm32mp_gic_register_handler(ARM_IRQ_SEC_PHY_TIMER,
+				     stm32_sec_timer_fiq_handler);
+	stm32mp_gic_register_handler(STM32MP1_IRQ_MCU_SEV,
+				     stm32_mcu_sev_it_handler);
+	stm32mp_gic_register_handler(STM32MP1_IRQ_TAMPSERRS,
+				     stm32_tamp_fiq_handler);
+	stm32mp_gic_register_handler(STM32MP_IRQ_SEC_DEFERRED_WORK,
+				     stm32_deferred_work_fiq_handler);
+}
+
 static void configure_wakeup_interrupt(void)
 {
 	int irq_num = fdt_rcc_enable_it("wakeup");
@@ -111,6 +198,7 @@ static void configure_wakeup_interrupt(void)
 static void initialize_pll1_settings(void)
 {
 	uint32_t cpu_voltage = 0U;
+	bool from_bl2;
 
 	if (stm32_are_pll1_settings_valid_in_context()) {
 		return;
@@ -134,7 +222,9 @@ static void initialize_pll1_settings(void)
 
 		cpu_voltage = (uint32_t)ret;
 
-		if (stm32mp1_clk_compute_all_pll1_settings(cpu_voltage) != 0) {
+		from_bl2 = stm32mp1_handoff_load_pll1_settings(cpu_voltage);
+		if (!from_bl2 &&
+		    (stm32mp1_clk_compute_all_pll1_settings(cpu_voltage) != 0)) {
 			panic();
 		}
 
@@ -156,6 +246,13 @@ static void initialize_pll1_settings(void)
 
 			cpu_voltage = voltage_mv;
 		}
+	} else {
+		from_bl2 = stm32mp1_handoff_load_pll1_settings(cpu_voltage);
+	}
+
+	/* OPP set from BL2 settings, they already match PLL1 registers */
+	if (from_bl2) {
+		return;
 	}
 
 	if (stm32mp1_clk_compute_all_pll1_settings(cpu_voltage) != 0) {
@@ -187,43 +284,16 @@ static void disable_usb_phy_regulator(void)
  ******************************************************************************/
 void sp_min_plat_fiq_handler(uint32_t id)
 {
-	bool unrecoverable_err = false;
+	id &= INT_ID_MASK;
 
-	switch (id & INT_ID_MASK) {
-	case ARM_IRQ_SEC_PHY_TIMER:
-	case STM32MP1_IRQ_MCU_SEV:
-	case STM32MP1_IRQ_RCC_WAKEUP:
-		stm32mp1_calib_it_handler(id);
-		break;
-	case STM32MP1_IRQ_TAMPSERRS:
-		stm32_tamp_it_handler();
-		break;
-	case ARM_IRQ_SEC_SGI_1:
-		stm32_sgi1_it_handler();
-		break;
-	case ARM_IRQ_SEC_SGI_6:
-		/* tell the primary cpu to exit from stm32_pwr_down_wfi() */
-		if (plat_my_core_pos() == STM32MP_PRIMARY_CPU) {
-			stm32mp1_calib_set_wakeup(true);
-		}
-		gicv2_end_of_interrupt(ARM_IRQ_SEC_SGI_6);
-		break;
-	default:
-		unrecoverable_err = true;
-		break;
-	}
-
-	if (!unrecoverable_err) {
+	if (stm32mp_gic_dispatch(id) || stm32_rng_it_handler(id) ||
+	    stm32mp1_scmi_it_handler(id)) {
 		return;
 	}
 
 	(void)plat_crash_console_init();
 
-	switch (id & INT_ID_MASK) {
-	case STM32MP1_IRQ_IWDG1:
-	case STM32MP1_IRQ_IWDG2:
-		stm32_iwdg_it_handler(id);
-		break;
+	switch (id) {
 	case STM32MP1_IRQ_TZC400:
 		tzc400_init(STM32MP1_TZC_BASE);
 		(void)tzc400_it_handler();
@@ -294,6 +364,9 @@ entry_point_info_t *sp_min_plat_get_bl33_ep_info(void)
 			panic();
 		}
 
+		stm32mp1_lp_timeline_end(LP_TL_STANDBY_RESUME);
+		stm32mp1_lp_governor_exit();
+
 		stm32mp_set_console_after_standby();
 
 		cpu_context = cm_get_context(NON_SECURE);
@@ -349,7 +422,7 @@ static void stm32mp1_etzpc_early_setup(void)
 	etzpc_configure_tzma(STM32MP1_ETZPC_TZMA_SYSRAM, TZMA1_SECURE_RANGE);
 }
 
-static void update_fdt_scmi_node(void *external_fdt)
+static void update_fdt_scmi_node(const void *external_fdt)
 {
 	int nodeoff;
 	const fdt32_t *cuint;
@@ -372,19 +445,19 @@ static void update_fdt_scmi_node(void *external_fdt)
 
 	val = fdt32_to_cpu(*cuint);
 
-	fdt_setprop_string(external_fdt, nodeoff, "compatible", "arm,scmi-smc");
-	fdt_delprop(external_fdt, nodeoff, "linaro,optee-channel-id");
-	fdt_setprop_u32(external_fdt, nodeoff, "arm,smc-id",
-			STM32_SIP_SMC_SCMI_AGENT0 + val);
+	stm32mp_fdt_batch_setprop_string(nodeoff, "compatible", "arm,scmi-smc");
+	stm32mp_fdt_batch_delprop(nodeoff, "linaro,optee-channel-id");
+	stm32mp_fdt_batch_setprop_u32(nodeoff, "arm,smc-id",
+				      STM32_SIP_SMC_SCMI_AGENT0 + val);
 }
 
-static void update_fdt_optee_node(void *external_fdt)
+static void update_fdt_optee_node(const void *external_fdt)
 {
 	int nodeoff;
 
 	nodeoff = fdt_path_offset(external_fdt, "/firmware/optee");
 	if (nodeoff >= 0) {
-		fdt_del_node(external_fdt, nodeoff);
+		stm32mp_fdt_batch_del_node(nodeoff);
 	}
 	/* the reserved memory nodes are kept */
 }
@@ -394,9 +467,12 @@ static void populate_ns_dt(u_register_t ns_dt_addr)
 	void *external_fdt = (void *)ns_dt_addr;
 	int ret;
 
-	/* Map beginning of DDR as non-secure for non-secure DT update */
+	/*
+	 * Map beginning of DDR as non-secure for non-secure DT update, cacheable
+	 * as the whole DT is read and written back, and flushed before unmap.
+	 */
 	ret = mmap_add_dynamic_region(ns_dt_addr, ns_dt_addr, STM32MP_HW_CONFIG_MAX_SIZE,
-				      MT_NON_CACHEABLE | MT_EXECUTE_NEVER | MT_RW | MT_NS);
+				      MT_MEMORY | MT_EXECUTE_NEVER | MT_RW | MT_NS);
 	assert(ret == 0);
 
 	if (fdt_check_header(external_fdt) != 0) {
@@ -404,22 +480,33 @@ static void populate_ns_dt(u_register_t ns_dt_addr)
 		goto out;
 	}
 
-	ret = fdt_open_into(external_fdt, external_fdt, STM32MP_HW_CONFIG_MAX_SIZE);
-	if (ret < 0) {
-		WARN("Error opening DT %i\n", ret);
-		goto out;
-	}
+	/* Record the updates, applied in a single pass over the DT */
+	stm32mp_fdt_batch_init(external_fdt);
 
 	update_fdt_scmi_node(external_fdt);
 
 	update_fdt_optee_node(external_fdt);
 
-	ret = fdt_pack(external_fdt);
+#if STM32MP_LOG_RING
+	if (stm32mp_log_ring_dt_fixup() != 0) {
+		WARN("Log ring not reserved in DT\n");
+	}
+#endif
+
+#if STM32MP_BOOT_TRACE
+	if (stm32mp1_boot_trace_dt_fixup() != 0) {
+		WARN("Boot trace not reserved in DT\n");
+	}
+#endif
+
+	ret = stm32mp_fdt_batch_apply(external_fdt, STM32MP_HW_CONFIG_MAX_SIZE);
 	if (ret < 0) {
-		WARN("Error packing DT %i\n", ret);
+		WARN("Error updating DT %i\n", ret);
 	}
 
 out:
+	flush_dcache_range(ns_dt_addr, STM32MP_HW_CONFIG_MAX_SIZE);
+
 	ret = mmap_remove_dynamic_region(ns_dt_addr, STM32MP_HW_CONFIG_MAX_SIZE);
 	assert(ret == 0);
 }
@@ -433,6 +520,10 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 	bl_params_t *params_from_bl2 = (bl_params_t *)arg0;
 	uintptr_t dt_addr = arg1;
 
+	stm32mp1_mem_usage_paint_stacks();
+
+	stm32mp_log_ring_init();
+
 	stm32mp_setup_early_console();
 
 	/* Imprecise aborts can be masked in NonSecure */
@@ -444,6 +535,8 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 
 	configure_mmu();
 
+	stm32mp_boot_timeline_mark(BOOT_TL_BL32_ENTRY, 0U);
+
 	assert(params_from_bl2 != NULL);
 	assert(params_from_bl2->h.type == PARAM_BL_PARAMS);
 	assert(params_from_bl2->h.version >= VERSION_2);
@@ -473,6 +566,8 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 		bl_params = bl_params->next_params_info;
 	}
 
+	stm32mp1_handoff_init(arg3);
+
 	if (dt_open_and_check(dt_addr) < 0) {
 		panic();
 	}
@@ -485,6 +580,8 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 		panic();
 	}
 
+	stm32mp1_boot_trace_start();
+
 	if (stm32mp1_clk_probe() < 0) {
 		panic();
 	}
@@ -494,6 +591,7 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 	stm32mp1_etzpc_early_setup();
 
 	generic_delay_timer_init();
+	timer_evtstrm_init(STM32MP_EVTSTRM_PERIOD_US);
 
 	if (dt_pmic_status() > 0) {
 		initialize_pmic();
@@ -532,6 +630,12 @@ static void init_sec_peripherals(void)
 		WARN("RNG driver init error %i\n", ret);
 	}
 
+	/* Init temperature sensor driver */
+	ret = stm32_dts_init();
+	if (ret < 0) {
+		WARN("DTS driver init error %i\n", ret);
+	}
+
 	/* Init tamper */
 	if (stm32_tamp_init() > 0) {
 		struct bkpregs_conf bkpregs_conf = {
@@ -575,6 +679,8 @@ void sp_min_platform_setup(void)
 
 	stm32mp_gic_init();
 
+	register_interrupt_handlers();
+
 	init_sec_peripherals();
 
 	if (stm32_iwdg_init() < 0) {
@@ -587,10 +693,18 @@ void sp_min_platform_setup(void)
 
 	stm32mp1_init_scmi_server();
 
+	stm32mp1_ddr_scrub_init();
+
+	stm32mp1_it_latency_init();
+
 	/* Cold boot: clean-up regulators state */
 	if (get_saved_pc() == 0U) {
 		regulator_core_cleanup();
 	}
+
+	stm32mp1_boot_trace_stop();
+
+	stm32mp_boot_timeline_mark(BOOT_TL_BL32_SETUP_END, 0U);
 }
 
 void sp_min_plat_arch_setup(void)
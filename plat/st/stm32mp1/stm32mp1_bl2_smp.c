@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/arm/gicv2.h>
+#include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <lib/mmio.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_mmu_helpers.h>
+
+#include <platform_def.h>
+#include <stm32mp1_bl2_smp.h>
+#include <stm32mp_common.h>
+#include <stm32mp_dt.h>
+
+#define BL2_SMP_WAKEUP_TIMEOUT_US	1000U
+
+/* Core 1 states, written by the core owning the transition */
+#define BL2_SMP_OFF			0U
+#define BL2_SMP_IDLE			1U
+#define BL2_SMP_STOP			2U
+
+/* Set up by setup_mmu_cfg() on core 0 and read by core 1 with its MMU off */
+extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
+extern uint8_t stm32mp1_bl2_smp_stack[];
+
+/*
+ * Job queue shared between both cores. Core 1 joins coherency before
+ * accessing it. Jobs are run in order: head counts the jobs queued by
+ * core 0, tail the jobs completed by core 1, which records the first
+ * error met until core 0 collects it.
+ */
+static struct {
+	struct {
+		int (*job)(void *arg);
+		void *arg;
+	} queue[STM32MP1_BL2_SMP_QUEUE_SIZE];
+	unsigned int head;
+	unsigned int tail;
+	int result;
+	unsigned int state;
+} bl2_smp __aligned(CACHE_WRITEBACK_GRANULE);
+
+static unsigned int bl2_smp_image_id = INVALID_IMAGE_ID;
+static bool bl2_smp_start_failed;
+
+static unsigned int bl2_smp_load(const unsigned int *field)
+{
+	unsigned int val = *(const volatile unsigned int *)field;
+
+	dmbish();
+
+	return val;
+}
+
+static void bl2_smp_store(unsigned int *field, unsigned int val)
+{
+	dmbish();
+	*(volatile unsigned int *)field = val;
+	dsbish();
+	sev();
+}
+
+static unsigned int bl2_smp_get_state(void)
+{
+	return bl2_smp_load(&bl2_smp.state);
+}
+
+static void bl2_smp_set_state(unsigned int state)
+{
+	bl2_smp_store(&bl2_smp.state, state);
+}
+
+void __dead2 stm32mp1_bl2_smp_main(void)
+{
+	bl2_smp_set_state(BL2_SMP_IDLE);
+
+	while (true) {
+		unsigned int tail = bl2_smp.tail;
+
+		if (bl2_smp_load(&bl2_smp.head) != tail) {
+			unsigned int slot = tail % STM32MP1_BL2_SMP_QUEUE_SIZE;
+			int ret;
+
+			ret = bl2_smp.queue[slot].job(bl2_smp.queue[slot].arg);
+			if ((ret != 0) && (bl2_smp.result == 0)) {
+				bl2_smp.result = ret;
+			}
+
+			bl2_smp_store(&bl2_smp.tail, tail + 1U);
+		} else if (bl2_smp_get_state() == BL2_SMP_STOP) {
+			bl2_smp_set_state(BL2_SMP_OFF);
+			stm32mp1_bl2_smp_power_down(stm32mp_rcc_base());
+		} else {
+			wfe();
+		}
+	}
+}
+
+static int bl2_smp_get_gicd_base(uintptr_t *base)
+{
+	struct dt_node_info dt_gic;
+
+	if (dt_get_node(&dt_gic, -1, "arm,cortex-a7-gic") < 0) {
+		return -ENODEV;
+	}
+
+	*base = dt_gic.base;
+
+	return 0;
+}
+
+static int bl2_smp_start(void)
+{
+	uintptr_t bkpr_core1_addr =
+		tamp_bkpr(BOOT_API_CORE1_BRANCH_ADDRESS_TAMP_BCK_REG_IDX);
+	uintptr_t bkpr_core1_magic =
+		tamp_bkpr(BOOT_API_CORE1_MAGIC_NUMBER_TAMP_BCK_REG_IDX);
+	uintptr_t gicd_base;
+	uint64_t timeout;
+	int ret;
+
+	if (stm32mp_is_single_core()) {
+		return -ENOTSUP;
+	}
+
+	ret = bl2_smp_get_gicd_base(&gicd_base);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/*
+	 * Core 1 starts with its MMU and data cache disabled: make the MMU
+	 * configuration, the mailbox and its stack visible in memory.
+	 */
+	flush_dcache_range((uintptr_t)mmu_cfg_params, sizeof(mmu_cfg_params));
+	flush_dcache_range((uintptr_t)&bl2_smp, sizeof(bl2_smp));
+	flush_dcache_range((uintptr_t)stm32mp1_bl2_smp_stack,
+			   STM32MP1_BL2_SMP_STACK_SIZE);
+
+	clk_enable(RTCAPB);
+
+	mmio_write_32(bkpr_core1_addr, (uintptr_t)stm32mp1_bl2_smp_entrypoint);
+	mmio_write_32(bkpr_core1_magic, BOOT_API_A7_CORE1_MAGIC_NUMBER);
+
+	/* Generate an IT to core 1, still in the ROM code wait loop */
+	dsbish();
+	mmio_write_32(gicd_base + GICD_SGIR,
+		      GICV2_SGIR_VALUE(SGIR_TGT_SPECIFIC,
+				       BIT(STM32MP_SECONDARY_CPU),
+				       ARM_IRQ_NON_SEC_SGI_0));
+
+	timeout = timeout_init_us(BL2_SMP_WAKEUP_TIMEOUT_US);
+	while (bl2_smp_get_state() != BL2_SMP_IDLE) {
+		if (timeout_elapsed(timeout)) {
+			ret = -ETIMEDOUT;
+			break;
+		}
+	}
+
+	/* The ROM code has branched, do not let it branch again on reset */
+	mmio_write_32(bkpr_core1_magic, 0U);
+	mmio_write_32(bkpr_core1_addr, 0U);
+
+	clk_disable(RTCAPB);
+
+	if (ret != 0) {
+		WARN("BL2 secondary core not started\n");
+	}
+
+	return ret;
+}
+
+void stm32mp1_bl2_smp_set_image(unsigned int image_id)
+{
+	bl2_smp_image_id = image_id;
+}
+
+/*
+ * Only images BL2 never reads once loaded can be authenticated in
+ * background: the check only has to be completed before BL2 exits.
+ */
+bool stm32mp1_bl2_smp_image_deferrable(void)
+{
+	switch (bl2_smp_image_id) {
+	case BL32_EXTRA1_IMAGE_ID:
+	case BL32_EXTRA2_IMAGE_ID:
+	case BL33_IMAGE_ID:
+	case HW_CONFIG_ID:
+	case TOS_FW_CONFIG_ID:
+		return !stm32mp_is_single_core();
+	default:
+		return false;
+	}
+}
+
+/*
+ * Wait for a free slot in the queue: the job queued STM32MP1_BL2_SMP_QUEUE_SIZE
+ * jobs before the next one is then completed, and its data can be reused.
+ */
+void stm32mp1_bl2_smp_reserve(void)
+{
+	while ((bl2_smp.head - bl2_smp_load(&bl2_smp.tail)) >=
+	       STM32MP1_BL2_SMP_QUEUE_SIZE) {
+		wfe();
+	}
+}
+
+/* Queue a job on core 1, started on first use */
+int stm32mp1_bl2_smp_run(int (*job)(void *arg), void *arg)
+{
+	unsigned int slot;
+
+	if (bl2_smp_get_state() == BL2_SMP_OFF) {
+		int ret;
+
+		if (bl2_smp_start_failed) {
+			return -ENODEV;
+		}
+
+		ret = bl2_smp_start();
+		if (ret != 0) {
+			bl2_smp_start_failed = true;
+			return ret;
+		}
+	}
+
+	stm32mp1_bl2_smp_reserve();
+
+	slot = bl2_smp.head % STM32MP1_BL2_SMP_QUEUE_SIZE;
+	bl2_smp.queue[slot].job = job;
+	bl2_smp.queue[slot].arg = arg;
+	bl2_smp_store(&bl2_smp.head, bl2_smp.head + 1U);
+
+	return 0;
+}
+
+bool stm32mp1_bl2_smp_pending(void)
+{
+	return bl2_smp.head != bl2_smp_load(&bl2_smp.tail);
+}
+
+/* Wait for the queued jobs, if any, and return the first error met */
+int stm32mp1_bl2_smp_wait(void)
+{
+	int ret;
+
+	if (bl2_smp_get_state() == BL2_SMP_OFF) {
+		return 0;
+	}
+
+	while (stm32mp1_bl2_smp_pending()) {
+		wfe();
+	}
+
+	/* Core 1 is idle, the result can be collected */
+	ret = bl2_smp.result;
+	bl2_smp.result = 0;
+
+	return ret;
+}
+
+int stm32mp1_bl2_smp_stop(void)
+{
+	int ret = stm32mp1_bl2_smp_wait();
+
+	if (bl2_smp_get_state() == BL2_SMP_OFF) {
+		return ret;
+	}
+
+	bl2_smp_set_state(BL2_SMP_STOP);
+
+	while (bl2_smp_get_state() != BL2_SMP_OFF) {
+		wfe();
+	}
+
+	return ret;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/mmio.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+#include <stm32mp1_boot_trace.h>
+#include <stm32mp1_dbgmcu.h>
+#include <stm32mp_dt.h>
+#include <stm32mp_fdt_batch.h>
+
+/* CoreSight management registers */
+#define CS_LAR			U(0xFB0)
+#define CS_LAR_KEY		U(0xC5ACCE55)
+
+/* Funnel registers */
+#define CSTF_CTRL		U(0x000)
+
+/* ETF registers */
+#define TMC_STS			U(0x00C)
+#define TMC_RRD			U(0x010)
+#define TMC_CTL			U(0x020)
+#define TMC_MODE		U(0x028)
+#define TMC_FFCR		U(0x304)
+
+#define TMC_STS_FULL		BIT(0)
+#define TMC_STS_READY		BIT(2)
+#define TMC_CTL_CAPT_EN		BIT(0)
+#define TMC_MODE_CIRCULAR	U(0)
+#define TMC_FFCR_EN_FMT		BIT(0)
+#define TMC_FFCR_EN_TI		BIT(1)
+#define TMC_FFCR_FON_FLIN	BIT(4)
+#define TMC_FFCR_FON_TRIG_EVT	BIT(5)
+#define TMC_FFCR_FLUSHMAN	BIT(6)
+#define TMC_FFCR_TRIGON_TRIGIN	BIT(8)
+#define TMC_FFCR_STOP_ON_FL	BIT(12)
+#define TMC_RRD_EMPTY		U(0xFFFFFFFF)
+
+/* ETMv3.5 registers */
+#define ETMCR			U(0x000)
+#define ETMTRIGGER		U(0x008)
+#define ETMSR			U(0x010)
+#define ETMTSSCR		U(0x018)
+#define ETMTEEVR		U(0x020)
+#define ETMTECR1		U(0x024)
+#define ETMSYNCFR		U(0x1E0)
+#define ETMTSEVR		U(0x1F8)
+#define ETMTRACEIDR		U(0x200)
+#define ETMOSLAR		U(0x300)
+#define ETMPDCR			U(0x310)
+
+#define ETMCR_PWD_DWN		BIT(0)
+#define ETMCR_BRANCH_BROADCAST	BIT(8)
+#define ETMCR_PROG		BIT(10)
+#define ETMCR_ETM_EN		BIT(11)
+#define ETMCR_CYC_ACC		BIT(12)
+#define ETMCR_TIMESTAMP_EN	BIT(28)
+#define ETMSR_PROG		BIT(1)
+#define ETMTECR1_EXCLUDE	BIT(24)
+#define ETMPDCR_PWD_UP		BIT(3)
+
+/* Event resource A always true, and never true */
+#define ETM_EVENT_ALWAYS	U(0x6F)
+#define ETM_EVENT_NEVER		U(0x406F)
+#define ETM_SYNC_FREQ		U(0x400)
+
+#define BOOT_TRACE_ID(cpu)	(U(0x10) + (cpu))
+#define BOOT_TRACE_SLOT_SIZE	(STM32MP_BOOT_TRACE_SIZE / 2U)
+
+/* The generic timer may not be initialized yet */
+#define BOOT_TRACE_POLL_LOOPS	U(100000)
+
+#if defined(IMAGE_BL2)
+#define BOOT_TRACE_IMAGE	U(2)
+#else
+#define BOOT_TRACE_IMAGE	U(32)
+#endif
+
+static uintptr_t etm_base;
+static unsigned int etm_cpu;
+
+static bool wait_bits(uintptr_t addr, uint32_t mask, uint32_t val)
+{
+	unsigned int i;
+
+	for (i = 0U; i < BOOT_TRACE_POLL_LOOPS; i++) {
+		if ((mmio_read_32(addr) & mask) == val) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uintptr_t boot_trace_base(void)
+{
+	return STM32MP_DDR_BASE + dt_get_ddr_size() - STM32MP_BOOT_TRACE_SIZE;
+}
+
+static uintptr_t boot_trace_slot(void)
+{
+	uintptr_t slot = boot_trace_base();
+
+#if defined(IMAGE_BL32)
+	slot += BOOT_TRACE_SLOT_SIZE;
+#endif
+
+	return slot;
+}
+
+/*
+ * Capture the trace of the calling core in the ETF, in circular buffer mode.
+ * The ETM traces all instructions, cycle accurate, until the trace is stopped.
+ */
+void stm32mp1_boot_trace_start(void)
+{
+	unsigned int cpu = plat_my_core_pos();
+	uintptr_t etm = CA7_ETM_BASE(cpu);
+
+	if (stm32mp1_dbgmcu_trace_enable() != 0) {
+		return;
+	}
+
+	mmio_write_32(ETF_BASE + CS_LAR, CS_LAR_KEY);
+	if (!wait_bits(ETF_BASE + TMC_STS, TMC_STS_READY, TMC_STS_READY)) {
+		WARN("Boot trace: ETF not ready\n");
+		return;
+	}
+
+	mmio_write_32(ETF_BASE + TMC_MODE, TMC_MODE_CIRCULAR);
+	mmio_write_32(ETF_BASE + TMC_FFCR, TMC_FFCR_EN_FMT | TMC_FFCR_EN_TI |
+		      TMC_FFCR_FON_FLIN | TMC_FFCR_FON_TRIG_EVT |
+		      TMC_FFCR_TRIGON_TRIGIN);
+	mmio_write_32(ETF_BASE + TMC_CTL, TMC_CTL_CAPT_EN);
+
+	mmio_write_32(CSTF_BASE + CS_LAR, CS_LAR_KEY);
+	mmio_setbits_32(CSTF_BASE + CSTF_CTRL, BIT(cpu));
+
+	mmio_write_32(etm + CS_LAR, CS_LAR_KEY);
+	mmio_clrbits_32(etm + ETMCR, ETMCR_PWD_DWN);
+	isb();
+	mmio_setbits_32(etm + ETMPDCR, ETMPDCR_PWD_UP);
+	mmio_write_32(etm + ETMOSLAR, 0U);
+	isb();
+
+	mmio_setbits_32(etm + ETMCR, ETMCR_PROG);
+	if (!wait_bits(etm + ETMSR, ETMSR_PROG, ETMSR_PROG)) {
+		WARN("Boot trace: ETM not programmable\n");
+		return;
+	}
+
+	mmio_clrsetbits_32(etm + ETMCR,
+			   ETMCR_BRANCH_BROADCAST | ETMCR_TIMESTAMP_EN,
+			   ETMCR_ETM_EN | ETMCR_CYC_ACC);
+	mmio_write_32(etm + ETMTRIGGER, ETM_EVENT_NEVER);
+	mmio_write_32(etm + ETMTSSCR, 0U);
+	mmio_write_32(etm + ETMTEEVR, ETM_EVENT_ALWAYS);
+	/* Exclude no address range: trace everything */
+	mmio_write_32(etm + ETMTECR1, ETMTECR1_EXCLUDE);
+	mmio_write_32(etm + ETMSYNCFR, ETM_SYNC_FREQ);
+	mmio_write_32(etm + ETMTSEVR, ETM_EVENT_NEVER);
+	mmio_write_32(etm + ETMTRACEIDR, BOOT_TRACE_ID(cpu));
+
+	mmio_clrbits_32(etm + ETMCR, ETMCR_PROG);
+	if (!wait_bits(etm + ETMSR, ETMSR_PROG, 0U)) {
+		WARN("Boot trace: ETM not started\n");
+		return;
+	}
+
+	etm_base = etm;
+	etm_cpu = cpu;
+}
+
+/* Stop the trace and drain the ETF in the DDR slot of the image */
+void stm32mp1_boot_trace_stop(void)
+{
+	struct stm32mp1_boot_trace *trace;
+	uintptr_t slot = boot_trace_slot();
+	uint32_t max_words;
+	uint32_t words;
+	uint32_t sts;
+
+	if (etm_base == 0U) {
+		return;
+	}
+
+	mmio_setbits_32(etm_base + ETMCR, ETMCR_PROG);
+	(void)wait_bits(etm_base + ETMSR, ETMSR_PROG, ETMSR_PROG);
+	mmio_setbits_32(etm_base + ETMCR, ETMCR_PWD_DWN);
+	etm_base = 0U;
+
+	mmio_setbits_32(ETF_BASE + TMC_FFCR, TMC_FFCR_STOP_ON_FL);
+	mmio_setbits_32(ETF_BASE + TMC_FFCR, TMC_FFCR_FLUSHMAN);
+	if (!wait_bits(ETF_BASE + TMC_FFCR, TMC_FFCR_FLUSHMAN, 0U) ||
+	    !wait_bits(ETF_BASE + TMC_STS, TMC_STS_READY, TMC_STS_READY)) {
+		WARN("Boot trace: ETF flush timeout\n");
+	}
+
+	sts = mmio_read_32(ETF_BASE + TMC_STS);
+
+#if defined(IMAGE_BL32)
+	/* BL2 maps the whole DDR, SP_min only the slot, while it is written */
+	if (mmap_add_dynamic_region(slot, slot, BOOT_TRACE_SLOT_SIZE,
+				    MT_MEMORY | MT_EXECUTE_NEVER | MT_RW |
+				    MT_NS) != 0) {
+		WARN("Boot trace: cannot map 0x%lx\n", slot);
+		mmio_write_32(ETF_BASE + TMC_CTL, 0U);
+		return;
+	}
+#endif
+
+	trace = (struct stm32mp1_boot_trace *)slot;
+	max_words = (BOOT_TRACE_SLOT_SIZE - sizeof(*trace)) / sizeof(uint32_t);
+
+	/* Read from the oldest word, until the buffer is empty */
+	for (words = 0U; words < max_words; words++) {
+		uint32_t word = mmio_read_32(ETF_BASE + TMC_RRD);
+
+		if (word == TMC_RRD_EMPTY) {
+			break;
+		}
+
+		trace->data[words] = word;
+	}
+
+	mmio_write_32(ETF_BASE + TMC_CTL, 0U);
+	mmio_clrbits_32(CSTF_BASE + CSTF_CTRL, BIT(etm_cpu));
+
+	trace->magic = BOOT_TRACE_MAGIC;
+	trace->image = BOOT_TRACE_IMAGE;
+	trace->trace_id = BOOT_TRACE_ID(etm_cpu);
+	trace->flags = ((sts & TMC_STS_FULL) != 0U) ? BOOT_TRACE_WRAPPED : 0U;
+	trace->size = words * sizeof(uint32_t);
+
+	flush_dcache_range(slot, BOOT_TRACE_SLOT_SIZE);
+
+#if defined(IMAGE_BL32)
+	(void)mmap_remove_dynamic_region(slot, BOOT_TRACE_SLOT_SIZE);
+#endif
+
+	INFO("Boot trace: %u bytes at 0x%lx\n", words * 4U, slot);
+}
+
+#if defined(IMAGE_BL32)
+/* Keep the dumps out of the non-secure world memory */
+int stm32mp1_boot_trace_dt_fixup(void)
+{
+	uintptr_t base = boot_trace_base();
+	char name[24];
+
+	(void)snprintf(name, sizeof(name), "tf-a-trace@%x",
+		       (unsigned int)base);
+
+	return stm32mp_fdt_batch_add_reserved_memory(name, base,
+						     STM32MP_BOOT_TRACE_SIZE);
+}
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/utils_def.h>
+
+#include <platform_def.h>
+#include <stm32mp1_cache_bench.h>
+
+#define CACHE_BENCH_BASE	STM32MP_BL33_BASE
+#define CACHE_BENCH_MIN_SIZE	U(0x1000)
+#define CACHE_BENCH_MAX_SIZE	U(0x400000)
+
+/* Dirty the buffer, as an image just loaded, the first lines are evicted */
+static void bench_dirty(size_t size)
+{
+	(void)memset((void *)CACHE_BENCH_BASE, 0x5A, size);
+	dsbsy();
+}
+
+static uint64_t bench_mva(size_t size)
+{
+	uint64_t start;
+
+	bench_dirty(size);
+
+	start = read_cntpct_el0();
+	flush_dcache_range(CACHE_BENCH_BASE, size);
+
+	return read_cntpct_el0() - start;
+}
+
+static uint64_t bench_sw(size_t size)
+{
+	uint64_t start;
+
+	bench_dirty(size);
+
+	start = read_cntpct_el0();
+	dcsw_op_all(DC_OP_CISW);
+
+	return read_cntpct_el0() - start;
+}
+
+void stm32mp1_cache_bench(void)
+{
+	size_t crossover = 0U;
+	size_t size;
+
+	for (size = CACHE_BENCH_MIN_SIZE; size <= CACHE_BENCH_MAX_SIZE;
+	     size *= 2U) {
+		uint64_t mva = bench_mva(size);
+		uint64_t sw = bench_sw(size);
+
+		NOTICE("CACHE_BENCH size=%u mva=%llu sw=%llu\n",
+		       (unsigned int)size, mva, sw);
+
+		if ((crossover == 0U) && (sw < mva)) {
+			crossover = size;
+		}
+	}
+
+	/* Smallest size flushed faster by set/way, 0 if none */
+	NOTICE("CACHE_BENCH crossover=%uKB\n", (unsigned int)(crossover / 1024U));
+}
@@ -5,6 +5,8 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <arch_helpers.h>
@@ -17,6 +19,7 @@
 #include <drivers/st/stm32mp1_ddr_helpers.h>
 #include <drivers/st/stm32mp1_ddr_regs.h>
 #include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/cassert.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/mmio.h>
 #include <lib/utils.h>
@@ -27,11 +30,21 @@
 #include <platform_def.h>
 #include <stm32mp1_context.h>
 #include <stm32mp1_critic_power.h>
+#include <stm32mp1_lp_governor.h>
 
 #define TRAINING_AREA_SIZE		64
 
 #define BL32_CANARY_ID			U(0x424c3332)
 
+/*
+ * BL32_CONTEXT_VERSION relates to struct backup_bl32_data_s layout.
+ *
+ * BL32_CONTEXT_VERSION_1:
+ * Context blocks listed in enum bl32_ctx_block, each with its CRC32.
+ */
+#define BL32_CONTEXT_VERSION_1		U(0x1)
+#define BL32_CONTEXT_VERSION		BL32_CONTEXT_VERSION_1
+
 /*
  * MAILBOX_MAGIC relates to struct backup_data_s as defined
  *
@@ -58,11 +71,6 @@
 #error MAILBOX_MAGIC_V2/_V3 does not support expected PLL1 settings
 #endif
 
-/* pll_settings structure size definitions (reference to clock driver) */
-#define PLL1_SETTINGS_SIZE		(((PLAT_MAX_OPP_NB * \
-					  (PLAT_MAX_PLLCFG_NB + 3)) + 1) * \
-					 sizeof(uint32_t))
-
 /* Set to 600 bytes to be a bit flexible but could be optimized if needed */
 #define CLOCK_CONTEXT_SIZE		600
 
@@ -86,16 +94,6 @@ struct backup_data_s {
 };
 
 #if defined(IMAGE_BL32)
-#define STM32MP1_TZC_REGION_OFFSET(num_region)		(U(0x20) * ((num_region) - U(1)))
-#define STM32MP1_TZC_REGION_LOW(num_region)		(U(0x120) + \
-							 STM32MP1_TZC_REGION_OFFSET(num_region))
-#define STM32MP1_TZC_REGION_TOP(num_region)		(U(0x128) + \
-							 STM32MP1_TZC_REGION_OFFSET(num_region))
-#define STM32MP1_TZC_REGION_ATTRIBUTE(num_region)	(U(0x130) + \
-							 STM32MP1_TZC_REGION_OFFSET(num_region))
-#define STM32MP1_TZC_REGION_ACCESS(num_region)		(U(0x134) + \
-							 STM32MP1_TZC_REGION_OFFSET(num_region))
-
 struct tzc_regions {
 	uint32_t low;
 	uint32_t top;
@@ -103,8 +101,24 @@ struct tzc_regions {
 	uint32_t access;
 };
 
+/*
+ * BL32 context blocks, only rewritten in Backup SRAM when their content
+ * changed since the previous suspend.
+ */
+enum bl32_ctx_block {
+	BL32_CTX_SMC,
+	BL32_CTX_CPU,
+	BL32_CTX_CLOCK,
+	BL32_CTX_SCMI,
+	BL32_CTX_REGUL,
+	BL32_CTX_TZC,
+	BL32_CTX_BLOCK_NB
+};
+
 struct backup_bl32_data_s {
 	uint32_t canary_id;
+	uint32_t version;
+	uint32_t block_crc[BL32_CTX_BLOCK_NB];
 	smc_ctx_t saved_smc_context[PLATFORM_CORE_COUNT];
 	cpu_context_t saved_cpu_context[PLATFORM_CORE_COUNT];
 	struct stm32_rtc_calendar rtc;
@@ -115,11 +129,126 @@ struct backup_bl32_data_s {
 	struct tzc_regions tzc_backup_context[STM32MP1_TZC_MAX_REGIONS];
 };
 
+#define BL32_CTX_BLOCK(_field) \
+	{ \
+		.offset = offsetof(struct backup_bl32_data_s, _field), \
+		.size = sizeof(((struct backup_bl32_data_s *)0)->_field), \
+	}
+
+static const struct {
+	size_t offset;
+	size_t size;
+} bl32_ctx_blocks[BL32_CTX_BLOCK_NB] = {
+	[BL32_CTX_SMC] = BL32_CTX_BLOCK(saved_smc_context),
+	[BL32_CTX_CPU] = BL32_CTX_BLOCK(saved_cpu_context),
+	[BL32_CTX_CLOCK] = BL32_CTX_BLOCK(clock_cfg),
+	[BL32_CTX_SCMI] = BL32_CTX_BLOCK(scmi_context),
+	[BL32_CTX_REGUL] = BL32_CTX_BLOCK(regul_context),
+	[BL32_CTX_TZC] = BL32_CTX_BLOCK(tzc_backup_context),
+};
+
+/* CRC32 of the blocks stored in Backup SRAM, once saved or restored */
+static uint32_t bl32_ctx_crc[BL32_CTX_BLOCK_NB];
+static bool bl32_ctx_crc_valid;
+
+/* Clock configuration gathered before being stored in Backup SRAM */
+static uint8_t clock_cfg[CLOCK_CONTEXT_SIZE];
+
+#if STM32MP_LP_TIMELINE
+CASSERT((sizeof(struct backup_data_s) + sizeof(struct backup_bl32_data_s)) <=
+	(STM32MP_LP_TIMELINE_BASE - STM32MP_BACKUP_RAM_BASE),
+	assert_backup_data_does_not_overlap_lp_timeline);
+#endif
+
+#if STM32MP_DDR_TRAINING_CACHE
+CASSERT((sizeof(struct backup_data_s) + sizeof(struct backup_bl32_data_s)) <=
+	(STM32MP_DDR_TRAINING_BASE - STM32MP_BACKUP_RAM_BASE),
+	assert_backup_data_does_not_overlap_ddr_training);
+#endif
+
+#if STM32MP_LP_GOVERNOR
+CASSERT((sizeof(struct backup_data_s) + sizeof(struct backup_bl32_data_s)) <=
+	(STM32MP_LP_GOVERNOR_BASE - STM32MP_BACKUP_RAM_BASE),
+	assert_backup_data_does_not_overlap_lp_governor);
+#endif
+
 static struct backup_bl32_data_s *get_bl32_backup_data(void)
 {
 	return (struct backup_bl32_data_s *)(STM32MP_BACKUP_RAM_BASE +
 					     sizeof(struct backup_data_s));
 }
+
+/* CRC32 (IEEE 802.3), computed per nibble to keep a small table */
+static uint32_t context_crc32(const void *data, size_t size)
+{
+	static const uint32_t crc_nibble[16] = {
+		0x00000000U, 0x1db71064U, 0x3b6e20c8U, 0x26d930acU,
+		0x76dc4190U, 0x6b6b51f4U, 0x4db26158U, 0x5005713cU,
+		0xedb88320U, 0xf00f9344U, 0xd6d6a3e8U, 0xcb61b38cU,
+		0x9b64c2b0U, 0x86d3d2d4U, 0xa00ae278U, 0xbdbdf21cU,
+	};
+	const uint8_t *buf = data;
+	uint32_t crc = ~0U;
+	size_t i;
+
+	for (i = 0U; i < size; i++) {
+		crc ^= buf[i];
+		crc = (crc >> 4) ^ crc_nibble[crc & 0xFU];
+		crc = (crc >> 4) ^ crc_nibble[crc & 0xFU];
+	}
+
+	return ~crc;
+}
+
+static void *bl32_ctx_block_addr(struct backup_bl32_data_s *backup_data,
+				 enum bl32_ctx_block id)
+{
+	return (uint8_t *)backup_data + bl32_ctx_blocks[id].offset;
+}
+
+/* Write a context block in Backup SRAM, only if its content changed */
+static void bl32_ctx_block_save(struct backup_bl32_data_s *backup_data,
+				enum bl32_ctx_block id, const void *data,
+				size_t size)
+{
+	uint32_t crc;
+
+	assert(size == bl32_ctx_blocks[id].size);
+
+	crc = context_crc32(data, size);
+
+	if (bl32_ctx_crc_valid && (bl32_ctx_crc[id] == crc)) {
+		return;
+	}
+
+	memcpy(bl32_ctx_block_addr(backup_data, id), data, size);
+	backup_data->block_crc[id] = crc;
+	bl32_ctx_crc[id] = crc;
+}
+
+static int bl32_ctx_blocks_check(struct backup_bl32_data_s *backup_data)
+{
+	unsigned int id;
+
+	if (backup_data->version != BL32_CONTEXT_VERSION) {
+		return -EINVAL;
+	}
+
+	for (id = 0U; id < BL32_CTX_BLOCK_NB; id++) {
+		uint32_t crc = context_crc32(bl32_ctx_block_addr(backup_data, id),
+					     bl32_ctx_blocks[id].size);
+
+		if (crc != backup_data->block_crc[id]) {
+			return -EINVAL;
+		}
+
+		bl32_ctx_crc[id] = crc;
+	}
+
+	bl32_ctx_crc_valid = true;
+
+	return 0;
+}
 #endif
 
 uint32_t stm32_pm_get_optee_ep(void)
@@ -163,7 +292,11 @@ void stm32_clean_context(void)
 #if defined(IMAGE_BL2)
 	zeromem((void *)STM32MP_BACKUP_RAM_BASE, sizeof(struct backup_data_s));
 #elif defined(IMAGE_BL32)
-	zeromem((void *)get_bl32_backup_data(), sizeof(struct backup_bl32_data_s));
+	/*
+	 * Only invalidate the BL32 context: blocks are kept in Backup SRAM,
+	 * unchanged ones are not rewritten at next suspend.
+	 */
+	get_bl32_backup_data()->canary_id = 0U;
 #endif
 
 	clk_disable(BKPSRAM);
@@ -172,17 +305,11 @@ void stm32_clean_context(void)
 #if defined(IMAGE_BL32)
 void stm32mp1_pm_save_clock_cfg(size_t offset, uint8_t *data, size_t size)
 {
-	struct backup_bl32_data_s *backup_data = get_bl32_backup_data();
-
-	if (offset + size > sizeof(backup_data->clock_cfg)) {
+	if (offset + size > sizeof(clock_cfg)) {
 		panic();
 	}
 
-	clk_enable(BKPSRAM);
-
-	memcpy(backup_data->clock_cfg + offset, data, size);
-
-	clk_disable(BKPSRAM);
+	memcpy(clock_cfg + offset, data, size);
 }
 
 void stm32mp1_pm_restore_clock_cfg(size_t offset, uint8_t *data, size_t size)
@@ -201,49 +328,43 @@ void stm32mp1_pm_restore_clock_cfg(size_t offset, uint8_t *data, size_t size)
 
 static void tzc_backup_context_save(struct tzc_regions *regions)
 {
+	struct tzc400_region cfg[STM32MP1_TZC_MAX_REGIONS];
 	unsigned int i;
 
 	assert(regions != NULL);
 
-	zeromem(regions, sizeof(struct tzc_regions) * STM32MP1_TZC_MAX_REGIONS);
-
 	tzc400_init(STM32MP1_TZC_BASE);
+	tzc400_get_regions(1U, cfg, STM32MP1_TZC_MAX_REGIONS);
 
 	for (i = 0U; i < STM32MP1_TZC_MAX_REGIONS; i++) {
-		unsigned int reg_num = i + 1U;
-
-		regions[i].low = mmio_read_32(STM32MP1_TZC_BASE +
-					      STM32MP1_TZC_REGION_LOW(reg_num));
-		regions[i].top = mmio_read_32(STM32MP1_TZC_BASE +
-					      STM32MP1_TZC_REGION_TOP(reg_num));
-		regions[i].attribute = mmio_read_32(STM32MP1_TZC_BASE +
-						    STM32MP1_TZC_REGION_ATTRIBUTE(reg_num));
-		regions[i].access = mmio_read_32(STM32MP1_TZC_BASE +
-						 STM32MP1_TZC_REGION_ACCESS(reg_num));
+		regions[i].low = (uint32_t)cfg[i].base;
+		regions[i].top = (uint32_t)cfg[i].top;
+		regions[i].attribute = cfg[i].attributes;
+		regions[i].access = cfg[i].id_access;
 	}
 }
 
+/*
+ * Only the regions lost or changed since the suspend are rewritten, the
+ * others keep their filters enabled.
+ */
 static void tzc_backup_context_restore(struct tzc_regions *regions)
 {
+	struct tzc400_region cfg[STM32MP1_TZC_MAX_REGIONS];
 	unsigned int i;
 
 	assert(regions != NULL);
 
-	tzc400_init(STM32MP1_TZC_BASE);
-
 	for (i = 0U; i < STM32MP1_TZC_MAX_REGIONS; i++) {
-		unsigned int reg_num = i + 1U;
-
-		mmio_write_32(STM32MP1_TZC_BASE + STM32MP1_TZC_REGION_LOW(reg_num),
-			      regions[i].low);
-		mmio_write_32(STM32MP1_TZC_BASE + STM32MP1_TZC_REGION_TOP(reg_num),
-			      regions[i].top);
-		mmio_write_32(STM32MP1_TZC_BASE + STM32MP1_TZC_REGION_ATTRIBUTE(reg_num),
-			      regions[i].attribute);
-		mmio_write_32(STM32MP1_TZC_BASE + STM32MP1_TZC_REGION_ACCESS(reg_num),
-			      regions[i].access);
+		cfg[i].base = regions[i].low;
+		cfg[i].top = regions[i].top;
+		cfg[i].attributes = regions[i].attribute;
+		cfg[i].id_access = regions[i].access;
 	}
 
+	tzc400_init(STM32MP1_TZC_BASE);
+	(void)tzc400_configure_regions(1U, cfg, STM32MP1_TZC_MAX_REGIONS);
+
 	/* Disable Region 0 access */
 	tzc400_configure_region0(TZC_REGION_S_NONE, 0);
 }
@@ -256,6 +377,9 @@ int stm32_save_context(uint32_t zq0cr0_zdata,
 	void *cpu_context;
 	struct backup_data_s *backup_data;
 	struct backup_bl32_data_s *backup_bl32_data;
+	uint8_t scmi_context[SCMI_CONTEXT_SIZE];
+	uint8_t regul_context[PLAT_BACKUP_REGULATOR_SIZE];
+	struct tzc_regions tzc_context[STM32MP1_TZC_MAX_REGIONS];
 
 	stm32mp1_clock_suspend();
 
@@ -275,8 +399,6 @@ int stm32_save_context(uint32_t zq0cr0_zdata,
 	/* Save the BL32 specific data */
 	backup_bl32_data = get_bl32_backup_data();
 
-	backup_bl32_data->canary_id = BL32_CANARY_ID;
-
 	/* Retrieve smc context struct address */
 	smc_context = smc_get_ctx(NON_SECURE);
 
@@ -284,23 +406,34 @@ int stm32_save_context(uint32_t zq0cr0_zdata,
 	cpu_context = cm_get_context(NON_SECURE);
 
 	/* Save context in Backup SRAM */
-	memcpy(&backup_bl32_data->saved_smc_context[0], smc_context,
-	       sizeof(smc_ctx_t) * PLATFORM_CORE_COUNT);
-	memcpy(&backup_bl32_data->saved_cpu_context[0], cpu_context,
-	       sizeof(cpu_context_t) * PLATFORM_CORE_COUNT);
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_SMC, smc_context,
+			    sizeof(smc_ctx_t) * PLATFORM_CORE_COUNT);
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_CPU, cpu_context,
+			    sizeof(cpu_context_t) * PLATFORM_CORE_COUNT);
 
 	memcpy(&backup_bl32_data->rtc, rtc_time, sizeof(struct stm32_rtc_calendar));
 	backup_bl32_data->stgen = stgen_cnt;
 
-	stm32mp1_pm_save_scmi_state(backup_bl32_data->scmi_context,
-				    sizeof(backup_bl32_data->scmi_context));
+	stm32mp1_pm_save_scmi_state(scmi_context, sizeof(scmi_context));
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_SCMI, scmi_context,
+			    sizeof(scmi_context));
 
 	save_clock_pm_context();
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_CLOCK, clock_cfg,
+			    sizeof(clock_cfg));
+
+	regulator_core_backup_context(regul_context, sizeof(regul_context));
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_REGUL, regul_context,
+			    sizeof(regul_context));
 
-	regulator_core_backup_context(backup_bl32_data->regul_context,
-				      sizeof(backup_bl32_data->regul_context));
+	tzc_backup_context_save(tzc_context);
+	bl32_ctx_block_save(backup_bl32_data, BL32_CTX_TZC, tzc_context,
+			    sizeof(tzc_context));
 
-	tzc_backup_context_save(backup_bl32_data->tzc_backup_context);
+	bl32_ctx_crc_valid = true;
+
+	backup_bl32_data->version = BL32_CONTEXT_VERSION;
+	backup_bl32_data->canary_id = BL32_CANARY_ID;
 
 	clk_disable(BKPSRAM);
 
@@ -326,7 +459,8 @@ int stm32_restore_context(void)
 
 	backup_bl32_data = get_bl32_backup_data();
 
-	if (backup_bl32_data->canary_id != BL32_CANARY_ID) {
+	if ((backup_bl32_data->canary_id != BL32_CANARY_ID) ||
+	    (bl32_ctx_blocks_check(backup_bl32_data) != 0)) {
 		ERROR("Incorrect BL32 backup data\n");
 		return -EINVAL;
 	}
@@ -351,10 +485,12 @@ int stm32_restore_context(void)
 	       sizeof(cpu_context_t) * PLATFORM_CORE_COUNT);
 
 	/* Restore STGEN counter with standby mode length */
-	stm32_rtc_get_calendar(&current_calendar);
+	stm32_rtc_get_calendar_nowait(&current_calendar);
 	stdby_time_in_ms = stm32_rtc_diff_calendar(&current_calendar,
 						   &backup_bl32_data->rtc);
+	stm32mp1_lp_governor_stgen_restore_start();
 	stm32mp_stgen_restore_counter(backup_bl32_data->stgen, stdby_time_in_ms);
+	stm32mp1_lp_governor_stgen_restore_end();
 
 	regulator_core_restore_context(backup_bl32_data->regul_context,
 				       sizeof(backup_bl32_data->regul_context));
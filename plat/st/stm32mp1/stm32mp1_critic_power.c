@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2019-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (C) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,6 +17,31 @@
 #include <platform_def.h>
 #include <stm32mp1_context.h>
 #include <stm32mp1_critic_power.h>
+#include <stm32mp1_lp_governor.h>
+#include <stm32mp1_lp_timeline.h>
+
+/*
+ * Dirty lines must reach the memory before the DDR enters self-refresh or the
+ * caches lose power. The whole caches are cleaned by set/way since the lines
+ * dirtied by the non-secure world are not known here. In Stop modes, the MPU
+ * caches keep their content and no other master can write to the DDR while in
+ * self-refresh, so clean lines are kept valid for the resume.
+ */
+static void clean_caches(uint32_t mode)
+{
+	switch (mode) {
+	case STM32_PM_CSLEEP_RUN:
+		break;
+	case STM32_PM_CSTOP_ALLOW_STOP:
+	case STM32_PM_CSTOP_ALLOW_LP_STOP:
+	case STM32_PM_CSTOP_ALLOW_LPLV_STOP:
+		dcsw_op_all(DC_OP_CSW);
+		break;
+	default:
+		dcsw_op_all(DC_OP_CISW);
+		break;
+	}
+}
 
 static void cstop_critic_enter(uint32_t mode)
 {
@@ -84,9 +109,7 @@ void stm32_pwr_down_wfi_load(bool is_cstop, uint32_t mode)
 #endif
 	}
 
-	if (mode != STM32_PM_CSLEEP_RUN) {
-		dcsw_op_all(DC_OP_CISW);
-	}
+	clean_caches(mode);
 
 	if (is_cstop) {
 		cstop_critic_enter(mode);
@@ -133,12 +156,12 @@ void stm32_pwr_down_wfi(bool is_cstop, uint32_t mode)
 {
 	uint32_t interrupt = GIC_SPURIOUS_INTERRUPT;
 
-	if (mode != STM32_PM_CSLEEP_RUN) {
-		dcsw_op_all(DC_OP_CISW);
-	}
+	clean_caches(mode);
 
 	if (is_cstop) {
 		cstop_critic_enter(mode);
+		stm32mp1_lp_timeline_mark(LP_TL_DDR_SR_ENTRY);
+		stm32mp1_lp_governor_sleep();
 	}
 
 	if (mode == STM32_PM_SHUTDOWN) {
@@ -161,7 +184,10 @@ void stm32_pwr_down_wfi(bool is_cstop, uint32_t mode)
 	}
 
 	if (is_cstop) {
+		stm32mp1_lp_timeline_mark(LP_TL_WAKEUP);
+		stm32mp1_lp_governor_wakeup();
 		stm32_pwr_cstop_critic_exit();
+		stm32mp1_lp_timeline_mark(LP_TL_DDR_SR_EXIT);
 	}
 }
 #endif
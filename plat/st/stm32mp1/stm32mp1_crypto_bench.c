@@ -0,0 +1,525 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/ecdsa.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/md.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/st/stm32_hash.h>
+#if STM32MP13
+#include <drivers/st/stm32_pka.h>
+#include <drivers/st/stm32_saes.h>
+#endif
+#include <lib/utils_def.h>
+
+#include <boot_api.h>
+#include <platform_def.h>
+#include <stm32mp1_crypto_bench.h>
+#include <stm32mp_common.h>
+
+/* Data buffers, BL33 is not loaded yet */
+#define CRYPTO_BENCH_BASE	STM32MP_BL33_BASE
+#define CRYPTO_BENCH_MAX_SIZE	U(0x10000)
+#define CRYPTO_BENCH_RUNS	U(8)
+
+#define SHA256_SIZE		U(32)
+#define AES_KEY_SIZE		U(16)
+#define AES_IV_SIZE		U(16)
+#define AES_TAG_SIZE		U(16)
+#define ECDSA_SIZE		U(32)
+
+#if STM32MP13
+#define ECDSA_HW_IMPL		"hw"
+#else
+#define ECDSA_HW_IMPL		"rom"
+#endif
+
+static const size_t bench_sizes[] = {
+	U(64), U(1024), U(16384), U(65536),
+};
+
+static const uint8_t bench_key[AES_KEY_SIZE] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+static const uint8_t bench_iv[AES_IV_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+/* SHA-256 of "TF-A crypto bench", signed with throw-away keys */
+static const uint8_t bench_digest[SHA256_SIZE] = {
+	0x8a, 0xc1, 0xeb, 0x72, 0x9c, 0xb2, 0xf6, 0x6a,
+	0xb7, 0x76, 0x0a, 0x69, 0x72, 0x3b, 0x50, 0xa5,
+	0xcf, 0xa0, 0x16, 0xdd, 0x1a, 0x62, 0x19, 0x1b,
+	0x05, 0xb0, 0x93, 0x84, 0x87, 0xf1, 0x07, 0xb8,
+};
+
+/* Signatures r | s and public keys x | y, most significant bytes first */
+static const uint8_t bench_p256_sig[2U * ECDSA_SIZE] = {
+	0x75, 0x10, 0x30, 0x6b, 0xfd, 0x48, 0x52, 0xc7,
+	0x23, 0xa0, 0x79, 0xbb, 0x0c, 0xe4, 0x2c, 0xff,
+	0x3d, 0x35, 0xab, 0xbe, 0x76, 0x27, 0x20, 0x90,
+	0x80, 0x5a, 0x82, 0xed, 0x2c, 0xa6, 0x58, 0xa9,
+	0x84, 0x8f, 0x1a, 0x94, 0x5b, 0xe8, 0x4d, 0x19,
+	0xe2, 0x0c, 0x41, 0x45, 0x57, 0xdd, 0x72, 0xa2,
+	0x08, 0x4c, 0x96, 0x35, 0xff, 0x01, 0x08, 0xeb,
+	0xef, 0xa9, 0x8c, 0x04, 0xbc, 0xc0, 0x1d, 0x04,
+};
+
+static const uint8_t bench_p256_pk[2U * ECDSA_SIZE] = {
+	0x15, 0x14, 0x60, 0x44, 0x3d, 0xbf, 0xd5, 0x32,
+	0x36, 0xbe, 0x1b, 0x33, 0xa8, 0x50, 0x2c, 0x53,
+	0x9c, 0x9d, 0x2d, 0xef, 0x70, 0xd0, 0x20, 0x50,
+	0xdc, 0xd3, 0xe7, 0x6a, 0x22, 0xbd, 0x8c, 0x8e,
+	0x79, 0xf6, 0x99, 0x54, 0xcd, 0x34, 0x2d, 0xc1,
+	0xb8, 0x45, 0x82, 0x3c, 0xee, 0x00, 0x78, 0x21,
+	0xca, 0xd0, 0x33, 0xc2, 0x6b, 0xa0, 0x05, 0x0e,
+	0x48, 0xd1, 0xf5, 0x41, 0xf3, 0xdf, 0x17, 0xab,
+};
+
+static const uint8_t bench_bp256t1_sig[2U * ECDSA_SIZE] = {
+	0x17, 0x5b, 0x4c, 0x08, 0x14, 0x3a, 0xd9, 0xc2,
+	0x3c, 0xa7, 0x29, 0xe7, 0x0b, 0xa9, 0x23, 0xa6,
+	0xb3, 0x98, 0x53, 0xa3, 0xcc, 0x0d, 0x99, 0xe9,
+	0x53, 0x5f, 0x30, 0xbf, 0x29, 0x72, 0x72, 0xc7,
+	0xa2, 0xb9, 0xa6, 0x15, 0xbb, 0xa6, 0x6c, 0xcb,
+	0xda, 0x98, 0xd0, 0x14, 0x6c, 0x63, 0xe0, 0xab,
+	0x69, 0x43, 0x60, 0x7b, 0x32, 0x23, 0xd0, 0xfb,
+	0x4a, 0xf9, 0x85, 0x81, 0x59, 0x8e, 0xcc, 0x54,
+};
+
+static const uint8_t bench_bp256t1_pk[2U * ECDSA_SIZE] = {
+	0x96, 0xb5, 0x5d, 0xa6, 0xab, 0x1c, 0x38, 0xc1,
+	0x73, 0xfc, 0xdd, 0x3c, 0x9f, 0x5b, 0x6c, 0x8c,
+	0x8c, 0x63, 0xb2, 0x1f, 0x28, 0x61, 0x54, 0xed,
+	0x2b, 0x5b, 0x6b, 0x58, 0x62, 0x55, 0x7c, 0xb1,
+	0x9b, 0x22, 0x68, 0x4d, 0x1e, 0xda, 0x3f, 0xee,
+	0xc0, 0xbc, 0x9d, 0xe1, 0x40, 0x3c, 0xa0, 0x78,
+	0x31, 0xaa, 0xe2, 0xaa, 0x9e, 0x2c, 0xac, 0x76,
+	0x2c, 0x98, 0x82, 0xdb, 0x00, 0xcf, 0x75, 0x96,
+};
+
+enum bench_curve {
+	BENCH_P256,
+	BENCH_BP256T1,
+};
+
+static const struct {
+	const char *name;
+	const uint8_t *sig;
+	const uint8_t *pk;
+} bench_curves[] = {
+	[BENCH_P256] = { "p256", bench_p256_sig, bench_p256_pk },
+	[BENCH_BP256T1] = { "bp256t1", bench_bp256t1_sig, bench_bp256t1_pk },
+};
+
+#if defined(MBEDTLS_AES_C)
+static mbedtls_aes_context bench_aes;
+#endif
+#if defined(MBEDTLS_GCM_C)
+static mbedtls_gcm_context bench_gcm;
+#endif
+
+/*
+ * One line per measure: the average duration of a call in us, and the
+ * throughput in KB/s for the size in bytes of its data (0 for ECDSA).
+ */
+static void bench_print(const char *alg, const char *impl, size_t size,
+			unsigned int align, uint64_t ticks, unsigned int runs,
+			int ret)
+{
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t us = (ticks * 1000000U) / (freq * runs);
+	uint64_t kbps = 0U;
+
+	if ((size != 0U) && (ticks != 0U)) {
+		kbps = (((uint64_t)size * runs * freq) / 1024U) / ticks;
+	}
+
+	NOTICE("CRYPTO_BENCH alg=%s impl=%s size=%u align=%u us=%llu kbps=%llu ret=%d\n",
+	       alg, impl, (unsigned int)size, align, us, kbps, ret);
+}
+
+static int hw_sha256(const uint8_t *buf, size_t size, uint8_t *digest)
+{
+	int ret;
+
+	stm32_hash_init(HASH_SHA256);
+
+	ret = stm32_hash_update(buf, size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return stm32_hash_final(digest);
+}
+
+static int sw_sha256(const uint8_t *buf, size_t size, uint8_t *digest)
+{
+	return mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), buf,
+			  size, digest);
+}
+
+/* SHA-256 of each size, from buffers at each byte alignment */
+static void bench_hash(uint8_t *buf)
+{
+	static const struct {
+		const char *impl;
+		int (*sha256)(const uint8_t *buf, size_t size, uint8_t *digest);
+	} impls[] = {
+		{ "hw", hw_sha256 },
+		{ "sw", sw_sha256 },
+	};
+	uint8_t digest[SHA256_SIZE];
+	unsigned int i;
+	unsigned int j;
+	unsigned int align;
+	unsigned int run;
+
+	for (i = 0U; i < ARRAY_SIZE(bench_sizes); i++) {
+		for (align = 0U; align < sizeof(uint32_t); align++) {
+			for (j = 0U; j < ARRAY_SIZE(impls); j++) {
+				uint64_t start = read_cntpct_el0();
+				int ret = 0;
+
+				for (run = 0U; (run < CRYPTO_BENCH_RUNS) &&
+				     (ret == 0); run++) {
+					ret = impls[j].sha256(buf + align,
+							      bench_sizes[i],
+							      digest);
+				}
+
+				bench_print("sha256", impls[j].impl,
+					    bench_sizes[i], align,
+					    read_cntpct_el0() - start,
+					    CRYPTO_BENCH_RUNS, ret);
+			}
+		}
+	}
+}
+
+#if STM32MP13
+static int hw_aes(enum stm32_saes_chaining_mode mode, uint8_t *buf,
+		  size_t size)
+{
+	struct stm32_saes_context ctx;
+	uint8_t tag[AES_TAG_SIZE];
+	int ret;
+
+	ret = stm32_saes_init(&ctx, false, mode, STM32_SAES_KEY_SOFT,
+			      bench_key, sizeof(bench_key), bench_iv,
+			      (mode == STM32_SAES_MODE_ECB) ?
+			      0U : sizeof(bench_iv));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (mode != STM32_SAES_MODE_GCM) {
+		return stm32_saes_update(&ctx, true, buf, buf, size);
+	}
+
+	ret = stm32_saes_update_assodata(&ctx, true, NULL, 0U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = stm32_saes_update_load(&ctx, true, buf, buf, size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return stm32_saes_final(&ctx, tag, sizeof(tag));
+}
+#endif
+
+/* Return 1 if the mode is not built in mbedTLS */
+static int sw_aes(unsigned int mode, uint8_t *buf, size_t size)
+{
+	uint8_t iv[AES_IV_SIZE];
+	int ret = 1;
+
+	(void)memcpy(iv, bench_iv, sizeof(iv));
+
+#if defined(MBEDTLS_AES_C)
+	ret = mbedtls_aes_setkey_enc(&bench_aes, bench_key,
+				     sizeof(bench_key) * 8U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	switch (mode) {
+	case 0U: {
+		size_t i;
+
+		for (i = 0U; (i < size) && (ret == 0); i += AES_IV_SIZE) {
+			ret = mbedtls_aes_crypt_ecb(&bench_aes,
+						    MBEDTLS_AES_ENCRYPT,
+						    buf + i, buf + i);
+		}
+		break;
+	}
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+	case 1U:
+		ret = mbedtls_aes_crypt_cbc(&bench_aes, MBEDTLS_AES_ENCRYPT,
+					    size, iv, buf, buf);
+		break;
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+	case 2U: {
+		uint8_t block[AES_IV_SIZE];
+		size_t off = 0U;
+
+		ret = mbedtls_aes_crypt_ctr(&bench_aes, size, &off, iv, block,
+					    buf, buf);
+		break;
+	}
+#endif
+	default:
+		ret = 1;
+		break;
+	}
+#endif /* MBEDTLS_AES_C */
+
+#if defined(MBEDTLS_GCM_C)
+	if (mode == 3U) {
+		uint8_t tag[AES_TAG_SIZE];
+
+		ret = mbedtls_gcm_setkey(&bench_gcm, MBEDTLS_CIPHER_ID_AES,
+					 bench_key, sizeof(bench_key) * 8U);
+		if (ret == 0) {
+			ret = mbedtls_gcm_crypt_and_tag(&bench_gcm,
+							MBEDTLS_GCM_ENCRYPT,
+							size, iv, sizeof(iv),
+							NULL, 0U, buf, buf,
+							sizeof(tag), tag);
+		}
+	}
+#endif
+
+	return ret;
+}
+
+/* AES-128 encryption in each mode, in place */
+static void bench_aes_modes(uint8_t *buf)
+{
+	static const char * const names[] = {
+		"aes-ecb", "aes-cbc", "aes-ctr", "aes-gcm",
+	};
+	unsigned int mode;
+	unsigned int i;
+	unsigned int run;
+
+	for (mode = 0U; mode < ARRAY_SIZE(names); mode++) {
+		for (i = 1U; i < ARRAY_SIZE(bench_sizes); i++) {
+			size_t size = bench_sizes[i];
+			uint64_t start;
+			int ret = 0;
+
+#if STM32MP13
+			start = read_cntpct_el0();
+			for (run = 0U; (run < CRYPTO_BENCH_RUNS) && (ret == 0);
+			     run++) {
+				ret = hw_aes((enum stm32_saes_chaining_mode)mode,
+					     buf, size);
+			}
+			bench_print(names[mode], "hw", size, 0U,
+				    read_cntpct_el0() - start,
+				    CRYPTO_BENCH_RUNS, ret);
+#endif
+
+			start = read_cntpct_el0();
+			ret = 0;
+			for (run = 0U; (run < CRYPTO_BENCH_RUNS) && (ret == 0);
+			     run++) {
+				ret = sw_aes(mode, buf, size);
+			}
+
+			if (ret != 1) {
+				bench_print(names[mode], "sw", size, 0U,
+					    read_cntpct_el0() - start,
+					    CRYPTO_BENCH_RUNS, ret);
+			}
+		}
+	}
+}
+
+static int hw_ecdsa(enum bench_curve curve)
+{
+	uint8_t digest[SHA256_SIZE];
+	uint8_t sig[2U * ECDSA_SIZE];
+	uint8_t pk[2U * ECDSA_SIZE];
+#if STM32MP13
+	enum stm32_pka_ecdsa_curve_id cid;
+#else
+	boot_api_context_t *boot_context =
+		(boot_api_context_t *)stm32mp_get_boot_ctx_address();
+	uint32_t algo = (curve == BENCH_P256) ?
+			BOOT_API_ECDSA_ALGO_TYPE_P256NIST :
+			BOOT_API_ECDSA_ALGO_TYPE_BRAINPOOL256;
+#endif
+
+	(void)memcpy(digest, bench_digest, sizeof(digest));
+	(void)memcpy(sig, bench_curves[curve].sig, sizeof(sig));
+	(void)memcpy(pk, bench_curves[curve].pk, sizeof(pk));
+
+#if STM32MP13
+	switch (curve) {
+#if PKA_USE_NIST_P256
+	case BENCH_P256:
+		cid = PKA_NIST_P256;
+		break;
+#endif
+#if PKA_USE_BRAINPOOL_P256T1
+	case BENCH_BP256T1:
+		cid = PKA_BRAINPOOL_P256T1;
+		break;
+#endif
+	default:
+		return 1;
+	}
+
+	return stm32_pka_ecdsa_verif(digest, sizeof(digest),
+				     sig, ECDSA_SIZE, sig + ECDSA_SIZE,
+				     ECDSA_SIZE, pk, ECDSA_SIZE,
+				     pk + ECDSA_SIZE, ECDSA_SIZE, cid);
+#else
+	/* The ROM verification service, as used for the chain of trust */
+	if (boot_context->bootrom_ecdsa_verify_signature(digest, pk, sig,
+							 algo) !=
+	    BOOT_API_RETURN_OK) {
+		return -1;
+	}
+
+	return 0;
+#endif
+}
+
+/* Return 1 if the curve is not built in mbedTLS */
+static int sw_ecdsa(enum bench_curve curve)
+{
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+	mbedtls_ecp_group grp;
+	mbedtls_ecp_point q;
+	mbedtls_mpi r;
+	mbedtls_mpi s;
+	uint8_t point[1U + (2U * ECDSA_SIZE)];
+	int ret;
+
+	if (curve != BENCH_P256) {
+		return 1;
+	}
+
+	point[0] = 0x04U;	/* Uncompressed point */
+	(void)memcpy(point + 1U, bench_p256_pk, sizeof(bench_p256_pk));
+
+	mbedtls_ecp_group_init(&grp);
+	mbedtls_ecp_point_init(&q);
+	mbedtls_mpi_init(&r);
+	mbedtls_mpi_init(&s);
+
+	ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1);
+	if (ret == 0) {
+		ret = mbedtls_ecp_point_read_binary(&grp, &q, point,
+						    sizeof(point));
+	}
+	if (ret == 0) {
+		ret = mbedtls_mpi_read_binary(&r, bench_p256_sig, ECDSA_SIZE);
+	}
+	if (ret == 0) {
+		ret = mbedtls_mpi_read_binary(&s, bench_p256_sig + ECDSA_SIZE,
+					      ECDSA_SIZE);
+	}
+	if (ret == 0) {
+		ret = mbedtls_ecdsa_verify(&grp, bench_digest,
+					   sizeof(bench_digest), &q, &r, &s);
+	}
+
+	mbedtls_mpi_free(&s);
+	mbedtls_mpi_free(&r);
+	mbedtls_ecp_point_free(&q);
+	mbedtls_ecp_group_free(&grp);
+
+	return ret;
+#else
+	return 1;
+#endif
+}
+
+/* One verification per curve, including the curve parameters load */
+static void bench_ecdsa(bool hw_ready)
+{
+	unsigned int curve;
+
+	for (curve = 0U; curve < ARRAY_SIZE(bench_curves); curve++) {
+		char alg[16];
+		uint64_t start;
+		int ret;
+
+		(void)snprintf(alg, sizeof(alg), "ecdsa-%s",
+			       bench_curves[curve].name);
+
+		if (hw_ready) {
+			start = read_cntpct_el0();
+			ret = hw_ecdsa((enum bench_curve)curve);
+			if (ret != 1) {
+				bench_print(alg, ECDSA_HW_IMPL, 0U, 0U,
+					    read_cntpct_el0() - start, 1U, ret);
+			}
+		}
+
+		start = read_cntpct_el0();
+		ret = sw_ecdsa((enum bench_curve)curve);
+		if (ret != 1) {
+			bench_print(alg, "sw", 0U, 0U,
+				    read_cntpct_el0() - start, 1U, ret);
+		}
+	}
+}
+
+void stm32mp1_crypto_bench(void)
+{
+	uint8_t *buf = (uint8_t *)CRYPTO_BENCH_BASE;
+	bool hw_ready = stm32mp_is_closed_device() ||
+			stm32mp_is_auth_supported();
+
+	(void)memset(buf, 0xA5, CRYPTO_BENCH_MAX_SIZE + sizeof(uint32_t));
+
+#if defined(MBEDTLS_AES_C)
+	mbedtls_aes_init(&bench_aes);
+#endif
+#if defined(MBEDTLS_GCM_C)
+	mbedtls_gcm_init(&bench_gcm);
+#endif
+
+	bench_hash(buf);
+
+#if STM32MP13
+	if (hw_ready) {
+		bench_aes_modes(buf);
+	}
+#else
+	bench_aes_modes(buf);
+#endif
+
+	bench_ecdsa(hw_ready);
+
+#if defined(MBEDTLS_GCM_C)
+	mbedtls_gcm_free(&bench_gcm);
+#endif
+#if defined(MBEDTLS_AES_C)
+	mbedtls_aes_free(&bench_aes);
+#endif
+}
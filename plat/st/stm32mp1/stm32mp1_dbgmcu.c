@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2016-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -36,6 +36,21 @@ static int stm32mp1_dbgmcu_init(void)
 	return 0;
 }
 
+/*
+ * @brief  Enable the debug and trace clocks for the trace components.
+ * @retval 0 on success, negative value on failure.
+ */
+int stm32mp1_dbgmcu_trace_enable(void)
+{
+	if (stm32mp1_dbgmcu_init() != 0) {
+		return -EPERM;
+	}
+
+	mmio_setbits_32(RCC_BASE + RCC_DBGCFGR, RCC_DBGCFGR_TRACECKEN);
+
+	return 0;
+}
+
 /*
  * @brief  Get silicon revision from DBGMCU registers.
  * @param  chip_version: pointer to the read value.
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/mmio.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+#include <stm32mp1_ddr_scrub.h>
+#include <stm32mp_dt.h>
+
+#define DDR_SCRUB_BLOCK_SIZE		U(64)
+
+/* DDR range mapped during a slice, with a single block descriptor */
+#define DDR_SCRUB_WINDOW_SIZE		U(0x00200000)
+
+/* Secure backup registers, kept across resets and low power modes */
+#define TAMP_DDR_SCRUB_OFFSET_REG_ID	U(6)
+#define TAMP_DDR_SCRUB_COUNT_REG_ID	U(7)
+#define TAMP_DDR_SCRUB_FAIL_REG_ID	U(8)
+
+#define DDR_SCRUB_PASSES_MASK		GENMASK_32(15, 0)
+#define DDR_SCRUB_ERRORS_SHIFT		16
+#define DDR_SCRUB_ERRORS_MAX		U(0xFFFF)
+
+/* CPUs running, a slice only starts when none is */
+static spinlock_t busy_lock;
+static volatile unsigned int busy_cpus;
+
+/* Held by the CPU running a slice, or accessing the progress */
+static spinlock_t scrub_lock;
+static struct stm32mp1_ddr_scrub_status scrub;
+static size_t ddr_size;
+
+static void ddr_scrub_save(void)
+{
+	clk_enable(RTCAPB);
+
+	mmio_write_32(tamp_bkpr(TAMP_DDR_SCRUB_OFFSET_REG_ID), scrub.offset);
+	mmio_write_32(tamp_bkpr(TAMP_DDR_SCRUB_COUNT_REG_ID),
+		      (scrub.errors << DDR_SCRUB_ERRORS_SHIFT) | scrub.passes);
+	mmio_write_32(tamp_bkpr(TAMP_DDR_SCRUB_FAIL_REG_ID), scrub.first_fail);
+
+	clk_disable(RTCAPB);
+}
+
+/*
+ * Non-destructive test of a word: r(v), w(~v), r(~v), w(v), r(v). Each bit
+ * is driven to both levels, and the content is restored. The window is
+ * mapped non-cacheable, the barriers push the writes out to the DDR.
+ */
+static bool ddr_scrub_word(uintptr_t addr)
+{
+	uint32_t val = mmio_read_32(addr);
+	bool ok;
+
+	mmio_write_32(addr, ~val);
+	dsb();
+	ok = mmio_read_32(addr) == ~val;
+
+	mmio_write_32(addr, val);
+	dsb();
+
+	return ok && (mmio_read_32(addr) == val);
+}
+
+static void ddr_scrub_fail(uintptr_t addr)
+{
+	if (scrub.first_fail == 0U) {
+		scrub.first_fail = (uint32_t)addr;
+		ERROR("DDR scrub: failure at 0x%lx\n", addr);
+	}
+
+	if (scrub.errors < DDR_SCRUB_ERRORS_MAX) {
+		scrub.errors++;
+	}
+}
+
+/*
+ * Test blocks from the saved offset, until the end of the mapped window, the
+ * time budget, a pending interrupt or a CPU leaving its idle state.
+ */
+static void ddr_scrub_slice(void)
+{
+	uintptr_t window = STM32MP_DDR_BASE +
+			   round_down(scrub.offset, DDR_SCRUB_WINDOW_SIZE);
+	uint64_t timeout = timeout_init_us(STM32MP_DDR_SCRUB_SLICE_US);
+
+	if (mmap_add_dynamic_region(window, window, DDR_SCRUB_WINDOW_SIZE,
+				    MT_NON_CACHEABLE | MT_RW | MT_NS |
+				    MT_EXECUTE_NEVER) != 0) {
+		return;
+	}
+
+	do {
+		uintptr_t addr = STM32MP_DDR_BASE + scrub.offset;
+		uintptr_t end = addr + DDR_SCRUB_BLOCK_SIZE;
+
+		for (; addr < end; addr += sizeof(uint32_t)) {
+			if (!ddr_scrub_word(addr)) {
+				ddr_scrub_fail(addr);
+			}
+		}
+
+		scrub.offset += DDR_SCRUB_BLOCK_SIZE;
+		if (scrub.offset == ddr_size) {
+			scrub.offset = 0U;
+			scrub.passes = (scrub.passes + 1U) &
+				       DDR_SCRUB_PASSES_MASK;
+		}
+	} while (((scrub.offset % DDR_SCRUB_WINDOW_SIZE) != 0U) &&
+		 !timeout_elapsed(timeout) && (read_isr() == 0U) &&
+		 (busy_cpus == 0U));
+
+	(void)mmap_remove_dynamic_region(window, DDR_SCRUB_WINDOW_SIZE);
+
+	ddr_scrub_save();
+}
+
+/* Resume from the progress saved before the last reset */
+void stm32mp1_ddr_scrub_init(void)
+{
+	uint32_t count;
+
+	ddr_size = dt_get_ddr_size();
+	busy_cpus = BIT(plat_my_core_pos());
+
+	clk_enable(RTCAPB);
+
+	scrub.offset = mmio_read_32(tamp_bkpr(TAMP_DDR_SCRUB_OFFSET_REG_ID));
+	count = mmio_read_32(tamp_bkpr(TAMP_DDR_SCRUB_COUNT_REG_ID));
+	scrub.first_fail = mmio_read_32(tamp_bkpr(TAMP_DDR_SCRUB_FAIL_REG_ID));
+
+	clk_disable(RTCAPB);
+
+	if ((scrub.offset >= ddr_size) ||
+	    ((scrub.offset % DDR_SCRUB_BLOCK_SIZE) != 0U)) {
+		scrub.offset = 0U;
+	}
+
+	scrub.passes = count & DDR_SCRUB_PASSES_MASK;
+	scrub.errors = count >> DDR_SCRUB_ERRORS_SHIFT;
+
+	if (scrub.errors != 0U) {
+		WARN("DDR scrub: %u failing words, first at 0x%x\n",
+		     scrub.errors, scrub.first_fail);
+	}
+}
+
+/*
+ * Called by a CPU entering an idle state. The last one runs a slice, unless
+ * the progress is being read.
+ */
+void stm32mp1_ddr_scrub_cpu_idle(void)
+{
+	bool all_idle;
+
+	spin_lock(&busy_lock);
+	busy_cpus &= ~BIT(plat_my_core_pos());
+	all_idle = busy_cpus == 0U;
+	spin_unlock(&busy_lock);
+
+	if (!all_idle || (ddr_size == 0U) || !spin_trylock(&scrub_lock)) {
+		return;
+	}
+
+	ddr_scrub_slice();
+
+	spin_unlock(&scrub_lock);
+}
+
+void stm32mp1_ddr_scrub_cpu_busy(void)
+{
+	spin_lock(&busy_lock);
+	busy_cpus |= BIT(plat_my_core_pos());
+	spin_unlock(&busy_lock);
+}
+
+void stm32mp1_ddr_scrub_get(struct stm32mp1_ddr_scrub_status *status)
+{
+	spin_lock(&scrub_lock);
+	*status = scrub;
+	spin_unlock(&scrub_lock);
+}
+
+void stm32mp1_ddr_scrub_clear(void)
+{
+	spin_lock(&scrub_lock);
+	scrub.errors = 0U;
+	scrub.first_fail = 0U;
+	ddr_scrub_save();
+	spin_unlock(&scrub_lock);
+}
@@ -112,6 +112,9 @@
 #if STM32MP15
 #define STM32MP_SYSRAM_BASE		U(0x2FFC0000)
 #define STM32MP_SYSRAM_SIZE		U(0x00040000)
+#define RETRAM_BASE			U(0x38000000)
+#define RETRAM_SIZE			U(0x00010000)
+#define RETRAM_SIZE_2MB_ALIGNED		U(0x00200000)
 #endif /* STM32MP15 */
 
 #define STM32MP_BACKUP_RAM_BASE		U(0x54000000)
@@ -122,6 +125,22 @@
 #define STM32MP_BACKUP_RAM_SIZE		U(0x00001000)	/* 4KB */
 #endif /* STM32MP15 */
 
+/* Low power timeline, at the end of Backup SRAM */
+#define STM32MP_LP_TIMELINE_SIZE	U(0x00000400)
+#define STM32MP_LP_TIMELINE_BASE	(STM32MP_BACKUP_RAM_BASE + \
+					 STM32MP_BACKUP_RAM_SIZE - \
+					 STM32MP_LP_TIMELINE_SIZE)
+
+/* DDR training results, below the low power timeline */
+#define STM32MP_DDR_TRAINING_SIZE	U(0x00000080)
+#define STM32MP_DDR_TRAINING_BASE	(STM32MP_LP_TIMELINE_BASE - \
+					 STM32MP_DDR_TRAINING_SIZE)
+
+/* Low power mode latencies, below the DDR training results */
+#define STM32MP_LP_GOVERNOR_SIZE	U(0x00000080)
+#define STM32MP_LP_GOVERNOR_BASE	(STM32MP_DDR_TRAINING_BASE - \
+					 STM32MP_LP_GOVERNOR_SIZE)
+
 #define STM32MP_NS_SYSRAM_SIZE		PAGE_SIZE
 #define STM32MP_NS_SYSRAM_BASE		(STM32MP_SYSRAM_BASE + \
 					 STM32MP_SYSRAM_SIZE - \
@@ -130,6 +149,17 @@
 #define STM32MP_SCMI_NS_SHM_BASE	STM32MP_NS_SYSRAM_BASE
 #define STM32MP_SCMI_NS_SHM_SIZE	STM32MP_NS_SYSRAM_SIZE
 
+/* Boot timeline shared with non-secure world, at the end of NS SYSRAM */
+#define STM32MP_BOOT_TIMELINE_SIZE	U(0x00000400)
+#define STM32MP_BOOT_TIMELINE_BASE	(STM32MP_NS_SYSRAM_BASE + \
+					 STM32MP_NS_SYSRAM_SIZE - \
+					 STM32MP_BOOT_TIMELINE_SIZE)
+
+/* Per-CPU log rings shared with non-secure world, below the boot timeline */
+#define STM32MP_LOG_RING_SIZE		U(0x00000800)
+#define STM32MP_LOG_RING_BASE		(STM32MP_BOOT_TIMELINE_BASE - \
+					 STM32MP_LOG_RING_SIZE)
+
 #define STM32MP_SEC_SYSRAM_BASE		STM32MP_SYSRAM_BASE
 #define STM32MP_SEC_SYSRAM_SIZE		(STM32MP_SYSRAM_SIZE - \
 					 STM32MP_NS_SYSRAM_SIZE)
@@ -138,6 +168,9 @@
 #define STM32MP_DDR_BASE		U(0xC0000000)
 #define STM32MP_DDR_MAX_SIZE		U(0x40000000)	/* Max 1GB */
 
+/* Boot trace dumps, at the end of the DDR, one half per image */
+#define STM32MP_BOOT_TRACE_SIZE		U(0x00004000)
+
 /* DDR power initializations */
 #ifndef __ASSEMBLER__
 enum ddr_type {
@@ -174,8 +207,12 @@ enum ddr_type {
 
 /* BL2 and BL32/sp_min require finer granularity tables */
 #if defined(IMAGE_BL2)
+#if STM32MP_MEM_BENCH
+#define MAX_XLAT_TABLES			U(3) /* 12 KB, DDR bench window */
+#else
 #define MAX_XLAT_TABLES			U(2) /* 8 KB for mapping */
 #endif
+#endif
 
 #if defined(IMAGE_BL32)
 #define MAX_XLAT_TABLES			U(4) /* 16 KB for mapping */
@@ -186,7 +223,9 @@ enum ddr_type {
  * BL stm32mp1_mmap size + mmap regions in *_plat_arch_setup
  */
 #if defined(IMAGE_BL2)
- #if STM32MP_USB_PROGRAMMER
+ #if STM32MP_USB_PROGRAMMER && STM32MP_M4_EARLY_BOOT
+  #define MAX_MMAP_REGIONS		9
+ #elif STM32MP_USB_PROGRAMMER || STM32MP_M4_EARLY_BOOT
   #define MAX_MMAP_REGIONS		8
  #else
   #define MAX_MMAP_REGIONS		7
@@ -254,6 +293,15 @@ enum ddr_type {
 #define EXTI_RPR3_RPIF65		BIT(1)
 #define EXTI_FPR3_FPIF65		BIT(1)
 
+/*******************************************************************************
+ * STM32MP1 IPCC
+ ******************************************************************************/
+#if STM32MP15
+#define IPCC_BASE			U(0x4C001000)
+#define IPCC_C1SCR			U(0x08)
+#define IPCC_C2TOC1SR			U(0x1C)
+#endif
+
 /*******************************************************************************
  * STM32MP1 GPIO
  ******************************************************************************/
@@ -359,8 +407,11 @@ enum ddr_type {
 #define STM32MP_MMC_INIT_FREQ			U(400000)	/*400 KHz*/
 #define STM32MP_SD_NORMAL_SPEED_MAX_FREQ	U(25000000)	/*25 MHz*/
 #define STM32MP_SD_HIGH_SPEED_MAX_FREQ		U(50000000)	/*50 MHz*/
+#define STM32MP_SD_SDR50_MAX_FREQ		U(100000000)	/*100 MHz*/
+#define STM32MP_SD_SDR104_MAX_FREQ		U(208000000)	/*208 MHz*/
 #define STM32MP_EMMC_NORMAL_SPEED_MAX_FREQ	U(26000000)	/*26 MHz*/
 #define STM32MP_EMMC_HIGH_SPEED_MAX_FREQ	U(52000000)	/*52 MHz*/
+#define STM32MP_EMMC_HS200_MAX_FREQ		U(200000000)	/*200 MHz*/
 
 /*******************************************************************************
  * STM32MP1 BSEC / OTP
@@ -553,6 +604,15 @@ static inline uintptr_t tamp_bkpr(uint32_t idx)
 #define MCE_KEY_SIZE_IN_BYTES		U(16)
 #endif
 
+/*******************************************************************************
+ * STM32MP15 CoreSight trace components
+ ******************************************************************************/
+#if STM32MP15
+#define CSTF_BASE			U(0x50091000)
+#define ETF_BASE			U(0x50092000)
+#define CA7_ETM_BASE(cpu)		(U(0x500DC000) + ((cpu) * U(0x1000)))
+#endif
+
 /*******************************************************************************
  * STM32MP1 IWDG
  ******************************************************************************/
@@ -589,6 +649,7 @@ static inline uintptr_t tamp_bkpr(uint32_t idx)
 #define I2C4_BASE			U(0x5C002000)
 #define I2C6_BASE			U(0x5c009000)
 #endif
+#define MDMA_BASE			U(0x58000000)
 #if STM32MP13
 #define RNG_BASE			U(0x54004000)
 #endif
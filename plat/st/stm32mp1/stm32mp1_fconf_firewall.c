@@ -25,6 +25,7 @@
 #define FORCE_SEC_REGION	BIT(31)
 
 static uint32_t nb_regions;
+static struct tzc400_region regions[STM32MP_MAX_REGIONS];
 
 struct dt_id_attr {
 	fdt32_t id_attr[STM32MP_MAX_REGIONS];
@@ -73,17 +74,19 @@ void stm32mp1_security_setup(void)
 	 */
 	tzc400_configure_region0(TZC_REGION_S_NONE, 0);
 
-	for (i = 1U; i <= nb_regions; i++) {
-		tzc400_update_filters(i, STM32MP1_FILTER_BIT_ALL);
+	for (i = 0U; i < nb_regions; i++) {
+		regions[i].attributes |= TZC_400_REGION_ATTR(0U, STM32MP1_FILTER_BIT_ALL);
 	}
 
+	(void)tzc400_configure_regions(1U, regions, nb_regions);
+
 	tzc400_set_action(TZC_ACTION_INT);
 	tzc400_enable_filters();
 }
 
-static int fconf_populate_stm32mp1_firewall(uintptr_t config)
+static int fconf_populate_stm32mp1_firewall(uintptr_t config, int node)
 {
-	int node, len;
+	int len;
 	unsigned int i;
 	const struct dt_id_attr *conf_list;
 	const void *dtb = (const void *)config;
@@ -96,7 +99,6 @@ static int fconf_populate_stm32mp1_firewall(uintptr_t config)
 		return 0;
 	}
 
-	node = fdt_node_offset_by_compatible(dtb, -1, compatible_str);
 	if (node < 0) {
 		ERROR("FCONF: Can't find %s compatible in dtb\n", compatible_str);
 		return node;
@@ -123,17 +125,29 @@ static int fconf_populate_stm32mp1_firewall(uintptr_t config)
 		VERBOSE("FCONF: stm32mp1-firewall cell found with value = 0x%x 0x%x 0x%x 0x%x\n",
 			base, size, sec_attr, nsaid);
 
+		if (nb_regions == STM32MP_MAX_REGIONS) {
+			ERROR("FCONF: Too many firewall regions\n");
+			return -1;
+		}
+
+		/* Region stays disabled for secure access for BL2 load */
+		regions[nb_regions].base = (unsigned long long)base;
+		regions[nb_regions].top = (unsigned long long)base + size - 1ULL;
+		regions[nb_regions].attributes = TZC_400_REGION_ATTR(sec_attr, 0U);
+		regions[nb_regions].id_access = nsaid;
 		nb_regions++;
+	}
 
-		/* Configure region but keep disabled for secure access for BL2 load */
-		tzc400_configure_region(0U, nb_regions, (unsigned long long)base,
-					(unsigned long long)base + size - 1ULL, sec_attr, nsaid);
+	if (nb_regions != 0U) {
+		(void)tzc400_configure_regions(1U, regions, nb_regions);
 	}
 
-	/* Force flush as the value will be used cache off */
+	/* Force flush as the values will be used cache off */
 	flush_dcache_range((uintptr_t)&nb_regions, sizeof(uint32_t));
+	flush_dcache_range((uintptr_t)regions, sizeof(regions));
 
 	return 0;
 }
 
-FCONF_REGISTER_POPULATOR(FW_CONFIG, stm32mp1_firewall, fconf_populate_stm32mp1_firewall);
+FCONF_REGISTER_NODE_POPULATOR(FW_CONFIG, stm32mp1_firewall, "st,mem-firewall",
+			      fconf_populate_stm32mp1_firewall);
@@ -69,6 +69,7 @@
 #define STM32MP_BL32_DTB_SIZE		U(0x00005000)	/* 20 KB for DTB */
 #define STM32MP_FW_CONFIG_MAX_SIZE	PAGE_SIZE	/* 4 KB for FCONF DTB */
 #define STM32MP_HW_CONFIG_MAX_SIZE	U(0x40000)	/* 256 KB for HW config DTB */
+#define STM32MP_NT_FW_CONFIG_MAX_SIZE	U(0x10000)	/* 64 KB for NT_FW config */
 
 #if STM32MP13
 #define STM32MP_BL2_BASE		(STM32MP_BL2_DTB_BASE + \
@@ -134,6 +135,8 @@
 #endif /* STM32MP15 */
 #define STM32MP_HW_CONFIG_BASE		(STM32MP_BL33_BASE + \
 					STM32MP_BL33_MAX_SIZE)
+#define STM32MP_NT_FW_CONFIG_BASE	(STM32MP_HW_CONFIG_BASE + \
+					 STM32MP_HW_CONFIG_MAX_SIZE)
 
 /*
  * MAX_MMAP_REGIONS is usually:
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <common/debug.h>
+#include <drivers/regulator.h>
+#include <drivers/st/stm32mp1_clk.h>
+#include <drivers/st/stm32mp_pmic.h>
+
+#include <stm32mp1_handoff.h>
+
+static struct stm32mp1_handoff handoff;
+
+#if defined(IMAGE_BL2)
+/*
+ * Compute the PLL1 settings of all OPPs for the current CPU supply voltage,
+ * as SP_min would do. Return the address of the structure to pass to SP_min,
+ * or 0 when there is nothing to hand off.
+ */
+uintptr_t stm32mp1_handoff_prepare(void)
+{
+	uint32_t cpu_voltage = 0U;
+
+	if (dt_pmic_status() > 0) {
+		struct rdev *regul = dt_get_cpu_regulator();
+		int ret;
+
+		if (regul == NULL) {
+			return 0U;
+		}
+
+		ret = regulator_get_voltage(regul);
+		if (ret < 0) {
+			return 0U;
+		}
+
+		cpu_voltage = (uint32_t)ret;
+	}
+
+	if ((stm32mp1_clk_compute_all_pll1_settings(cpu_voltage) != 0) ||
+	    !stm32mp1_clk_pll1_settings_are_valid()) {
+		return 0U;
+	}
+
+	stm32mp1_clk_lp_save_opp_pll1_settings(handoff.pll1_settings,
+					       sizeof(handoff.pll1_settings));
+
+	handoff.cpu_voltage_mv = cpu_voltage;
+	handoff.size = sizeof(handoff);
+	handoff.version = STM32MP1_HANDOFF_VERSION;
+	handoff.magic = STM32MP1_HANDOFF_MAGIC;
+
+	return (uintptr_t)&handoff;
+}
+#endif /* IMAGE_BL2 */
+
+#if defined(IMAGE_BL32)
+void stm32mp1_handoff_init(uintptr_t addr)
+{
+	const struct stm32mp1_handoff *from =
+		(const struct stm32mp1_handoff *)addr;
+
+	/* BL2 memory is in secure SYSRAM */
+	if ((addr < STM32MP_SYSRAM_BASE) ||
+	    (addr > (STM32MP_SYSRAM_BASE + STM32MP_SYSRAM_SIZE -
+		     sizeof(*from)))) {
+		return;
+	}
+
+	if ((from->magic != STM32MP1_HANDOFF_MAGIC) ||
+	    (from->version != STM32MP1_HANDOFF_VERSION) ||
+	    (from->size != sizeof(*from))) {
+		WARN("Ignore BL2 handoff data\n");
+		return;
+	}
+
+	handoff = *from;
+}
+
+/* Load the PLL1 settings from BL2 if computed for the same CPU voltage */
+bool stm32mp1_handoff_load_pll1_settings(uint32_t cpu_voltage_mv)
+{
+	if ((handoff.magic != STM32MP1_HANDOFF_MAGIC) ||
+	    (handoff.cpu_voltage_mv != cpu_voltage_mv)) {
+		return false;
+	}
+
+	stm32mp1_clk_lp_load_opp_pll1_settings(handoff.pll1_settings,
+					       sizeof(handoff.pll1_settings));
+
+	return true;
+}
+#endif /* IMAGE_BL32 */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/spinlock.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#include <stm32mp1_it_latency.h>
+#include <stm32mp1_smc.h>
+#include <stm32mp_sec_timer.h>
+
+/* Shortest period, for the measure not to starve the normal world */
+#define IT_LATENCY_PERIOD_MIN_US	U(10)
+
+static spinlock_t latency_lock;
+static int latency_task = -1;
+static bool latency_running;
+static uint64_t latency_period;
+static uint64_t latency_deadline;
+static uint64_t latency_sum;
+static struct stm32mp1_it_latency_stats latency;
+/*
+ * Bucket n counts the interrupts handled from 2^n to 2^(n+1) - 1 system
+ * counter ticks after the timer expiry, the last bucket also counting
+ * longer latencies.
+ */
+static uint32_t latency_hist[STM32_SMC_IT_LATENCY_BUCKETS];
+
+static unsigned int it_latency_bucket(uint64_t ticks)
+{
+	unsigned int bucket = 0U;
+
+	while ((ticks > 1U) &&
+	       (bucket < (STM32_SMC_IT_LATENCY_BUCKETS - 1U))) {
+		ticks >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/*
+ * Secure timer task, run from the FIQ handler. The timer expired at the
+ * deadline, the latency includes the monitor entry, the interrupt dispatch
+ * and any time the FIQ was masked by a SMC handler.
+ */
+static void it_latency_task(void)
+{
+	uint64_t now = read_cntpct_el0();
+	uint32_t ticks;
+
+	spin_lock(&latency_lock);
+
+	if (!latency_running) {
+		spin_unlock(&latency_lock);
+		return;
+	}
+
+	ticks = (uint32_t)MIN(now - latency_deadline, (uint64_t)UINT32_MAX);
+
+	latency.count++;
+	latency.min = MIN(latency.min, ticks);
+	latency.max = MAX(latency.max, ticks);
+	latency_sum += ticks;
+	latency_hist[it_latency_bucket(ticks)]++;
+
+	/* Periods missed while the FIQ was masked are skipped */
+	latency_deadline += latency_period;
+	if (latency_deadline <= now) {
+		latency_deadline = now + latency_period;
+	}
+
+	stm32mp_sec_timer_arm_at((unsigned int)latency_task, latency_deadline);
+
+	spin_unlock(&latency_lock);
+}
+
+void stm32mp1_it_latency_init(void)
+{
+	latency_task = stm32mp_sec_timer_register(it_latency_task, 0U);
+	if (latency_task < 0) {
+		ERROR("IT latency: no secure timer task\n");
+	}
+}
+
+/* Reset the statistics and arm the timer of the calling CPU */
+int stm32mp1_it_latency_start(uint32_t period_us)
+{
+	if (latency_task < 0) {
+		return -ENODEV;
+	}
+
+	if (period_us < IT_LATENCY_PERIOD_MIN_US) {
+		return -EINVAL;
+	}
+
+	spin_lock(&latency_lock);
+
+	zeromem(&latency, sizeof(latency));
+	zeromem(latency_hist, sizeof(latency_hist));
+	latency.min = UINT32_MAX;
+	latency_sum = 0U;
+
+	latency_period = ((uint64_t)period_us * read_cntfrq_el0()) / 1000000U;
+	latency_deadline = read_cntpct_el0() + latency_period;
+	latency_running = true;
+
+	stm32mp_sec_timer_arm_at((unsigned int)latency_task, latency_deadline);
+
+	spin_unlock(&latency_lock);
+
+	return 0;
+}
+
+void stm32mp1_it_latency_stop(void)
+{
+	if (latency_task < 0) {
+		return;
+	}
+
+	spin_lock(&latency_lock);
+
+	latency_running = false;
+	stm32mp_sec_timer_cancel((unsigned int)latency_task);
+
+	spin_unlock(&latency_lock);
+}
+
+void stm32mp1_it_latency_get(struct stm32mp1_it_latency_stats *stats)
+{
+	spin_lock(&latency_lock);
+
+	*stats = latency;
+	if (latency.count == 0U) {
+		stats->min = 0U;
+	} else {
+		stats->avg = (uint32_t)(latency_sum / latency.count);
+	}
+
+	spin_unlock(&latency_lock);
+}
+
+int stm32mp1_it_latency_hist(unsigned int bucket, uint32_t *count)
+{
+	if (bucket >= STM32_SMC_IT_LATENCY_BUCKETS) {
+		return -EINVAL;
+	}
+
+	spin_lock(&latency_lock);
+	*count = latency_hist[bucket];
+	spin_unlock(&latency_lock);
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -21,12 +21,11 @@
 #include <drivers/st/stm32mp1_ddr_helpers.h>
 #include <drivers/st/stm32mp1_pwr.h>
 #include <drivers/st/stm32mp1_rcc.h>
-#include <drivers/st/stpmic1.h>
 #include <dt-bindings/clock/stm32mp1-clks.h>
 #include <dt-bindings/power/stm32mp1-power.h>
 #include <lib/mmio.h>
 #include <lib/psci/psci.h>
-#include <lib/spinlock.h>
+#include <lib/sync_flag.h>
 #include <plat/common/platform.h>
 
 #include <boot_api.h>
@@ -34,6 +33,8 @@
 #include <stm32mp_dt.h>
 #include <stm32mp1_context.h>
 #include <stm32mp1_low_power.h>
+#include <stm32mp1_lp_governor.h>
+#include <stm32mp1_lp_timeline.h>
 #include <stm32mp1_power_config.h>
 #include <stm32mp1_private.h>
 
@@ -101,9 +102,9 @@ enum {
 	STATE_AUTOSTOP_EXIT,
 };
 
-static struct spinlock lp_lock;
-static volatile int cpu0_state = STATE_NONE;
-static volatile int cpu1_state = STATE_NONE;
+/* Auto-stop handshake, awaited in WFE by the other CPU */
+static sync_flag_t cpu0_state;
+static sync_flag_t cpu1_state;
 
 const char *plat_get_lp_mode_name(int mode)
 {
@@ -122,6 +123,11 @@ void stm32_apply_pmic_suspend_config(uint32_t mode)
 		if (!initialize_pmic_i2c()) {
 			panic();
 		}
+
+		/* Regulators suspend configuration is written on commit */
+		if (regulator_core_batch_start() != 0) {
+			panic();
+		}
 	}
 }
 
@@ -132,7 +138,7 @@ void stm32_apply_pmic_suspend_config(uint32_t mode)
  * @nsec_addr - Non secure resume entry point
  * Return 0 if succeed to suspend, non 0 else.
  */
-static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
+static void __hot enter_cstop(uint32_t mode, uint32_t nsec_addr)
 {
 	uint32_t zq0cr0_zdata;
 	uintptr_t bkpr_core1_addr =
@@ -150,8 +156,13 @@ static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
 	}
 #endif
 
+	stm32mp1_lp_timeline_start(mode);
+	stm32mp1_lp_governor_enter(mode);
+
 	stm32mp1_syscfg_disable_io_compensation();
 
+	stm32mp1_lp_timeline_mark(LP_TL_IO_COMP_DISABLE);
+
 	stm32_clean_context();
 
 	if (mode == STM32_PM_CSTOP_ALLOW_STANDBY_DDR_SR) {
@@ -162,6 +173,8 @@ static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
 		stm32_save_ddr_training_area();
 	}
 
+	stm32mp1_lp_timeline_mark(LP_TL_CONTEXT_CLEAN);
+
 	if (dt_pmic_status() > 0) {
 		stm32_apply_pmic_suspend_config(mode);
 
@@ -172,6 +185,15 @@ static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
 
 	regulator_core_suspend(mode);
 
+	if ((dt_pmic_status() > 0) &&
+	    (config_pwr[mode].regul_suspend_node_name != NULL)) {
+		if (regulator_core_batch_commit() != 0) {
+			panic();
+		}
+	}
+
+	stm32mp1_lp_timeline_mark(LP_TL_PMIC_SUSPEND);
+
 	/* Clear RCC interrupt before enabling it */
 	mmio_setbits_32(rcc_base + RCC_MP_CIFR, RCC_MP_CIFR_WKUPF);
 
@@ -204,7 +226,9 @@ static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
 
 	stm32mp1_clock_stopmode_save();
 
-	stm32_rtc_get_calendar(&sleep_time);
+	stm32mp1_lp_timeline_mark(LP_TL_CLOCK_SAVE);
+
+	stm32_rtc_get_calendar_nowait(&sleep_time);
 	stgen_cnt = stm32mp_stgen_get_counter();
 
 	if (mode == STM32_PM_CSTOP_ALLOW_STANDBY_DDR_SR) {
@@ -243,6 +267,8 @@ static void enter_cstop(uint32_t mode, uint32_t nsec_addr)
 
 	clk_disable(RTCAPB);
 
+	stm32mp1_lp_timeline_mark(LP_TL_CONTEXT_SAVE);
+
 	enter_cstop_done = true;
 }
 
@@ -254,7 +280,7 @@ bool stm32_is_cstop_done(void)
 /*
  * stm32_exit_cstop - Exit from CSTOP mode
  */
-void stm32_exit_cstop(void)
+void __hot stm32_exit_cstop(void)
 {
 	uintptr_t pwr_base = stm32mp_pwr_base();
 	uintptr_t rcc_base = stm32mp_rcc_base();
@@ -267,6 +293,8 @@ void stm32_exit_cstop(void)
 
 	enter_cstop_done = false;
 
+	stm32mp1_lp_timeline_mark(LP_TL_EXIT_START);
+
 	stm32mp1_syscfg_enable_io_compensation_start();
 
 	plat_ic_set_priority_mask(gicc_pmr);
@@ -285,40 +313,33 @@ void stm32_exit_cstop(void)
 	mmio_clrbits_32(pwr_base + PWR_CR2, PWR_CR2_BREN | PWR_CR2_RREN);
 
 	/* Update STGEN counter with low power mode duration */
-	stm32_rtc_get_calendar(&current_calendar);
+	stm32_rtc_get_calendar_nowait(&current_calendar);
 
 	stdby_time_in_ms = stm32_rtc_diff_calendar(&current_calendar,
 						   &sleep_time);
+	stm32mp1_lp_governor_stgen_restore_start();
 	stm32mp_stgen_restore_counter(stgen_cnt, stdby_time_in_ms);
+	stm32mp1_lp_governor_stgen_restore_end();
+
+	stm32mp1_lp_timeline_mark(LP_TL_STGEN_RESTORE);
 
 	if (stm32mp1_clock_stopmode_resume() != 0) {
 		panic();
 	}
 
-	regulator_core_resume();
+	stm32mp1_lp_timeline_mark(LP_TL_CLOCK_RESUME);
 
-	stm32mp1_syscfg_enable_io_compensation_finish();
-}
-
-static int get_locked(volatile int *state)
-{
-	volatile int val;
+	regulator_core_resume();
 
-	spin_lock(&lp_lock);
-	val = *state;
-	spin_unlock(&lp_lock);
+	stm32mp1_lp_timeline_mark(LP_TL_REGUL_RESUME);
 
-	return val;
-}
+	stm32mp1_syscfg_enable_io_compensation_finish();
 
-static void set_locked(volatile int *state, int val)
-{
-	spin_lock(&lp_lock);
-	*state = val;
-	spin_unlock(&lp_lock);
+	stm32mp1_lp_timeline_end(LP_TL_EXIT_END);
+	stm32mp1_lp_governor_exit();
 }
 
-static void smp_synchro(int state, bool wake_up)
+static void smp_synchro(uint32_t state, bool wake_up)
 {
 	/* if the other CPU is stopped, no need to synchronize */
 	if (psci_is_last_on_cpu() == 1U) {
@@ -326,27 +347,31 @@ static void smp_synchro(int state, bool wake_up)
 	}
 
 	if (plat_my_core_pos() == STM32MP_PRIMARY_CPU) {
-		set_locked(&cpu0_state, state);
+		sync_flag_set(&cpu0_state, state);
 
-		while (get_locked(&cpu1_state) != state) {
-			if (wake_up) {
+		if (!wake_up) {
+			sync_flag_wait(&cpu1_state, state);
+		} else {
+			while (!sync_flag_test(&cpu1_state, state)) {
 				/* wakeup secondary CPU */
 				gicv2_raise_sgi(ARM_IRQ_SEC_SGI_6,
 						STM32MP_SECONDARY_CPU);
 				udelay(10);
 			}
-		};
+		}
 	} else {
-		while (get_locked(&cpu0_state) != state) {
-			if (wake_up) {
+		if (!wake_up) {
+			sync_flag_wait(&cpu0_state, state);
+		} else {
+			while (!sync_flag_test(&cpu0_state, state)) {
 				/* wakeup primary CPU */
 				gicv2_raise_sgi(ARM_IRQ_SEC_SGI_6,
 						STM32MP_PRIMARY_CPU);
 				udelay(10);
 			}
-		};
+		}
 
-		set_locked(&cpu1_state, state);
+		sync_flag_set(&cpu1_state, state);
 	}
 }
 
@@ -388,7 +413,7 @@ void stm32_auto_stop(void)
 	}
 }
 
-static void enter_csleep(void)
+static void __hot enter_csleep(void)
 {
 	uintptr_t pwr_base = stm32mp_pwr_base();
 
@@ -400,7 +425,7 @@ static void enter_csleep(void)
 	stm32_pwr_down_wfi(false, STM32_PM_CSLEEP_RUN);
 }
 
-void stm32_enter_low_power(uint32_t mode, uint32_t nsec_addr)
+void __hot stm32_enter_low_power(uint32_t mode, uint32_t nsec_addr)
 {
 	switch (mode) {
 	case STM32_PM_SHUTDOWN:
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <drivers/clk.h>
+#include <drivers/st/stm32_rtc.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <dt-bindings/power/stm32mp1-power.h>
+#include <lib/cassert.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include <platform_def.h>
+#include <stm32mp1_lp_governor.h>
+
+#define LP_GOV_MAGIC		0x564F474CU	/* "LGOV" */
+
+/*
+ * Layout of the latencies stored at STM32MP_LP_GOVERNOR_BASE, kept in Backup
+ * SRAM across Stop and Standby modes, as SP_min is loaded again by BL2 when
+ * exiting Standby. Counter values are in system counter ticks, latencies in
+ * microseconds, 0 until a first cycle of the mode is measured.
+ *
+ * @start: counter when entering the low power mode
+ * @ref: counter when the exit latency measurement resumes, 0 until wake-up
+ *	from Stop, the counter then counting from the Standby exit reset
+ * @exit_us: exit latency measured so far, the system counter being restored
+ *	with the low power mode duration in the middle of the exit
+ */
+struct lp_gov {
+	uint32_t magic;
+	uint32_t mode;
+	uint32_t active;
+	uint32_t exit_us;
+	uint64_t start;
+	uint64_t ref;
+	uint32_t entry_latency_us[STM32_PM_MAX_SOC_MODE];
+	uint32_t exit_latency_us[STM32_PM_MAX_SOC_MODE];
+};
+
+CASSERT(sizeof(struct lp_gov) <= STM32MP_LP_GOVERNOR_SIZE,
+	assert_lp_governor_size);
+
+static struct lp_gov *lp_gov(void)
+{
+	return (struct lp_gov *)STM32MP_LP_GOVERNOR_BASE;
+}
+
+static uint64_t ticks_to_us(uint64_t ticks)
+{
+	uint64_t freq = read_cntfrq_el0();
+
+	if (freq == 0U) {
+		return 0U;
+	}
+
+	return (ticks * 1000000ULL) / freq;
+}
+
+static uint32_t lp_gov_latency_us(struct lp_gov *gov, uint32_t mode)
+{
+	return gov->entry_latency_us[mode] + gov->exit_latency_us[mode];
+}
+
+/*
+ * Follow latency increases at once, to keep meeting the deadlines, and
+ * decreases slowly, a single fast cycle not being representative.
+ */
+static void lp_gov_update(uint32_t *latency_us, uint32_t sample_us)
+{
+	uint32_t average = ((*latency_us * 3U) + sample_us) / 4U;
+
+	*latency_us = MAX(average, sample_us);
+}
+
+/* Remaining time of a non-secure generic timer, if enabled and unmasked */
+static uint64_t timer_deadline_us(u_register_t ctl, uint32_t tval)
+{
+	if ((get_cntp_ctl_enable(ctl) == 0U) ||
+	    (get_cntp_ctl_imask(ctl) != 0U)) {
+		return LP_GOV_NO_DEADLINE;
+	}
+
+	if ((int32_t)tval < 0) {
+		return 0U;
+	}
+
+	return ticks_to_us(tval);
+}
+
+/*
+ * Get the time to the next wake-up event known to the firmware: the RTC
+ * alarm A and the non-secure physical and virtual timers of this CPU.
+ */
+uint64_t stm32mp1_lp_governor_get_deadline_us(void)
+{
+	uint64_t deadline_us = LP_GOV_NO_DEADLINE;
+	unsigned long long alarm_ms;
+	u_register_t scr = read_scr();
+	u_register_t ctl;
+	uint32_t tval;
+
+	if (stm32_rtc_get_alarm_delay(&alarm_ms) == 0) {
+		deadline_us = alarm_ms * 1000ULL;
+	}
+
+	ctl = read_cntv_ctl();
+	tval = read_cntv_tval();
+	deadline_us = MIN(deadline_us, timer_deadline_us(ctl, tval));
+
+	/* Physical timer registers are banked, read the non-secure ones */
+	write_scr(scr | SCR_NS_BIT);
+	isb();
+	ctl = read_cntp_ctl();
+	tval = read_cntp_tval();
+	write_scr(scr);
+	isb();
+
+	return MIN(deadline_us, timer_deadline_us(ctl, tval));
+}
+
+/* Check a low power mode can be entered and exited before the deadline */
+bool stm32mp1_lp_governor_fits(uint32_t mode, uint64_t deadline_us)
+{
+	struct lp_gov *gov = lp_gov();
+	bool fits = true;
+
+	assert(mode < STM32_PM_MAX_SOC_MODE);
+
+	if (deadline_us == LP_GOV_NO_DEADLINE) {
+		return true;
+	}
+
+	clk_enable(BKPSRAM);
+
+	if (gov->magic == LP_GOV_MAGIC) {
+		fits = lp_gov_latency_us(gov, mode) <= deadline_us;
+	}
+
+	clk_disable(BKPSRAM);
+
+	return fits;
+}
+
+void stm32mp1_lp_governor_enter(uint32_t mode)
+{
+	struct lp_gov *gov = lp_gov();
+
+	assert(mode < STM32_PM_MAX_SOC_MODE);
+
+	clk_enable(BKPSRAM);
+
+	/* Backup SRAM content is not initialized after a power on reset */
+	if (gov->magic != LP_GOV_MAGIC) {
+		zeromem(gov, sizeof(*gov));
+		gov->magic = LP_GOV_MAGIC;
+	}
+
+	gov->mode = mode;
+	gov->start = read_cntpct_el0();
+	gov->active = 1U;
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_governor_sleep(void)
+{
+	struct lp_gov *gov = lp_gov();
+
+	clk_enable(BKPSRAM);
+
+	if ((gov->magic == LP_GOV_MAGIC) && (gov->active != 0U)) {
+		lp_gov_update(&gov->entry_latency_us[gov->mode],
+			      (uint32_t)ticks_to_us(read_cntpct_el0() -
+						    gov->start));
+		gov->exit_us = 0U;
+		gov->ref = 0U;
+	}
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_governor_wakeup(void)
+{
+	struct lp_gov *gov = lp_gov();
+
+	clk_enable(BKPSRAM);
+
+	if ((gov->magic == LP_GOV_MAGIC) && (gov->active != 0U)) {
+		gov->ref = read_cntpct_el0();
+	}
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_governor_stgen_restore_start(void)
+{
+	struct lp_gov *gov = lp_gov();
+
+	clk_enable(BKPSRAM);
+
+	if ((gov->magic == LP_GOV_MAGIC) && (gov->active != 0U)) {
+		gov->exit_us += (uint32_t)ticks_to_us(read_cntpct_el0() -
+						      gov->ref);
+	}
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_governor_stgen_restore_end(void)
+{
+	stm32mp1_lp_governor_wakeup();
+}
+
+void stm32mp1_lp_governor_exit(void)
+{
+	struct lp_gov *gov = lp_gov();
+
+	clk_enable(BKPSRAM);
+
+	if ((gov->magic == LP_GOV_MAGIC) && (gov->active != 0U)) {
+		gov->exit_us += (uint32_t)ticks_to_us(read_cntpct_el0() -
+						      gov->ref);
+		lp_gov_update(&gov->exit_latency_us[gov->mode], gov->exit_us);
+		gov->active = 0U;
+	}
+
+	clk_disable(BKPSRAM);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <drivers/clk.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/cassert.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include <platform_def.h>
+#include <stm32mp1_lp_timeline.h>
+
+#define LP_TL_MAGIC		0x4E4C544CU	/* "LTLN" */
+
+/* Timestamps in microseconds of the steps of a low power cycle */
+struct lp_tl_cycle {
+	uint16_t mode;
+	uint16_t steps;
+	uint32_t time_us[LP_TL_STEP_NB];
+};
+
+/*
+ * Layout of the timeline stored at STM32MP_LP_TIMELINE_BASE, kept in Backup
+ * SRAM across Stop and Standby modes. Cycles are recorded in a ring, @head
+ * being the one of the last entered low power mode.
+ */
+struct lp_tl {
+	uint32_t magic;
+	uint32_t head;
+	uint32_t count;
+	uint32_t active;
+	struct lp_tl_cycle cycle[];
+};
+
+#define LP_TL_MAX_CYCLES	((STM32MP_LP_TIMELINE_SIZE - \
+				  sizeof(struct lp_tl)) / \
+				 sizeof(struct lp_tl_cycle))
+
+CASSERT(LP_TL_MAX_CYCLES > 0U, assert_lp_timeline_size);
+CASSERT(LP_TL_STEP_NB <= 16U, assert_lp_timeline_steps_fit_mask);
+
+static struct lp_tl *lp_tl(void)
+{
+	return (struct lp_tl *)STM32MP_LP_TIMELINE_BASE;
+}
+
+static bool lp_tl_is_valid(struct lp_tl *tl)
+{
+	return (tl->magic == LP_TL_MAGIC) && (tl->head < LP_TL_MAX_CYCLES) &&
+	       (tl->count <= LP_TL_MAX_CYCLES);
+}
+
+static uint32_t lp_timeline_now_us(void)
+{
+	uint64_t freq = read_cntfrq_el0();
+
+	if (freq == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)((read_cntpct_el0() * 1000000ULL) / freq);
+}
+
+static void lp_tl_mark(struct lp_tl *tl, unsigned int step)
+{
+	struct lp_tl_cycle *cycle = &tl->cycle[tl->head];
+
+	cycle->time_us[step] = lp_timeline_now_us();
+	cycle->steps |= (uint16_t)BIT_32(step);
+}
+
+void stm32mp1_lp_timeline_start(uint32_t mode)
+{
+	struct lp_tl *tl = lp_tl();
+
+	clk_enable(BKPSRAM);
+
+	/* Backup SRAM content is not initialized after a power on reset */
+	if (!lp_tl_is_valid(tl)) {
+		zeromem(tl, STM32MP_LP_TIMELINE_SIZE);
+		tl->magic = LP_TL_MAGIC;
+		tl->head = LP_TL_MAX_CYCLES - 1U;
+	}
+
+	tl->head = (tl->head + 1U) % LP_TL_MAX_CYCLES;
+	if (tl->count < LP_TL_MAX_CYCLES) {
+		tl->count++;
+	}
+
+	zeromem(&tl->cycle[tl->head], sizeof(struct lp_tl_cycle));
+	tl->cycle[tl->head].mode = (uint16_t)mode;
+	lp_tl_mark(tl, LP_TL_ENTER_START);
+	tl->active = 1U;
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_timeline_mark(unsigned int step)
+{
+	struct lp_tl *tl = lp_tl();
+
+	assert(step < LP_TL_STEP_NB);
+
+	clk_enable(BKPSRAM);
+
+	if (lp_tl_is_valid(tl) && (tl->active != 0U)) {
+		lp_tl_mark(tl, step);
+	}
+
+	clk_disable(BKPSRAM);
+}
+
+void stm32mp1_lp_timeline_end(unsigned int step)
+{
+	struct lp_tl *tl = lp_tl();
+
+	assert(step < LP_TL_STEP_NB);
+
+	clk_enable(BKPSRAM);
+
+	if (lp_tl_is_valid(tl) && (tl->active != 0U)) {
+		lp_tl_mark(tl, step);
+		tl->active = 0U;
+	}
+
+	clk_disable(BKPSRAM);
+}
+
+/*
+ * Get the duration of a step of a recorded low power cycle, from the end of
+ * the previous recorded step. Cycle 0 is the last entered low power mode.
+ */
+int stm32mp1_lp_timeline_get(unsigned int cycle, unsigned int step,
+			     uint32_t *duration_us, uint32_t *mode)
+{
+	struct lp_tl *tl = lp_tl();
+	struct lp_tl_cycle *entry;
+	unsigned int prev;
+	int ret = 0;
+
+	if (step >= LP_TL_STEP_NB) {
+		return -EINVAL;
+	}
+
+	clk_enable(BKPSRAM);
+
+	if (!lp_tl_is_valid(tl) || (cycle >= tl->count)) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	entry = &tl->cycle[(tl->head + LP_TL_MAX_CYCLES - cycle) %
+			   LP_TL_MAX_CYCLES];
+
+	if ((entry->steps & BIT_32(step)) == 0U) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	*duration_us = 0U;
+	*mode = entry->mode;
+
+	for (prev = step; prev > 0U; prev--) {
+		if ((entry->steps & BIT_32(prev - 1U)) != 0U) {
+			*duration_us = entry->time_us[step] -
+				       entry->time_us[prev - 1U];
+			break;
+		}
+	}
+
+out:
+	clk_disable(BKPSRAM);
+
+	return ret;
+}
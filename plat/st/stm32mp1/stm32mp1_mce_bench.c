@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/st/stm32_mce.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#include <stm32mp1_context.h>
+#include <stm32mp1_mce_bench.h>
+
+#define MCE_BENCH_SIZE		U(0x100000)	/* 1MB, larger than the caches */
+
+static uint64_t bench_write(uintptr_t base)
+{
+	volatile uint32_t *addr = (volatile uint32_t *)base;
+	uint64_t start = read_cntpct_el0();
+	uint32_t i;
+
+	for (i = 0U; i < (MCE_BENCH_SIZE / sizeof(uint32_t)); i++) {
+		addr[i] = i;
+	}
+
+	flush_dcache_range(base, MCE_BENCH_SIZE);
+
+	return read_cntpct_el0() - start;
+}
+
+static uint64_t bench_read(uintptr_t base, uint32_t *errors)
+{
+	volatile uint32_t *addr = (volatile uint32_t *)base;
+	uint64_t start;
+	uint32_t i;
+
+	inv_dcache_range(base, MCE_BENCH_SIZE);
+
+	start = read_cntpct_el0();
+
+	for (i = 0U; i < (MCE_BENCH_SIZE / sizeof(uint32_t)); i++) {
+		if (addr[i] != i) {
+			(*errors)++;
+		}
+	}
+
+	return read_cntpct_el0() - start;
+}
+
+static void bench_print(const char *mode, const char *op, uint64_t ticks,
+			uint32_t errors)
+{
+	uint64_t kbps = 0U;
+
+	if (ticks != 0U) {
+		kbps = ((MCE_BENCH_SIZE / 1024U) * read_cntfrq_el0()) / ticks;
+	}
+
+	NOTICE("MCE_BENCH mode=%s op=%s size=%u ticks=%llu kbps=%llu err=%u\n",
+	       mode, op, MCE_BENCH_SIZE, ticks, kbps, errors);
+}
+
+void stm32mp1_mce_bench(void)
+{
+	static const struct {
+		uint32_t encrypt_mode;
+		const char *name;
+	} modes[] = {
+		{ MCE_BYPASS_MODE, "plaintext" },
+		{ MCE_ENCRYPT_MODE, "encrypt" },
+	};
+	struct stm32_mce_region_s regions[MCE_IP_MAX_REGION_NB];
+	uint32_t nb_regions;
+	unsigned int i;
+
+	for (nb_regions = 0U; nb_regions < MCE_IP_MAX_REGION_NB; nb_regions++) {
+		stm32mp1_pm_get_mce_region(nb_regions, &regions[nb_regions]);
+
+		if (regions[nb_regions].end_address == 0U) {
+			break;
+		}
+	}
+
+	if ((nb_regions == 0U) ||
+	    ((regions[0].end_address - regions[0].start_address + 1U) <
+	     MCE_BENCH_SIZE)) {
+		WARN("MCE_BENCH: no MCE region of at least 1MB\n");
+		return;
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(modes); i++) {
+		struct stm32_mce_region_s bench_region = regions[0];
+		uint32_t errors = 0U;
+		uint64_t ticks;
+
+		bench_region.encrypt_mode = modes[i].encrypt_mode;
+		if (stm32_mce_configure_regions(&bench_region, 1U) != 0) {
+			panic();
+		}
+
+		ticks = bench_write(regions[0].start_address);
+		bench_print(modes[i].name, "write", ticks, 0U);
+
+		ticks = bench_read(regions[0].start_address, &errors);
+		bench_print(modes[i].name, "read", ticks, errors);
+	}
+
+	if (stm32_mce_configure_regions(regions, nb_regions) != 0) {
+		panic();
+	}
+}
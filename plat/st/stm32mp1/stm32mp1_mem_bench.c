@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libfdt.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/clk.h>
+#include <drivers/st/stm32mp_ddrctrl_regs.h>
+#include <drivers/st/stm32mp_ram.h>
+#include <dt-bindings/clock/stm32mp1-clks.h>
+#include <lib/mmio.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+#include <stm32mp1_mem_bench.h>
+#include <stm32mp_common.h>
+#include <stm32mp_dt.h>
+
+/* DDR window, the two halves are the copy source and destination */
+#define MEM_BENCH_DDR_SIZE	U(0x400000)
+/* Data accessed per bandwidth measure, and loads per latency measure */
+#define MEM_BENCH_BYTES		U(0x400000)
+#define MEM_BENCH_LOADS		U(0x10000)
+/* Pointer chasing, one pointer per cache line */
+#define MEM_BENCH_LINE		CACHE_WRITEBACK_GRANULE
+
+enum bench_attr {
+	BENCH_CACHED,
+	BENCH_WC,
+	BENCH_UNCACHED,
+	BENCH_ATTR_NB,
+};
+
+static const struct {
+	const char *name;
+	unsigned int attr;
+} bench_attrs[BENCH_ATTR_NB] = {
+	[BENCH_CACHED] = { .name = "cached", .attr = MT_MEMORY },
+	[BENCH_WC] = { .name = "wc", .attr = MT_NON_CACHEABLE },
+	[BENCH_UNCACHED] = { .name = "uncached", .attr = MT_DEVICE },
+};
+
+/*
+ * A target is either mapped by the bench, with each attribute, or measured
+ * through its BL2 mapping. Targets holding live data are only read.
+ */
+struct mem_bench_target {
+	const char *name;
+	uintptr_t base;
+	size_t size;
+	bool remap;
+	enum bench_attr attr;
+	bool read_only;
+	bool gated;
+	unsigned long clk;
+};
+
+static const struct mem_bench_target bench_targets[] = {
+	{
+		.name = "ddr",
+		.base = STM32MP_DDR_BASE,
+		.size = MEM_BENCH_DDR_SIZE,
+		.remap = true,
+	},
+	{
+		/* BL2 image */
+		.name = "sysram",
+		.base = STM32MP_SYSRAM_BASE,
+		.size = U(0x10000),
+		.attr = BENCH_CACHED,
+		.read_only = true,
+	},
+#if STM32MP13
+	{
+		/* SRAM1 holds the MTD buffer and SRAM3 the FW_CONFIG */
+		.name = "sram2",
+		.base = SRAM2_BASE,
+		.size = SRAM2_SIZE,
+		.attr = BENCH_CACHED,
+	},
+#endif
+#if STM32MP15 && !STM32MP_M4_EARLY_BOOT
+	{
+		.name = "retram",
+		.base = RETRAM_BASE,
+		.size = RETRAM_SIZE,
+		.remap = true,
+	},
+#endif
+	{
+		/* Low power context */
+		.name = "bkpsram",
+		.base = STM32MP_BACKUP_RAM_BASE,
+		.size = STM32MP_BACKUP_RAM_SIZE,
+		.attr = BENCH_UNCACHED,
+		.read_only = true,
+		.gated = true,
+		.clk = BKPSRAM,
+	},
+};
+
+static uint32_t bench_sum;
+
+static void bench_read(uintptr_t src, uintptr_t dst, size_t size)
+{
+	const volatile uint32_t *s = (const volatile uint32_t *)src;
+	const volatile uint32_t *end = s + (size / sizeof(uint32_t));
+	uint32_t sum = 0U;
+
+	while (s < end) {
+		sum += s[0] + s[1] + s[2] + s[3];
+		s += 4;
+	}
+
+	/* Not optimized out */
+	bench_sum += sum;
+}
+
+static void bench_write(uintptr_t src, uintptr_t dst, size_t size)
+{
+	volatile uint32_t *d = (volatile uint32_t *)dst;
+	volatile uint32_t *end = d + (size / sizeof(uint32_t));
+
+	while (d < end) {
+		d[0] = 0x5A5A5A5AU;
+		d[1] = 0xA5A5A5A5U;
+		d[2] = 0x5A5A5A5AU;
+		d[3] = 0xA5A5A5A5U;
+		d += 4;
+	}
+}
+
+static void bench_copy(uintptr_t src, uintptr_t dst, size_t size)
+{
+	const volatile uint32_t *s = (const volatile uint32_t *)src;
+	const volatile uint32_t *end = s + (size / sizeof(uint32_t));
+	volatile uint32_t *d = (volatile uint32_t *)dst;
+
+	while (s < end) {
+		d[0] = s[0];
+		d[1] = s[1];
+		d[2] = s[2];
+		d[3] = s[3];
+		s += 4;
+		d += 4;
+	}
+}
+
+static const struct {
+	const char *name;
+	void (*op)(uintptr_t src, uintptr_t dst, size_t size);
+} bench_ops[] = {
+	{ .name = "read", .op = bench_read },
+	{ .name = "write", .op = bench_write },
+	{ .name = "copy", .op = bench_copy },
+};
+
+static uint64_t bench_kbps(size_t bytes, uint64_t ticks)
+{
+	return ((uint64_t)bytes * read_cntfrq_el0()) /
+	       (1024U * MAX(ticks, (uint64_t)1U));
+}
+
+static void bench_bandwidth(const struct mem_bench_target *target,
+			    enum bench_attr attr)
+{
+	size_t size = target->read_only ? target->size : (target->size / 2U);
+	unsigned int runs = MAX(MEM_BENCH_BYTES / size, 1U);
+	unsigned int nb_ops = target->read_only ? 1U : ARRAY_SIZE(bench_ops);
+	unsigned int i;
+
+	for (i = 0U; i < nb_ops; i++) {
+		uint64_t start;
+		unsigned int run;
+
+		start = read_cntpct_el0();
+
+		for (run = 0U; run < runs; run++) {
+			bench_ops[i].op(target->base, target->base + size, size);
+		}
+
+		dsbsy();
+
+		NOTICE("MEM_BENCH mem=%s attr=%s op=%s size=%u kbps=%llu\n",
+		       target->name, bench_attrs[attr].name, bench_ops[i].name,
+		       (unsigned int)size,
+		       bench_kbps(size * runs, read_cntpct_el0() - start));
+	}
+}
+
+/*
+ * Each line points to the next one of a full period LCG sequence, modulo
+ * the number of lines: the loads depend on each other and their addresses
+ * are not predictable by the prefetcher.
+ */
+static void bench_latency(const struct mem_bench_target *target,
+			  enum bench_attr attr)
+{
+	size_t lines = target->size / MEM_BENCH_LINE;
+	uintptr_t addr = target->base;
+	uint64_t start;
+	uint64_t ticks;
+	size_t line;
+	unsigned int i;
+
+	for (line = 0U; line < lines; line++) {
+		size_t next = ((5U * line) + 1U) & (lines - 1U);
+
+		mmio_write_32(target->base + (line * MEM_BENCH_LINE),
+			      target->base + (next * MEM_BENCH_LINE));
+	}
+
+	/* Warm up the cache, if any */
+	for (line = 0U; line < lines; line++) {
+		addr = mmio_read_32(addr);
+	}
+
+	dsbsy();
+	start = read_cntpct_el0();
+
+	for (i = 0U; i < MEM_BENCH_LOADS; i++) {
+		addr = mmio_read_32(addr);
+	}
+
+	ticks = read_cntpct_el0() - start;
+
+	NOTICE("MEM_BENCH mem=%s attr=%s op=latency size=%u ns=%llu.%02llu\n",
+	       target->name, bench_attrs[attr].name, (unsigned int)target->size,
+	       (ticks * 1000000000U) / (read_cntfrq_el0() * MEM_BENCH_LOADS),
+	       ((ticks * 100000000000U) /
+		(read_cntfrq_el0() * MEM_BENCH_LOADS)) % 100U);
+
+	/* Not optimized out */
+	bench_sum += (uint32_t)addr;
+}
+
+static void bench_target_attr(const struct mem_bench_target *target,
+			      enum bench_attr attr)
+{
+	size_t map_size = round_up(target->size, XLAT_BLOCK_SIZE(2));
+	int ret;
+
+	if (target->remap) {
+		ret = mmap_add_dynamic_region(target->base, target->base,
+					      map_size,
+					      bench_attrs[attr].attr | MT_RW |
+					      MT_SECURE | MT_EXECUTE_NEVER);
+		if (ret != 0) {
+			ERROR("MEM_BENCH %s mapping: error %d\n",
+			      target->name, ret);
+			panic();
+		}
+	}
+
+	bench_bandwidth(target, attr);
+
+	if (!target->read_only) {
+		bench_latency(target, attr);
+	}
+
+	if (target->remap) {
+		/* No dirty line left for the next attribute */
+		if (attr == BENCH_CACHED) {
+			flush_dcache_range(target->base, target->size);
+		}
+
+		ret = mmap_remove_dynamic_region(target->base, map_size);
+		if (ret != 0) {
+			ERROR("MEM_BENCH %s unmapping: error %d\n",
+			      target->name, ret);
+			panic();
+		}
+	}
+}
+
+/* DDR configuration and AXI port 0 QoS, from the DT and the controller */
+static void bench_ddr_config(void)
+{
+	struct stm32mp_ddrctl *ctl =
+		(struct stm32mp_ddrctl *)stm32mp_ddrctrl_base();
+	struct stm32mp_ddr_info info;
+	void *fdt;
+	int node;
+
+	if (fdt_get_address(&fdt) == 0) {
+		return;
+	}
+
+	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	if ((node < 0) || (stm32mp_ddr_dt_get_info(fdt, node, &info) < 0)) {
+		return;
+	}
+
+	NOTICE("MEM_BENCH ddr=\"%s\" speed=%ukHz sched=0x%x perfhpr1=0x%x perflpr1=0x%x pcfgqos0=0x%x pcfgwqos0=0x%x\n",
+	       info.name, info.speed,
+	       mmio_read_32((uintptr_t)&ctl->sched),
+	       mmio_read_32((uintptr_t)&ctl->perfhpr1),
+	       mmio_read_32((uintptr_t)&ctl->perflpr1),
+	       mmio_read_32((uintptr_t)&ctl->pcfgqos0_0),
+	       mmio_read_32((uintptr_t)&ctl->pcfgwqos0_0));
+}
+
+void stm32mp1_mem_bench(void)
+{
+	unsigned int i;
+	int ret;
+
+	bench_ddr_config();
+
+	/* The DDR window is mapped alone, with each attribute */
+	flush_dcache_range(STM32MP_DDR_BASE, MEM_BENCH_DDR_SIZE);
+	if (stm32mp_unmap_ddr() != 0) {
+		ERROR("MEM_BENCH DDR unmapping failed\n");
+		panic();
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(bench_targets); i++) {
+		const struct mem_bench_target *target = &bench_targets[i];
+		enum bench_attr attr;
+
+		if (target->gated) {
+			clk_enable(target->clk);
+		}
+
+		if (!target->remap) {
+			bench_target_attr(target, target->attr);
+		} else {
+			for (attr = BENCH_CACHED; attr < BENCH_ATTR_NB; attr++) {
+				bench_target_attr(target, attr);
+			}
+		}
+
+		if (target->gated) {
+			clk_disable(target->clk);
+		}
+	}
+
+	ret = mmap_add_dynamic_region(STM32MP_DDR_BASE, STM32MP_DDR_BASE,
+				      STM32MP_DDR_MAX_SIZE,
+				      MT_MEMORY | MT_RW | MT_SECURE);
+	if (ret < 0) {
+		ERROR("DDR mapping: error %d\n", ret);
+		panic();
+	}
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include <platform_def.h>
+#include <stm32mp1_mem_usage.h>
+#include <stm32mp1_smc.h>
+
+#if defined(IMAGE_BL2)
+#include <drivers/io/io_storage.h>
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+#include <drivers/auth/mbedtls/mbedtls_common.h>
+#endif
+#endif
+
+#define STACK_PAINT		U(0x5A5A5A5A)
+
+/* Words just below the stack pointer, left to the painting loop */
+#define STACK_PAINT_GUARD	U(64)
+
+IMPORT_SYM(uintptr_t, __STACKS_START__, STACKS_START);
+IMPORT_SYM(uintptr_t, __STACKS_END__, STACKS_END);
+
+/* One stack per CPU in SP_min, a single one in BL2 */
+static unsigned int stacks_count(void)
+{
+	return (unsigned int)((STACKS_END - STACKS_START) / PLATFORM_STACK_SIZE);
+}
+
+/*
+ * Fill the stacks with a pattern, before the MMU is enabled and before other
+ * CPUs are started. The stack of the calling CPU is filled up to its current
+ * stack pointer. Stacks grow down from the top of their PLATFORM_STACK_SIZE
+ * slot.
+ */
+void stm32mp1_mem_usage_paint_stacks(void)
+{
+	unsigned int i;
+	uintptr_t sp;
+
+	__asm__ volatile ("mov %0, sp" : "=r" (sp));
+
+	for (i = 0U; i < stacks_count(); i++) {
+		uintptr_t base = STACKS_START + (i * PLATFORM_STACK_SIZE);
+		uintptr_t end = base + PLATFORM_STACK_SIZE;
+		/* Volatile, not to be turned into a memset() call */
+		volatile uint32_t *word;
+
+		if ((sp > base) && (sp <= end)) {
+			end = sp - STACK_PAINT_GUARD;
+		}
+
+		for (word = (uint32_t *)base; (uintptr_t)word < end; word++) {
+			*word = STACK_PAINT;
+		}
+	}
+}
+
+/* Deepest stack use, from the first overwritten word above the slot bottom */
+static uint32_t stack_max_used(unsigned int index)
+{
+	const uint32_t *word = (const uint32_t *)(STACKS_START +
+						  (index * PLATFORM_STACK_SIZE));
+	uint32_t unused = 0U;
+
+	while ((unused < PLATFORM_STACK_SIZE) && (*word == STACK_PAINT)) {
+		unused += sizeof(uint32_t);
+		word++;
+	}
+
+	return PLATFORM_STACK_SIZE - unused;
+}
+
+int stm32mp1_mem_usage_get(unsigned int id, unsigned int index,
+			   uint32_t *max_used, uint32_t *size)
+{
+	unsigned int used;
+	unsigned int total;
+
+	switch (id) {
+	case STM32_SMC_MEM_USAGE_STACK:
+		if (index >= stacks_count()) {
+			return -EINVAL;
+		}
+
+		*max_used = stack_max_used(index);
+		*size = PLATFORM_STACK_SIZE;
+		break;
+	case STM32_SMC_MEM_USAGE_XLAT_TABLES:
+		xlat_get_tables_usage(&used, &total);
+		*max_used = used;
+		*size = total;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+void stm32mp1_mem_usage_print(void)
+{
+	uint32_t used;
+	uint32_t size;
+	unsigned int i;
+#if defined(IMAGE_BL2) && TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+	size_t heap_used;
+	size_t heap_size;
+#endif
+
+	for (i = 0U; i < stacks_count(); i++) {
+		(void)stm32mp1_mem_usage_get(STM32_SMC_MEM_USAGE_STACK, i,
+					     &used, &size);
+		NOTICE("Stack %u: %u/%u bytes used at most\n", i, used, size);
+	}
+
+	(void)stm32mp1_mem_usage_get(STM32_SMC_MEM_USAGE_XLAT_TABLES, 0U,
+				     &used, &size);
+	NOTICE("Translation tables: %u/%u used at most\n", used, size);
+
+#if defined(IMAGE_BL2)
+	NOTICE("IO handles: %u/%u used at most\n", io_get_handles_max_used(),
+	       (unsigned int)MAX_IO_HANDLES);
+
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+	mbedtls_heap_get_usage(&heap_used, &heap_size);
+	NOTICE("mbed TLS heap: %u/%u bytes used at most\n",
+	       (unsigned int)heap_used, (unsigned int)heap_size);
+#endif
+#endif
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <plat/common/platform.h>
+
+#include <platform_def.h>
+#include <stm32mp1_perf_snapshot.h>
+#include <stm32mp1_smc.h>
+
+/*
+ * Each CPU only writes its own snapshot. The PMU belongs to the non-secure
+ * world: the cycle counter is read as configured there, never reset nor
+ * enabled here.
+ */
+static struct stm32mp1_perf_snapshot perf_snapshot[PLATFORM_CORE_COUNT];
+
+void stm32mp1_perf_snapshot_capture(void)
+{
+	struct stm32mp1_perf_snapshot *snapshot =
+		&perf_snapshot[plat_my_core_pos()];
+	uint32_t pmcr = read_pmcr();
+	uint32_t flags = 0U;
+
+	if (((pmcr & PMCR_E_BIT) != 0U) &&
+	    ((read_pmcntenset() & PMCNTENSET_C_BIT) != 0U)) {
+		flags |= STM32_SMC_PERF_SNAPSHOT_CYCLES_ON;
+	}
+
+	if ((pmcr & PMCR_D_BIT) != 0U) {
+		flags |= STM32_SMC_PERF_SNAPSHOT_CYCLES_DIV64;
+	}
+
+	snapshot->cycles = read_pmccntr();
+	snapshot->timestamp = read_cntpct_el0();
+	snapshot->flags = flags;
+	snapshot->seq++;
+}
+
+int stm32mp1_perf_snapshot_get(unsigned int core,
+			       struct stm32mp1_perf_snapshot *snapshot)
+{
+	if (core >= PLATFORM_CORE_COUNT) {
+		return -EINVAL;
+	}
+
+	*snapshot = perf_snapshot[core];
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -22,24 +22,32 @@
 #include <lib/mmio.h>
 #include <lib/psci/psci.h>
 #include <plat/common/platform.h>
+#include <smccc_helpers.h>
 
+#include <stm32mp1_ddr_scrub.h>
 #include <stm32mp1_low_power.h>
 #include <stm32mp1_power_config.h>
+#include <stm32mp_log_ring.h>
 
 static uintptr_t stm32_sec_entrypoint;
 static uint32_t cntfrq_core0;
 static uintptr_t saved_entrypoint;
+static uint32_t suspend_soc_mode;
 
 /*******************************************************************************
  * STM32MP1 handler called when a CPU is about to enter standby.
  * call by core 1 to enter in wfi
  ******************************************************************************/
-static void stm32_cpu_standby(plat_local_state_t cpu_state)
+static void __hot stm32_cpu_standby(plat_local_state_t cpu_state)
 {
 	uint32_t interrupt = GIC_SPURIOUS_INTERRUPT;
 
 	assert(cpu_state == ARM_LOCAL_STATE_RET);
 
+	stm32mp_log_ring_drain();
+
+	stm32mp1_ddr_scrub_cpu_idle();
+
 	/*
 	 * Enter standby state.
 	 * Synchronize on memory accesses and instruction flow before the WFI
@@ -47,8 +55,14 @@ static void stm32_cpu_standby(plat_local_state_t cpu_state)
 	 */
 	dsb();
 	isb();
+#if ENABLE_PSCI_STAT_HISTOGRAM
+	psci_stats_hw_low_pwr_enter(cpu_state);
+#endif
 	while (interrupt == GIC_SPURIOUS_INTERRUPT) {
 		wfi();
+#if ENABLE_PSCI_STAT_HISTOGRAM
+		psci_stats_hw_low_pwr_exit(cpu_state);
+#endif
 
 		/* Acknoledge IT */
 		interrupt = gicv2_acknowledge_interrupt();
@@ -58,6 +72,8 @@ static void stm32_cpu_standby(plat_local_state_t cpu_state)
 			gicv2_end_of_interrupt(interrupt);
 		}
 	}
+
+	stm32mp1_ddr_scrub_cpu_busy();
 }
 
 /*******************************************************************************
@@ -119,18 +135,25 @@ static int stm32_pwr_domain_on(u_register_t mpidr)
  ******************************************************************************/
 static void stm32_pwr_domain_off(const psci_power_state_t *target_state)
 {
-	/* Nothing to do */
+	stm32mp1_ddr_scrub_cpu_idle();
 }
 
 /*******************************************************************************
  * STM32MP1 handler called when a power domain is about to be suspended. The
  * target_state encodes the power state that each level should transition to.
  ******************************************************************************/
-static void stm32_pwr_domain_suspend(const psci_power_state_t *target_state)
+static void __hot stm32_pwr_domain_suspend(const psci_power_state_t
+					     *target_state)
 {
-	uint32_t soc_mode = stm32mp1_get_lp_soc_mode(PSCI_MODE_SYSTEM_SUSPEND);
+	/* Selected once, the wake-up deadline moving until the WFI */
+	suspend_soc_mode = stm32mp1_get_lp_soc_mode(PSCI_MODE_SYSTEM_SUSPEND);
 
-	stm32_enter_low_power(soc_mode, saved_entrypoint);
+#if SP_MIN_LAZY_BANKED_REGS
+	/* Banked registers are restored from the SMC context on warm boot */
+	smc_ctx_save_banked_regs(smc_get_ctx(NON_SECURE));
+#endif
+
+	stm32_enter_low_power(suspend_soc_mode, saved_entrypoint);
 }
 
 /*******************************************************************************
@@ -144,6 +167,8 @@ static void stm32_pwr_domain_on_finish(const psci_power_state_t *target_state)
 	stm32mp_gic_pcpu_init();
 
 	write_cntfrq_el0(cntfrq_core0);
+
+	stm32mp1_ddr_scrub_cpu_busy();
 }
 
 /*******************************************************************************
@@ -151,8 +176,8 @@ static void stm32_pwr_domain_on_finish(const psci_power_state_t *target_state)
  * having been suspended earlier. The target_state encodes the low power state
  * that each level has woken up from.
  ******************************************************************************/
-static void stm32_pwr_domain_suspend_finish(const psci_power_state_t
-					    *target_state)
+static void __hot stm32_pwr_domain_suspend_finish(const psci_power_state_t
+						  *target_state)
 {
 	/* Nothing to do, power domain is not disabled */
 }
@@ -162,15 +187,24 @@ static void stm32_pwr_domain_suspend_finish(const psci_power_state_t
  * call is made by core 0, it is a return from stop mode. In this case, we
  * should restore previous context and jump to secure entrypoint.
  ******************************************************************************/
-static void __dead2 stm32_pwr_domain_pwr_down_wfi(const psci_power_state_t
-						  *target_state)
+static void __dead2 __hot stm32_pwr_domain_pwr_down_wfi(const psci_power_state_t
+							*target_state)
 {
 	if (MPIDR_AFFLVL0_VAL(read_mpidr_el1()) == STM32MP_PRIMARY_CPU) {
 		void (*warm_entrypoint)(void) =
 			(void (*)(void))stm32_sec_entrypoint;
 
-		stm32_pwr_down_wfi(stm32_is_cstop_done(),
-				   stm32mp1_get_lp_soc_mode(PSCI_MODE_SYSTEM_SUSPEND));
+#if ENABLE_PSCI_STAT_HISTOGRAM
+		psci_stats_hw_low_pwr_enter(
+			target_state->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+#endif
+
+		stm32_pwr_down_wfi(stm32_is_cstop_done(), suspend_soc_mode);
+
+#if ENABLE_PSCI_STAT_HISTOGRAM
+		psci_stats_hw_low_pwr_exit(
+			target_state->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+#endif
 
 		stm32_exit_cstop();
 
@@ -219,8 +253,8 @@ static void __dead2 stm32_system_reset(void)
 	stm32mp_system_reset();
 }
 
-static int stm32_validate_power_state(unsigned int power_state,
-				      psci_power_state_t *req_state)
+static int __hot stm32_validate_power_state(unsigned int power_state,
+					    psci_power_state_t *req_state)
 {
 	int pstate = psci_get_pstate_type(power_state);
 
@@ -236,6 +270,11 @@ static int stm32_validate_power_state(unsigned int power_state,
 		return PSCI_E_INVALID_PARAMS;
 	}
 
+	/*
+	 * Only core-local retention is exposed through CPU_SUSPEND: PSCI enters
+	 * it directly through stm32_cpu_standby(), without taking the power
+	 * domain locks nor doing cache maintenance.
+	 */
 	req_state->pwr_domain_state[0] = ARM_LOCAL_STATE_RET;
 	req_state->pwr_domain_state[1] = ARM_LOCAL_STATE_RUN;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2017-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,6 +15,7 @@
 #include <dt-bindings/power/stm32mp1-power.h>
 
 #include <stm32mp_dt.h>
+#include <stm32mp1_lp_governor.h>
 #include <stm32mp1_power_config.h>
 
 #define SYSTEM_SUSPEND_SUPPORTED_MODES	"system_suspend_supported_soc_modes"
@@ -189,17 +190,25 @@ static bool is_allowed_mode(uint32_t soc_mode)
 	return stm32mp1_supported_soc_modes[soc_mode] == 1U;
 }
 
+/*
+ * Get the deepest allowed mode, and with STM32MP_LP_GOVERNOR, the deepest one
+ * entered and exited before the next known wake-up event.
+ */
 uint32_t stm32mp1_get_lp_soc_mode(uint32_t psci_mode)
 {
 	uint32_t mode;
+	uint64_t deadline_us;
 
 	if (psci_mode == PSCI_MODE_SYSTEM_OFF) {
 		return system_off_mode;
 	}
 
 	mode = deepest_system_suspend_mode;
+	deadline_us = stm32mp1_lp_governor_get_deadline_us();
 
-	while ((mode > STM32_PM_CSLEEP_RUN) && !is_allowed_mode(mode)) {
+	while ((mode > STM32_PM_CSLEEP_RUN) &&
+	       (!is_allowed_mode(mode) ||
+		!stm32mp1_lp_governor_fits(mode, deadline_us))) {
 		mode--;
 	}
 
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <arch_helpers.h>
 #include <drivers/arm/gicv2.h>
@@ -94,6 +95,15 @@
 					MT_EXECUTE_NEVER)
 #endif
 
+#if STM32MP_M4_EARLY_BOOT
+#define MAP_RETRAM	MAP_REGION_FLAT(RETRAM_BASE, \
+					RETRAM_SIZE_2MB_ALIGNED, \
+					MT_MEMORY | \
+					MT_RW | \
+					MT_SECURE | \
+					MT_EXECUTE_NEVER)
+#endif
+
 #define MAP_DEVICE1	MAP_REGION_FLAT(STM32MP1_DEVICE1_BASE, \
 					STM32MP1_DEVICE1_SIZE, \
 					MT_DEVICE | \
@@ -113,9 +123,12 @@ static const mmap_region_t stm32mp1_mmap[] = {
 	MAP_SEC_SYSRAM,
 #if STM32MP13
 	MAP_SRAM_ALL,
+#endif
+#if STM32MP_M4_EARLY_BOOT
+	MAP_RETRAM,
 #endif
 	MAP_DEVICE1,
-#if STM32MP_RAW_NAND
+#if STM32MP_RAW_NAND || STM32MP_BL2_SMP
 	MAP_DEVICE2,
 #endif
 	{0}
@@ -268,7 +281,7 @@ int stm32_get_gpio_bank_pinctrl_node(void *fdt, unsigned int bank)
 		panic();
 	}
 
-	return fdt_node_offset_by_compatible(fdt, -1, node_compatible);
+	return dt_node_offset_by_compatible(-1, node_compatible);
 }
 
 #if STM32MP_UART_PROGRAMMER || !defined(IMAGE_BL2)
@@ -793,6 +806,28 @@ enum etzpc_decprot_attributes stm32mp_etzpc_binding2decprot(uint32_t mode)
 		panic();
 	}
 }
+
+/*
+ * Get the GIC interrupts of a secure I2C instance. The event interrupt is
+ * described through the EXTI in the device tree, its GIC mapping is fixed.
+ */
+int stm32mp1_i2c_get_irqs(uintptr_t base, int *irq_event, int *irq_error)
+{
+	switch (base) {
+	case I2C4_BASE:
+		*irq_event = (int)STM32MP1_IRQ_I2C4_EV;
+		*irq_error = (int)STM32MP1_IRQ_I2C4_ER;
+		break;
+	case I2C6_BASE:
+		*irq_event = (int)STM32MP1_IRQ_I2C6_EV;
+		*irq_error = (int)STM32MP1_IRQ_I2C6_ER;
+		break;
+	default:
+		return -ENOENT;
+	}
+
+	return 0;
+}
 #endif
 
 bool stm32mp1_addr_inside_backupsram(uintptr_t addr)
@@ -801,7 +836,7 @@ bool stm32mp1_addr_inside_backupsram(uintptr_t addr)
 		(addr < (STM32MP_BACKUP_RAM_BASE + STM32MP_BACKUP_RAM_SIZE));
 }
 
-bool stm32mp1_is_wakeup_from_standby(void)
+static bool is_wakeup_from_standby(void)
 {
 	uint32_t rstsr = mmio_read_32(stm32mp_rcc_base() + RCC_MP_RSTSCLRR);
 #if STM32MP15
@@ -830,6 +865,21 @@ bool stm32mp1_is_wakeup_from_standby(void)
 	return stm32_pm_context_is_valid();
 }
 
+/*
+ * The wakeup source is evaluated once, the first call shall occur once the
+ * clock driver is initialized to access the backup registers and SRAM.
+ */
+bool stm32mp1_is_wakeup_from_standby(void)
+{
+	static int wakeup = -1;
+
+	if (wakeup == -1) {
+		wakeup = is_wakeup_from_standby() ? 1 : 0;
+	}
+
+	return wakeup == 1;
+}
+
 bool stm32mp_skip_boot_device_after_standby(void)
 {
 	static int skip = -1;
@@ -941,6 +991,10 @@ void stm32mp_dump_core_registers(bool fcore)
 		return;
 	}
 
+#if SP_MIN_LAZY_BANKED_REGS
+	smc_ctx_save_banked_regs(ctx);
+#endif
+
 	INFO("CPU : %i\n", plat_my_core_pos());
 
 	for (i = 0U; i < ARRAY_SIZE(dump_table); i++) {
@@ -987,4 +1041,41 @@ void stm32_set_max_fwu_trial_boot_cnt(void)
 			   TAMP_BOOT_FWU_INFO_CNT_MSK);
 	clk_disable(RTCAPB);
 }
+
+#if STM32MP_FWU_IWDG_FALLBACK
+/*
+ * Called in trial state, once the trial boot counter is decremented. Return
+ * true if a previous trial boot ended with a watchdog reset, the counter is
+ * then cleared for the next boots to also select the previous bank. The IWDG
+ * reset flags are cleared, not to be taken for the failure of a next trial.
+ */
+bool stm32_fwu_trial_failed_on_iwdg(void)
+{
+	uintptr_t rstsclrr = stm32mp_rcc_base() + RCC_MP_RSTSCLRR;
+	uintptr_t bkpr_fwu_cnt = tamp_bkpr(TAMP_BOOT_FWU_INFO_REG_ID);
+	uint32_t iwdg_rst = RCC_MP_RSTSCLRR_IWDG1RSTF |
+			    RCC_MP_RSTSCLRR_IWDG2RSTF;
+	uint32_t try_cnt;
+	bool failed;
+
+	if ((mmio_read_32(rstsclrr) & iwdg_rst) == 0U) {
+		return false;
+	}
+
+	mmio_write_32(rstsclrr, iwdg_rst);
+
+	clk_enable(RTCAPB);
+	try_cnt = (mmio_read_32(bkpr_fwu_cnt) & TAMP_BOOT_FWU_INFO_CNT_MSK) >>
+		TAMP_BOOT_FWU_INFO_CNT_OFF;
+
+	/* The first trial boot decremented the counter from its max value */
+	failed = try_cnt < (FWU_MAX_TRIAL_REBOOT - 1U);
+	if (failed) {
+		mmio_clrbits_32(bkpr_fwu_cnt, TAMP_BOOT_FWU_INFO_CNT_MSK);
+	}
+	clk_disable(RTCAPB);
+
+	return failed;
+}
+#endif
 #endif /* PSA_FWU_SUPPORT */
@@ -1,26 +1,41 @@
 /*
- * Copyright (c) 2019-2020, STMicroelectronics - All Rights Reserved
+ * Copyright (c) 2019-2022, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 #include <platform_def.h>
 
+#include <drivers/arm/gicv2.h>
 #include <drivers/clk.h>
+#include <drivers/delay_timer.h>
+#include <drivers/regulator.h>
 #include <drivers/scmi-msg.h>
 #include <drivers/scmi.h>
+#include <drivers/st/stm32_dts.h>
 #include <drivers/st/stm32mp1_clk.h>
+#include <drivers/st/stm32mp_clkfunc.h>
+#include <drivers/st/stm32mp_pmic.h>
 #include <drivers/st/stm32mp_reset.h>
+#include <drivers/st/stpmic1.h>
 #include <dt-bindings/clock/stm32mp1-clks.h>
 #include <dt-bindings/reset/stm32mp1-resets.h>
+#include <lib/mmio.h>
+#include <lib/spinlock.h>
 #include <lib/utils.h>
+#include <plat/common/platform.h>
+
+#include <stm32mp_dt.h>
 
 #define TIMEOUT_US_1MS		1000U
 
 #define SCMI_CLOCK_NAME_SIZE	16U
 #define SCMI_RSTD_NAME_SIZE	16U
+#define SCMI_PERF_DOMAIN_NAME_SIZE	16U
+#define SCMI_SENSOR_NAME_SIZE	16U
 
 /*
  * struct stm32_scmi_clk - Data for the exposed clock
@@ -49,19 +64,63 @@ struct stm32_scmi_rstd {
 #define SMT_BUFFER0_BASE	SMT_BUFFER_BASE
 #define SMT_BUFFER1_BASE	(SMT_BUFFER_BASE + 0x200)
 
+/* Delayed response buffers, following each agent-to-server buffer */
+#define SMT_P2A_BUFFER0_BASE	(SMT_BUFFER0_BASE + 0x100)
+#define SMT_P2A_BUFFER1_BASE	(SMT_BUFFER1_BASE + 0x100)
+
+/* M4 agent buffer, in the free slot following agent 0 buffer */
+#define SMT_BUFFER2_BASE	(SMT_BUFFER_BASE + 0x80)
+
+/*
+ * The M4 rings the doorbell of its agent by setting its IPCC channel, then
+ * sending an event: the MCU SEV interrupt is secure while the IPCC one
+ * belongs to Linux. The channel is freed once the response is written.
+ */
+#define SCMI_M4_AGENT_ID	2U
+#define SCMI_M4_IPCC_CH		BIT(5)
+
+/* Secure SGI processing the deferred SCMI messages */
+#define SCMI_DELAYED_RESP_SGI	ARM_IRQ_SEC_SGI_2
+
 CASSERT((STM32MP_SCMI_NS_SHM_BASE + STM32MP_SCMI_NS_SHM_SIZE) >=
-	(SMT_BUFFER1_BASE + SMT_BUF_SLOT_SIZE),
+	(SMT_P2A_BUFFER1_BASE + SMT_BUF_SLOT_SIZE),
 	assert_scmi_non_secure_shm_fits_scmi_overall_buffer_size);
 
+#if STM32MP_BOOT_TIMELINE
+CASSERT(STM32MP_BOOT_TIMELINE_BASE >=
+	(SMT_P2A_BUFFER1_BASE + SMT_BUF_SLOT_SIZE),
+	assert_scmi_non_secure_shm_does_not_overlap_boot_timeline);
+#endif
+
+#if STM32MP_LOG_RING
+CASSERT(STM32MP_LOG_RING_BASE >=
+	(SMT_P2A_BUFFER1_BASE + SMT_BUF_SLOT_SIZE),
+	assert_scmi_non_secure_shm_does_not_overlap_log_ring);
+#endif
+
 static struct scmi_msg_channel scmi_channel[] = {
 	[0] = {
 		.shm_addr = SMT_BUFFER0_BASE,
 		.shm_size = SMT_BUF_SLOT_SIZE,
+#if STM32MP_SCMI_DELAYED_RESP
+		.p2a_shm_addr = SMT_P2A_BUFFER0_BASE,
+		.p2a_shm_size = SMT_BUF_SLOT_SIZE,
+#endif
 	},
 	[1] = {
 		.shm_addr = SMT_BUFFER1_BASE,
 		.shm_size = SMT_BUF_SLOT_SIZE,
+#if STM32MP_SCMI_DELAYED_RESP
+		.p2a_shm_addr = SMT_P2A_BUFFER1_BASE,
+		.p2a_shm_size = SMT_BUF_SLOT_SIZE,
+#endif
 	},
+#if STM32MP_SCMI_M4_AGENT
+	[SCMI_M4_AGENT_ID] = {
+		.shm_addr = SMT_BUFFER2_BASE,
+		.shm_size = SMT_BUF_SLOT_SIZE,
+	},
+#endif
 };
 
 struct scmi_msg_channel *plat_scmi_get_channel(unsigned int agent_id)
@@ -71,6 +130,50 @@ struct scmi_msg_channel *plat_scmi_get_channel(unsigned int agent_id)
 	return &scmi_channel[agent_id];
 }
 
+#if STM32MP_SCMI_DELAYED_RESP
+bool plat_scmi_delayed_response_kick(void)
+{
+	gicv2_raise_sgi(SCMI_DELAYED_RESP_SGI, plat_my_core_pos());
+
+	return true;
+}
+
+bool stm32mp1_scmi_it_handler(uint32_t id)
+{
+	if (id != SCMI_DELAYED_RESP_SGI) {
+		return false;
+	}
+
+	gicv2_end_of_interrupt(id);
+
+	scmi_delayed_response_process();
+
+	return true;
+}
+#endif
+
+#if STM32MP_SCMI_M4_AGENT
+bool stm32mp1_scmi_m4_it_handler(void)
+{
+	bool pending;
+
+	clk_enable(IPCC);
+
+	pending = (mmio_read_32(IPCC_BASE + IPCC_C2TOC1SR) &
+		   SCMI_M4_IPCC_CH) != 0U;
+	if (pending) {
+		scmi_smt_interrupt_entry(SCMI_M4_AGENT_ID);
+
+		/* Free the channel, the M4 reads the response on its event */
+		mmio_write_32(IPCC_BASE + IPCC_C1SCR, SCMI_M4_IPCC_CH);
+	}
+
+	clk_disable(IPCC);
+
+	return pending;
+}
+#endif
+
 #define CLOCK_CELL(_scmi_id, _id, _name, _init_enabled) \
 	[_scmi_id] = { \
 		.clock_id = _id, \
@@ -108,6 +211,13 @@ static struct stm32_scmi_clk stm32_scmi1_clock[] = {
 	CLOCK_CELL(CK_SCMI1_MCU, CK_MCU, "ck_mcu", false),
 };
 
+#if STM32MP_SCMI_M4_AGENT
+static struct stm32_scmi_clk stm32_scmi2_clock[] = {
+	CLOCK_CELL(CK_SCMI2_PLL3_Q, PLL3_Q, "pll3_q", false),
+	CLOCK_CELL(CK_SCMI2_PLL3_R, PLL3_R, "pll3_r", false),
+};
+#endif
+
 #define RESET_CELL(_scmi_id, _id, _name) \
 	[_scmi_id] = { \
 		.reset_id = _id, \
@@ -129,11 +239,75 @@ static struct stm32_scmi_rstd stm32_scmi0_reset_domain[] = {
 	RESET_CELL(RST_SCMI0_MCU_HOLD_BOOT, MCU_HOLD_BOOT_R, "mcu_hold_boot"),
 };
 
+#if STM32MP_SCMI_M4_AGENT
+static struct stm32_scmi_rstd stm32_scmi2_reset_domain[] = {
+	RESET_CELL(RST_SCMI2_SPI6, SPI6_R, "spi6"),
+	RESET_CELL(RST_SCMI2_I2C6, I2C6_R, "i2c6"),
+	RESET_CELL(RST_SCMI2_USART1, USART1_R, "usart1"),
+};
+#endif
+
+/* Single CPU performance domain, levels are the DT OPP frequencies */
+#define SCMI_PERF_CPU		0U
+
+static const char * const stm32_scmi0_perf_domain[] = {
+	[SCMI_PERF_CPU] = "cpu",
+};
+
+static struct {
+	uint32_t freq_khz[PLAT_MAX_OPP_NB];
+	uint32_t volt_mv[PLAT_MAX_OPP_NB];
+	size_t count;
+	struct rdev *regul;
+	/* Level queries are readers, level changes are writers */
+	struct rwlock lock;
+} cpu_opp;
+
+/*
+ * SoC temperature, then the PMIC rail voltages, named after the STPMIC1
+ * regulators
+ */
+#define SCMI_SENSOR_DTS		0U
+#define SCMI_SENSOR_PMIC_FIRST	1U
+
+static const char * const stm32_scmi0_sensor[] = {
+	[SCMI_SENSOR_DTS] = "dts",
+	"buck1",
+	"buck2",
+	"buck3",
+	"buck4",
+	"ldo1",
+	"ldo2",
+	"ldo3",
+	"ldo5",
+	"ldo6",
+};
+
+#define PMIC_SENSOR_COUNT	(ARRAY_SIZE(stm32_scmi0_sensor) - \
+				 SCMI_SENSOR_PMIC_FIRST)
+
+/*
+ * Rail voltages are all read in a single I2C transfer, then served from
+ * this cache for a polling period.
+ */
+#define PMIC_SENSOR_PERIOD_US	100000U
+
+static struct {
+	int mv[PMIC_SENSOR_COUNT];
+	uint64_t timeout;
+	bool valid;
+	bool available;
+} pmic_sensor;
+
 struct scmi_agent_resources {
 	struct stm32_scmi_clk *clock;
 	size_t clock_count;
 	struct stm32_scmi_rstd *rstd;
 	size_t rstd_count;
+	const char * const *perf;
+	size_t perf_count;
+	const char * const *sensor;
+	size_t sensor_count;
 };
 
 static const struct scmi_agent_resources agent_resources[] = {
@@ -142,11 +316,23 @@ static const struct scmi_agent_resources agent_resources[] = {
 		.clock_count = ARRAY_SIZE(stm32_scmi0_clock),
 		.rstd = stm32_scmi0_reset_domain,
 		.rstd_count = ARRAY_SIZE(stm32_scmi0_reset_domain),
+		.perf = stm32_scmi0_perf_domain,
+		.perf_count = ARRAY_SIZE(stm32_scmi0_perf_domain),
+		.sensor = stm32_scmi0_sensor,
+		.sensor_count = ARRAY_SIZE(stm32_scmi0_sensor),
 	},
 	[1] = {
 		.clock = stm32_scmi1_clock,
 		.clock_count = ARRAY_SIZE(stm32_scmi1_clock),
 	},
+#if STM32MP_SCMI_M4_AGENT
+	[SCMI_M4_AGENT_ID] = {
+		.clock = stm32_scmi2_clock,
+		.clock_count = ARRAY_SIZE(stm32_scmi2_clock),
+		.rstd = stm32_scmi2_reset_domain,
+		.rstd_count = ARRAY_SIZE(stm32_scmi2_reset_domain),
+	},
+#endif
 };
 
 static const struct scmi_agent_resources *find_resource(unsigned int agent_id)
@@ -176,6 +362,20 @@ static size_t plat_scmi_protocol_count_paranoid(void)
 		}
 	}
 
+	for (n = 0U; n < ARRAY_SIZE(agent_resources); n++) {
+		if (agent_resources[n].perf_count) {
+			count++;
+			break;
+		}
+	}
+
+	for (n = 0U; n < ARRAY_SIZE(agent_resources); n++) {
+		if (agent_resources[n].sensor_count) {
+			count++;
+			break;
+		}
+	}
+
 	return count;
 }
 #endif
@@ -193,10 +393,12 @@ const char *plat_scmi_sub_vendor_name(void)
 	return sub_vendor;
 }
 
-/* Currently supporting Clocks and Reset Domains */
+/* Currently supporting Performance Domains, Clocks, Reset Domains, Sensors */
 static const uint8_t plat_protocol_list[] = {
+	SCMI_PROTOCOL_ID_PERF,
 	SCMI_PROTOCOL_ID_CLOCK,
 	SCMI_PROTOCOL_ID_RESET_DOMAIN,
+	SCMI_PROTOCOL_ID_SENSOR,
 	0U /* Null termination */
 };
 
@@ -224,14 +426,9 @@ static struct stm32_scmi_clk *find_clock(unsigned int agent_id,
 					 unsigned int scmi_id)
 {
 	const struct scmi_agent_resources *resource = find_resource(agent_id);
-	size_t n = 0U;
 
-	if (resource != NULL) {
-		for (n = 0U; n < resource->clock_count; n++) {
-			if (n == scmi_id) {
-				return &resource->clock[n];
-			}
-		}
+	if ((resource != NULL) && (scmi_id < resource->clock_count)) {
+		return &resource->clock[scmi_id];
 	}
 
 	return NULL;
@@ -309,6 +506,7 @@ int32_t plat_scmi_clock_set_rate(unsigned int agent_id,
 				 unsigned long rate)
 {
 	struct stm32_scmi_clk *clock = find_clock(agent_id, scmi_id);
+	int ret;
 
 	if (clock == NULL) {
 		return SCMI_NOT_FOUND;
@@ -320,7 +518,10 @@ int32_t plat_scmi_clock_set_rate(unsigned int agent_id,
 
 	switch (scmi_id) {
 	case CK_SCMI0_MPU:
-		if (stm32mp1_set_opp_khz(rate / 1000UL) != 0) {
+		rw_write_lock(&cpu_opp.lock);
+		ret = stm32mp1_set_opp_khz(rate / 1000UL);
+		rw_write_unlock(&cpu_opp.lock);
+		if (ret != 0) {
 			return SCMI_INVALID_PARAMETERS;
 		}
 		break;
@@ -389,6 +590,271 @@ int32_t plat_scmi_clock_set_state(unsigned int agent_id, unsigned int scmi_id,
 	return SCMI_SUCCESS;
 }
 
+/*
+ * Platform SCMI performance domains
+ */
+size_t plat_scmi_perf_count(unsigned int agent_id)
+{
+	const struct scmi_agent_resources *resource = find_resource(agent_id);
+
+	if ((resource == NULL) || (cpu_opp.count == 0U)) {
+		return 0U;
+	}
+
+	return resource->perf_count;
+}
+
+const char *plat_scmi_perf_get_name(unsigned int agent_id,
+				    unsigned int scmi_id)
+{
+	const struct scmi_agent_resources *resource = find_resource(agent_id);
+
+	if ((resource == NULL) || (scmi_id >= resource->perf_count)) {
+		return NULL;
+	}
+
+	return resource->perf[scmi_id];
+}
+
+int32_t plat_scmi_perf_levels_array(unsigned int agent_id,
+				    unsigned int scmi_id, size_t start_index,
+				    unsigned int *levels, size_t *nb_elts)
+{
+	size_t n;
+
+	if (scmi_id >= plat_scmi_perf_count(agent_id)) {
+		return SCMI_NOT_FOUND;
+	}
+
+	if (levels == NULL) {
+		*nb_elts = cpu_opp.count;
+		return SCMI_SUCCESS;
+	}
+
+	if ((start_index > cpu_opp.count) ||
+	    (*nb_elts > (cpu_opp.count - start_index))) {
+		return SCMI_OUT_OF_RANGE;
+	}
+
+	for (n = 0U; n < *nb_elts; n++) {
+		levels[n] = cpu_opp.freq_khz[start_index + n];
+	}
+
+	return SCMI_SUCCESS;
+}
+
+int32_t plat_scmi_perf_level_get(unsigned int agent_id, unsigned int scmi_id,
+				 unsigned int *level)
+{
+	if (scmi_id >= plat_scmi_perf_count(agent_id)) {
+		return SCMI_NOT_FOUND;
+	}
+
+	rw_read_lock(&cpu_opp.lock);
+	*level = (unsigned int)(clk_get_rate(CK_MPU) / 1000UL);
+	rw_read_unlock(&cpu_opp.lock);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Raise the voltage before increasing the frequency, lower it after
+ * decreasing the frequency, under the lock shared with the MPU clock rate.
+ */
+int32_t plat_scmi_perf_level_set(unsigned int agent_id, unsigned int scmi_id,
+				 unsigned int level)
+{
+	unsigned int cur_khz;
+	int32_t status = SCMI_SUCCESS;
+	size_t n;
+
+	if (scmi_id >= plat_scmi_perf_count(agent_id)) {
+		return SCMI_NOT_FOUND;
+	}
+
+	for (n = 0U; n < cpu_opp.count; n++) {
+		if (cpu_opp.freq_khz[n] == level) {
+			break;
+		}
+	}
+
+	if (n == cpu_opp.count) {
+		return SCMI_OUT_OF_RANGE;
+	}
+
+	rw_write_lock(&cpu_opp.lock);
+
+	cur_khz = (unsigned int)(clk_get_rate(CK_MPU) / 1000UL);
+
+	if ((cpu_opp.regul != NULL) && (level > cur_khz) &&
+	    (regulator_set_voltage(cpu_opp.regul,
+				   (uint16_t)cpu_opp.volt_mv[n]) != 0)) {
+		status = SCMI_HARDWARE_ERROR;
+		goto out;
+	}
+
+	if (stm32mp1_set_opp_khz(level) != 0) {
+		status = SCMI_HARDWARE_ERROR;
+		goto out;
+	}
+
+	if ((cpu_opp.regul != NULL) && (level < cur_khz) &&
+	    (regulator_set_voltage(cpu_opp.regul,
+				   (uint16_t)cpu_opp.volt_mv[n]) != 0)) {
+		/* Lower frequency is still safe at the higher voltage */
+		WARN("CPU voltage not lowered for %ukHz\n", level);
+	}
+
+out:
+	/* CPU rail voltage may have changed */
+	pmic_sensor.valid = false;
+
+	rw_write_unlock(&cpu_opp.lock);
+
+	return status;
+}
+
+static void init_cpu_opp(void)
+{
+	uint32_t count = PLAT_MAX_OPP_NB;
+	size_t i;
+	size_t j;
+
+	if (dt_get_all_opp_freqvolt(&count, cpu_opp.freq_khz,
+				    cpu_opp.volt_mv) != 0) {
+		VERBOSE("No SCMI CPU performance domain\n");
+		return;
+	}
+
+	/* Sort levels in ascending frequency order */
+	for (i = 1U; i < count; i++) {
+		for (j = i; (j > 0U) &&
+		     (cpu_opp.freq_khz[j - 1U] > cpu_opp.freq_khz[j]); j--) {
+			uint32_t freq = cpu_opp.freq_khz[j];
+			uint32_t volt = cpu_opp.volt_mv[j];
+
+			cpu_opp.freq_khz[j] = cpu_opp.freq_khz[j - 1U];
+			cpu_opp.volt_mv[j] = cpu_opp.volt_mv[j - 1U];
+			cpu_opp.freq_khz[j - 1U] = freq;
+			cpu_opp.volt_mv[j - 1U] = volt;
+		}
+	}
+
+	if (dt_pmic_status() > 0) {
+		cpu_opp.regul = dt_get_cpu_regulator();
+	}
+
+	cpu_opp.count = count;
+}
+
+/*
+ * Platform SCMI sensors
+ */
+size_t plat_scmi_sensor_count(unsigned int agent_id)
+{
+	const struct scmi_agent_resources *resource = find_resource(agent_id);
+
+	if (resource == NULL) {
+		return 0U;
+	}
+
+	/* Without PMIC, only the SoC temperature is exposed */
+	if (!pmic_sensor.available) {
+		return MIN(resource->sensor_count,
+			   (size_t)SCMI_SENSOR_PMIC_FIRST);
+	}
+
+	return resource->sensor_count;
+}
+
+const char *plat_scmi_sensor_get_name(unsigned int agent_id,
+				      unsigned int scmi_id)
+{
+	const struct scmi_agent_resources *resource = find_resource(agent_id);
+
+	if ((resource == NULL) ||
+	    (scmi_id >= plat_scmi_sensor_count(agent_id))) {
+		return NULL;
+	}
+
+	return resource->sensor[scmi_id];
+}
+
+int32_t plat_scmi_sensor_get_unit(unsigned int agent_id, unsigned int scmi_id,
+				  unsigned int *type, int *scale)
+{
+	if (scmi_id >= plat_scmi_sensor_count(agent_id)) {
+		return SCMI_NOT_FOUND;
+	}
+
+	/* Millidegree Celsius and millivolts */
+	if (scmi_id == SCMI_SENSOR_DTS) {
+		*type = SCMI_SENSOR_TYPE_DEGREES_C;
+	} else {
+		*type = SCMI_SENSOR_TYPE_VOLTS;
+	}
+
+	*scale = -3;
+
+	return SCMI_SUCCESS;
+}
+
+static int32_t read_pmic_sensor(unsigned int index, int64_t *value)
+{
+	int mv;
+
+	if (!pmic_sensor.valid || timeout_elapsed(pmic_sensor.timeout)) {
+		if (stpmic1_regulators_voltage_get(
+			&stm32_scmi0_sensor[SCMI_SENSOR_PMIC_FIRST],
+			pmic_sensor.mv, PMIC_SENSOR_COUNT) != 0) {
+			pmic_sensor.valid = false;
+			return SCMI_HARDWARE_ERROR;
+		}
+
+		pmic_sensor.timeout = timeout_init_us(PMIC_SENSOR_PERIOD_US);
+		pmic_sensor.valid = true;
+	}
+
+	mv = pmic_sensor.mv[index];
+	if (mv < 0) {
+		return SCMI_HARDWARE_ERROR;
+	}
+
+	*value = mv;
+
+	return SCMI_SUCCESS;
+}
+
+int32_t plat_scmi_sensor_reading_get(unsigned int agent_id,
+				     unsigned int scmi_id, int64_t *value)
+{
+	int mcelsius = 0;
+	int ret;
+
+	if (scmi_id >= plat_scmi_sensor_count(agent_id)) {
+		return SCMI_NOT_FOUND;
+	}
+
+	if (scmi_id != SCMI_SENSOR_DTS) {
+		return read_pmic_sensor(scmi_id - SCMI_SENSOR_PMIC_FIRST,
+					value);
+	}
+
+	ret = stm32_dts_get_temp(&mcelsius);
+	if (ret == -ENODEV) {
+		/* Sensor not assigned to the secure world */
+		return SCMI_DENIED;
+	}
+
+	if (ret != 0) {
+		return SCMI_HARDWARE_ERROR;
+	}
+
+	*value = mcelsius;
+
+	return SCMI_SUCCESS;
+}
+
 /*
  * Platform SCMI reset domains
  */
@@ -396,14 +862,9 @@ static struct stm32_scmi_rstd *find_rstd(unsigned int agent_id,
 					 unsigned int scmi_id)
 {
 	const struct scmi_agent_resources *resource = find_resource(agent_id);
-	size_t n;
 
-	if (resource != NULL) {
-		for (n = 0U; n < resource->rstd_count; n++) {
-			if (n == scmi_id) {
-				return &resource->rstd[n];
-			}
-		}
+	if ((resource != NULL) && (scmi_id < resource->rstd_count)) {
+		return &resource->rstd[scmi_id];
 	}
 
 	return NULL;
@@ -497,6 +958,95 @@ int32_t plat_scmi_rstd_set_state(unsigned int agent_id, unsigned int scmi_id,
 	return SCMI_SUCCESS;
 }
 
+/* Get the reset controller IDs of a group of SCMI reset domains */
+static int32_t rstd_group_reset_ids(unsigned int agent_id,
+				    const uint32_t *scmi_id, size_t count,
+				    uint32_t *reset_id)
+{
+	size_t i;
+
+	for (i = 0U; i < count; i++) {
+		const struct stm32_scmi_rstd *rstd = find_rstd(agent_id,
+							       scmi_id[i]);
+
+		if (rstd == NULL) {
+			return SCMI_NOT_FOUND;
+		}
+
+		/* The MCU hold boot is not an RCC reset line */
+		if (rstd->reset_id == MCU_HOLD_BOOT_R) {
+			return SCMI_NOT_SUPPORTED;
+		}
+
+		if (!stm32mp_nsec_can_access_reset(rstd->reset_id)) {
+			return SCMI_DENIED;
+		}
+
+		reset_id[i] = (uint32_t)rstd->reset_id;
+	}
+
+	return SCMI_SUCCESS;
+}
+
+int32_t plat_scmi_rstd_group_autonomous(unsigned int agent_id,
+					const uint32_t *scmi_id, size_t count,
+					unsigned int state)
+{
+	uint32_t reset_id[SCMI_RESET_DOMAIN_GROUP_MAX];
+	int32_t status;
+
+	assert(count <= ARRAY_SIZE(reset_id));
+
+	status = rstd_group_reset_ids(agent_id, scmi_id, count, reset_id);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	/* Supports only reset with context loss */
+	if (state != 0U) {
+		return SCMI_NOT_SUPPORTED;
+	}
+
+	VERBOSE("SCMI reset group of %u cycle\n", (unsigned int)count);
+
+	if (stm32mp_reset_assert_multi(reset_id, count, TIMEOUT_US_1MS) != 0) {
+		return SCMI_HARDWARE_ERROR;
+	}
+
+	if (stm32mp_reset_deassert_multi(reset_id, count,
+					 TIMEOUT_US_1MS) != 0) {
+		return SCMI_HARDWARE_ERROR;
+	}
+
+	return SCMI_SUCCESS;
+}
+
+int32_t plat_scmi_rstd_group_set_state(unsigned int agent_id,
+				       const uint32_t *scmi_id, size_t count,
+				       bool assert_not_deassert)
+{
+	uint32_t reset_id[SCMI_RESET_DOMAIN_GROUP_MAX];
+	int32_t status;
+
+	assert(count <= ARRAY_SIZE(reset_id));
+
+	status = rstd_group_reset_ids(agent_id, scmi_id, count, reset_id);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	VERBOSE("SCMI reset group of %u %s\n", (unsigned int)count,
+		assert_not_deassert ? "set" : "release");
+
+	if (assert_not_deassert) {
+		(void)stm32mp_reset_assert_multi(reset_id, count, 0U);
+	} else {
+		(void)stm32mp_reset_deassert_multi(reset_id, count, 0U);
+	}
+
+	return SCMI_SUCCESS;
+}
+
 /*
  * Initialize platform SCMI resources
  */
@@ -537,7 +1087,33 @@ void stm32mp1_init_scmi_server(void)
 				panic();
 			}
 		}
+
+		for (j = 0U; j < res->perf_count; j++) {
+			if ((res->perf[j] == NULL) ||
+			    (strlen(res->perf[j]) >= SCMI_PERF_DOMAIN_NAME_SIZE)) {
+				ERROR("Invalid SCMI performance domain name\n");
+				panic();
+			}
+		}
+
+		for (j = 0U; j < res->sensor_count; j++) {
+			if ((res->sensor[j] == NULL) ||
+			    (strlen(res->sensor[j]) >= SCMI_SENSOR_NAME_SIZE)) {
+				ERROR("Invalid SCMI sensor name\n");
+				panic();
+			}
+		}
+	}
+
+	init_cpu_opp();
+
+#if STM32MP_SCMI_M4_AGENT
+	if (fdt_rcc_enable_it("mcu_sev") < 0) {
+		WARN("No M4 SCMI doorbell\n");
 	}
+#endif
+
+	pmic_sensor.available = dt_pmic_status() > 0;
 }
 
 /*
@@ -479,7 +479,7 @@ static bool stm32mp_gpio_bank_is_secure(unsigned int bank)
 	return secure == get_gpioz_nbpin();
 }
 
-bool stm32mp_nsec_can_access_clock(unsigned long clock_id)
+static bool nsec_can_access_clock(unsigned long clock_id)
 {
 	enum stm32mp_shres shres_id = STM32MP1_SHRES_COUNT;
 
@@ -541,7 +541,7 @@ bool stm32mp_nsec_can_access_clock(unsigned long clock_id)
 	return periph_is_non_secure(shres_id);
 }
 
-bool stm32mp_nsec_can_access_reset(unsigned int reset_id)
+static bool nsec_can_access_reset(unsigned int reset_id)
 {
 	enum stm32mp_shres shres_id = STM32MP1_SHRES_COUNT;
 
@@ -584,6 +584,93 @@ bool stm32mp_nsec_can_access_reset(unsigned int reset_id)
 	return periph_is_non_secure(shres_id);
 }
 
+/*
+ * Non-secure access rights to clocks and resets, computed once the resource
+ * states are locked. Resets are grouped by RCC reset register (32 resets
+ * each), only the registers holding resets that may be non-secure are
+ * listed.
+ */
+#define RST_PER_BANK		32U
+
+static const unsigned int nsec_rst_bank_id[] = {
+	MCU_HOLD_BOOT_R / RST_PER_BANK,
+	USART1_R / RST_PER_BANK,
+	CRYP1_R / RST_PER_BANK,
+	MDMA_R / RST_PER_BANK,
+	MCU_R / RST_PER_BANK,
+};
+
+static const unsigned int nsec_rst_id[] = {
+	CRYP1_R, GPIOZ_R, HASH1_R, I2C4_R, I2C6_R, MCU_R, MCU_HOLD_BOOT_R,
+	MDMA_R, RNG1_R, SPI6_R, USART1_R,
+};
+
+static uint32_t nsec_clk_map[DIV_ROUND_UP_2EVAL(STM32MP1_LAST_CLK, 32U)];
+static uint32_t nsec_rst_map[ARRAY_SIZE(nsec_rst_bank_id)];
+static bool nsec_maps_ready;
+
+static void build_nsec_access_maps(void)
+{
+	unsigned long clock_id;
+	unsigned int i;
+	unsigned int j;
+
+	for (clock_id = 0U; clock_id < STM32MP1_LAST_CLK; clock_id++) {
+		if (nsec_can_access_clock(clock_id)) {
+			nsec_clk_map[clock_id / 32U] |= BIT(clock_id % 32U);
+		}
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(nsec_rst_id); i++) {
+		if (!nsec_can_access_reset(nsec_rst_id[i])) {
+			continue;
+		}
+
+		for (j = 0U; j < ARRAY_SIZE(nsec_rst_bank_id); j++) {
+			if (nsec_rst_bank_id[j] == (nsec_rst_id[i] / RST_PER_BANK)) {
+				nsec_rst_map[j] |= BIT(nsec_rst_id[i] % RST_PER_BANK);
+				break;
+			}
+		}
+
+		assert(j < ARRAY_SIZE(nsec_rst_bank_id));
+	}
+
+	nsec_maps_ready = true;
+}
+
+bool stm32mp_nsec_can_access_clock(unsigned long clock_id)
+{
+	if (!nsec_maps_ready) {
+		build_nsec_access_maps();
+	}
+
+	if (clock_id >= STM32MP1_LAST_CLK) {
+		return false;
+	}
+
+	return (nsec_clk_map[clock_id / 32U] & BIT(clock_id % 32U)) != 0U;
+}
+
+bool stm32mp_nsec_can_access_reset(unsigned int reset_id)
+{
+	unsigned int bank = reset_id / RST_PER_BANK;
+	unsigned int i;
+
+	if (!nsec_maps_ready) {
+		build_nsec_access_maps();
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(nsec_rst_bank_id); i++) {
+		if (nsec_rst_bank_id[i] == bank) {
+			return (nsec_rst_map[i] &
+				BIT(reset_id % RST_PER_BANK)) != 0U;
+		}
+	}
+
+	return false;
+}
+
 static bool mckprot_protects_periph(enum stm32mp_shres id)
 {
 	switch (id) {
@@ -751,4 +838,8 @@ void stm32mp_lock_periph_registering(void)
 	check_rcc_secure_configuration();
 	check_etzpc_secure_configuration();
 	set_gpio_secure_configuration();
+
+	if (!nsec_maps_ready) {
+		build_nsec_access_maps();
+	}
 }
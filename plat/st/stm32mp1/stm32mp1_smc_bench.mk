@@ -0,0 +1,43 @@
+#
+# Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+# SMC latency benchmark, a normal world payload to be loaded as BL33
+SMC_BENCH_ITERATIONS	?=	1000
+# Secure timer interrupt period, with STM32MP_IT_LATENCY in SP_MIN
+SMC_BENCH_IT_PERIOD_US	?=	100
+
+SMC_BENCH_DIR		:=	${BUILD_PLAT}/smc_bench
+SMC_BENCH_SOURCES	:=	plat/st/stm32mp1/smc_bench/smc_bench_entry.S		\
+				plat/st/stm32mp1/smc_bench/smc_bench.c
+SMC_BENCH_OBJS		:=	$(addprefix ${SMC_BENCH_DIR}/,$(patsubst %.S,%.o,$(patsubst %.c,%.o,$(notdir ${SMC_BENCH_SOURCES}))))
+SMC_BENCH_LINKERFILE	:=	${SMC_BENCH_DIR}/smc_bench.ld
+SMC_BENCH_ELF		:=	${BUILD_PLAT}/smc_bench.elf
+SMC_BENCH_BIN		:=	${BUILD_PLAT}/smc_bench.bin
+
+SMC_BENCH_CPPFLAGS	:=	-DSMC_BENCH_ITERATIONS=${SMC_BENCH_ITERATIONS}U	\
+				-DSMC_BENCH_IT_PERIOD_US=${SMC_BENCH_IT_PERIOD_US}U
+
+.PHONY: smc_bench smc_bench_dirs
+
+$(eval $(call MAKE_PREREQ_DIR,${SMC_BENCH_DIR},${BUILD_PLAT}))
+
+smc_bench_dirs: | ${SMC_BENCH_DIR}
+
+$(eval $(call MAKE_OBJS,${SMC_BENCH_DIR},${SMC_BENCH_SOURCES},smc_bench))
+
+$(eval $(call MAKE_LD,${SMC_BENCH_LINKERFILE},plat/st/stm32mp1/smc_bench/smc_bench.ld.S,smc_bench))
+
+${SMC_BENCH_ELF}: ${SMC_BENCH_OBJS} ${SMC_BENCH_LINKERFILE}
+	@echo "  LD      $@"
+	${Q}${LD} -o $@ ${STM32_TF_ELF_LDFLAGS} -Map=$(@:.elf=.map) --script ${SMC_BENCH_LINKERFILE} ${SMC_BENCH_OBJS}
+
+${SMC_BENCH_BIN}: ${SMC_BENCH_ELF}
+	${Q}${OC} -O binary $< $@
+	@echo
+	@echo "Built $@ successfully"
+	@echo
+
+smc_bench: ${SMC_BENCH_BIN}
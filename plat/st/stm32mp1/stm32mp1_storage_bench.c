@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/io/io_storage.h>
+#include <drivers/mmc.h>
+#include <drivers/nand.h>
+#include <drivers/spi_nor.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#include <boot_api.h>
+#include <platform_def.h>
+#include <stm32mp1_storage_bench.h>
+#include <stm32mp_common.h>
+#include <stm32mp_io_storage.h>
+
+/* Data buffer, BL33 is not loaded yet */
+#define STORAGE_BENCH_BASE	STM32MP_BL33_BASE
+/* Read area from the FIP offset, and data read per measure */
+#define STORAGE_BENCH_AREA	U(0x200000)
+#define STORAGE_BENCH_TOTAL	U(0x100000)
+#define STORAGE_BENCH_MAX_RUNS	U(64)
+/* Random offsets are aligned on a MMC block */
+#define STORAGE_BENCH_ALIGN	U(512)
+
+static const size_t bench_sizes[] = {
+	U(512), U(4096), U(65536), U(0x100000),
+};
+
+enum bench_layer {
+	BENCH_RAW,
+	BENCH_IO,
+	BENCH_FIP,
+};
+
+static const char * const bench_layers[] = {
+	[BENCH_RAW] = "raw",
+	[BENCH_IO] = "io",
+	[BENCH_FIP] = "fip",
+};
+
+static uint16_t bench_itf;
+static size_t bench_base;
+static uint32_t bench_seed;
+
+/* Reproducible offsets, from the same seed for each layer */
+static uint32_t bench_random(void)
+{
+	bench_seed ^= bench_seed << 13;
+	bench_seed ^= bench_seed >> 17;
+	bench_seed ^= bench_seed << 5;
+
+	return bench_seed;
+}
+
+static size_t bench_offset(size_t size, unsigned int run, bool random)
+{
+	if (!random) {
+		return (size_t)run * size;
+	}
+
+	return ((size_t)bench_random() % (STORAGE_BENCH_AREA - size + 1U)) &
+	       ~(STORAGE_BENCH_ALIGN - 1U);
+}
+
+static unsigned int bench_runs(size_t size)
+{
+	return MIN(STORAGE_BENCH_TOTAL / size, STORAGE_BENCH_MAX_RUNS);
+}
+
+static const char *bench_device(void)
+{
+	switch (bench_itf) {
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_SD:
+		return "sd";
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_EMMC:
+		return "emmc";
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NOR_QSPI:
+		return "spi-nor";
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NAND_FMC:
+		return "nand";
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NAND_QSPI:
+		return "spi-nand";
+	default:
+		return NULL;
+	}
+}
+
+/* Read with the driver op behind io_block or io_mtd */
+static int bench_raw_read(size_t offset, uintptr_t buf, size_t size)
+{
+	size_t length_read = 0U;
+	int ret = -ENODEV;
+
+	switch (bench_itf) {
+#if STM32MP_SDMMC || STM32MP_EMMC
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_SD:
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_EMMC:
+		length_read = mmc_read_blocks((int)(offset / MMC_BLOCK_SIZE),
+					      buf, size);
+		ret = 0;
+		break;
+#endif
+#if STM32MP_SPI_NOR
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NOR_QSPI:
+		ret = spi_nor_read(offset, buf, size, &length_read);
+		break;
+#endif
+#if STM32MP_RAW_NAND || STM32MP_SPI_NAND
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NAND_FMC:
+	case BOOT_API_CTX_BOOT_INTERFACE_SEL_FLASH_NAND_QSPI:
+		ret = nand_read(offset, buf, size, &length_read);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	if ((ret == 0) && (length_read != size)) {
+		ret = -EIO;
+	}
+
+	return ret;
+}
+
+static int bench_io_read(uintptr_t handle, size_t offset, uintptr_t buf,
+			 size_t size, bool random)
+{
+	size_t length_read;
+	int ret;
+
+	if (random) {
+		ret = io_seek(handle, IO_SEEK_SET, (signed long long)offset);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	ret = io_read(handle, buf, size, &length_read);
+	if ((ret == 0) && (length_read != size)) {
+		ret = -EIO;
+	}
+
+	return ret;
+}
+
+static int bench_open(enum bench_layer layer, uintptr_t *handle,
+		      size_t *length)
+{
+	static io_block_spec_t area_spec;
+	uintptr_t dev_handle;
+	uintptr_t spec;
+	int ret;
+
+	if (layer == BENCH_IO) {
+		area_spec.offset = bench_base;
+		area_spec.length = STORAGE_BENCH_AREA;
+		*length = STORAGE_BENCH_AREA;
+
+		return io_open(storage_dev_handle, (uintptr_t)&area_spec,
+			       handle);
+	}
+
+	/* BL33 entry of the FIP, io_fip cannot seek */
+	ret = plat_get_image_source(BL33_IMAGE_ID, &dev_handle, &spec);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = io_open(dev_handle, spec, handle);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = io_size(*handle, length);
+	if (ret != 0) {
+		(void)io_close(*handle);
+	}
+
+	return ret;
+}
+
+/*
+ * Average duration of a read of the size, in ns, 0 on error. The runs of
+ * a sequential measure read consecutive areas.
+ */
+static uint64_t bench_measure(enum bench_layer layer, size_t size,
+			      bool random)
+{
+	uintptr_t buf = STORAGE_BENCH_BASE;
+	uint64_t freq = read_cntfrq_el0();
+	unsigned int runs = bench_runs(size);
+	size_t length = STORAGE_BENCH_AREA;
+	uintptr_t handle = 0U;
+	uint64_t ticks = 0U;
+	uint64_t start;
+	unsigned int run;
+	int ret = 0;
+
+	if (layer != BENCH_RAW) {
+		ret = bench_open(layer, &handle, &length);
+		if (ret != 0) {
+			goto out;
+		}
+	}
+
+	if (size > length) {
+		ret = -EFBIG;
+		goto close;
+	}
+
+	runs = MIN(runs, (unsigned int)(length / size));
+	bench_seed = 0x2545F491U;
+
+	start = read_cntpct_el0();
+
+	for (run = 0U; (run < runs) && (ret == 0); run++) {
+		size_t offset = bench_offset(size, run, random);
+
+		if (layer == BENCH_RAW) {
+			ret = bench_raw_read(bench_base + offset, buf, size);
+		} else {
+			ret = bench_io_read(handle, offset, buf, size, random);
+		}
+	}
+
+	ticks = read_cntpct_el0() - start;
+
+close:
+	if (layer != BENCH_RAW) {
+		(void)io_close(handle);
+	}
+
+out:
+	if ((ret != 0) || (runs == 0U)) {
+		NOTICE("STORAGE_BENCH dev=%s layer=%s pattern=%s size=%u ret=%d\n",
+		       bench_device(), bench_layers[layer],
+		       random ? "rand" : "seq", (unsigned int)size, ret);
+		return 0U;
+	}
+
+	ticks = MAX(ticks, (uint64_t)1U);
+
+	NOTICE("STORAGE_BENCH dev=%s layer=%s pattern=%s size=%u runs=%u us=%llu kbps=%llu\n",
+	       bench_device(), bench_layers[layer], random ? "rand" : "seq",
+	       (unsigned int)size, runs,
+	       (ticks * 1000000U) / (freq * runs),
+	       ((uint64_t)size * runs * freq) / (1024U * ticks));
+
+	return (ticks * 1000000000U) / (freq * runs);
+}
+
+/*
+ * A read lasts a command overhead plus its size over the data throughput:
+ * both are derived from the smallest and the largest measured sizes.
+ */
+static void bench_layer(enum bench_layer layer, bool random)
+{
+	uint64_t ns_min = 0U;
+	uint64_t ns_max = 0U;
+	size_t size_min = 0U;
+	size_t size_max = 0U;
+	uint64_t data_ns;
+	uint64_t cmd_ns;
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(bench_sizes); i++) {
+		uint64_t ns = bench_measure(layer, bench_sizes[i], random);
+
+		if (ns == 0U) {
+			continue;
+		}
+
+		if (size_min == 0U) {
+			ns_min = ns;
+			size_min = bench_sizes[i];
+		}
+
+		ns_max = ns;
+		size_max = bench_sizes[i];
+	}
+
+	if ((size_max == size_min) || (ns_max <= ns_min)) {
+		return;
+	}
+
+	data_ns = ns_max - ns_min;
+	cmd_ns = (ns_min * size_max - ns_max * size_min) / (size_max - size_min);
+	if ((ns_min * size_max) < (ns_max * size_min)) {
+		cmd_ns = 0U;
+	}
+
+	NOTICE("STORAGE_BENCH dev=%s layer=%s pattern=%s cmd_us=%llu data_kbps=%llu\n",
+	       bench_device(), bench_layers[layer], random ? "rand" : "seq",
+	       cmd_ns / 1000U,
+	       ((uint64_t)(size_max - size_min) * 1000000000U) /
+	       (1024U * data_ns));
+}
+
+void stm32mp1_storage_bench(void)
+{
+	bench_itf = stm32mp_get_boot_itf_selected();
+	bench_base = image_block_spec.offset;
+
+	if (bench_device() == NULL) {
+		return;
+	}
+
+	bench_layer(BENCH_RAW, false);
+	bench_layer(BENCH_RAW, true);
+	bench_layer(BENCH_IO, false);
+	bench_layer(BENCH_IO, true);
+	bench_layer(BENCH_FIP, false);
+}
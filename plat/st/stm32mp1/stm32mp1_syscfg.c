@@ -167,7 +167,7 @@ static int get_regu_max_voltage(void *fdt, int sdmmc_node, char *regu_name, uint
 		return -ENODEV;
 	}
 
-	node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*cuint));
+	node = dt_node_offset_by_phandle(fdt32_to_cpu(*cuint));
 	if (node < 0) {
 		return -ENODEV;
 	}
@@ -31,6 +31,31 @@ static cert_t stm32mp1_tbb_certs[] = {
 		},
 		.num_ext = 3
 	},
+	/*
+	 * Same certificate, also signing the hashes of all the other FIP
+	 * images, for the STM32MP_FIP_MANIFEST_CERT chain of trust.
+	 */
+	[1] = {
+		.id = STM32MP_FIP_MANIFEST_CERT,
+		.opt = "stm32mp-fip-manifest-cert",
+		.help_msg = "STM32MP Config Certificate with all FIP image hashes (output file)",
+		.fn = NULL,
+		.cn = "STM32MP config FW Certificate",
+		.key = ROT_KEY,
+		.issuer = STM32MP_FIP_MANIFEST_CERT,
+		.ext = {
+			TRUSTED_FW_NVCOUNTER_EXT,
+			HW_CONFIG_HASH_EXT,
+			FW_CONFIG_HASH_EXT,
+			TRUSTED_OS_FW_HASH_EXT,
+			TRUSTED_OS_FW_EXTRA1_HASH_EXT,
+			TRUSTED_OS_FW_EXTRA2_HASH_EXT,
+			TRUSTED_OS_FW_CONFIG_HASH_EXT,
+			NON_TRUSTED_WORLD_BOOTLOADER_HASH_EXT,
+			NON_TRUSTED_FW_CONFIG_HASH_EXT
+		},
+		.num_ext = 9
+	},
 };
 
 PLAT_REGISTER_COT(stm32mp1_tbb_certs);
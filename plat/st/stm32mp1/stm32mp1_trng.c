@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <drivers/st/stm32_rng.h>
+#include <plat/common/plat_trng.h>
+#include <smccc_helpers.h>
+
+DEFINE_SVC_UUID2(_plat_trng_uuid,
+	0x2255f2ee, 0x8eeb, 0x43ee, 0x91, 0x71,
+	0xd7, 0xdf, 0x76, 0x69, 0x69, 0x2d
+);
+uuid_t plat_trng_uuid;
+
+/*
+ * Entropy is taken from the RNG pool, refilled on RNG interrupt: the TRNG
+ * service then reports no entropy instead of waiting for the RNG.
+ */
+bool plat_get_entropy(uint64_t *out)
+{
+	assert(out != NULL);
+
+	return stm32_rng_read_pool((uint8_t *)out, sizeof(*out)) == 0;
+}
+
+void plat_entropy_setup(void)
+{
+	plat_trng_uuid = _plat_trng_uuid;
+}
@@ -37,6 +37,10 @@
 
 #define USB_DFU_CONFIG_DESC_SIZ		USB_DFU_DESC_SIZ(USB_DFU_ITF_NUM)
 
+/* wTransferSize is a 16-bit field, blocks are received on EP0 */
+CASSERT((USBD_DFU_XFER_SIZE >= USB_MAX_EP0_SIZE) &&
+	(USBD_DFU_XFER_SIZE <= 0xFFFFU), assert_usb_dfu_xfer_size);
+
 /* DFU devices */
 static struct usb_dfu_handle usb_dfu_handle;
 
@@ -121,7 +125,7 @@ static const uint8_t usb_stm32mp1_config_desc[USB_DFU_CONFIG_DESC_SIZ] = {
 	DFU_BM_ATTRIBUTE, /* bmAttribute for DFU */
 	0xFF, /* DetachTimeOut = 255 ms */
 	0x00,
-	TRANSFER_SIZE_BYTES(USBD_DFU_XFER_SIZE), /* TransferSize = 1024 Byte */
+	TRANSFER_SIZE_BYTES(USBD_DFU_XFER_SIZE), /* TransferSize */
 	((USB_DFU_VERSION >> 0) & 0xFF), /* bcdDFUVersion */
 	((USB_DFU_VERSION >> 8) & 0xFF)
 };
@@ -24,6 +24,8 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
 #include <tools_share/uuid.h>
 
@@ -215,6 +217,12 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		    RT_INSTR_ENTER_SPD,
+		    PMF_NO_CACHE_MAINT);
+#endif
+
 		cm_el1_sysregs_context_save(NON_SECURE);
 
 		/*
@@ -264,6 +272,12 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X7));
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		    RT_INSTR_ENTER_SP,
+		    PMF_NO_CACHE_MAINT);
+#endif
+
 		SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
 	}
 
@@ -361,6 +375,13 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 * and return to the non-secure state.
 		 */
 		assert(handle == cm_get_context(SECURE));
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		    RT_INSTR_EXIT_SP,
+		    PMF_NO_CACHE_MAINT);
+#endif
+
 		cm_el1_sysregs_context_save(SECURE);
 
 		/* Get a reference to the non-secure context */
@@ -371,6 +392,12 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		    RT_INSTR_EXIT_SPD,
+		    PMF_NO_CACHE_MAINT);
+#endif
+
 		SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
 
 	/*
@@ -6,12 +6,83 @@
 
 #include <assert.h>
 
+#include <drivers/arm/gic_common.h>
 #include <lib/utils.h>
 
 #include "sdei_private.h"
 
 #define MAP_OFF(_map, _mapping) ((_map) - (_mapping)->map)
 
+/*
+ * Direct index from a bound interrupt number to its event mapping, so that
+ * the dispatch does not search the mappings. Each entry holds the offset of
+ * the mapping plus one, or 0 if no mapping is bound to the interrupt.
+ */
+static uint8_t sdei_private_intr_index[TOTAL_PCPU_INTR_NUM];
+static uint8_t sdei_shared_intr_index[TOTAL_SPI_INTR_NUM];
+
+static uint8_t *get_intr_index(unsigned int intr_num, bool shared)
+{
+	if (shared) {
+		if ((intr_num < MIN_SPI_ID) || (intr_num > MAX_SPI_ID)) {
+			return NULL;
+		}
+
+		return &sdei_shared_intr_index[intr_num - MIN_SPI_ID];
+	}
+
+	if (intr_num >= MIN_SPI_ID) {
+		return NULL;
+	}
+
+	return &sdei_private_intr_index[intr_num];
+}
+
+/*
+ * Record the interrupt a mapping is bound to. Like the search it replaces,
+ * the first mapping of an interrupt is the one found.
+ */
+void sdei_index_map(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping = is_event_private(map) ?
+		SDEI_PRIVATE_MAPPING() : SDEI_SHARED_MAPPING();
+	uint8_t *index = get_intr_index(map->intr, is_event_shared(map));
+
+	if ((index != NULL) && (*index == 0U)) {
+		*index = (uint8_t)(MAP_OFF(map, mapping) + 1);
+	}
+}
+
+/* Forget the interrupt a mapping was bound to */
+void sdei_unindex_map(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping = is_event_private(map) ?
+		SDEI_PRIVATE_MAPPING() : SDEI_SHARED_MAPPING();
+	uint8_t *index = get_intr_index(map->intr, is_event_shared(map));
+
+	if ((index != NULL) &&
+	    (*index == (uint8_t)(MAP_OFF(map, mapping) + 1))) {
+		*index = 0U;
+	}
+}
+
+/* Index the interrupts of the platform defined mappings */
+void sdei_init_intr_index(void)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j;
+
+	for_each_mapping_type(i, mapping) {
+		/* Offsets must fit in the index entries */
+		assert(mapping->num_maps < UINT8_MAX);
+
+		iterate_mapping(mapping, j, map) {
+			sdei_index_map(map);
+		}
+	}
+}
+
 /*
  * Get SDEI entry with the given mapping: on success, returns pointer to SDEI
  * entry. On error, returns NULL.
@@ -59,14 +130,25 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
+	const uint8_t *index;
 	unsigned int i;
 
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+
+	/* Bound interrupts are found directly */
+	index = get_intr_index(intr_num, shared);
+	if (index != NULL) {
+		if (*index == 0U) {
+			return NULL;
+		}
+
+		return &mapping->map[*index - 1U];
+	}
+
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Look for a match in private and shared mappings, as requested, e.g.
+	 * for a free dynamic mapping. This is a linear search.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
 	iterate_mapping(mapping, i, map) {
 		if (map->intr == intr_num)
 			return map;
@@ -229,6 +229,7 @@ static void sdei_class_init(sdei_class_t class)
 void sdei_init(void)
 {
 	plat_sdei_setup();
+	sdei_init_intr_index();
 	sdei_class_init(SDEI_CRITICAL);
 	sdei_class_init(SDEI_NORMAL);
 
@@ -766,6 +767,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			sdei_index_map(map);
 			retry = false;
 		}
 		sdei_map_unlock(map);
@@ -823,6 +825,7 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		sdei_unindex_map(map);
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
 	} else {
@@ -17,6 +17,11 @@ SPMD_SOURCES	+=	$(addprefix services/std_svc/spmd/,	\
 			spmd_pm.c				\
 			spmd_main.c)
 
+# Flag to measure the round trip of the direct requests forwarded to the SPMC
+SPMD_DIRECT_MSG_STATS	?=	0
+$(eval $(call assert_boolean,SPMD_DIRECT_MSG_STATS))
+$(eval $(call add_define,SPMD_DIRECT_MSG_STATS))
+
 # Let the top-level Makefile know that we intend to include a BL32 image
 NEED_BL32		:=	yes
 
@@ -401,6 +401,87 @@ int spmd_setup(void)
 	return rc;
 }
 
+#if SPMD_DIRECT_MSG_STATS
+static int spmd_direct_msg_idx(uint32_t smc_fid)
+{
+	switch (smc_fid) {
+	case FFA_MSG_SEND_DIRECT_REQ_SMC32:
+	case FFA_MSG_SEND_DIRECT_RESP_SMC32:
+		return (int)SPMD_DIRECT_MSG_SMC32;
+	case FFA_MSG_SEND_DIRECT_REQ_SMC64:
+	case FFA_MSG_SEND_DIRECT_RESP_SMC64:
+		return (int)SPMD_DIRECT_MSG_SMC64;
+	default:
+		return -1;
+	}
+}
+
+/*******************************************************************************
+ * Account the time from a normal world direct request being forwarded to the
+ * SPMC, to the direct response coming back on this CPU.
+ ******************************************************************************/
+static void spmd_direct_msg_account(uint32_t smc_fid, bool secure_origin)
+{
+	spmd_spm_core_context_t *ctx = spmd_get_context();
+	spmd_direct_msg_stats_t *stats;
+	uint64_t delta;
+	int idx = spmd_direct_msg_idx(smc_fid);
+
+	if (idx < 0) {
+		return;
+	}
+
+	if (!secure_origin) {
+		if ((smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC32) ||
+		    (smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC64)) {
+			ctx->direct_req_idx = (unsigned int)idx;
+			ctx->direct_req_ts = read_cntpct_el0();
+		}
+
+		return;
+	}
+
+	if ((smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC32) ||
+	    (smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC64) ||
+	    (ctx->direct_req_ts == 0ULL)) {
+		return;
+	}
+
+	delta = read_cntpct_el0() - ctx->direct_req_ts;
+	ctx->direct_req_ts = 0ULL;
+
+	stats = &ctx->direct_msg_stats[ctx->direct_req_idx];
+	stats->count++;
+	stats->total += delta;
+	if (delta > stats->max) {
+		stats->max = delta;
+	}
+}
+
+/*******************************************************************************
+ * Get the direct request round trip statistics of a CPU, for the SMC32 or
+ * SMC64 direct request function ID.
+ ******************************************************************************/
+int spmd_get_direct_msg_stats(uint64_t mpidr, uint32_t smc_fid,
+			      uint64_t *count, uint64_t *total_ticks,
+			      uint64_t *max_ticks)
+{
+	const spmd_direct_msg_stats_t *stats;
+	int idx = spmd_direct_msg_idx(smc_fid);
+
+	if ((idx < 0) || (plat_core_pos_by_mpidr(mpidr) < 0)) {
+		return -EINVAL;
+	}
+
+	stats = &spmd_get_context_by_mpidr(mpidr)->direct_msg_stats[idx];
+	*count = stats->count;
+	*total_ticks = stats->total;
+	*max_ticks = stats->max;
+
+	return 0;
+}
+#endif /* SPMD_DIRECT_MSG_STATS */
+
 /*******************************************************************************
  * Forward SMC to the other security state
  ******************************************************************************/
@@ -415,6 +496,10 @@ static uint64_t spmd_smc_forward(uint32_t smc_fid,
 	unsigned int secure_state_in = (secure_origin) ? SECURE : NON_SECURE;
 	unsigned int secure_state_out = (!secure_origin) ? SECURE : NON_SECURE;
 
+#if SPMD_DIRECT_MSG_STATS
+	spmd_direct_msg_account(smc_fid, secure_origin);
+#endif
+
 	/* Save incoming security state */
 #if SPMD_SPM_AT_SEL2
 	if (secure_state_in == NON_SECURE) {
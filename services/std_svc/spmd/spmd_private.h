@@ -42,6 +42,19 @@ typedef enum spmc_state {
 	SPMC_STATE_ON
 } spmc_state_t;
 
+#if SPMD_DIRECT_MSG_STATS
+/* Direct request round trips, in system counter ticks */
+typedef struct spmd_direct_msg_stats {
+	uint64_t count;
+	uint64_t total;
+	uint64_t max;
+} spmd_direct_msg_stats_t;
+
+#define SPMD_DIRECT_MSG_SMC32			U(0)
+#define SPMD_DIRECT_MSG_SMC64			U(1)
+#define SPMD_DIRECT_MSG_NUM			U(2)
+#endif
+
 /*
  * Data structure used by the SPM dispatcher (SPMD) in EL3 to track context of
  * the SPM core (SPMC) at the next lower EL.
@@ -51,6 +64,12 @@ typedef struct spmd_spm_core_context {
 	cpu_context_t cpu_ctx;
 	spmc_state_t state;
 	bool secure_interrupt_ongoing;
+#if SPMD_DIRECT_MSG_STATS
+	/* Counter value when the pending direct request was forwarded */
+	uint64_t direct_req_ts;
+	unsigned int direct_req_idx;
+	spmd_direct_msg_stats_t direct_msg_stats[SPMD_DIRECT_MSG_NUM];
+#endif
 } spmd_spm_core_context_t;
 
 /*
@@ -76,14 +76,14 @@ static int32_t std_svc_setup(void)
  * Top-level Standard Service SMC handler. This handler will in turn dispatch
  * calls to PSCI SMC handler
  */
-static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
-			     u_register_t x1,
-			     u_register_t x2,
-			     u_register_t x3,
-			     u_register_t x4,
-			     void *cookie,
-			     void *handle,
-			     u_register_t flags)
+static uintptr_t __hot std_svc_smc_handler(uint32_t smc_fid,
+					   u_register_t x1,
+					   u_register_t x2,
+					   u_register_t x3,
+					   u_register_t x4,
+					   void *cookie,
+					   void *handle,
+					   u_register_t flags)
 {
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 		/* 32-bit SMC function, clear top parameter bits */
@@ -104,12 +104,13 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
 		/*
-		 * Flush cache line so that even if CPU power down happens
-		 * the timestamp update is reflected in memory.
+		 * The cache line is flushed at the end of the PSCI call, or
+		 * before the CPU powers down, so that the timestamp update is
+		 * reflected in memory.
 		 */
 		PMF_WRITE_TIMESTAMP(rt_instr_svc,
 		    RT_INSTR_ENTER_PSCI,
-		    PMF_CACHE_MAINT,
+		    PMF_CACHE_MAINT_DEFER,
 		    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
 #endif
 
@@ -120,6 +121,7 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
 		    RT_INSTR_EXIT_PSCI,
 		    PMF_NO_CACHE_MAINT);
+		pmf_flush_deferred_timestamps();
 #endif
 
 		SMC_RET1(handle, ret);
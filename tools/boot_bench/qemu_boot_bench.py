@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""
+Measure the BL2 image loading of a synthetic FIP on QEMU virt, in a
+deterministic way.
+
+TF-A is built for PLAT=qemu with BL2_LOAD_INSTRUMENTATION=1, with a BL33 and
+optionally a BL32 made of pseudo-random data of the given sizes. QEMU runs
+the flash image with -icount, so that the generic timer follows the executed
+instructions and not the host time: the same tree and configuration always
+give the same timestamps. The BL2_LOAD_INSTR lines printed by BL2 are
+collected until BL1 boots BL31, and written as a JSON report, with the open,
+read and authentication durations of each image in generic timer ticks and
+in microseconds of the emulated time.
+
+Example:
+    qemu_boot_bench.py --bl33-size 1M --bl32-size 256K --tbb \\
+        --mbedtls-dir ../mbedtls -o report.json
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# See include/export/common/tbbr/tbbr_img_def_exp.h
+IMAGE_NAMES = {
+    1: 'bl2', 3: 'bl31', 4: 'bl32', 5: 'bl33',
+    6: 'trusted_boot_fw_cert', 7: 'trusted_key_cert',
+    9: 'soc_fw_key_cert', 10: 'trusted_os_fw_key_cert',
+    11: 'non_trusted_fw_key_cert', 13: 'soc_fw_content_cert',
+    14: 'trusted_os_fw_content_cert', 15: 'non_trusted_fw_content_cert',
+    21: 'bl32_extra1', 22: 'bl32_extra2', 23: 'hw_config',
+    24: 'tb_fw_config', 25: 'soc_fw_config', 26: 'tos_fw_config',
+    27: 'nt_fw_config', 31: 'fw_config',
+}
+
+# See plat/qemu/qemu/include/platform_def.h
+FIP_OFFSET = 0x40000
+FIP_MAX_SIZE = 0x400000
+
+LOAD_INSTR_RE = re.compile(r'BL2_LOAD_INSTR id=(\d+) start=(\d+) '
+                           r'open=(\d+) read=(\d+) auth=(\d+)')
+FREQ_RE = re.compile(r'BL2_LOAD_INSTR freq=(\d+)')
+END_MARKER = 'Booting BL31'
+
+
+def size_arg(text):
+    """Size in bytes, with an optional K or M suffix"""
+    units = {'K': 1024, 'M': 1024 * 1024}
+    if text[-1:].upper() in units:
+        return int(text[:-1], 0) * units[text[-1:].upper()]
+
+    return int(text, 0)
+
+
+def write_payload(path, size, seed):
+    rng = random.Random(seed)
+    with open(path, 'wb') as f:
+        f.write(bytes(rng.getrandbits(8) for _ in range(size)))
+
+
+def build(args, work):
+    bl33 = os.path.join(work, 'bench_bl33.bin')
+    write_payload(bl33, args.bl33_size, 33)
+
+    cmd = ['make', '-C', args.tf_a_dir, '-j{}'.format(args.jobs),
+           'PLAT=qemu', 'BL2_LOAD_INSTRUMENTATION=1',
+           'BUILD_BASE={}'.format(os.path.join(work, 'build')),
+           'BL33={}'.format(bl33)]
+
+    if args.bl32_size != 0:
+        bl32 = os.path.join(work, 'bench_bl32.bin')
+        write_payload(bl32, args.bl32_size, 32)
+        cmd += ['NEED_BL32=yes', 'BL32={}'.format(bl32)]
+
+    if args.tbb:
+        cmd += ['TRUSTED_BOARD_BOOT=1', 'GENERATE_COT=1',
+                'MBEDTLS_DIR={}'.format(os.path.abspath(args.mbedtls_dir))]
+
+    if args.cross_compile:
+        cmd.append('CROSS_COMPILE={}'.format(args.cross_compile))
+
+    cmd += args.make_args + ['all', 'fip']
+
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+    out = os.path.join(work, 'build', 'qemu', 'release')
+    with open(os.path.join(out, 'fip.bin'), 'rb') as f:
+        fip = f.read()
+    if len(fip) > FIP_MAX_SIZE:
+        sys.exit('FIP of {} bytes larger than the {} bytes of flash'.format(
+            len(fip), FIP_MAX_SIZE))
+
+    flash = os.path.join(work, 'flash.bin')
+    with open(os.path.join(out, 'bl1.bin'), 'rb') as f:
+        bl1 = f.read()
+    with open(flash, 'wb') as f:
+        f.write(bl1.ljust(FIP_OFFSET, b'\0'))
+        f.write(fip)
+
+    return flash, len(fip)
+
+
+def run(args, flash, work):
+    """Boot up to BL31, return the timer frequency and the image records"""
+    cmd = [args.qemu, '-nographic', '-machine', 'virt,secure=on',
+           '-cpu', 'cortex-a57', '-smp', '1', '-m', '1024',
+           '-icount', 'shift={},sleep=off'.format(args.icount_shift),
+           '-bios', flash, '-d', 'unimp', '-monitor', 'none',
+           '-serial', 'stdio']
+
+    # No file in the working directory, for the FIP to be the only source
+    proc = subprocess.Popen(cmd, cwd=work, stdout=subprocess.PIPE,
+                            stderr=subprocess.DEVNULL, universal_newlines=True,
+                            errors='replace')
+    freq = None
+    images = []
+
+    try:
+        for line in proc.stdout:
+            if args.verbose:
+                sys.stderr.write(line)
+
+            m = FREQ_RE.search(line)
+            if m:
+                freq = int(m.group(1))
+                continue
+
+            m = LOAD_INSTR_RE.search(line)
+            if m:
+                image_id, start, t_open, t_read, t_auth = \
+                    (int(v) for v in m.groups())
+                images.append({
+                    'id': image_id,
+                    'name': IMAGE_NAMES.get(image_id,
+                                            'image{}'.format(image_id)),
+                    'start': start, 'open': t_open, 'read': t_read,
+                    'auth': t_auth,
+                })
+                continue
+
+            if END_MARKER in line:
+                break
+    finally:
+        proc.kill()
+        proc.wait()
+
+    if freq is None or not images:
+        sys.exit('No BL2_LOAD_INSTR output, see --verbose')
+
+    return freq, images
+
+
+def to_us(ticks, freq):
+    return round(ticks * 1000000 / freq, 3)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Deterministic BL2 image loading benchmark on QEMU')
+    parser.add_argument('--tf-a-dir', default='.',
+                        help='TF-A source tree (default: .)')
+    parser.add_argument('--qemu', default='qemu-system-aarch64',
+                        help='QEMU binary (default: %(default)s)')
+    parser.add_argument('--cross-compile', default=None,
+                        help='CROSS_COMPILE prefix of the build')
+    parser.add_argument('--bl33-size', type=size_arg, default='1M',
+                        help='synthetic BL33 size (default: 1M)')
+    parser.add_argument('--bl32-size', type=size_arg, default='0',
+                        help='synthetic BL32 size, 0 for no BL32 '
+                             '(default: 0)')
+    parser.add_argument('--tbb', action='store_true',
+                        help='build with TRUSTED_BOARD_BOOT=1 and '
+                             'GENERATE_COT=1')
+    parser.add_argument('--mbedtls-dir', default=None,
+                        help='mbedTLS source tree, for --tbb')
+    parser.add_argument('--icount-shift', type=int, default=0,
+                        help='QEMU -icount shift (default: 0)')
+    parser.add_argument('--runs', type=int, default=1,
+                        help='boots to run, all must give the same '
+                             'timestamps (default: 1)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count())
+    parser.add_argument('-o', '--output', default='-',
+                        help='JSON report file, - for stdout')
+    parser.add_argument('-v', '--verbose', action='store_true',
+                        help='copy the console output to stderr')
+    parser.add_argument('make_args', nargs='*',
+                        help='additional make variables, NAME=VALUE')
+    args = parser.parse_args()
+
+    if args.tbb and args.mbedtls_dir is None:
+        parser.error('--tbb requires --mbedtls-dir')
+
+    work = tempfile.mkdtemp(prefix='qemu_boot_bench_')
+    try:
+        flash, fip_size = build(args, work)
+
+        freq, images = run(args, flash, work)
+        for n in range(1, args.runs):
+            if run(args, flash, work) != (freq, images):
+                sys.exit('Run {} differs from run 0, the boot is not '
+                         'deterministic'.format(n))
+    finally:
+        shutil.rmtree(work)
+
+    for image in images:
+        for key in ('open', 'read', 'auth'):
+            image[key + '_us'] = to_us(image[key], freq)
+
+    total = sum(i['open'] + i['read'] + i['auth'] for i in images)
+    report = {
+        'config': {
+            'bl33_size': args.bl33_size,
+            'bl32_size': args.bl32_size,
+            'tbb': args.tbb,
+            'fip_size': fip_size,
+            'icount_shift': args.icount_shift,
+            'runs': args.runs,
+            'make_args': args.make_args,
+        },
+        'freq': freq,
+        'images': images,
+        'total': total,
+        'total_us': to_us(total, freq),
+    }
+
+    if args.output == '-':
+        json.dump(report, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
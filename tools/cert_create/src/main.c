@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -57,6 +59,8 @@
 #define ID_TO_BIT_MASK(id)		(1 << id)
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define BATCH_LINE_MAX_LEN		8192
+#define BATCH_ARGS_MAX_NUM		(CMD_OPT_MAX_NUM * 2)
 
 /* Global options */
 static int key_alg;
@@ -65,6 +69,24 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static const char *batch_fn;
+static long nr_jobs = 1;
+static const EVP_MD *md_info;
+static unsigned int md_len;
+
+/*
+ * Certificates created so far in batch mode, indexed by a digest of their
+ * extensions. A certificate whose extensions match one of these is not
+ * signed again.
+ */
+typedef struct cert_cache_s {
+	int cert;
+	unsigned char md[SHA256_DIGEST_LENGTH];
+	X509 *x;
+	struct cert_cache_s *next;
+} cert_cache_t;
+
+static cert_cache_t *cert_cache;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -289,25 +311,392 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "batch", required_argument, NULL, 'B' },
+		"Create the certificate sets listed in the given manifest, one per line"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of batch manifest lines processed in parallel (default: 1)"
 	}
 };
 
-int main(int argc, char *argv[])
+static void cert_cache_digest(int cert_idx, STACK_OF(X509_EXTENSION) * sk,
+			      unsigned char *md)
+{
+	SHA256_CTX ctx;
+	unsigned char *der;
+	int i, len;
+
+	SHA256_Init(&ctx);
+	SHA256_Update(&ctx, &cert_idx, sizeof(cert_idx));
+	for (i = 0; i < sk_X509_EXTENSION_num(sk); i++) {
+		der = NULL;
+		len = i2d_X509_EXTENSION(sk_X509_EXTENSION_value(sk, i), &der);
+		if (len < 0) {
+			ERROR("Cannot encode extension\n");
+			exit(1);
+		}
+		SHA256_Update(&ctx, der, len);
+		OPENSSL_free(der);
+	}
+	SHA256_Final(md, &ctx);
+}
+
+static X509 *cert_cache_lookup(int cert_idx, const unsigned char *md)
+{
+	cert_cache_t *entry;
+
+	for (entry = cert_cache; entry != NULL; entry = entry->next) {
+		if (entry->cert == cert_idx &&
+		    memcmp(entry->md, md, sizeof(entry->md)) == 0) {
+			return entry->x;
+		}
+	}
+
+	return NULL;
+}
+
+static void cert_cache_add(int cert_idx, const unsigned char *md, X509 *x)
+{
+	cert_cache_t *entry;
+
+	CHECK_NULL(entry, malloc(sizeof(*entry)));
+	entry->cert = cert_idx;
+	memcpy(entry->md, md, sizeof(entry->md));
+	entry->x = x;
+	entry->next = cert_cache;
+	cert_cache = entry;
+}
+
+static void cert_cache_free(void)
+{
+	cert_cache_t *entry;
+
+	while (cert_cache != NULL) {
+		entry = cert_cache;
+		cert_cache = entry->next;
+		X509_free(entry->x);
+		free(entry);
+	}
+}
+
+static void create_certs(void)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
 	ext_t *ext;
-	key_t *key;
 	cert_t *cert;
-	FILE *file;
 	int i, j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	unsigned char cache_md[SHA256_DIGEST_LENGTH];
+
+	for (i = 0 ; i < num_certs ; i++) {
+
+		cert = &certs[i];
+		cert->x = NULL;
+
+		if (cert->fn == NULL) {
+			/* Certificate not requested. Skip to the next one */
+			continue;
+		}
+
+		/* Create a new stack of extensions. This stack will be used
+		 * to create the certificate */
+		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+		for (j = 0 ; j < cert->num_ext ; j++) {
+
+			ext = &extensions[cert->ext[j]];
+
+			/* Get OpenSSL internal ID for this extension */
+			CHECK_OID(ext_nid, ext->oid);
+
+			/*
+			 * Three types of extensions are currently supported:
+			 *     - EXT_TYPE_NVCOUNTER
+			 *     - EXT_TYPE_HASH
+			 *     - EXT_TYPE_PKEY
+			 */
+			switch (ext->type) {
+			case EXT_TYPE_NVCOUNTER:
+				if (ext->optional && ext->arg == NULL) {
+					/* Skip this NVCounter */
+					continue;
+				} else {
+					/* Checked by `check_cmd_params` */
+					assert(ext->arg != NULL);
+					nvctr = atoi(ext->arg);
+					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+						EXT_CRIT, nvctr));
+				}
+				break;
+			case EXT_TYPE_HASH:
+				if (ext->arg == NULL) {
+					if (ext->optional) {
+						/* Include a hash filled with zeros */
+						memset(md, 0x0, SHA512_DIGEST_LENGTH);
+					} else {
+						/* Do not include this hash in the certificate */
+						continue;
+					}
+				} else {
+					/* Calculate the hash of the file */
+					if (!sha_file(hash_alg, ext->arg, md)) {
+						ERROR("Cannot calculate hash of %s\n",
+							ext->arg);
+						exit(1);
+					}
+				}
+				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+						EXT_CRIT, md_info, md,
+						md_len));
+				break;
+			case EXT_TYPE_PKEY:
+				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+					EXT_CRIT, keys[ext->attr.key].key));
+				break;
+			default:
+				ERROR("Unknown extension type '%d' in %s\n",
+						ext->type, cert->cn);
+				exit(1);
+			}
+
+			/* Push the extension into the stack */
+			sk_X509_EXTENSION_push(sk, cert_ext);
+		}
+
+		/*
+		 * Reuse an identical certificate created earlier in the
+		 * batch. The keys are the same for all the certificate sets,
+		 * so only the extensions tell certificates apart.
+		 */
+		cert_cache_digest(i, sk, cache_md);
+		cert->x = cert_cache_lookup(i, cache_md);
+		if (cert->x != NULL) {
+			VERBOSE("Reusing %s\n", cert->cn);
+		} else {
+			/* Create certificate. Signed with corresponding key */
+			if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
+				ERROR("Cannot create %s\n", cert->cn);
+				exit(1);
+			}
+			cert_cache_add(i, cache_md, cert->x);
+		}
+
+		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
+				cert_ext = sk_X509_EXTENSION_pop(sk)) {
+			X509_EXTENSION_free(cert_ext);
+		}
+
+		sk_X509_EXTENSION_free(sk);
+	}
+}
+
+static void save_certs(void)
+{
+	FILE *file;
+	int i;
+
+	/* Print the certificates */
+	if (print_cert) {
+		for (i = 0 ; i < num_certs ; i++) {
+			if (!certs[i].x) {
+				continue;
+			}
+			printf("\n\n=====================================\n\n");
+			X509_print_fp(stdout, certs[i].x);
+		}
+	}
+
+	/* Save created certificates to files */
+	for (i = 0 ; i < num_certs ; i++) {
+		if (certs[i].x && certs[i].fn) {
+			file = fopen(certs[i].fn, "w");
+			if (file != NULL) {
+				i2d_X509_fp(file, certs[i].x);
+				fclose(file);
+			} else {
+				ERROR("Cannot create file %s\n", certs[i].fn);
+			}
+		}
+	}
+}
+
+/*
+ * Create the certificate set described by one line of the batch manifest.
+ * The line holds image, counter and certificate options, which are added
+ * to the ones given on the command line. Keys are shared by all the sets.
+ */
+static void process_batch_line(const char *cmd, char *line, int line_nb)
+{
+	const struct option *cmd_opt = cmd_opt_get_array();
+	char *args[BATCH_ARGS_MAX_NUM + 1];
+	const char **ext_args, **cert_fns;
+	const char *cur_opt;
+	ext_t *ext;
+	cert_t *cert;
+	int argc = 0, c, i, opt_idx = 0;
+
+	args[argc++] = (char *)cmd;
+	for (args[argc] = strtok(line, " \t\r\n"); args[argc] != NULL;
+	     args[argc] = strtok(NULL, " \t\r\n")) {
+		if (++argc == BATCH_ARGS_MAX_NUM) {
+			ERROR("%s:%d: Too many options\n", batch_fn, line_nb);
+			exit(1);
+		}
+	}
+
+	/* Save the command line options to restore them afterwards */
+	CHECK_NULL(ext_args, malloc(num_extensions * sizeof(*ext_args)));
+	CHECK_NULL(cert_fns, malloc(num_certs * sizeof(*cert_fns)));
+	for (i = 0; i < num_extensions; i++) {
+		ext_args[i] = extensions[i].arg;
+	}
+	for (i = 0; i < num_certs; i++) {
+		cert_fns[i] = certs[i].fn;
+	}
+
+	/* Restart the option scanning from the beginning of the line */
+	optind = 0;
+	while (1) {
+		c = getopt_long(argc, args, "", cmd_opt, &opt_idx);
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case CMD_OPT_EXT:
+			cur_opt = cmd_opt_get_name(opt_idx);
+			ext = ext_get_by_opt(cur_opt);
+			ext->arg = optarg;
+			break;
+		case CMD_OPT_CERT:
+			cur_opt = cmd_opt_get_name(opt_idx);
+			cert = cert_get_by_opt(cur_opt);
+			cert->fn = optarg;
+			break;
+		default:
+			ERROR("%s:%d: Only image, counter and certificate "
+			      "options are allowed\n", batch_fn, line_nb);
+			exit(1);
+		}
+	}
+	if (optind != argc) {
+		ERROR("%s:%d: Unexpected argument '%s'\n", batch_fn, line_nb,
+		      args[optind]);
+		exit(1);
+	}
+
+	check_cmd_params();
+	create_certs();
+	save_certs();
+
+	for (i = 0; i < num_extensions; i++) {
+		extensions[i].arg = ext_args[i];
+	}
+	for (i = 0; i < num_certs; i++) {
+		certs[i].fn = cert_fns[i];
+	}
+	free(ext_args);
+	free(cert_fns);
+}
+
+/*
+ * Process the lines of the batch manifest with the given worker, which
+ * handles every nr_jobs-th line starting from its own index. Each worker
+ * opens the manifest as forked processes would share the file offset.
+ */
+static void process_batch(const char *cmd, int worker)
+{
+	char line[BATCH_LINE_MAX_LEN];
+	FILE *file;
+	char *p;
+	int line_nb = 0, entry = 0;
+
+	file = fopen(batch_fn, "r");
+	if (file == NULL) {
+		ERROR("Cannot open %s\n", batch_fn);
+		exit(1);
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		line_nb++;
+		if (strchr(line, '\n') == NULL && !feof(file)) {
+			ERROR("%s:%d: Line too long\n", batch_fn, line_nb);
+			exit(1);
+		}
+
+		/* Skip comments and empty lines */
+		for (p = line; isspace((unsigned char)*p); p++) {
+		}
+		if (*p == '#' || *p == '\0') {
+			continue;
+		}
+
+		if ((entry++ % nr_jobs) == worker) {
+			process_batch_line(cmd, line, line_nb);
+		}
+	}
+
+	fclose(file);
+}
+
+static void run_batch(const char *cmd)
+{
+	pid_t pid;
+	int i, status, rc = 0;
+
+	if (nr_jobs == 1) {
+		process_batch(cmd, 0);
+		return;
+	}
+
+	/*
+	 * The chain of trust lives in global tables, so the certificate sets
+	 * are spread over worker processes rather than threads. The keys are
+	 * loaded once before forking and inherited by all the workers.
+	 */
+	fflush(stdout);
+	fflush(stderr);
+	for (i = 0; i < nr_jobs; i++) {
+		pid = fork();
+		if (pid == -1) {
+			ERROR("Cannot create batch worker\n");
+			exit(1);
+		}
+		if (pid == 0) {
+			process_batch(cmd, i);
+			fflush(stdout);
+			_exit(0);
+		}
+	}
+
+	for (i = 0; i < nr_jobs; i++) {
+		if (wait(&status) == -1 || !WIFEXITED(status) ||
+		    WEXITSTATUS(status) != 0) {
+			rc = 1;
+		}
+	}
+
+	if (rc != 0) {
+		ERROR("Batch %s failed\n", batch_fn);
+		exit(1);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	ext_t *ext;
+	key_t *key;
+	cert_t *cert;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
+	char *end;
 	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -345,7 +734,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:B:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -367,9 +756,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'B':
+			batch_fn = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			nr_jobs = strtol(optarg, &end, 10);
+			if (*end != '\0' || nr_jobs <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -470,118 +869,13 @@ int main(int argc, char *argv[])
 	}
 
 	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
-			continue;
-		}
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
-				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
-		}
-
-		sk_X509_EXTENSION_free(sk);
-	}
-
-
-	/* Print the certificates */
-	if (print_cert) {
-		for (i = 0 ; i < num_certs ; i++) {
-			if (!certs[i].x) {
-				continue;
-			}
-			printf("\n\n=====================================\n\n");
-			X509_print_fp(stdout, certs[i].x);
-		}
-	}
-
-	/* Save created certificates to files */
-	for (i = 0 ; i < num_certs ; i++) {
-		if (certs[i].x && certs[i].fn) {
-			file = fopen(certs[i].fn, "w");
-			if (file != NULL) {
-				i2d_X509_fp(file, certs[i].x);
-				fclose(file);
-			} else {
-				ERROR("Cannot create file %s\n", certs[i].fn);
-			}
-		}
+	if (batch_fn != NULL) {
+		run_batch(argv[0]);
+	} else {
+		create_certs();
+		save_certs();
 	}
+	cert_cache_free();
 
 	/* Save keys */
 	if (save_keys) {
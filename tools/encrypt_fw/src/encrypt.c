@@ -12,7 +12,11 @@
 #include "debug.h"
 #include "encrypt.h"
 
-#define BUFFER_SIZE		256
+/*
+ * The image is encrypted as a single GCM stream, one buffer at a time, so
+ * that host memory use does not depend on the image size.
+ */
+#define BUFFER_SIZE		0x10000
 #define IV_SIZE			12
 #define IV_STRING_SIZE		24
 #define TAG_SIZE		16
@@ -26,7 +30,7 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 	FILE *ip_file;
 	FILE *op_file;
 	EVP_CIPHER_CTX *ctx;
-	unsigned char data[BUFFER_SIZE], enc_data[BUFFER_SIZE];
+	static unsigned char data[BUFFER_SIZE], enc_data[BUFFER_SIZE];
 	unsigned char key[KEY_SIZE], iv[IV_SIZE], tag[TAG_SIZE];
 	int bytes, enc_len = 0, i, j, ret = 0;
 	struct fw_enc_hdr header;
@@ -104,7 +108,17 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 			goto out;
 		}
 
-		fwrite(enc_data, 1, enc_len, op_file);
+		if (fwrite(enc_data, 1, enc_len, op_file) != enc_len) {
+			ERROR("Cannot write %s\n", op_name);
+			ret = -1;
+			goto out;
+		}
+	}
+
+	if (ferror(ip_file)) {
+		ERROR("Cannot read %s\n", ip_name);
+		ret = -1;
+		goto out;
 	}
 
 	ret = EVP_EncryptFinal_ex(ctx, enc_data, &enc_len);
@@ -135,7 +149,12 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		goto out;
 	}
 
-	fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file);
+	if (fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file) !=
+	    sizeof(struct fw_enc_hdr)) {
+		ERROR("Cannot write %s\n", op_name);
+		ret = -1;
+		goto out;
+	}
 
 out:
 	EVP_CIPHER_CTX_free(ctx);
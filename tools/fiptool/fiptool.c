@@ -22,6 +22,8 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IMAGE_ALIGN 3
+#define OPT_LOAD_ORDER 4
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(int);
@@ -53,6 +55,7 @@ static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+static long nr_jobs;
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -134,6 +137,127 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+/*
+ * Load the content of an open file. Regular files are mapped read-only so
+ * that large payloads are not copied through stdio, anything else is read
+ * into a heap buffer.
+ */
+static void *load_file(FILE *fp, size_t size, const char *filename,
+    int *mapped)
+{
+	void *buf;
+
+#ifndef _MSC_VER
+	if (size > 0) {
+		buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (buf != MAP_FAILED) {
+			posix_madvise(buf, size, POSIX_MADV_WILLNEED);
+			*mapped = 1;
+			return buf;
+		}
+	}
+#endif
+	*mapped = 0;
+	buf = xmalloc(size, "failed to load file into memory");
+	if (fread(buf, 1, size, fp) != size)
+		log_errx("Failed to read %s", filename);
+	return buf;
+}
+
+static void unload_file(void *buf, size_t size, int mapped)
+{
+#ifndef _MSC_VER
+	if (mapped) {
+		munmap(buf, size);
+		return;
+	}
+#endif
+	free(buf);
+}
+
+typedef void (*job_fn_t)(void *arg);
+
+#ifndef _MSC_VER
+typedef struct job_queue {
+	job_fn_t         fn;
+	char            *args;
+	size_t           nr_args;
+	size_t           arg_size;
+	size_t           next;
+	pthread_mutex_t  lock;
+} job_queue_t;
+
+static void *job_worker(void *arg)
+{
+	job_queue_t *q = arg;
+	size_t i;
+
+	while (1) {
+		pthread_mutex_lock(&q->lock);
+		i = q->next++;
+		pthread_mutex_unlock(&q->lock);
+		if (i >= q->nr_args)
+			break;
+		q->fn(q->args + i * q->arg_size);
+	}
+	return NULL;
+}
+
+static size_t get_nr_threads(void)
+{
+	long n = nr_jobs;
+
+	if (n <= 0)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? n : 1;
+}
+#endif
+
+/*
+ * Call fn on each of the nr_args elements of the args array, spreading
+ * the calls over a pool of worker threads. The calls must be independent
+ * of each other as they complete in no particular order.
+ */
+static void run_jobs(job_fn_t fn, void *args, size_t nr_args,
+    size_t arg_size)
+{
+	size_t i;
+#ifndef _MSC_VER
+	job_queue_t q;
+	pthread_t *threads;
+	size_t nr_threads;
+
+	nr_threads = get_nr_threads();
+	if (nr_threads > nr_args)
+		nr_threads = nr_args;
+
+	if (nr_threads > 1) {
+		q.fn = fn;
+		q.args = args;
+		q.nr_args = nr_args;
+		q.arg_size = arg_size;
+		q.next = 0;
+		if (pthread_mutex_init(&q.lock, NULL) != 0)
+			log_errx("Failed to initialize job queue");
+
+		threads = xmalloc(nr_threads * sizeof(*threads),
+		    "failed to allocate worker threads");
+		for (i = 0; i < nr_threads; i++)
+			if (pthread_create(&threads[i], NULL, job_worker,
+			    &q) != 0)
+				log_errx("Failed to create worker thread");
+		for (i = 0; i < nr_threads; i++)
+			pthread_join(threads[i], NULL);
+
+		free(threads);
+		pthread_mutex_destroy(&q.lock);
+		return;
+	}
+#endif
+	for (i = 0; i < nr_args; i++)
+		fn((char *)args + i * arg_size);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -164,15 +288,19 @@ static void set_image_desc_action(image_desc_t *desc, int action,
 		    "failed to allocate memory for argument");
 }
 
+static void free_image(image_t *image)
+{
+	unload_file(image->buffer, image->toc_e.size, image->mapped);
+	free(image);
+}
+
 static void free_image_desc(image_desc_t *desc)
 {
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -298,6 +426,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
+	int mapped;
 
 	fp = fopen(filename, "rb");
 	if (fp == NULL)
@@ -306,9 +435,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (fstat(fileno(fp), &st) == -1)
 		log_err("fstat %s", filename);
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	buf = load_file(fp, st.st_size, filename, &mapped);
 	bufend = buf + st.st_size;
 	fclose(fp);
 
@@ -378,7 +505,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+	unload_file(buf, st.st_size, mapped);
 	return 0;
 }
 
@@ -400,9 +527,7 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	image->buffer = load_file(fp, st.st_size, filename, &image->mapped);
 	image->toc_e.size = st.st_size;
 
 	fclose(fp);
@@ -454,10 +579,28 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	const image_t *image;
+	unsigned char  md[SHA256_DIGEST_LENGTH];
+} hash_job_t;
+
+static void hash_image_job(void *arg)
+{
+	hash_job_t *job = arg;
+
+	SHA256(job->image->buffer, job->image->toc_e.size, job->md);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	hash_job_t *jobs = NULL, *job;
+	size_t nr_images = 0;
+#endif
 
 	if (argc != 2)
 		info_usage(EXIT_FAILURE);
@@ -474,6 +617,19 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	/* Hash all images up front, they are independent of each other. */
+	if (verbose) {
+		jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+		    "failed to allocate hash jobs");
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				jobs[nr_images++].image = desc->image;
+		run_jobs(hash_image_job, jobs, nr_images, sizeof(*jobs));
+	}
+	job = jobs;
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -486,16 +642,17 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(job->md, sizeof(job->md));
+			job++;
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(jobs);
+#endif
 	return 0;
 }
 
@@ -505,22 +662,46 @@ static void info_usage(int exit_status)
 	exit(exit_status);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+static size_t count_images(void)
 {
-	FILE *fp;
 	image_desc_t *desc;
-	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
-	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
 		if (desc->image != NULL)
 			nr_images++;
+	return nr_images;
+}
+
+static uint64_t align_offset(uint64_t offset, unsigned long align)
+{
+	return (offset + align - 1) & ~((uint64_t)align - 1);
+}
+
+/* An image aligned with --image-align overrides the FIP alignment. */
+static unsigned long get_desc_align(const image_desc_t *desc,
+    unsigned long align)
+{
+	return desc->align != 0 ? desc->align : align;
+}
+
+/*
+ * Lay out the images of the table in the FIP and build the header and ToC
+ * entries describing them. The offset of each image is updated and the
+ * returned buffer holds toc_size bytes of metadata. The size of the FIP,
+ * including the padding of the last image, is returned in fip_size.
+ */
+static char *build_toc(uint64_t toc_flags, unsigned long align,
+    uint64_t *toc_size, uint64_t *fip_size)
+{
+	image_desc_t *desc;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	char *buf;
+	uint64_t entry_offset, buf_size;
 
 	buf_size = sizeof(fip_toc_header_t) +
-	    sizeof(fip_toc_entry_t) * (nr_images + 1);
+	    sizeof(fip_toc_entry_t) * (count_images() + 1);
 	buf = calloc(1, buf_size);
 	if (buf == NULL)
 		log_err("calloc");
@@ -539,8 +720,8 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 		if (image == NULL)
 			continue;
-		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
+		entry_offset = align_offset(entry_offset,
+		    get_desc_align(desc, align));
 		image->toc_e.offset_address = entry_offset;
 		*toc_entry++ = image->toc_e;
 		entry_offset += image->toc_e.size;
@@ -552,7 +733,31 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	 * size.
 	 */
 	memset(toc_entry, 0, sizeof(*toc_entry));
-	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
+	toc_entry->offset_address = align_offset(entry_offset, align);
+
+	*toc_size = buf_size;
+	*fip_size = toc_entry->offset_address;
+	return buf;
+}
+
+static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+{
+	FILE *fp;
+	image_desc_t *desc;
+	char *buf;
+	uint64_t entry_offset = 0, buf_size, fip_size, payload_size = 0;
+	uint64_t pad_size;
+
+	buf = build_toc(toc_flags, align, &buf_size, &fip_size);
+	entry_offset = buf_size;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		payload_size += image->toc_e.size;
+		entry_offset = image->toc_e.offset_address + image->toc_e.size;
+	}
 
 	/* Generate the FIP file. */
 	fp = fopen(filename, "wb");
@@ -581,7 +786,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	if (fseek(fp, entry_offset, SEEK_SET))
 		log_errx("Failed to set file position");
 
-	pad_size = toc_entry->offset_address - entry_offset;
+	pad_size = fip_size - entry_offset;
 	while (pad_size--)
 		fputc(0x0, fp);
 
@@ -590,6 +795,63 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	return 0;
 }
 
+typedef struct load_job {
+	image_desc_t *desc;
+	image_t      *image;
+} load_job_t;
+
+static void load_image_job(void *arg)
+{
+	load_job_t *job = arg;
+
+	job->image = read_image_from_file(&job->desc->uuid,
+	    job->desc->action_arg);
+}
+
+/* Read all the images to be packed, spread over the worker threads. */
+static load_job_t *load_images(size_t *nr_loaded)
+{
+	image_desc_t *desc;
+	load_job_t *jobs;
+	size_t nr = 0;
+
+	jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+	    "failed to allocate load jobs");
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->action == DO_PACK)
+			jobs[nr++].desc = desc;
+
+	run_jobs(load_image_job, jobs, nr, sizeof(*jobs));
+
+	*nr_loaded = nr;
+	return jobs;
+}
+
+/* Add or replace the loaded images in the image table. */
+static void install_images(load_job_t *jobs, size_t nr)
+{
+	size_t i;
+
+	for (i = 0; i < nr; i++) {
+		image_desc_t *desc = jobs[i].desc;
+
+		if (desc->image != NULL) {
+			if (verbose) {
+				log_dbgx("Replacing %s with %s",
+				    desc->cmdline_name,
+				    desc->action_arg);
+			}
+			free_image(desc->image);
+			desc->image = jobs[i].image;
+		} else {
+			if (verbose)
+				log_dbgx("Adding image %s",
+				    desc->action_arg);
+			desc->image = jobs[i].image;
+		}
+	}
+}
+
 /*
  * This function is shared between the create and update subcommands.
  * The difference between the two subcommands is that when the FIP file
@@ -598,33 +860,131 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
  * internal image table is not populated.
  */
 static void update_fip(void)
+{
+	load_job_t *jobs;
+	size_t nr;
+
+	jobs = load_images(&nr);
+	install_images(jobs, nr);
+	free(jobs);
+}
+
+static int get_file_size(const char *filename, uint64_t *size)
+{
+	struct BLD_PLAT_STAT st;
+	FILE *fp;
+	int ret = 0;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return -1;
+	if (fstat(fileno(fp), &st) == -1)
+		ret = -1;
+	else
+		*size = st.st_size;
+	fclose(fp);
+	return ret;
+}
+
+/*
+ * Check that the images of the table sit where pack_images() would place
+ * them with the given alignment, so that the FIP can be updated in place.
+ */
+static int fip_layout_matches(unsigned long align, uint64_t fip_size)
 {
 	image_desc_t *desc;
+	uint64_t entry_offset;
 
-	/* Add or replace images in the FIP file. */
+	entry_offset = sizeof(fip_toc_header_t) +
+	    sizeof(fip_toc_entry_t) * (count_images() + 1);
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image;
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		entry_offset = align_offset(entry_offset,
+		    get_desc_align(desc, align));
+		if (image->toc_e.offset_address != entry_offset)
+			return 0;
+		entry_offset += image->toc_e.size;
+	}
+
+	return align_offset(entry_offset, align) == fip_size;
+}
+
+/*
+ * Update the FIP file in place when none of its images moves: every image
+ * to be packed replaces an existing one of the same size and the current
+ * layout is the one pack_images() would produce. Only the images whose
+ * content changed are rewritten, along with the header and ToC entries.
+ * Returns 0 on success, or -1 if the FIP has to be regenerated.
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	image_desc_t *desc;
+	load_job_t *jobs;
+	FILE *fp;
+	char *buf;
+	uint64_t size, buf_size, fip_size;
+	size_t i, nr;
 
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		if (desc->action != DO_PACK)
 			continue;
+		if (desc->image == NULL)
+			return -1;
+		if (get_file_size(desc->action_arg, &size) != 0 ||
+		    size != desc->image->toc_e.size)
+			return -1;
+	}
 
-		image = read_image_from_file(&desc->uuid,
-		    desc->action_arg);
-		if (desc->image != NULL) {
-			if (verbose) {
-				log_dbgx("Replacing %s with %s",
-				    desc->cmdline_name,
-				    desc->action_arg);
-			}
-			free(desc->image);
-			desc->image = image;
-		} else {
+	if (get_file_size(filename, &size) != 0 ||
+	    !fip_layout_matches(align, size))
+		return -1;
+
+	fp = fopen(filename, "r+b");
+	if (fp == NULL)
+		return -1;
+
+	jobs = load_images(&nr);
+	for (i = 0; i < nr; i++) {
+		image_t *old = jobs[i].desc->image;
+		image_t *new = jobs[i].image;
+
+		/* The file may have changed since it was checked. */
+		if (new->toc_e.size != old->toc_e.size)
+			log_errx("%s changed while updating %s",
+			    jobs[i].desc->action_arg, filename);
+
+		new->toc_e.offset_address = old->toc_e.offset_address;
+		if (memcmp(new->buffer, old->buffer, new->toc_e.size) == 0) {
 			if (verbose)
-				log_dbgx("Adding image %s",
-				    desc->action_arg);
-			desc->image = image;
+				log_dbgx("%s is unchanged",
+				    jobs[i].desc->cmdline_name);
+			continue;
 		}
+
+		if (verbose)
+			log_dbgx("Rewriting %s in place",
+			    jobs[i].desc->cmdline_name);
+		if (fseek(fp, new->toc_e.offset_address, SEEK_SET))
+			log_errx("Failed to set file position");
+		xfwrite(new->buffer, new->toc_e.size, fp, filename);
 	}
+	install_images(jobs, nr);
+	free(jobs);
+
+	/* The ToC entry flags of replaced images are reset as on a repack. */
+	buf = build_toc(toc_flags, align, &buf_size, &fip_size);
+	assert(fip_size == size);
+	if (fseek(fp, 0, SEEK_SET))
+		log_errx("Failed to set file position");
+	xfwrite(buf, buf_size, fp, filename);
+
+	free(buf);
+	fclose(fp);
+	return 0;
 }
 
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
@@ -673,12 +1033,88 @@ static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len)
 	}
 }
 
+/*
+ * Look up an image by its command line name, or by UUID for images that
+ * do not have one. A descriptor is created for unknown UUIDs.
+ */
+static image_desc_t *lookup_image_desc_from_arg(const char *arg)
+{
+	char name[_UUID_STR_LEN + 1];
+	image_desc_t *desc;
+	uuid_t uuid;
+
+	desc = lookup_image_desc_from_opt(arg);
+	if (desc != NULL && strcmp(arg, "blob") != 0)
+		return desc;
+
+	if (strlen(arg) != _UUID_STR_LEN)
+		log_errx("Unknown image: %s", arg);
+	uuid_from_str(&uuid, arg);
+	desc = lookup_image_desc_from_uuid(&uuid);
+	if (desc == NULL) {
+		uuid_to_str(name, sizeof(name), &uuid);
+		desc = new_image_desc(&uuid, name, "blob");
+		add_image_desc(desc);
+	}
+	return desc;
+}
+
+static void parse_image_align_opt(char *arg)
+{
+	image_desc_t *desc;
+	char *p;
+
+	p = strchr(arg, '=');
+	if (p == NULL)
+		log_errx("Invalid image alignment: %s", arg);
+	*p++ = '\0';
+
+	desc = lookup_image_desc_from_arg(arg);
+	desc->align = get_image_align(p);
+}
+
+/*
+ * Move the images listed in the comma separated load order to the front
+ * of the table, in that order, so that they are packed back to back in
+ * the order the boot loader reads them. The other images follow in their
+ * usual order.
+ */
+static void sort_image_descs(char *order)
+{
+	image_desc_t *head = NULL, **tail = &head;
+	image_desc_t *desc, **p;
+	char *name;
+
+	for (name = strtok(order, ","); name != NULL;
+	     name = strtok(NULL, ",")) {
+		desc = lookup_image_desc_from_arg(name);
+
+		/* Skip images listed twice. */
+		for (p = &head; *p != NULL && *p != desc; p = &(*p)->next)
+			;
+		if (*p != NULL)
+			continue;
+
+		/* Unlink it from the table and append it to the new list. */
+		for (p = &image_desc_head; *p != desc; p = &(*p)->next)
+			;
+		*p = desc->next;
+		desc->next = NULL;
+		*tail = desc;
+		tail = &desc->next;
+	}
+
+	*tail = image_desc_head;
+	image_desc_head = head;
+}
+
 static int create_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
 	size_t nr_opts = 0;
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
+	char *load_order = NULL;
 
 	if (argc < 2)
 		create_usage(EXIT_FAILURE);
@@ -687,6 +1123,10 @@ static int create_cmd(int argc, char *argv[])
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
+	opts = add_opt(opts, &nr_opts, "image-align", required_argument,
+	    OPT_IMAGE_ALIGN);
+	opts = add_opt(opts, &nr_opts, "load-order", required_argument,
+	    OPT_LOAD_ORDER);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
 	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
 
@@ -711,6 +1151,12 @@ static int create_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IMAGE_ALIGN:
+			parse_image_align_opt(optarg);
+			break;
+		case OPT_LOAD_ORDER:
+			load_order = optarg;
+			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1];
 			char filename[PATH_MAX] = { 0 };
@@ -746,6 +1192,9 @@ static int create_cmd(int argc, char *argv[])
 
 	update_fip();
 
+	if (load_order != NULL)
+		sort_image_descs(load_order);
+
 	pack_images(argv[0], toc_flags, align);
 	return 0;
 }
@@ -758,6 +1207,8 @@ static void create_usage(int exit_status)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
+	printf("  --image-align <name>=<value>\tAlign the given image to <value>, overriding --align.\n");
+	printf("  --load-order <name>,...\tPack the given images first, in this order.\n");
 	printf("  --blob uuid=...,file=...\tAdd an image with the given UUID pointed to by file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -782,13 +1233,19 @@ static int update_cmd(int argc, char *argv[])
 	fip_toc_header_t toc_header = { 0 };
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
+	char *load_order = NULL;
 	int pflag = 0;
+	int in_place = 0;
 
 	if (argc < 2)
 		update_usage(EXIT_FAILURE);
 
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
+	opts = add_opt(opts, &nr_opts, "image-align", required_argument,
+	    OPT_IMAGE_ALIGN);
+	opts = add_opt(opts, &nr_opts, "load-order", required_argument,
+	    OPT_LOAD_ORDER);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
@@ -839,6 +1296,12 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IMAGE_ALIGN:
+			parse_image_align_opt(optarg);
+			break;
+		case OPT_LOAD_ORDER:
+			load_order = optarg;
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -856,13 +1319,21 @@ static int update_cmd(int argc, char *argv[])
 	if (outfile[0] == '\0')
 		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
 
-	if (access(argv[0], F_OK) == 0)
+	if (access(argv[0], F_OK) == 0) {
 		parse_fip(argv[0], &toc_header);
+		in_place = strcmp(outfile, argv[0]) == 0;
+	}
 
 	if (pflag)
 		toc_header.flags &= ~(0xffffULL << 32);
 	toc_flags = (toc_header.flags |= toc_flags);
 
+	if (load_order != NULL)
+		sort_image_descs(load_order);
+
+	if (in_place && update_fip_in_place(outfile, toc_flags, align) == 0)
+		return 0;
+
 	update_fip();
 
 	pack_images(outfile, toc_flags, align);
@@ -877,6 +1348,8 @@ static void update_usage(int exit_status)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
+	printf("  --image-align <name>=<value>\tAlign the given image to <value>, overriding --align.\n");
+	printf("  --load-order <name>,...\tPack the given images first, in this order.\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
@@ -1044,6 +1517,7 @@ static int remove_cmd(int argc, char *argv[])
 	fip_toc_header_t toc_header;
 	image_desc_t *desc;
 	unsigned long align = 1;
+	char *load_order = NULL;
 	int fflag = 0;
 
 	if (argc < 2)
@@ -1051,6 +1525,10 @@ static int remove_cmd(int argc, char *argv[])
 
 	opts = fill_common_opts(opts, &nr_opts, no_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
+	opts = add_opt(opts, &nr_opts, "image-align", required_argument,
+	    OPT_IMAGE_ALIGN);
+	opts = add_opt(opts, &nr_opts, "load-order", required_argument,
+	    OPT_LOAD_ORDER);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
 	opts = add_opt(opts, &nr_opts, "force", no_argument, 'f');
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
@@ -1074,6 +1552,12 @@ static int remove_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IMAGE_ALIGN:
+			parse_image_align_opt(optarg);
+			break;
+		case OPT_LOAD_ORDER:
+			load_order = optarg;
+			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
 			uuid_t uuid = uuid_null;
@@ -1128,7 +1612,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1136,6 +1620,9 @@ static int remove_cmd(int argc, char *argv[])
 		}
 	}
 
+	if (load_order != NULL)
+		sort_image_descs(load_order);
+
 	pack_images(outfile, toc_header.flags, align);
 	return 0;
 }
@@ -1148,6 +1635,10 @@ static void remove_usage(int exit_status)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\tEach image is aligned to <value> (default: 1).\n");
+	printf("  --image-align <name>=<value>\n");
+	printf("\t\t\tAlign the given image to <value>, overriding --align.\n");
+	printf("  --load-order <name>,...\n");
+	printf("\t\t\tPack the given images first, in this order.\n");
 	printf("  --blob uuid=...\tRemove an image with the given UUID.\n");
 	printf("  --force\t\tIf the output FIP file already exists, use --force to overwrite it.\n");
 	printf("  --out FIP_FILENAME\tSet an alternative output FIP file.\n");
@@ -1202,9 +1693,10 @@ static int help_cmd(int argc, char *argv[])
 
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--verbose] [--jobs N] <command> [<args>]\n");
 	printf("Global options supported:\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
+	printf("  --jobs N\tUse N threads to read and hash images (default: number of CPUs).\n");
 	printf("\n");
 	printf("Commands supported:\n");
 	printf("  info\t\tList images contained in FIP.\n");
@@ -1225,6 +1717,7 @@ int main(int argc, char *argv[])
 		int c, opt_index = 0;
 		static struct option opts[] = {
 			{ "verbose", no_argument, NULL, 'v' },
+			{ "jobs", required_argument, NULL, 'j' },
 			{ NULL, no_argument, NULL, 0 }
 		};
 
@@ -1232,7 +1725,7 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+vj:", opts, &opt_index);
 		if (c == -1)
 			break;
 
@@ -1240,6 +1733,15 @@ int main(int argc, char *argv[])
 		case 'v':
 			verbose = 1;
 			break;
+		case 'j': {
+			char *endptr;
+
+			errno = 0;
+			nr_jobs = strtol(optarg, &endptr, 0);
+			if (*endptr != '\0' || nr_jobs <= 0 || errno != 0)
+				log_errx("Invalid number of jobs: %s", optarg);
+			break;
+		}
 		default:
 			usage();
 		}
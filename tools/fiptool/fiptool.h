@@ -36,6 +36,7 @@ typedef struct image_desc {
 	char              *cmdline_name;
 	int                action;
 	char              *action_arg;
+	unsigned long      align;
 	struct image      *image;
 	struct image_desc *next;
 } image_desc_t;
@@ -43,6 +44,7 @@ typedef struct image_desc {
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	int                  mapped;
 } image_t;
 
 typedef struct cmd {
@@ -17,6 +17,8 @@
 /* Not Visual Studio, so include Posix Headers. */
 # include <getopt.h>
 # include <openssl/sha.h>
+# include <pthread.h>
+# include <sys/mman.h>
 # include <unistd.h>
 
 # define  BLD_PLAT_STAT stat
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, STMicroelectronics - All Rights Reserved
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""
+Decode the console output of images built with ENABLE_LOG_TOKENS.
+
+The log messages are formatted back from the .tf_log_fmt section of the ELF
+files of the images, named after the image (bl1.elf, bl2.elf, bl2u.elf,
+bl31.elf, bl32.elf) or given as IMAGE=PATH. Other console output is copied
+as is.
+
+Example:
+    decode_log_tokens.py -i /dev/ttyACM0 build/stm32mp1/debug/bl2/bl2.elf \\
+        build/stm32mp1/debug/bl32/bl32.elf
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+LOG_TOKEN_SYNC = 0xA5
+LOG_TOKEN_ESC = 0xA6
+LOG_TOKEN_ESC_XOR = 0x20
+
+# Image byte of the records, see common/tf_log.c
+IMAGES = {'bl1': 1, 'bl2': 2, 'bl2u': 3, 'bl31': 31, 'bl32': 32}
+
+PREFIXES = {10: 'ERROR:   ', 20: 'NOTICE:  ', 30: 'WARNING: ',
+            40: 'INFO:    ', 50: 'VERBOSE: '}
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 2
+
+
+class Elf:
+    """Format strings and constant data of an image ELF file"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        if data[:4] != b'\x7fELF':
+            raise ValueError('{}: not an ELF file'.format(path))
+
+        endian = '<' if data[5] == 1 else '>'
+        if data[4] == 2:
+            shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH',
+                                                            data, 0x3A)
+            shfmt = endian + 'IIQQQQIIQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH',
+                                                            data, 0x2E)
+            shfmt = endian + 'IIIIIIIIII'
+
+        sections = [struct.unpack_from(shfmt, data, shoff + i * shentsize)
+                    for i in range(shnum)]
+        names = sections[shstrndx][4]
+
+        self.fmt = None
+        self.rodata = []
+        for (name, stype, flags, addr, offset, size) in \
+                (s[:6] for s in sections):
+            name = cstring(data, names + name)
+            contents = data[offset:offset + size]
+            if name == '.tf_log_fmt':
+                self.fmt = (addr, contents)
+            elif stype == SHT_PROGBITS and (flags & SHF_ALLOC) != 0:
+                self.rodata.append((addr, contents))
+
+        if self.fmt is None:
+            raise ValueError('{}: no .tf_log_fmt section, was the image '
+                             'built with ENABLE_LOG_TOKENS=1?'.format(path))
+
+    def format_string(self, token):
+        addr, contents = self.fmt
+        if not addr <= token < addr + len(contents):
+            return None
+
+        return cstring(contents, token - addr)
+
+    def string(self, addr):
+        for base, contents in self.rodata:
+            if base <= addr < base + len(contents):
+                return cstring(contents, addr - base)
+
+        return '<string@0x{:x}>'.format(addr)
+
+
+def cstring(data, offset):
+    end = data.find(b'\0', offset)
+    if end < 0:
+        end = len(data)
+
+    return data[offset:end].decode('latin-1')
+
+
+def format_message(fmt, args, elf):
+    """Format as the reduced vprintf() of lib/libc/printf.c"""
+    out = ''
+    i = 0
+
+    while i < len(fmt):
+        if fmt[i] != '%':
+            out += fmt[i]
+            i += 1
+            continue
+
+        i += 1
+        padn = 0
+        padc = ''
+        while True:
+            c = fmt[i] if i < len(fmt) else ''
+            if c in ('l', 'z'):
+                i += 1
+                continue
+            if c == '0':
+                padc = '0'
+                i += 1
+                while i < len(fmt) and fmt[i].isdigit():
+                    padn = padn * 10 + int(fmt[i])
+                    i += 1
+                continue
+            break
+
+        if c == '%':
+            out += '%'
+        elif c in ('d', 'i', 'u', 'x', 'p', 's'):
+            if not args:
+                return out + '<missing argument>\n'
+            val, size = args.pop(0)
+            sign = ''
+            if c in ('d', 'i'):
+                if val >= 1 << (size * 8 - 1):
+                    val -= 1 << (size * 8)
+                if val < 0:
+                    sign = '-'
+                    val = -val
+                    padn -= 1
+                digits = str(val)
+            elif c == 'u':
+                digits = str(val)
+            elif c == 'x':
+                digits = '{:x}'.format(val)
+            elif c == 'p':
+                digits = '{:x}'.format(val)
+                if val != 0:
+                    sign = '0x'
+                    padn -= 2
+            else:
+                out += elf.string(val)
+                i += 1
+                continue
+
+            if padc:
+                digits = digits.rjust(padn, padc)
+            out += sign + digits
+        else:
+            # vprintf() stops on unsupported specifiers
+            return out
+
+        i += 1
+
+    return out
+
+
+def read_bytes(stream, count):
+    """Read count bytes of a record, undoing the escaping"""
+    data = bytearray()
+
+    while len(data) < count:
+        c = stream.read(1)
+        if not c:
+            raise EOFError
+        c = c[0]
+        if c == LOG_TOKEN_ESC:
+            c = stream.read(1)
+            if not c:
+                raise EOFError
+            c = c[0] ^ LOG_TOKEN_ESC_XOR
+        data.append(c)
+
+    return bytes(data)
+
+
+def decode_record(stream, elfs):
+    image, token, nargs, wide = struct.unpack('<BIBH', read_bytes(stream, 8))
+
+    args = []
+    for n in range(nargs):
+        size = 8 if (wide & (1 << n)) != 0 else 4
+        val = int.from_bytes(read_bytes(stream, size), 'little')
+        args.append((val, size))
+
+    elf = elfs.get(image)
+    fmt = elf.format_string(token) if elf is not None else None
+    if not fmt:
+        return '<unknown token 0x{:x} of image {}>\n'.format(token, image)
+
+    level = ord(fmt[0])
+    prefix = PREFIXES.get(level, '')
+
+    return prefix + format_message(fmt[1:], args, elf)
+
+
+def decode(stream, elfs, out):
+    try:
+        while True:
+            c = stream.read(1)
+            if not c:
+                break
+            if c[0] == LOG_TOKEN_SYNC:
+                out.write(decode_record(stream, elfs))
+            else:
+                out.write(c.decode('latin-1'))
+            out.flush()
+    except EOFError:
+        out.write('<truncated record>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode the console output of TF-A images built with '
+                    'ENABLE_LOG_TOKENS=1')
+    parser.add_argument('-i', '--input', default='-',
+                        help='console output file or device, - for stdin')
+    parser.add_argument('elf', nargs='+',
+                        help='ELF file of an image, [IMAGE=]PATH with IMAGE '
+                             'one of ' + ', '.join(IMAGES))
+    args = parser.parse_args()
+
+    elfs = {}
+    for arg in args.elf:
+        if '=' in arg:
+            name, path = arg.split('=', 1)
+        else:
+            path = arg
+            name = os.path.splitext(os.path.basename(path))[0]
+        if name not in IMAGES:
+            parser.error('{}: unknown image {}'.format(arg, name))
+        elfs[IMAGES[name]] = Elf(path)
+
+    if args.input == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, 'rb', buffering=0)
+
+    decode(stream, elfs, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()